@@ -38,7 +38,7 @@ static hmac_sha256_digest hmac_sha256(std::string_view key, std::string_view msg
     return digest;
 }
 
-static hmac_sha256_digest get_signature_key(std::string_view key, std::string_view date_stamp, std::string_view region_name, std::string_view service_name) {
+hmac_sha256_digest get_signature_key(std::string_view key, std::string_view date_stamp, std::string_view region_name, std::string_view service_name) {
     auto date = hmac_sha256("AWS4" + std::string(key), date_stamp);
     auto region = hmac_sha256(std::string_view(date.data(), date.size()), region_name);
     auto service = hmac_sha256(std::string_view(region.data(), region.size()), service_name);
@@ -46,6 +46,25 @@ static hmac_sha256_digest get_signature_key(std::string_view key, std::string_vi
     return signing;
 }
 
+const hmac_sha256_digest& signing_key_cache::get(std::string_view access_key_id, std::string_view secret_access_key,
+        std::string_view date_stamp, std::string_view region_name, std::string_view service_name) {
+    auto scope = fmt::format("{}/{}/{}/{}", access_key_id, date_stamp, region_name, service_name);
+    auto it = _entries.find(scope);
+    if (it != _entries.end()) {
+        if (it->second.secret_access_key != secret_access_key) {
+            it->second = entry{std::string(secret_access_key), get_signature_key(secret_access_key, date_stamp, region_name, service_name)};
+        }
+        return it->second.signing_key;
+    }
+    if (_entries.size() >= _max_size) {
+        // Entries of past days are never used again; rather than tracking
+        // recency, start over. Active users re-derive their keys once.
+        _entries.clear();
+    }
+    auto key = get_signature_key(secret_access_key, date_stamp, region_name, service_name);
+    return _entries.emplace(std::move(scope), entry{std::string(secret_access_key), key}).first->second.signing_key;
+}
+
 static std::string apply_sha256(std::string_view msg) {
     sha256_hasher hasher;
     hasher.update(msg.data(), msg.size());
@@ -87,7 +106,7 @@ void check_expiry(std::string_view signature_date) {
     }
 }
 
-std::string get_signature(std::string_view access_key_id, std::string_view secret_access_key, std::string_view host, std::string_view method,
+std::string get_signature(std::string_view access_key_id, const hmac_sha256_digest& signing_key, std::string_view host, std::string_view method,
         std::string_view orig_datestamp, std::string_view signed_headers_str, const std::map<std::string_view, std::string_view>& signed_headers_map,
         const std::vector<temporary_buffer<char>>& body_content, std::string_view region, std::string_view service, std::string_view query_string) {
     auto amz_date_it = signed_headers_map.find("x-amz-date");
@@ -116,7 +135,6 @@ std::string get_signature(std::string_view access_key_id, std::string_view secre
     std::string credential_scope = fmt::format("{}/{}/{}/aws4_request", datestamp, region, service);
     std::string string_to_sign = fmt::format("{}\n{}\n{}\n{}", algorithm, amz_date, credential_scope,  apply_sha256(canonical_request));
 
-    hmac_sha256_digest signing_key = get_signature_key(secret_access_key, datestamp, region, service);
     hmac_sha256_digest signature = hmac_sha256(std::string_view(signing_key.data(), signing_key.size()), string_to_sign);
 
     return to_hex(bytes_view(reinterpret_cast<const int8_t*>(signature.data()), signature.size()));
@@ -11,6 +11,7 @@
 #include <string>
 #include <string_view>
 #include <array>
+#include <unordered_map>
 #include "gc_clock.hh"
 #include "utils/loading_cache.hh"
 
@@ -24,7 +25,34 @@ using hmac_sha256_digest = std::array<char, 32>;
 
 using key_cache = utils::loading_cache<std::string, std::string, 1>;
 
-std::string get_signature(std::string_view access_key_id, std::string_view secret_access_key, std::string_view host, std::string_view method,
+hmac_sha256_digest get_signature_key(std::string_view key, std::string_view date_stamp, std::string_view region_name, std::string_view service_name);
+
+// A shard-local cache of SigV4 signing keys.
+//
+// The signing key of a request depends only on the user's secret key and on
+// the date, region and service of its credential scope, but deriving it takes
+// four HMAC computations. Clients sign all their requests of a day with the
+// same key, so it is cached per user and scope. Entries remember the secret
+// key they were derived from, so a changed secret key is never paired with a
+// stale signing key.
+class signing_key_cache {
+    struct entry {
+        std::string secret_access_key;
+        hmac_sha256_digest signing_key;
+    };
+    // Keyed by access key id and credential scope, e.g. "user/20230101/us-east-1/dynamodb".
+    std::unordered_map<std::string, entry> _entries;
+    size_t _max_size;
+public:
+    explicit signing_key_cache(size_t max_size) : _max_size(max_size) {}
+
+    const hmac_sha256_digest& get(std::string_view access_key_id, std::string_view secret_access_key,
+            std::string_view date_stamp, std::string_view region_name, std::string_view service_name);
+
+    size_t size() const noexcept { return _entries.size(); }
+};
+
+std::string get_signature(std::string_view access_key_id, const hmac_sha256_digest& signing_key, std::string_view host, std::string_view method,
         std::string_view orig_datestamp, std::string_view signed_headers_str, const std::map<std::string_view, std::string_view>& signed_headers_map,
         const std::vector<temporary_buffer<char>>& body_content, std::string_view region, std::string_view service, std::string_view query_string);
 
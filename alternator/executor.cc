@@ -45,10 +45,13 @@
 #include "db/tags/utils.hh"
 #include "alternator/rmw_operation.hh"
 #include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/find_end.hpp>
 #include <unordered_set>
 #include "service/storage_proxy.hh"
+#include "replica/database.hh"
+#include "locator/abstract_replication_strategy.hh"
 #include "gms/gossiper.hh"
 #include "schema_registry.hh"
 #include "utils/error_injection.hh"
@@ -3219,40 +3222,74 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
         requests.emplace_back(std::move(rs));
     }
 
-    // If we got here, all "requests" are valid, so let's start the
-    // requests for the different partitions all in parallel.
-    std::vector<future<std::vector<rjson::value>>> response_futures;
+    // If we got here, all "requests" are valid. Group the partitions into
+    // reads: a table without a clustering key needs the same slice for all
+    // of its partitions, so all partitions owned by the same replica set are
+    // read with a single multi-partition command. This saves the per-read
+    // setup and result conversion, and a failing replica set only makes its
+    // own keys unprocessed. Other tables need a slice per partition.
+    struct read_group {
+        const table_requests* rs;
+        std::vector<const std::pair<const partition_key, table_requests::clustering_keys>*> partitions;
+    };
+    std::vector<read_group> groups;
     for (const auto& rs : requests) {
-        for (const auto &r : rs.requests) {
-            auto& pk = r.first;
-            auto& cks = r.second;
-            dht::partition_range_vector partition_ranges{dht::partition_range(dht::decorate_key(*rs.schema, pk))};
-            std::vector<query::clustering_range> bounds;
-            if (rs.schema->clustering_key_size() == 0) {
-                bounds.push_back(query::clustering_range::make_open_ended_both_sides());
-            } else {
-                for (auto& ck : cks) {
-                    bounds.push_back(query::clustering_range::make_singular(ck.first));
-                }
+        if (rs.schema->clustering_key_size() == 0) {
+            auto erm = _proxy.local_db().find_keyspace(rs.schema->ks_name()).get_effective_replication_map();
+            std::map<std::vector<gms::inet_address>, read_group> by_replicas;
+            for (const auto& r : rs.requests) {
+                auto token = dht::get_token(*rs.schema, r.first);
+                auto eps = erm->get_natural_endpoints(token);
+                std::vector<gms::inet_address> replicas(eps.begin(), eps.end());
+                std::sort(replicas.begin(), replicas.end());
+                auto it = by_replicas.try_emplace(std::move(replicas), read_group{&rs, {}}).first;
+                it->second.partitions.push_back(&r);
+            }
+            for (auto& [_, group] : by_replicas) {
+                groups.push_back(std::move(group));
+            }
+        } else {
+            for (const auto& r : rs.requests) {
+                groups.push_back(read_group{&rs, {&r}});
             }
-            auto regular_columns = boost::copy_range<query::column_id_vector>(
-                    rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
-            auto selection = cql3::selection::selection::wildcard(rs.schema);
-            auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
-            auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
-                    query::tombstone_limit(_proxy.get_tombstone_limit()));
-            command->allow_limit = db::allow_per_partition_rate_limit::yes;
-            future<std::vector<rjson::value>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
-                    service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
-                    [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
-                utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
-                std::vector<rjson::value> jsons = describe_multi_item(schema, partition_slice, *selection, *qr.query_result, *attrs_to_get);
-                return make_ready_future<std::vector<rjson::value>>(std::move(jsons));
-            });
-            response_futures.push_back(std::move(f));
         }
     }
 
+    // Start all the reads in parallel.
+    std::vector<future<std::vector<rjson::value>>> response_futures;
+    response_futures.reserve(groups.size());
+    for (const auto& group : groups) {
+        auto& rs = *group.rs;
+        dht::partition_range_vector partition_ranges;
+        partition_ranges.reserve(group.partitions.size());
+        std::vector<query::clustering_range> bounds;
+        for (auto* r : group.partitions) {
+            partition_ranges.push_back(dht::partition_range(dht::decorate_key(*rs.schema, r->first)));
+        }
+        if (rs.schema->clustering_key_size() == 0) {
+            bounds.push_back(query::clustering_range::make_open_ended_both_sides());
+        } else {
+            for (auto& ck : group.partitions.front()->second) {
+                bounds.push_back(query::clustering_range::make_singular(ck.first));
+            }
+        }
+        auto regular_columns = boost::copy_range<query::column_id_vector>(
+                rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+        auto selection = cql3::selection::selection::wildcard(rs.schema);
+        auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
+        auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
+                query::tombstone_limit(_proxy.get_tombstone_limit()));
+        command->allow_limit = db::allow_per_partition_rate_limit::yes;
+        future<std::vector<rjson::value>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
+                service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
+                [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
+            utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
+            std::vector<rjson::value> jsons = describe_multi_item(schema, partition_slice, *selection, *qr.query_result, *attrs_to_get);
+            return make_ready_future<std::vector<rjson::value>>(std::move(jsons));
+        });
+        response_futures.push_back(std::move(f));
+    }
+
     // Wait for all requests to complete, and then return the response.
     // In case of full failure (no reads succeeded), an arbitrary error
     // from one of the operations will be returned.
@@ -3264,42 +3301,40 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
     rjson::add(response, "UnprocessedKeys", rjson::empty_object());
 
     auto fut_it = response_futures.begin();
-    for (const auto& rs : requests) {
-        auto table = table_name(*rs.schema);
-        for (const auto &r : rs.requests) {
-            auto& pk = r.first;
-            auto& cks = r.second;
-            auto& fut = *fut_it;
-            ++fut_it;
-            try {
-                std::vector<rjson::value> results = co_await std::move(fut);
-                some_succeeded = true;
-                if (!response["Responses"].HasMember(table)) {
-                    rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
-                }
-                for (rjson::value& json : results) {
-                    rjson::push_back(response["Responses"][table], std::move(json));
-                }
-            } catch(...) {
-                eptr = std::current_exception();
-                // This read of potentially several rows in one partition,
-                // failed. We need to add the row key(s) to UnprocessedKeys.
-                if (!response["UnprocessedKeys"].HasMember(table)) {
-                    // Add the table's entry in UnprocessedKeys. Need to copy
-                    // all the table's parameters from the request except the
-                    // Keys field, which we start empty and then build below.
-                    rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
-                    rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
-                    rjson::value& request_item = request_items[table];
-                    for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
-                        if (it->name != "Keys") {
-                            rjson::add_with_string_name(unprocessed_item,
-                                rjson::to_string_view(it->name), rjson::copy(it->value));
-                        }
+    for (const auto& group : groups) {
+        auto table = table_name(*group.rs->schema);
+        auto& fut = *fut_it;
+        ++fut_it;
+        try {
+            std::vector<rjson::value> results = co_await std::move(fut);
+            some_succeeded = true;
+            if (!response["Responses"].HasMember(table)) {
+                rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
+            }
+            for (rjson::value& json : results) {
+                rjson::push_back(response["Responses"][table], std::move(json));
+            }
+        } catch(...) {
+            eptr = std::current_exception();
+            // This read of potentially several rows in several partitions
+            // failed. We need to add the row key(s) to UnprocessedKeys.
+            if (!response["UnprocessedKeys"].HasMember(table)) {
+                // Add the table's entry in UnprocessedKeys. Need to copy
+                // all the table's parameters from the request except the
+                // Keys field, which we start empty and then build below.
+                rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
+                rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
+                rjson::value& request_item = request_items[table];
+                for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
+                    if (it->name != "Keys") {
+                        rjson::add_with_string_name(unprocessed_item,
+                            rjson::to_string_view(it->name), rjson::copy(it->value));
                     }
-                    rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
                 }
-                for (auto& ck : cks) {
+                rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
+            }
+            for (auto* r : group.partitions) {
+                for (auto& ck : r->second) {
                     rjson::push_back(response["UnprocessedKeys"][table]["Keys"], std::move(*ck.second));
                 }
             }
@@ -3555,6 +3590,11 @@ class describe_items_visitor {
         return std::move(_items);
     }
 
+    // Returns the items accumulated so far, and starts a new list.
+    rjson::value take_items() {
+        return std::exchange(_items, rjson::empty_array());
+    }
+
     size_t get_scanned_count() {
         return _scanned_count;
     }
@@ -3582,6 +3622,81 @@ static std::tuple<rjson::value, size_t> describe_items(schema_ptr schema, const
     return {std::move(items_descr), size};
 }
 
+// Like describe_items(), but serializes the items straight from the result
+// set to the output stream, one item at a time, instead of building the JSON
+// document of the whole page first. The number of items is only known after
+// all of them went through the filter, so "Count" and "ScannedCount" are
+// written after "Items".
+static json::json_return_type make_streamed_items(const cql3::selection::selection& selection, std::unique_ptr<cql3::result_set> result_set,
+        std::optional<attrs_to_get>&& attrs_to_get, filter&& filter, std::optional<rjson::value> last_evaluated_key,
+        std::function<void(size_t)> on_done) {
+    struct streamed_items {
+        std::vector<const column_definition*> columns;
+        std::unique_ptr<cql3::result_set> result_set;
+        std::optional<attrs_to_get> attrs_to_get;
+        ::alternator::filter filter;
+        std::optional<rjson::value> last_evaluated_key;
+        std::function<void(size_t)> on_done;
+    };
+    // json::json_return_type uses std::function, so the state must be copyable.
+    auto state = make_shared<streamed_items>(streamed_items{selection.get_columns(), std::move(result_set), std::move(attrs_to_get),
+            std::move(filter), std::move(last_evaluated_key), std::move(on_done)});
+    std::function<future<>(output_stream<char>&&)> func = [state] (output_stream<char>&& os) mutable -> future<> {
+        auto los = std::move(os);
+        auto st = std::move(state);
+        try {
+            // If attrs_to_get is empty, the user asked for Select=COUNT and
+            // we shouldn't return "Items" at all, see describe_items().
+            bool with_items = !st->attrs_to_get || !st->attrs_to_get->empty();
+            describe_items_visitor visitor(st->columns, st->attrs_to_get, st->filter);
+            auto column_count = st->result_set->get_metadata().column_count();
+            size_t count = 0;
+            if (with_items) {
+                co_await los.write("{\"Items\":[");
+            } else {
+                co_await los.write("{");
+            }
+            for (auto& row : st->result_set->rows()) {
+                visitor.start_row();
+                for (auto i = 0u; i < column_count; i++) {
+                    auto& cell = row[i];
+                    visitor.accept_value(cell ? std::optional<query::result_bytes_view>(*cell) : std::optional<query::result_bytes_view>());
+                }
+                visitor.end_row();
+                auto items = visitor.take_items();
+                for (auto& item : items.GetArray()) {
+                    if (with_items) {
+                        if (count) {
+                            co_await los.write(",");
+                        }
+                        co_await rjson::print(item, los);
+                    }
+                    ++count;
+                }
+                co_await coroutine::maybe_yield();
+            }
+            if (with_items) {
+                co_await los.write("],");
+            }
+            co_await los.write(format("\"Count\":{},\"ScannedCount\":{}", count, visitor.get_scanned_count()));
+            if (st->last_evaluated_key) {
+                co_await los.write(",\"LastEvaluatedKey\":");
+                co_await rjson::print(*st->last_evaluated_key, los);
+            }
+            co_await los.write("}");
+            co_await los.flush();
+            co_await los.close();
+            st->on_done(count);
+        } catch (...) {
+            // As in make_streamed(), the HTTP headers are already written, so
+            // just log and rethrow.
+            elogger.error("Unhandled exception in data streaming: {}", std::current_exception());
+            throw;
+        }
+    };
+    return func;
+}
+
 static rjson::value encode_paging_state(const schema& schema, const service::pager::paging_state& paging_state) {
     rjson::value last_evaluated_key = rjson::empty_object();
     std::vector<bytes> exploded_pk = paging_state.get_partition_key().explode();
@@ -3664,7 +3779,7 @@ static future<executor::request_return_type> do_query(service::storage_proxy& pr
     auto p = service::pager::query_pagers::pager(proxy, schema, selection, *query_state_ptr, *query_options, command, std::move(partition_ranges), nullptr);
 
     return p->fetch_page(limit, gc_clock::now(), executor::default_timeout()).then(
-            [p = std::move(p), schema, cql_stats, partition_slice = std::move(partition_slice),
+            [p = std::move(p), schema, &cql_stats, partition_slice = std::move(partition_slice),
              selection = std::move(selection), query_state_ptr = std::move(query_state_ptr),
              attrs_to_get = std::move(attrs_to_get),
              query_options = std::move(query_options),
@@ -3674,6 +3789,25 @@ static future<executor::request_return_type> do_query(service::storage_proxy& pr
         }
         auto paging_state = rs->get_metadata().paging_state();
         bool has_filter = filter;
+        // TODO: better threshold
+        if (rs->size() > 10) {
+            // Large pages are serialized while they are written out, so that
+            // the JSON document of the page never needs to be built in memory.
+            std::optional<rjson::value> last_evaluated_key;
+            if (paging_state) {
+                last_evaluated_key = encode_paging_state(*schema, *paging_state);
+            }
+            if (has_filter) {
+                cql_stats.filtered_rows_read_total += p->stats().rows_read_total;
+            }
+            auto on_done = [&cql_stats, has_filter] (size_t size) {
+                if (has_filter) {
+                    cql_stats.filtered_rows_matched_total += size;
+                }
+            };
+            return make_ready_future<executor::request_return_type>(make_streamed_items(*selection, std::move(rs),
+                    std::move(attrs_to_get), std::move(filter), std::move(last_evaluated_key), std::move(on_done)));
+        }
         auto [items, size] = describe_items(schema, partition_slice, *selection, std::move(rs), std::move(attrs_to_get), std::move(filter));
         if (paging_state) {
             rjson::add(items, "LastEvaluatedKey", encode_paging_state(*schema, *paging_state));
@@ -3683,10 +3817,6 @@ static future<executor::request_return_type> do_query(service::storage_proxy& pr
             // update our "filtered_row_matched_total" for all the rows matched, despited the filter
             cql_stats.filtered_rows_matched_total += size;
         }
-        // TODO: better threshold
-        if (size > 10) {
-            return make_ready_future<executor::request_return_type>(make_streamed(std::move(items)));
-        }
         return make_ready_future<executor::request_return_type>(make_jsonable(std::move(items)));
     });
 }
@@ -24,6 +24,7 @@
 #include <boost/algorithm/cxx11/all_of.hpp>
 
 #include <functional>
+#include <list>
 #include <unordered_map>
 
 namespace alternator {
@@ -43,31 +44,77 @@ Result do_with_parser(std::string_view input, Func&& f) {
     return result;
 }
 
+// A per-shard cache of parsed expressions, keyed by the expression string.
+//
+// Applications typically send the same few expressions over and over, with
+// different ExpressionAttributeValues. Parsing with ANTLR is expensive, so
+// the unresolved result is kept and each request gets a copy of it, which
+// resolve_*() then modifies in place. Expressions which fail to parse are
+// not cached.
+template <typename T>
+class parsed_expression_cache {
+    static constexpr size_t max_entries = 1000;
+    // DynamoDB limits expressions to 4KB. Longer ones aren't worth caching.
+    static constexpr size_t max_expression_size = 4096;
+
+    using lru_list = std::list<std::pair<std::string, T>>;
+    lru_list _lru;
+    std::unordered_map<std::string_view, typename lru_list::iterator> _index;
+public:
+    template <typename Parse>
+    T get_or_parse(std::string_view query, Parse&& parse) {
+        if (query.size() > max_expression_size) {
+            return parse(query);
+        }
+        if (auto i = _index.find(query); i != _index.end()) {
+            _lru.splice(_lru.begin(), _lru, i->second);
+            return i->second->second;
+        }
+        T parsed = parse(query);
+        if (_lru.size() >= max_entries) {
+            _index.erase(_lru.back().first);
+            _lru.pop_back();
+        }
+        _lru.emplace_front(std::string(query), parsed);
+        _index.emplace(_lru.front().first, _lru.begin());
+        return parsed;
+    }
+};
+
 parsed::update_expression
 parse_update_expression(std::string_view query) {
-    try {
-        return do_with_parser(query,  std::mem_fn(&expressionsParser::update_expression));
-    } catch (...) {
-        throw expressions_syntax_error(format("Failed parsing UpdateExpression '{}': {}", query, std::current_exception()));
-    }
+    static thread_local parsed_expression_cache<parsed::update_expression> cache;
+    return cache.get_or_parse(query, [] (std::string_view query) {
+        try {
+            return do_with_parser(query,  std::mem_fn(&expressionsParser::update_expression));
+        } catch (...) {
+            throw expressions_syntax_error(format("Failed parsing UpdateExpression '{}': {}", query, std::current_exception()));
+        }
+    });
 }
 
 std::vector<parsed::path>
 parse_projection_expression(std::string_view query) {
-    try {
-        return do_with_parser(query,  std::mem_fn(&expressionsParser::projection_expression));
-    } catch (...) {
-        throw expressions_syntax_error(format("Failed parsing ProjectionExpression '{}': {}", query, std::current_exception()));
-    }
+    static thread_local parsed_expression_cache<std::vector<parsed::path>> cache;
+    return cache.get_or_parse(query, [] (std::string_view query) {
+        try {
+            return do_with_parser(query,  std::mem_fn(&expressionsParser::projection_expression));
+        } catch (...) {
+            throw expressions_syntax_error(format("Failed parsing ProjectionExpression '{}': {}", query, std::current_exception()));
+        }
+    });
 }
 
 parsed::condition_expression
 parse_condition_expression(std::string_view query) {
-    try {
-        return do_with_parser(query,  std::mem_fn(&expressionsParser::condition_expression));
-    } catch (...) {
-        throw expressions_syntax_error(format("Failed parsing ConditionExpression '{}': {}", query, std::current_exception()));
-    }
+    static thread_local parsed_expression_cache<parsed::condition_expression> cache;
+    return cache.get_or_parse(query, [] (std::string_view query) {
+        try {
+            return do_with_parser(query,  std::mem_fn(&expressionsParser::condition_expression));
+        } catch (...) {
+            throw expressions_syntax_error(format("Failed parsing ConditionExpression '{}': {}", query, std::current_exception()));
+        }
+    });
 }
 
 namespace parsed {
@@ -304,19 +304,17 @@ future<std::string> server::verify_signature(const request& req, const chunked_c
         }
     }
 
-    auto cache_getter = [&proxy = _proxy] (std::string username) {
-        return get_key_from_roles(proxy, std::move(username));
-    };
-    return _key_cache.get_ptr(user, cache_getter).then([this, &req, &content,
-                                                    user = std::move(user),
-                                                    host = std::move(host),
-                                                    datestamp = std::move(datestamp),
-                                                    signed_headers_str = std::move(signed_headers_str),
-                                                    signed_headers_map = std::move(signed_headers_map),
-                                                    region = std::move(region),
-                                                    service = std::move(service),
-                                                    user_signature = std::move(user_signature)] (key_cache::value_ptr key_ptr) {
-        std::string signature = get_signature(user, *key_ptr, std::string_view(host), req._method,
+    auto verify = [this, &req, &content,
+                   user,
+                   host = std::move(host),
+                   datestamp = std::move(datestamp),
+                   signed_headers_str = std::move(signed_headers_str),
+                   signed_headers_map = std::move(signed_headers_map),
+                   region = std::move(region),
+                   service = std::move(service),
+                   user_signature = std::move(user_signature)] (const std::string& secret_access_key) {
+        const hmac_sha256_digest& signing_key = _signing_key_cache.get(user, secret_access_key, datestamp, region, service);
+        std::string signature = get_signature(user, signing_key, std::string_view(host), req._method,
                 datestamp, signed_headers_str, signed_headers_map, content, region, service, "");
 
         if (signature != std::string_view(user_signature)) {
@@ -324,6 +322,17 @@ future<std::string> server::verify_signature(const request& req, const chunked_c
             throw api_error::unrecognized_client("The security token included in the request is invalid.");
         }
         return user;
+    };
+    // The key of a user who sent a request recently is cached; use it
+    // without going through the loader and its continuations.
+    if (auto key_ptr = _key_cache.find(user)) {
+        return make_ready_future<std::string>(verify(*key_ptr));
+    }
+    auto cache_getter = [&proxy = _proxy] (std::string username) {
+        return get_key_from_roles(proxy, std::move(username));
+    };
+    return _key_cache.get_ptr(user, cache_getter).then([verify = std::move(verify)] (key_cache::value_ptr key_ptr) {
+        return verify(*key_ptr);
     });
 }
 
@@ -447,6 +456,7 @@ server::server(executor& exec, service::storage_proxy& proxy, gms::gossiper& gos
         , _proxy(proxy)
         , _gossiper(gossiper)
         , _key_cache(1024, 1min, slogger)
+        , _signing_key_cache(1024)
         , _enforce_authorization(false)
         , _enabled_servers{}
         , _pending_requests{}
@@ -233,12 +233,10 @@ static bool is_expired(const rjson::value& expiration_time, gc_clock::time_point
     return n && is_expired(*n, now);
 }
 
-// expire_item() expires an item - i.e., deletes it as appropriate for
-// expiration - with CL=QUORUM and (FIXME!) in a way Alternator Streams
-// understands it is an expiration event - not a user-initiated deletion.
-static future<> expire_item(service::storage_proxy& proxy,
-                            const service::query_state& qs,
-                            const std::vector<bytes_opt>& row,
+// make_expiration_mutation() returns the mutation which expires an item -
+// i.e., deletes it as appropriate for expiration - or nothing if the row
+// lacks a key column. The mutations are applied by expire_items().
+static std::optional<mutation> make_expiration_mutation(const std::vector<bytes_opt>& row,
                             schema_ptr schema,
                             api::timestamp_type ts) {
     // Prepare the row key to delete
@@ -255,7 +253,7 @@ static future<> expire_item(service::storage_proxy& proxy,
             // This shouldn't happen - all key columns must have values.
             // But if it ever happens, let's just *not* expire the item.
             // FIXME: log or increment a metric if this happens.
-            return make_ready_future<>();
+            return std::nullopt;
         }
         exploded_pk.push_back(*row_c);
     }
@@ -275,14 +273,27 @@ static future<> expire_item(service::storage_proxy& proxy,
                 // This shouldn't happen - all key columns must have values.
                 // But if it ever happens, let's just *not* expire the item.
                 // FIXME: log or increment a metric if this happens.
-                return make_ready_future<>();
+                return std::nullopt;
             }
             exploded_ck.push_back(*row_c);
         }
         auto ck = clustering_key::from_exploded(exploded_ck);
         m.partition().clustered_row(*schema, ck).apply(tombstone(ts, gc_clock::now()));
     }
-    return proxy.mutate(std::vector<mutation>{std::move(m)},
+    return m;
+}
+
+// Maximum number of items expire_items() deletes with one storage_proxy::mutate()
+// call. The mutations of a batch are sent to their replicas in parallel.
+static constexpr size_t max_expiration_batch = 100;
+
+// expire_items() applies expiration mutations with CL=QUORUM and (FIXME!)
+// in a way Alternator Streams understands it is an expiration event - not
+// a user-initiated deletion.
+static future<> expire_items(service::storage_proxy& proxy,
+                             const service::query_state& qs,
+                             std::vector<mutation> mutations) {
+    return proxy.mutate(std::move(mutations),
         db::consistency_level::LOCAL_QUORUM,
         executor::default_timeout(), // FIXME - which timeout?
         qs.get_trace_state(), qs.get_permit(),
@@ -566,6 +577,8 @@ static future<> scan_table_ranges(
         if (!expiration_column) {
             continue;
         }
+        std::vector<mutation> expired_items;
+        auto now = gc_clock::now();
         for (const auto& row : rows) {
             const bytes_opt& cell = row[*expiration_column];
             if (!cell) {
@@ -573,8 +586,6 @@ static future<> scan_table_ranges(
             }
             auto v = meta[*expiration_column]->type->deserialize(*cell);
             bool expired = false;
-            // FIXME: don't recalculate "now" all the time
-            auto now = gc_clock::now();
             if (scan_ctx.member) {
                 // In this case, the expiration-time attribute we're
                 // looking for is a member in a map, saved serialized
@@ -603,13 +614,22 @@ static future<> scan_table_ranges(
                 expired = is_expired(n, now);
             }
             if (expired) {
-                expiration_stats.items_deleted++;
                 // FIXME: maybe don't recalculate new_timestamp() all the time
-                // FIXME: if expire_item() throws on timeout, we need to retry it.
                 auto ts = api::new_timestamp();
-                co_await expire_item(proxy, *scan_ctx.query_state_ptr, row, s, ts);
+                if (auto m = make_expiration_mutation(row, s, ts)) {
+                    expiration_stats.items_deleted++;
+                    expired_items.push_back(std::move(*m));
+                }
+                if (expired_items.size() >= max_expiration_batch) {
+                    // FIXME: if expire_items() throws on timeout, we need to retry it.
+                    co_await expire_items(proxy, *scan_ctx.query_state_ptr, std::exchange(expired_items, {}));
+                    now = gc_clock::now();
+                }
             }
         }
+        if (!expired_items.empty()) {
+            co_await expire_items(proxy, *scan_ctx.query_state_ptr, std::move(expired_items));
+        }
         // FIXME: once in a while, persist p->state(), so on reboot
         // we don't start from scratch.
     }
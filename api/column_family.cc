@@ -992,6 +992,34 @@ void set_column_family(http_context& ctx, routes& r) {
     });
 
 
+    cf::get_sstable_io_stats.set(r, [&ctx](std::unique_ptr<request> req) {
+        return map_reduce_cf_raw(ctx, req->param["name"], sstables::io_stats(), [](const replica::column_family& cf) {
+            return cf.get_sstables_io_stats();
+        }, [] (sstables::io_stats a, const sstables::io_stats& b) {
+            a.merge(b);
+            return a;
+        }).then([](const sstables::io_stats& stats) {
+            using io_stats = sstables::io_stats;
+            std::vector<cf::sstable_io_stats> res;
+            for (size_t c = 0; c < io_stats::component_count; ++c) {
+                for (size_t r = 0; r < io_stats::reason_count; ++r) {
+                    auto& counters = stats.get(io_stats::component(c), io_stats::reason(r));
+                    cf::sstable_io_stats s;
+                    s.component = sstring(sstables::to_string(io_stats::component(c)));
+                    s.reason = sstring(sstables::to_string(io_stats::reason(r)));
+                    s.read_ops = counters.read_ops;
+                    s.read_bytes = counters.read_bytes;
+                    s.write_ops = counters.write_ops;
+                    s.write_bytes = counters.write_bytes;
+                    s.read_latency_p50 = counters.read_latency.quantile(0.5);
+                    s.read_latency_p99 = counters.read_latency.quantile(0.99);
+                    res.push_back(std::move(s));
+                }
+            }
+            return make_ready_future<json::json_return_type>(std::move(res));
+        });
+    });
+
     cf::toppartitions.set(r, [&ctx] (std::unique_ptr<request> req) {
         auto name = req->param["name"];
         auto [ks, cf] = parse_fully_qualified_cf_name(name);
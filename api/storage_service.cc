@@ -28,6 +28,7 @@
 #include <seastar/http/exception.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include "repair/row_level.hh"
 #include "locator/snitch_base.hh"
 #include "column_family.hh"
@@ -44,6 +45,7 @@
 #include "cdc/generation_service.hh"
 #include "service/storage_proxy.hh"
 #include "locator/abstract_replication_strategy.hh"
+#include "dht/sharder.hh"
 #include "sstables_loader.hh"
 #include "db/view/view_builder.hh"
 
@@ -560,6 +562,35 @@ void set_storage_service(http_context& ctx, routes& r, sharded<service::storage_
         return describe_ring_as_json(ss, validate_keyspace(ctx, req->param));
     });
 
+    ss::get_shard_ranges.set(r, [&ctx](std::unique_ptr<request> req) -> future<json::json_return_type> {
+        auto keyspace = validate_keyspace(ctx, req->param);
+        auto tables = parse_tables(keyspace, ctx, req->query_parameters, "cf");
+        if (tables.size() != 1) {
+            throw bad_param_exception("Exactly one table must be given in the cf parameter");
+        }
+        auto s = ctx.db.local().find_schema(keyspace, tables.front());
+        auto erm = ctx.db.local().find_keyspace(keyspace).get_effective_replication_map();
+        auto ranges = erm->get_ranges(utils::fb_utilities::get_broadcast_address());
+        const auto& sharder = s->get_sharder();
+        std::vector<ss::shard_token_range> res;
+        for (shard_id shard = 0; shard < sharder.shard_count(); ++shard) {
+            for (const auto& range : ranges) {
+                auto range_sharder = dht::selective_token_range_sharder(sharder, range, shard);
+                while (auto sub_range = range_sharder.next()) {
+                    ss::shard_token_range r;
+                    r.start_token = sub_range->start() ? sub_range->start()->value().to_sstring() : "";
+                    r.start_inclusive = sub_range->start() && sub_range->start()->is_inclusive();
+                    r.end_token = sub_range->end() ? sub_range->end()->value().to_sstring() : "";
+                    r.end_inclusive = sub_range->end() && sub_range->end()->is_inclusive();
+                    r.shard = shard;
+                    res.push_back(std::move(r));
+                }
+                co_await coroutine::maybe_yield();
+            }
+        }
+        co_return stream_range_as_array(std::move(res), std::identity());
+    });
+
     ss::get_host_id_map.set(r, [&ctx](const_req req) {
         std::vector<ss::mapper> res;
         return map_to_key_value(ctx.get_token_metadata().get_endpoint_to_host_id_map_for_reading(), res);
@@ -13,6 +13,7 @@
 #include <seastar/http/exception.hh>
 #include "log.hh"
 #include "replica/database.hh"
+#include "utils/sampling_profiler.hh"
 
 extern logging::logger apilog;
 
@@ -71,6 +72,36 @@ void set_system(http_context& ctx, routes& r) {
         return json::json_void();
     });
 
+    hs::get_cpu_profile.set(r, [](std::unique_ptr<request> req) {
+        auto parse = [&req] (const char* name, long def, long max) {
+            auto value = req->get_query_param(name);
+            if (value.empty()) {
+                return def;
+            }
+            long ret;
+            try {
+                ret = std::stol(value);
+            } catch (...) {
+                throw bad_param_exception(format("Invalid {}: {}", name, value));
+            }
+            if (ret <= 0 || ret > max) {
+                throw bad_param_exception(format("{} must be between 1 and {}", name, max));
+            }
+            return ret;
+        };
+        auto duration = std::chrono::seconds(parse("duration", 10, 600));
+        auto period = std::chrono::microseconds(parse("period_us", 10000, 1000000));
+        apilog.info("Profiling CPU usage for {}s every {}us", duration.count(), period.count());
+        return utils::sampling_profiler::profile(duration, period).then([] (utils::sampling_profiler::folded_stacks stacks) {
+            std::vector<sstring> res;
+            res.reserve(stacks.size());
+            for (auto& [stack, count] : stacks) {
+                res.push_back(format("{} {}", stack, count));
+            }
+            return make_ready_future<json::json_return_type>(std::move(res));
+        });
+    });
+
     hs::drop_sstable_caches.set(r, [&ctx](std::unique_ptr<request> req) {
         apilog.info("Dropping sstable caches");
         return ctx.db.invoke_on_all([] (replica::database& db) {
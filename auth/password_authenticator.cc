@@ -29,6 +29,8 @@
 #include "utils/class_registrator.hh"
 #include "replica/database.hh"
 #include "cql3/query_processor.hh"
+#include "hashers.hh"
+#include "utils/alien_worker.hh"
 
 namespace auth {
 
@@ -57,6 +59,58 @@ password_authenticator::password_authenticator(cql3::query_processor& qp, ::serv
     : _qp(qp)
     , _migration_manager(mm)
     , _stopped(make_ready_future<>()) {
+    static thread_local std::random_device rd{};
+    _digest_salt = bytes(bytes::initialized_later(), 16);
+    std::generate(_digest_salt.begin(), _digest_salt.end(), [] { return int8_t(rd()); });
+}
+
+static constexpr auto verified_password_ttl = std::chrono::seconds(30);
+static constexpr size_t max_verified_passwords = 1024;
+
+// Shared by all shards. Hashing only runs on logins which miss
+// _verified_passwords, so a few threads are enough.
+static utils::alien_worker& hashing_worker() {
+    static utils::alien_worker worker(std::clamp(smp::count / 8, 1u, 4u));
+    return worker;
+}
+
+bytes password_authenticator::password_digest(const sstring& password) const {
+    sha256_hasher h;
+    h.update(reinterpret_cast<const char*>(_digest_salt.data()), _digest_salt.size());
+    h.update(password.data(), password.size());
+    return h.finalize();
+}
+
+future<bool> password_authenticator::check_password(const sstring& username, const sstring& password, const sstring& salted_hash) const {
+    const auto now = lowres_clock::now();
+    auto digest = password_digest(password);
+    if (auto it = _verified_passwords.find(username); it != _verified_passwords.end()) {
+        auto& v = it->second;
+        if (v.expiry > now && v.salted_hash == salted_hash && v.digest == digest) {
+            ++_stats.verified_password_hits;
+            return make_ready_future<bool>(true);
+        }
+        _verified_passwords.erase(it);
+    }
+    ++_stats.password_hashes;
+    // The gate keeps the shard's authenticator alive until the worker hands back the result.
+    return with_gate(_hashing_gate, [password, salted_hash] {
+        return hashing_worker().submit<bool>([password, salted_hash] {
+            return passwords::check(password, salted_hash);
+        });
+    }).then([this, username, salted_hash, digest = std::move(digest)] (bool ok) mutable {
+        if (!ok) {
+            return false;
+        }
+        const auto now = lowres_clock::now();
+        if (_verified_passwords.size() >= max_verified_passwords) {
+            std::erase_if(_verified_passwords, [now] (const auto& e) { return e.second.expiry <= now; });
+        }
+        if (_verified_passwords.size() < max_verified_passwords) {
+            _verified_passwords.insert_or_assign(username, verified_password{std::move(salted_hash), std::move(digest), now + verified_password_ttl});
+        }
+        return true;
+    });
 }
 
 static bool has_salted_hash(const cql3::untyped_result_set_row& row) {
@@ -157,7 +211,9 @@ future<> password_authenticator::start() {
 
 future<> password_authenticator::stop() {
     _as.request_abort();
-    return _stopped.handle_exception_type([] (const sleep_aborted&) { }).handle_exception_type([](const abort_requested_exception&) {});
+    return _stopped.handle_exception_type([] (const sleep_aborted&) { }).handle_exception_type([](const abort_requested_exception&) {}).then([this] {
+        return _hashing_gate.close();
+    });
 }
 
 db::consistency_level password_authenticator::consistency_for_user(std::string_view role_name) {
@@ -212,14 +268,18 @@ future<authenticated_user> password_authenticator::authenticate(
                 internal_distributed_query_state(),
                 {username},
                 cql3::query_processor::cache_internal::yes);
-    }).then_wrapped([=](future<::shared_ptr<cql3::untyped_result_set>> f) {
+    }).then([this, username, password] (::shared_ptr<cql3::untyped_result_set> res) {
+        auto salted_hash = std::optional<sstring>();
+        if (!res->empty()) {
+            salted_hash = res->one().get_opt<sstring>(SALTED_HASH);
+        }
+        if (!salted_hash) {
+            return make_ready_future<bool>(false);
+        }
+        return check_password(username, password, *salted_hash);
+    }).then_wrapped([=](future<bool> f) {
         try {
-            auto res = f.get0();
-            auto salted_hash = std::optional<sstring>();
-            if (!res->empty()) {
-                salted_hash = res->one().get_opt<sstring>(SALTED_HASH);
-            }
-            if (!salted_hash || !passwords::check(password, *salted_hash)) {
+            if (!f.get0()) {
                 throw exceptions::authentication_exception("Username and/or password are incorrect");
             }
             return make_ready_future<authenticated_user>(username);
@@ -11,6 +11,8 @@
 #pragma once
 
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
 
 #include "auth/authenticator.hh"
 
@@ -33,6 +35,27 @@ class password_authenticator : public authenticator {
     ::service::migration_manager& _migration_manager;
     future<> _stopped;
     seastar::abort_source _as;
+    // Held by password checks waiting for the hashing worker.
+    mutable seastar::gate _hashing_gate;
+
+    // Recently verified passwords, so that a client reconnecting (or opening
+    // many connections) doesn't pay for hashing each time. An entry is only
+    // used while the stored salted hash is unchanged.
+    struct verified_password {
+        sstring salted_hash;
+        bytes digest; // of the cleartext password, see password_digest()
+        lowres_clock::time_point expiry;
+    };
+    mutable std::unordered_map<sstring, verified_password> _verified_passwords;
+    bytes _digest_salt;
+
+public:
+    struct stats {
+        uint64_t password_hashes = 0; // passwords checked by hashing them
+        uint64_t verified_password_hits = 0; // passwords accepted as recently verified
+    };
+private:
+    mutable stats _stats;
 
 public:
     static db::consistency_level consistency_for_user(std::string_view role_name);
@@ -67,9 +90,16 @@ class password_authenticator : public authenticator {
 
     virtual ::shared_ptr<sasl_challenge> new_sasl_challenge() const override;
 
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+
 private:
     bool legacy_metadata_exists() const;
 
+    bytes password_digest(const sstring& password) const;
+    future<bool> check_password(const sstring& username, const sstring& password, const sstring& salted_hash) const;
+
     future<> migrate_legacy_metadata() const;
 
     future<> create_default_if_missing() const;
@@ -35,4 +35,12 @@ future<permission_set> permissions_cache::get(const role_or_anonymous& maybe_rol
     });
 }
 
+std::optional<permission_set> permissions_cache::find(const role_or_anonymous& maybe_role, const resource& r) {
+    auto v = _cache.find(key_type(maybe_role, r));
+    if (!v) {
+        return std::nullopt;
+    }
+    return *v;
+}
+
 }
@@ -67,6 +67,8 @@ class permissions_cache final {
     bool update_config(utils::loading_cache_config);
     void reset();
     future<permission_set> get(const role_or_anonymous&, const resource&);
+    // Returns the cached permissions, without loading them on a miss.
+    std::optional<permission_set> find(const role_or_anonymous&, const resource&);
 };
 
 }
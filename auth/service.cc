@@ -288,6 +288,10 @@ future<permission_set> service::get_permissions(const role_or_anonymous& maybe_r
     return _permissions_cache->get(maybe_role, r);
 }
 
+std::optional<permission_set> service::find_cached_permissions(const role_or_anonymous& maybe_role, const resource& r) const {
+    return _permissions_cache->find(maybe_role, r);
+}
+
 future<bool> service::has_superuser(std::string_view role_name) const {
     return this->get_roles(std::move(role_name)).then([this](role_set roles) {
         return do_with(std::move(roles), [this](const role_set& roles) {
@@ -378,6 +382,12 @@ future<permission_set> get_permissions(const service& ser, const authenticated_u
     });
 }
 
+std::optional<permission_set> find_cached_permissions(const service& ser, const authenticated_user& u, const resource& r) {
+    role_or_anonymous maybe_role;
+    maybe_role.name = u.name;
+    return ser.find_cached_permissions(maybe_role, r);
+}
+
 bool is_enforcing(const service& ser)  {
     const bool enforcing_authorizer = ser.underlying_authorizer().qualified_java_name() != allow_all_authorizer_name;
 
@@ -127,6 +127,11 @@ class service final : public seastar::peering_sharded_service<service> {
     ///
     future<permission_set> get_permissions(const role_or_anonymous&, const resource&) const;
 
+    ///
+    /// Like \ref get_permissions, but only returns cached permissions, and doesn't load them on a miss.
+    ///
+    std::optional<permission_set> find_cached_permissions(const role_or_anonymous&, const resource&) const;
+
     ///
     /// Like \ref get_permissions, but never returns cached permissions.
     ///
@@ -173,6 +178,8 @@ future<role_set> get_roles(const service&, const authenticated_user&);
 
 future<permission_set> get_permissions(const service&, const authenticated_user&, const resource&);
 
+std::optional<permission_set> find_cached_permissions(const service&, const authenticated_user&, const resource&);
+
 ///
 /// Access-control is "enforcing" when either the authenticator or the authorizer are not their "allow-all" variants.
 ///
@@ -13,6 +13,7 @@
 #include <seastar/core/file.hh>
 #include <chrono>
 #include <cmath>
+#include <optional>
 
 #include "seastarx.hh"
 
@@ -35,6 +36,13 @@
 // region, and aggressively in the third region.
 //
 // The constants q1 and q2 are used to determine the proportional factor at each stage.
+//
+// The shares computed from the control points are the target the controller moves towards, rather
+// than the shares it sets directly: shares approach the target exponentially, with the given
+// smoothing time constant. Bursty input then doesn't translate into swings of the shares, which
+// would otherwise alternate between starving the process and hurting the latency of foreground
+// work. Reaching the last control point is an emergency, in which the maximum shares are set
+// immediately.
 class backlog_controller {
 public:
     struct scheduling_group {
@@ -70,6 +78,11 @@ class backlog_controller {
     // When that option is deprecated we should remove this.
     float _static_shares;
 
+    // The fraction of the distance to the target shares that is covered in a single
+    // adjustment, 1 if shares are not smoothed.
+    float _smoothing_factor;
+    std::optional<float> _current_shares;
+
     virtual void update_controller(float quota);
 
     bool controller_disabled() const noexcept {
@@ -77,16 +90,18 @@ class backlog_controller {
     }
 
     void adjust();
+    void set_shares(float shares);
 
     backlog_controller(scheduling_group sg, std::chrono::milliseconds interval,
                        std::vector<control_point> control_points, std::function<float()> backlog,
-                       float static_shares = 0)
+                       float static_shares = 0, std::chrono::milliseconds smoothing = std::chrono::milliseconds(0))
         : _scheduling_group(std::move(sg))
         , _update_timer([this] { adjust(); })
         , _control_points()
         , _current_backlog(std::move(backlog))
         , _inflight_update(make_ready_future<>())
         , _static_shares(static_shares)
+        , _smoothing_factor(float(interval.count()) / float(interval.count() + smoothing.count()))
     {
         _control_points.insert(_control_points.end(), control_points.begin(), control_points.end());
         _update_timer.arm_periodic(interval);
@@ -96,6 +111,11 @@ class backlog_controller {
 public:
     backlog_controller(backlog_controller&&) = default;
     float backlog_of_shares(float shares) const;
+
+    // The shares most recently set by the controller, 0 before the first adjustment.
+    float current_shares() const noexcept {
+        return _current_shares.value_or(0.0f);
+    }
 };
 
 // memtable flush CPU controller.
@@ -116,11 +136,13 @@ class backlog_controller {
 class flush_controller : public backlog_controller {
     static constexpr float hard_dirty_limit = 1.0f;
 public:
-    flush_controller(backlog_controller::scheduling_group sg, float static_shares, std::chrono::milliseconds interval, float soft_limit, std::function<float()> current_dirty)
+    flush_controller(backlog_controller::scheduling_group sg, float static_shares, std::chrono::milliseconds interval, float soft_limit, std::function<float()> current_dirty,
+                     std::chrono::milliseconds smoothing = std::chrono::milliseconds(0))
         : backlog_controller(std::move(sg), std::move(interval),
           std::vector<backlog_controller::control_point>({{0.0, 0.0}, {soft_limit, 10}, {soft_limit + (hard_dirty_limit - soft_limit) / 2, 200} , {hard_dirty_limit, 1000}}),
           std::move(current_dirty),
-          static_shares
+          static_shares,
+          smoothing
         )
     {}
 };
@@ -130,11 +152,13 @@ class compaction_controller : public backlog_controller {
     static constexpr unsigned normalization_factor = 30;
     static constexpr float disable_backlog = std::numeric_limits<double>::infinity();
     static constexpr float backlog_disabled(float backlog) { return std::isinf(backlog); }
-    compaction_controller(backlog_controller::scheduling_group sg, float static_shares, std::chrono::milliseconds interval, std::function<float()> current_backlog)
+    compaction_controller(backlog_controller::scheduling_group sg, float static_shares, std::chrono::milliseconds interval, std::function<float()> current_backlog,
+                          std::chrono::milliseconds smoothing = std::chrono::milliseconds(0))
         : backlog_controller(std::move(sg), std::move(interval),
           std::vector<backlog_controller::control_point>({{0.0, 50}, {1.5, 100} , {normalization_factor, 1000}}),
           std::move(current_backlog),
-          static_shares
+          static_shares,
+          smoothing
         )
     {}
 };
@@ -12,6 +12,7 @@
 
 #include "bytes.hh"
 #include "utils/managed_bytes.hh"
+#include "utils/fragment_pool.hh"
 #include "hashing.hh"
 #include <seastar/core/simple-stream.hh>
 #include <seastar/core/loop.hh>
@@ -143,7 +144,7 @@ class bytes_ostream {
     [[gnu::noinline]]
     value_type* alloc_new(size_type size) {
             auto alloc_size = next_alloc_size(size);
-            auto space = malloc(alloc_size);
+            auto space = utils::fragment_pool::allocate(alloc_size);
             if (!space) {
                 throw std::bad_alloc();
             }
@@ -158,7 +159,7 @@ class bytes_ostream {
         while (c) {
             auto n = c->next;
             c->~chunk();
-            ::free(c);
+            utils::fragment_pool::free(c);
             c = n;
         }
     }
@@ -281,7 +282,7 @@ class bytes_ostream {
             return view();
         }
 
-        auto space = malloc(_size + sizeof(chunk));
+        auto space = utils::fragment_pool::allocate(_size + sizeof(chunk));
         if (!space) {
             throw std::bad_alloc();
         }
@@ -295,7 +296,7 @@ class bytes_ostream {
             auto next = r->next;
             dst = std::copy_n(r->data, r->frag_size, dst);
             r->~chunk();
-            ::free(r);
+            utils::fragment_pool::free(r);
             r = next;
         }
 
@@ -480,7 +481,7 @@ class bytes_ostream {
             auto second_chunk = _begin.ptr->next;
             auto next = second_chunk->next;
             second_chunk->~chunk();
-            ::free(second_chunk);
+            utils::fragment_pool::free(second_chunk);
             _begin->next = std::move(next);
             return make_ready_future<>();
         });
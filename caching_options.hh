@@ -25,7 +25,11 @@ class caching_options {
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled);
+    // If set, partitions missing from the cache are only populated into it
+    // when they were read recently more often than the partitions evicted
+    // to make room for them, rather than on every read.
+    bool _admit_frequent_only = false;
+    caching_options(sstring k, sstring r, bool enabled, bool admit_frequent_only = false);
 
     friend class schema;
     caching_options();
@@ -34,6 +38,10 @@ class caching_options {
         return _enabled;
     }
 
+    bool admit_frequent_only() const {
+        return _admit_frequent_only;
+    }
+
     std::map<sstring, sstring> to_map() const;
 
     sstring to_sstring() const;
@@ -33,12 +33,26 @@ enum class image_mode : uint8_t {
     full,
 };
 
+/**
+ * Where the pre-image of a write is read from.
+ * query == a read at the consistency level of the write, before the write
+ * cache == the memtables and row cache of the coordinator, if it is a replica.
+ *          Rows which can't be served from memory get a pre_image_unknown
+ *          log row instead of a pre-image.
+ */
+enum class image_source : uint8_t {
+    query,
+    cache,
+};
+
 std::ostream& operator<<(std::ostream& os, delta_mode);
 std::ostream& operator<<(std::ostream& os, image_mode);
+std::ostream& operator<<(std::ostream& os, image_source);
 
 class options final {
     std::optional<bool> _enabled;
     image_mode _preimage = image_mode::off;
+    image_source _preimage_source = image_source::query;
     bool _postimage = false;
     delta_mode _delta_mode = delta_mode::full;
     int _ttl = 86400; // 24h in seconds
@@ -53,6 +67,7 @@ class options final {
     bool is_enabled_set() const { return _enabled.has_value(); }
     bool preimage() const { return _preimage != image_mode::off; }
     bool full_preimage() const { return _preimage == image_mode::full; }
+    image_source preimage_source() const { return _preimage_source; }
     bool postimage() const { return _postimage; }
     delta_mode get_delta_mode() const { return _delta_mode; }
     void set_delta_mode(delta_mode m) { _delta_mode = m; }
@@ -61,6 +76,7 @@ class options final {
     void enabled(bool b) { _enabled = b; }
     void preimage(bool b) { preimage(b ? image_mode::on : image_mode::off); }
     void preimage(image_mode m) { _preimage = m; }
+    void preimage_source(image_source s) { _preimage_source = s; }
     void postimage(bool b) { _postimage = b; }
     void ttl(int v) { _ttl = v; }
 
@@ -13,6 +13,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <seastar/core/thread.hh>
 #include <seastar/core/metrics.hh>
+#include <seastar/core/coroutine.hh>
 
 #include "cdc/log.hh"
 #include "cdc/generation.hh"
@@ -41,6 +42,7 @@
 #include "concrete_types.hh"
 #include "types/listlike_partial_deserializing_iterator.hh"
 #include "tracing/trace_state.hh"
+#include "utils/fb_utilities.hh"
 #include "stats.hh"
 #include "compaction/compaction_strategy.hh"
 
@@ -103,6 +105,10 @@ cdc::stats::stats() {
                         sm::description(format("number of {} preimage queries performed", kind)),
                         {}),
 
+                sm::make_total_operations("preimage_unknown_" + kind, counters.preimage_unknown,
+                        sm::description(format("number of {} preimage reads which couldn't be served from memory", kind)),
+                        {}),
+
                 sm::make_total_operations("operations_with_preimage_" + kind, counters.with_preimage_count,
                         sm::description(format("number of {} operations that included preimage", kind)),
                         {}),
@@ -290,6 +296,9 @@ static const sstring delta_mode_string_full = "full";
 
 static const std::string_view image_mode_string_full = delta_mode_string_full;
 
+static const sstring image_source_string_query = "query";
+static const sstring image_source_string_cache = "cache";
+
 sstring to_string(cdc::delta_mode dm) {
     switch (dm) {
         case cdc::delta_mode::keys : return delta_mode_string_keys;
@@ -307,6 +316,14 @@ sstring to_string(cdc::image_mode m) {
     throw std::logic_error("Impossible value of cdc::image_mode");
 }
 
+sstring to_string(cdc::image_source s) {
+    switch (s) {
+        case cdc::image_source::query : return image_source_string_query;
+        case cdc::image_source::cache : return image_source_string_cache;
+    }
+    throw std::logic_error("Impossible value of cdc::image_source");
+}
+
 } // anon. namespace
 
 std::ostream& cdc::operator<<(std::ostream& os, delta_mode m) {
@@ -317,6 +334,10 @@ std::ostream& cdc::operator<<(std::ostream& os, image_mode m) {
     return os << to_string(m);
 }
 
+std::ostream& cdc::operator<<(std::ostream& os, image_source s) {
+    return os << to_string(s);
+}
+
 cdc::options::options(const std::map<sstring, sstring>& map) {
     for (auto& p : map) {
         auto key = p.first;
@@ -344,6 +365,14 @@ cdc::options::options(const std::map<sstring, sstring>& map) {
             } else {
                 throw exceptions::configuration_exception("Invalid value for CDC option \"preimage\": " + p.second);
             }
+        } else if (key == "preimage_source") {
+            if (val == image_source_string_query) {
+                _preimage_source = image_source::query;
+            } else if (val == image_source_string_cache) {
+                _preimage_source = image_source::cache;
+            } else {
+                throw exceptions::configuration_exception("Invalid value for CDC option \"preimage_source\": " + p.second);
+            }
         } else if (key == "postimage") {
             if (is_true || is_false) {
                 _postimage = is_true;    
@@ -378,13 +407,18 @@ std::map<sstring, sstring> cdc::options::to_map() const {
         return {};
     }
 
-    return {
+    std::map<sstring, sstring> ret = {
         { "enabled", enabled() ? "true" : "false" },
         { "preimage", to_string(_preimage) },
         { "postimage", _postimage ? "true" : "false" },
         { "delta", to_string(_delta_mode) },
         { "ttl", std::to_string(_ttl) },
     };
+    // Only stored when set, so that schemas which don't use it can be read by nodes which don't know it.
+    if (_preimage_source != image_source::query) {
+        ret.emplace("preimage_source", to_string(_preimage_source));
+    }
+    return ret;
 }
 
 sstring cdc::options::to_sstring() const {
@@ -393,7 +427,7 @@ sstring cdc::options::to_sstring() const {
 
 bool cdc::options::operator==(const options& o) const {
     return enabled() == o.enabled() && _preimage == o._preimage && _postimage == o._postimage && _ttl == o._ttl
-            && _delta_mode == o._delta_mode;
+            && _delta_mode == o._delta_mode && _preimage_source == o._preimage_source;
 }
 bool cdc::options::operator!=(const options& o) const {
     return !(*this == o);
@@ -1351,6 +1385,98 @@ struct process_change_visitor {
     constexpr bool finished() const { return false; }
 };
 
+struct preimage_query {
+    lw_shared_ptr<query::read_command> command;
+    ::shared_ptr<cql3::selection::selection> selection;
+};
+
+// Builds the query for the current values of the rows touched by the mutation.
+// Returns disengaged optional if the mutation doesn't touch any row.
+static std::optional<preimage_query> make_preimage_query(service::storage_proxy& proxy, const schema_ptr& s, const mutation& m) {
+    auto& p = m.partition();
+    if (p.clustered_rows().empty() && p.static_row().empty()) {
+        return std::nullopt;
+    }
+
+    auto&& pc = s->partition_key_columns();
+    auto&& cc = s->clustering_key_columns();
+
+    std::vector<query::clustering_range> bounds;
+    uint64_t row_limit = query::max_rows;
+
+    const bool has_only_static_row = !p.static_row().empty() && p.clustered_rows().empty();
+    if (cc.empty() || has_only_static_row) {
+        bounds.push_back(query::clustering_range::make_open_ended_both_sides());
+        if (has_only_static_row) {
+            row_limit = 1;
+        }
+    } else {
+        for (const rows_entry& r : p.clustered_rows()) {
+            auto& ck = r.key();
+            bounds.push_back(query::clustering_range::make_singular(ck));
+        }
+    }
+
+    std::vector<const column_definition*> columns;
+    columns.reserve(s->all_columns().size());
+
+    std::transform(pc.begin(), pc.end(), std::back_inserter(columns), [](auto& c) { return &c; });
+    std::transform(cc.begin(), cc.end(), std::back_inserter(columns), [](auto& c) { return &c; });
+
+    query::column_id_vector static_columns, regular_columns;
+
+    // TODO: this assumes all mutations touch the same set of columns. This might not be true, and we may need to do more horrible set operation here.
+    if (!p.static_row().empty()) {
+        // for postimage we need everything...
+        if (s->cdc_options().postimage() || s->cdc_options().full_preimage()) {
+            for (const column_definition& c: s->static_columns()) {
+                static_columns.emplace_back(c.id);
+                columns.emplace_back(&c);
+            }
+        } else {
+            p.static_row().get().for_each_cell([&] (column_id id, const atomic_cell_or_collection&) {
+                auto& cdef =s->column_at(column_kind::static_column, id);
+                static_columns.emplace_back(id);
+                columns.emplace_back(&cdef);
+            });
+        }
+    }
+    if (!p.clustered_rows().empty()) {
+        const bool has_row_delete = std::any_of(p.clustered_rows().begin(), p.clustered_rows().end(), [] (const rows_entry& re) {
+            return re.row().deleted_at();
+        });
+        // for postimage we need everything...
+        if (has_row_delete || s->cdc_options().postimage() || s->cdc_options().full_preimage()) {
+            for (const column_definition& c: s->regular_columns()) {
+                regular_columns.emplace_back(c.id);
+                columns.emplace_back(&c);
+            }
+        } else {
+            p.clustered_rows().begin()->row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection&) {
+                const auto& cdef =s->column_at(column_kind::regular_column, id);
+                regular_columns.emplace_back(id);
+                columns.emplace_back(&cdef);
+            });
+        }
+    }
+    
+    auto selection = cql3::selection::selection::for_columns(s, std::move(columns));
+
+    auto opts = selection->get_query_options();
+    opts.set(query::partition_slice::option::collections_as_maps);
+    opts.set_if<query::partition_slice::option::always_return_static_content>(!p.static_row().empty());
+
+    auto partition_slice = query::partition_slice(std::move(bounds), std::move(static_columns), std::move(regular_columns), std::move(opts));
+    const auto max_result_size = proxy.get_max_result_size(partition_slice);
+    const auto tombstone_limit = query::tombstone_limit(proxy.get_tombstone_limit());
+    auto command = ::make_lw_shared<query::read_command>(s->id(), s->version(), std::move(partition_slice), query::max_result_size(max_result_size), tombstone_limit, query::row_limit(row_limit));
+    return preimage_query{std::move(command), std::move(selection)};
+}
+
+static lw_shared_ptr<cql3::untyped_result_set> make_preimage_result_set(const schema& s, const preimage_query& q, foreign_ptr<lw_shared_ptr<query::result>> result) {
+    return make_lw_shared<cql3::untyped_result_set>(s, std::move(result), *q.selection, q.command->slice);
+}
+
 class transformer final : public change_processor {
 private:
     db_context _ctx;
@@ -1443,6 +1569,9 @@ class transformer final : public change_processor {
 
     stats::part_type_set _touched_parts;
 
+    // Set when the state of the rows before the change couldn't be read.
+    bool _preimage_unknown = false;
+
 public:
     transformer(db_context ctx, schema_ptr s, dht::decorated_key dk)
         : _ctx(ctx)
@@ -1478,6 +1607,17 @@ class transformer final : public change_processor {
 
         assert(_builder);
 
+        if (_preimage_unknown) {
+            // Without the preimage, the postimage would be missing the columns which the change didn't touch.
+            if (op == operation::pre_image) {
+                auto image_ck = _builder->allocate_new_log_row(operation::pre_image_unknown);
+                if (ck) {
+                    _builder->set_clustering_columns(image_ck, *ck);
+                }
+            }
+            return;
+        }
+
         const auto kind = ck ? column_kind::regular_column : column_kind::static_column;
 
         cell_map* row_state;
@@ -1578,92 +1718,20 @@ class transformer final : public change_processor {
             db::consistency_level write_cl,
             const mutation& m)
     {
-        auto& p = m.partition();
-        if (p.clustered_rows().empty() && p.static_row().empty()) {
+        auto q = make_preimage_query(_ctx._proxy, _schema, m);
+        if (!q) {
             return make_ready_future<lw_shared_ptr<cql3::untyped_result_set>>();
         }
 
         dht::partition_range_vector partition_ranges{dht::partition_range(m.decorated_key())};
 
-        auto&& pc = _schema->partition_key_columns();
-        auto&& cc = _schema->clustering_key_columns();
-
-        std::vector<query::clustering_range> bounds;
-        uint64_t row_limit = query::max_rows;
-
-        const bool has_only_static_row = !p.static_row().empty() && p.clustered_rows().empty();
-        if (cc.empty() || has_only_static_row) {
-            bounds.push_back(query::clustering_range::make_open_ended_both_sides());
-            if (has_only_static_row) {
-                row_limit = 1;
-            }
-        } else {
-            for (const rows_entry& r : p.clustered_rows()) {
-                auto& ck = r.key();
-                bounds.push_back(query::clustering_range::make_singular(ck));
-            }
-        }
-
-        std::vector<const column_definition*> columns;
-        columns.reserve(_schema->all_columns().size());
-
-        std::transform(pc.begin(), pc.end(), std::back_inserter(columns), [](auto& c) { return &c; });
-        std::transform(cc.begin(), cc.end(), std::back_inserter(columns), [](auto& c) { return &c; });
-
-        query::column_id_vector static_columns, regular_columns;
-
-        // TODO: this assumes all mutations touch the same set of columns. This might not be true, and we may need to do more horrible set operation here.
-        if (!p.static_row().empty()) {
-            // for postimage we need everything...
-            if (_schema->cdc_options().postimage() || _schema->cdc_options().full_preimage()) {
-                for (const column_definition& c: _schema->static_columns()) {
-                    static_columns.emplace_back(c.id);
-                    columns.emplace_back(&c);
-                }
-            } else {
-                p.static_row().get().for_each_cell([&] (column_id id, const atomic_cell_or_collection&) {
-                    auto& cdef =_schema->column_at(column_kind::static_column, id);
-                    static_columns.emplace_back(id);
-                    columns.emplace_back(&cdef);
-                });
-            }
-        }
-        if (!p.clustered_rows().empty()) {
-            const bool has_row_delete = std::any_of(p.clustered_rows().begin(), p.clustered_rows().end(), [] (const rows_entry& re) {
-                return re.row().deleted_at();
-            });
-            // for postimage we need everything...
-            if (has_row_delete || _schema->cdc_options().postimage() || _schema->cdc_options().full_preimage()) {
-                for (const column_definition& c: _schema->regular_columns()) {
-                    regular_columns.emplace_back(c.id);
-                    columns.emplace_back(&c);
-                }
-            } else {
-                p.clustered_rows().begin()->row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection&) {
-                    const auto& cdef =_schema->column_at(column_kind::regular_column, id);
-                    regular_columns.emplace_back(id);
-                    columns.emplace_back(&cdef);
-                });
-            }
-        }
-        
-        auto selection = cql3::selection::selection::for_columns(_schema, std::move(columns));
-
-        auto opts = selection->get_query_options();
-        opts.set(query::partition_slice::option::collections_as_maps);
-        opts.set_if<query::partition_slice::option::always_return_static_content>(!p.static_row().empty());
-
-        auto partition_slice = query::partition_slice(std::move(bounds), std::move(static_columns), std::move(regular_columns), std::move(opts));
-        const auto max_result_size = _ctx._proxy.get_max_result_size(partition_slice);
-        const auto tombstone_limit = query::tombstone_limit(_ctx._proxy.get_tombstone_limit());
-        auto command = ::make_lw_shared<query::read_command>(_schema->id(), _schema->version(), partition_slice, query::max_result_size(max_result_size), tombstone_limit, query::row_limit(row_limit));
-
         const auto select_cl = adjust_cl(write_cl);
 
       try {
+        auto command = q->command;
         return _ctx._proxy.query(_schema, std::move(command), std::move(partition_ranges), select_cl, service::storage_proxy::coordinator_query_options(default_timeout(), empty_service_permit(), client_state)).then(
-                [s = _schema, partition_slice = std::move(partition_slice), selection = std::move(selection)] (service::storage_proxy::coordinator_query_result qr) -> lw_shared_ptr<cql3::untyped_result_set> {
-            return make_lw_shared<cql3::untyped_result_set>(*s, std::move(qr.query_result), *selection, partition_slice);
+                [s = _schema, q = std::move(*q)] (service::storage_proxy::coordinator_query_result qr) -> lw_shared_ptr<cql3::untyped_result_set> {
+            return make_preimage_result_set(*s, q, std::move(qr.query_result));
         });
       } catch (exceptions::unavailable_exception& e) {
         // `query` can throw `unavailable_exception`, which is seen by clients as ~ "NoHostAvailable". 
@@ -1674,6 +1742,12 @@ class transformer final : public change_processor {
       }
     }
 
+    // Marks the state of the rows before the change as unknown.
+    // Must be called before the first begin_timestamp().
+    void set_preimage_unknown() {
+        _preimage_unknown = true;
+    }
+
     // Note: this assumes that the results are from one partition only
     void load_preimage_results_into_state(lw_shared_ptr<cql3::untyped_result_set> preimage_set, bool static_only) {
         // static row
@@ -1745,6 +1819,111 @@ transform_mutations(std::vector<mutation>& muts, decltype(muts.size()) batch_siz
         .then([&muts] () mutable { return std::move(muts); });
 }
 
+// A preimage read from memory. A null result set which isn't unknown means
+// that the mutation doesn't touch any rows.
+struct cached_preimage {
+    lw_shared_ptr<cql3::untyped_result_set> result_set;
+    bool unknown = false;
+};
+
+struct cache_read_request {
+    global_schema_ptr schema;
+    lw_shared_ptr<query::read_command> command;
+    dht::decorated_key key;
+};
+
+using cache_read_results = std::vector<foreign_ptr<lw_shared_ptr<query::result>>>;
+
+// Runs on the shard owning the partitions. The result of a partition which
+// can't be read from memory only is null.
+static future<cache_read_results> read_from_cache(replica::database& db, const std::vector<cache_read_request>& requests,
+        tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
+    cache_read_results results;
+    results.reserve(requests.size());
+    for (const auto& r : requests) {
+        schema_ptr s = r.schema;
+        if (!db.find_column_family(s).is_cached(r.key, r.command->slice)) {
+            results.emplace_back(nullptr);
+            continue;
+        }
+        auto [result, ht] = co_await db.query(s, *r.command, query::result_options::only_result(),
+                {dht::partition_range(r.key)}, trace_state, timeout);
+        results.emplace_back(make_foreign(std::move(result)));
+    }
+    co_return results;
+}
+
+// Reads the preimages of the mutations whose tables have preimage_source = cache from the memtables and
+// row cache of this node. The preimage of a partition is unknown if this node doesn't replicate it, or if
+// its touched rows can't be read without reading sstables. All reads of a shard are done in a single
+// cross-shard call. A failed read makes the preimages of the shard's mutations unknown instead of failing
+// the write.
+static future<std::vector<cached_preimage>> read_cached_preimages(db_context ctx, const std::vector<mutation>& mutations,
+        tracing::trace_state_ptr tr_state, db::timeout_clock::time_point timeout) {
+    std::vector<cached_preimage> ret(mutations.size());
+    std::vector<std::optional<preimage_query>> queries(mutations.size());
+    std::vector<std::vector<size_t>> indices_by_shard(smp::count);
+    auto& stats = ctx._proxy.get_cdc_stats();
+    const auto me = utils::fb_utilities::get_broadcast_address();
+
+    for (size_t i = 0; i < mutations.size(); ++i) {
+        auto& m = mutations[i];
+        auto& opts = m.schema()->cdc_options();
+        if (!opts.enabled() || opts.preimage_source() != image_source::cache || !(opts.preimage() || opts.postimage())) {
+            continue;
+        }
+        queries[i] = make_preimage_query(ctx._proxy, m.schema(), m);
+        if (!queries[i]) {
+            continue;
+        }
+        stats.counters_total.preimage_selects++;
+        auto erm = ctx._proxy.get_db().local().find_keyspace(m.schema()->ks_name()).get_effective_replication_map();
+        auto replicas = erm->get_natural_endpoints(m.token());
+        if (std::find(replicas.begin(), replicas.end(), me) == replicas.end()) {
+            ret[i].unknown = true;
+            continue;
+        }
+        indices_by_shard[dht::shard_of(*m.schema(), m.token())].push_back(i);
+    }
+
+    co_await parallel_for_each(boost::irange(0u, smp::count), [&] (unsigned shard) {
+        auto& indices = indices_by_shard[shard];
+        if (indices.empty()) {
+            return make_ready_future<>();
+        }
+        std::vector<cache_read_request> requests;
+        requests.reserve(indices.size());
+        for (auto i : indices) {
+            requests.push_back(cache_read_request{global_schema_ptr(mutations[i].schema()), queries[i]->command, mutations[i].decorated_key()});
+        }
+        return ctx._proxy.get_db().invoke_on(shard, [requests = std::move(requests), gt = tracing::global_trace_state_ptr(tr_state), timeout] (replica::database& db) {
+            return read_from_cache(db, requests, gt.get(), timeout);
+        }).then_wrapped([&, shard] (future<cache_read_results> f) {
+            cache_read_results results;
+            if (f.failed()) {
+                cdc_log.debug("Preimage: failed to read preimages from memory on shard {}: {}", shard, f.get_exception());
+                stats.counters_failed.preimage_selects += indices.size();
+                results.resize(indices.size());
+            } else {
+                results = f.get();
+            }
+            for (size_t j = 0; j < indices.size(); ++j) {
+                auto i = indices[j];
+                if (results[j]) {
+                    ret[i].result_set = make_preimage_result_set(*mutations[i].schema(), *queries[i], std::move(results[j]));
+                } else {
+                    ret[i].unknown = true;
+                }
+            }
+        });
+    });
+
+    for (auto& p : ret) {
+        stats.counters_total.preimage_unknown += p.unknown;
+    }
+    co_return ret;
+}
+
 } // namespace cdc
 
 future<std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>>
@@ -1762,71 +1941,83 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
     tracing::trace(tr_state, "CDC: Started generating mutations for log rows");
     mutations.reserve(2 * mutations.size());
 
-    return do_with(std::move(mutations), service::query_state(service::client_state::for_internal_calls(), empty_service_permit()), operation_details{},
-            [this, timeout, i, tr_state = std::move(tr_state), write_cl] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details) {
-        return transform_mutations(mutations, 1, [this, &mutations, timeout, &qs, tr_state = tr_state, &details, write_cl] (int idx) mutable {
-            auto& m = mutations[idx];
-            auto s = m.schema();
-
-            if (!s->cdc_options().enabled()) {
-                return make_ready_future<>();
-            }
-
-            transformer trans(_ctxt, s, m.decorated_key());
-
-            auto f = make_ready_future<lw_shared_ptr<cql3::untyped_result_set>>(nullptr);
-            if (s->cdc_options().preimage() || s->cdc_options().postimage()) {
-                // Note: further improvement here would be to coalesce the pre-image selects into one
-                // iff a batch contains several modifications to the same table. Otoh, batch is rare(?)
-                // so this is premature.
-                tracing::trace(tr_state, "CDC: Selecting preimage for {}", m.decorated_key());
-                f = trans.pre_image_select(qs.get_client_state(), write_cl, m).then_wrapped([this] (future<lw_shared_ptr<cql3::untyped_result_set>> f) {
-                    auto& cdc_stats = _ctxt._proxy.get_cdc_stats();
-                    cdc_stats.counters_total.preimage_selects++;
-                    if (f.failed()) {
-                        cdc_stats.counters_failed.preimage_selects++;
-                    }
-                    return f;
-                });
-            } else {
-                tracing::trace(tr_state, "CDC: Preimage not enabled for the table, not querying current value of {}", m.decorated_key());
-            }
-
-            return f.then([trans = std::move(trans), &mutations, idx, tr_state, &details] (lw_shared_ptr<cql3::untyped_result_set> rs) mutable {
+    return do_with(std::move(mutations), service::query_state(service::client_state::for_internal_calls(), empty_service_permit()), operation_details{}, std::vector<cached_preimage>{},
+            [this, timeout, i, tr_state = std::move(tr_state), write_cl] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details, std::vector<cached_preimage>& cached_preimages) {
+        return read_cached_preimages(_ctxt, mutations, tr_state, timeout).then([this, &mutations, timeout, &qs, tr_state, &details, write_cl, &cached_preimages] (std::vector<cached_preimage> r) {
+            cached_preimages = std::move(r);
+            return transform_mutations(mutations, 1, [this, &mutations, timeout, &qs, tr_state = tr_state, &details, write_cl, &cached_preimages] (int idx) mutable {
                 auto& m = mutations[idx];
-                auto& s = m.schema();
+                auto s = m.schema();
 
-                if (rs) {
-                    const auto& p = m.partition();
-                    const bool static_only = !p.static_row().empty() && p.clustered_rows().empty();
-                    trans.load_preimage_results_into_state(std::move(rs), static_only);
+                if (!s->cdc_options().enabled()) {
+                    return make_ready_future<>();
                 }
 
-                const bool preimage = s->cdc_options().preimage();
-                const bool postimage = s->cdc_options().postimage();
-                details.had_preimage |= preimage;
-                details.had_postimage |= postimage;
-                tracing::trace(tr_state, "CDC: Generating log mutations for {}", m.decorated_key());
-                if (should_split(m)) {
-                    tracing::trace(tr_state, "CDC: Splitting {}", m.decorated_key());
-                    details.was_split = true;
-                    process_changes_with_splitting(m, trans, preimage, postimage);
+                transformer trans(_ctxt, s, m.decorated_key());
+
+                auto f = make_ready_future<lw_shared_ptr<cql3::untyped_result_set>>(nullptr);
+                if (s->cdc_options().preimage_source() == image_source::cache && (s->cdc_options().preimage() || s->cdc_options().postimage())) {
+                    auto& cached = cached_preimages[idx];
+                    if (cached.unknown) {
+                        tracing::trace(tr_state, "CDC: Preimage of {} couldn't be read from memory", m.decorated_key());
+                        trans.set_preimage_unknown();
+                    } else {
+                        tracing::trace(tr_state, "CDC: Read preimage of {} from memory", m.decorated_key());
+                    }
+                    f = make_ready_future<lw_shared_ptr<cql3::untyped_result_set>>(std::move(cached.result_set));
+                } else if (s->cdc_options().preimage() || s->cdc_options().postimage()) {
+                    // Note: further improvement here would be to coalesce the pre-image selects into one
+                    // iff a batch contains several modifications to the same table. Otoh, batch is rare(?)
+                    // so this is premature.
+                    tracing::trace(tr_state, "CDC: Selecting preimage for {}", m.decorated_key());
+                    f = trans.pre_image_select(qs.get_client_state(), write_cl, m).then_wrapped([this] (future<lw_shared_ptr<cql3::untyped_result_set>> f) {
+                        auto& cdc_stats = _ctxt._proxy.get_cdc_stats();
+                        cdc_stats.counters_total.preimage_selects++;
+                        if (f.failed()) {
+                            cdc_stats.counters_failed.preimage_selects++;
+                        }
+                        return f;
+                    });
                 } else {
-                    tracing::trace(tr_state, "CDC: No need to split {}", m.decorated_key());
-                    process_changes_without_splitting(m, trans, preimage, postimage);
+                    tracing::trace(tr_state, "CDC: Preimage not enabled for the table, not querying current value of {}", m.decorated_key());
                 }
-                auto [log_mut, touched_parts] = std::move(trans).finish();
-                const int generated_count = log_mut.size();
-                mutations.insert(mutations.end(), std::make_move_iterator(log_mut.begin()), std::make_move_iterator(log_mut.end()));
 
-                // `m` might be invalidated at this point because of the push_back to the vector
-                tracing::trace(tr_state, "CDC: Generated {} log mutations from {}", generated_count, mutations[idx].decorated_key());
-                details.touched_parts.add(touched_parts);
+                return f.then([trans = std::move(trans), &mutations, idx, tr_state, &details] (lw_shared_ptr<cql3::untyped_result_set> rs) mutable {
+                    auto& m = mutations[idx];
+                    auto& s = m.schema();
+
+                    if (rs) {
+                        const auto& p = m.partition();
+                        const bool static_only = !p.static_row().empty() && p.clustered_rows().empty();
+                        trans.load_preimage_results_into_state(std::move(rs), static_only);
+                    }
+
+                    const bool preimage = s->cdc_options().preimage();
+                    const bool postimage = s->cdc_options().postimage();
+                    details.had_preimage |= preimage;
+                    details.had_postimage |= postimage;
+                    tracing::trace(tr_state, "CDC: Generating log mutations for {}", m.decorated_key());
+                    if (should_split(m)) {
+                        tracing::trace(tr_state, "CDC: Splitting {}", m.decorated_key());
+                        details.was_split = true;
+                        process_changes_with_splitting(m, trans, preimage, postimage);
+                    } else {
+                        tracing::trace(tr_state, "CDC: No need to split {}", m.decorated_key());
+                        process_changes_without_splitting(m, trans, preimage, postimage);
+                    }
+                    auto [log_mut, touched_parts] = std::move(trans).finish();
+                    const int generated_count = log_mut.size();
+                    mutations.insert(mutations.end(), std::make_move_iterator(log_mut.begin()), std::make_move_iterator(log_mut.end()));
+
+                    // `m` might be invalidated at this point because of the push_back to the vector
+                    tracing::trace(tr_state, "CDC: Generated {} log mutations from {}", generated_count, mutations[idx].decorated_key());
+                    details.touched_parts.add(touched_parts);
+                });
+            }).then([this, tr_state, &details](std::vector<mutation> mutations) {
+                tracing::trace(tr_state, "CDC: Finished generating all log mutations");
+                auto tracker = make_lw_shared<cdc::operation_result_tracker>(_ctxt._proxy.get_cdc_stats(), details);
+                return make_ready_future<std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>>(std::make_tuple(std::move(mutations), std::move(tracker)));
             });
-        }).then([this, tr_state, &details](std::vector<mutation> mutations) {
-            tracing::trace(tr_state, "CDC: Finished generating all log mutations");
-            auto tracker = make_lw_shared<cdc::operation_result_tracker>(_ctxt._proxy.get_cdc_stats(), details);
-            return make_ready_future<std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>>(std::make_tuple(std::move(mutations), std::move(tracker)));
         });
     });
 }
@@ -104,6 +104,9 @@ enum class operation : int8_t {
     pre_image = 0, update = 1, insert = 2, row_delete = 3, partition_delete = 4,
     range_delete_start_inclusive = 5, range_delete_start_exclusive = 6, range_delete_end_inclusive = 7, range_delete_end_exclusive = 8,
     post_image = 9,
+    // The row's state before the write couldn't be read from memory (preimage_source = cache),
+    // so neither its pre-image nor its post-image was recorded.
+    pre_image_unknown = 10,
 };
 
 bool is_log_for_some_table(const replica::database& db, const sstring& ks_name, const std::string_view& table_name);
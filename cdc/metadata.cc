@@ -12,6 +12,7 @@
 
 #include "cdc/generation.hh"
 #include "cdc/metadata.hh"
+#include "locator/token_index.hh"
 
 extern logging::logger cdc_log;
 
@@ -55,6 +56,37 @@ cdc::stream_id get_stream(
     return get_stream(*it, tok);
 }
 
+// non-static for testing
+cdc::stream_id get_stream(
+        const std::vector<cdc::token_range_description>& entries,
+        const locator::token_index& index,
+        dht::token tok) {
+    if (index.empty()) {
+        return get_stream(entries, tok);
+    }
+
+    auto pos = index.lower_bound(tok);
+    if (pos == entries.size()) {
+        pos = 0;
+    }
+
+    return get_stream(entries[pos], tok);
+}
+
+static locator::token_index make_index(const std::vector<cdc::token_range_description>& entries) {
+    std::vector<dht::token> ends;
+    ends.reserve(entries.size());
+    for (auto& e : entries) {
+        ends.push_back(e.token_range_end);
+    }
+    return locator::token_index(ends);
+}
+
+cdc::metadata::generation::generation(topology_description d)
+    : desc(std::move(d))
+    , index(make_index(desc.entries()))
+{ }
+
 cdc::metadata::container_t::const_iterator cdc::metadata::gen_used_at(api::timestamp_type ts) const {
     auto it = _gens.upper_bound(ts);
     if (it == _gens.begin()) {
@@ -125,7 +157,7 @@ cdc::stream_id cdc::metadata::get_stream(api::timestamp_type ts, dht::token tok)
     }
 
     auto& gen = *it->second;
-    auto ret = ::get_stream(gen.entries(), tok);
+    auto ret = ::get_stream(gen.desc.entries(), gen.index, tok);
     _last_stream_timestamp = ts;
     return ret;
 }
@@ -165,7 +197,7 @@ bool cdc::metadata::insert(db_clock::time_point tp, topology_description&& gen)
 
     }
 
-    _gens.insert_or_assign(to_ts(tp), std::move(gen));
+    _gens.insert_or_assign(to_ts(tp), generation(std::move(gen)));
     return true;
 }
 
@@ -13,6 +13,7 @@
 #include "db_clock.hh"
 #include "timestamp.hh"
 #include "cdc/generation.hh"
+#include "locator/token_index.hh"
 
 namespace dht {
     class token;
@@ -34,7 +35,16 @@ class metadata final {
     // On the other hand, timestamp_clock (1us resolution) is used for mutation timestamps,
     // and api::timestamp_type represents the number of ticks of a timestamp_clock::time_point since epoch.
 
-    using container_t = std::map<api::timestamp_type, std::optional<topology_description>>;
+    struct generation {
+        topology_description desc;
+        // Search structure over the token_range_end of desc's entries,
+        // built once when the generation is inserted.
+        locator::token_index index;
+
+        explicit generation(topology_description);
+    };
+
+    using container_t = std::map<api::timestamp_type, std::optional<generation>>;
     container_t _gens;
 
     /* The timestamp used in the last successful `get_stream` call. */
@@ -10,6 +10,7 @@
 
 #include <boost/intrusive/unordered_set.hpp>
 
+#include "absl-flat_hash_map.hh"
 #include "utils/small_vector.hh"
 #include "mutation_partition.hh"
 #include "xx_hasher.hh"
@@ -170,7 +171,7 @@ class cell_locker {
             }
             unlink();
             if (!--_parent._cell_count) {
-                delete &_parent;
+                _parent._parent.release_partition(_parent);
             }
         }
 
@@ -210,7 +211,7 @@ class cell_locker {
         };
     };
 
-    class partition_entry : public bi::unordered_set_base_hook<bi::link_mode<bi::auto_unlink>> {
+    class partition_entry {
         using cells_type = bi::unordered_set<cell_entry,
                                              bi::equal<cell_entry::equal_compare>,
                                              bi::hash<cell_entry::hasher>,
@@ -228,6 +229,7 @@ class cell_locker {
         schema_ptr _schema;
 
         friend class cell_entry;
+        friend class cell_locker;
     private:
         static constexpr size_t compute_rehash_at_size(size_t bucket_count) {
             return bucket_count * max_load_factor::num / max_load_factor::den;
@@ -252,10 +254,9 @@ class cell_locker {
             , _schema(s)
         { }
 
-        ~partition_entry() {
-            if (is_linked()) {
-                _parent._partition_count--;
-            }
+        // Reuses a released entry, which has no cells, for another partition.
+        void reset(const dht::decorated_key& dk) {
+            _key = dk;
         }
 
         // Upgrades partition entry to new schema. Returns false if all
@@ -271,44 +272,45 @@ class cell_locker {
         cells_type& cells() {
             return _cells;
         }
+    };
 
-        struct hasher {
-            size_t operator()(const dht::decorated_key& dk) const {
-                return std::hash<dht::decorated_key>()(dk);
-            }
-            size_t operator()(const partition_entry& pe) const {
-                return operator()(pe._key);
-            }
-        };
+    // Keys point to partition_entry::_key of the mapped entry.
+    struct partition_key_hash {
+        using is_transparent = void;
+        size_t operator()(const dht::decorated_key& dk) const {
+            return std::hash<dht::decorated_key>()(dk);
+        }
+        size_t operator()(const dht::decorated_key* dk) const {
+            return operator()(*dk);
+        }
+    };
 
-        class equal_compare {
-            dht::decorated_key_equals_comparator _cmp;
-        public:
-            explicit equal_compare(const schema& s) : _cmp(s) { }
-            bool operator()(const dht::decorated_key& dk, const partition_entry& pe) {
-                return _cmp(dk, pe._key);
-            }
-            bool operator()(const partition_entry& pe, const dht::decorated_key& dk) {
-                return _cmp(dk, pe._key);
-            }
-            bool operator()(const partition_entry& a, const partition_entry& b) {
-                return _cmp(a._key, b._key);
-            }
-        };
+    struct partition_key_equal {
+        using is_transparent = void;
+        dht::decorated_key_equals_comparator _cmp;
+
+        explicit partition_key_equal(const ::schema& s) : _cmp(s) { }
+        bool operator()(const dht::decorated_key* a, const dht::decorated_key* b) const {
+            return _cmp(*a, *b);
+        }
+        bool operator()(const dht::decorated_key& a, const dht::decorated_key* b) const {
+            return _cmp(a, *b);
+        }
+        bool operator()(const dht::decorated_key* a, const dht::decorated_key& b) const {
+            return _cmp(*a, b);
+        }
     };
 
-    using partitions_type = bi::unordered_set<partition_entry,
-                                              bi::equal<partition_entry::equal_compare>,
-                                              bi::hash<partition_entry::hasher>,
-                                              bi::constant_time_size<false>>;
+    // Open addressing, so that looking up a hot partition doesn't chase
+    // bucket chains, and locking a new one doesn't allocate a node.
+    using partitions_type = flat_hash_map<const dht::decorated_key*, partition_entry*, partition_key_hash, partition_key_equal>;
 
-    static constexpr size_t initial_bucket_count = 4 * 1024;
-    using max_load_factor = std::ratio<3, 4>;
+    // Entries of unlocked partitions are kept for reuse, so that locking
+    // a partition which isn't locked yet doesn't allocate one.
+    static constexpr size_t max_free_partitions = 64;
 
-    std::unique_ptr<partitions_type::bucket_type[]> _buckets;
     partitions_type _partitions;
-    size_t _partition_count = 0;
-    size_t _rehash_at_size = compute_rehash_at_size(initial_bucket_count);
+    std::vector<std::unique_ptr<partition_entry>> _free_partitions;
     schema_ptr _schema;
 
     // partitions_type uses equality comparator which keeps a reference to the
@@ -320,25 +322,35 @@ class cell_locker {
 private:
     struct locker;
 
-    static constexpr size_t compute_rehash_at_size(size_t bucket_count) {
-        return bucket_count * max_load_factor::num / max_load_factor::den;
+    partition_entry& allocate_partition(const dht::decorated_key& dk) {
+        std::unique_ptr<partition_entry> pe;
+        if (!_free_partitions.empty()) {
+            pe = std::move(_free_partitions.back());
+            _free_partitions.pop_back();
+            pe->reset(dk);
+        } else {
+            pe = std::make_unique<partition_entry>(_schema, *this, dk);
+        }
+        _partitions.emplace(&pe->_key, pe.get());
+        return *pe.release();
     }
-    void maybe_rehash() {
-        if (_partition_count >= _rehash_at_size) {
-            auto new_bucket_count = std::min(_partitions.bucket_count() * 2, _partitions.bucket_count() + 64 * 1024);
-            auto buckets = std::make_unique<partitions_type::bucket_type[]>(new_bucket_count);
-
-            _partitions.rehash(partitions_type::bucket_traits(buckets.get(), new_bucket_count));
-            _buckets = std::move(buckets);
 
-            _rehash_at_size = compute_rehash_at_size(new_bucket_count);
+    // Called once the last cell of the partition is gone.
+    void release_partition(partition_entry& pe) noexcept {
+        _partitions.erase(&pe._key);
+        std::unique_ptr<partition_entry> p(&pe);
+        // Cells of reused entries are hashed according to the entry's schema.
+        if (_free_partitions.size() < max_free_partitions && pe._schema == _schema) {
+            try {
+                _free_partitions.push_back(std::move(p));
+            } catch (...) {
+                // Not reusing the entry is fine.
+            }
         }
     }
 public:
     explicit cell_locker(schema_ptr s, cell_locker_stats& stats)
-        : _buckets(std::make_unique<partitions_type::bucket_type[]>(initial_bucket_count))
-        , _partitions(partitions_type::bucket_traits(_buckets.get(), initial_bucket_count),
-                      partition_entry::hasher(), partition_entry::equal_compare(*s))
+        : _partitions(0, partition_key_hash(), partition_key_equal(*s))
         , _schema(s)
         , _original_schema(std::move(s))
         , _stats(stats)
@@ -350,6 +362,7 @@ class cell_locker {
 
     void set_schema(schema_ptr s) {
         _schema = s;
+        _free_partitions.clear();
     }
     schema_ptr schema() const {
         return _schema;
@@ -429,42 +442,43 @@ struct cell_locker::locker {
 
 inline
 future<std::vector<locked_cell>> cell_locker::lock_cells(const dht::decorated_key& dk, partition_cells_range&& range, db::timeout_clock::time_point timeout) {
-    partition_entry::hasher pe_hash;
-    partition_entry::equal_compare pe_eq(*_schema);
-
-    auto it = _partitions.find(dk, pe_hash, pe_eq);
-    std::unique_ptr<partition_entry> partition;
-    if (it == _partitions.end()) {
-        partition = std::make_unique<partition_entry>(_schema, *this, dk);
-    } else if (!it->upgrade(_schema)) {
-        partition = std::unique_ptr<partition_entry>(&*it);
-        _partition_count--;
-        _partitions.erase(it);
+    auto it = _partitions.find(dk);
+    partition_entry* pe = it != _partitions.end() ? it->second : nullptr;
+    if (pe && !pe->upgrade(_schema)) {
+        release_partition(*pe);
+        pe = nullptr;
     }
 
-    if (partition) {
+    if (!pe) {
+        auto& partition = allocate_partition(dk);
         std::vector<locked_cell> locks;
-        for (auto&& r : range) {
-            if (r.empty()) {
-                continue;
+        try {
+            for (auto&& r : range) {
+                if (r.empty()) {
+                    continue;
+                }
+                for (auto&& c : r) {
+                    auto cell = make_lw_shared<cell_entry>(partition, position_in_partition(r.position()), c);
+                    _stats.lock_acquisitions++;
+                    // Inserted last, so that cells are linked only if the lock is held.
+                    locks.emplace_back(cell);
+                    partition.insert(std::move(cell));
+                }
             }
-            for (auto&& c : r) {
-                auto cell = make_lw_shared<cell_entry>(*partition, position_in_partition(r.position()), c);
-                _stats.lock_acquisitions++;
-                partition->insert(cell);
-                locks.emplace_back(std::move(cell));
+        } catch (...) {
+            if (locks.empty()) {
+                release_partition(partition);
             }
+            throw;
         }
 
-        if (!locks.empty()) {
-            _partitions.insert(*partition.release());
-            _partition_count++;
-            maybe_rehash();
+        if (locks.empty()) {
+            release_partition(partition);
         }
         return make_ready_future<std::vector<locked_cell>>(std::move(locks));
     }
 
-    auto l = std::make_unique<locker>(*_schema, _stats, *it, std::move(range), timeout);
+    auto l = std::make_unique<locker>(*_schema, _stats, *pe, std::move(range), timeout);
     auto f = l->lock_all();
     return f.then([l = std::move(l)] {
         return std::move(*l).get();
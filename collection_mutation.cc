@@ -301,7 +301,75 @@ merge(collection_mutation_view_description a, collection_mutation_view_descripti
     return merged;
 }
 
+// Appending is the common way of updating large collections: list appends, and
+// additions of set elements or map entries which sort after the existing ones.
+// If all cells of b sort after the cells of a, b has no tombstone and the
+// tombstone of a covers none of the cells of b, the merged mutation is a with
+// the cells of b added at the end. Copying the serialized cells then saves
+// deserializing and serializing back every cell of a, which otherwise makes
+// the cost of appending to a collection in memtables and cache grow with its
+// size much faster.
+static std::optional<collection_mutation>
+try_merge_appended(const abstract_type& type, collection_mutation_view a, collection_mutation_view b, const abstract_type& key_type) {
+    collection_mutation_input_stream b_in(b.data);
+    auto b_view = deserialize_collection_mutation(type, b_in);
+    if (b_view.tomb || b_view.cells.empty()) {
+        return std::nullopt;
+    }
+
+    auto a_in = a.data;
+    tombstone a_tomb;
+    if (read_simple<uint8_t>(a_in)) {
+        auto ts = read_simple<api::timestamp_type>(a_in);
+        auto ttl = read_simple<gc_clock::duration::rep>(a_in);
+        a_tomb = tombstone{ts, gc_clock::time_point(gc_clock::duration(ttl))};
+    }
+    const auto a_header_size = a.data.size() - a_in.size();
+    auto a_nr = read_simple<uint32_t>(a_in);
+    const auto a_cells = a_in;
+
+    // Tombstones win if timestamps are equal, see merge() below.
+    if (a_tomb && std::any_of(b_view.cells.begin(), b_view.cells.end(), [&] (const auto& c) { return a_tomb.timestamp >= c.second.timestamp(); })) {
+        return std::nullopt;
+    }
+
+    managed_bytes_view last_key;
+    for (uint32_t i = 0; i != a_nr; ++i) {
+        auto ksize = read_simple<uint32_t>(a_in);
+        last_key = read_simple_bytes(a_in, ksize);
+        auto vsize = read_simple<uint32_t>(a_in);
+        a_in.remove_prefix(vsize);
+    }
+    if (a_nr && !with_linearized(last_key, [&] (bytes_view k) { return key_type.less(k, b_view.cells.front().first); })) {
+        return std::nullopt;
+    }
+
+    // b has no tombstone, so its cells follow the flag byte and the cell count.
+    const auto b_cells = b.data.substr(1 + sizeof(uint32_t), b.data.size() - 1 - sizeof(uint32_t));
+    managed_bytes ret(managed_bytes::initialized_later(), a_header_size + sizeof(uint32_t) + a_cells.size() + b_cells.size());
+    managed_bytes_mutable_view out(ret);
+    write_fragmented(out, a.data.prefix(a_header_size));
+    write<int32_t>(out, a_nr + b_view.cells.size());
+    write_fragmented(out, a_cells);
+    write_fragmented(out, b_cells);
+    return collection_mutation(type, std::move(ret));
+}
+
 collection_mutation merge(const abstract_type& type, collection_mutation_view a, collection_mutation_view b) {
+    auto appended = visit(type, make_visitor(
+    [&] (const collection_type_impl& ctype) {
+        return try_merge_appended(type, a, b, *ctype.name_comparator());
+    },
+    [&] (const user_type_impl& utype) {
+        return try_merge_appended(type, a, b, *short_type);
+    },
+    [] (const abstract_type& o) -> std::optional<collection_mutation> {
+        throw std::runtime_error(format("collection_mutation merge: unknown type: {}", o.name()));
+    }
+    ));
+    if (appended) {
+        return std::move(*appended);
+    }
     return a.with_deserialized(type, [&] (collection_mutation_view_description a_view) {
         return b.with_deserialized(type, [&] (collection_mutation_view_description b_view) {
             return visit(type, make_visitor(
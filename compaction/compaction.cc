@@ -53,6 +53,7 @@
 #include "readers/compacting.hh"
 #include "tombstone_gc.hh"
 #include "keys.hh"
+#include "sstables/hyperloglog.hh"
 
 namespace sstables {
 
@@ -439,6 +440,59 @@ std::ostream& operator<<(std::ostream& os, const formatted_sstables_list& lst) {
     return os;
 }
 
+// Estimates the number of distinct partitions in a set of sstables, by merging
+// the cardinality estimators of their partition keys (kept in the compaction
+// metadata). Overlapping sstables share partitions, so summing their partition
+// counts overestimates the output of compacting them, and bloom filters sized
+// by that sum are too large.
+// Falls back to the sum if any sstable has no estimator, or one too coarse
+// to be trusted, as sstables written with a low precision have.
+class partition_union_estimator {
+    std::optional<hll::HyperLogLog> _sketch;
+    bool _usable = true;
+    uint64_t _sum = 0;
+    uint64_t _max = 0;
+public:
+    static constexpr uint32_t min_registers = 1 << 10;
+
+    void add(const sstable& sst) {
+        const auto count = sst.get_estimated_key_count();
+        _sum += count;
+        _max = std::max(_max, count);
+        if (!_usable) {
+            return;
+        }
+        try {
+            auto sketch = hll::HyperLogLog::from_bytes(sst.get_compaction_metadata().cardinality.elements);
+            if (sketch.registerSize() < min_registers) {
+                _usable = false;
+            } else if (!_sketch) {
+                _sketch = std::move(sketch);
+            } else {
+                _sketch->merge(sketch);
+            }
+        } catch (...) {
+            _usable = false;
+        }
+    }
+
+    uint64_t input_partitions() const {
+        return _sum;
+    }
+
+    uint64_t estimate() const {
+        if (!_usable || !_sketch) {
+            return _sum;
+        }
+        // Pad by three standard errors, so that filters are rarely undersized.
+        const auto m = double(_sketch->registerSize());
+        const auto estimate = uint64_t(std::ceil(_sketch->estimate() * (1 + 3 * 1.04 / std::sqrt(m))));
+        // The union has at least as many partitions as the largest input, and
+        // at most as many as all of them.
+        return std::clamp(estimate, _max, _sum);
+    }
+};
+
 class compaction {
 protected:
     compaction_data& _cdata;
@@ -463,11 +517,14 @@ class compaction {
     db::replay_position _rp;
     encoding_stats_collector _stats_collector;
     bool _can_split_large_partition = false;
+    bool _can_pass_through = false;
     bool _contains_multi_fragment_runs = false;
     mutation_source_metadata _ms_metadata = {};
     compaction_sstable_replacer_fn _replacer;
     run_id _run_identifier;
     ::io_priority_class _io_priority;
+    std::optional<double> _bloom_filter_fp_chance;
+    std::optional<double> _summary_ratio;
     // optional clone of sstable set to be used for expiration purposes, so it will be set if expiration is enabled.
     std::optional<sstable_set> _sstable_set;
     // used to incrementally calculate max purgeable timestamp, as we iterate through decorated keys.
@@ -495,9 +552,12 @@ class compaction {
         , _max_sstable_size(descriptor.max_sstable_bytes)
         , _sstable_level(descriptor.level)
         , _can_split_large_partition(descriptor.can_split_large_partition)
+        , _can_pass_through(descriptor.can_pass_through)
         , _replacer(std::move(descriptor.replacer))
         , _run_identifier(descriptor.run_identifier)
         , _io_priority(descriptor.io_priority)
+        , _bloom_filter_fp_chance(descriptor.bloom_filter_fp_chance)
+        , _summary_ratio(descriptor.summary_ratio)
         , _sstable_set(std::move(descriptor.all_sstables_snapshot))
         , _selector(_sstable_set ? _sstable_set->make_incremental_selector() : std::optional<sstable_set::incremental_selector>{})
         , _compacting_for_max_purgeable_func(std::unordered_set<shared_sstable>(_sstables.begin(), _sstables.end()))
@@ -546,6 +606,10 @@ class compaction {
         cfg.run_identifier = _run_identifier;
         cfg.replay_position = _rp;
         cfg.sstable_level = _sstable_level;
+        cfg.bloom_filter_fp_chance = _bloom_filter_fp_chance;
+        if (_summary_ratio) {
+            cfg.summary_byte_cost = summary_byte_cost(*_summary_ratio);
+        }
         return cfg;
     }
 
@@ -643,6 +707,7 @@ class compaction {
         min_max_tracker<api::timestamp_type> timestamp_tracker;
 
         _input_sstable_generations.reserve(_sstables.size());
+        partition_union_estimator partition_estimator;
         for (auto& sst : _sstables) {
             co_await coroutine::maybe_yield();
             auto& sst_stats = sst->get_stats_metadata();
@@ -664,10 +729,7 @@ class compaction {
 
             // We also capture the sstable, so we keep it alive while the read isn't done
             ssts->insert(sst);
-            // FIXME: If the sstables have cardinality estimation bitmaps, use that
-            // for a better estimate for the number of partitions in the merged
-            // sstable than just adding up the lengths of individual sstables.
-            _estimated_partitions += sst->get_estimated_key_count();
+            partition_estimator.add(*sst);
             // TODO:
             // Note that this is not fully correct. Since we might be merging sstables that originated on
             // another shard (#cpu changed), we might be comparing RP:s with differing shard ids,
@@ -684,6 +746,8 @@ class compaction {
         }
 
         _compacting = std::move(ssts);
+        _estimated_partitions = partition_estimator.estimate();
+        log_debug("Estimated {} partitions in the output, {} in the input", _estimated_partitions, partition_estimator.input_partitions());
 
         _ms_metadata.min_timestamp = timestamp_tracker.min();
         _ms_metadata.max_timestamp = timestamp_tracker.max();
@@ -740,6 +804,44 @@ class compaction {
         return consumer(make_sstable_reader());
     }
 
+    // A regular compaction of a single sstable which holds no tombstones and
+    // no expiring cells, e.g. a LCS promotion of a sstable which overlaps
+    // nothing in the next level, would write every partition back unchanged.
+    // Only the level in its Statistics would differ. Applies only to
+    // compactions chosen by the strategy, a major compaction is expected to
+    // rewrite its input.
+    bool can_pass_through() const {
+        if (!_can_pass_through || _type != compaction_type::Compaction || _sstables.size() != 1 || _compacting->all()->size() != 1 || use_interposer_consumer()) {
+            return false;
+        }
+        auto& sst = _sstables.front();
+        return sst->get_version() == _table_s.get_sstables_manager().get_highest_supported_format()
+            && sst->get_schema()->version() == _schema->version()
+            && _schema->dropped_columns().empty()
+            && sst->get_shards_for_this_sstable().size() == 1
+            && sst->data_size() <= _max_sstable_size
+            && sst->has_correct_max_deletion_time()
+            && sst->get_stats_metadata().min_local_deletion_time == std::numeric_limits<int32_t>::max();
+    }
+
+    // Links the components of the input sstable under a new generation and
+    // rewrites just its Statistics, instead of parsing and re-serializing it.
+    future<> pass_through() {
+        return seastar::async([this] {
+            auto& input = _sstables.front();
+            auto sst = _sstable_creator(this_shard_id());
+            setup_new_sstable(sst);
+            log_debug("Passing {} through as {} at level {}", input->get_filename(), sst->get_filename(), _sstable_level);
+            input->create_links(sst->get_dir(), sst->generation()).get();
+            sst->load(_io_priority).get();
+            sst->mutate_sstable_level(_sstable_level).get();
+            _end_size += sst->bytes_on_disk();
+            _cdata.total_keys_written += sst->get_estimated_key_count();
+            _new_unused_sstables.push_back(sst);
+            _new_partial_sstables.erase(sst);
+        });
+    }
+
     virtual reader_consumer_v2 make_interposer_consumer(reader_consumer_v2 end_consumer) {
         return _table_s.get_compaction_strategy().make_interposer_consumer(_ms_metadata, std::move(end_consumer));
     }
@@ -1699,7 +1801,7 @@ class resharding_compaction final : public compaction {
 future<compaction_result> compaction::run(std::unique_ptr<compaction> c) {
     return seastar::async([c = std::move(c)] () mutable {
         c->setup().get();
-        auto consumer = c->consume();
+        auto consumer = c->can_pass_through() ? c->pass_through() : c->consume();
 
         auto start_time = db_clock::now();
         try {
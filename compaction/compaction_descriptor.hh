@@ -155,6 +155,10 @@ struct compaction_descriptor {
     uint64_t max_sstable_bytes;
     // Can split large partitions at clustering boundary.
     bool can_split_large_partition = false;
+    // Set for regular compactions chosen by the compaction strategy, which
+    // may pass a single sstable through as is instead of rewriting it.
+    // Major compactions must rewrite their input.
+    bool can_pass_through = false;
     // Run identifier of output sstables.
     sstables::run_id run_identifier;
     // The options passed down to the compaction code.
@@ -169,6 +173,11 @@ struct compaction_descriptor {
     // Denotes if this compaction task is comprised solely of completely expired SSTables
     sstables::has_only_fully_expired has_only_fully_expired = has_only_fully_expired::no;
 
+    // Override the schema's bloom_filter_fp_chance and the configured
+    // sstable_summary_ratio for the sstable(s) created by compaction.
+    std::optional<double> bloom_filter_fp_chance;
+    std::optional<double> summary_ratio;
+
     compaction_descriptor() = default;
 
     static constexpr int default_level = 0;
@@ -525,8 +525,9 @@ std::ostream& operator<<(std::ostream& os, const compaction_manager::task& task)
     return os << task.describe();
 }
 
-inline compaction_controller make_compaction_controller(const compaction_manager::scheduling_group& csg, uint64_t static_shares, std::function<double()> fn) {
-    return compaction_controller(csg, static_shares, 250ms, std::move(fn));
+inline compaction_controller make_compaction_controller(const compaction_manager::scheduling_group& csg, uint64_t static_shares, std::function<double()> fn,
+        std::chrono::milliseconds smoothing = std::chrono::milliseconds(0)) {
+    return compaction_controller(csg, static_shares, 250ms, std::move(fn), smoothing);
 }
 
 compaction_manager::compaction_state::~compaction_state() {
@@ -656,7 +657,7 @@ compaction_manager::compaction_manager(config cfg, abort_source& as)
             return compaction_controller::normalization_factor;
         }
         return b;
-    }))
+    }, _cfg.shares_smoothing))
     , _backlog_manager(_compaction_controller)
     , _early_abort_subscription(as.subscribe([this] () noexcept {
         do_stop();
@@ -728,6 +729,8 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the sum of compaction backlog for all tables in the system.")),
         sm::make_gauge("normalized_backlog", [this] { return _last_backlog / available_memory(); },
                        sm::description("Holds the sum of normalized compaction backlog for all tables in the system. Backlog is normalized by dividing backlog by shard's available memory.")),
+        sm::make_gauge("shares", [this] { return _compaction_controller.current_shares(); },
+                       sm::description("Holds the shares currently assigned to compaction by the compaction controller.")),
         sm::make_counter("validation_errors", [this] { return _validation_errors; },
                        sm::description("Holds the number of encountered validation errors.")),
     });
@@ -957,6 +960,7 @@ class compaction_manager::regular_compaction_task : public compaction_manager::t
             compaction::table_state& t = *_compacting_table;
             sstables::compaction_strategy cs = t.get_compaction_strategy();
             sstables::compaction_descriptor descriptor = cs.get_sstables_for_compaction(t, _cm.get_strategy_control(), _cm.get_candidates(t));
+            descriptor.can_pass_through = true;
             int weight = calculate_weight(descriptor);
 
             if (descriptor.sstables.empty() || !can_proceed() || t.is_auto_compaction_disabled_by_user()) {
@@ -979,6 +983,8 @@ class compaction_manager::regular_compaction_task : public compaction_manager::t
                 fmt::ptr(this), descriptor.sstables.size(), weight, t.schema()->ks_name(), t.schema()->cf_name());
 
             setup_new_compaction(descriptor.run_identifier);
+            _running_compaction = compaction::running_compaction{descriptor.sstables, descriptor.level};
+            auto reset_running_compaction = defer([this] () noexcept { _running_compaction.reset(); });
             std::exception_ptr ex;
 
             try {
@@ -1091,8 +1097,8 @@ class compaction_manager::offstrategy_compaction_task : public compaction_manage
         // round, progressively degrading read amplification until integration happens.
         // The drawback of this approach is the 2x space requirement as the old sstables
         // will only be deleted at the end. The impact of this space requirement is reduced
-        // by the fact that off-strategy is serialized across all tables, meaning that the
-        // actual requirement is the size of the largest table's maintenance set.
+        // by the fact that only a few off-strategy compactions run at a time, meaning that the
+        // actual requirement is the size of the largest tables' maintenance sets.
 
         compaction::table_state& t = *_compacting_table;
         const auto& maintenance_sstables = t.maintenance_sstable_set();
@@ -1182,7 +1188,8 @@ class compaction_manager::offstrategy_compaction_task : public compaction_manage
                 co_return std::nullopt;
             }
             switch_state(state::pending);
-            auto units = co_await acquire_semaphore(_cm._off_strategy_sem);
+            co_await _cm.admit_offstrategy(*_compacting_table, _compaction_data.abort);
+            auto release = defer([this] () noexcept { _cm.release_offstrategy(*_compacting_table); });
             if (!can_proceed()) {
                 co_return std::nullopt;
             }
@@ -1212,6 +1219,58 @@ class compaction_manager::offstrategy_compaction_task : public compaction_manage
     }
 };
 
+future<> compaction_manager::admit_offstrategy(compaction::table_state& t, abort_source& as) {
+    if (_offstrategy_waiters.empty() && _offstrategy_running.size() < _cfg.max_concurrent_offstrategy_compactions
+            && !_offstrategy_running.contains(&t)) {
+        _offstrategy_running.insert(&t);
+        co_return;
+    }
+
+    auto w = make_lw_shared<offstrategy_waiter>(offstrategy_waiter{
+        .table = &t,
+        .maintenance_sstables = t.maintenance_sstable_set().all()->size(),
+    });
+    auto it = _offstrategy_waiters.insert(_offstrategy_waiters.end(), w);
+    auto on_abort = [this, w, it] () noexcept {
+        if (!w->done) {
+            w->done = true;
+            _offstrategy_waiters.erase(it);
+            auto s = w->table->schema();
+            w->admitted.set_exception(sstables::compaction_stopped_exception(s->ks_name(), s->cf_name(), "abort requested"));
+        }
+    };
+    auto sub = as.subscribe(on_abort);
+    if (!sub) {
+        on_abort();
+    }
+    co_await w->admitted.get_future();
+}
+
+void compaction_manager::release_offstrategy(compaction::table_state& t) noexcept {
+    _offstrategy_running.erase(&t);
+    maybe_admit_offstrategy();
+}
+
+void compaction_manager::maybe_admit_offstrategy() noexcept {
+    while (_offstrategy_running.size() < _cfg.max_concurrent_offstrategy_compactions) {
+        auto best = _offstrategy_waiters.end();
+        for (auto it = _offstrategy_waiters.begin(); it != _offstrategy_waiters.end(); ++it) {
+            if (!_offstrategy_running.contains((*it)->table)
+                    && (best == _offstrategy_waiters.end() || (*it)->maintenance_sstables > (*best)->maintenance_sstables)) {
+                best = it;
+            }
+        }
+        if (best == _offstrategy_waiters.end()) {
+            return;
+        }
+        auto w = *best;
+        _offstrategy_waiters.erase(best);
+        w->done = true;
+        _offstrategy_running.insert(w->table);
+        w->admitted.set_value();
+    }
+}
+
 future<bool> compaction_manager::perform_offstrategy(compaction::table_state& t) {
     if (_state != state::enabled) {
         co_return false;
@@ -1683,6 +1742,16 @@ class compaction_manager::strategy_control : public compaction::strategy_control
                 && task->compacting_table()->schema()->cf_name() == s->cf_name();
         });
     }
+
+    std::vector<compaction::running_compaction> running_compactions(table_state& table_s) const override {
+        std::vector<compaction::running_compaction> ret;
+        for (auto& task : _cm._tasks) {
+            if (task->compaction_running() && task->compacting_table() == &table_s) {
+                ret.push_back(task->get_running_compaction().value_or(compaction::running_compaction{}));
+            }
+        }
+        return ret;
+    }
 };
 
 compaction::strategy_control& compaction_manager::get_strategy_control() const noexcept {
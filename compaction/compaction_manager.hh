@@ -27,6 +27,7 @@
 #include "utils/serialized_action.hh"
 #include <vector>
 #include <list>
+#include <unordered_set>
 #include <functional>
 #include <algorithm>
 #include "compaction.hh"
@@ -67,6 +68,9 @@ class compaction_manager {
         size_t available_memory = 0;
         utils::updateable_value<float> static_shares = utils::updateable_value<float>(0);
         utils::updateable_value<uint32_t> throughput_mb_per_sec = utils::updateable_value<uint32_t>(0);
+        // Time constant of the smoothing of the compaction controller's shares.
+        std::chrono::milliseconds shares_smoothing = std::chrono::milliseconds(0);
+        unsigned max_concurrent_offstrategy_compactions = 1;
     };
 private:
     struct compaction_state {
@@ -118,6 +122,8 @@ class compaction_manager {
         compaction_state& _compaction_state;
         sstables::compaction_data _compaction_data;
         state _state = state::none;
+        // Input and output level of the regular compaction being run.
+        std::optional<compaction::running_compaction> _running_compaction;
 
     private:
         shared_future<compaction_stats_opt> _compaction_done = make_ready_future<compaction_stats_opt>();
@@ -189,6 +195,10 @@ class compaction_manager {
             return _compaction_data;
         }
 
+        const std::optional<compaction::running_compaction>& get_running_compaction() const noexcept {
+            return _running_compaction;
+        }
+
         bool generating_output_run() const noexcept {
             return compaction_running() && _output_run_identifier;
         }
@@ -284,10 +294,19 @@ class compaction_manager {
     // If the operation must be serialized with regular, then the per-table write lock must be taken.
     seastar::named_semaphore _maintenance_ops_sem = {1, named_semaphore_exception_factory{"maintenance operation"}};
 
-    // This semaphore ensures that off-strategy compaction will be serialized for
-    // all tables, to limit space requirement and protect against candidates
-    // being picked more than once.
-    seastar::named_semaphore _off_strategy_sem = {1, named_semaphore_exception_factory{"off-strategy compaction"}};
+    // Off-strategy compactions run up to max_concurrent_offstrategy_compactions at a
+    // time, to limit space requirement, and at most one per table, to protect against
+    // candidates being picked more than once. Waiting ones are admitted in the order of
+    // the size of their table's maintenance set, so that the tables whose reads suffer
+    // the most get their sstables integrated first.
+    struct offstrategy_waiter {
+        compaction::table_state* table;
+        size_t maintenance_sstables;
+        promise<> admitted;
+        bool done = false;
+    };
+    std::list<lw_shared_ptr<offstrategy_waiter>> _offstrategy_waiters;
+    std::unordered_set<compaction::table_state*> _offstrategy_running;
 
     seastar::shared_ptr<db::system_keyspace> _sys_ks;
 
@@ -316,6 +335,12 @@ class compaction_manager {
     future<compaction_stats_opt> perform_task(shared_ptr<task>);
 
     future<> stop_tasks(std::vector<shared_ptr<task>> tasks, sstring reason);
+
+    // Waits until an off-strategy compaction of the table may run.
+    // Fails with compaction_stopped_exception if `as` is aborted in the meantime.
+    future<> admit_offstrategy(compaction::table_state& t, abort_source& as);
+    void release_offstrategy(compaction::table_state& t) noexcept;
+    void maybe_admit_offstrategy() noexcept;
     future<> update_throughput(uint32_t value_mbs);
 
     // Return the largest fan-in of currently running compactions
@@ -26,6 +26,7 @@
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "backlog_controller.hh"
 #include "compaction_backlog_manager.hh"
 #include "size_tiered_backlog_tracker.hh"
@@ -50,10 +51,39 @@ std::vector<compaction_descriptor> compaction_strategy_impl::get_cleanup_compact
     }));
 }
 
+std::optional<compaction_descriptor>
+compaction_strategy_impl::get_fully_expired_sstables_job(table_state& table_s, const std::vector<shared_sstable>& candidates, gc_clock::time_point compaction_time) {
+    // Looking for sstables shadowed by expired candidates is expensive, so
+    // it's done only if some candidate has no live data left at all.
+    auto has_no_live_data = [&] (const shared_sstable& sst) {
+        return sst->get_max_local_deletion_time() < sst->get_gc_before_for_fully_expire(compaction_time, table_s.get_tombstone_gc_state());
+    };
+    if (std::none_of(candidates.begin(), candidates.end(), has_no_live_data)) {
+        return std::nullopt;
+    }
+    auto expired = table_s.fully_expired_sstables(candidates, compaction_time);
+    if (expired.empty()) {
+        return std::nullopt;
+    }
+    clogger.debug("Going to drop {} fully expired sstables of {}.{}", expired.size(), table_s.schema()->ks_name(), table_s.schema()->cf_name());
+    return compaction_descriptor(has_only_fully_expired::yes, std::vector<shared_sstable>(expired.begin(), expired.end()), service::get_local_compaction_priority());
+}
+
+bool compaction_strategy_impl::expires_soon(const shared_sstable& sst, gc_clock::time_point compaction_time, const tombstone_gc_state& gc_state) const {
+    if (_expiring_sstable_skip_window == gc_clock::duration::zero()) {
+        return false;
+    }
+    return sst->get_max_local_deletion_time() < sst->get_gc_before_for_fully_expire(compaction_time + _expiring_sstable_skip_window, gc_state);
+}
+
 bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point compaction_time, const tombstone_gc_state& gc_state) {
     if (_disable_tombstone_compaction) {
         return false;
     }
+    // Tombstones of sstables expiring soon will be dropped along with them.
+    if (expires_soon(sst, compaction_time, gc_state)) {
+        return false;
+    }
     // ignore sstables that were created just recently because there's a chance
     // that expired tombstones still cover old data and thus cannot be removed.
     // We want to avoid a compaction loop here on the same data by considering
@@ -96,6 +126,10 @@ compaction_strategy_impl::compaction_strategy_impl(const std::map<sstring, sstri
     auto interval = property_definitions::to_long(TOMBSTONE_COMPACTION_INTERVAL_OPTION, tmp_value, DEFAULT_TOMBSTONE_COMPACTION_INTERVAL().count());
     _tombstone_compaction_interval = db_clock::duration(std::chrono::seconds(interval));
 
+    tmp_value = get_value(options, EXPIRING_SSTABLE_SKIP_WINDOW_OPTION);
+    auto skip_window = property_definitions::to_long(EXPIRING_SSTABLE_SKIP_WINDOW_OPTION, tmp_value, 0);
+    _expiring_sstable_skip_window = std::chrono::duration_cast<gc_clock::duration>(std::chrono::seconds(skip_window));
+
     // FIXME: validate options.
 }
 
@@ -413,6 +447,105 @@ class leveled_compaction_backlog_tracker final : public compaction_backlog_track
     }
 };
 
+// The backlog for ICS follows from the STCS one, with runs in place of SSTables:
+//
+//   Br = (Sr - Cr) * log4(T / Sr),
+//
+// where Sr is the size of the run r and Cr the amount of bytes of it already compacted.
+// Accounting fragments individually would overestimate the backlog, as every fragment
+// is small compared to the table, although they are compacted together with their run.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    size_tiered_compaction_strategy_options _stcs_options;
+    int64_t _total_bytes = 0;
+    std::unordered_map<run_id, incremental_compaction_strategy::sstable_run_and_size> _all;
+    // Size of the runs contributing backlog, i.e. the ones in an interesting bucket.
+    std::unordered_map<run_id, uint64_t> _runs_contributing_backlog;
+
+    static double log4(double x) {
+        double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+
+    void refresh_runs_backlog_contribution() {
+        _runs_contributing_backlog = {};
+        if (_all.empty()) {
+            return;
+        }
+        // Deduce threshold from the newest fragment, like size_tiered_backlog_tracker does.
+        const sstables::shared_sstable* newest_sst = nullptr;
+        for (auto& [id, run] : _all) {
+            for (auto& sst : run.fragments) {
+                if (!newest_sst || std::less<generation_type>()((*newest_sst)->generation(), sst->generation())) {
+                    newest_sst = &sst;
+                }
+            }
+        }
+        auto threshold = (*newest_sst)->get_schema()->min_compaction_threshold();
+        auto runs = boost::copy_range<std::vector<incremental_compaction_strategy::sstable_run_and_size>>(_all | boost::adaptors::map_values);
+        for (auto& bucket : incremental_compaction_strategy::get_buckets(std::move(runs), _stcs_options)) {
+            if (bucket.size() < size_t(threshold)) {
+                continue;
+            }
+            for (auto& run : bucket) {
+                _runs_contributing_backlog.emplace(run.fragments.front()->run_identifier(), run.size);
+            }
+        }
+    }
+public:
+    incremental_backlog_tracker(size_tiered_compaction_strategy_options stcs_options) : _stcs_options(stcs_options) {}
+
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
+        if (_total_bytes <= 0) {
+            return 0;
+        }
+        std::unordered_map<run_id, uint64_t> compacted;
+        for (auto& [sst, rp] : oc) {
+            if (_runs_contributing_backlog.contains(sst->run_identifier())) {
+                compacted[sst->run_identifier()] += rp->compacted();
+            }
+        }
+        double b = 0;
+        for (auto& [id, size] : _runs_contributing_backlog) {
+            auto it = compacted.find(id);
+            uint64_t c = it != compacted.end() ? it->second : 0;
+            if (size <= c) {
+                continue;
+            }
+            b += (size - c) * log4(double(_total_bytes) / size);
+        }
+        return b > 0 ? b : 0;
+    }
+
+    virtual void replace_sstables(std::vector<sstables::shared_sstable> old_ssts, std::vector<sstables::shared_sstable> new_ssts) override {
+        for (auto& sst : old_ssts) {
+            auto it = _all.find(sst->run_identifier());
+            if (sst->data_size() == 0 || it == _all.end()) {
+                continue;
+            }
+            auto& run = it->second;
+            auto f = std::find(run.fragments.begin(), run.fragments.end(), sst);
+            if (f == run.fragments.end()) {
+                continue;
+            }
+            run.fragments.erase(f);
+            run.size -= sst->data_size();
+            _total_bytes -= sst->data_size();
+            if (run.fragments.empty()) {
+                _all.erase(it);
+            }
+        }
+        for (auto& sst : new_ssts) {
+            if (sst->data_size() > 0) {
+                auto& run = _all[sst->run_identifier()];
+                run.size += sst->data_size();
+                _total_bytes += sst->data_size();
+                run.fragments.push_back(std::move(sst));
+            }
+        }
+        refresh_runs_backlog_contribution();
+    }
+};
+
 struct unimplemented_backlog_tracker final : public compaction_backlog_tracker::impl {
     virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
         return compaction_controller::disable_backlog;
@@ -696,6 +829,18 @@ size_tiered_compaction_strategy::size_tiered_compaction_strategy(const size_tier
     , _backlog_tracker(std::make_unique<size_tiered_backlog_tracker>(_options))
 {}
 
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _fragment_size_in_mb(cql3::statements::property_definitions::to_int(SSTABLE_SIZE_OPTION,
+            compaction_strategy_impl::get_value(options, SSTABLE_SIZE_OPTION), DEFAULT_MAX_SSTABLE_SIZE_IN_MB))
+    , _stcs_options(options)
+    , _backlog_tracker(std::make_unique<incremental_backlog_tracker>(_stcs_options))
+{
+    if (_fragment_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} must be greater than 0, but was {}", SSTABLE_SIZE_OPTION, _fragment_size_in_mb));
+    }
+}
+
 compaction_strategy::compaction_strategy(::shared_ptr<compaction_strategy_impl> impl)
     : _compaction_strategy_impl(std::move(impl)) {}
 compaction_strategy::compaction_strategy() = default;
@@ -724,6 +869,10 @@ void compaction_strategy::notify_completion(const std::vector<shared_sstable>& r
     _compaction_strategy_impl->notify_completion(removed, added);
 }
 
+std::vector<int64_t> compaction_strategy::estimated_pending_compactions_per_level() const {
+    return _compaction_strategy_impl->estimated_pending_compactions_per_level();
+}
+
 bool compaction_strategy::parallel_compaction() const {
     return _compaction_strategy_impl->parallel_compaction();
 }
@@ -776,6 +925,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
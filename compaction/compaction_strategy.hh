@@ -63,6 +63,10 @@ class compaction_strategy {
     // An estimation of number of compaction for strategy to be satisfied.
     int64_t estimated_pending_compactions(table_state& table_s) const;
 
+    // The same estimation for each level, for strategies which organize
+    // sstables in levels. Empty for other strategies.
+    std::vector<int64_t> estimated_pending_compactions_per_level() const;
+
     static sstring name(compaction_strategy_type type) {
         switch (type) {
         case compaction_strategy_type::null:
@@ -75,6 +79,8 @@ class compaction_strategy {
             return "DateTieredCompactionStrategy";
         case compaction_strategy_type::time_window:
             return "TimeWindowCompactionStrategy";
+        case compaction_strategy_type::incremental:
+            return "IncrementalCompactionStrategy";
         default:
             throw std::runtime_error("Invalid Compaction Strategy");
         }
@@ -93,6 +99,8 @@ class compaction_strategy {
             return compaction_strategy_type::date_tiered;
         } else if (short_name == "TimeWindowCompactionStrategy") {
             return compaction_strategy_type::time_window;
+        } else if (short_name == "IncrementalCompactionStrategy") {
+            return compaction_strategy_type::incremental;
         } else {
             throw exceptions::configuration_exception(format("Unable to find compaction strategy class '{}'", name));
         }
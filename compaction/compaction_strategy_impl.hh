@@ -34,16 +34,26 @@ class compaction_strategy_impl {
 protected:
     const sstring TOMBSTONE_THRESHOLD_OPTION = "tombstone_threshold";
     const sstring TOMBSTONE_COMPACTION_INTERVAL_OPTION = "tombstone_compaction_interval";
+    const sstring EXPIRING_SSTABLE_SKIP_WINDOW_OPTION = "expiring_sstable_skip_window";
 
     bool _use_clustering_key_filter = false;
     bool _disable_tombstone_compaction = false;
     float _tombstone_threshold = DEFAULT_TOMBSTONE_THRESHOLD;
     db_clock::duration _tombstone_compaction_interval = DEFAULT_TOMBSTONE_COMPACTION_INTERVAL();
+    // sstables which will be fully expired within this window aren't worth
+    // compacting, they will soon be dropped as a whole. Disabled if zero.
+    gc_clock::duration _expiring_sstable_skip_window = gc_clock::duration::zero();
 public:
     static std::optional<sstring> get_value(const std::map<sstring, sstring>& options, const sstring& name);
 protected:
     compaction_strategy_impl() = default;
     explicit compaction_strategy_impl(const std::map<sstring, sstring>& options);
+    // Returns a job dropping the candidates which are fully expired and don't
+    // shadow data in other sstables, if there are any.
+    static std::optional<compaction_descriptor> get_fully_expired_sstables_job(table_state& table_s,
+            const std::vector<shared_sstable>& candidates, gc_clock::time_point compaction_time);
+    // Whether the sstable will be fully expired within the expiring_sstable_skip_window.
+    bool expires_soon(const shared_sstable& sst, gc_clock::time_point compaction_time, const tombstone_gc_state& gc_state) const;
     static compaction_descriptor make_major_compaction_job(std::vector<sstables::shared_sstable> candidates,
             int level = compaction_descriptor::default_level,
             uint64_t max_sstable_bytes = compaction_descriptor::default_max_sstable_bytes);
@@ -60,6 +70,9 @@ class compaction_strategy_impl {
         return true;
     }
     virtual int64_t estimated_pending_compactions(table_state& table_s) const = 0;
+    virtual std::vector<int64_t> estimated_pending_compactions_per_level() const {
+        return {};
+    }
     virtual std::unique_ptr<sstable_set_impl> make_sstable_set(schema_ptr schema) const;
 
     bool use_clustering_key_filter() const {
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "incremental_compaction_strategy.hh"
+#include "compaction.hh"
+#include "sstables/sstables.hh"
+#include "sstables/sstable_set.hh"
+#include "cql3/statements/property_definitions.hh"
+
+#include <boost/range/adaptors.hpp>
+#include <boost/range/algorithm.hpp>
+
+namespace sstables {
+
+std::vector<incremental_compaction_strategy::sstable_run_and_size>
+incremental_compaction_strategy::make_runs(const std::vector<shared_sstable>& sstables) {
+    std::unordered_map<run_id, sstable_run_and_size> runs;
+    for (auto& sst : sstables) {
+        auto& run = runs[sst->run_identifier()];
+        run.fragments.push_back(sst);
+        run.size += sst->data_size();
+    }
+    return boost::copy_range<std::vector<sstable_run_and_size>>(runs | boost::adaptors::map_values);
+}
+
+std::vector<std::vector<incremental_compaction_strategy::sstable_run_and_size>>
+incremental_compaction_strategy::get_buckets(std::vector<sstable_run_and_size> runs, const size_tiered_compaction_strategy_options& options) {
+    std::sort(runs.begin(), runs.end(), [] (const sstable_run_and_size& a, const sstable_run_and_size& b) {
+        return a.size < b.size;
+    });
+
+    using bucket_type = std::vector<sstable_run_and_size>;
+    std::vector<bucket_type> bucket_list;
+    std::vector<double> bucket_average_size_list;
+
+    // Same algorithm as size_tiered_compaction_strategy::get_buckets(), with runs in place of sstables.
+    for (auto& run : runs) {
+        size_t size = run.size;
+
+        if (!bucket_list.empty()) {
+            auto& bucket_average_size = bucket_average_size_list.back();
+
+            if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
+                    (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
+                auto& bucket = bucket_list.back();
+                auto total_size = bucket.size() * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket.size() + 1);
+                auto smallest_run_in_bucket = bucket[0].size;
+
+                if (size < options.min_sstable_size || smallest_run_in_bucket > new_average_size * options.bucket_low) {
+                    bucket.push_back(std::move(run));
+                    bucket_average_size = new_average_size;
+                    continue;
+                }
+            }
+        }
+
+        bucket_list.push_back(bucket_type{std::move(run)});
+        bucket_average_size_list.push_back(size);
+    }
+
+    return bucket_list;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::make_descriptor(std::vector<sstable_run_and_size> runs) const {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        std::move(run.fragments.begin(), run.fragments.end(), std::back_inserter(sstables));
+    }
+    // Output is split into fragments of a single new run, which allows compaction to release
+    // input fragments as soon as they're exhausted.
+    return compaction_descriptor(std::move(sstables), service::get_local_compaction_priority(),
+        compaction_descriptor::default_level, fragment_size());
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) {
+    int min_threshold = table_s.min_compaction_threshold();
+    int max_threshold = table_s.schema()->max_compaction_threshold();
+    auto compaction_time = gc_clock::now();
+
+    auto buckets = get_buckets(make_runs(candidates), _stcs_options);
+
+    auto most_interesting = [&] (size_t threshold) -> std::vector<sstable_run_and_size> {
+        std::vector<sstable_run_and_size>* max = nullptr;
+        // Pick the bucket with more runs, as efficiency of same-tier compactions increases with their number.
+        for (auto& bucket : buckets) {
+            if (bucket.size() >= threshold && (!max || bucket.size() > max->size())) {
+                max = &bucket;
+            }
+        }
+        if (!max) {
+            return {};
+        }
+        auto ret = std::move(*max);
+        ret.resize(std::min(ret.size(), size_t(max_threshold)));
+        return ret;
+    };
+
+    if (auto runs = most_interesting(min_threshold); !runs.empty()) {
+        return make_descriptor(std::move(runs));
+    }
+
+    // If we are not enforcing min_threshold explicitly, try any pair of runs in the same tier.
+    if (!table_s.compaction_enforce_min_threshold()) {
+        if (auto runs = most_interesting(2); !runs.empty()) {
+            return make_descriptor(std::move(runs));
+        }
+    }
+
+    // Try to compact a single run with a fragment whose droppable tombstone ratio is greater than
+    // threshold, preferring the biggest tiers, for the same reasons as size_tiered_compaction_strategy.
+    // The whole run is compacted, as the output replaces the run it came from.
+    for (auto& bucket : buckets | boost::adaptors::reversed) {
+        const sstable_run_and_size* oldest = nullptr;
+        api::timestamp_type oldest_timestamp = api::max_timestamp;
+        for (auto& run : bucket) {
+            for (auto& sst : run.fragments) {
+                if (!worth_dropping_tombstones(sst, compaction_time, table_s.get_tombstone_gc_state())) {
+                    continue;
+                }
+                auto ts = sst->get_stats_metadata().min_timestamp;
+                if (!oldest || ts < oldest_timestamp) {
+                    oldest = &run;
+                    oldest_timestamp = ts;
+                }
+            }
+        }
+        if (oldest) {
+            return make_descriptor({ *oldest });
+        }
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
+    if (candidates.empty()) {
+        return compaction_descriptor();
+    }
+    return make_major_compaction_job(std::move(candidates), compaction_descriptor::default_level, fragment_size());
+}
+
+std::vector<compaction_descriptor>
+incremental_compaction_strategy::get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const {
+    // Runs are cleaned up one at a time, so the temporary space is bounded by a run's fragment,
+    // and each output replaces its input run.
+    std::vector<compaction_descriptor> ret;
+    for (auto& run : make_runs(candidates)) {
+        auto id = run.fragments.front()->run_identifier();
+        ret.push_back(compaction_descriptor(std::move(run.fragments), service::get_local_compaction_priority(),
+            compaction_descriptor::default_level, fragment_size(), id));
+    }
+    return ret;
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    int min_threshold = table_s.min_compaction_threshold();
+    int max_threshold = table_s.schema()->max_compaction_threshold();
+
+    auto all_sstables = table_s.main_sstable_set().all();
+    auto sstables = boost::copy_range<std::vector<shared_sstable>>(*all_sstables);
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(make_runs(sstables), _stcs_options)) {
+        if (bucket.size() >= size_t(min_threshold)) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+    // Reshape works on sstables which don't belong to the table yet, e.g. ones which were
+    // imported or streamed, so there are no meaningful runs to look at. Reshape them like
+    // size-tiered does, but produce fragmented output.
+    auto desc = size_tiered_compaction_strategy(_stcs_options).get_reshaping_job(std::move(input), std::move(schema), iop, mode);
+    desc.max_sstable_bytes = fragment_size();
+    return desc;
+}
+
+}
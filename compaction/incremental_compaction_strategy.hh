@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <vector>
+#include <map>
+
+#include <seastar/core/sstring.hh>
+
+#include "compaction_strategy_type.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "compaction_strategy_impl.hh"
+#include "compaction_backlog_manager.hh"
+#include "sstables/shared_sstable.hh"
+
+namespace sstables {
+
+// Size-tiered compaction over sstable runs.
+//
+// Tiers are made of runs of similar size rather than of sstables. Output is
+// split into fragments of at most sstable_size_in_mb, which all belong to a
+// single new run. Since the fragments of a run don't overlap, compaction can
+// release an input fragment as soon as the output went past its last key,
+// so the temporary space needed by a compaction is bounded by the fragment
+// size times the number of input runs, instead of by the size of the input.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+public:
+    // A group of non-overlapping sstables sharing a run identifier.
+    struct sstable_run_and_size {
+        std::vector<shared_sstable> fragments;
+        uint64_t size = 0;
+    };
+private:
+    static constexpr int32_t DEFAULT_MAX_SSTABLE_SIZE_IN_MB = 1000;
+    const sstring SSTABLE_SIZE_OPTION = "sstable_size_in_mb";
+
+    int32_t _fragment_size_in_mb = DEFAULT_MAX_SSTABLE_SIZE_IN_MB;
+    size_tiered_compaction_strategy_options _stcs_options;
+    compaction_backlog_tracker _backlog_tracker;
+
+    uint64_t fragment_size() const {
+        return uint64_t(_fragment_size_in_mb) * 1024 * 1024;
+    }
+
+    compaction_descriptor make_descriptor(std::vector<sstable_run_and_size> runs) const;
+public:
+    static std::vector<sstable_run_and_size> make_runs(const std::vector<shared_sstable>& sstables);
+
+    // Group runs of similar size into buckets, like size_tiered_compaction_strategy::get_buckets() does with sstables.
+    static std::vector<std::vector<sstable_run_and_size>> get_buckets(std::vector<sstable_run_and_size> runs, const size_tiered_compaction_strategy_options& options);
+
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+
+};
+
+}
@@ -15,6 +15,11 @@
 namespace sstables {
 
 compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) {
+    auto compaction_time = gc_clock::now();
+    if (auto expired_job = get_fully_expired_sstables_job(table_s, candidates, compaction_time)) {
+        return std::move(*expired_job);
+    }
+
     // NOTE: leveled_manifest creation may be slightly expensive, so later on,
     // we may want to store it in the strategy itself. However, the sstable
     // lists managed by the manifest may become outdated. For example, one
@@ -24,9 +29,16 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(t
     if (!_last_compacted_keys) {
         generate_last_compacted_keys(manifest);
     }
+    _pending_compactions_per_level = manifest.get_estimated_tasks_per_level();
+    manifest.set_running_compactions(control.running_compactions(table_s));
     auto candidate = manifest.get_compaction_candidates(*_last_compacted_keys, _compaction_counter);
 
-    if (!candidate.sstables.empty()) {
+    // Levels are kept in shape by compacting, unless all the data to be
+    // rewritten will be dropped soon anyway.
+    auto expires_soon = [&] (const sstables::shared_sstable& sst) {
+        return this->expires_soon(sst, compaction_time, table_s.get_tombstone_gc_state());
+    };
+    if (!candidate.sstables.empty() && !std::all_of(candidate.sstables.begin(), candidate.sstables.end(), expires_soon)) {
         leveled_manifest::logger.debug("leveled: Compacting {} out of {} sstables", candidate.sstables.size(), table_s.main_sstable_set().all()->size());
         return candidate;
     }
@@ -35,7 +47,6 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(t
     // unlike stcs, lcs can look for sstable with highest droppable tombstone ratio, so as not to choose
     // a sstable which droppable data shadow data in older sstable, by starting from highest levels which
     // theoretically contain oldest non-overlapping data.
-    auto compaction_time = gc_clock::now();
     for (auto level = int(manifest.get_level_count()); level >= 0; level--) {
         auto& sstables = manifest.get_level(level);
         // filter out sstables which droppable tombstone ratio isn't greater than the defined threshold.
@@ -43,6 +54,9 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(t
             return !worth_dropping_tombstones(sst, compaction_time, table_s.get_tombstone_gc_state());
         });
         sstables.erase(e, sstables.end());
+        std::erase_if(sstables, [&] (const sstables::shared_sstable& sst) {
+            return manifest.interferes_with_running_compactions({ sst }, sst->get_sstable_level());
+        });
         if (sstables.empty()) {
             continue;
         }
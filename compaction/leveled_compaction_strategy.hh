@@ -34,6 +34,9 @@ class leveled_compaction_strategy : public compaction_strategy_impl {
     int32_t _max_sstable_size_in_mb = DEFAULT_MAX_SSTABLE_SIZE_IN_MB;
     std::optional<std::vector<std::optional<dht::decorated_key>>> _last_compacted_keys;
     std::vector<int> _compaction_counter;
+    // Estimated pending compactions of each level, as of the last time
+    // compaction candidates were picked.
+    std::vector<int64_t> _pending_compactions_per_level;
     size_tiered_compaction_strategy_options _stcs_options;
     compaction_backlog_tracker _backlog_tracker;
     int32_t calculate_max_sstable_size_in_mb(std::optional<sstring> option_value) const;
@@ -55,8 +58,14 @@ class leveled_compaction_strategy : public compaction_strategy_impl {
 
     virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
 
+    virtual std::vector<int64_t> estimated_pending_compactions_per_level() const override {
+        return _pending_compactions_per_level;
+    }
+
+    // Compactions run in parallel as long as they don't touch the same
+    // level over overlapping key ranges, see leveled_manifest::interferes_with_running_compactions().
     virtual bool parallel_compaction() const override {
-        return false;
+        return true;
     }
 
     virtual compaction_strategy_type type() const override {
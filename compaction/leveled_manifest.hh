@@ -13,6 +13,7 @@
 #include "sstables/sstables.hh"
 #include "compaction.hh"
 #include "size_tiered_compaction_strategy.hh"
+#include "strategy_control.hh"
 #include "range.hh"
 #include "log.hh"
 #include <boost/range/algorithm/sort.hpp>
@@ -25,6 +26,9 @@ class leveled_manifest {
     std::vector<std::vector<sstables::shared_sstable>> _generations;
     uint64_t _max_sstable_size_in_bytes;
     const sstables::size_tiered_compaction_strategy_options& _stcs_options;
+    // Compactions running alongside the one being picked. Their sstables
+    // aren't in the manifest.
+    std::vector<compaction::running_compaction> _running_compactions;
 
     struct candidates_info {
         std::vector<sstables::shared_sstable> candidates;
@@ -90,6 +94,42 @@ class leveled_manifest {
         return manifest;
     }
 
+    void set_running_compactions(std::vector<compaction::running_compaction> running_compactions) {
+        _running_compactions = std::move(running_compactions);
+    }
+
+    // Whether compacting the candidates into output_level could break the
+    // invariant of a level above L0 together with a running compaction: that
+    // is, if both touch the same level over overlapping token ranges. L0
+    // allows overlapping sstables, so compactions within L0 never interfere.
+    bool interferes_with_running_compactions(const std::vector<sstables::shared_sstable>& candidates, int output_level) const {
+        if (_running_compactions.empty() || candidates.empty()) {
+            return false;
+        }
+        auto touches = [] (const std::vector<sstables::shared_sstable>& sstables, int output_level, int level) {
+            return output_level == level || std::any_of(sstables.begin(), sstables.end(), [level] (const sstables::shared_sstable& sst) {
+                return int(sst->get_sstable_level()) == level;
+            });
+        };
+        auto [first, last] = token_span(candidates);
+        for (auto& running : _running_compactions) {
+            // Nothing is known about compactions not run on behalf of the strategy.
+            if (running.input.empty()) {
+                return true;
+            }
+            auto [running_first, running_last] = token_span(running.input);
+            if (last < running_first || running_last < first) {
+                continue;
+            }
+            for (int level = 1; level < MAX_LEVELS; level++) {
+                if (touches(candidates, output_level, level) && touches(running.input, running.output_level, level)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     // Return first set of overlapping sstables for a given level.
     // Assumes _generations[level] is already sorted by first key.
     std::vector<sstables::shared_sstable> overlapping_sstables(int level) const {
@@ -219,7 +259,7 @@ class leveled_manifest {
                 }
             }
             auto descriptor = get_descriptor_for_level(i, last_compacted_keys, compaction_counter);
-            if (!descriptor.sstables.empty()) {
+            if (!descriptor.sstables.empty() && !interferes_with_running_compactions(descriptor.sstables, descriptor.level)) {
                 return descriptor;
             }
         }
@@ -229,8 +269,10 @@ class leveled_manifest {
             auto info = get_candidates_for(0, last_compacted_keys);
             if (!info.candidates.empty()) {
                 auto next_level = get_next_level(info.candidates, info.can_promote);
-                return sstables::compaction_descriptor(std::move(info.candidates),
-                                                       service::get_local_compaction_priority(), next_level, _max_sstable_size_in_bytes);
+                if (!interferes_with_running_compactions(info.candidates, next_level)) {
+                    return sstables::compaction_descriptor(std::move(info.candidates),
+                                                           service::get_local_compaction_priority(), next_level, _max_sstable_size_in_bytes);
+                }
             }
         }
 
@@ -250,7 +292,7 @@ class leveled_manifest {
             }
 
             auto descriptor = get_descriptor_for_level(i-1, last_compacted_keys, compaction_counter);
-            if (!descriptor.sstables.empty()) {
+            if (!descriptor.sstables.empty() && !interferes_with_running_compactions(descriptor.sstables, descriptor.level)) {
                 return descriptor;
             }
         }
@@ -451,11 +493,26 @@ class leveled_manifest {
 
         int start = sstable_index_based_on_last_compacted_key(sstables, level, s, last_compacted_keys);
 
-        auto pos = start % sstables.size();
-        auto candidates = overlapping(*_schema, sstables.at(pos), get_level(level + 1));
-        candidates.push_back(sstables.at(pos));
+        // Skip over key ranges of the level taken by running compactions.
+        for (size_t i = 0; i < sstables.size(); i++) {
+            auto pos = (start + i) % sstables.size();
+            auto candidates = overlapping(*_schema, sstables.at(pos), get_level(level + 1));
+            candidates.push_back(sstables.at(pos));
+            if (!interferes_with_running_compactions(candidates, level + 1)) {
+                return { candidates, true };
+            }
+        }
+        return { {}, true };
+    }
 
-        return { candidates, true };
+    static std::pair<dht::token, dht::token> token_span(const std::vector<sstables::shared_sstable>& sstables) {
+        auto first = sstables.front()->get_first_decorated_key()._token;
+        auto last = sstables.front()->get_last_decorated_key()._token;
+        for (auto& sst : sstables) {
+            first = std::min(first, sst->get_first_decorated_key()._token);
+            last = std::max(last, sst->get_last_decorated_key()._token);
+        }
+        return { first, last };
     }
 
     /**
@@ -490,19 +547,31 @@ class leveled_manifest {
         return _generations[level];
     }
 
+    static int64_t get_estimated_tasks_for_level(const std::vector<sstables::shared_sstable>& sstables, int level, uint64_t max_sstable_size_in_bytes) {
+        uint64_t total_bytes_for_this_level = get_total_bytes(sstables);
+        uint64_t max_bytes_for_this_level = max_bytes_for_level(level, max_sstable_size_in_bytes);
+
+        if (total_bytes_for_this_level < max_bytes_for_this_level) {
+            return 0;
+        }
+        // If there is 1 byte over TBL - (MBL * 1.001), there is still a task left, so we need to round up.
+        return std::ceil(float(total_bytes_for_this_level - max_bytes_for_this_level*TARGET_SCORE) / max_sstable_size_in_bytes);
+    }
+
     static int64_t get_estimated_tasks(const std::vector<std::vector<sstables::shared_sstable>>& levels, uint64_t max_sstable_size_in_bytes) {
         int64_t tasks = 0;
 
         for (int i = static_cast<int>(levels.size()) - 1; i >= 0; i--) {
-            const auto& sstables = levels[i];
-            uint64_t total_bytes_for_this_level = get_total_bytes(sstables);
-            uint64_t max_bytes_for_this_level = max_bytes_for_level(i, max_sstable_size_in_bytes);
+            tasks += get_estimated_tasks_for_level(levels[i], i, max_sstable_size_in_bytes);
+        }
+        return tasks;
+    }
 
-            if (total_bytes_for_this_level < max_bytes_for_this_level) {
-                continue;
-            }
-            // If there is 1 byte over TBL - (MBL * 1.001), there is still a task left, so we need to round up.
-            tasks += std::ceil(float(total_bytes_for_this_level - max_bytes_for_this_level*TARGET_SCORE) / max_sstable_size_in_bytes);
+    std::vector<int64_t> get_estimated_tasks_per_level() const {
+        std::vector<int64_t> tasks;
+        tasks.reserve(_generations.size());
+        for (size_t i = 0; i < _generations.size(); i++) {
+            tasks.push_back(get_estimated_tasks_for_level(_generations[i], i, _max_sstable_size_in_bytes));
         }
         return tasks;
     }
@@ -150,6 +150,15 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
 
     // TODO: Add support to filter cold sstables (for reference: SizeTieredCompactionStrategy::filterColdSSTables).
 
+    if (auto expired_job = get_fully_expired_sstables_job(table_s, candidates, compaction_time)) {
+        return std::move(*expired_job);
+    }
+    // Rewriting sstables which will be dropped soon is wasted work.
+    auto e = boost::range::remove_if(candidates, [&] (const sstables::shared_sstable& sst) {
+        return expires_soon(sst, compaction_time, table_s.get_tombstone_gc_state());
+    });
+    candidates.erase(e, candidates.end());
+
     auto buckets = get_buckets(candidates);
 
     if (is_any_bucket_interesting(buckets, min_threshold)) {
@@ -9,15 +9,29 @@
 
 #pragma once
 
+#include <vector>
+
+#include "sstables/shared_sstable.hh"
+
 namespace compaction {
 
 class table_state;
 
+// A compaction running on a table.
+struct running_compaction {
+    // Empty if unknown, e.g. for compactions not run on behalf of the strategy.
+    std::vector<sstables::shared_sstable> input;
+    int output_level = 0;
+};
+
 // Used by manager to set goals and constraints on compaction strategies
 class strategy_control {
 public:
     virtual ~strategy_control() {}
     virtual bool has_ongoing_compaction(table_state& table_s) const noexcept = 0;
+    // Strategies allowing parallel compaction use this to pick jobs which
+    // don't interfere with the ones already running.
+    virtual std::vector<running_compaction> running_compactions(table_state& table_s) const = 0;
 };
 
 }
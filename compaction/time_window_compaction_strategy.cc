@@ -66,6 +66,32 @@ time_window_compaction_strategy_options::time_window_compaction_strategy_options
             timestamp_resolution = valid_timestamp_resolutions.at(it->second);
         }
     }
+
+    it = options.find(COLD_WINDOW_BLOOM_FILTER_FP_CHANCE_KEY);
+    if (it != options.end()) {
+        try {
+            cold_window_bloom_filter_fp_chance = std::stod(it->second);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(sstring("Invalid double value ") + it->second + " for " + COLD_WINDOW_BLOOM_FILTER_FP_CHANCE_KEY);
+        }
+        if (*cold_window_bloom_filter_fp_chance <= 0 || *cold_window_bloom_filter_fp_chance > 1) {
+            throw exceptions::configuration_exception(fmt::format("{} must be larger than 0 and less than or equal to 1.0, got {}",
+                    COLD_WINDOW_BLOOM_FILTER_FP_CHANCE_KEY, it->second));
+        }
+    }
+
+    it = options.find(COLD_WINDOW_SUMMARY_RATIO_KEY);
+    if (it != options.end()) {
+        try {
+            cold_window_summary_ratio = std::stod(it->second);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(sstring("Invalid double value ") + it->second + " for " + COLD_WINDOW_SUMMARY_RATIO_KEY);
+        }
+        if (*cold_window_summary_ratio < 0 || *cold_window_summary_ratio > 1) {
+            throw exceptions::configuration_exception(fmt::format("{} must be between 0 and 1.0, got {}",
+                    COLD_WINDOW_SUMMARY_RATIO_KEY, it->second));
+        }
+    }
 }
 
 time_window_compaction_strategy_options::time_window_compaction_strategy_options(time_window_compaction_strategy_options&&) = default;
@@ -109,9 +135,11 @@ uint64_t time_window_compaction_strategy::adjust_partition_estimate(const mutati
     const auto max_window = get_window_for(_options, *ms_meta.max_timestamp);
     const auto window_size = get_window_size(_options);
 
-    auto estimated_window_count = (max_window + (window_size - 1) - min_window) / window_size;
+    // The data is segregated into at most max_data_segregation_window_count
+    // sstables, see classify_by_timestamp.
+    auto estimated_window_count = std::min(uint64_t((max_window - min_window) / window_size) + 1, max_data_segregation_window_count);
 
-    return partition_estimate / std::max(1UL, uint64_t(estimated_window_count));
+    return partition_estimate / estimated_window_count;
 }
 
 reader_consumer_v2 time_window_compaction_strategy::make_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) {
@@ -245,7 +273,27 @@ time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_
 
     auto compaction_candidates = get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
     clogger.debug("[{}] Going to compact {} non-expired sstables", fmt::ptr(this), compaction_candidates.size());
-    return compaction_descriptor(std::move(compaction_candidates), service::get_local_compaction_priority());
+    auto desc = compaction_descriptor(std::move(compaction_candidates), service::get_local_compaction_priority());
+    maybe_set_cold_window_options(desc);
+    return desc;
+}
+
+void time_window_compaction_strategy::maybe_set_cold_window_options(compaction_descriptor& desc) const {
+    if ((!_options.cold_window_bloom_filter_fp_chance && !_options.cold_window_summary_ratio) || desc.sstables.empty()) {
+        return;
+    }
+    auto window_of = [this] (const shared_sstable& sst) {
+        return get_window_lower_bound(_options.sstable_window_size, to_timestamp_type(_options.timestamp_resolution, sst->get_stats_metadata().max_timestamp));
+    };
+    auto window = window_of(desc.sstables.front());
+    if (is_last_active_bucket(window, _highest_window_seen) || !std::all_of(desc.sstables.begin(), desc.sstables.end(), [&] (const shared_sstable& sst) {
+            return window_of(sst) == window;
+        })) {
+        return;
+    }
+    clogger.debug("[{}] Compacting sstables of cold window {}", fmt::ptr(this), window);
+    desc.bloom_filter_fp_chance = _options.cold_window_bloom_filter_fp_chance;
+    desc.summary_ratio = _options.cold_window_summary_ratio;
 }
 
 time_window_compaction_strategy::bucket_compaction_mode
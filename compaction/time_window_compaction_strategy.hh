@@ -36,6 +36,10 @@ class time_window_compaction_strategy_options {
     static constexpr auto COMPACTION_WINDOW_UNIT_KEY = "compaction_window_unit";
     static constexpr auto COMPACTION_WINDOW_SIZE_KEY = "compaction_window_size";
     static constexpr auto EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS_KEY = "expired_sstable_check_frequency_seconds";
+    // Applied to sstables written by compactions of windows older than the
+    // newest one, which are rarely read, to shrink their filters and summaries.
+    static constexpr auto COLD_WINDOW_BLOOM_FILTER_FP_CHANCE_KEY = "cold_window_bloom_filter_fp_chance";
+    static constexpr auto COLD_WINDOW_SUMMARY_RATIO_KEY = "cold_window_summary_ratio";
 private:
     const std::unordered_map<sstring, std::chrono::seconds> valid_window_units = { { "MINUTES", 60s }, { "HOURS", 3600s }, { "DAYS", 86400s } };
 
@@ -51,6 +55,8 @@ class time_window_compaction_strategy_options {
     std::chrono::seconds sstable_window_size = DEFAULT_COMPACTION_WINDOW_UNIT * DEFAULT_COMPACTION_WINDOW_SIZE;
     db_clock::duration expired_sstable_check_frequency = DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS();
     timestamp_resolutions timestamp_resolution = timestamp_resolutions::microsecond;
+    std::optional<double> cold_window_bloom_filter_fp_chance;
+    std::optional<double> cold_window_summary_ratio;
 public:
     time_window_compaction_strategy_options(const time_window_compaction_strategy_options&);
     time_window_compaction_strategy_options(time_window_compaction_strategy_options&&);
@@ -113,6 +119,10 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
     get_next_non_expired_sstables(table_state& table_s, strategy_control& control, std::vector<shared_sstable> non_expiring_sstables, gc_clock::time_point compaction_time);
 
     std::vector<shared_sstable> get_compaction_candidates(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidate_sstables);
+
+    // Applies the cold window options to the descriptor, if all its sstables
+    // belong to a single window older than the newest one.
+    void maybe_set_cold_window_options(compaction_descriptor& desc) const;
 public:
     // Find the lowest timestamp for window of given size
     static timestamp_type
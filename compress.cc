@@ -60,6 +60,18 @@ std::map<sstring, sstring> compressor::options() const {
     return {};
 }
 
+std::map<sstring, sstring> compressor::stored_options() const {
+    return options();
+}
+
+size_t compressor::dictionary_sample_size() const {
+    return 0;
+}
+
+shared_ptr<compressor> compressor::train_dictionary(const std::vector<std::string_view>& samples) const {
+    return nullptr;
+}
+
 compressor::ptr_type compressor::create(const sstring& name, const opt_getter& opts) {
     if (name.empty()) {
         return {};
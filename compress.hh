@@ -10,6 +10,8 @@
 
 #include <map>
 #include <set>
+#include <string_view>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
@@ -50,6 +52,23 @@ class compressor {
      * Returns original options used in instantiating this compressor
      */
     virtual std::map<sstring, sstring> options() const;
+    /**
+     * Returns the options to be stored along with the compressed data, i.e.
+     * options() and whatever else is needed to uncompress it, like a dictionary.
+     */
+    virtual std::map<sstring, sstring> stored_options() const;
+
+    /**
+     * Returns the amount of data to be sampled for train_dictionary(), or 0
+     * if this compressor isn't configured to use a dictionary.
+     */
+    virtual size_t dictionary_sample_size() const;
+    /**
+     * Returns a compressor, with the same options as this one, which uses a
+     * dictionary trained on the given samples. Returns nullptr if no
+     * dictionary could be trained.
+     */
+    virtual shared_ptr<compressor> train_dictionary(const std::vector<std::string_view>& samples) const;
 
     /**
      * Compressor class name.
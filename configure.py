@@ -358,6 +358,8 @@ scylla_tests = set([
     'test/boost/bytes_ostream_test',
     'test/boost/cache_flat_mutation_reader_test',
     'test/boost/cached_file_test',
+    'test/boost/disk_block_cache_test',
+    'test/boost/chunk_cache_test',
     'test/boost/caching_options_test',
     'test/boost/canonical_mutation_test',
     'test/boost/cartesian_product_test',
@@ -383,6 +385,7 @@ scylla_tests = set([
     'test/boost/cql_query_group_test',
     'test/boost/cql_functions_test',
     'test/boost/crc_test',
+    'test/boost/cross_shard_batcher_test',
     'test/boost/data_listeners_test',
     'test/boost/database_test',
     'test/boost/dirty_memory_manager_test',
@@ -402,6 +405,7 @@ scylla_tests = set([
     'test/boost/hash_test',
     'test/boost/hashers_test',
     'test/boost/hint_test',
+    'test/boost/hyperloglog_test',
     'test/boost/idl_test',
     'test/boost/input_stream_test',
     'test/boost/json_cql_query_test',
@@ -467,6 +471,7 @@ scylla_tests = set([
     'test/boost/sstable_move_test',
     'test/boost/statement_restrictions_test',
     'test/boost/storage_proxy_test',
+    'test/boost/timer_wheel_test',
     'test/boost/top_k_test',
     'test/boost/transport_test',
     'test/boost/types_test',
@@ -482,6 +487,7 @@ scylla_tests = set([
     'test/boost/virtual_reader_test',
     'test/boost/virtual_table_mutation_source_test',
     'test/boost/virtual_table_test',
+    'test/boost/zstd_rpc_compressor_test',
     'test/boost/bptree_test',
     'test/boost/btree_test',
     'test/boost/radix_tree_test',
@@ -516,8 +522,10 @@ scylla_tests = set([
     'test/perf/perf_cql_parser',
     'test/perf/perf_fast_forward',
     'test/perf/perf_hash',
+    'test/perf/perf_messaging',
     'test/perf/perf_mutation',
     'test/perf/perf_collection',
+    'test/perf/perf_row_cache',
     'test/perf/perf_row_cache_update',
     'test/perf/perf_row_cache_reads',
     'test/perf/logalloc',
@@ -665,6 +673,7 @@ scylla_raft_core = [
 ]
 
 scylla_core = (['message/messaging_service.cc',
+                'message/zstd_rpc_compressor.cc',
                 'replica/database.cc',
                 'replica/table.cc',
                 'replica/distributed_loader.cc',
@@ -702,6 +711,11 @@ scylla_core = (['message/messaging_service.cc',
                 'utils/rjson.cc',
                 'utils/human_readable.cc',
                 'utils/histogram_metrics_helper.cc',
+                'utils/stall_attribution.cc',
+                'utils/sampling_profiler.cc',
+                'utils/timer_wheel.cc',
+                'utils/disk_block_cache.cc',
+                'utils/alien_worker.cc',
                 'mutation_partition.cc',
                 'mutation_partition_view.cc',
                 'mutation_partition_serializer.cc',
@@ -717,6 +731,7 @@ scylla_core = (['message/messaging_service.cc',
                 'zstd.cc',
                 'sstables/sstables.cc',
                 'sstables/sstables_manager.cc',
+                'sstables/io_stats.cc',
                 'sstables/sstable_set.cc',
                 'sstables/mx/partition_reversing_data_source.cc',
                 'sstables/mx/reader.cc',
@@ -729,6 +744,7 @@ scylla_core = (['message/messaging_service.cc',
                 'compaction/compaction_strategy.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
                 'compaction/time_window_compaction_strategy.cc',
                 'compaction/compaction_manager.cc',
                 'sstables/integrity_checked_file_impl.cc',
@@ -764,6 +780,7 @@ scylla_core = (['message/messaging_service.cc',
                 'cql3/expr/expression.cc',
                 'cql3/expr/restrictions.cc',
                 'cql3/expr/prepare_expr.cc',
+                'cql3/expr/column_filter.cc',
                 'cql3/functions/user_function.cc',
                 'cql3/functions/functions.cc',
                 'cql3/functions/aggregate_fcts.cc',
@@ -842,6 +859,8 @@ scylla_core = (['message/messaging_service.cc',
                 'service/priority_manager.cc',
                 'service/migration_manager.cc',
                 'service/storage_proxy.cc',
+                'service/deferred_read_repair_queue.cc',
+                'service/replica_suspicion_listener.cc',
                 'query_ranges_to_vnodes.cc',
                 'service/forward_service.cc',
                 'service/paxos/proposal.cc',
@@ -1200,6 +1219,7 @@ pure_boost_tests = set([
     'test/boost/dynamic_bitset_test',
     'test/boost/enum_option_test',
     'test/boost/enum_set_test',
+    'test/boost/hyperloglog_test',
     'test/boost/idl_test',
     'test/boost/json_test',
     'test/boost/keys_test',
@@ -1230,6 +1250,7 @@ tests_not_using_seastar_test_framework = set([
     'test/perf/perf_hash',
     'test/perf/perf_mutation',
     'test/perf/perf_collection',
+    'test/perf/perf_row_cache',
     'test/perf/perf_row_cache_update',
     'test/perf/logalloc',
     'test/unit/lsa_async_eviction_test',
@@ -1285,7 +1306,9 @@ deps['test/boost/summary_test'] = ['test/boost/summary_test.cc']
 deps['test/boost/anchorless_list_test'] = ['test/boost/anchorless_list_test.cc']
 deps['test/perf/perf_fast_forward'] += ['seastar/tests/perf/linux_perf_event.cc']
 deps['test/perf/perf_simple_query'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc', 'test/lib/alternator_test_env.cc'] + alternator
+deps['test/perf/perf_messaging'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc']
 deps['test/perf/perf_commitlog'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc']
+deps['test/perf/perf_row_cache'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc']
 deps['test/perf/perf_row_cache_reads'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc']
 deps['test/perf/perf_row_cache_update'] += ['test/perf/perf.cc', 'seastar/tests/perf/linux_perf_event.cc']
 deps['test/boost/reusable_buffer_test'] = [
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "column_filter.hh"
+#include "cql3/query_options.hh"
+#include "utils/fragment_range.hh"
+#include "utils/overloaded_functor.hh"
+
+namespace cql3::expr {
+
+single_column_filter::single_column_filter(const column_definition& column)
+    : _column(&column)
+    , _type(&column.type->without_reversed())
+{
+    if (_type == int32_type.get()) {
+        _kind = value_kind::signed_integer;
+        _integer_size = sizeof(int32_t);
+    } else if (_type == long_type.get() || _type == timestamp_type.get()) {
+        _kind = value_kind::signed_integer;
+        _integer_size = sizeof(int64_t);
+    } else if (_type == utf8_type.get() || _type == ascii_type.get() || _type == bytes_type.get()) {
+        _kind = value_kind::string;
+    } else {
+        _kind = value_kind::generic;
+    }
+}
+
+static int64_t read_integer(managed_bytes_view v, size_t size) {
+    return size == sizeof(int32_t) ? read_simple_exactly<int32_t>(v) : read_simple_exactly<int64_t>(v);
+}
+
+bool single_column_filter::add(const binary_operator& op, const query_options& options) {
+    auto col = as_if<column_value>(&op.lhs);
+    if (!col || col->col != _column || op.order != comparison_order::cql) {
+        return false;
+    }
+    switch (op.op) {
+    case oper_t::EQ:
+    case oper_t::NEQ:
+    case oper_t::LT:
+    case oper_t::LTE:
+    case oper_t::GT:
+    case oper_t::GTE:
+        break;
+    default:
+        return false;
+    }
+    if (!is<constant>(op.rhs) && !is<bind_variable>(op.rhs)) {
+        return false;
+    }
+    auto value = evaluate(op.rhs, options);
+    if (value.is_unset_value()) {
+        // Leave reporting the error to the evaluation of the expression.
+        return false;
+    }
+    if (value.is_null()) {
+        // Comparisons with null are never true, but x != null is: it's !(x = null).
+        _never_satisfied |= op.op != oper_t::NEQ;
+        return true;
+    }
+    comparison c{op.op, std::move(value).to_managed_bytes()};
+    if (_kind == value_kind::signed_integer) {
+        if (c.value.size() != _integer_size) {
+            // Empty values (or garbage) are compared with the type's comparator.
+            _kind = value_kind::generic;
+        } else {
+            c.integer = read_integer(managed_bytes_view(c.value), _integer_size);
+        }
+    }
+    _comparisons.push_back(std::move(c));
+    return true;
+}
+
+std::optional<single_column_filter> single_column_filter::prepare(const expression& restriction, const query_options& options) {
+    const binary_operator* first = find_binop(restriction, [] (const binary_operator&) { return true; });
+    if (!first) {
+        return std::nullopt;
+    }
+    auto col = as_if<column_value>(&first->lhs);
+    if (!col) {
+        return std::nullopt;
+    }
+    single_column_filter filter(*col->col);
+    bool supported = visit(overloaded_functor{
+        [&] (const binary_operator& op) {
+            return filter.add(op, options);
+        },
+        [&] (const conjunction& c) {
+            return std::all_of(c.children.begin(), c.children.end(), [&] (const expression& child) {
+                auto op = as_if<binary_operator>(&child);
+                return op && filter.add(*op, options);
+            });
+        },
+        [] (const auto&) {
+            return false;
+        },
+    }, restriction);
+    if (!supported) {
+        return std::nullopt;
+    }
+    return filter;
+}
+
+std::strong_ordering single_column_filter::compare(managed_bytes_view value, const comparison& c) const {
+    switch (_kind) {
+    case value_kind::signed_integer:
+        if (value.size_bytes() == _integer_size) {
+            return read_integer(value, _integer_size) <=> c.integer;
+        }
+        break;
+    case value_kind::string:
+        return compare_unsigned(value, managed_bytes_view(c.value));
+    case value_kind::generic:
+        break;
+    }
+    return _type->compare(value, managed_bytes_view(c.value));
+}
+
+bool single_column_filter::is_satisfied_by(managed_bytes_view_opt value) const {
+    if (_never_satisfied) {
+        return false;
+    }
+    for (auto& c : _comparisons) {
+        if (!value) {
+            // Null satisfies only inequality.
+            if (c.op != oper_t::NEQ) {
+                return false;
+            }
+            continue;
+        }
+        if (_kind == value_kind::generic && (c.op == oper_t::EQ || c.op == oper_t::NEQ)) {
+            if (_type->equal(*value, managed_bytes_view(c.value)) != (c.op == oper_t::EQ)) {
+                return false;
+            }
+            continue;
+        }
+        auto cmp = compare(*value, c);
+        bool satisfied;
+        switch (c.op) {
+        case oper_t::EQ: satisfied = cmp == 0; break;
+        case oper_t::NEQ: satisfied = cmp != 0; break;
+        case oper_t::LT: satisfied = cmp < 0; break;
+        case oper_t::LTE: satisfied = cmp <= 0; break;
+        case oper_t::GT: satisfied = cmp > 0; break;
+        case oper_t::GTE: satisfied = cmp >= 0; break;
+        default: satisfied = false;
+        }
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace cql3::expr
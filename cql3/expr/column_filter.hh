@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "expression.hh"
+
+namespace cql3::expr {
+
+/// A restriction on a single column, prepared for checking it on many rows.
+///
+/// is_satisfied_by() walks the expression tree and re-evaluates the right-hand side
+/// of every comparison for each row. Restrictions used by filtering scans are mostly
+/// conjunctions of comparisons of a column with constants or bind variables, so the
+/// values can be evaluated once per query instead. Column values are then compared
+/// with them in their serialized form, and the comparison of integers, timestamps
+/// and strings doesn't go through the generic type comparator.
+class single_column_filter {
+public:
+    struct comparison {
+        oper_t op;
+        managed_bytes value;
+        int64_t integer = 0; // The decoded value, for value_kind::signed_integer
+    };
+private:
+    enum class value_kind {
+        signed_integer, // int and bigint, as well as timestamp, which compares as a signed 64-bit integer
+        string, // text, ascii and blob, which compare as unsigned bytes
+        generic,
+    };
+    const column_definition* _column;
+    const abstract_type* _type;
+    value_kind _kind;
+    size_t _integer_size = 0;
+    std::vector<comparison> _comparisons;
+    // Set when comparing with null, which no value satisfies.
+    bool _never_satisfied = false;
+private:
+    single_column_filter(const column_definition& column);
+    bool add(const binary_operator& op, const query_options& options);
+    std::strong_ordering compare(managed_bytes_view value, const comparison& c) const;
+public:
+    /// Returns a disengaged optional if the restriction doesn't have the supported form,
+    /// in which case it has to be checked with is_satisfied_by().
+    static std::optional<single_column_filter> prepare(const expression& restriction, const query_options& options);
+
+    const column_definition& column() const {
+        return *_column;
+    }
+
+    /// The restriction is the conjunction of the comparisons, unless never_satisfied().
+    const std::vector<comparison>& comparisons() const {
+        return _comparisons;
+    }
+
+    bool never_satisfied() const {
+        return _never_satisfied;
+    }
+
+    /// True iff the column value, which is null if disengaged, satisfies the restriction.
+    bool is_satisfied_by(managed_bytes_view_opt value) const;
+};
+
+} // namespace cql3::expr
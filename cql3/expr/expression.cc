@@ -166,7 +166,6 @@ get_value(const subscript& s, const evaluation_inputs& inputs) {
         // For null[i] we return null.
         return std::nullopt;
     }
-    const auto deserialized = cdef->type->deserialize(managed_bytes_view(*serialized));
     const auto key = evaluate(s.sub, inputs);
     auto&& key_type = col_type->is_map() ? col_type->name_comparator() : int32_type;
     if (key.is_null()) {
@@ -192,17 +191,18 @@ get_value(const subscript& s, const evaluation_inputs& inputs) {
             format("Unsupported unset map key for column {}",
                 cdef->name_as_text()));
     }
+    // Elements are looked up in the serialized form, as deserializing large collections
+    // just to find a single element is expensive.
     if (col_type->is_map()) {
-        const auto& data_map = value_cast<map_type_impl::native_type>(deserialized);
+        const auto data_map = partially_deserialize_map_views(managed_bytes_view(*serialized), cql_serialization_format::internal());
         const auto found = key.view().with_linearized([&] (bytes_view key_bv) {
-            using entry = std::pair<data_value, data_value>;
-            return std::find_if(data_map.cbegin(), data_map.cend(), [&] (const entry& element) {
-                return key_type->compare(element.first.serialize_nonnull(), key_bv) == 0;
+            return std::find_if(data_map.cbegin(), data_map.cend(), [&] (const auto& element) {
+                return key_type->compare(element.first, managed_bytes_view(key_bv)) == 0;
             });
         });
-        return found == data_map.cend() ? std::nullopt : managed_bytes_opt(found->second.serialize_nonnull());
+        return found == data_map.cend() ? std::nullopt : managed_bytes_opt(managed_bytes(found->second));
     } else if (col_type->is_list()) {
-        const auto& data_list = value_cast<list_type_impl::native_type>(deserialized);
+        const auto data_list = partially_deserialize_listlike_views(managed_bytes_view(*serialized), cql_serialization_format::internal());
         auto key_deserialized = key.view().with_linearized([&] (bytes_view key_bv) {
             return key_type->deserialize(key_bv);
         });
@@ -210,7 +210,7 @@ get_value(const subscript& s, const evaluation_inputs& inputs) {
         if (key_int < 0 || size_t(key_int) >= data_list.size()) {
             return std::nullopt;
         }
-        return managed_bytes_opt(data_list[key_int].serialize_nonnull());
+        return managed_bytes_opt(managed_bytes(data_list[key_int]));
     } else {
         throw exceptions::invalid_request_exception(format("subscripting non-map, non-list column {}", cdef->name_as_text()));
     }
@@ -332,29 +332,27 @@ bool limits(const tuple_constructor& columns_tuple, const oper_t op, const expre
     return op == oper_t::LTE || op == oper_t::GTE;
 }
 
-/// True iff collection (list, set, or map) contains value.
-bool contains(const data_value& collection, const raw_value_view& value) {
+/// True iff the serialized collection (list, set, or map) of the given type contains value.
+bool contains(const abstract_type& type, managed_bytes_view collection, const raw_value_view& value) {
     if (!value) {
         // CONTAINS NULL should evaluate to NULL/false
         return false;
     }
-    auto col_type = static_pointer_cast<const collection_type_impl>(collection.type());
-    auto&& element_type = col_type->is_set() ? col_type->name_comparator() : col_type->value_comparator();
+    auto& col_type = dynamic_cast<const collection_type_impl&>(type.without_reversed());
+    auto&& element_type = col_type.is_set() ? col_type.name_comparator() : col_type.value_comparator();
+    const auto sf = cql_serialization_format::internal();
     return value.with_linearized([&] (bytes_view val) {
         auto exists_in = [&](auto&& range) {
-            auto found = std::find_if(range.begin(), range.end(), [&] (auto&& element) {
-                return element_type->compare(element.serialize_nonnull(), val) == 0;
+            auto found = std::find_if(range.begin(), range.end(), [&] (managed_bytes_view element) {
+                return element_type->compare(element, managed_bytes_view(val)) == 0;
             });
             return found != range.end();
         };
-        if (col_type->is_list()) {
-            return exists_in(value_cast<list_type_impl::native_type>(collection));
-        } else if (col_type->is_set()) {
-            return exists_in(value_cast<set_type_impl::native_type>(collection));
-        } else if (col_type->is_map()) {
-            auto data_map = value_cast<map_type_impl::native_type>(collection);
-            using entry = std::pair<data_value, data_value>;
-            return exists_in(data_map | transformed([] (const entry& e) { return e.second; }));
+        if (col_type.is_list() || col_type.is_set()) {
+            return exists_in(partially_deserialize_listlike_views(collection, sf));
+        } else if (col_type.is_map()) {
+            using entry = std::pair<managed_bytes_view, managed_bytes_view>;
+            return exists_in(partially_deserialize_map_views(collection, sf) | transformed([] (const entry& e) { return e.second; }));
         } else {
             throw std::logic_error("unsupported collection type in a CONTAINS expression");
         }
@@ -365,7 +363,7 @@ bool contains(const data_value& collection, const raw_value_view& value) {
 bool contains(const column_value& col, const raw_value_view& value, const evaluation_inputs& inputs) {
     const auto collection = get_value(col, inputs);
     if (collection) {
-        return contains(col.col->type->deserialize(managed_bytes_view(*collection)), value);
+        return contains(*col.col->type, managed_bytes_view(*collection), value);
     } else {
         return false;
     }
@@ -382,12 +380,11 @@ bool contains_key(const column_value& col, cql3::raw_value_view key, const evalu
     if (!collection) {
         return false;
     }
-    const auto data_map = value_cast<map_type_impl::native_type>(type->deserialize(managed_bytes_view(*collection)));
+    const auto data_map = partially_deserialize_map_views(managed_bytes_view(*collection), cql_serialization_format::internal());
     auto key_type = static_pointer_cast<const collection_type_impl>(type)->name_comparator();
     auto found = key.with_linearized([&] (bytes_view k_bv) {
-        using entry = std::pair<data_value, data_value>;
-        return std::find_if(data_map.begin(), data_map.end(), [&] (const entry& element) {
-            return key_type->compare(element.first.serialize_nonnull(), k_bv) == 0;
+        return std::find_if(data_map.begin(), data_map.end(), [&] (const auto& element) {
+            return key_type->compare(element.first, managed_bytes_view(k_bv)) == 0;
         });
     });
     return found != data_map.end();
@@ -786,6 +783,29 @@ nonwrapping_range<clustering_key_prefix> to_range(oper_t op, const clustering_ke
     return to_range<const clustering_key_prefix&>(op, val);
 }
 
+/// Values matching a LIKE pattern start with its literal prefix, so in byte order (which is the order of
+/// the string types LIKE applies to) they lie between the prefix and the prefix with its last byte
+/// incremented.  The pattern still has to be checked on the values in the range.
+static value_set like_prefix_range(bytes_view pattern) {
+    bytes prefix = like_matcher::literal_prefix(pattern);
+    if (prefix.empty()) {
+        return unbounded_value_set;
+    }
+    static constexpr bool inclusive = true, exclusive = false;
+    auto start = interval_bound(managed_bytes(prefix), inclusive);
+    bytes successor = prefix;
+    auto len = successor.size();
+    while (len && uint8_t(successor[len - 1]) == 0xff) {
+        --len;
+    }
+    if (!len) {
+        return nonwrapping_range<managed_bytes>::make_starting_with(std::move(start));
+    }
+    successor.resize(len);
+    successor[len - 1] = uint8_t(successor[len - 1]) + 1;
+    return nonwrapping_range<managed_bytes>(std::move(start), interval_bound(managed_bytes(successor), exclusive));
+}
+
 value_set possible_lhs_values(const column_definition* cdef, const expression& expr, const query_options& options) {
     const auto type = cdef ? &cdef->type->without_reversed() : long_type.get();
     return expr::visit(overloaded_functor{
@@ -826,6 +846,12 @@ value_set possible_lhs_values(const column_definition* cdef, const expression& e
                                     return empty_value_set; // All NULL comparisons fail; no column values match.
                                 }
                                 return value_set(value_list{*val});
+                            } else if (oper.op == oper_t::LIKE) {
+                                managed_bytes_opt val = evaluate(oper.rhs, options).to_managed_bytes_opt();
+                                if (!val) {
+                                    return empty_value_set; // All NULL comparisons fail; no column values match.
+                                }
+                                return like_prefix_range(to_bytes(*val));
                             }
                             throw std::logic_error(format("possible_lhs_values: unhandled operator {}", oper));
                         },
@@ -14,6 +14,7 @@
 #include "cql3/functions/scalar_function.hh"
 #include "cql_serialization_format.hh"
 #include "utils/big_decimal.hh"
+#include "utils/big_number_accumulator.hh"
 #include "aggregate_fcts.hh"
 #include "user_aggregate.hh"
 #include "functions.hh"
@@ -24,6 +25,8 @@
 #include <cstdint>
 #include <optional>
 #include <type_traits>
+#include <bit>
+#include <seastar/core/byteorder.hh>
 
 using namespace cql3;
 using namespace functions;
@@ -46,6 +49,9 @@ class impl_count_function : public aggregate_function::aggregate {
     virtual void add_input(cql_serialization_format sf, const std::vector<opt_bytes>& values) override {
         ++_count;
     }
+    virtual void add_input_batch(cql_serialization_format sf, const argument_batch& values) override {
+        _count += values.size();
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _count = value_cast<int64_t>(long_type->deserialize(bytes_view(*acc)));
@@ -166,12 +172,98 @@ struct same_type_accumulator_for {
     }
 };
 
+// Sums of varints and decimals are accumulated in 128 bits while they fit,
+// rather than in multiprecision arithmetic.
+template <typename T, typename Accumulator>
+struct big_number_accumulator_for {
+    using type = Accumulator;
+
+    static T narrow(const type& acc) {
+        return acc.get();
+    }
+
+    static data_value decompose_to_data_value(const type& acc) {
+        return data_value(acc.get());
+    }
+
+    static bytes_opt decompose(const data_value& value) {
+        return data_type_for<T>()->decompose(value);
+    }
+
+    static bytes_opt decompose(const type& acc) {
+        return data_type_for<T>()->decompose(decompose_to_data_value(acc));
+    }
+
+    static type cast_to_accumulator(const data_value& value) {
+        return type(value_cast<T>(value));
+    }
+
+    static type deserialize(const bytes_opt& acc) {
+        return cast_to_accumulator(data_type_for<T>()->deserialize(*acc));
+    }
+
+    static shared_ptr<const abstract_type> data_type() {
+        return data_type_for<T>();
+    }
+};
+
 template <typename T>
 struct accumulator_for : public std::conditional_t<std::is_integral_v<T>,
                                                    int128_accumulator_for<T>,
                                                    same_type_accumulator_for<T>>
 { };
 
+template <>
+struct accumulator_for<utils::multiprecision_int>
+        : public big_number_accumulator_for<utils::multiprecision_int, utils::varint_accumulator>
+{ };
+
+template <>
+struct accumulator_for<big_decimal>
+        : public big_number_accumulator_for<big_decimal, utils::decimal_accumulator>
+{ };
+
+// Accumulators which can add values in their serialized form.
+template <typename T>
+concept serialized_accumulator = requires (T acc, bytes_view v) {
+    { acc.add_serialized(v) } -> std::same_as<bool>;
+};
+
+// Types serialized as fixed-width big-endian numbers, whose batches
+// can be decoded without going through data_value.
+template <typename T>
+concept fixed_width_numeric = std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>
+        || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>
+        || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Decodes the non-null values of a batch into a column vector, so that the
+// aggregation loops run over plain arrays. Values which don't have the width
+// of the type (i.e. empty ones) are passed to `fallback`, in order to handle
+// them the way add_input() does.
+template <fixed_width_numeric Type, typename Fallback>
+std::vector<Type> decode_batch(const argument_batch& values, Fallback&& fallback) {
+    std::vector<Type> ret;
+    ret.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values.is_null(i)) {
+            continue;
+        }
+        auto v = values.value(i);
+        if (v.size() != sizeof(Type)) {
+            fallback(i);
+            continue;
+        }
+        auto p = reinterpret_cast<const char*>(v.data());
+        if constexpr (std::is_integral_v<Type>) {
+            ret.push_back(read_be<Type>(p));
+        } else {
+            using bits_type = std::conditional_t<sizeof(Type) == sizeof(uint32_t), uint32_t, uint64_t>;
+            ret.push_back(std::bit_cast<Type>(read_be<bits_type>(p)));
+        }
+    }
+    return ret;
+}
+
 class impl_user_aggregate : public aggregate_function::aggregate {
     ::shared_ptr<scalar_function> _sfunc;
     ::shared_ptr<scalar_function> _rfunc;
@@ -225,8 +317,23 @@ class impl_sum_function_for : public aggregate_function::aggregate {
         if (!values[0]) {
             return;
         }
+        if constexpr (serialized_accumulator<accumulator_type>) {
+            if (_sum.add_serialized(*values[0])) {
+                return;
+            }
+        }
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    virtual void add_input_batch(cql_serialization_format sf, const argument_batch& values) override {
+        if constexpr (fixed_width_numeric<Type>) {
+            auto column = decode_batch<Type>(values, [&] (size_t i) { add_input(sf, {values.get(i)}); });
+            for (auto v : column) {
+                _sum += v;
+            }
+        } else {
+            aggregate::add_input_batch(sf, values);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _sum = accumulator_for<Type>::deserialize(acc);
@@ -298,11 +405,19 @@ class impl_div_for_avg {
     }
 };
 
+template <>
+class impl_div_for_avg<utils::multiprecision_int> {
+public:
+    static utils::multiprecision_int div(const utils::varint_accumulator& x, const int64_t y) {
+        return x.get() / y;
+    }
+};
+
 template <>
 class impl_div_for_avg<big_decimal> {
 public:
-    static big_decimal div(const big_decimal& x, const int64_t y) {
-        return x.div(y, big_decimal::rounding_mode::HALF_EVEN);
+    static big_decimal div(const utils::decimal_accumulator& x, const int64_t y) {
+        return x.get().div(y, big_decimal::rounding_mode::HALF_EVEN);
     }
 };
 
@@ -328,8 +443,24 @@ class impl_avg_function_for : public aggregate_function::aggregate {
             return;
         }
         ++_count;
+        if constexpr (serialized_accumulator<typename accumulator_for<Type>::type>) {
+            if (_sum.add_serialized(*values[0])) {
+                return;
+            }
+        }
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    virtual void add_input_batch(cql_serialization_format sf, const argument_batch& values) override {
+        if constexpr (fixed_width_numeric<Type>) {
+            auto column = decode_batch<Type>(values, [&] (size_t i) { add_input(sf, {values.get(i)}); });
+            for (auto v : column) {
+                _sum += v;
+            }
+            _count += column.size();
+        } else {
+            aggregate::add_input_batch(sf, values);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             data_type tuple_type = tuple_type_impl::get_instance({accumulator_for<Type>::data_type(), long_type});
@@ -474,6 +605,21 @@ class impl_max_function_for final : public aggregate_function::aggregate {
             _max = max_wrapper(*_max, val);
         }
     }
+    virtual void add_input_batch(cql_serialization_format sf, const argument_batch& values) override {
+        if constexpr (fixed_width_numeric<Type>) {
+            auto column = decode_batch<Type>(values, [&] (size_t i) { add_input(sf, {values.get(i)}); });
+            if (column.empty()) {
+                return;
+            }
+            Type acc = _max ? *_max : column.front();
+            for (auto v : column) {
+                acc = max_wrapper(acc, v);
+            }
+            _max = acc;
+        } else {
+            aggregate::add_input_batch(sf, values);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _max = value_cast<typename aggregate_type_for<Type>::type>(data_type_for<Type>()->deserialize(*acc));
@@ -615,6 +761,21 @@ class impl_min_function_for final : public aggregate_function::aggregate {
             _min = min_wrapper(*_min, val);
         }
     }
+    virtual void add_input_batch(cql_serialization_format sf, const argument_batch& values) override {
+        if constexpr (fixed_width_numeric<Type>) {
+            auto column = decode_batch<Type>(values, [&] (size_t i) { add_input(sf, {values.get(i)}); });
+            if (column.empty()) {
+                return;
+            }
+            Type acc = _min ? *_min : column.front();
+            for (auto v : column) {
+                acc = min_wrapper(acc, v);
+            }
+            _min = acc;
+        } else {
+            aggregate::add_input_batch(sf, values);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _min = value_cast<typename aggregate_type_for<Type>::type>(data_type_for<Type>()->deserialize(*acc));
@@ -729,6 +890,11 @@ class impl_count_function_for final : public aggregate_function::aggregate {
         }
         ++_count;
     }
+    virtual void add_input_batch(cql_serialization_format sf, const argument_batch& values) override {
+        for (size_t i = 0; i < values.size(); ++i) {
+            _count += !values.is_null(i);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _count = value_cast<int64_t>(long_type->deserialize(bytes_view(*acc)));
@@ -48,27 +48,26 @@ class as_json_function : public scalar_function {
     virtual bool requires_thread() const override;
 
     virtual bytes_opt execute(cql_serialization_format sf, const std::vector<bytes_opt>& parameters) override {
-        bytes_ostream encoded_row;
-        encoded_row.write("{", 1);
+        std::string encoded_row;
+        encoded_row += '{';
         for (size_t i = 0; i < _selector_names.size(); ++i) {
             if (i > 0) {
-                encoded_row.write(", ", 2);
+                encoded_row += ", ";
             }
             bool has_any_upper = boost::algorithm::any_of(_selector_names[i], [](unsigned char c) { return std::isupper(c); });
-            encoded_row.write("\"", 1);
+            encoded_row += '"';
             if (has_any_upper) {
-                encoded_row.write("\\\"", 2);
+                encoded_row += "\\\"";
             }
-            encoded_row.write(_selector_names[i].c_str(), _selector_names[i].size());
+            encoded_row += _selector_names[i];
             if (has_any_upper) {
-                encoded_row.write("\\\"", 2);
+                encoded_row += "\\\"";
             }
-            encoded_row.write("\": ", 3);
-            sstring row_sstring = to_json_string(*_selector_types[i], parameters[i]);
-            encoded_row.write(row_sstring.c_str(), row_sstring.size());
+            encoded_row += "\": ";
+            write_json(encoded_row, *_selector_types[i], parameters[i]);
         }
-        encoded_row.write("}", 1);
-        return bytes(encoded_row.linearize());
+        encoded_row += '}';
+        return bytes(reinterpret_cast<const int8_t*>(encoded_row.data()), encoded_row.size());
     }
 
     virtual const function_name& name() const override {
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#include "cql3/prepared_statements_cache.hh"
+#include "utils/estimated_histogram.hh"
+
+namespace cql3 {
+
+// Execution statistics of prepared statements on this shard.
+//
+// At most max_entries statements are tracked. When a statement which isn't
+// tracked yet is executed while the table is full, it replaces the statement
+// with the lowest total execution time, so that the most expensive ones are
+// retained.
+class prepared_statement_stats {
+public:
+    // Latencies in microseconds, from 16us to 16s.
+    using latency_histogram = utils::approx_exponential_histogram<16, 16777216, 4>;
+
+    struct entry {
+        sstring query_string;
+        uint64_t calls = 0;
+        uint64_t errors = 0;
+        std::chrono::microseconds total_latency{0};
+        latency_histogram latency;
+
+        entry& merge(const entry& o) {
+            calls += o.calls;
+            errors += o.errors;
+            total_latency += o.total_latency;
+            latency.merge(o.latency);
+            return *this;
+        }
+    };
+
+    using map_type = std::unordered_map<prepared_cache_key_type, entry>;
+
+    static constexpr size_t default_max_entries = 1000;
+private:
+    size_t _max_entries;
+    map_type _entries;
+private:
+    map_type::iterator find_or_create(const prepared_cache_key_type& key, const sstring& query_string) {
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            return it;
+        }
+        if (_entries.size() >= _max_entries) {
+            _entries.erase(std::min_element(_entries.begin(), _entries.end(), [] (const auto& a, const auto& b) {
+                return a.second.total_latency < b.second.total_latency;
+            }));
+        }
+        return _entries.emplace(key, entry{query_string}).first;
+    }
+public:
+    explicit prepared_statement_stats(size_t max_entries = default_max_entries)
+        : _max_entries(std::max(max_entries, size_t(1)))
+    { }
+
+    void record(const prepared_cache_key_type& key, const sstring& query_string, std::chrono::microseconds latency, bool failed) {
+        auto& e = find_or_create(key, query_string)->second;
+        ++e.calls;
+        e.errors += failed;
+        e.total_latency += latency;
+        e.latency.add(latency.count());
+    }
+
+    const map_type& entries() const noexcept {
+        return _entries;
+    }
+};
+
+}
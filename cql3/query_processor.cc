@@ -11,6 +11,7 @@
 #include "cql3/query_processor.hh"
 
 #include <seastar/core/metrics.hh>
+#include <seastar/core/with_scheduling_group.hh>
 
 #include "service/storage_proxy.hh"
 #include "cql3/CqlParser.hpp"
@@ -22,6 +23,7 @@
 #include "db/config.hh"
 #include "data_dictionary/data_dictionary.hh"
 #include "hashers.hh"
+#include "utils/memory_usage_metrics.hh"
 
 namespace cql3 {
 
@@ -90,6 +92,22 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
         "statements_prepared",
         _stats.prepare_invocations,
         sm::description("Counts the total number of parsed CQL requests.")));
+    qp_group.push_back(sm::make_counter(
+        "unprepared_statements_cache_hits",
+        [this] { return _unprepared_cache.hits(); },
+        sm::description("Counts unprepared statements which were found in the cache of unprepared statements, and not parsed again.")));
+    qp_group.push_back(sm::make_counter(
+        "unprepared_statements_cache_misses",
+        [this] { return _unprepared_cache.misses(); },
+        sm::description("Counts unprepared statements which were parsed and prepared because they were not in the cache of unprepared statements.")));
+    qp_group.push_back(sm::make_counter(
+        "statements_prepared_from_other_shards",
+        _stats.prepared_from_other_shards,
+        sm::description("Counts prepared statements which were prepared on this shard on their first execution, from another shard's copy.")));
+    qp_group.push_back(sm::make_counter(
+        "heavy_statement_executions",
+        _stats.heavy_statement_executions,
+        sm::description("Counts executions of prepared statements classified as heavy, which run in a lower-priority scheduling group.")));
     for (auto cl = size_t(clevel::MIN_VALUE); cl <= size_t(clevel::MAX_VALUE); ++cl) {
         qp_group.push_back(
             sm::make_counter(
@@ -100,6 +118,12 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
     }
     _metrics.add_group("query_processor", qp_group);
 
+    _metrics.add_group(sstring(utils::memory_usage_metrics_group), {
+        utils::make_subsystem_memory_gauge("prepared_statements", [this] {
+            return _prepared_cache.memory_footprint() + _authorized_prepared_cache.memory_footprint();
+        }),
+    });
+
     sm::label cas_label("conditional");
     auto cas_label_instance = cas_label("yes");
     auto non_cas_label_instance = cas_label("no");
@@ -294,6 +318,14 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
                             sm::description("Counts the total number of sub-statements in CQL BATCH requests with conditions."),
                             {cas_label_instance}),
 
+                    sm::make_counter(
+                            "mutations_in_batches",
+                            _cql_stats.mutations_in_batches,
+                            sm::description("Counts the total number of partition mutations sent by CQL BATCH requests without conditions, "
+                                            "after merging the sub-statements modifying the same partition. "
+                                            "The ratio of statements_in_batches to this counter is the coalescing factor of batches."),
+                            {non_cas_label_instance}),
+
                     sm::make_counter(
                             "batches_pure_logged",
                             _cql_stats.batches_pure_logged,
@@ -465,10 +497,18 @@ future<> query_processor::stop() {
 future<::shared_ptr<result_message>>
 query_processor::execute_direct_without_checking_exception_message(const sstring_view& query_string, service::query_state& query_state, query_options& options) {
     log.trace("execute_direct: \"{}\"", query_string);
-    tracing::trace(query_state.get_trace_state(), "Parsing a statement");
-    auto p = get_statement(query_string, query_state.get_client_state());
+    const auto& client_state = query_state.get_client_state();
+    auto* p = _unprepared_cache.find(client_state.get_raw_keyspace(), query_string);
+    std::unique_ptr<statements::prepared_statement> uncached;
+    if (!p) {
+        tracing::trace(query_state.get_trace_state(), "Parsing a statement");
+        uncached = get_statement(query_string, client_state);
+        p = unprepared_statements_cache::cacheable(query_string)
+                ? _unprepared_cache.insert(client_state.get_raw_keyspace(), query_string, std::move(uncached))
+                : uncached.get();
+    }
     auto cql_statement = p->statement;
-    const auto warnings = std::move(p->warnings);
+    const auto warnings = p->warnings;
     if (cql_statement->get_bound_terms() != options.get_values_count()) {
         const auto msg = format("Invalid amount of bind variables: expected {:d} received {:d}",
                 cql_statement->get_bound_terms(),
@@ -504,6 +544,8 @@ query_processor::execute_prepared_without_checking_exception_message(
         bool needs_authorization) {
 
     ::shared_ptr<cql_statement> statement = prepared->statement;
+    auto tracked = prepared->checked_weak_from_this();
+    auto stats_key = cache_key;
     future<> fut = make_ready_future<>();
     if (needs_authorization) {
         fut = statement->check_access(*this, query_state.get_client_state()).then([this, &query_state, prepared = std::move(prepared), cache_key = std::move(cache_key)] () mutable {
@@ -514,8 +556,47 @@ query_processor::execute_prepared_without_checking_exception_message(
     }
     log.trace("execute_prepared: \"{}\"", statement->raw_cql_statement);
 
-    return fut.then([this, statement = std::move(statement), &query_state, &options] () mutable {
+    return fut.then([this, tracked = std::move(tracked), stats_key = std::move(stats_key), statement = std::move(statement), &query_state, &options] () mutable {
+        return process_authorized_prepared_statement(std::move(tracked), std::move(stats_key), std::move(statement), query_state, options);
+    });
+}
+
+future<::shared_ptr<result_message>>
+query_processor::process_authorized_prepared_statement(statements::prepared_statement::checked_weak_ptr prepared, prepared_cache_key_type cache_key,
+        ::shared_ptr<cql_statement> statement, service::query_state& query_state, const query_options& options) {
+    if (!prepared) {
         return process_authorized_statement(std::move(statement), query_state, options);
+    }
+    const auto threshold = std::chrono::milliseconds(_db.get_config().heavy_statement_threshold_in_ms());
+    const auto start = std::chrono::steady_clock::now();
+    const auto service_start = _service_time_clock.start(start);
+    future<::shared_ptr<result_message>> f = make_ready_future<::shared_ptr<result_message>>();
+    if (threshold.count() && prepared->heavy) {
+        ++_stats.heavy_statement_executions;
+        f = with_scheduling_group(_proxy.get_db().local().get_heavy_statement_scheduling_group(), [this, statement = std::move(statement), &query_state, &options] () mutable {
+            return process_authorized_statement(std::move(statement), query_state, options);
+        });
+    } else {
+        f = process_authorized_statement(std::move(statement), query_state, options);
+    }
+    // Failed executions count too, timeouts are the most expensive kind.
+    return f.then_wrapped([this, prepared = std::move(prepared), cache_key = std::move(cache_key), start, service_start, threshold] (future<::shared_ptr<result_message>> f) mutable {
+        const auto now = std::chrono::steady_clock::now();
+        auto t = std::chrono::duration_cast<std::chrono::microseconds>(now - start);
+        auto service_time = _service_time_clock.stop(service_start, now);
+        if (!prepared) {
+            return f;
+        }
+        if (threshold.count()) {
+            prepared->record_service_time(service_time, threshold);
+        }
+        if (f.failed()) {
+            _prepared_statement_stats.record(cache_key, prepared->statement->raw_cql_statement, t, true);
+            return f;
+        }
+        auto msg = f.get0();
+        _prepared_statement_stats.record(cache_key, prepared->statement->raw_cql_statement, t, msg && msg->is_exception());
+        return make_ready_future<::shared_ptr<result_message>>(std::move(msg));
     });
 }
 
@@ -594,9 +675,46 @@ query_processor::get_statement(const sstring_view& query, const service::client_
     ++_stats.prepare_invocations;
     auto p = statement->prepare(_db, _cql_stats);
     p->statement->raw_cql_statement = sstring(query);
+    p->keyspace = client_state.get_raw_keyspace();
     return p;
 }
 
+future<bool> query_processor::prepare_from_other_shards(prepared_cache_key_type key) {
+    struct source {
+        sstring query;
+        sstring keyspace;
+    };
+    std::optional<source> src;
+    for (unsigned shard = 0; shard < smp::count && !src; ++shard) {
+        if (shard == this_shard_id()) {
+            continue;
+        }
+        src = co_await container().invoke_on(shard, [key] (query_processor& qp) -> std::optional<source> {
+            auto p = qp.get_prepared(key);
+            if (!p) {
+                return std::nullopt;
+            }
+            return source{p->statement->raw_cql_statement, p->keyspace};
+        });
+    }
+    if (!src) {
+        co_return false;
+    }
+    ++_stats.prepared_from_other_shards;
+    co_await _prepared_cache.get(key, [this, &src] {
+        std::unique_ptr<raw::parsed_statement> statement = parse_statement(src->query);
+        if (auto cf_stmt = dynamic_cast<raw::cf_statement*>(statement.get())) {
+            cf_stmt->prepare_keyspace(src->keyspace);
+        }
+        ++_stats.prepare_invocations;
+        auto p = statement->prepare(_db, _cql_stats);
+        p->statement->raw_cql_statement = src->query;
+        p->keyspace = src->keyspace;
+        return make_ready_future<std::unique_ptr<statements::prepared_statement>>(std::move(p));
+    }).discard_result();
+    co_return true;
+}
+
 std::unique_ptr<raw::parsed_statement>
 query_processor::parse_statement(const sstring_view& query) {
     try {
@@ -951,6 +1069,8 @@ void query_processor::migration_subscriber::on_drop_view(const sstring& ks_name,
 void query_processor::migration_subscriber::remove_invalid_prepared_statements(
         sstring ks_name,
         std::optional<sstring> cf_name) {
+    // Unprepared statements are cheap to prepare again, drop them all.
+    _qp->_unprepared_cache.clear();
     _qp->_prepared_cache.remove_if([&] (::shared_ptr<cql_statement> stmt) {
         return this->should_invalidate(ks_name, cf_name, stmt);
     });
@@ -19,6 +19,9 @@
 
 #include "cql3/prepared_statements_cache.hh"
 #include "cql3/authorized_prepared_statements_cache.hh"
+#include "cql3/prepared_statement_stats.hh"
+#include "cql3/service_time_clock.hh"
+#include "cql3/unprepared_statements_cache.hh"
 #include "cql3/statements/prepared_statement.hh"
 #include "exceptions/exceptions.hh"
 #include "lang/wasm_instance_cache.hh"
@@ -104,6 +107,8 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     struct stats {
         uint64_t prepare_invocations = 0;
         uint64_t queries_by_cl[size_t(db::consistency_level::MAX_VALUE) + 1] = {};
+        uint64_t heavy_statement_executions = 0;
+        uint64_t prepared_from_other_shards = 0;
     } _stats;
 
     cql_stats _cql_stats;
@@ -115,6 +120,10 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
 
     prepared_statements_cache _prepared_cache;
     authorized_prepared_statements_cache _authorized_prepared_cache;
+    prepared_statement_stats _prepared_statement_stats;
+    // Measures the service time of prepared statements, which classifies
+    // them as heavy.
+    service_time_clock _service_time_clock;
 
     std::function<void(uint32_t)> _auth_prepared_cache_cfg_cb;
     serialized_action _authorized_prepared_cache_config_action;
@@ -125,6 +134,8 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     // don't bother with expiration on those.
     std::unordered_map<sstring, std::unique_ptr<statements::prepared_statement>> _internal_statements;
 
+    unprepared_statements_cache _unprepared_cache;
+
     wasm::instance_cache* _wasm_instance_cache;
 public:
     static const sstring CQL_VERSION;
@@ -167,6 +178,10 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
         return _cql_stats;
     }
 
+    const prepared_statement_stats& get_prepared_statement_stats() const noexcept {
+        return _prepared_statement_stats;
+    }
+
     wasm::instance_cache* get_wasm_instance_cache() {
         return _wasm_instance_cache;
     }
@@ -391,6 +406,12 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
             const std::string_view& query,
             const service::client_state& client_state);
 
+    // PREPARE only prepares the statement on the shard it arrives at. Other
+    // shards prepare it on its first execution there, from the query text
+    // of a shard which has it: this prepares the statement with the given
+    // id on this shard. Resolves to false if no shard has it prepared.
+    future<bool> prepare_from_other_shards(prepared_cache_key_type key);
+
     friend class migration_subscriber;
 
     shared_ptr<cql_transport::messages::result_message> bounce_to_shard(unsigned shard, cql3::computed_function_values cached_fn_calls);
@@ -409,6 +430,13 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     future<::shared_ptr<cql_transport::messages::result_message>>
     process_authorized_statement(const ::shared_ptr<cql_statement> statement, service::query_state& query_state, const query_options& options);
 
+    // Like process_authorized_statement(), but also tracks the service time of the
+    // prepared statement, and executes it in the heavy statement scheduling group if
+    // it's usually longer than heavy_statement_threshold_in_ms.
+    future<::shared_ptr<cql_transport::messages::result_message>>
+    process_authorized_prepared_statement(statements::prepared_statement::checked_weak_ptr prepared, prepared_cache_key_type cache_key,
+            ::shared_ptr<cql_statement> statement, service::query_state& query_state, const query_options& options);
+
     /*!
      * \brief created a state object for paging
      *
@@ -311,8 +311,14 @@ static std::vector<expr::expression> extract_clustering_prefix_restrictions(
             break;
         }
         if (find_needs_filtering(found->second)) { // This column's restriction doesn't define a clear bound.
+            // Except for LIKE, which bounds the column by its pattern's literal prefix, like a slice: c LIKE 'ab%'
+            // reads the range ['ab', 'ac').  The column is still filtered by the LIKE, see
+            // num_clustering_prefix_columns_that_need_not_be_filtered().
             // TODO: if this is a conjunction of filtering and non-filtering atoms, we could split them and add the
             // latter to the prefix.
+            if (!find_binop(found->second, [] (const binary_operator& b) { return needs_filtering(b.op) && b.op != oper_t::LIKE; })) {
+                prefix.push_back(found->second);
+            }
             break;
         }
         prefix.push_back(found->second);
@@ -961,8 +967,20 @@ dht::partition_range_vector partition_ranges_from_singles(
         }
     }
     cartesian_product cp(column_values);
-    dht::partition_range_vector ranges(product_size);
-    std::transform(cp.begin(), cp.end(), ranges.begin(), std::bind_front(range_from_bytes, std::ref(schema)));
+    std::vector<partition_key> keys;
+    keys.reserve(product_size);
+    std::transform(cp.begin(), cp.end(), std::back_inserter(keys), [] (const std::vector<managed_bytes>& pk) {
+        return partition_key::from_exploded(pk);
+    });
+    // Compute the tokens of all keys together, which is faster than one at a time.
+    std::vector<partition_key_view> key_views(keys.begin(), keys.end());
+    std::vector<dht::token> tokens(keys.size());
+    dht::get_tokens(schema, key_views, tokens);
+    dht::partition_range_vector ranges;
+    ranges.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ranges.push_back(dht::partition_range::make_singular(query::ring_position(std::move(tokens[i]), std::move(keys[i]))));
+    }
     return ranges;
 }
 
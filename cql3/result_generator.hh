@@ -34,10 +34,10 @@ class result_generator {
     private:
         void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
             if (def.is_multi_cell()) {
-                _visitor.accept_value(i.next_collection_cell());
+                accept_result_value(_visitor, i.next_collection_cell());
             } else {
                 auto cell = i.next_atomic_cell();
-                _visitor.accept_value(cell ? std::optional<query::result_bytes_view>(cell->value()) : std::optional<query::result_bytes_view>());
+                accept_result_value(_visitor, cell ? std::optional<query::result_bytes_view>(cell->value()) : std::optional<query::result_bytes_view>());
             }
         }
     public:
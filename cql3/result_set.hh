@@ -135,6 +135,18 @@ concept ResultVisitor = requires(Visitor& visitor) {
     visitor.end_row();
 };
 
+// Passes to the visitor a value which lives as long as the visited result.
+// Visitors which reference values after accept_value() returns take such
+// values through accept_result_value(), and copy all others.
+template<typename Visitor>
+void accept_result_value(Visitor& visitor, std::optional<query::result_bytes_view> value) {
+    if constexpr (requires { visitor.accept_result_value(value); }) {
+        visitor.accept_result_value(std::move(value));
+    } else {
+        visitor.accept_value(std::move(value));
+    }
+}
+
 class result_set {
     using col_type = bytes_opt;
     using row_type = std::vector<col_type>;
@@ -187,7 +199,7 @@ class result_set {
             visitor.start_row();
             for (auto i = 0u; i < column_count; i++) {
                 auto& cell = row[i];
-                visitor.accept_value(cell ? std::optional<query::result_bytes_view>(*cell) : std::optional<query::result_bytes_view>());
+                accept_result_value(visitor, cell ? std::optional<query::result_bytes_view>(*cell) : std::optional<query::result_bytes_view>());
             }
             visitor.end_row();
         }
@@ -189,6 +189,14 @@ class selection_with_processing : public selection {
         return _factories->get_reductions();
     }
 
+    virtual bool is_reducible_with_grouping() const override {
+        return _factories->does_grouped_reduction();
+    }
+
+    virtual std::vector<std::optional<sstring>> get_plain_column_names() const override {
+        return _factories->get_plain_column_names();
+    }
+
 protected:
     class selectors_with_processing : public selectors {
     private:
@@ -417,7 +425,22 @@ result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<const
     , _per_partition_remaining(_per_partition_limit)
     , _rows_fetched_for_last_partition(rows_fetched_for_last_partition)
     , _last_pkey(std::move(last_pkey))
-{ }
+{
+    auto prepare = [this] (const expr::single_column_restrictions_map& restrictions) {
+        for (auto&& [cdef, restriction] : restrictions) {
+            if (auto filter = expr::single_column_filter::prepare(restriction, _options)) {
+                _prepared_filters.emplace(cdef, std::move(*filter));
+            }
+        }
+    };
+    prepare(_restrictions->get_non_pk_restriction());
+    if (!_skip_pk_restrictions) {
+        prepare(_restrictions->get_single_column_partition_key_restrictions());
+    }
+    if (!_skip_ck_restrictions && !expr::contains_multi_column_restriction(_restrictions->get_clustering_columns_restrictions())) {
+        prepare(_restrictions->get_single_column_clustering_key_restrictions());
+    }
+}
 
 bool result_set_builder::restrictions_filter::do_filter(const selection& selection,
                                                          const std::vector<bytes>& partition_key,
@@ -446,15 +469,39 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
                 });
     }
 
-    auto static_row_iterator = static_row.iterator();
-    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
+    // Collected once per row, when a restriction on a non-primary-key column is checked first.
+    std::optional<std::vector<managed_bytes_opt>> static_and_regular_columns;
+    auto get_static_and_regular_columns = [&] () -> const std::vector<managed_bytes_opt>& {
+        if (!static_and_regular_columns) {
+            static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
+        }
+        return *static_and_regular_columns;
+    };
+    auto is_satisfied_by = [&] (const column_definition* cdef, const expr::expression& restriction,
+            managed_bytes_view_opt value, const std::vector<managed_bytes_opt>* static_and_regular_columns) {
+        if (auto it = _prepared_filters.find(cdef); it != _prepared_filters.end()) {
+            return it->second.is_satisfied_by(value);
+        }
+        return expr::is_satisfied_by(
+                restriction,
+                expr::evaluation_inputs{
+                    .partition_key = &partition_key,
+                    .clustering_key = &clustering_key,
+                    .static_and_regular_columns = static_and_regular_columns,
+                    .selection = &selection,
+                    .options = &_options,
+                });
+    };
+
     const expr::single_column_restrictions_map& non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
-    for (auto&& cdef : selection.get_columns()) {
+    const auto& columns = selection.get_columns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        auto cdef = columns[i];
         switch (cdef->kind) {
         case column_kind::static_column:
             // fallthrough
         case column_kind::regular_column: {
-            if (cdef->kind == column_kind::regular_column && !row_iterator) {
+            if (cdef->kind == column_kind::regular_column && !row) {
                 continue;
             }
             auto restr_it = non_pk_restrictions_map.find(cdef);
@@ -462,17 +509,9 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
                 continue;
             }
             const expr::expression& single_col_restriction = restr_it->second;
-            // FIXME: push to upper layer so it happens once per row
-            auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
-            bool regular_restriction_matches = expr::is_satisfied_by(
-                    single_col_restriction,
-                    expr::evaluation_inputs{
-                        .partition_key = &partition_key,
-                        .clustering_key = &clustering_key,
-                        .static_and_regular_columns = &static_and_regular_columns,
-                        .selection = &selection,
-                        .options = &_options,
-                    });
+            auto& values = get_static_and_regular_columns();
+            bool regular_restriction_matches = is_satisfied_by(cdef, single_col_restriction,
+                    values[i] ? managed_bytes_view_opt(*values[i]) : std::nullopt, &values);
             if (!regular_restriction_matches) {
                 _current_static_row_does_not_match = (cdef->kind == column_kind::static_column);
                 return false;
@@ -483,21 +522,15 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             if (_skip_pk_restrictions) {
                 continue;
             }
-            auto partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
+            const expr::single_column_restrictions_map& partition_key_restrictions_map =
+                _restrictions->get_single_column_partition_key_restrictions();
             auto restr_it = partition_key_restrictions_map.find(cdef);
             if (restr_it == partition_key_restrictions_map.end()) {
                 continue;
             }
             const expr::expression& single_col_restriction = restr_it->second;
-            if (!expr::is_satisfied_by(
-                        single_col_restriction,
-                        expr::evaluation_inputs{
-                            .partition_key = &partition_key,
-                            .clustering_key = &clustering_key,
-                            .static_and_regular_columns = nullptr, // partition key filtering only
-                            .selection = &selection,
-                            .options = &_options,
-                        })) {
+            // partition key filtering only
+            if (!is_satisfied_by(cdef, single_col_restriction, managed_bytes_view(bytes_view(partition_key[cdef->id])), nullptr)) {
                 _current_partition_key_does_not_match = true;
                 return false;
             }
@@ -517,15 +550,8 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
                 return false;
             }
             const expr::expression& single_col_restriction = restr_it->second;
-            if (!expr::is_satisfied_by(
-                        single_col_restriction,
-                        expr::evaluation_inputs{
-                            .partition_key = &partition_key,
-                            .clustering_key = &clustering_key,
-                            .static_and_regular_columns = nullptr, // clustering key checks only
-                            .selection = &selection,
-                            .options = &_options,
-                        })) {
+            // clustering key checks only
+            if (!is_satisfied_by(cdef, single_col_restriction, managed_bytes_view(bytes_view(clustering_key[cdef->id])), nullptr)) {
                 return false;
             }
             }
@@ -15,6 +15,7 @@
 #include "query-result-reader.hh"
 #include "cql3/column_specification.hh"
 #include "cql3/selection/selector.hh"
+#include "cql3/expr/column_filter.hh"
 #include "exceptions/exceptions.hh"
 #include "unimplemented.hh"
 #include <seastar/core/thread.hh>
@@ -148,6 +149,12 @@ class selection {
 
     virtual query::forward_request::reductions_info get_reductions() const {return {{}, {}};}
 
+    // Whether every selector is either a reducible aggregate or a plain
+    // column selector, see selector_factories::does_grouped_reduction().
+    virtual bool is_reducible_with_grouping() const {return false;}
+
+    virtual std::vector<std::optional<sstring>> get_plain_column_names() const {return {};}
+
     /**
      * Checks that selectors are either all aggregates or that none of them is.
      *
@@ -229,6 +236,9 @@ class result_set_builder {
         mutable uint64_t _rows_fetched_for_last_partition;
         mutable std::optional<partition_key> _last_pkey;
         mutable bool _is_first_partition_on_page = true;
+        // Single column restrictions which could be prepared for checking rows
+        // without evaluating them. The other ones go through expr::is_satisfied_by().
+        std::unordered_map<const column_definition*, expr::single_column_filter> _prepared_filters;
     public:
         explicit restrictions_filter(::shared_ptr<const restrictions::statement_restrictions> restrictions,
                 const query_options& options,
@@ -254,6 +264,8 @@ class result_set_builder {
     void add_collection(const column_definition& def, bytes_view c);
     void new_row();
     std::unique_ptr<result_set> build();
+    // The number of rows, or groups, built so far.
+    size_t result_set_size() const { return _result_set->size(); }
     api::timestamp_type timestamp_of(size_t idx);
     int32_t ttl_of(size_t idx);
 
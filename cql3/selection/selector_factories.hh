@@ -130,10 +130,24 @@ class selector_factories {
         });
     }
 
+    // Whether every selector either is a reducible aggregate or selects
+    // a column as is, which grouped queries can reduce per group.
+    bool does_grouped_reduction() const {
+        return does_aggregation() && std::all_of(_factories.cbegin(), _factories.cend(), [](const ::shared_ptr<selector::factory>& factory) {
+            return factory->is_simple_selector_factory()
+                    || (factory->is_reducible_selector_factory() && factory->contains_only_simple_arguments());
+        });
+    }
+
+    // Selectors of plain columns are skipped, they select the grouping
+    // columns of grouped reductions.
     query::forward_request::reductions_info get_reductions() const {
         std::vector<query::forward_request::reduction_type> types;
         std::vector<query::forward_request::aggregation_info> infos;
         for (const auto& factory: _factories) {
+            if (factory->is_simple_selector_factory()) {
+                continue;
+            }
             auto r = factory->get_reduction();
             if (!r) {
                 throw std::runtime_error(format("Column {} doesn't have reduction type", factory->column_name()));
@@ -145,6 +159,17 @@ class selector_factories {
         return {types, infos};
     }
 
+    // For each selector, the name of the column it selects as is, or
+    // std::nullopt if it isn't a plain column selector.
+    std::vector<std::optional<sstring>> get_plain_column_names() const {
+        std::vector<std::optional<sstring>> names;
+        names.reserve(_factories.size());
+        for (const auto& factory: _factories) {
+            names.push_back(factory->is_simple_selector_factory() ? std::optional(factory->column_name()) : std::nullopt);
+        }
+        return names;
+    }
+
     /**
      * Checks if this <code>SelectorFactories</code> contains at least one factory for writetime selectors.
      *
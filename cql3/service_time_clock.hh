@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace cql3 {
+
+// Estimates the service time of statements executing concurrently on a shard.
+//
+// The wall time of an execution grows with the number of statements it runs
+// alongside, so when a shard is overloaded, every statement looks slow. This
+// clock instead advances at the rate of 1/n, where n is the number of
+// statements in flight, as if the shard served them all in parallel at an
+// equal share each. The difference of its readings at the start and at the
+// end of an execution is the time the execution would have taken alone.
+class service_time_clock {
+public:
+    using clock_type = std::chrono::steady_clock;
+    using duration = std::chrono::duration<double, std::micro>;
+private:
+    unsigned _in_flight = 0;
+    duration _now{0};
+    clock_type::time_point _updated = clock_type::now();
+private:
+    void advance(clock_type::time_point now) noexcept {
+        if (_in_flight && now > _updated) {
+            _now += std::chrono::duration_cast<duration>(now - _updated) / _in_flight;
+        }
+        _updated = std::max(_updated, now);
+    }
+public:
+    // Called when an execution starts, returns the reading to pass to stop().
+    duration start(clock_type::time_point now = clock_type::now()) noexcept {
+        advance(now);
+        ++_in_flight;
+        return _now;
+    }
+
+    // Called when the execution which started at the given reading ends,
+    // returns its service time.
+    std::chrono::microseconds stop(duration started, clock_type::time_point now = clock_type::now()) noexcept {
+        advance(now);
+        --_in_flight;
+        return std::chrono::duration_cast<std::chrono::microseconds>(_now - started);
+    }
+
+    unsigned in_flight() const noexcept {
+        return _in_flight;
+    }
+};
+
+}
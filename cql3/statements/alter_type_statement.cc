@@ -37,6 +37,13 @@ void alter_type_statement::prepare_keyspace(const service::client_state& state)
     }
 }
 
+void alter_type_statement::prepare_keyspace(std::string_view keyspace)
+{
+    if (!_name.has_keyspace()) {
+        _name.set_keyspace(sstring(keyspace));
+    }
+}
+
 future<> alter_type_statement::check_access(query_processor& qp, const service::client_state& state) const
 {
     return state.has_keyspace_access(qp.db(), keyspace(), auth::permission::ALTER);
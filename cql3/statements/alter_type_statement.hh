@@ -33,6 +33,7 @@ class alter_type_statement : public schema_altering_statement {
     alter_type_statement(const ut_name& name);
 
     virtual void prepare_keyspace(const service::client_state& state) override;
+    virtual void prepare_keyspace(std::string_view keyspace) override;
 
     virtual future<> check_access(query_processor& qp, const service::client_state& state) const override;
 
@@ -273,6 +273,7 @@ future<shared_ptr<cql_transport::messages::result_message>> batch_statement::do_
     auto timeout = db::timeout_clock::now() + get_timeout(query_state.get_client_state(), options);
     return get_mutations(qp, options, timeout, local, now, query_state).then([this, &qp, &options, timeout, tr_state = query_state.get_trace_state(),
                                                                                                                                permit = query_state.get_permit()] (std::vector<mutation> ms) mutable {
+        _stats.mutations_in_batches += ms.size();
         return execute_without_conditions(qp, std::move(ms), options.get_consistency(), timeout, std::move(tr_state), std::move(permit));
     }).then([] (coordinator_result<> res) {
         if (!res) {
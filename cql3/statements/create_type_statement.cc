@@ -35,6 +35,13 @@ void create_type_statement::prepare_keyspace(const service::client_state& state)
     }
 }
 
+void create_type_statement::prepare_keyspace(std::string_view keyspace)
+{
+    if (!_name.has_keyspace()) {
+        _name.set_keyspace(sstring(keyspace));
+    }
+}
+
 void create_type_statement::add_definition(::shared_ptr<column_identifier> name, ::shared_ptr<cql3_type::raw> type)
 {
     _column_names.emplace_back(name);
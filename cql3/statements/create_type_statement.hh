@@ -28,6 +28,7 @@ class create_type_statement : public schema_altering_statement {
     create_type_statement(const ut_name& name, bool if_not_exists);
 
     virtual void prepare_keyspace(const service::client_state& state) override;
+    virtual void prepare_keyspace(std::string_view keyspace) override;
 
     void add_definition(::shared_ptr<column_identifier> name, ::shared_ptr<cql3_type::raw> type);
 
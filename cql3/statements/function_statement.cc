@@ -74,6 +74,12 @@ void function_statement::prepare_keyspace(const service::client_state& state) {
     }
 }
 
+void function_statement::prepare_keyspace(std::string_view keyspace) {
+    if (!_name.has_keyspace()) {
+        _name.keyspace = sstring(keyspace);
+    }
+}
+
 create_function_statement_base::create_function_statement_base(functions::function_name name,
         std::vector<shared_ptr<cql3_type::raw>> raw_arg_types, bool or_replace, bool if_not_exists)
     : function_statement(std::move(name), std::move(raw_arg_types)), _or_replace(or_replace), _if_not_exists(if_not_exists) {}
@@ -26,6 +26,7 @@ class function_statement : public schema_altering_statement {
 protected:
     virtual future<> check_access(query_processor& qp, const service::client_state& state) const override;
     virtual void prepare_keyspace(const service::client_state& state) override;
+    virtual void prepare_keyspace(std::string_view keyspace) override;
     db::functions::function_name _name;
     std::vector<shared_ptr<cql3_type::raw>> _raw_arg_types;
     mutable std::vector<data_type> _arg_types;
@@ -13,6 +13,7 @@
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/weak_ptr.hh>
 #include <seastar/core/checked_ptr.hh>
+#include <chrono>
 #include <optional>
 #include <vector>
 
@@ -41,6 +42,27 @@ class prepared_statement : public seastar::weakly_referencable<prepared_statemen
     const std::vector<seastar::lw_shared_ptr<column_specification>> bound_names;
     std::vector<uint16_t> partition_key_bind_indices;
     std::vector<sstring> warnings;
+    // The keyspace of the session which prepared the statement; together
+    // with the query text it determines the statement's id.
+    sstring keyspace;
+    // Moving average of the service time of executions of this statement,
+    // see service_time_clock.
+    std::chrono::microseconds average_service_time{0};
+    // Whether the query processor executes the statement as a heavy one.
+    // The statement becomes heavy when its average service time reaches the
+    // threshold, and stops being heavy only when the average drops below half
+    // of it, so that statements close to the threshold don't flip back and
+    // forth with every execution.
+    bool heavy = false;
+
+    void record_service_time(std::chrono::microseconds t, std::chrono::microseconds heavy_threshold) noexcept {
+        average_service_time = average_service_time.count() ? (average_service_time * 7 + t) / 8 : t;
+        if (average_service_time >= heavy_threshold) {
+            heavy = true;
+        } else if (average_service_time < heavy_threshold / 2) {
+            heavy = false;
+        }
+    }
 
     prepared_statement(seastar::shared_ptr<cql_statement> statement_, std::vector<seastar::lw_shared_ptr<column_specification>> bound_names_,
                        std::vector<uint16_t> partition_key_bind_indices, std::vector<sstring> warnings = {});
@@ -46,6 +46,12 @@ class batch_statement : public raw::cf_statement {
         }
     }
 
+    virtual void prepare_keyspace(std::string_view keyspace) override {
+        for (auto&& s : _parsed_statements) {
+            s->prepare_keyspace(keyspace);
+        }
+    }
+
     virtual std::unique_ptr<prepared_statement> prepare(data_dictionary::database db, cql_stats& stats) override;
 };
 
@@ -35,8 +35,10 @@ class cf_statement : public parsed_statement {
 public:
     virtual void prepare_keyspace(const service::client_state& state);
 
-    // Only for internal calls, use the version with ClientState for user queries
-    void prepare_keyspace(std::string_view keyspace);
+    // Only for internal calls, use the version with ClientState for user queries.
+    // Statements which override the version with ClientState override this one too,
+    // with the given keyspace standing for the session's.
+    virtual void prepare_keyspace(std::string_view keyspace);
 
     virtual const sstring& keyspace() const;
 
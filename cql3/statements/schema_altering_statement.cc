@@ -59,6 +59,13 @@ void schema_altering_statement::prepare_keyspace(const service::client_state& st
     }
 }
 
+void schema_altering_statement::prepare_keyspace(std::string_view keyspace)
+{
+    if (_is_column_family_level) {
+        cf_statement::prepare_keyspace(keyspace);
+    }
+}
+
 future<::shared_ptr<messages::result_message>>
 schema_altering_statement::execute0(query_processor& qp, service::query_state& state, const query_options& options) const {
     auto& mm = qp.get_migration_manager();
@@ -55,6 +55,7 @@ class schema_altering_statement : public raw::cf_statement, public cql_statement
     virtual uint32_t get_bound_terms() const override;
 
     virtual void prepare_keyspace(const service::client_state& state) override;
+    virtual void prepare_keyspace(std::string_view keyspace) override;
 
     virtual future<std::pair<::shared_ptr<cql_transport::event::schema_change>, std::vector<mutation>>> prepare_schema_mutations(query_processor& qp, api::timestamp_type) const = 0;
 
@@ -10,6 +10,7 @@
 
 #include "cql3/statements/select_statement.hh"
 #include "cql3/expr/expression.hh"
+#include "cql3/expr/column_filter.hh"
 #include "cql3/statements/index_target.hh"
 #include "cql3/statements/raw/select_statement.hh"
 #include "cql3/query_processor.hh"
@@ -182,6 +183,28 @@ select_statement::select_statement(schema_ptr schema,
     _opts.set_if<query::partition_slice::option::bypass_cache>(_parameters->bypass_cache());
     _opts.set_if<query::partition_slice::option::distinct>(_parameters->is_distinct());
     _opts.set_if<query::partition_slice::option::reversed>(_is_reversed);
+
+    if (_selection->contains_static_columns()) {
+        _static_columns.reserve(_selection->get_column_count());
+    }
+    _regular_columns.reserve(_selection->get_column_count());
+    for (auto&& col : _selection->get_columns()) {
+        if (col->is_static()) {
+            _static_columns.push_back(col->id);
+        } else if (col->is_regular()) {
+            _regular_columns.push_back(col->id);
+        }
+    }
+
+    const expr::expression& ck_restrictions = _restrictions->get_clustering_columns_restrictions();
+    if (!expr::contains_bind_marker(ck_restrictions)
+            && !expr::find_in_expression<expr::function_call>(ck_restrictions, [] (const expr::function_call&) { return true; })) {
+        try {
+            _constant_clustering_bounds = make_clustering_bounds(query_options::DEFAULT);
+        } catch (...) {
+            // Leave reporting the error to execution.
+        }
+    }
 }
 
 db::timeout_clock::duration select_statement::get_timeout(const service::client_state& state, const query_options& options) const {
@@ -225,31 +248,8 @@ const sstring& select_statement::column_family() const {
     return _schema->cf_name();
 }
 
-query::partition_slice
-select_statement::make_partition_slice(const query_options& options) const
-{
-    query::column_id_vector static_columns;
-    query::column_id_vector regular_columns;
-
-    if (_selection->contains_static_columns()) {
-        static_columns.reserve(_selection->get_column_count());
-    }
-
-    regular_columns.reserve(_selection->get_column_count());
-
-    for (auto&& col : _selection->get_columns()) {
-        if (col->is_static()) {
-            static_columns.push_back(col->id);
-        } else if (col->is_regular()) {
-            regular_columns.push_back(col->id);
-        }
-    }
-
-    if (_parameters->is_distinct()) {
-        return query::partition_slice({ query::clustering_range::make_open_ended_both_sides() },
-            std::move(static_columns), {}, _opts, nullptr, options.get_cql_serialization_format());
-    }
-
+std::vector<query::clustering_range>
+select_statement::make_clustering_bounds(const query_options& options) const {
     auto bounds =_restrictions->get_clustering_bounds(options);
     if (bounds.size() > 1) {
         auto comparer = position_in_partition::less_compare(*_schema);
@@ -260,10 +260,60 @@ select_statement::make_partition_slice(const query_options& options) const
     }
     if (_is_reversed) {
         std::reverse(bounds.begin(), bounds.end());
+    }
+    return bounds;
+}
+
+query::partition_slice
+select_statement::make_partition_slice(const query_options& options) const
+{
+    if (_parameters->is_distinct()) {
+        return query::partition_slice({ query::clustering_range::make_open_ended_both_sides() },
+            _static_columns, {}, _opts, nullptr, options.get_cql_serialization_format());
+    }
+
+    auto bounds = _constant_clustering_bounds ? *_constant_clustering_bounds : make_clustering_bounds(options);
+    if (_is_reversed) {
         ++_stats.reverse_queries;
     }
     return query::partition_slice(std::move(bounds),
-        std::move(static_columns), std::move(regular_columns), _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
+        _static_columns, _regular_columns, _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
+}
+
+std::optional<query::row_filter>
+select_statement::make_row_filter(const query_options& options) const {
+    if (_parameters->is_distinct()) {
+        return std::nullopt;
+    }
+    auto to_comparison_op = [] (expr::oper_t op) {
+        switch (op) {
+        case expr::oper_t::EQ: return query::row_filter::comparison_op::eq;
+        case expr::oper_t::NEQ: return query::row_filter::comparison_op::neq;
+        case expr::oper_t::LT: return query::row_filter::comparison_op::lt;
+        case expr::oper_t::LTE: return query::row_filter::comparison_op::lte;
+        case expr::oper_t::GT: return query::row_filter::comparison_op::gt;
+        case expr::oper_t::GTE: return query::row_filter::comparison_op::gte;
+        default: throw std::logic_error(format("make_row_filter: unexpected operator {}", op));
+        }
+    };
+    query::row_filter filter;
+    for (auto&& [cdef, restriction] : _restrictions->get_non_pk_restriction()) {
+        // Static rows are checked once per partition, by the coordinator.
+        if (!cdef->is_regular() || !cdef->is_atomic() || cdef->is_counter()) {
+            continue;
+        }
+        auto prepared = expr::single_column_filter::prepare(restriction, options);
+        if (!prepared || prepared->never_satisfied()) {
+            continue;
+        }
+        for (auto& c : prepared->comparisons()) {
+            filter.comparisons.push_back(query::row_filter::comparison{cdef->id, to_comparison_op(c.op), to_bytes(c.value)});
+        }
+    }
+    if (filter.comparisons.empty()) {
+        return std::nullopt;
+    }
+    return filter;
 }
 
 uint64_t select_statement::do_get_limit(const query_options& options,
@@ -402,6 +452,13 @@ select_statement::do_execute(query_processor& qp,
     }
 
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
+    // Replicas can drop rows which don't match the filter only if the result comes
+    // from a single replica, since rows are filtered before they are reconciled.
+    // The per-partition limit counts rows before filtering on replicas.
+    if (_restrictions_need_filtering && !_per_partition_limit
+            && (cl == db::consistency_level::ONE || cl == db::consistency_level::LOCAL_ONE)) {
+        command->filter = make_row_filter(options);
+    }
     auto timeout_duration = get_timeout(state.get_client_state(), options);
     auto timeout = db::timeout_clock::now() + timeout_duration;
     auto p = service::pager::query_pagers::pager(qp.proxy(), _schema, _selection,
@@ -661,6 +718,8 @@ indexed_table_select_statement::do_execute_base_query(
         std::vector<primary_key>::iterator current_primary_key;
         size_t previous_result_size = 0;
         size_t next_iteration_size = 0;
+        // Runs of keys of the current iteration which are read with one query each.
+        std::vector<std::pair<std::vector<primary_key>::iterator, std::vector<primary_key>::iterator>> key_runs;
         base_query_state(uint64_t row_limit, std::vector<primary_key>&& keys)
                 : merger(row_limit, query::max_partitions)
                 , primary_keys(std::move(keys))
@@ -678,7 +737,8 @@ indexed_table_select_statement::do_execute_base_query(
         auto &key_it = query_state.current_primary_key;
         auto &previous_result_size = query_state.previous_result_size;
         auto &next_iteration_size = query_state.next_iteration_size;
-        return utils::result_repeat([this, is_paged, &previous_result_size, &next_iteration_size, &keys, &key_it, &merger, &qp, &state, &options, cmd, timeout]() {
+        auto &key_runs = query_state.key_runs;
+        return utils::result_repeat([this, is_paged, &previous_result_size, &next_iteration_size, &keys, &key_it, &key_runs, &merger, &qp, &state, &options, cmd, timeout]() {
             // Starting with 1 key, we check if the result was a short read, and if not,
             // we continue exponentially, asking for 2x more key than before
             auto already_done = std::distance(keys.begin(), key_it);
@@ -689,18 +749,39 @@ indexed_table_select_statement::do_execute_base_query(
             }
             next_iteration_size = std::min<size_t>({next_iteration_size, keys.size() - already_done, max_base_table_query_concurrency});
             auto key_it_end = key_it + next_iteration_size;
-            auto command = ::make_lw_shared<query::read_command>(*cmd);
+
+            // Rows of the same partition come one after another in the index,
+            // in clustering order, so they are read together with one query
+            // per partition. A run is only extended with full clustering keys
+            // which are strictly ascending, so that its ranges are ordered and
+            // don't overlap.
+            key_runs.clear();
+            auto ck_less = clustering_key_prefix::less_compare(*_schema);
+            for (auto it = key_it; it != key_it_end;) {
+                auto run_end = std::next(it);
+                if (it->clustering && it->clustering.is_full(*_schema)) {
+                    while (run_end != key_it_end
+                            && run_end->clustering && run_end->clustering.is_full(*_schema)
+                            && run_end->partition.equal(*_schema, it->partition)
+                            && ck_less(std::prev(run_end)->clustering, run_end->clustering)) {
+                        ++run_end;
+                    }
+                }
+                key_runs.emplace_back(it, run_end);
+                it = run_end;
+            }
 
             query::result_merger oneshot_merger(cmd->get_row_limit(), query::max_partitions);
-            return utils::result_map_reduce(key_it, key_it_end, [this, &qp, &state, &options, cmd, timeout] (auto& key) {
+            return utils::result_map_reduce(key_runs.begin(), key_runs.end(), [this, &qp, &state, &options, cmd, timeout] (auto& run) {
                 auto command = ::make_lw_shared<query::read_command>(*cmd);
-                // for each partition, read just one clustering row (TODO: can
-                // get all needed rows of one partition at once.)
+                auto& [run_begin, run_end] = run;
                 command->slice._row_ranges.clear();
-                if (key.clustering) {
-                    command->slice._row_ranges.push_back(query::clustering_range::make_singular(key.clustering));
+                for (auto it = run_begin; it != run_end; ++it) {
+                    if (it->clustering) {
+                        command->slice._row_ranges.push_back(query::clustering_range::make_singular(it->clustering));
+                    }
                 }
-                return qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(key.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
+                return qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(run_begin->partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
                 .then(utils::result_wrap([] (service::storage_proxy::coordinator_query_result qr) -> coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>> {
                     return std::move(qr.query_result);
                 }));
@@ -1400,6 +1481,9 @@ indexed_table_select_statement::find_index_clustering_rows(query_processor& qp,
 }
 
 class parallelized_select_statement : public select_statement {
+    // The most groups of a GROUP BY query which are aggregated by replicas.
+    // Queries with more groups are aggregated by the coordinator.
+    static constexpr uint64_t max_forwarded_groups = 10000;
 public:
     static ::shared_ptr<cql3::statements::select_statement> prepare(
         schema_ptr schema,
@@ -1504,6 +1588,12 @@ parallelized_select_statement::do_execute(
     service::query_state& state,
     const query_options& options
 ) const {
+    if (has_group_by() && options.get_paging_state()) {
+        // A later page of a grouped query which had too many groups to be
+        // forwarded, see below.
+        return select_statement::do_execute(qp, state, options);
+    }
+
     tracing::add_table_name(state.get_trace_state(), keyspace(), column_family());
 
     auto cl = options.get_consistency();
@@ -1511,16 +1601,6 @@ parallelized_select_statement::do_execute(
 
     auto now = gc_clock::now();
 
-    const source_selector src_sel = state.get_client_state().is_internal()
-            ? source_selector::INTERNAL : source_selector::USER;
-    ++_stats.query_cnt(src_sel, _ks_sel, cond_selector::NO_CONDITIONS, statement_type::SELECT);
-
-    _stats.select_bypass_caches += _parameters->bypass_cache();
-    _stats.select_allow_filtering += _parameters->allow_filtering();
-    _stats.select_partition_range_scan += _range_scan;
-    _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
-    _stats.select_parallelized += 1;
-
     auto slice = make_partition_slice(options);
     auto command = ::make_lw_shared<query::read_command>(
         _schema->id(),
@@ -1557,14 +1637,60 @@ parallelized_select_statement::do_execute(
         .timeout = timeout,
         .aggregation_infos = reductions.infos,
     };
+    if (has_group_by()) {
+        req.group_by_column_names.emplace();
+        for (auto idx : *_group_by_cell_indices) {
+            req.group_by_column_names->push_back(_selection->get_columns()[idx]->name_as_text());
+        }
+        // Forwarded groups are returned in a single page, so take no more
+        // than a page of them, and never more than max_forwarded_groups.
+        const auto page_size = options.get_page_size();
+        req.max_groups = page_size > 0 ? std::min<uint64_t>(page_size, max_forwarded_groups) : max_forwarded_groups;
+    }
 
     // dispatch execution of this statement to other nodes
-    return qp.forwarder().dispatch(req, state.get_trace_state()).then([this] (query::forward_result res) {
+    return qp.forwarder().dispatch(req, state.get_trace_state()).then([this, &qp, &state, &options,
+            group_by_names = req.group_by_column_names, max_groups = req.max_groups] (query::forward_result res) {
+        if (max_groups && res.grouped_query_results && res.grouped_query_results->size() > *max_groups) {
+            // Too many groups for a single page. Let the coordinator read
+            // and aggregate them, it pages the result.
+            return select_statement::do_execute(qp, state, options);
+        }
+
+        const source_selector src_sel = state.get_client_state().is_internal()
+                ? source_selector::INTERNAL : source_selector::USER;
+        ++_stats.query_cnt(src_sel, _ks_sel, cond_selector::NO_CONDITIONS, statement_type::SELECT);
+
+        _stats.select_bypass_caches += _parameters->bypass_cache();
+        _stats.select_allow_filtering += _parameters->allow_filtering();
+        _stats.select_partition_range_scan += _range_scan;
+        _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
+        _stats.select_parallelized += 1;
+
         auto meta = make_shared<metadata>(*_selection->get_result_metadata());
         auto rs = std::make_unique<result_set>(std::move(meta));
-        rs->add_row(res.query_results);
+        if (group_by_names) {
+            // Each group comes as its grouping columns followed by its
+            // aggregates; lay them out in the order of the selectors.
+            const auto plain_column_names = _selection->get_plain_column_names();
+            for (auto& group : *res.grouped_query_results) {
+                std::vector<bytes_opt> row;
+                row.reserve(plain_column_names.size());
+                auto next_aggregate = group.begin() + group_by_names->size();
+                for (auto& name : plain_column_names) {
+                    if (name) {
+                        row.push_back(group[std::ranges::find(*group_by_names, *name) - group_by_names->begin()]);
+                    } else {
+                        row.push_back(std::move(*next_aggregate++));
+                    }
+                }
+                rs->add_row(std::move(row));
+            }
+        } else {
+            rs->add_row(res.query_results);
+        }
         update_stats_rows_read(rs->size());
-        return shared_ptr<cql_transport::messages::result_message>(
+        return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(
             make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)))
         );
     });
@@ -1676,15 +1802,40 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
 
     // Used to determine if an execution of this statement can be parallelized
     // using `forward_service`.
+    // GROUP BY can be forwarded when the groups include the whole partition
+    // key, so that each group is aggregated on a single replica, and every
+    // selector either aggregates or selects a grouping column.
+    auto can_group_by_be_forwarded = [&] {
+        if (!db.features().parallelized_group_by_aggregation || !selection->is_reducible_with_grouping()
+                || _limit || _per_partition_limit || !_parameters->orderings().empty()
+                || group_by_cell_indices->size() < schema->partition_key_size()) {
+            return false;
+        }
+        const auto& columns = selection->get_columns();
+        std::vector<sstring> group_by_names;
+        for (size_t i = 0; i < group_by_cell_indices->size(); i++) {
+            auto def = columns[(*group_by_cell_indices)[i]];
+            if (i < schema->partition_key_size() && (!def->is_partition_key() || def->component_index() != i)) {
+                return false;
+            }
+            group_by_names.push_back(def->name_as_text());
+        }
+        return std::ranges::all_of(selection->get_plain_column_names(), [&] (const std::optional<sstring>& name) {
+            return !name || std::ranges::find(group_by_names, *name) != group_by_names.end();
+        });
+    };
+
     auto can_be_forwarded = [&] {
         return selection->is_aggregate()        // Aggregation only
             && ( // SUPPORTED PARALLELIZATION
                  // All potential intermediate coordinators must support forwarding
-                (db.features().parallelized_aggregation && selection->is_count())
-                || (db.features().uda_native_parallelized_aggregation && selection->is_reducible())
+                (group_by_cell_indices->empty() && (
+                    (db.features().parallelized_aggregation && selection->is_count())
+                    || (db.features().uda_native_parallelized_aggregation && selection->is_reducible())
+                ))
+                || (!group_by_cell_indices->empty() && can_group_by_be_forwarded())
             )
             && !restrictions->need_filtering()  // No filtering
-            && group_by_cell_indices->empty()   // No GROUP BY
             && db.get_config().enable_parallelized_aggregation();
     };
 
@@ -74,6 +74,12 @@ class select_statement : public cql_statement {
     ordering_comparator_type _ordering_comparator;
 
     query::partition_slice::option_set _opts;
+    // Parts of the partition slice which don't depend on bound values,
+    // computed once instead of on every execution.
+    query::column_id_vector _static_columns;
+    query::column_id_vector _regular_columns;
+    // Engaged if the clustering restrictions don't depend on bound values.
+    std::optional<std::vector<query::clustering_range>> _constant_clustering_bounds;
     cql_stats& _stats;
     const ks_selector _ks_sel;
     bool _range_scan = false;
@@ -131,6 +137,10 @@ protected :
 
     query::partition_slice make_partition_slice(const query_options& options) const;
 
+    // Returns the restrictions on regular columns which replicas can apply themselves,
+    // to avoid sending rows which would be filtered out.
+    std::optional<query::row_filter> make_row_filter(const query_options& options) const;
+
     const ::shared_ptr<const restrictions::statement_restrictions> get_restrictions() const;
 
     bool has_group_by() const { return _group_by_cell_indices && !_group_by_cell_indices->empty(); }
@@ -146,6 +156,7 @@ protected :
         return do_get_limit(options, _per_partition_limit, query::partition_max_rows);
     }
     bool needs_post_query_ordering() const;
+    std::vector<query::clustering_range> make_clustering_bounds(const query_options& options) const;
     virtual void update_stats_rows_read(int64_t rows_read) const {
         _stats.rows_read += rows_read;
     }
@@ -70,6 +70,7 @@ strongly_consistent_modification_statement::execute_without_checking_exception_m
 
     auto result = co_await service::broadcast_tables::execute(
         qp.get_group0_client(),
+        qp.proxy(),
         { evaluate_prepared(_query, options) }
     );
     
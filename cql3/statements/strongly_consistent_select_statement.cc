@@ -99,6 +99,7 @@ strongly_consistent_select_statement::execute_without_checking_exception_message
 
     auto result = co_await service::broadcast_tables::execute(
         qp.get_group0_client(),
+        qp.proxy(),
         { evaluate_prepared(_query, options) }
     );
     
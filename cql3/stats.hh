@@ -57,6 +57,9 @@ struct cql_stats {
     uint64_t cas_batches = 0;
     uint64_t statements_in_batches = 0;
     uint64_t statements_in_cas_batches = 0;
+    // Mutations sent by batches without conditions, after merging those of
+    // the same partition.
+    uint64_t mutations_in_batches = 0;
     uint64_t batches_pure_logged = 0;
     uint64_t batches_pure_unlogged = 0;
     uint64_t batches_unlogged_from_logged = 0;
@@ -17,7 +17,10 @@
 #include "types/user.hh"
 #include "types/listlike_partial_deserializing_iterator.hh"
 #include "utils/managed_bytes.hh"
+#include "utils/fragment_range.hh"
 #include "exceptions/exceptions.hh"
+#include <algorithm>
+#include <iterator>
 #include <limits>
 #include <utility>
 #include <boost/algorithm/string/trim_all.hpp>
@@ -27,55 +30,47 @@ static inline bool is_control_char(char c) {
     return c >= 0 && c <= 0x1F;
 }
 
-static inline bool needs_escaping(const sstring& s) {
-    return std::any_of(s.begin(), s.end(), [](char c) {return is_control_char(c) || c == '"' || c == '\\';});
-}
-
-
-static sstring quote_json_string(const sstring& value) {
-    if (!needs_escaping(value)) {
-        return format("\"{}\"", value);
-    }
-    std::ostringstream oss;
-    oss << std::hex << std::uppercase << std::setfill('0');
-    oss.put('"');
+static void write_json_string(std::string& out, std::string_view value) {
+    static constexpr char hex_digits[] = "0123456789ABCDEF";
+    out.reserve(out.size() + value.size() + 2);
+    out += '"';
     for (char c : value) {
         switch (c) {
         case '"':
-            oss.put('\\').put('"');
+            out += "\\\"";
             break;
         case '\\':
-            oss.put('\\').put('\\');
+            out += "\\\\";
             break;
         case '\b':
-            oss.put('\\').put('b');
+            out += "\\b";
             break;
         case '\f':
-            oss.put('\\').put('f');
+            out += "\\f";
             break;
         case '\n':
-            oss.put('\\').put('n');
+            out += "\\n";
             break;
         case '\r':
-            oss.put('\\').put('r');
+            out += "\\r";
             break;
         case '\t':
-            oss.put('\\').put('t');
+            out += "\\t";
             break;
         default:
             if (is_control_char(c)) {
-                oss.put('\\').put('u') << std::setw(4) << static_cast<int>(c);
+                out += "\\u00";
+                out += hex_digits[c >> 4];
+                out += hex_digits[c & 0xF];
             } else {
-                oss.put(c);
+                out += c;
             }
             break;
         }
     }
-    oss.put('"');
-    return oss.str();
+    out += '"';
 }
 
-
 template <typename T> static T to_int(const rjson::value& value) {
     int64_t result;
 
@@ -180,6 +175,7 @@ static bytes from_json_object_aux(const list_type_impl& t, const rjson::value& v
     if (!value.IsArray()) {
         throw marshal_exception("list_type must be represented as JSON Array");
     }
+    values.reserve(value.Size());
     for (const rjson::value& v : value.GetArray()) {
         values.emplace_back(from_json_object(*t.get_elements_type(), v, sf));
     }
@@ -208,12 +204,16 @@ static bytes from_json_object_aux(const user_type_impl& ut, const rjson::value&
         throw marshal_exception("user_type must be represented as JSON Object");
     }
 
-    std::unordered_set<std::string_view> remaining_names;
     for (auto vi = value.MemberBegin(); vi != value.MemberEnd(); ++vi) {
-        remaining_names.insert(rjson::to_string_view(vi->name));
+        auto name = rjson::to_string_view(vi->name);
+        if (std::ranges::none_of(ut.string_field_names(), [name] (const sstring& field) { return std::string_view(field) == name; })) {
+            throw marshal_exception(format(
+                    "Extraneous field definition for user type {}: {}", ut.get_name_as_string(), name));
+        }
     }
 
     std::vector<bytes_opt> raw_tuple;
+    raw_tuple.reserve(ut.field_names().size());
     for (unsigned i = 0; i < ut.field_names().size(); ++i) {
         auto t = ut.all_types()[i];
         const rjson::value* v = rjson::find(value, std::string_view(ut.field_name_as_string(i)));
@@ -222,12 +222,6 @@ static bytes from_json_object_aux(const user_type_impl& ut, const rjson::value&
         } else {
             raw_tuple.push_back(from_json_object(*t, *v, sf));
         }
-        remaining_names.erase(std::string_view(ut.field_name_as_string(i)));
-    }
-
-    if (!remaining_names.empty()) {
-        throw marshal_exception(format(
-                "Extraneous field definition for user type {}: {}", ut.get_name_as_string(), *remaining_names.begin()));
     }
     return ut.build_value(std::move(raw_tuple));
 }
@@ -342,189 +336,197 @@ template <typename T> static T compose_value(const integer_type_impl<T>& t, byte
     return read_be<T>(reinterpret_cast<const char*>(bv.data()));
 }
 
-static sstring to_json_string_aux(const map_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
+// The writer below appends the JSON representation of a value, including
+// the elements of collections, tuples and UDTs, to a single output string.
+
+static void write_json(std::string& out, const abstract_type& t, bytes_view bv);
+
+static void write_json(std::string& out, const abstract_type& t, managed_bytes_view mbv) {
+    with_linearized(mbv, [&] (bytes_view bv) {
+        write_json(out, t, bv);
+    });
+}
+
+static void write_json_aux(std::string& out, const map_type_impl& t, bytes_view bv) {
     auto sf = cql_serialization_format::internal();
 
-    out << '{';
+    out += '{';
+    // Keys are written to a scratch buffer first, to tell whether they
+    // still need quoting without inserting into the output.
+    std::string key;
     auto size = read_collection_size(bv, sf);
     for (int i = 0; i < size; ++i) {
         auto kb = read_collection_value(bv, sf);
         auto vb = read_collection_value(bv, sf);
 
         if (i > 0) {
-            out << ", ";
+            out += ", ";
         }
 
         // Valid keys in JSON map must be quoted strings
-        sstring string_key = to_json_string(*t.get_keys_type(), kb);
-        bool is_unquoted = string_key.empty() || string_key[0] != '"';
-        if (is_unquoted) {
-            out << '"';
-        }
-        out << string_key;
-        if (is_unquoted) {
-            out << '"';
-        }
-        out << ": ";
-        out << to_json_string(*t.get_values_type(), vb);
-    }
-    out << '}';
-    return out.str();
-}
-
-static sstring to_json_string_aux(const set_type_impl& t, bytes_view bv) {
-    using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
-    bool first = true;
-    auto sf = cql_serialization_format::internal();
-    out << '[';
-    managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv, sf), llpdi::end(mbv, sf), [&first, &out, &t] (const managed_bytes_view& e) {
-        if (first) {
-            first = false;
+        key.clear();
+        write_json(key, *t.get_keys_type(), kb);
+        if (key.starts_with('"')) {
+            out += key;
         } else {
-            out << ", ";
+            out += '"';
+            out += key;
+            out += '"';
         }
-        out << to_json_string(*t.get_elements_type(), e);
-    });
-    out << ']';
-    return out.str();
+        out += ": ";
+        write_json(out, *t.get_values_type(), vb);
+    }
+    out += '}';
 }
 
-static sstring to_json_string_aux(const list_type_impl& t, bytes_view bv) {
+static void write_json_listlike(std::string& out, const abstract_type& elements_type, bytes_view bv) {
     using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
     bool first = true;
     auto sf = cql_serialization_format::internal();
-    out << '[';
+    out += '[';
     managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv, sf), llpdi::end(mbv, sf), [&first, &out, &t] (const managed_bytes_view& e) {
+    std::for_each(llpdi::begin(mbv, sf), llpdi::end(mbv, sf), [&] (const managed_bytes_view& e) {
         if (first) {
             first = false;
         } else {
-            out << ", ";
+            out += ", ";
         }
-        out << to_json_string(*t.get_elements_type(), e);
+        write_json(out, elements_type, e);
     });
-    out << ']';
-    return out.str();
+    out += ']';
 }
 
-static sstring to_json_string_aux(const tuple_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '[';
+static void write_json_aux(std::string& out, const tuple_type_impl& t, bytes_view bv) {
+    out += '[';
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            out += ", ";
         }
         if (*vi) {
-            // TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(out, **ti, **vi);
         } else {
-            out << "null";
+            out += "null";
         }
         ++ti;
         ++vi;
     }
 
-    out << ']';
-    return out.str();
+    out += ']';
 }
 
-static sstring to_json_string_aux(const user_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '{';
+static void write_json_aux(std::string& out, const user_type_impl& t, bytes_view bv) {
+    out += '{';
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     int i = 0;
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            out += ", ";
         }
-        out << quote_json_string(t.field_name_as_string(i)) << ": ";
+        write_json_string(out, t.field_name_as_string(i));
+        out += ": ";
         if (*vi) {
-            //TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(out, **ti, **vi);
         } else {
-            out << "null";
+            out += "null";
         }
         ++ti;
         ++i;
         ++vi;
     }
 
-    out << '}';
-    return out.str();
+    out += '}';
 }
 
 namespace {
-struct to_json_string_visitor {
+struct json_writer_visitor {
+    std::string& out;
     bytes_view bv;
-    sstring operator()(const reversed_type_impl& t) { return to_json_string(*t.underlying_type(), bv); }
-    template <typename T> sstring operator()(const integer_type_impl<T>& t) { return to_sstring(compose_value(t, bv)); }
-    template <typename T> sstring operator()(const floating_type_impl<T>& t) {
+    void operator()(const reversed_type_impl& t) { write_json(out, *t.underlying_type(), bv); }
+    template <typename T> void operator()(const integer_type_impl<T>& t) {
+        fmt::format_to(std::back_inserter(out), "{}", compose_value(t, bv));
+    }
+    template <typename T> void operator()(const floating_type_impl<T>& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
         T d = value_cast<T>(v);
         if (std::isnan(d) || std::isinf(d)) {
-            return "null";
+            out += "null";
+            return;
         }
-        return to_sstring(d);
-    }
-    sstring operator()(const uuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const inet_addr_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const string_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const bytes_type_impl& t) { return quote_json_string("0x" + t.to_string(bv)); }
-    sstring operator()(const boolean_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const timestamp_date_base_class& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const timeuuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const map_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const set_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const list_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const tuple_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const user_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const simple_date_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const time_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const empty_type_impl& t) { return "null"; }
-    sstring operator()(const duration_type_impl& t) {
+        out += to_sstring(d);
+    }
+    void operator()(const uuid_type_impl& t) { write_json_string(out, t.to_string(bv)); }
+    void operator()(const inet_addr_type_impl& t) { write_json_string(out, t.to_string(bv)); }
+    void operator()(const string_type_impl& t) {
+        write_json_string(out, std::string_view(reinterpret_cast<const char*>(bv.data()), bv.size()));
+    }
+    void operator()(const bytes_type_impl& t) { write_json_string(out, "0x" + t.to_string(bv)); }
+    void operator()(const boolean_type_impl& t) { out += t.to_string(bv); }
+    void operator()(const timestamp_date_base_class& t) { write_json_string(out, t.to_string(bv)); }
+    void operator()(const timeuuid_type_impl& t) { write_json_string(out, t.to_string(bv)); }
+    void operator()(const map_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const set_type_impl& t) { write_json_listlike(out, *t.get_elements_type(), bv); }
+    void operator()(const list_type_impl& t) { write_json_listlike(out, *t.get_elements_type(), bv); }
+    void operator()(const tuple_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const user_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const simple_date_type_impl& t) { write_json_string(out, t.to_string(bv)); }
+    void operator()(const time_type_impl& t) { out += t.to_string(bv); }
+    void operator()(const empty_type_impl& t) { out += "null"; }
+    void operator()(const duration_type_impl& t) {
         auto v = t.deserialize(bv);
         if (v.is_null()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
-        return quote_json_string(t.to_string(bv));
+        write_json_string(out, t.to_string(bv));
     }
-    sstring operator()(const counter_type_impl& t) {
+    void operator()(const counter_type_impl& t) {
         // It will be called only from cql3 layer while processing query results.
-        return to_json_string(*counter_cell_view::total_value_type(), bv);
+        write_json(out, *counter_cell_view::total_value_type(), bv);
     }
-    sstring operator()(const decimal_type_impl& t) {
+    void operator()(const decimal_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<big_decimal>(v).to_string();
+        out += value_cast<big_decimal>(v).to_string();
     }
-    sstring operator()(const varint_type_impl& t) {
+    void operator()(const varint_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<utils::multiprecision_int>(v).str();
+        out += value_cast<utils::multiprecision_int>(v).str();
     }
 };
 }
 
+static void write_json(std::string& out, const abstract_type& t, bytes_view bv) {
+    visit(t, json_writer_visitor{out, bv});
+}
+
+void write_json(std::string& out, const abstract_type& t, const bytes_opt& b) {
+    if (b) {
+        write_json(out, t, bytes_view(*b));
+    } else {
+        out += "null";
+    }
+}
+
 sstring to_json_string(const abstract_type& t, bytes_view bv) {
-    return visit(t, to_json_string_visitor{bv});
+    std::string out;
+    write_json(out, t, bv);
+    return sstring(out);
 }
 
 sstring to_json_string(const abstract_type& t, const managed_bytes_view& mbv) {
-    return visit(t, to_json_string_visitor{linearized(mbv)});
+    std::string out;
+    write_json(out, t, mbv);
+    return sstring(out);
 }
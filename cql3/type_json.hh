@@ -15,6 +15,9 @@ bytes from_json_object(const abstract_type &t, const rjson::value& value, cql_se
 sstring to_json_string(const abstract_type &t, bytes_view bv);
 sstring to_json_string(const abstract_type &t, const managed_bytes_view& bv);
 
+// Appends the JSON representation of a value of type t (or null) to out.
+void write_json(std::string& out, const abstract_type& t, const bytes_opt& b);
+
 inline sstring to_json_string(const abstract_type &t, const bytes& b) {
     return to_json_string(t, bytes_view(b));
 }
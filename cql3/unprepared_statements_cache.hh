@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "cql3/statements/prepared_statement.hh"
+
+namespace cql3 {
+
+/// \brief Statements executed without being prepared, so that repeating an
+/// unprepared query doesn't parse and prepare it again.
+///
+/// Statements are looked up by the session's keyspace and the query text,
+/// which together determine the prepared statement. The cache holds at most
+/// max_entries statements, dropping the least recently used ones first, and
+/// doesn't keep statements of queries longer than max_query_size, which are
+/// unlikely to repeat. It is shard-local.
+class unprepared_statements_cache {
+public:
+    static constexpr size_t max_entries = 1000;
+    static constexpr size_t max_query_size = 4096;
+
+    using value_type = std::unique_ptr<statements::prepared_statement>;
+private:
+    struct key_type {
+        sstring keyspace;
+        sstring query;
+        bool operator==(const key_type&) const = default;
+    };
+    struct key_hash {
+        size_t operator()(const key_type& k) const noexcept {
+            return std::hash<sstring>()(k.query) ^ std::hash<sstring>()(k.keyspace);
+        }
+    };
+    struct entry {
+        key_type key;
+        value_type statement;
+    };
+    // Most recently used first.
+    std::list<entry> _lru;
+    std::unordered_map<key_type, std::list<entry>::iterator, key_hash> _index;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+public:
+    static bool cacheable(std::string_view query) noexcept {
+        return query.size() <= max_query_size;
+    }
+
+    /// Returns the statement of the query, or nullptr.
+    statements::prepared_statement* find(std::string_view keyspace, std::string_view query) {
+        if (!cacheable(query)) {
+            return nullptr;
+        }
+        auto it = _index.find(key_type{sstring(keyspace), sstring(query)});
+        if (it == _index.end()) {
+            ++_misses;
+            return nullptr;
+        }
+        ++_hits;
+        _lru.splice(_lru.begin(), _lru, it->second);
+        return it->second->statement.get();
+    }
+
+    /// Keeps the statement of a cacheable query. Returns the kept statement.
+    statements::prepared_statement* insert(std::string_view keyspace, std::string_view query, value_type statement) {
+        auto key = key_type{sstring(keyspace), sstring(query)};
+        if (auto it = _index.find(key); it != _index.end()) {
+            _lru.erase(it->second);
+            _index.erase(it);
+        }
+        if (_lru.size() >= max_entries) {
+            _index.erase(_lru.back().key);
+            _lru.pop_back();
+        }
+        _lru.push_front(entry{key, std::move(statement)});
+        _index.emplace(std::move(key), _lru.begin());
+        return _lru.front().statement.get();
+    }
+
+    void clear() noexcept {
+        _index.clear();
+        _lru.clear();
+    }
+
+    size_t size() const noexcept { return _lru.size(); }
+    uint64_t hits() const noexcept { return _hits; }
+    uint64_t misses() const noexcept { return _misses; }
+};
+
+}
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "utils/lru.hh"
+#include "utils/frequency_sketch.hh"
 #include "utils/logalloc.hh"
 #include "partition_version.hh"
 #include "mutation_cleaner.hh"
@@ -57,6 +58,7 @@ class cache_tracker final {
         uint64_t partitions;
         uint64_t rows;
         uint64_t mispopulations;
+        uint64_t admission_rejections;
         uint64_t underlying_recreations;
         uint64_t underlying_partition_skips;
         uint64_t underlying_row_skips;
@@ -79,8 +81,17 @@ class cache_tracker final {
     mutation_cleaner _garbage;
     mutation_cleaner _memtable_cleaner;
     mutation_application_stats& _app_stats;
+    // TinyLFU-style admission for tables which admit only frequently read
+    // partitions into the cache: approximate frequencies of recent reads of
+    // such partitions, allocated on first use. Shared by all tables, like the
+    // LRU the victims come from.
+    std::unique_ptr<utils::frequency_sketch> _admission_sketch;
+    static constexpr size_t admission_sketch_width = 16384;
+    // Frequency of the partition evicted last, which stands for the next victim.
+    unsigned _victim_frequency = 0;
 private:
     void setup_metrics();
+    static uint64_t admission_hash(const schema&, const dht::decorated_key&) noexcept;
 public:
     using register_metrics = bool_class<class register_metrics_tag>;
     cache_tracker(mutation_application_stats&, register_metrics);
@@ -98,13 +109,19 @@ class cache_tracker final {
     void on_partition_merge() noexcept;
     void on_partition_hit() noexcept;
     void on_partition_miss() noexcept;
-    void on_partition_eviction() noexcept;
+    void on_partition_eviction(const cache_entry&) noexcept;
     void on_row_eviction() noexcept;
     void on_row_hit() noexcept;
     void on_dummy_row_hit() noexcept;
     void on_row_miss() noexcept;
     void on_miss_already_populated() noexcept;
     void on_mispopulate() noexcept;
+    // Records a read of a partition present in the cache, of a table with frequent-only admission.
+    void record_access(const schema&, const dht::decorated_key&);
+    // Records a read of a partition missing from the cache, of a table with frequent-only admission,
+    // and tells whether the partition should be populated into the cache. It should be if it was read
+    // more often than the partition which would be evicted to make room for it.
+    bool should_admit(const schema&, const dht::decorated_key&);
     void on_row_processed_from_memtable() noexcept { ++_stats.rows_processed_from_memtable; }
     void on_row_dropped_from_memtable() noexcept { ++_stats.rows_dropped_from_memtable; }
     void on_row_merged_from_memtable() noexcept { ++_stats.rows_merged_from_memtable; }
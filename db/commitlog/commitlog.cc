@@ -15,6 +15,7 @@
 #include <filesystem>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <lz4.h>
 #include <unordered_map>
 #include <unordered_set>
 #include <exception>
@@ -33,8 +34,10 @@
 #include <seastar/core/chunked_fifo.hh>
 #include <seastar/core/queue.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/core/byteorder.hh>
 #include <seastar/net/byteorder.hh>
 #include <seastar/util/defer.hh>
 
@@ -100,13 +103,22 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     config c;
 
     c.commit_log_location = cfg.commitlog_directory();
+    c.extra_commit_log_locations = cfg.commitlog_extra_directories();
     c.metrics_category_name = "commitlog";
     c.commitlog_total_space_in_mb = cfg.commitlog_total_space_in_mb() >= 0 ? cfg.commitlog_total_space_in_mb() : (shard_available_memory * smp::count) >> 20;
     c.commitlog_segment_size_in_mb = cfg.commitlog_segment_size_in_mb();
     c.commitlog_sync_period_in_ms = cfg.commitlog_sync_period_in_ms();
-    c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH : sync_mode::PERIODIC;
+    if (cfg.commitlog_sync() == "batch") {
+        c.mode = sync_mode::BATCH;
+    } else if (cfg.commitlog_sync() == "group") {
+        c.mode = sync_mode::GROUP;
+    } else {
+        c.mode = sync_mode::PERIODIC;
+    }
+    c.commitlog_sync_group_max_delay_in_us = cfg.commitlog_sync_group_max_delay_in_us();
     c.extensions = &cfg.extensions();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
+    c.use_compression = cfg.commitlog_compression();
     c.allow_going_over_size_limit = !cfg.commitlog_use_hard_size_limit();
 
     if (cfg.commitlog_flush_threshold_in_mb() >= 0) {
@@ -379,6 +391,12 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t requests_blocked_memory = 0;
         uint64_t blocked_on_new_segment = 0;
         uint64_t active_allocations = 0;
+        uint64_t group_commit_syncs = 0;
+        uint64_t group_commit_writes = 0;
+        uint64_t group_commit_wait_us = 0;
+        // chunk bytes before and after compression, for compressed segments
+        uint64_t compression_input_bytes = 0;
+        uint64_t compression_output_bytes = 0;
     };
 
     class scope_increment_counter {
@@ -398,6 +416,48 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     byte_flow<uint64_t> last_bytes;
     byte_flow<double> bytes_rate;
 
+    // Group commit window controller, see group_commit_delay().
+    using group_clock_type = std::chrono::steady_clock;
+    group_clock_type::time_point last_group_write;
+    double group_write_interval_us = std::numeric_limits<double>::max();
+    double group_sync_latency_us = 0;
+
+    // Writes which could be sharing a flush consistently arrive less than one flush
+    // latency apart. With fewer writes, waiting delays them without saving flushes,
+    // so only wait when the next write is expected before the flush would complete,
+    // and never longer than the flush itself takes, or than configured.
+    std::chrono::microseconds group_commit_delay() const {
+        if (group_write_interval_us >= group_sync_latency_us) {
+            return std::chrono::microseconds(0);
+        }
+        auto delay = std::min<double>(group_sync_latency_us, cfg.commitlog_sync_group_max_delay_in_us);
+        return std::chrono::microseconds(uint64_t(delay));
+    }
+
+    void on_group_write(group_clock_type::time_point now) {
+        // Exponentially weighted averages, so the window follows load changes within tens of writes.
+        static constexpr double alpha = 0.1;
+        if (last_group_write != group_clock_type::time_point()) {
+            auto interval = std::chrono::duration<double, std::micro>(now - last_group_write).count();
+            group_write_interval_us = group_write_interval_us == std::numeric_limits<double>::max()
+                    ? interval : (1 - alpha) * group_write_interval_us + alpha * interval;
+        }
+        last_group_write = now;
+        ++totals.group_commit_writes;
+    }
+
+    void on_group_sync_latency(group_clock_type::duration latency) {
+        static constexpr double alpha = 0.1;
+        auto l = std::chrono::duration<double, std::micro>(latency).count();
+        group_sync_latency_us = group_sync_latency_us == 0 ? l : (1 - alpha) * group_sync_latency_us + alpha * l;
+        ++totals.group_commit_syncs;
+    }
+
+    // True when writes are acknowledged only after their data is flushed.
+    bool syncs_each_write() const noexcept {
+        return cfg.mode != sync_mode::PERIODIC;
+    }
+
     typename std::chrono::high_resolution_clock::time_point last_time;
 
     size_t pending_allocations() const {
@@ -441,7 +501,18 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     future<sseg_ptr> allocate_segment_ex(descriptor, named_file, open_flags);
 
     sstring filename(const descriptor& d) const {
-        return cfg.commit_log_location + "/" + d.filename();
+        return filename(cfg.commit_log_location, d);
+    }
+    static sstring filename(const sstring& dir, const descriptor& d) {
+        return dir + "/" + d.filename();
+    }
+    // The directory of a segment file
+    static sstring dirname(const sstring& filename) {
+        return std::filesystem::path(filename).parent_path().native();
+    }
+    const sstring& pick_location() const;
+    const std::vector<sstring>& locations() const noexcept {
+        return _locations;
     }
 
     future<> clear();
@@ -499,6 +570,9 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     void abort_recycled_list(std::exception_ptr);
 
     size_t max_request_controller_units() const;
+    // commit_log_location, followed by extra_commit_log_locations
+    std::vector<sstring> _locations;
+    mutable size_t _next_location = 0;
     segment_id_type _ids = 0, _low_id = 0;
     std::vector<sseg_ptr> _segments;
     queue<sseg_ptr> _reserve_segments;
@@ -674,7 +748,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     named_file _file;
 
     uint64_t _file_pos = 0;
+    // Where the next chunk is written in the file. Same as _file_pos, the
+    // logical (replay) position, unless chunks were compressed.
+    uint64_t _disk_pos = 0;
     uint64_t _flush_pos = 0;
+    // The physical position up to which the file is flushed, i.e. what
+    // _disk_pos was when _file_pos was _flush_pos.
+    uint64_t _disk_flush_pos = 0;
     uint64_t _waste = 0;
 
     size_t _alignment;
@@ -692,6 +772,8 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     std::unordered_map<cf_id_type, uint64_t> _cf_dirty;
     time_point _sync_time;
     utils::flush_queue<replay_position, std::less<replay_position>, clock_type> _pending_ops;
+    // In GROUP mode, the flush shared by writes waiting for the current window to close.
+    std::optional<shared_future<>> _group_sync;
 
     uint64_t _num_allocs = 0;
 
@@ -731,6 +813,11 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     static constexpr size_t descriptor_header_size = 5 * sizeof(uint32_t);
     static constexpr uint32_t segment_magic = ('S'<<24) |('C'<< 16) | ('L' << 8) | 'C';
     static constexpr uint32_t multi_entry_size_magic = 0xffffffff;
+    // Set in the "next" field of the header of compressed chunks (segment_version_3).
+    // The header is then followed by the compressed size and the position in the
+    // file of the next chunk, and the compressed entries.
+    static constexpr uint32_t compressed_chunk_flag = 0x80000000;
+    static constexpr size_t compressed_chunk_overhead_size = 2 * sizeof(uint32_t);
 
     // The commit log (chained) sync marker/header size in bytes (int: length + int: checksum [segmentId, position])
     static constexpr size_t sync_marker_size = 2 * sizeof(uint32_t);
@@ -789,7 +876,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     bool must_sync() {
-        if (_segment_manager->cfg.mode == sync_mode::BATCH) {
+        if (_segment_manager->syncs_each_write()) {
             return false;
         }
         auto now = clock_type::now();
@@ -833,7 +920,11 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         }
     
         co_await _pending_ops.close();
-        co_await _file.truncate(_flush_pos);
+        auto size = _file.known_size();
+        co_await _file.truncate(_disk_flush_pos);
+        if (size > _disk_flush_pos) {
+            _segment_manager->totals.total_size_on_disk -= size - _disk_flush_pos;
+        }
         co_await _file.close();
 
         if (p) {
@@ -854,6 +945,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         auto me = shared_from_this();
         assert(me.use_count() > 1);
         uint64_t pos = _file_pos;
+        uint64_t disk_pos = _disk_pos;
 
         clogger.trace("Syncing {} {} -> {}", *this, _flush_pos, pos);
 
@@ -864,7 +956,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         // Run like this to ensure flush ordering, and making flushes "waitable"
         co_await _pending_ops.run_with_ordered_post_op(rp, [] {}, [&] {
             assert(_pending_ops.has_operation(rp));
-            return do_flush(pos);
+            return do_flush(pos, disk_pos);
         });
         co_return me;
     }
@@ -894,7 +986,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         _segment_manager->totals.wasted_size_on_disk += _waste;
         co_return s;
     }
-    future<sseg_ptr> do_flush(uint64_t pos) {
+    future<sseg_ptr> do_flush(uint64_t pos, uint64_t disk_pos) {
         auto me = shared_from_this();
         co_await begin_flush();
 
@@ -912,6 +1004,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             // TODO: retry/ignore/fail/stop - optional behaviour in origin.
             // we fast-fail the whole commit.
             _flush_pos = std::max(pos, _flush_pos);
+            _disk_flush_pos = std::max(disk_pos, _disk_flush_pos);
             ++_segment_manager->totals.flush_count;
             clogger.trace("{} synced to {}", *this, _flush_pos);
         } catch (...) {
@@ -966,8 +1059,18 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         auto off = _file_pos;
         auto top = off + size;
         auto num = _num_allocs;
+        auto chunk_header_size = (off == 0 ? descriptor_header_size : 0) + segment_overhead_size;
+
+        std::optional<compressed_chunk> compressed;
+        if (!termination && _desc.ver >= descriptor::segment_version_3) {
+            compressed = compress_chunk(buf, chunk_header_size, size);
+        }
+        auto disk_off = _disk_pos;
+        auto disk_size = compressed ? compressed->buf.size() : size;
 
         _file_pos = top;
+        _disk_pos += disk_size;
+        auto disk_top = _disk_pos;
         _buffer_ostream = { };
         _num_allocs = 0;
 
@@ -996,8 +1099,12 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             crc.process<int32_t>(_desc.id & 0xffffffff);
             crc.process<int32_t>(_desc.id >> 32);
             crc.process(uint32_t(off + header_size));
+            if (compressed) {
+                crc.process(compressed->compressed_size);
+                crc.process(uint32_t(_disk_pos));
+            }
 
-            write(out, uint32_t(_file_pos));
+            write(out, uint32_t(_file_pos) | (compressed ? compressed_chunk_flag : 0));
             write(out, crc.checksum());
 
             forget_schema_versions();
@@ -1010,14 +1117,33 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             write(out, uint64_t(0));
         }
 
+        buffer_type cbuf;
+        if (compressed) {
+            // The headers go uncompressed, followed by the compressed chunk trailer.
+            auto p = compressed->buf.get_write();
+            auto headers = *fragmented_temporary_buffer::view(buf).begin();
+            assert(headers.size() >= chunk_header_size);
+            p = std::copy_n(headers.data(), chunk_header_size, p);
+            write_be<uint32_t>(p, compressed->compressed_size);
+            write_be<uint32_t>(p + sizeof(uint32_t), uint32_t(_disk_pos));
+            std::vector<temporary_buffer<char>> fragments;
+            fragments.emplace_back(std::move(compressed->buf));
+            cbuf = buffer_type(std::move(fragments), disk_size);
+        }
+        if (_desc.ver >= descriptor::segment_version_3 && !termination) {
+            _segment_manager->totals.compression_input_bytes += size;
+            _segment_manager->totals.compression_output_bytes += disk_size;
+        }
+
         replay_position rp(_desc.id, position_type(off));
 
         // The write will be allowed to start now, but flush (below) must wait for not only this,
         // but all previous write/flush pairs.
         co_await _pending_ops.run_with_ordered_post_op(rp, [&]() -> future<> {
-            auto view = fragmented_temporary_buffer::view(buf);
-            view.remove_suffix(buf.size_bytes() - size);
-            assert(size == view.size_bytes());
+            auto& data = compressed ? cbuf : buf;
+            auto view = fragmented_temporary_buffer::view(data);
+            view.remove_suffix(data.size_bytes() - disk_size);
+            assert(disk_size == view.size_bytes());
 
             if (view.empty()) {
                 co_return;
@@ -1028,28 +1154,33 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             auto finally = defer([&] () noexcept {
                 _segment_manager->notify_memory_written(size);
                 _segment_manager->totals.buffer_list_bytes -= buf.size_bytes();
-                if (_file.known_size() < _file_pos) {
-                    _segment_manager->totals.total_size_on_disk += (_file_pos - _file.known_size());
-                }
             });
 
+            // Account for the growth of the file before writing, as the write
+            // itself updates the known size. Only this chunk counts: _disk_pos
+            // may already include chunks that are not written yet.
+            if (_file.known_size() < disk_top) {
+                _segment_manager->totals.total_size_on_disk += (disk_top - _file.known_size());
+                _file.maybe_update_size(disk_top);
+            }
+
             for (;;) {
                 auto current = *view.begin();
                 try {
-                    auto bytes = co_await _file.dma_write(off, current.data(), current.size(), priority_class);
+                    auto bytes = co_await _file.dma_write(disk_off, current.data(), current.size(), priority_class);
                     _segment_manager->totals.bytes_written += bytes;
                     _segment_manager->totals.active_size_on_disk += bytes;
                     ++_segment_manager->totals.cycle_count;
                     if (bytes == view.size_bytes()) {
-                        clogger.trace("Final write of {} to {}: {}/{} bytes at {}", bytes, *this, size, size, off);
+                        clogger.trace("Final write of {} to {}: {}/{} bytes at {}", bytes, *this, disk_size, disk_size, disk_off);
                         break;
                     }
                     // gah, partial write. should always get here with dma chunk sized
                     // "bytes", but lets make sure...
                     bytes = align_down(bytes, _alignment);
-                    off += bytes;
+                    disk_off += bytes;
                     view.remove_prefix(bytes);
-                    clogger.trace("Partial write of {} to {}: {}/{} bytes at at {}", bytes, *this, size - view.size_bytes(), size, off - bytes);
+                    clogger.trace("Partial write of {} to {}: {}/{} bytes at at {}", bytes, *this, disk_size - view.size_bytes(), disk_size, disk_off - bytes);
                     continue;
                     // TODO: retry/ignore/fail/stop - optional behaviour in origin.
                     // we fast-fail the whole commit.
@@ -1061,13 +1192,53 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         }, [&]() -> future<> {
             assert(_pending_ops.has_operation(rp));
             if (flush_after) {
-                co_await do_flush(top);
+                co_await do_flush(top, disk_top);
             }
         });
         co_return me;
     }
 
-    future<sseg_ptr> batch_cycle(timeout_clock::time_point timeout) {
+    future<> group_sync() {
+        auto me = shared_from_this();
+        // Writes arriving from now on belong to the next group.
+        _group_sync.reset();
+        auto start = segment_manager::group_clock_type::now();
+        try {
+            co_await sync();
+        } catch (...) {
+            _closed = true; // see batch_cycle()
+            throw;
+        }
+        _segment_manager->on_group_sync_latency(segment_manager::group_clock_type::now() - start);
+    }
+
+    future<sseg_ptr> group_cycle(timeout_clock::time_point timeout) {
+        /**
+         * For group mode the first write after a flush opens a window,
+         * and all writes added to the buffer until it closes share
+         * the flush issued at its end.
+         */
+        auto me = shared_from_this();
+        auto start = segment_manager::group_clock_type::now();
+        _segment_manager->on_group_write(start);
+        if (!_group_sync) {
+            auto delay = _segment_manager->group_commit_delay();
+            if (delay.count() == 0) {
+                co_await batch_cycle(timeout, false);
+                _segment_manager->on_group_sync_latency(segment_manager::group_clock_type::now() - start);
+                co_return me;
+            }
+            _group_sync.emplace(seastar::sleep(delay).then([this, me] {
+                return group_sync();
+            }));
+        }
+        co_await _group_sync->get_future(timeout);
+        _segment_manager->totals.group_commit_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                segment_manager::group_clock_type::now() - start).count();
+        co_return me;
+    }
+
+    future<sseg_ptr> batch_cycle(timeout_clock::time_point timeout, bool allow_grouping = true) {
         /**
          * For batch mode we force a write "immediately".
          * However, we first wait for all previous writes/flushes
@@ -1076,8 +1247,12 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
          * This has the benefit of allowing several allocations to
          * queue up in a single buffer.
          */
+        if (allow_grouping && _segment_manager->cfg.mode == sync_mode::GROUP) {
+            co_return co_await group_cycle(timeout);
+        }
         auto me = shared_from_this();
         auto fp = _file_pos;
+        auto dp = _disk_pos;
         try {
             co_await _pending_ops.wait_for_pending(timeout);
             if (fp != _file_pos) {
@@ -1089,11 +1264,11 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                 replay_position rp(_desc.id, position_type(fp));
                 co_await _pending_ops.wait_for_pending(rp, timeout);
                 
-                assert(_segment_manager->cfg.mode != sync_mode::BATCH || _flush_pos > fp);
+                assert(!_segment_manager->syncs_each_write() || _flush_pos > fp);
                 if (_flush_pos <= fp) {
                     // previous op we were waiting for was not sync one, so it did not flush
                     // force flush here
-                    co_await do_flush(fp);
+                    co_await do_flush(fp, dp);
                 }
             } else {
                 // It is ok to leave the sync behind on timeout because there will be at most one
@@ -1143,7 +1318,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         if (!is_still_allocating() || position() + s > _segment_manager->max_size) { // would we make the file too big?
             return write_result::no_space;
         } else if (!_buffer.empty() && (s > _buffer_ostream.size())) {  // enough data?
-            if (_segment_manager->cfg.mode == sync_mode::BATCH || writer.sync) {
+            if (_segment_manager->syncs_each_write() || writer.sync) {
                 // TODO: this could cause starvation if we're really unlucky.
                 // If we run batch mode and find ourselves not fit in a non-empty
                 // buffer, we must force a cycle and wait for it (to keep flush order)
@@ -1229,7 +1404,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         ++_segment_manager->totals.allocation_count;
         ++_num_allocs;
 
-        if (_segment_manager->cfg.mode == sync_mode::BATCH || writer.sync) {
+        if (_segment_manager->syncs_each_write() || writer.sync) {
             return write_result::ok_need_batch_sync;
         } else {
             // If this buffer alone is too big, potentially bigger than the maximum allowed size,
@@ -1247,7 +1422,43 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     size_t file_position() const {
-        return _file_pos;
+        return _disk_pos;
+    }
+
+    struct compressed_chunk {
+        temporary_buffer<char> buf;
+        uint32_t compressed_size;
+    };
+
+    // Compresses the entries of a chunk, i.e. all of the first size bytes of buf
+    // but the leading hdr bytes of headers. The returned buffer has room for
+    // the headers and the compressed chunk trailer, which the caller fills in.
+    // Returns nothing unless compression saves at least a disk block.
+    std::optional<compressed_chunk> compress_chunk(const buffer_type& buf, size_t hdr, size_t size) const {
+        auto view = fragmented_temporary_buffer::view(buf);
+        view.remove_prefix(hdr);
+        view.remove_suffix(buf.size_bytes() - size);
+
+        temporary_buffer<char> input(view.size_bytes());
+        auto p = input.get_write();
+        for (auto frag : view) {
+            p = std::copy(frag.begin(), frag.end(), p);
+        }
+
+        auto data_off = hdr + compressed_chunk_overhead_size;
+        auto bound = LZ4_compressBound(input.size());
+        auto output = temporary_buffer<char>::aligned(_alignment, align_up(data_off + bound, _alignment));
+        auto len = LZ4_compress_default(input.get(), output.get_write() + data_off, input.size(), bound);
+        if (len <= 0) {
+            return std::nullopt;
+        }
+        auto disk_size = align_up(data_off + len, _alignment);
+        if (disk_size >= size) {
+            return std::nullopt;
+        }
+        std::fill(output.get_write() + data_off + len, output.get_write() + disk_size, 0);
+        output.trim(disk_size);
+        return compressed_chunk{std::move(output), uint32_t(len)};
     }
 
     // ensures no more of this segment is writeable, by allocating any unused section at the end and marking it discarded
@@ -1298,6 +1509,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     sstring get_segment_name() const {
         return _desc.filename();
     }
+    const sstring& get_file_name() const {
+        return _file.name();
+    }
+    // Bytes allocated in the segment, but not yet flushed to disk
+    uint64_t unflushed_bytes() const noexcept {
+        return position() - std::min<uint64_t>(position(), _flush_pos);
+    }
 };
 
 template<typename T, typename R>
@@ -1394,6 +1612,18 @@ db::commitlog::segment_manager::segment_manager(config c)
     assert(max_size > 0);
     assert(max_mutation_size < segment::multi_entry_size_magic);
 
+    _locations.push_back(cfg.commit_log_location);
+    for (auto& dir : cfg.extra_commit_log_locations) {
+        if (std::find(_locations.begin(), _locations.end(), dir) == _locations.end()) {
+            _locations.push_back(dir);
+        }
+    }
+
+    if (cfg.use_compression && max_size >= segment::compressed_chunk_flag) {
+        clogger.warn("Commitlog segment size {} MB is too large for compression. Disabling commitlog compression.", max_size / (1024 * 1024));
+        cfg.use_compression = false;
+    }
+
     clogger.trace("Commitlog {} maximum disk size: {} MB / cpu ({} cpus)",
             cfg.commit_log_location, max_disk_size / (1024 * 1024),
             smp::count);
@@ -1476,23 +1706,26 @@ db::commitlog::segment_manager::list_descriptors(sstring dirname) const {
 // or does shard 0 init first (main/database), then replays on 0 as well.
 future<std::vector<sstring>> db::commitlog::segment_manager::get_segments_to_replay() const {
     std::vector<sstring> segments_to_replay;
-    auto descs = co_await list_descriptors(cfg.commit_log_location);
-    for (auto& d : descs) {
-        auto id = replay_position(d.id).base_id();
-        if (id <= _low_id) {
-            segments_to_replay.push_back(cfg.commit_log_location + "/" + d.filename());
+    for (auto& dir : _locations) {
+        auto descs = co_await list_descriptors(dir);
+        for (auto& d : descs) {
+            auto id = replay_position(d.id).base_id();
+            if (id <= _low_id) {
+                segments_to_replay.push_back(filename(dir, d));
+            }
         }
     }
     co_return segments_to_replay;
 }
 
 future<> db::commitlog::segment_manager::init() {
-    auto descs = co_await list_descriptors(cfg.commit_log_location);
-
     assert(_reserve_segments.empty()); // _segments_to_replay must not pick them up
     segment_id_type id = *cfg.base_segment_id;
-    for (auto& d : descs) {
-        id = std::max(id, replay_position(d.id).base_id());
+    for (auto& dir : _locations) {
+        auto descs = co_await list_descriptors(dir);
+        for (auto& d : descs) {
+            id = std::max(id, replay_position(d.id).base_id());
+        }
     }
 
     // base id counter is [ <shard> | <base> ]
@@ -1538,6 +1771,18 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
                        sm::description("Counts number of bytes written to the disk. "
                                        "Divide this value by \"alloc\" to get the average number of bytes per mutation written to the disk.")),
 
+        sm::make_counter("compression_input_bytes", totals.compression_input_bytes,
+                       sm::description("Counts number of bytes of chunks of compressed segments before compression.")),
+
+        sm::make_counter("compression_output_bytes", totals.compression_output_bytes,
+                       sm::description("Counts number of bytes of chunks of compressed segments written to the disk. "
+                                       "Divide compression_input_bytes by this value to get the compression ratio.")),
+
+        sm::make_gauge("compression_ratio", [this] {
+                           return totals.compression_output_bytes ? double(totals.compression_input_bytes) / totals.compression_output_bytes : 1.0;
+                       },
+                       sm::description("Holds the ratio of chunk bytes before and after compression, for compressed segments.")),
+
         sm::make_counter("bytes_released", totals.bytes_released,
                        sm::description("Counts number of bytes released from disk. (Deleted/recycled)")),
 
@@ -1584,6 +1829,20 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
 
         sm::make_gauge("active_allocations", totals.active_allocations,
                        sm::description("Current number of active allocations.")),
+
+        sm::make_counter("group_commit_syncs", totals.group_commit_syncs,
+                       sm::description("Counts number of flushes issued on behalf of a group of writes in \"group\" sync mode. "
+                                       "Divide group_commit_writes by this value to get the average group size.")),
+
+        sm::make_counter("group_commit_writes", totals.group_commit_writes,
+                       sm::description("Counts number of writes which waited for a group flush in \"group\" sync mode.")),
+
+        sm::make_counter("group_commit_wait_us", totals.group_commit_wait_us,
+                       sm::description("Counts total time in microseconds writes spent waiting for a shared flush in \"group\" sync mode. "
+                                       "Divide by group_commit_writes to get the average wait time.")),
+
+        sm::make_gauge("group_commit_window_us", [this] { return group_commit_delay().count(); },
+                       sm::description("Holds the current length of the window in microseconds during which writes are gathered before a flush in \"group\" sync mode.")),
     });
 }
 
@@ -1771,10 +2030,34 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
     co_return make_shared<segment>(shared_from_this(), std::move(d), std::move(f), align);
 }
 
+const sstring& db::commitlog::segment_manager::pick_location() const {
+    if (_locations.size() == 1) {
+        return _locations.front();
+    }
+    std::vector<uint64_t> unflushed(_locations.size());
+    for (auto& s : _segments) {
+        auto i = std::find(_locations.begin(), _locations.end(), dirname(s->get_file_name()));
+        if (i != _locations.end()) {
+            unflushed[i - _locations.begin()] += s->unflushed_bytes();
+        }
+    }
+    // Start from the next directory in turn, so that idle directories
+    // are all used.
+    auto start = _next_location++ % _locations.size();
+    auto best = start;
+    for (size_t n = 1; n < _locations.size(); ++n) {
+        auto i = (start + n) % _locations.size();
+        if (unflushed[i] < unflushed[best]) {
+            best = i;
+        }
+    }
+    return _locations[best];
+}
+
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment() {
     for (;;) {
-        descriptor d(next_id(), cfg.fname_prefix);
-        auto dst = filename(d);
+        descriptor d(next_id(), cfg.fname_prefix, cfg.use_compression ? descriptor::segment_version_3 : descriptor::segment_version_2);
+        auto dst = filename(pick_location(), d);
         auto flags = open_flags::wo;
         if (cfg.use_o_dsync) {
             flags |= open_flags::dsync;
@@ -1786,6 +2069,8 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
             // proper descriptor id order. If we renamed in the delete call
             // that recycled the file we could potentially have
             // out-of-order files. (Sort does not help).
+            // Recycled files stay in their directory.
+            dst = filename(dirname(f.name()), d);
             clogger.debug("Using recycled segment file {} -> {}", f.name(), dst);
             co_await f.rename(dst);
             co_return co_await allocate_segment_ex(std::move(d), std::move(f), flags);
@@ -2144,7 +2429,7 @@ future<> db::commitlog::segment_manager::do_pending_deletes() {
 
             if (next_usage <= max_disk_size && mode != dispose_mode::ForceDelete) {
                 descriptor d(next_id(), "Recycled-" + cfg.fname_prefix);
-                auto dst = this->filename(d);
+                auto dst = this->filename(dirname(f.name()), d);
 
                 clogger.debug("Recycling segment file {}", f.name());
                 // must rename the file since we must ensure the
@@ -2225,7 +2510,7 @@ void db::commitlog::segment_manager::on_timer() {
     // without waiting for them, so segement_manager could be shut down
     // while they are running.
     (void)seastar::with_gate(_gate, [this] {
-        if (cfg.mode != sync_mode::BATCH) {
+        if (!syncs_each_write()) {
             sync();
         }
 
@@ -2279,8 +2564,7 @@ std::vector<sstring> db::commitlog::segment_manager::get_active_names() const {
     std::vector<sstring> res;
     for (auto i: _segments) {
         if (!i->is_unused()) {
-            // Each shared is located in its own directory
-            res.push_back(cfg.commit_log_location + "/" + i->get_segment_name());
+            res.push_back(i->get_file_name());
         }
     }
     return res;
@@ -2572,11 +2856,26 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
         size_t start_off = 0;
         size_t file_size = 0;
         size_t corrupt_size = 0;
+        // Replay positions are ahead of file positions by this
+        // much, after compressed chunks.
+        size_t logical_offset = 0;
+        // Set while reading the entries of a compressed chunk from
+        // memory, when pos is the replay position.
+        bool decompressed = false;
         bool eof = false;
         bool header = true;
         bool failed = false;
         fragmented_temporary_buffer::reader frag_reader;
 
+        class chunk_data_source_impl : public data_source_impl {
+            temporary_buffer<char> _buf;
+        public:
+            explicit chunk_data_source_impl(temporary_buffer<char> buf) : _buf(std::move(buf)) {}
+            virtual future<temporary_buffer<char>> get() override {
+                return make_ready_future<temporary_buffer<char>>(std::exchange(_buf, {}));
+            }
+        };
+
         work(file f, descriptor din, commit_load_reader_func fn, seastar::io_priority_class read_io_prio_class, position_type o = 0)
                 : f(f), d(din), func(std::move(fn)), fin(make_file_input_stream(f, 0, make_file_input_stream_options(read_io_prio_class))), start_off(o) {
         }
@@ -2597,7 +2896,7 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
         }
         future<> skip(size_t bytes) {
             pos += bytes;
-            if (pos > file_size) {
+            if (!decompressed && pos > file_size) {
                 eof = true;
                 pos = file_size;
             }
@@ -2671,7 +2970,23 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
             crc32_nbo crc;
             crc.process<int32_t>(id & 0xffffffff);
             crc.process<int32_t>(id >> 32);
-            crc.process<uint32_t>(start);
+            crc.process<uint32_t>(start + logical_offset);
+
+            bool compressed = d.ver >= descriptor::segment_version_3 && (next & segment::compressed_chunk_flag);
+            uint32_t compressed_size = 0;
+            uint32_t disk_next = 0;
+            if (compressed) {
+                next &= ~segment::compressed_chunk_flag;
+                buf = co_await frag_reader.read_exactly(fin, segment::compressed_chunk_overhead_size);
+                if (!advance(buf)) {
+                    co_return;
+                }
+                in = buf.get_istream();
+                compressed_size = read<uint32_t>(in);
+                disk_next = read<uint32_t>(in);
+                crc.process(compressed_size);
+                crc.process(disk_next);
+            }
 
             auto cs = crc.checksum();
             if (cs != checksum) {
@@ -2683,10 +2998,14 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 co_return;
             }
 
-            this->next = next;
+            if (compressed) {
+                co_return co_await read_compressed_chunk(start + logical_offset + segment::segment_overhead_size, next, compressed_size, disk_next);
+            }
+
+            this->next = next - logical_offset;
 
             if (start_off >= next) {
-                co_return co_await skip(next - pos);
+                co_return co_await skip(this->next - pos);
             }
 
             while (!end_of_chunk()) {
@@ -2694,6 +3013,63 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
             }
         }
 
+        // Reads the entries of a compressed chunk, which are at replay positions
+        // [data_pos, next) once decompressed, and continues after the chunk, at
+        // disk_next in the file.
+        future<> read_compressed_chunk(size_t data_pos, size_t next, uint32_t compressed_size, uint32_t disk_next) {
+            if (disk_next > file_size || disk_next < pos + compressed_size || next < data_pos) {
+                clogger.debug("Invalid compressed segment chunk at {}.", data_pos);
+                corrupt_size += (file_size - pos);
+                stop();
+                co_return;
+            }
+
+            if (start_off < next) {
+                auto data = co_await fin.read_exactly(compressed_size);
+                pos += data.size();
+                if (data.size() != compressed_size) {
+                    stop();
+                    co_return;
+                }
+                temporary_buffer<char> chunk(next - data_pos);
+                auto len = LZ4_decompress_safe(data.get(), chunk.get_write(), compressed_size, chunk.size());
+                if (len < 0 || size_t(len) != chunk.size()) {
+                    // The chunk header checksum was fine, so we can still go on with the next chunk.
+                    clogger.debug("Failed to decompress segment chunk at {}.", data_pos);
+                    corrupt_size += chunk.size();
+                } else {
+                    auto disk_pos = std::exchange(pos, data_pos);
+                    auto disk_in = std::exchange(fin, input_stream<char>(data_source(std::make_unique<chunk_data_source_impl>(std::move(chunk)))));
+                    std::swap(this->next, next);
+                    logical_offset = 0;
+                    decompressed = true;
+                    std::exception_ptr ex;
+                    try {
+                        while (!end_of_chunk()) {
+                            co_await read_entry();
+                        }
+                    } catch (...) {
+                        ex = std::current_exception();
+                    }
+                    co_await fin.close();
+                    fin = std::move(disk_in);
+                    decompressed = false;
+                    std::swap(this->next, next);
+                    pos = disk_pos;
+                    if (ex) {
+                        std::rethrow_exception(ex);
+                    }
+                    if (failed) {
+                        co_return;
+                    }
+                }
+            }
+
+            logical_offset = next - disk_next;
+            this->next = disk_next;
+            co_await skip(disk_next - pos);
+        }
+
         using produce_func = std::function<future<>(buffer_and_replay_position, uint32_t)>;
 
         future<> produce(buffer_and_replay_position bar) {
@@ -2725,7 +3101,7 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
 
             auto buf = co_await frag_reader.read_exactly(fin, entry_header_size);
 
-            replay_position rp(id, position_type(pos));
+            replay_position rp(id, position_type(pos + logical_offset));
 
             if (!advance(buf)) {
                 co_return;
@@ -2950,7 +3326,12 @@ uint64_t db::commitlog::get_num_active_allocations() const {
 }
 
 future<std::vector<db::commitlog::descriptor>> db::commitlog::list_existing_descriptors() const {
-    return list_existing_descriptors(active_config().commit_log_location);
+    std::vector<descriptor> res;
+    for (auto& dir : _segment_manager->locations()) {
+        auto descs = co_await list_existing_descriptors(dir);
+        std::move(descs.begin(), descs.end(), std::back_inserter(res));
+    }
+    co_return res;
 }
 
 future<std::vector<db::commitlog::descriptor>> db::commitlog::list_existing_descriptors(const sstring& dir) const {
@@ -2958,7 +3339,12 @@ future<std::vector<db::commitlog::descriptor>> db::commitlog::list_existing_desc
 }
 
 future<std::vector<sstring>> db::commitlog::list_existing_segments() const {
-    return list_existing_segments(active_config().commit_log_location);
+    std::vector<sstring> res;
+    for (auto& dir : _segment_manager->locations()) {
+        auto paths = co_await list_existing_segments(dir);
+        std::move(paths.begin(), paths.end(), std::back_inserter(res));
+    }
+    co_return res;
 }
 
 future<std::vector<sstring>> db::commitlog::list_existing_segments(const sstring& dir) const {
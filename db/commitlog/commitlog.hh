@@ -55,6 +55,11 @@ class extensions;
  * flushing has not been done in X ms, we will write + flush to file. In
  * which case we wait for it.
  *
+ * In GROUP mode, every write waits for its data to be flushed, like in
+ * BATCH mode, but the flush is shared by all writes arriving within a short
+ * window. The window adapts to the observed write rate and flush latency,
+ * and never exceeds the configured maximum delay.
+ *
  * The commitlog does not guarantee any ordering between "add" callers
  * (due to the above). The actual order in the commitlog is however
  * identified by the replay_position returned.
@@ -81,7 +86,7 @@ class commitlog {
     ::shared_ptr<segment_manager> _segment_manager;
 public:
     enum class sync_mode {
-        PERIODIC, BATCH
+        PERIODIC, BATCH, GROUP
     };
     using force_sync = commitlog_entry_writer::force_sync;
     struct config {
@@ -90,11 +95,17 @@ class commitlog {
         static config from_db_config(const db::config&, size_t shard_available_memory);
 
         sstring commit_log_location;
+        // More directories, typically on other devices, to place segments in.
+        // Each new segment goes to the directory with the least data waiting
+        // to be written and flushed.
+        std::vector<sstring> extra_commit_log_locations;
         sstring metrics_category_name;
         uint64_t commitlog_total_space_in_mb = 0;
         std::optional<uint64_t> commitlog_flush_threshold_in_mb = {};
         uint64_t commitlog_segment_size_in_mb = 32;
         uint64_t commitlog_sync_period_in_ms = 10 * 1000; //TODO: verify default!
+        // Upper bound on the time a write waits for others to share its flush in GROUP mode.
+        uint64_t commitlog_sync_group_max_delay_in_us = 2000;
         // Max number of segments to keep in pre-alloc reserve.
         // Not (yet) configurable from scylla.conf.
         uint64_t max_reserve_segments = 12;
@@ -107,6 +118,8 @@ class commitlog {
         std::string fname_prefix = descriptor::FILENAME_PREFIX;
 
         bool use_o_dsync = false;
+        // Compress chunks with lz4 when written. Segments are written in segment_version_3 then.
+        bool use_compression = false;
         bool warn_about_segments_left_on_disk_after_shutdown = true;
         bool allow_going_over_size_limit = true;
 
@@ -133,6 +146,8 @@ class commitlog {
 
         static inline constexpr uint32_t segment_version_1 = 1u;
         static inline constexpr uint32_t segment_version_2 = 2u;
+        // Chunks may be compressed
+        static inline constexpr uint32_t segment_version_3 = 3u;
 
         descriptor(descriptor&&) noexcept = default;
         descriptor(const descriptor&) = default;
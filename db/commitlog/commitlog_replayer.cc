@@ -12,9 +12,12 @@
 #include <algorithm>
 #include <unordered_map>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/lowres_clock.hh>
 
 #include "commitlog.hh"
 #include "commitlog_replayer.hh"
@@ -57,12 +60,14 @@ class db::commitlog_replayer::impl {
         uint64_t skipped_mutations = 0;
         uint64_t applied_mutations = 0;
         uint64_t corrupt_bytes = 0;
+        uint64_t replayed_bytes = 0;
 
         stats& operator+=(const stats& s) {
             invalid_mutations += s.invalid_mutations;
             skipped_mutations += s.skipped_mutations;
             applied_mutations += s.applied_mutations;
             corrupt_bytes += s.corrupt_bytes;
+            replayed_bytes += s.replayed_bytes;
             return *this;
         }
         stats operator+(const stats& s) const {
@@ -212,6 +217,7 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
 future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
     auto&& buf = buf_rp.buffer;
     auto&& rp = buf_rp.position;
+    s->replayed_bytes += buf.size_bytes();
     try {
 
         commitlog_entry_reader cer(buf);
@@ -340,12 +346,15 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
             return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
                 return smp::submit_to(id, [this, id, map, &fname_prefix] () {
                     auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
+                    // Segments are replayed a few at a time. Mutations commute, so the order
+                    // across segments doesn't matter, and reading the next segments while
+                    // the current ones are applied keeps the disk busy. Memory is bounded by
+                    // the dirty memory manager, which flushes memtables as they fill up.
+                    auto parallelism = std::max<uint32_t>(1, _impl->_db.local().get_config().commitlog_replay_parallelism());
                     auto range = map->equal_range(id);
-                    return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
-                        auto&f = p.second;
+                    auto files = boost::copy_range<std::vector<sstring>>(boost::make_iterator_range(range.first, range.second) | boost::adaptors::map_values);
+                    return do_with(std::move(files), [this, total, parallelism, &fname_prefix] (std::vector<sstring>& files) {
+                      return max_concurrent_for_each(files, parallelism, [this, total, &fname_prefix] (const sstring& f) {
                         rlogger.debug("Replaying {}", f);
                         return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
                             if (stats.corrupt_bytes != 0) {
@@ -359,15 +368,21 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
                             );
                             *total += stats;
                         });
+                      });
                     }).then([total] {
                         return make_ready_future<impl::stats>(*total);
                     });
                 });
-            }, impl::stats(), std::plus<impl::stats>()).then([](impl::stats totals) {
-                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped)"
+            }, impl::stats(), std::plus<impl::stats>()).then([start = lowres_clock::now()] (impl::stats totals) {
+                auto elapsed = std::chrono::duration<double>(lowres_clock::now() - start).count();
+                auto rate = [elapsed] (uint64_t n) { return elapsed > 0 ? n / elapsed : 0.0; };
+                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped) in {:.2f} s ({:.0f} mutations/s, {:.2f} MB/s)"
                                 , totals.applied_mutations
                                 , totals.invalid_mutations
                                 , totals.skipped_mutations
+                                , elapsed
+                                , rate(totals.applied_mutations)
+                                , rate(totals.replayed_bytes) / (1024 * 1024)
                 );
             });
         }).finally([this] {
@@ -281,8 +281,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the memtable shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_static_shares(this, "compaction_static_shares", liveness::LiveUpdate, value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
+    , memtable_flush_shares_smoothing_in_ms(this, "memtable_flush_shares_smoothing_in_ms", value_status::Used, 200,
+        "Time constant with which the memtable flush controller moves shares towards the value computed from the amount of dirty memory. Higher values give steadier shares, at the cost of a slower response to write bursts. 0 disables smoothing.")
+    , compaction_shares_smoothing_in_ms(this, "compaction_shares_smoothing_in_ms", value_status::Used, 2000,
+        "Time constant with which the compaction controller moves shares towards the value computed from the compaction backlog. Higher values give steadier shares, at the cost of a slower response to write bursts. 0 disables smoothing.")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , max_concurrent_offstrategy_compactions(this, "max_concurrent_offstrategy_compactions", value_status::Used, 2,
+        "Maximum number of off-strategy compactions, which integrate sstables from repair and streaming, running at the same time on each shard. Each one temporarily needs extra disk space of the size of its table's repaired or streamed data.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -303,6 +309,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory in which Scylla will put all its subdirectories. The location of individual subdirs can be overriden by the respective *_directory options.")
     , commitlog_directory(this, "commitlog_directory", value_status::Used, "",
         "The directory where the commit log is stored. For optimal write performance, it is recommended the commit log be on a separate disk partition (ideally, a separate physical device) from the data file directories.")
+    , commitlog_extra_directories(this, "commitlog_extra_directories", value_status::Used, { },
+        "Additional directories, ideally on separate physical devices, where commit log segments are stored along with commitlog_directory. Each new segment is placed in the directory with the least data waiting to be written, spreading commit log writes over the devices.")
     , data_file_directories(this, "data_file_directories", "datadir", value_status::Used, { },
         "The directory location where table data (SSTables) is stored")
     , hints_directory(this, "hints_directory", value_status::Used, "",
@@ -414,6 +422,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\n"
         "\tperiodic : Used with commitlog_sync_period_in_ms (Default: 10000 - 10 seconds ) to control how often the commit log is synchronized to disk. Periodic syncs are acknowledged immediately.\n"
         "\tbatch : Used with commitlog_sync_batch_window_in_ms (Default: disabled **) to control how long Scylla waits for other writes before performing a sync. When using this method, writes are not acknowledged until fsynced to disk.\n"
+        "\tgroup : Like batch, writes are not acknowledged until fsynced to disk, but concurrent writes share a sync. The time a write waits for others adapts to the write rate and the sync latency, up to commitlog_sync_group_max_delay_in_us.\n"
         "Related information: Durability")
     , commitlog_segment_size_in_mb(this, "commitlog_segment_size_in_mb", value_status::Used, 64,
         "Sets the size of the individual commitlog file segments. A commitlog segment may be archived, deleted, or recycled after all its data has been flushed to SSTables. This amount of data can potentially include commitlog segments from every table in the system. The default size is usually suitable for most commitlog archiving, but if you want a finer granularity, 8 or 16 MB is reasonable. See Commit log archive configuration.\n"
@@ -424,6 +433,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Note: does not exist on the listing page other than in above comment, wtf? */
     , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_sync_group_max_delay_in_us(this, "commitlog_sync_group_max_delay_in_us", value_status::Used, 2000,
+        "Maximum time in microseconds a write waits for other writes to share its sync in \"group\" mode.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -434,8 +445,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Threshold for commitlog disk usage. When used disk space goes above this value, Scylla initiates flushes of memtables to disk for the oldest commitlog segments, removing those log segments. Adjusting this affects disk usage vs. write latency. Default is (approximately) commitlog_total_space_in_mb - <num shards>*commitlog_segment_size_in_mb.")
     , commitlog_use_o_dsync(this, "commitlog_use_o_dsync", value_status::Used, true,
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, false,
+        "Whether or not to compress commitlog segment chunks with lz4. Reduces commitlog disk writes for compressible data, at the cost of CPU. Segments written with compression cannot be replayed by older versions.")
     , commitlog_use_hard_size_limit(this, "commitlog_use_hard_size_limit", value_status::Used, false,
         "Whether or not to use a hard size limit for commitlog disk usage. Default is false. Enabling this can cause latency spikes, whereas the default can lead to occasional disk usage peaks.\n")
+    , commitlog_replay_parallelism(this, "commitlog_replay_parallelism", value_status::Used, 2,
+        "Maximum number of commitlog segments replayed concurrently by each shard on startup. Higher values hide read latency at the cost of more memory held by in-flight mutations.")
     /* Compaction settings */
     /* Related information: Configuring compaction */
     , compaction_preheat_key_cache(this, "compaction_preheat_key_cache", value_status::Unused, true,
@@ -574,6 +589,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The time that the coordinator waits for counter writes to complete.")
     , cas_contention_timeout_in_ms(this, "cas_contention_timeout_in_ms", value_status::Used, 1000,
         "The time that the coordinator continues to retry a CAS (compare and set) operation that contends with other proposals for the same row.")
+    , cas_ballot_lease_in_ms(this, "cas_ballot_lease_in_ms", liveness::LiveUpdate, value_status::Used, 1000,
+        "The time after an uncontended CAS (compare and set) round during which the coordinator sends further CAS operations on the same row which don't read existing values straight to the accept phase, skipping prepare. Zero disables this.")
     , truncate_request_timeout_in_ms(this, "truncate_request_timeout_in_ms", value_status::Used, 60000,
         "The time that the coordinator waits for truncates (remove all data from a table) to complete. The long default value allows for a snapshot to be taken before removing the data. If auto_snapshot is disabled (not recommended), you can reduce this time.")
     , write_request_timeout_in_ms(this, "write_request_timeout_in_ms", value_status::Used, 2000,
@@ -582,6 +599,15 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , request_timeout_in_ms(this, "request_timeout_in_ms", value_status::Used, 10000,
         "The default timeout for other, miscellaneous operations.\n"
         "Related information: About hinted handoff writes")
+    , heavy_statement_threshold_in_ms(this, "heavy_statement_threshold_in_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "Prepared statements whose average service time exceeds this threshold are executed in a separate, lower-priority scheduling group, so that expensive queries (e.g. scans with ALLOW FILTERING) don't slow down other queries. The service time of an execution is its duration divided by the number of statements executing along with it, so that statements aren't classified as heavy just because the node is busy. A statement stops being heavy when its average drops below half the threshold. Zero disables this.")
+    , deferred_read_repair(this, "deferred_read_repair", liveness::LiveUpdate, value_status::Used, false,
+        "Return the reconciled result of reads which found mismatching replicas without waiting for the read repair writes. The repair mutations are queued, coalesced per partition and written in the background. "
+        "This lowers the latency of such reads, e.g. while nodes catch up after an outage, at the cost of a read at a given consistency level no longer guaranteeing that a following read at that consistency level sees the same data.")
+    , deferred_read_repair_max_pending_partitions(this, "deferred_read_repair_max_pending_partitions", liveness::LiveUpdate, value_status::Used, 10000,
+        "The maximum number of partitions with deferred read repair writes queued on a shard. Repairs of further partitions are dropped.")
+    , deferred_read_repair_partitions_per_second(this, "deferred_read_repair_partitions_per_second", liveness::LiveUpdate, value_status::Used, 1000,
+        "The maximum rate, in partitions per second per shard, at which deferred read repair writes are sent.")
     /* Inter-node settings */
     , cross_node_timeout(this, "cross_node_timeout", value_status::Unused, false,
         "Enable or disable operation timeout information exchange between nodes (to accurately measure request timeouts). If disabled Cassandra assumes the request was forwarded to the replica instantly by the coordinator.\n"
@@ -656,6 +682,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tYour own RPC server: You must provide a fully-qualified class name of an o.a.c.t.TServerFactory that can create a server instance.")
     , cache_hit_rate_read_balancing(this, "cache_hit_rate_read_balancing", value_status::Used, true,
         "This boolean controls whether the replicas for read query will be choosen based on cache hit ratio")
+    , spread_hot_partition_reads(this, "spread_hot_partition_reads", liveness::LiveUpdate, value_status::Used, true,
+        "Spread reads at consistency level ONE or LOCAL_ONE of partitions which receive a large share of a coordinator's reads over all live replicas in the local datacenter, instead of sending them to the closest replica")
+    , read_replica_latency_balancing(this, "read_replica_latency_balancing", liveness::LiveUpdate, value_status::Used, false,
+        "Send reads to the replicas in the local datacenter with the lowest expected response time, estimated from the latency of recent requests to each of them and the number of requests still waiting for their reply. Replaces the balancing of cache_hit_rate_read_balancing when enabled")
+    , speculative_retry_budget(this, "speculative_retry_budget", liveness::LiveUpdate, value_status::Used, 0.05,
+        "The largest share of reads for which a speculative request may be sent to an extra replica, when the table's speculative_retry is a percentile or a fixed time. Set to 1 to not limit speculative reads")
     /* Advanced fault detection settings */
     /* Settings to handle poorly performing or failing nodes. */
     , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", value_status::Unused, 0,
@@ -805,6 +837,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , experimental(this, "experimental", value_status::Used, false, "[Deprecated] Set to true to unlock all experimental features (except 'raft' feature, which should be enabled explicitly via 'experimental-features' option). Please use 'experimental-features', instead.")
     , experimental_features(this, "experimental_features", value_status::Used, {}, experimental_features_help_string())
     , lsa_reclamation_step(this, "lsa_reclamation_step", value_status::Used, 1, "Minimum number of segments to reclaim in a single step")
+    , lsa_transparent_huge_pages(this, "lsa_transparent_huge_pages", value_status::Used, false,
+        "Ask the kernel to back the memory of LSA segments (row cache and memtables) with transparent huge pages, to reduce TLB misses. Has no effect if transparent huge pages are disabled in the kernel, or when memory is already backed by huge pages reserved with --hugepages.")
+    , lsa_background_reclaim_reserve_in_mb(this, "lsa_background_reclaim_reserve_in_mb", value_status::Used, 57,
+        "Amount of free memory per shard that LSA tries to keep by reclaiming in the background, so that allocations don't have to reclaim synchronously. Zero disables background reclaim.")
+    , lsa_background_reclaim_max_shares(this, "lsa_background_reclaim_max_shares", value_status::Used, 1000,
+        "CPU shares of the background reclaim scheduling group when free memory is exhausted. The shares grow linearly towards this value as free memory drops below lsa_background_reclaim_reserve_in_mb.")
     , prometheus_port(this, "prometheus_port", value_status::Used, 9180, "Prometheus port, set to zero to disable")
     , prometheus_address(this, "prometheus_address", value_status::Used, {/* listen_address */}, "Prometheus listening address, defaulting to listen_address if not explicitly set")
     , prometheus_prefix(this, "prometheus_prefix", value_status::Used, "scylla", "Set the prefix of the exported Prometheus metrics. Changing this will break Scylla's dashboard compatibility, do not change unless you know what you are doing.")
@@ -816,10 +854,24 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , large_memory_allocation_warning_threshold(this, "large_memory_allocation_warning_threshold", value_status::Used, size_t(1) << 20, "Warn about memory allocations above this size; set to zero to disable")
     , enable_deprecated_partitioners(this, "enable_deprecated_partitioners", value_status::Used, false, "Enable the byteordered and random partitioners. These partitioners are deprecated and will be removed in a future version.")
     , enable_keyspace_column_family_metrics(this, "enable_keyspace_column_family_metrics", value_status::Used, false, "Enable per keyspace and per column family metrics reporting")
+    , hot_partitions_sample_period(this, "hot_partitions_sample_period", liveness::LiveUpdate, value_status::Used, 1000,
+        "Count one in every this many reads and writes to find the hottest partitions of each shard, reported in system.hot_partitions. 0 disables the tracking.")
     , enable_sstable_data_integrity_check(this, "enable_sstable_data_integrity_check", value_status::Used, false, "Enable interposer which checks for integrity of every sstable write."
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , enable_sstable_key_validation(this, "enable_sstable_key_validation", value_status::Used, ENABLE_SSTABLE_KEY_VALIDATION, "Enable validation of partition and clustering keys monotonicity"
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
+    , sstable_blocked_bloom_filter(this, "sstable_blocked_bloom_filter", value_status::Used, false, "Write sstable bloom filters in the cache-line-blocked layout, which checks all probes"
+        " of a key within a single cache line. Sstables written this way cannot be read by versions which do not support the layout.")
+    , sstable_prefix_compressed_promoted_index(this, "sstable_prefix_compressed_promoted_index", value_status::Used, false, "Write the last clustering key of each promoted index"
+        " block as a suffix of the block's first key, omitting the components they share. Makes the promoted index of wide partitions smaller."
+        " Sstables written this way cannot be read by versions which do not support it.")
+    , sstable_filter_memory_limit_fraction(this, "sstable_filter_memory_limit_fraction", value_status::Used, 0.2, "Fraction of the shard's memory that bloom filters"
+        " of sstables may use. Above it, the filters of the least recently read sstables are dropped, and reads of those sstables consult the index instead."
+        " Dropped filters are reloaded from disk when memory is freed. Set to 0 to keep all filters in memory.")
+    , sstable_chunk_cache(this, "sstable_chunk_cache", value_status::Used, false, "Cache decompressed chunks of compressed sstables read by single-partition queries,"
+        " in memory shared with the row cache. Only applies to tables with caching enabled, and to sstables opened after the option is set.")
+    , sstable_scan_read_ahead(this, "sstable_scan_read_ahead", liveness::LiveUpdate, value_status::Used, 4, "Number of buffers read ahead by sstable readers"
+        " which scan the data file to its end, like the readers of compaction. Higher values keep more reads in flight, at the cost of more memory per reader.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
@@ -836,6 +888,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , max_clustering_key_restrictions_per_query(this, "max_clustering_key_restrictions_per_query", liveness::LiveUpdate, value_status::Used, 100,
             "Maximum number of distinct clustering key restrictions per query. This limit places a bound on the size of IN tuples, "
             "especially when multiple clustering key columns have IN restrictions. Increasing this value can result in server instability.")
+    , max_partitions_per_in_query_page(this, "max_partitions_per_in_query_page", liveness::LiveUpdate, value_status::Used, 0,
+            "Maximum number of partitions a paged query with an IN restriction on the partition key reads at once. "
+            "The rows of the first partitions are then sent without waiting for the reads of the others, which are left "
+            "for the next pages. 0 means all the remaining partitions are read for every page.")
     , max_memory_for_unlimited_query_soft_limit(this, "max_memory_for_unlimited_query_soft_limit", liveness::LiveUpdate, value_status::Used, uint64_t(1) << 20,
             "Maximum amount of memory a query, whose memory consumption is not naturally limited, is allowed to consume, e.g. non-paged and reverse queries. "
             "This is the soft limit, there will be a warning logged for queries violating this limit.")
@@ -846,6 +902,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "The maximum number of compaction windows allowed when making use of TimeWindowCompactionStrategy. A setting of 0 effectively disables the restriction.")
     , initial_sstable_loading_concurrency(this, "initial_sstable_loading_concurrency", value_status::Used, 4u,
             "Maximum amount of sstables to load in parallel during initialization. A higher number can lead to more memory consumption. You should not need to touch this")
+    , snapshot_link_concurrency(this, "snapshot_link_concurrency", value_status::Used, 32u,
+            "Maximum amount of sstables to hard-link into snapshots in parallel, per shard. Lower it if taking snapshots disturbs foreground latency")
     , enable_3_1_0_compatibility_mode(this, "enable_3_1_0_compatibility_mode", value_status::Used, false,
         "Set to true if the cluster was initially installed from 3.1.0. If it was upgraded from an earlier version,"
         " or installed from a later version, leave this set to false. This adjusts the communication protocol to"
@@ -858,6 +916,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Time period in seconds after which unused schema versions will be evicted from the local schema registry cache. Default is 1 second.")
     , max_concurrent_requests_per_shard(this, "max_concurrent_requests_per_shard",liveness::LiveUpdate, value_status::Used, std::numeric_limits<uint32_t>::max(),
         "Maximum number of concurrent requests a single shard can handle before it starts shedding extra load. By default, no requests will be shed.")
+    , cql_connection_memory_share(this, "cql_connection_memory_share", value_status::Used, 0.25,
+        "Fraction of the shard's CQL request memory a single connection may hold with its in-flight requests. A connection over it isn't read"
+        " until some of its requests complete, so clients pipelining many requests don't starve the others. Set to 1 to disable.")
     , cdc_dont_rewrite_streams(this, "cdc_dont_rewrite_streams", value_status::Used, false,
             "Disable rewriting streams from cdc_streams_descriptions to cdc_streams_descriptions_v2. Should not be necessary, but the procedure is expensive and prone to failures; this config option is left as a backdoor in case some user requires manual intervention.")
     , strict_allow_filtering(this, "strict_allow_filtering", liveness::LiveUpdate, value_status::Used, strict_allow_filtering_default(), "Match Cassandra in requiring ALLOW FILTERING on slow queries. Can be true, false, or warn. When false, Scylla accepts some slow queries even without ALLOW FILTERING that Cassandra rejects. Warn is same as false, but with warning.")
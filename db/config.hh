@@ -140,13 +140,17 @@ class config : public utils::config_file {
     named_value<bool> auto_adjust_flush_quota;
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
+    named_value<uint32_t> memtable_flush_shares_smoothing_in_ms;
+    named_value<uint32_t> compaction_shares_smoothing_in_ms;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> max_concurrent_offstrategy_compactions;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
     named_value<bool> listen_interface_prefer_ipv6;
     named_value<sstring> work_directory;
     named_value<sstring> commitlog_directory;
+    named_value<string_list> commitlog_extra_directories;
     named_value<string_list> data_file_directories;
     named_value<sstring> hints_directory;
     named_value<sstring> view_hints_directory;
@@ -176,11 +180,14 @@ class config : public utils::config_file {
     named_value<uint32_t> commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
     named_value<uint32_t> commitlog_sync_batch_window_in_ms;
+    named_value<uint32_t> commitlog_sync_group_max_delay_in_us;
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments; // unused. retained for upgrade compat
     named_value<int64_t> commitlog_flush_threshold_in_mb;
     named_value<bool> commitlog_use_o_dsync;
+    named_value<bool> commitlog_compression;
     named_value<bool> commitlog_use_hard_size_limit;
+    named_value<uint32_t> commitlog_replay_parallelism;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -232,9 +239,14 @@ class config : public utils::config_file {
     named_value<uint32_t> read_request_timeout_in_ms;
     named_value<uint32_t> counter_write_request_timeout_in_ms;
     named_value<uint32_t> cas_contention_timeout_in_ms;
+    named_value<uint32_t> cas_ballot_lease_in_ms;
     named_value<uint32_t> truncate_request_timeout_in_ms;
     named_value<uint32_t> write_request_timeout_in_ms;
     named_value<uint32_t> request_timeout_in_ms;
+    named_value<uint32_t> heavy_statement_threshold_in_ms;
+    named_value<bool> deferred_read_repair;
+    named_value<uint32_t> deferred_read_repair_max_pending_partitions;
+    named_value<uint32_t> deferred_read_repair_partitions_per_second;
     named_value<bool> cross_node_timeout;
     named_value<uint32_t> internode_send_buff_size_in_bytes;
     named_value<uint32_t> internode_recv_buff_size_in_bytes;
@@ -258,6 +270,9 @@ class config : public utils::config_file {
     named_value<uint32_t> rpc_send_buff_size_in_bytes;
     named_value<sstring> rpc_server_type;
     named_value<bool> cache_hit_rate_read_balancing;
+    named_value<bool> spread_hot_partition_reads;
+    named_value<bool> read_replica_latency_balancing;
+    named_value<double> speculative_retry_budget;
     named_value<double> dynamic_snitch_badness_threshold;
     named_value<uint32_t> dynamic_snitch_reset_interval_in_ms;
     named_value<uint32_t> dynamic_snitch_update_interval_in_ms;
@@ -312,6 +327,9 @@ class config : public utils::config_file {
     named_value<bool> experimental;
     named_value<std::vector<enum_option<experimental_features_t>>> experimental_features;
     named_value<size_t> lsa_reclamation_step;
+    named_value<bool> lsa_transparent_huge_pages;
+    named_value<size_t> lsa_background_reclaim_reserve_in_mb;
+    named_value<unsigned> lsa_background_reclaim_max_shares;
     named_value<uint16_t> prometheus_port;
     named_value<sstring> prometheus_address;
     named_value<sstring> prometheus_prefix;
@@ -322,8 +340,14 @@ class config : public utils::config_file {
     named_value<size_t> large_memory_allocation_warning_threshold;
     named_value<bool> enable_deprecated_partitioners;
     named_value<bool> enable_keyspace_column_family_metrics;
+    named_value<uint32_t> hot_partitions_sample_period;
     named_value<bool> enable_sstable_data_integrity_check;
     named_value<bool> enable_sstable_key_validation;
+    named_value<bool> sstable_blocked_bloom_filter;
+    named_value<bool> sstable_prefix_compressed_promoted_index;
+    named_value<double> sstable_filter_memory_limit_fraction;
+    named_value<bool> sstable_chunk_cache;
+    named_value<uint32_t> sstable_scan_read_ahead;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
     named_value<bool> enable_sstables_mc_format;
@@ -335,10 +359,12 @@ class config : public utils::config_file {
     named_value<bool> abort_on_internal_error;
     named_value<uint32_t> max_partition_key_restrictions_per_query;
     named_value<uint32_t> max_clustering_key_restrictions_per_query;
+    named_value<uint32_t> max_partitions_per_in_query_page;
     named_value<uint64_t> max_memory_for_unlimited_query_soft_limit;
     named_value<uint64_t> max_memory_for_unlimited_query_hard_limit;
     named_value<uint32_t> twcs_max_window_count;
     named_value<unsigned> initial_sstable_loading_concurrency;
+    named_value<unsigned> snapshot_link_concurrency;
     named_value<bool> enable_3_1_0_compatibility_mode;
     named_value<bool> enable_user_defined_functions;
     named_value<unsigned> user_defined_function_time_limit_ms;
@@ -346,6 +372,7 @@ class config : public utils::config_file {
     named_value<unsigned> user_defined_function_contiguous_allocation_limit_bytes;
     named_value<uint32_t> schema_registry_grace_period;
     named_value<uint32_t> max_concurrent_requests_per_shard;
+    named_value<double> cql_connection_memory_share;
     named_value<bool> cdc_dont_rewrite_streams;
     named_value<tri_mode_restriction> strict_allow_filtering;
     named_value<bool> reversed_reads_auto_bypass_cache;
@@ -114,6 +114,54 @@ toppartitions_data_listener::localize(const global_top_k::results& r) {
     return n;
 }
 
+hot_partitions_data_listener::hot_partitions_data_listener(replica::database& db, utils::updateable_value<uint32_t> sample_period)
+        : _db(db)
+        , _sample_period(std::move(sample_period))
+        , _window_timer([this] { close_window(); }) {
+    _db.data_listeners().install(this);
+    _window_timer.arm_periodic(window);
+}
+
+hot_partitions_data_listener::~hot_partitions_data_listener() {
+    _db.data_listeners().uninstall(this);
+}
+
+bool hot_partitions_data_listener::sample(uint64_t& ops) {
+    auto period = _sample_period();
+    return period && ++ops % period == 0;
+}
+
+void hot_partitions_data_listener::close_window() {
+    try {
+        _last_window.read = _top_k_read.top(list_size);
+        _last_window.write = _top_k_write.top(list_size);
+    } catch (...) {
+        dblog.warn("hot_partitions_data_listener: failed to collect the top partitions: {}", std::current_exception());
+        _last_window = {};
+    }
+    _top_k_read = top_k(capacity);
+    _top_k_write = top_k(capacity);
+}
+
+flat_mutation_reader_v2 hot_partitions_data_listener::on_read(const schema_ptr& s, const dht::partition_range& range,
+        const query::partition_slice& slice, flat_mutation_reader_v2&& rd) {
+    if (!sample(_reads)) {
+        return std::move(rd);
+    }
+    return make_filtering_reader(std::move(rd), [zis = this->weak_from_this(), s] (const dht::decorated_key& dk) {
+        if (zis) {
+            zis->_top_k_read.append(toppartitions_item_key{s, dk});
+        }
+        return true;
+    });
+}
+
+void hot_partitions_data_listener::on_write(const schema_ptr& s, const frozen_mutation& m) {
+    if (sample(_writes)) {
+        _top_k_write.append(toppartitions_item_key{s, m.decorated_key(*s)});
+    }
+}
+
 toppartitions_query::toppartitions_query(distributed<replica::database>& xdb, std::unordered_set<std::tuple<sstring, sstring>, utils::tuple_hash>&& table_filters,
         std::unordered_set<sstring>&& keyspace_filters, std::chrono::milliseconds duration, size_t list_size, size_t capacity)
         : _xdb(xdb), _table_filters(std::move(table_filters)), _keyspace_filters(std::move(keyspace_filters)), _duration(duration), _list_size(list_size), _capacity(capacity),
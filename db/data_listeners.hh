@@ -12,12 +12,15 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
 
 #include "utils/hash.hh"
 #include "schema_fwd.hh"
 #include "readers/flat_mutation_reader_v2.hh"
 #include "utils/top_k.hh"
 #include "schema_registry.hh"
+#include "utils/updateable_value.hh"
 
 #include <vector>
 #include <set>
@@ -138,6 +141,55 @@ class toppartitions_data_listener : public data_listener, public weakly_referenc
     future<> stop();
 };
 
+// Tracks the partitions read and written the most on this shard, all the time.
+//
+// Unlike toppartitions_data_listener, which counts every operation for the
+// duration of an explicit query, this listener counts only one in every
+// sample_period reads and writes, so that it is cheap enough to stay installed.
+// Counts are collected in windows of a fixed length, and the top partitions of
+// the last complete window are kept for reporting.
+class hot_partitions_data_listener : public data_listener, public weakly_referencable<hot_partitions_data_listener> {
+public:
+    using top_k = toppartitions_data_listener::top_k;
+
+    static constexpr size_t capacity = 256;
+    static constexpr size_t list_size = 16;
+    static constexpr std::chrono::seconds window{60};
+
+    struct results {
+        top_k::results read;
+        top_k::results write;
+    };
+private:
+    replica::database& _db;
+    // 0 disables sampling.
+    utils::updateable_value<uint32_t> _sample_period;
+    uint64_t _reads = 0;
+    uint64_t _writes = 0;
+    top_k _top_k_read{capacity};
+    top_k _top_k_write{capacity};
+    results _last_window;
+    timer<lowres_clock> _window_timer;
+private:
+    bool sample(uint64_t& ops);
+public:
+    hot_partitions_data_listener(replica::database& db, utils::updateable_value<uint32_t> sample_period);
+    ~hot_partitions_data_listener();
+
+    virtual flat_mutation_reader_v2 on_read(const schema_ptr& s, const dht::partition_range& range,
+            const query::partition_slice& slice, flat_mutation_reader_v2&& rd) override;
+
+    virtual void on_write(const schema_ptr& s, const frozen_mutation& m) override;
+
+    // Keeps the top partitions of the current window and starts a new one.
+    // Called by a timer every window.
+    void close_window();
+
+    const results& last_window() const noexcept {
+        return _last_window;
+    }
+};
+
 class toppartitions_query {
     distributed<replica::database>& _xdb;
     std::unordered_set<std::tuple<sstring, sstring>, utils::tuple_hash> _table_filters;
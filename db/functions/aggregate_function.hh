@@ -11,11 +11,72 @@
 #pragma once
 
 #include "function.hh"
+#include "bytes.hh"
 #include <optional>
+#include <vector>
 
 namespace db {
 namespace functions {
 
+/**
+ * The values of a single argument for a batch of rows.
+ *
+ * Values are stored back to back in one buffer, so a batch of a page of
+ * rows costs a couple of allocations instead of one per value.
+ */
+class argument_batch {
+    struct entry {
+        uint32_t offset;
+        // Negative for nulls.
+        int32_t size;
+    };
+    std::vector<bytes::value_type> _data;
+    std::vector<entry> _entries;
+public:
+    size_t size() const {
+        return _entries.size();
+    }
+
+    bool empty() const {
+        return _entries.empty();
+    }
+
+    bool is_null(size_t i) const {
+        return _entries[i].size < 0;
+    }
+
+    // Must not be called for nulls.
+    bytes_view value(size_t i) const {
+        return bytes_view(_data.data() + _entries[i].offset, _entries[i].size);
+    }
+
+    bytes_opt get(size_t i) const {
+        if (is_null(i)) {
+            return std::nullopt;
+        }
+        return bytes(value(i));
+    }
+
+    void push_null() {
+        _entries.push_back(entry{uint32_t(_data.size()), -1});
+    }
+
+    // Appends a value given as a range of bytes_view fragments.
+    template <typename FragmentRange>
+    void push_back(const FragmentRange& fragments) {
+        auto offset = _data.size();
+        for (bytes_view f : fragments) {
+            _data.insert(_data.end(), f.begin(), f.end());
+        }
+        _entries.push_back(entry{uint32_t(offset), int32_t(_data.size() - offset)});
+    }
+
+    void clear() {
+        _data.clear();
+        _entries.clear();
+    }
+};
+
 
 /**
  * Performs a calculation on a set of values and return a single value.
@@ -68,6 +129,23 @@ class aggregate_function : public virtual function {
          */
         virtual void add_input(cql_serialization_format sf, const std::vector<opt_bytes>& values) = 0;
 
+        /**
+         * Adds the values of a batch of rows to this aggregate, which must take
+         * at most one argument. Equivalent to calling <code>add_input()</code> for each
+         * value of the batch, but allows native aggregates to work on whole columns.
+         * Aggregates without arguments are passed a batch of nulls, one per row.
+         *
+         * @param protocol_version native protocol version
+         * @param values the values of the argument, one per row.
+         */
+        virtual void add_input_batch(cql_serialization_format sf, const argument_batch& values) {
+            std::vector<opt_bytes> row(1);
+            for (size_t i = 0; i < values.size(); ++i) {
+                row[0] = values.get(i);
+                add_input(sf, row);
+            }
+        }
+
         /**
          * Computes and returns the aggregate current value.
          *
@@ -8,6 +8,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <seastar/core/future.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/sleep.hh>
@@ -16,6 +17,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <boost/range/adaptors.hpp>
+#include <boost/range/irange.hpp>
 #include "utils/div_ceil.hh"
 #include "db/extensions.hh"
 #include "service/storage_proxy.hh"
@@ -77,6 +79,9 @@ void manager::register_metrics(const sstring& group_name) {
         sm::make_counter("sent", _stats.sent,
                         sm::description("Number of sent hints.")),
 
+        sm::make_counter("sent_bytes", _stats.sent_bytes,
+                        sm::description("Total size of sent hints.")),
+
         sm::make_counter("discarded", _stats.discarded,
                         sm::description("Number of hints that were discarded during sending (too old, schema changed, etc.).")),
 
@@ -855,67 +860,96 @@ future<> manager::end_point_hints_manager::sender::send_one_mutation(frozen_muta
     return do_send_one_mutation(std::move(m), natural_endpoints);
 }
 
-future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
-        ctx_ptr->mark_hint_as_in_progress(rp);
+future<> manager::end_point_hints_manager::sender::add_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    std::optional<frozen_mutation_and_schema> m;
+    // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
+    try {
+        m = get_mutation(ctx_ptr, buf);
+    } catch (replica::no_such_column_family& e) {
+        manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+        ++this->shard_stats().discarded;
+    } catch (replica::no_such_keyspace& e) {
+        manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+        ++this->shard_stats().discarded;
+    } catch (no_column_mapping& e) {
+        manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
+        ++this->shard_stats().discarded;
+    } catch (...) {
+        manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, std::current_exception());
+        ctx_ptr->on_hint_send_failure(rp);
+        co_return;
+    }
 
-        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
-        (void)with_gate(ctx_ptr->file_send_gate, [this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] () mutable {
-            try {
-                auto m = this->get_mutation(ctx_ptr, buf);
-                gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
-
-                // The hint is too old - drop it.
-                //
-                // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
-                // (last_modification - manager::hints_timer_period) old.
-                if (gc_clock::now().time_since_epoch() - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
-                    return make_ready_future<>();
-                }
+    // The hint is too old - drop it.
+    //
+    // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
+    // (last_modification - manager::hints_timer_period) old.
+    if (!m || gc_clock::now().time_since_epoch() - secs_since_file_mod > m->s->gc_grace_seconds() - manager::hints_flush_period) {
+        ctx_ptr->on_hint_send_success(rp);
+        update_sent_upper_bound(*ctx_ptr);
+        co_return;
+    }
 
-                return this->send_one_mutation(std::move(m)).then([this, rp, ctx_ptr] {
-                    ++this->shard_stats().sent;
-                }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
-                    manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), eptr);
-                    return make_exception_future<>(std::move(eptr));
-                });
+    auto& batch = ctx_ptr->pending_batch;
+    const size_t size = buf.size_bytes();
+    if (batch && (batch->s != m->s || !batch->mutations.front().key().equal(*m->s, m->fm.key())
+            || batch->size + size > hint_batch_size_limit())) {
+        co_await send_hint_batch(ctx_ptr, std::exchange(batch, std::nullopt).value());
+    }
+    if (!batch) {
+        batch.emplace(hint_batch{m->s});
+    }
+    ctx_ptr->mark_hint_as_in_progress(rp);
+    batch->mutations.push_back(std::move(m->fm));
+    batch->rps.push_back(rp);
+    batch->size += size;
+}
 
-            // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
-            } catch (replica::no_such_column_family& e) {
-                manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (replica::no_such_keyspace& e) {
-                manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (no_column_mapping& e) {
-                manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
-                ++this->shard_stats().discarded;
-            } catch (...) {
-                auto eptr = std::current_exception();
-                manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, eptr);
+future<> manager::end_point_hints_manager::sender::send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, hint_batch batch) {
+    auto batch_ptr = make_lw_shared<hint_batch>(std::move(batch));
+    return _resource_manager.get_send_units_for(batch_ptr->size).then([this, batch_ptr, ctx_ptr] (auto units) mutable {
+        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
+        (void)with_gate(ctx_ptr->file_send_gate, [this, batch_ptr] () mutable {
+            return futurize_invoke([this, batch_ptr] {
+                auto& s = batch_ptr->s;
+                auto& mutations = batch_ptr->mutations;
+                if (mutations.size() == 1) {
+                    return this->send_one_mutation({std::move(mutations.front()), s});
+                }
+                mutation m = mutations.front().unfreeze(s);
+                for (auto i = std::next(mutations.begin()); i != mutations.end(); ++i) {
+                    m.apply(i->unfreeze(s));
+                }
+                return this->send_one_mutation({freeze(m), s});
+            }).then([this, batch_ptr] {
+                this->shard_stats().sent += batch_ptr->rps.size();
+                this->shard_stats().sent_bytes += batch_ptr->size;
+                _replayed_hints += batch_ptr->rps.size();
+                _replayed_bytes += batch_ptr->size;
+            }).handle_exception([this] (auto eptr) {
+                manager_logger.trace("send_hint_batch(): failed to send to {}: {}", end_point_key(), eptr);
                 return make_exception_future<>(std::move(eptr));
-            }
-            return make_ready_future<>();
-        }).then_wrapped([this, units = std::move(units), rp, ctx_ptr] (future<>&& f) {
+            });
+        }).then_wrapped([this, units = std::move(units), batch_ptr, ctx_ptr] (future<>&& f) {
             // Information about the error was already printed somewhere higher.
-            // We just need to account in the ctx that sending of this hint has failed.
+            // We just need to account in the ctx that sending of these hints has failed.
             if (!f.failed()) {
-                ctx_ptr->on_hint_send_success(rp);
-                auto new_bound = ctx_ptr->get_replayed_bound();
-                // Segments from other shards are replayed first and are considered to be "before" replay position 0.
-                // Update the sent upper bound only if it is a local segment.
-                if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
-                    _sent_upper_bound_rp = new_bound;
-                    notify_replay_waiters();
+                for (auto rp : batch_ptr->rps) {
+                    ctx_ptr->on_hint_send_success(rp);
                 }
+                update_sent_upper_bound(*ctx_ptr);
             } else {
-                ctx_ptr->on_hint_send_failure(rp);
+                for (auto rp : batch_ptr->rps) {
+                    ctx_ptr->on_hint_send_failure(rp);
+                }
             }
             f.ignore_ready_future();
         });
-    }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
+    }).handle_exception([this, batch_ptr, ctx_ptr] (auto eptr) {
         manager_logger.trace("send_one_file(): Hmmm. Something bad had happend: {}", eptr);
-        ctx_ptr->on_hint_send_failure(rp);
+        for (auto rp : batch_ptr->rps) {
+            ctx_ptr->on_hint_send_failure(rp);
+        }
     });
 }
 
@@ -1024,14 +1058,42 @@ void manager::end_point_hints_manager::sender::rewind_sent_replay_position_to(db
     notify_replay_waiters();
 }
 
-// runs in a seastar::async context
-bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fname) {
-    timespec last_mod = get_last_file_modification(fname).get0();
+double manager::end_point_hints_manager::sender::destination_load() const {
+    return std::clamp<double>(_proxy.get_backlog_of(end_point_key()).relative_size(), 0.0, 1.0);
+}
+
+size_t manager::end_point_hints_manager::sender::replay_window() const {
+    return std::max<size_t>(1, std::lround(max_segments_in_flight * (1.0 - destination_load())));
+}
+
+size_t manager::end_point_hints_manager::sender::hint_batch_size_limit() const {
+    // Even a loaded destination gets small batches - merging a couple of hints to the same partition
+    // is always cheaper for it than applying them one by one.
+    static constexpr size_t min_hint_batch_size = 8 * 1024;
+    return std::max<size_t>(min_hint_batch_size, max_hint_batch_size * (1.0 - destination_load()));
+}
+
+void manager::end_point_hints_manager::sender::update_sent_upper_bound(const send_one_file_ctx& ctx) noexcept {
+    // Segments from other shards are replayed first and are considered to be "before" replay position 0,
+    // so only local segments are tracked here.
+    _replay_tracker.on_progress(ctx.segment_id, ctx.get_replayed_bound());
+    auto new_bound = _replay_tracker.replayed_bound();
+    if (new_bound && new_bound->shard_id() == this_shard_id() && _sent_upper_bound_rp < *new_bound) {
+        _sent_upper_bound_rp = *new_bound;
+        notify_replay_waiters();
+    }
+}
+
+future<bool> manager::end_point_hints_manager::sender::send_one_file(const sstring& fname) {
+    timespec last_mod = co_await get_last_file_modification(fname);
     gc_clock::duration secs_since_file_mod = std::chrono::seconds(last_mod.tv_sec);
-    lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(_last_schema_ver_to_column_mapping);
+    auto& progress = _segment_progress[fname];
+    auto segment_id = commitlog::descriptor(fname, manager::FILENAME_PREFIX).id;
+    lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(segment_id, progress.schema_ver_to_column_mapping);
+    _replay_tracker.on_progress(segment_id, ctx_ptr->get_replayed_bound());
 
     try {
-        commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_priority(), [this, secs_since_file_mod, &fname, ctx_ptr] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
+        co_await commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_priority(), [this, secs_since_file_mod, &fname, ctx_ptr] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
             auto& buf = buf_rp.buffer;
             auto& rp = buf_rp.position;
 
@@ -1063,11 +1125,11 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
                     co_await sleep(std::chrono::milliseconds(100));
                     continue;
                 } else {
-                    co_await send_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
+                    co_await add_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
                     break;
                 }
             };
-        }, _last_not_complete_rp.pos, &_db.extensions()).get();
+        }, progress.last_not_complete_rp.pos, &_db.extensions());
     } catch (db::commitlog::segment_error& ex) {
         manager_logger.error("{}: {}. Dropping...", fname, ex.what());
         ctx_ptr->segment_replay_failed = false;
@@ -1077,8 +1139,20 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
         ctx_ptr->segment_replay_failed = true;
     }
 
+    // Send the hints which are left in the last batch, unless we are going to retry them anyway.
+    if (ctx_ptr->pending_batch) {
+        auto batch = std::exchange(ctx_ptr->pending_batch, std::nullopt).value();
+        if (!ctx_ptr->segment_replay_failed || draining()) {
+            co_await send_hint_batch(ctx_ptr, std::move(batch));
+        } else {
+            for (auto rp : batch.rps) {
+                ctx_ptr->on_hint_send_failure(rp);
+            }
+        }
+    }
+
     // wait till all background hints sending is complete
-    ctx_ptr->file_send_gate.close().get();
+    co_await ctx_ptr->file_send_gate.close();
 
     // If we are draining ignore failures and drop the segment even if we failed to send it.
     if (draining() && ctx_ptr->segment_replay_failed) {
@@ -1091,41 +1165,23 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
         // If some hints failed to be sent, first_failed_rp will tell the position of first such hint.
         // If there was an error thrown by read_log_file function itself, we will retry sending from
         // the last hint that was successfully sent (last_succeeded_rp).
-        _last_not_complete_rp = ctx_ptr->first_failed_rp.value_or(ctx_ptr->last_succeeded_rp.value_or(_last_not_complete_rp));
-        manager_logger.trace("send_one_file(): error while sending hints from {}, last RP is {}", fname, _last_not_complete_rp);
-        return false;
+        progress.last_not_complete_rp = ctx_ptr->first_failed_rp.value_or(ctx_ptr->last_succeeded_rp.value_or(progress.last_not_complete_rp));
+        manager_logger.trace("send_one_file(): error while sending hints from {}, last RP is {}", fname, progress.last_not_complete_rp);
+        co_return false;
     }
 
     // If we got here we are done with the current segment and we can remove it.
-    with_shared(_file_update_mutex, [&fname, this] {
-        auto p = _ep_manager.get_or_load().get0();
-        return p->delete_segments({ fname });
-    }).get();
+    co_await with_shared(_file_update_mutex, [&fname, this] () -> future<> {
+        auto p = co_await _ep_manager.get_or_load();
+        co_await p->delete_segments({ fname });
+    });
 
-    // clear the replay position - we are going to send the next segment...
-    _last_not_complete_rp = replay_position();
-    _last_schema_ver_to_column_mapping.clear();
+    // forget the replay position - the segment is gone
+    _segment_progress.erase(fname);
+    _replay_tracker.on_done(segment_id);
+    update_sent_upper_bound(*ctx_ptr);
     manager_logger.trace("send_one_file(): segment {} was sent in full and deleted", fname);
-    return true;
-}
-
-const sstring* manager::end_point_hints_manager::sender::name_of_current_segment() const {
-    // Foreign segments are replayed first
-    if (!_foreign_segments_to_replay.empty()) {
-        return &_foreign_segments_to_replay.front();
-    }
-    if (!_segments_to_replay.empty()) {
-        return &_segments_to_replay.front();
-    }
-    return nullptr;
-}
-
-void manager::end_point_hints_manager::sender::pop_current_segment() {
-    if (!_foreign_segments_to_replay.empty()) {
-        _foreign_segments_to_replay.pop_front();
-    } else if (!_segments_to_replay.empty()) {
-        _segments_to_replay.pop_front();
-    }
+    co_return true;
 }
 
 // Runs in the seastar::async context
@@ -1136,20 +1192,45 @@ void manager::end_point_hints_manager::sender::send_hints_maybe() noexcept {
     int replayed_segments_count = 0;
 
     try {
-        while (true) {
-            const sstring* seg_name = name_of_current_segment();
-            if (!seg_name || !replay_allowed() || !can_send()) {
-                break;
+        // Foreign segments are replayed first
+        using segment_list = std::list<sstring>;
+        std::vector<std::pair<segment_list*, segment_list::iterator>> round;
+        for (auto* segments : { &_foreign_segments_to_replay, &_segments_to_replay }) {
+            for (auto it = segments->begin(); it != segments->end(); ++it) {
+                round.emplace_back(segments, it);
             }
-            if (!send_one_file(*seg_name)) {
-                break;
-            }
-            pop_current_segment();
-            ++replayed_segments_count;
+        }
+
+        // Forget the progress of segments which are not going to be replayed anymore.
+        std::erase_if(_segment_progress, [&] (const auto& p) {
+            return std::none_of(round.begin(), round.end(), [&] (const auto& seg) { return *seg.second == p.first; });
+        });
 
-            notify_replay_waiters();
+        _replay_tracker.start_round(_segments_to_replay | boost::adaptors::transformed([] (const sstring& fname) {
+            return commitlog::descriptor(fname, manager::FILENAME_PREFIX).id;
+        }));
+
+        if (!round.empty() && !_replay_start_tp) {
+            _replay_start_tp = clock::now();
         }
 
+        size_t next = 0;
+        bool failed = false;
+        const size_t window = std::min(replay_window(), round.size());
+        parallel_for_each(boost::irange<size_t>(0, window), [&] (size_t) -> future<> {
+            while (!failed && next < round.size() && replay_allowed() && can_send()) {
+                auto [segments, it] = round[next++];
+                if (!co_await send_one_file(*it)) {
+                    failed = true;
+                    co_return;
+                }
+                segments->erase(it);
+                ++replayed_segments_count;
+
+                notify_replay_waiters();
+            }
+        }).get();
+
     // Ignore exceptions, we will retry sending this file from where we left off the next time.
     // Exceptions are not expected here during the regular operation, so just log them.
     } catch (...) {
@@ -1162,6 +1243,15 @@ void manager::end_point_hints_manager::sender::send_hints_maybe() noexcept {
     } else {
         // if there are no segments to send we want to retry when we maybe have some (after flushing)
         _next_send_retry_tp = _next_flush_tp;
+
+        if (_replay_start_tp) {
+            auto elapsed = std::chrono::duration<double>(clock::now() - *_replay_start_tp).count();
+            manager_logger.info("Replayed {} hints ({} bytes) to {} in {:.3f}s ({:.0f} bytes/s)", _replayed_hints, _replayed_bytes, end_point_key(),
+                    elapsed, elapsed > 0 ? _replayed_bytes / elapsed : 0.0);
+            _replay_start_tp.reset();
+            _replayed_hints = 0;
+            _replayed_bytes = 0;
+        }
     }
 
     manager_logger.trace("send_hints(): we handled {} segments", replayed_segments_count);
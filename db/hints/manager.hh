@@ -23,10 +23,12 @@
 #include <seastar/core/abort_source.hh>
 #include "inet_address_vectors.hh"
 #include "db/commitlog/commitlog.hh"
+#include "frozen_mutation.hh"
 #include "utils/loading_shared_values.hh"
 #include "db/hints/resource_manager.hh"
 #include "db/hints/host_filter.hh"
 #include "db/hints/sync_point.hh"
+#include "db/hints/segment_replay_tracker.hh"
 
 class fragmented_temporary_buffer;
 
@@ -73,6 +75,7 @@ class manager {
         uint64_t errors = 0;
         uint64_t dropped = 0;
         uint64_t sent = 0;
+        uint64_t sent_bytes = 0;
         uint64_t discarded = 0;
         uint64_t corrupted_files = 0;
     };
@@ -108,12 +111,32 @@ class manager {
                 state::ep_state_left_the_ring,
                 state::draining>>;
 
+            // Consecutive hints from a segment to the same partition, which are sent as a single mutation.
+            struct hint_batch {
+                schema_ptr s;
+                std::vector<frozen_mutation> mutations;
+                std::vector<db::replay_position> rps;
+                size_t size = 0;
+            };
+
+            // Progress of the replay of a segment, kept across replay attempts.
+            struct segment_progress {
+                // Position from which the next replay attempt should start.
+                replay_position last_not_complete_rp;
+                // Column mappings are written to a segment only once per schema version, so they are needed
+                // when the replay is resumed from the middle of the segment.
+                std::unordered_map<table_schema_version, column_mapping> schema_ver_to_column_mapping;
+            };
+
             struct send_one_file_ctx {
-                send_one_file_ctx(std::unordered_map<table_schema_version, column_mapping>& last_schema_ver_to_column_mapping)
-                    : schema_ver_to_column_mapping(last_schema_ver_to_column_mapping)
+                send_one_file_ctx(segment_id_type id, std::unordered_map<table_schema_version, column_mapping>& last_schema_ver_to_column_mapping)
+                    : segment_id(id)
+                    , schema_ver_to_column_mapping(last_schema_ver_to_column_mapping)
                 {}
+                segment_id_type segment_id;
                 std::unordered_map<table_schema_version, column_mapping>& schema_ver_to_column_mapping;
                 seastar::gate file_send_gate;
+                std::optional<hint_batch> pending_batch;
                 std::optional<db::replay_position> first_failed_rp;
                 std::optional<db::replay_position> last_succeeded_rp;
                 std::set<db::replay_position> in_progress_rps;
@@ -127,13 +150,20 @@ class manager {
                 db::replay_position get_replayed_bound() const noexcept;
             };
 
+            // The maximum number of segments of an end point replayed in parallel.
+            static constexpr size_t max_segments_in_flight = 4;
+            // The maximum size of the hints to a partition merged into a single mutation.
+            static constexpr size_t max_hint_batch_size = 128 * 1024;
+
         private:
             std::list<sstring> _segments_to_replay;
             // Segments to replay which were not created on this shard but were moved during rebalancing
             std::list<sstring> _foreign_segments_to_replay;
-            replay_position _last_not_complete_rp;
+            std::unordered_map<sstring, segment_progress> _segment_progress;
+            // Local segments of the current replay round. Since segments are replayed in parallel,
+            // _sent_upper_bound_rp can only be advanced up to the first segment which wasn't replayed in full.
+            segment_replay_tracker _replay_tracker;
             replay_position _sent_upper_bound_rp;
-            std::unordered_map<table_schema_version, column_mapping> _last_schema_ver_to_column_mapping;
             state_set _state;
             future<> _stopped;
             abort_source _stop_as;
@@ -151,6 +181,11 @@ class manager {
 
             std::multimap<db::replay_position, lw_shared_ptr<std::optional<promise<>>>> _replay_waiters;
 
+            // Replay throughput, measured from the moment a backlog of segments appears until it's replayed.
+            std::optional<clock::time_point> _replay_start_tp;
+            uint64_t _replayed_hints = 0;
+            uint64_t _replayed_bytes = 0;
+
         public:
             sender(end_point_hints_manager& parent, service::storage_proxy& local_storage_proxy, replica::database& local_db, gms::gossiper& local_gossiper) noexcept;
             ~sender();
@@ -192,24 +227,32 @@ class manager {
             future<> wait_until_hints_are_replayed_up_to(abort_source& as, db::replay_position up_to_rp);
 
         private:
-            /// \brief Gets the name of the current segment that should be sent.
-            ///
-            /// If there are no segments to be sent, nullptr will be returned.
-            const sstring* name_of_current_segment() const;
-
-            /// \brief Removes the current segment from the queue.
-            void pop_current_segment();
-
             /// \brief Send hints collected so far.
             ///
             /// Send hints aggregated so far. This function is going to try to deplete
             /// the _segments_to_replay list. Once it's empty it's going to be repopulated during the next send_hints() call
             /// with the new hints files if any.
             ///
-            /// send_hints() is going to stop sending if it sends for too long (longer than the timer period). In this case it's
-            /// going to return and next send_hints() is going to continue from the point the previous call left.
+            /// Up to replay_window() segments are sent in parallel, oldest first (foreign segments before local ones).
+            /// No new segments are started once sending of a segment fails; the failed segments are retried from where
+            /// they were left in the next call.
             void send_hints_maybe() noexcept;
 
+            /// \brief Returns the load of the destination, as reported by its view update backlog, between 0 and 1.
+            double destination_load() const;
+
+            /// \brief Returns the number of segments which should be sent in parallel.
+            ///
+            /// The window shrinks down to a single segment as the destination gets loaded.
+            size_t replay_window() const;
+
+            /// \brief Returns the maximum size of the hints to a partition which should be merged into a single mutation.
+            size_t hint_batch_size_limit() const;
+
+            /// \brief Records the progress of the segment sent in the given context and advances _sent_upper_bound_rp
+            /// up to the first local segment which wasn't replayed in full.
+            void update_sent_upper_bound(const send_one_file_ctx& ctx) noexcept;
+
             void set_draining() noexcept {
                 _state.set(state::draining);
             }
@@ -230,19 +273,28 @@ class manager {
                 return _ep_manager.replay_allowed();
             }
 
-            /// \brief Try to send one hint read from the file.
-            ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of hints "in the air".
+            /// \brief Add one hint read from the file to the pending batch of the file.
             ///  - Discard the hints that are older than the grace seconds value of the corresponding table.
-            ///
-            /// If sending fails we are going to set the state::segment_replay_failed in the _state and _first_failed_rp will be updated to min(_first_failed_rp, \ref rp).
+            ///  - Send the pending batch first if the hint is not to the same partition or if the batch is full.
             ///
             /// \param ctx_ptr shared pointer to the file sending context
             /// \param buf buffer representing the hint
             /// \param rp replay position of this hint in the file (see commitlog for more details on "replay position")
             /// \param secs_since_file_mod last modification time stamp (in seconds since Epoch) of the current hints file
             /// \param fname name of the hints file this hint was read from
-            /// \return future that resolves when next hint may be sent
-            future<> send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+            /// \return future that resolves when next hint may be added
+            future<> add_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+            /// \brief Try to send a batch of hints to one partition.
+            ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of hints "in the air".
+            ///
+            /// If sending fails we are going to set the segment_replay_failed in the ctx and first_failed_rp will be updated to
+            /// the lowest replay position of the batch.
+            ///
+            /// \param ctx_ptr shared pointer to the file sending context
+            /// \param batch hints to send
+            /// \return future that resolves when next batch may be sent
+            future<> send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, hint_batch batch);
 
             /// \brief Send all hint from a single file and delete it after it has been successfully sent.
             /// Send all hints from the given file. If we failed to send the current segment we will pick up in the next
@@ -250,7 +302,7 @@ class manager {
             ///
             /// \param fname file to send
             /// \return TRUE if file has been successfully sent
-            bool send_one_file(const sstring& fname);
+            future<bool> send_one_file(const sstring& fname);
 
             /// \brief Checks if we can still send hints.
             /// \return TRUE if the destination Node is either ALIVE or has left the ring (e.g. after decommission or removenode).
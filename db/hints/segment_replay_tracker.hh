@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include "db/commitlog/replay_position.hh"
+
+namespace db {
+namespace hints {
+
+// Tracks how far the local segments of a replay round were replayed in order.
+//
+// Segments of an end point are replayed in parallel, so they make progress and
+// complete out of order, while the sent upper bound used by sync points means
+// that all hints below it were replayed. The bound can therefore only advance
+// up to the oldest segment of the round which wasn't replayed in full.
+class segment_replay_tracker {
+    struct segment_state {
+        // Position below which all hints of the segment were replayed,
+        // disengaged until the replay of the segment starts.
+        std::optional<db::replay_position> replayed_bound;
+        bool done = false;
+    };
+    std::map<segment_id_type, segment_state> _segments;
+public:
+    // Starts a new round, in which the given segments are replayed.
+    template <typename Range>
+    void start_round(const Range& ids) {
+        _segments.clear();
+        for (auto id : ids) {
+            _segments.emplace(id, segment_state{});
+        }
+    }
+
+    // Records that all hints of the segment below the given position
+    // were replayed. Segments which are not part of the round are ignored.
+    void on_progress(segment_id_type id, db::replay_position bound) noexcept {
+        if (auto it = _segments.find(id); it != _segments.end()) {
+            it->second.replayed_bound = bound;
+        }
+    }
+
+    // Records that the segment was replayed in full.
+    void on_done(segment_id_type id) noexcept {
+        if (auto it = _segments.find(id); it != _segments.end()) {
+            it->second.done = true;
+        }
+    }
+
+    // Returns the position below which all hints of the round were replayed,
+    // if the replay of the oldest segment which isn't done yet has started.
+    // Forgets the segments which were replayed in full before it.
+    std::optional<db::replay_position> replayed_bound() noexcept {
+        std::optional<db::replay_position> bound;
+        while (!_segments.empty()) {
+            auto& seg = _segments.begin()->second;
+            if (!seg.replayed_bound) {
+                break;
+            }
+            bound = seg.replayed_bound;
+            if (!seg.done) {
+                break;
+            }
+            _segments.erase(_segments.begin());
+        }
+        return bound;
+    }
+};
+
+}
+}
@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/print.hh>
 #include "db/system_keyspace.hh"
 #include "db/large_data_handler.hh"
@@ -34,20 +36,83 @@ large_data_handler::large_data_handler(uint64_t partition_threshold_bytes, uint6
         partition_threshold_bytes, row_threshold_bytes, cell_threshold_bytes, rows_count_threshold, _collection_elements_count_threshold);
 }
 
-future<large_data_handler::partition_above_threshold> large_data_handler::maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) {
+large_data_handler::partition_above_threshold large_data_handler::maybe_record_large_partitions(const schema& s, std::string_view sstable_name, const sstables::key& key, uint64_t partition_size, uint64_t rows) {
     assert(running());
     partition_above_threshold above_threshold{partition_size > _partition_threshold_bytes, rows > _rows_count_threshold};
     if (above_threshold.size) [[unlikely]] {
         ++_stats.partitions_bigger_than_threshold;
     }
     if (above_threshold.size || above_threshold.rows) [[unlikely]] {
-        return with_sem([&sst, &key, partition_size, rows, this] {
-            return record_large_partitions(sst, key, partition_size, rows);
-        }).then([above_threshold] {
-            return above_threshold;
+        enqueue(pending_record{record_kind::partition, sst.get_schema(), sst_filename(sst), key, std::nullopt, nullptr, partition_size, rows});
+    }
+    return above_threshold;
+}
+
+bool large_data_handler::maybe_record_large_rows(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, uint64_t row_size) {
+    assert(running());
+    if (row_size > _row_threshold_bytes) [[unlikely]] {
+        enqueue(pending_record{record_kind::row, sst.get_schema(), sst_filename(sst), partition_key,
+                clustering_key ? std::make_optional(*clustering_key) : std::nullopt, nullptr, row_size, 0});
+        return true;
+    }
+    return false;
+}
+
+bool large_data_handler::maybe_record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
+    assert(running());
+    if (cell_size > _cell_threshold_bytes || collection_elements > _collection_elements_count_threshold) [[unlikely]] {
+        enqueue(pending_record{record_kind::cell, sst.get_schema(), sst_filename(sst), partition_key,
+                clustering_key ? std::make_optional(*clustering_key) : std::nullopt, &cdef, cell_size, collection_elements});
+        return true;
+    }
+    return false;
+}
+
+void large_data_handler::enqueue(pending_record r) {
+    if (_pending.size() >= max_pending_records) {
+        ++_stats.records_dropped;
+        large_data_logger.debug("Too many pending large data records, dropping the record of {}/{} in {}",
+                r.schema->ks_name(), r.schema->cf_name(), r.sstable_name);
+        return;
+    }
+    _pending.push_back(std::move(r));
+    if (!_recording) {
+        _recording = true;
+        _recorder = record_pending();
+    }
+}
+
+future<> large_data_handler::record_pending() {
+    while (!_pending.empty()) {
+        auto batch = std::exchange(_pending, {});
+        auto op = _record_barrier.start();
+        co_await max_concurrent_for_each(batch, max_concurrency, [this] (const pending_record& r) {
+            return futurize_invoke([this, &r] {
+                return record(r);
+            }).handle_exception([&r] (std::exception_ptr ep) {
+                large_data_logger.warn("Failed to record large data of {}/{} in {}: {}",
+                        r.schema->ks_name(), r.schema->cf_name(), r.sstable_name, ep);
+            });
         });
     }
-    return make_ready_future<partition_above_threshold>();
+    // Reset synchronously with the check above, so that a record enqueued
+    // from now on starts a new recorder.
+    _recording = false;
+}
+
+future<> large_data_handler::record(const pending_record& r) const {
+    const clustering_key_prefix* ck = r.clustering_key ? &*r.clustering_key : nullptr;
+    switch (r.kind) {
+    case record_kind::partition:
+        return record_large_partitions(*r.schema, r.sstable_name, r.partition_key, r.size, r.count);
+    case record_kind::row:
+        return record_large_rows(*r.schema, r.sstable_name, r.partition_key, ck, r.size);
+    case record_kind::cell:
+        return record_large_cells(*r.schema, r.sstable_name, r.partition_key, ck, *r.cdef, r.size, r.count);
+    }
+    abort();
 }
 
 void large_data_handler::start() {
@@ -56,10 +121,12 @@ void large_data_handler::start() {
 
 future<> large_data_handler::stop() {
     if (!running()) {
-        return make_ready_future<>();
+        co_return;
     }
     _running = false;
-    return _sem.wait(max_concurrency);
+    // Write out whatever records are still pending.
+    co_await std::exchange(_recorder, make_ready_future<>());
+    co_await _sem.wait(max_concurrency);
 }
 
 void large_data_handler::plug_system_keyspace(db::system_keyspace& sys_ks) noexcept {
@@ -89,26 +156,39 @@ future<> large_data_handler::maybe_delete_large_data_entries(sstables::shared_ss
         auto entry = sst->get_large_data_stat(type);
         return entry && entry->above_threshold;
     };
+    const bool large_partitions = above_threshold(ldt::partition_size) || above_threshold(ldt::rows_in_partition);
+    const bool large_rows = above_threshold(ldt::row_size);
+    const bool large_cells = above_threshold(ldt::cell_size) || above_threshold(ldt::elements_in_collection);
+    if (!large_partitions && !large_rows && !large_cells) {
+        co_return;
+    }
+
+    // Records of the sstable which are still pending, or being written,
+    // must not bring its entries back after they are deleted.
+    std::erase_if(_pending, [&] (const pending_record& r) {
+        return r.schema->id() == schema->id() && r.sstable_name == filename;
+    });
+    co_await _record_barrier.advance_and_await();
 
-    future<> large_partitions = make_ready_future<>();
-    if (above_threshold(ldt::partition_size) || above_threshold(ldt::rows_in_partition)) {
-        large_partitions = with_sem([schema, filename, this] () mutable {
+    future<> delete_partitions = make_ready_future<>();
+    if (large_partitions) {
+        delete_partitions = with_sem([schema, filename, this] () mutable {
             return delete_large_data_entries(*schema, std::move(filename), db::system_keyspace::LARGE_PARTITIONS);
         });
     }
-    future<> large_rows = make_ready_future<>();
-    if (above_threshold(ldt::row_size)) {
-        large_rows = with_sem([schema, filename, this] () mutable {
+    future<> delete_rows = make_ready_future<>();
+    if (large_rows) {
+        delete_rows = with_sem([schema, filename, this] () mutable {
             return delete_large_data_entries(*schema, std::move(filename), db::system_keyspace::LARGE_ROWS);
         });
     }
-    future<> large_cells = make_ready_future<>();
-    if (above_threshold(ldt::cell_size) || above_threshold(ldt::elements_in_collection)) {
-        large_cells = with_sem([schema, filename, this] () mutable {
+    future<> delete_cells = make_ready_future<>();
+    if (large_cells) {
+        delete_cells = with_sem([schema, filename, this] () mutable {
             return delete_large_data_entries(*schema, std::move(filename), db::system_keyspace::LARGE_CELLS);
         });
     }
-    return when_all(std::move(large_partitions), std::move(large_rows), std::move(large_cells)).discard_result();
+    co_await when_all(std::move(delete_partitions), std::move(delete_rows), std::move(delete_cells)).discard_result();
 }
 
 cql_table_large_data_handler::cql_table_large_data_handler(gms::feature_service& feat,
@@ -119,13 +199,13 @@ cql_table_large_data_handler::cql_table_large_data_handler(gms::feature_service&
         utils::updateable_value<uint32_t> collection_elements_count_threshold)
     : large_data_handler(partition_threshold_mb() * MB, row_threshold_mb() * MB, cell_threshold_mb() * MB, rows_count_threshold(), collection_elements_count_threshold())
     , _feat(feat)
-    , _record_large_cells([this] (const sstables::sstable& sst, const sstables::key& pk, const clustering_key_prefix* ck, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
-        return internal_record_large_cells(sst, pk, ck, cdef, cell_size, collection_elements);
+    , _record_large_cells([this] (const schema& s, std::string_view sstable_name, const sstables::key& pk, const clustering_key_prefix* ck, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
+        return internal_record_large_cells(s, sstable_name, pk, ck, cdef, cell_size, collection_elements);
     })
     , _feat_listener(_feat.large_collection_detection.when_enabled([this] {
         large_data_logger.debug("Enabled large_collection detection");
-        _record_large_cells = [this] (const sstables::sstable& sst, const sstables::key& pk, const clustering_key_prefix* ck, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
-            return internal_record_large_cells_and_collections(sst, pk, ck, cdef, cell_size, collection_elements);
+        _record_large_cells = [this] (const schema& s, std::string_view sstable_name, const sstables::key& pk, const clustering_key_prefix* ck, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
+            return internal_record_large_cells_and_collections(s, sstable_name, pk, ck, cdef, cell_size, collection_elements);
         };
     }))
     , _partition_threshold_mb_updater(_partition_threshold_bytes, std::move(partition_threshold_mb), [] (uint32_t threshold_mb) { return uint64_t(threshold_mb) * MB; })
@@ -136,7 +216,7 @@ cql_table_large_data_handler::cql_table_large_data_handler(gms::feature_service&
 {}
 
 template <typename... Args>
-future<> cql_table_large_data_handler::try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
+future<> cql_table_large_data_handler::try_record(std::string_view large_table, const schema& s, std::string_view sst_name, const sstables::key& partition_key, int64_t size,
         std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) const {
     if (!_sys_ks) {
         return make_ready_future<>();
@@ -150,10 +230,9 @@ future<> cql_table_large_data_handler::try_record(std::string_view large_table,
     }
     const sstring req = format("INSERT INTO system.large_{}s (keyspace_name, table_name, sstable_name, {}_size, partition_key, compaction_time{}) VALUES (?, ?, ?, ?, ?, ?{}) USING TTL 2592000",
             large_table, large_table, extra_fields_str, extra_values);
-    const schema &s = *sst.get_schema();
     auto ks_name = s.ks_name();
     auto cf_name = s.cf_name();
-    const auto sstable_name = large_data_handler::sst_filename(sst);
+    const auto sstable_name = sstring(sst_name);
     std::string pk_str = key_to_str(partition_key.to_partition_key(s), s);
     auto timestamp = db_clock::now();
     large_data_logger.warn("Writing large {} {}/{}: {}{} ({} bytes) to {}", desc, ks_name, cf_name, pk_str, extra_path, size, sstable_name);
@@ -166,54 +245,51 @@ future<> cql_table_large_data_handler::try_record(std::string_view large_table,
             .finally([ p = _sys_ks ] {});
 }
 
-future<> cql_table_large_data_handler::record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) const {
-    return try_record("partition", sst, key, int64_t(partition_size), "partition", "", {"rows"}, data_value((int64_t)rows));
+future<> cql_table_large_data_handler::record_large_partitions(const schema& s, std::string_view sstable_name, const sstables::key& key, uint64_t partition_size, uint64_t rows) const {
+    return try_record("partition", s, sstable_name, key, int64_t(partition_size), "partition", "", {"rows"}, data_value((int64_t)rows));
 }
 
-future<> cql_table_large_data_handler::record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+future<> cql_table_large_data_handler::record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
         const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const {
-    return _record_large_cells(sst, partition_key, clustering_key, cdef, cell_size, collection_elements);
+    return _record_large_cells(s, sstable_name, partition_key, clustering_key, cdef, cell_size, collection_elements);
 }
 
-future<> cql_table_large_data_handler::internal_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+future<> cql_table_large_data_handler::internal_record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
         const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const {
     auto column_name = cdef.name_as_text();
     std::string_view cell_type = cdef.is_atomic() ? "cell" : "collection";
     static const std::vector<sstring> extra_fields{"clustering_key", "column_name"};
     if (clustering_key) {
-        const schema &s = *sst.get_schema();
         auto ck_str = key_to_str(*clustering_key, s);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name);
+        return try_record("cell", s, sstable_name, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name);
     } else {
         auto desc = format("static {}", cell_type);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name);
+        return try_record("cell", s, sstable_name, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name);
     }
 }
 
-future<> cql_table_large_data_handler::internal_record_large_cells_and_collections(const sstables::sstable& sst, const sstables::key& partition_key,
+future<> cql_table_large_data_handler::internal_record_large_cells_and_collections(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
         const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const {
     auto column_name = cdef.name_as_text();
     std::string_view cell_type = cdef.is_atomic() ? "cell" : "collection";
     static const std::vector<sstring> extra_fields{"clustering_key", "column_name", "collection_elements"};
     if (clustering_key) {
-        const schema &s = *sst.get_schema();
         auto ck_str = key_to_str(*clustering_key, s);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name, data_value((int64_t)collection_elements));
+        return try_record("cell", s, sstable_name, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name, data_value((int64_t)collection_elements));
     } else {
         auto desc = format("static {}", cell_type);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name, data_value((int64_t)collection_elements));
+        return try_record("cell", s, sstable_name, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name, data_value((int64_t)collection_elements));
     }
 }
 
-future<> cql_table_large_data_handler::record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+future<> cql_table_large_data_handler::record_large_rows(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
         const clustering_key_prefix* clustering_key, uint64_t row_size) const {
     static const std::vector<sstring> extra_fields{"clustering_key"};
     if (clustering_key) {
-        const schema &s = *sst.get_schema();
         std::string ck_str = key_to_str(*clustering_key, s);
-        return try_record("row", sst, partition_key, int64_t(row_size), "row", format("/{}", ck_str), extra_fields,  ck_str);
+        return try_record("row", s, sstable_name, partition_key, int64_t(row_size), "row", format("/{}", ck_str), extra_fields,  ck_str);
     } else {
-        return try_record("row", sst, partition_key, int64_t(row_size), "static row", "", extra_fields, data_value::make_null(utf8_type));
+        return try_record("row", s, sstable_name, partition_key, int64_t(row_size), "static row", "", extra_fields, data_value::make_null(utf8_type));
     }
 }
 
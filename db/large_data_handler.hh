@@ -11,12 +11,13 @@
 #include <cstdint>
 #include "schema_fwd.hh"
 #include "system_keyspace.hh"
+#include "sstables/key.hh"
 #include "sstables/shared_sstable.hh"
+#include "utils/phased_barrier.hh"
 #include "utils/updateable_value.hh"
 
 namespace sstables {
 class sstable;
-class key;
 }
 
 namespace db {
@@ -27,6 +28,7 @@ class large_data_handler {
 public:
     struct stats {
         int64_t partitions_bigger_than_threshold = 0; // number of large partition updates exceeding threshold_bytes
+        uint64_t records_dropped = 0; // number of large data records dropped because too many were pending
     };
 
 private:
@@ -52,6 +54,37 @@ class large_data_handler {
         });
     }
 
+    // Large data records are not written while the sstable is being written,
+    // which would slow down flushes and compaction of tables with many large
+    // partitions. Instead, they are queued and written in the background in
+    // batches of up to max_pending_records. When the queue is full, further
+    // records are dropped and counted in stats::records_dropped rather than
+    // having the writer wait.
+    static constexpr size_t max_pending_records = 1024;
+
+    enum class record_kind { partition, row, cell };
+
+    struct pending_record {
+        record_kind kind;
+        schema_ptr schema;
+        sstring sstable_name;
+        sstables::key partition_key;
+        std::optional<clustering_key_prefix> clustering_key;
+        const column_definition* cdef = nullptr; // owned by schema
+        uint64_t size;
+        uint64_t count; // rows for partitions, elements for cells
+    };
+
+    std::vector<pending_record> _pending;
+    bool _recording = false;
+    future<> _recorder = make_ready_future<>();
+    // Every batch of records being written is an operation.
+    utils::phased_barrier _record_barrier;
+
+    void enqueue(pending_record r);
+    future<> record_pending();
+    future<> record(const pending_record& r) const;
+
     bool _running = false;
 
 protected:
@@ -76,37 +109,19 @@ class large_data_handler {
     void start();
     future<> stop();
 
-    future<bool> maybe_record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, uint64_t row_size) {
-        assert(running());
-        if (__builtin_expect(row_size > _row_threshold_bytes, false)) {
-            return with_sem([&sst, &partition_key, clustering_key, row_size, this] {
-                return record_large_rows(sst, partition_key, clustering_key, row_size);
-            }).then([] {
-                return true;
-            });
-        }
-        return make_ready_future<bool>(false);
-    }
+    // The maybe_record_*() functions return whether the thresholds were
+    // exceeded. Exceeding records are written in the background.
+    bool maybe_record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, uint64_t row_size);
 
     struct partition_above_threshold {
         bool size = false;
         bool rows = false;
     };
-    future<partition_above_threshold> maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows);
-
-    future<bool> maybe_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
-        assert(running());
-        if (__builtin_expect(cell_size > _cell_threshold_bytes || collection_elements > _collection_elements_count_threshold, false)) {
-            return with_sem([&sst, &partition_key, clustering_key, &cdef, cell_size, collection_elements, this] {
-                return record_large_cells(sst, partition_key, clustering_key, cdef, cell_size, collection_elements);
-            }).then([] {
-                return true;
-            });
-        }
-        return make_ready_future<bool>(false);
-    }
+    partition_above_threshold maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows);
+
+    bool maybe_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements);
 
     future<> maybe_delete_large_data_entries(sstables::shared_sstable sst);
 
@@ -134,16 +149,16 @@ class large_data_handler {
     void unplug_system_keyspace() noexcept;
 
 protected:
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+    virtual future<> record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const = 0;
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) const = 0;
+    virtual future<> record_large_rows(const schema& s, std::string_view sstable_name, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) const = 0;
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const = 0;
-    virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const = 0;
+    virtual future<> record_large_partitions(const schema& s, std::string_view sstable_name, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const = 0;
 };
 
 class cql_table_large_data_handler : public large_data_handler {
     gms::feature_service& _feat;
-    std::function<future<> (const sstables::sstable& sst, const sstables::key& partition_key,
+    std::function<future<> (const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements)> _record_large_cells;
     std::optional<std::any> _feat_listener;
 
@@ -164,28 +179,28 @@ class cql_table_large_data_handler : public large_data_handler {
             utils::updateable_value<uint32_t> collection_elements_count_threshold);
 
 protected:
-    virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override;
+    virtual future<> record_large_partitions(const schema& s, std::string_view sstable_name, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override;
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const override;
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+    virtual future<> record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const override;
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) const override;
+    virtual future<> record_large_rows(const schema& s, std::string_view sstable_name, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) const override;
 
 private:
-    future<> internal_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+    future<> internal_record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const;
-    future<> internal_record_large_cells_and_collections(const sstables::sstable& sst, const sstables::key& partition_key,
+    future<> internal_record_large_cells_and_collections(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const;
 
 private:
     template <typename... Args>
-    future<> try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
+    future<> try_record(std::string_view large_table, const schema& s, std::string_view sstable_name, const sstables::key& partition_key, int64_t size,
             std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) const;
 };
 
 class nop_large_data_handler : public large_data_handler {
 public:
     nop_large_data_handler();
-    virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override {
+    virtual future<> record_large_partitions(const schema& s, std::string_view sstable_name, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override {
         return make_ready_future<>();
     }
 
@@ -193,12 +208,12 @@ class nop_large_data_handler : public large_data_handler {
         return make_ready_future<>();
     }
 
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+    virtual future<> record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
         const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const override {
         return make_ready_future<>();
     }
 
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+    virtual future<> record_large_rows(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, uint64_t row_size) const override {
         return make_ready_future<>();
     }
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <algorithm>
 #include <cmath>
 #include <numbers>
 #include <array>
@@ -39,6 +40,13 @@
 // time window. This strategy is also known as "lossy counting".
 //
 // Both mechanisms 1) and 2) are implemented in a lazy manner.
+//
+// Coordinators which are not replicas for an operation leave the decision
+// to replicas, which costs the replicas some work even if the operation
+// is rejected. To avoid that for partitions which are being rate limited,
+// the coordinator remembers how often replicas rejected operations on them
+// in the last time window and rejects that fraction of operations itself.
+// The operations it still sends to replicas keep the estimate up to date.
 
 namespace db {
 
@@ -46,6 +54,14 @@ static constexpr size_t hash_bits = 16;
 static constexpr size_t entry_count = 1 << hash_bits;
 static constexpr size_t bucket_size = 10000;
 
+static constexpr size_t feedback_hash_bits = 12;
+static constexpr size_t feedback_entry_count = 1 << feedback_hash_bits;
+
+// Always leave some operations for replicas to decide about, otherwise
+// the coordinator would stop learning whether the partition is still
+// over the limit.
+static constexpr float max_early_rejection = 0.9f;
+
 
 void rate_limiter_base::on_timer() noexcept {
     _time_window_history.pop_back();
@@ -59,6 +75,7 @@ void rate_limiter_base::on_timer() noexcept {
     _current_entries_in_time_window = 0;
 
     _current_time_window = (_current_time_window + 1) % (1 << time_window_bits);
+    ++_feedback_time_window;
 
     // Because time window ids are 12 bit numbers and we increase the current
     // time window number by 1 every second, it wraps around every 4096
@@ -192,6 +209,49 @@ bool rate_limiter_base::entry_is_empty(const rate_limiter_base::entry& b) noexce
     return b.op_count <= _current_bucket;
 }
 
+uint32_t rate_limiter_base::get_label_id(label& l) noexcept {
+    // Assign a label if not done yet
+    if (l._label == 0) {
+        l._label = _next_label++;
+    }
+    return l._label;
+}
+
+rate_limiter_base::feedback_entry& rate_limiter_base::get_feedback_entry(uint32_t label, uint64_t token) noexcept {
+    feedback_entry& e = _feedback[compute_hash(label, token) % feedback_entry_count];
+    feedback_entry_refresh(e);
+    return e;
+}
+
+void rate_limiter_base::feedback_entry_refresh(rate_limiter_base::feedback_entry& e) noexcept {
+    const uint32_t window_delta = _feedback_time_window - e.time_window;
+    if (window_delta == 0) {
+        return;
+    }
+
+    if (window_delta == 1 && e.complete_window) {
+        if (e.rejected == 0) {
+            e.early_rejection /= 2;
+        } else {
+            // Replicas rejected a fraction `q` of the operations which were
+            // not rejected early, so in total a fraction 1 - (1 - q)(1 - p)
+            // of the operations was over the limit.
+            const float q = std::min(1.0f, float(e.rejected) / float(std::max(e.forwarded, 1u)));
+            e.early_rejection = std::min(max_early_rejection, 1.0f - (1.0f - q) * (1.0f - e.early_rejection));
+        }
+    } else {
+        // Either the entry was allocated in the middle of the previous
+        // time window, so its counts don't tell the rejection rate yet,
+        // or it wasn't used for a while and the counts are outdated.
+        e.early_rejection = 0;
+    }
+
+    e.forwarded = 0;
+    e.rejected = 0;
+    e.complete_window = true;
+    e.time_window = _feedback_time_window;
+}
+
 void rate_limiter_base::register_metrics() {
     namespace sm = seastar::metrics;
 
@@ -211,6 +271,12 @@ void rate_limiter_base::register_metrics() {
         sm::make_counter("probe_count", _metrics.probe_count,
                 sm::description("Number of probes made during lookups.")),
 
+        sm::make_counter("early_rejections", _metrics.early_rejections,
+                sm::description("Number of operations rejected by the coordinator because replicas were recently rejecting operations on the partition.")),
+
+        sm::make_counter("failed_feedback_allocations", _metrics.failed_feedback_allocations,
+                sm::description("Number of replica rejections which could not be remembered by the coordinator.")),
+
         sm::make_gauge("load_factor", [&] {
                     uint32_t occupied_entry_count = _current_entries_in_time_window;
                     for (const auto& twe : _time_window_history) {
@@ -225,18 +291,14 @@ void rate_limiter_base::register_metrics() {
 rate_limiter_base::rate_limiter_base()
         : _salt(std::random_device{}())
         , _entries(entry_count)
-        , _time_window_history(op_count_bits - 1) {
+        , _time_window_history(op_count_bits - 1)
+        , _feedback(feedback_entry_count) {
     
     register_metrics();
 }
 
 uint64_t rate_limiter_base::increase_and_get_counter(label& l, uint64_t token) noexcept {
-    // Assign a label if not done yet
-    if (l._label == 0) {
-        l._label = _next_label++;
-    }
-
-    entry* b = get_entry(l._label, token);
+    entry* b = get_entry(get_label_id(l), token);
     if (!b) {
         // We failed to allocate a entry for this partition. This means that
         // we won't track hit count for this partition during this time window.
@@ -300,6 +362,46 @@ rate_limiter_base::can_proceed rate_limiter_base::account_operation(
     }
 }
 
+rate_limiter_base::can_proceed rate_limiter_base::check_replica_feedback(
+        label& l, uint64_t token,
+        const db::per_partition_rate_limit::account_and_enforce& rate_limit_info) noexcept {
+
+    if (l._label == 0) {
+        // Nothing was ever rejected for this label
+        return can_proceed::yes;
+    }
+
+    feedback_entry& e = get_feedback_entry(l._label, token);
+    if (e.token != token || e.label != l._label) {
+        return can_proceed::yes;
+    }
+
+    if (rate_limit_info.get_random_variable_as_double() >= 1.0 - e.early_rejection) {
+        ++_metrics.early_rejections;
+        return can_proceed::no;
+    }
+    ++e.forwarded;
+    return can_proceed::yes;
+}
+
+void rate_limiter_base::on_rejected_by_replicas(label& l, uint64_t token) noexcept {
+    const uint32_t label = get_label_id(l);
+    feedback_entry& e = get_feedback_entry(label, token);
+    if (e.token != token || e.label != label) {
+        if (e.early_rejection > 0 || e.rejected > 0) {
+            // Don't evict a partition which is being rate limited right now
+            ++_metrics.failed_feedback_allocations;
+            return;
+        }
+        e = feedback_entry{
+            .token = token,
+            .label = label,
+            .time_window = _feedback_time_window,
+        };
+    }
+    ++e.rejected;
+}
+
 template class generic_rate_limiter<seastar::lowres_clock>;
 
 }
@@ -43,6 +43,8 @@ class rate_limiter_base {
         uint64_t successful_lookups = 0;
         uint64_t failed_allocations = 0;
         uint64_t probe_count = 0;
+        uint64_t early_rejections = 0;
+        uint64_t failed_feedback_allocations = 0;
     };
 
     // Represents a piece of the hashmap storage.
@@ -77,6 +79,28 @@ class rate_limiter_base {
         uint32_t lossy_counting_decrease = 0;
     };
 
+    // Remembers how often replicas rejected operations on a partition which
+    // were sent to them with account_and_enforce, i.e. by a coordinator
+    // which is not a replica. Kept in a small direct-mapped table, so only
+    // the partitions which are being rejected right now fit there.
+    struct feedback_entry {
+        uint64_t token = 0;
+        uint32_t label = 0;
+        uint32_t time_window = 0;
+
+        // Operations sent to replicas and operations rejected by them
+        // within the time window.
+        uint32_t forwarded = 0;
+        uint32_t rejected = 0;
+
+        // Whether the counts above cover the whole time window.
+        bool complete_window = false;
+
+        // The probability with which the coordinator rejects operations
+        // on this partition without sending them to replicas.
+        float early_rejection = 0;
+    };
+
 public:
     struct can_proceed_tag{};
     using can_proceed = seastar::bool_class<can_proceed_tag>;
@@ -106,6 +130,9 @@ class rate_limiter_base {
     utils::chunked_vector<entry> _entries;
     std::vector<time_window_entry> _time_window_history;
 
+    uint32_t _feedback_time_window = 0;
+    std::vector<feedback_entry> _feedback;
+
     metrics _metrics;
     seastar::metrics::metric_groups _metric_group;
 
@@ -116,6 +143,10 @@ class rate_limiter_base {
     void entry_refresh(entry& b) noexcept;
     bool entry_is_empty(const entry& b) noexcept;
 
+    uint32_t get_label_id(label& l) noexcept;
+    feedback_entry& get_feedback_entry(uint32_t label, uint64_t token) noexcept;
+    void feedback_entry_refresh(feedback_entry& e) noexcept;
+
     void register_metrics();
 
 protected:
@@ -147,6 +178,21 @@ class rate_limiter_base {
     // only `limit` operations per second are admitted.
     can_proceed account_operation(label& l, uint64_t token, uint64_t limit,
             const db::per_partition_rate_limit::info& rate_limit_info) noexcept;
+
+    // Used by a coordinator which is not a replica for the operation, before
+    // sending it to replicas with `rate_limit_info`.
+    //
+    // If replicas have recently been rejecting operations for given
+    // (label, token), returns can_proceed::no with a probability that
+    // approximates the fraction of operations replicas would reject, so that
+    // they don't have to be sent at all. Operations with a high random
+    // variable are rejected first, as replicas reject those first too.
+    can_proceed check_replica_feedback(label& l, uint64_t token,
+            const db::per_partition_rate_limit::account_and_enforce& rate_limit_info) noexcept;
+
+    // Records that replicas rejected an operation for given (label, token)
+    // which was let through by `check_replica_feedback()`.
+    void on_rejected_by_replicas(label& l, uint64_t token) noexcept;
 };
 
 template<typename ClockType>
@@ -45,6 +45,7 @@
 #include <seastar/rpc/rpc_types.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/range/algorithm/copy.hpp>
@@ -75,6 +76,7 @@
 #include "cql3/column_identifier.hh"
 #include "cql3/column_specification.hh"
 #include "types.hh"
+#include "utils/stall_attribution.hh"
 
 using namespace db;
 using namespace std::chrono_literals;
@@ -979,13 +981,77 @@ static table_id table_id_from_mutations(const schema_mutations& sm) {
     return table_id(table_row.get_nonnull<utils::UUID>("id"));
 }
 
+// Names of the tables and views whose definitions are touched by a set of schema
+// mutations, per keyspace. A disengaged optional means any table of that keyspace
+// may be affected (e.g. a partition tombstone from DROP KEYSPACE), so all of them
+// have to be diffed.
+using affected_tables_map = std::map<sstring, std::optional<std::set<sstring>>>;
+
+static bool is_per_table_schema_table(const sstring& cf_name) {
+    static const std::unordered_set<sstring> names = {
+        TABLES, VIEWS, COLUMNS, VIEW_VIRTUAL_COLUMNS, COMPUTED_COLUMNS, DROPPED_COLUMNS, INDEXES, SCYLLA_TABLES,
+    };
+    return names.contains(cf_name);
+}
+
+// The first clustering column of every per-table schema table is the table name.
+static sstring table_name_of(const schema& s, const clustering_key_prefix& ck) {
+    return value_cast<sstring>(utf8_type->deserialize(ck.get_component(s, 0)));
+}
+
+static void collect_affected_tables(affected_tables_map& affected, const sstring& keyspace_name, const mutation& m) {
+    auto& names = affected.try_emplace(keyspace_name, std::set<sstring>()).first->second;
+    if (!names) {
+        return;
+    }
+    if (!is_per_table_schema_table(m.schema()->cf_name())) {
+        return;
+    }
+    const schema& s = *m.schema();
+    const auto& mp = m.partition();
+    if (mp.partition_tombstone() || !mp.static_row().empty()) {
+        names = std::nullopt;
+        return;
+    }
+    for (const rows_entry& e : mp.non_dummy_rows()) {
+        names->insert(table_name_of(s, e.key()));
+    }
+    for (const range_tombstone_entry& rte : mp.row_tombstones()) {
+        const range_tombstone& rt = rte.tombstone();
+        if (rt.start.is_empty(s) || rt.end.is_empty(s)) {
+            names = std::nullopt;
+            return;
+        }
+        auto start_name = table_name_of(s, rt.start);
+        if (start_name != table_name_of(s, rt.end)) {
+            names = std::nullopt;
+            return;
+        }
+        names->insert(std::move(start_name));
+    }
+}
+
 static
 future<std::map<table_id, schema_mutations>>
-read_tables_for_keyspaces(distributed<service::storage_proxy>& proxy, const std::set<sstring>& keyspace_names, schema_ptr s)
+read_tables_for_keyspaces(distributed<service::storage_proxy>& proxy, const std::set<sstring>& keyspace_names, schema_ptr s,
+        const affected_tables_map* affected = nullptr)
 {
     std::map<table_id, schema_mutations> result;
     for (auto&& keyspace_name : keyspace_names) {
+        const std::set<sstring>* only = nullptr;
+        if (affected) {
+            auto it = affected->find(keyspace_name);
+            if (it != affected->end() && it->second) {
+                only = &*it->second;
+                if (only->empty()) {
+                    continue;
+                }
+            }
+        }
         for (auto&& table_name : co_await read_table_names_of_keyspace(proxy, keyspace_name, s)) {
+            if (only && !only->contains(table_name)) {
+                continue;
+            }
             auto qn = qualified_name(keyspace_name, table_name);
             auto muts = co_await read_table_mutations(proxy, qn, s);
             auto id = table_id_from_mutations(muts);
@@ -1094,8 +1160,14 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std:
     // compare before/after schemas of the affected keyspaces only
     std::set<sstring> keyspaces;
     std::set<table_id> column_families;
+    // Within those keyspaces, diff only the tables and views the mutations touch.
+    // Tables not mentioned by any mutation can't change, and re-reading and
+    // comparing all of them makes every DDL cost O(tables in keyspace).
+    affected_tables_map affected_tables;
     for (auto&& mutation : mutations) {
-        keyspaces.emplace(value_cast<sstring>(utf8_type->deserialize(mutation.key().get_component(*s, 0))));
+        auto keyspace_name = value_cast<sstring>(utf8_type->deserialize(mutation.key().get_component(*s, 0)));
+        collect_affected_tables(affected_tables, keyspace_name, mutation);
+        keyspaces.emplace(std::move(keyspace_name));
         column_families.emplace(mutation.column_family_id());
         // We must force recalculation of schema version after the merge, since the resulting
         // schema may be a mix of the old and new schemas.
@@ -1104,9 +1176,9 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std:
 
     // current state of the schema
     auto&& old_keyspaces = co_await read_schema_for_keyspaces(proxy, KEYSPACES, keyspaces);
-    auto&& old_column_families = co_await read_tables_for_keyspaces(proxy, keyspaces, tables());
+    auto&& old_column_families = co_await read_tables_for_keyspaces(proxy, keyspaces, tables(), &affected_tables);
     auto&& old_types = co_await read_schema_for_keyspaces(proxy, TYPES, keyspaces);
-    auto&& old_views = co_await read_tables_for_keyspaces(proxy, keyspaces, views());
+    auto&& old_views = co_await read_tables_for_keyspaces(proxy, keyspaces, views(), &affected_tables);
     auto old_functions = co_await read_schema_for_keyspaces(proxy, FUNCTIONS, keyspaces);
     auto old_aggregates = co_await read_schema_for_keyspaces(proxy, AGGREGATES, keyspaces);
     auto old_scylla_aggregates = co_await read_schema_for_keyspaces(proxy, SCYLLA_AGGREGATES, keyspaces);
@@ -1126,9 +1198,9 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std:
 
     // with new data applied
     auto&& new_keyspaces = co_await read_schema_for_keyspaces(proxy, KEYSPACES, keyspaces);
-    auto&& new_column_families = co_await read_tables_for_keyspaces(proxy, keyspaces, tables());
+    auto&& new_column_families = co_await read_tables_for_keyspaces(proxy, keyspaces, tables(), &affected_tables);
     auto&& new_types = co_await read_schema_for_keyspaces(proxy, TYPES, keyspaces);
-    auto&& new_views = co_await read_tables_for_keyspaces(proxy, keyspaces, views());
+    auto&& new_views = co_await read_tables_for_keyspaces(proxy, keyspaces, views(), &affected_tables);
     auto new_functions = co_await read_schema_for_keyspaces(proxy, FUNCTIONS, keyspaces);
     auto new_aggregates = co_await read_schema_for_keyspaces(proxy, AGGREGATES, keyspaces);
     auto new_scylla_aggregates = co_await read_schema_for_keyspaces(proxy, SCYLLA_AGGREGATES, keyspaces);
@@ -1241,30 +1313,47 @@ enum class schema_diff_side {
     right, // new, after
 };
 
-static schema_diff diff_table_or_view(distributed<service::storage_proxy>& proxy,
+// Creating schema objects is expensive, and a diff can span many tables (e.g.
+// when a whole keyspace is pulled), so yield between entries. Nothing is
+// published here, so deferring doesn't break the atomicity of the merge.
+static future<schema_diff> diff_table_or_view(distributed<service::storage_proxy>& proxy,
     std::map<table_id, schema_mutations>&& before,
     std::map<table_id, schema_mutations>&& after,
     noncopyable_function<schema_ptr (schema_mutations sm, schema_diff_side)> create_schema)
 {
+    using stall_scope = utils::stall_attribution::scope;
+    constexpr auto op = utils::stall_attribution::operation::schema_merge;
     schema_diff d;
     auto diff = difference(before, after);
     for (auto&& key : diff.entries_only_on_left) {
-        auto&& s = proxy.local().get_db().local().find_schema(key);
-        slogger.info("Dropping {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
-        d.dropped.emplace_back(schema_diff::dropped_schema{s});
+        {
+            stall_scope scope(op);
+            auto&& s = proxy.local().get_db().local().find_schema(key);
+            slogger.info("Dropping {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
+            d.dropped.emplace_back(schema_diff::dropped_schema{s});
+        }
+        co_await coroutine::maybe_yield();
     }
     for (auto&& key : diff.entries_only_on_right) {
-        auto s = create_schema(std::move(after.at(key)), schema_diff_side::right);
-        slogger.info("Creating {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
-        d.created.emplace_back(s);
+        {
+            stall_scope scope(op);
+            auto s = create_schema(std::move(after.at(key)), schema_diff_side::right);
+            slogger.info("Creating {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
+            d.created.emplace_back(s);
+        }
+        co_await coroutine::maybe_yield();
     }
     for (auto&& key : diff.entries_differing) {
-        auto s_before = create_schema(std::move(before.at(key)), schema_diff_side::left);
-        auto s = create_schema(std::move(after.at(key)), schema_diff_side::right);
-        slogger.info("Altering {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
-        d.altered.emplace_back(schema_diff::altered_schema{s_before, s});
+        {
+            stall_scope scope(op);
+            auto s_before = create_schema(std::move(before.at(key)), schema_diff_side::left);
+            auto s = create_schema(std::move(after.at(key)), schema_diff_side::right);
+            slogger.info("Altering {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
+            d.altered.emplace_back(schema_diff::altered_schema{s_before, s});
+        }
+        co_await coroutine::maybe_yield();
     }
-    return d;
+    co_return d;
 }
 
 // see the comments for merge_keyspaces()
@@ -1278,10 +1367,10 @@ static future<> merge_tables_and_views(distributed<service::storage_proxy>& prox
     std::map<table_id, schema_mutations>&& views_before,
     std::map<table_id, schema_mutations>&& views_after)
 {
-    auto tables_diff = diff_table_or_view(proxy, std::move(tables_before), std::move(tables_after), [&] (schema_mutations sm, schema_diff_side) {
+    auto tables_diff = co_await diff_table_or_view(proxy, std::move(tables_before), std::move(tables_after), [&] (schema_mutations sm, schema_diff_side) {
         return create_table_from_mutations(proxy, std::move(sm));
     });
-    auto views_diff = diff_table_or_view(proxy, std::move(views_before), std::move(views_after), [&] (schema_mutations sm, schema_diff_side side) {
+    auto views_diff = co_await diff_table_or_view(proxy, std::move(views_before), std::move(views_after), [&] (schema_mutations sm, schema_diff_side side) {
         // The view schema mutation should be created with reference to the base table schema because we definitely know it by now.
         // If we don't do it we are leaving a window where write commands to this schema are illegal.
         // There are 3 possibilities:
@@ -1449,6 +1538,7 @@ struct row_diff {
 // A row is identified by its primary key.
 // In the output, all entries of a given keyspace are together.
 static row_diff diff_rows(const schema_result& before, const schema_result& after) {
+    utils::stall_attribution::scope stall_scope(utils::stall_attribution::operation::schema_merge);
     auto diff = difference(before, after, indirect_equal_to<lw_shared_ptr<query::result_set>>());
 
     // For new or empty keyspaces, just record each row.
@@ -2047,11 +2137,13 @@ make_list_mutation(const std::vector<T, Args...>& values,
         m.tomb.timestamp = timestamp - 1;
         m.tomb.deletion_time = gc_clock::now();
 
+        std::vector<utils::UUID> uuids(values.size());
+        utils::UUID_gen::get_time_UUIDs(uuids);
+        auto uuid = uuids.begin();
         for (auto&& value : values) {
             auto dv = f(value);
-            auto uuid = utils::UUID_gen::get_time_UUID_bytes();
             m.cells.emplace_back(
-                bytes(reinterpret_cast<const int8_t*>(uuid.data()), uuid.size()),
+                (uuid++)->serialize(),
                 atomic_cell::make_live(*vtyp, timestamp, vtyp->decompose(std::move(dv)), atomic_cell::collection_member::yes));
         }
 
@@ -54,6 +54,7 @@
 #include "index/built_indexes_virtual_reader.hh"
 #include "utils/generation-number.hh"
 #include "db/virtual_table.hh"
+#include "db/data_listeners.hh"
 #include "service/storage_service.hh"
 #include "gms/gossiper.hh"
 #include "service/paxos/paxos_state.hh"
@@ -147,6 +148,10 @@ schema_ptr system_keyspace::batchlog() {
         //    .compactionStrategyOptions(Collections.singletonMap("min_threshold", "2"))
        );
        builder.set_gc_grace_seconds(0);
+       // Batches are usually removed soon after they are written, while both the
+       // batch and its tombstone are still in the memtable. Such partitions are
+       // then dropped on flush, instead of reaching sstables and compaction.
+       builder.set_purge_dead_partitions_on_flush(true);
        builder.with_version(generate_schema_version(builder.uuid()));
        return builder.build(schema_builder::compact_storage::no);
     }();
@@ -154,6 +159,7 @@ schema_ptr system_keyspace::batchlog() {
 }
 
 /*static*/ schema_ptr system_keyspace::paxos() {
+    constexpr uint16_t schema_version_offset = 1; // leveled compaction
     static thread_local auto paxos = [] {
         // FIXME: switch to the new schema_builder interface (with_column(...), etc)
         schema_builder builder(generate_legacy_id(NAME, PAXOS), NAME, PAXOS,
@@ -175,12 +181,19 @@ schema_ptr system_keyspace::batchlog() {
         utf8_type,
         // comment
         "in-progress paxos proposals"
-        // FIXME: the original Java code also had:
-        // operations on resulting CFMetaData:
-        //    .compactionStrategyClass(LeveledCompactionStrategy.class);
        );
        builder.set_gc_grace_seconds(0);
-       builder.with_version(generate_schema_version(builder.uuid()));
+       // Every CAS reads the state of its key before overwriting it, and learning
+       // a decision, as well as pruning it, leaves tombstones behind. Leveled
+       // compaction bounds the number of sstables such reads have to merge, and
+       // a low tombstone threshold makes it purge pruned and expired state
+       // without waiting for the sstables to move up a level.
+       builder.set_compaction_strategy(sstables::compaction_strategy_type::leveled);
+       builder.set_compaction_strategy_options({
+           { "tombstone_threshold", "0.1" },
+           { "tombstone_compaction_interval", "3600" },
+       });
+       builder.with_version(generate_schema_version(builder.uuid(), schema_version_offset));
        builder.set_wait_for_sync_to_commitlog(true);
        return builder.build(schema_builder::compact_storage::no);
     }();
@@ -2390,6 +2403,147 @@ class runtime_info_table : public memtable_filling_virtual_table {
     }
 };
 
+class hot_partitions_table : public memtable_filling_virtual_table {
+private:
+    distributed<replica::database>& _db;
+
+    struct hot_partition {
+        sstring keyspace_name;
+        sstring table_name;
+        sstring operation;
+        sstring partition_key;
+        int64_t count;
+        int64_t error;
+    };
+public:
+    explicit hot_partitions_table(distributed<replica::database>& db)
+        : memtable_filling_virtual_table(build_schema())
+        , _db(db) {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "hot_partitions");
+        return schema_builder(system_keyspace::NAME, "hot_partitions", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("operation", utf8_type, column_kind::clustering_key)
+            .with_column("partition_key", utf8_type, column_kind::clustering_key)
+            .with_column("count", long_type)
+            .with_column("error", long_type)
+            .set_comment("Lists the most read and written partitions of this node in the last minute, estimated from sampled operations.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        // Each shard tracks the partitions it owns, so the lists don't overlap.
+        auto hot_partitions = co_await _db.map_reduce0([] (replica::database& db) {
+            std::vector<hot_partition> ret;
+            auto& last_window = db.hot_partitions().last_window();
+            for (auto [operation, top] : {std::pair("read", &last_window.read), std::pair("write", &last_window.write)}) {
+                for (auto& e : *top) {
+                    ret.push_back(hot_partition{e.item.schema->ks_name(), e.item.schema->cf_name(), operation, sstring(e.item), e.count, e.error});
+                }
+            }
+            return ret;
+        }, std::vector<hot_partition>(), [] (std::vector<hot_partition> a, std::vector<hot_partition> b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        });
+
+        std::map<sstring, std::vector<hot_partition>> by_keyspace;
+        for (auto& hp : hot_partitions) {
+            by_keyspace[hp.keyspace_name].push_back(std::move(hp));
+        }
+        for (auto& [keyspace_name, partitions] : by_keyspace) {
+            auto dk = dht::decorate_key(*_s, partition_key::from_single_value(*schema(), data_value(keyspace_name).serialize_nonnull()));
+            if (!this_shard_owns(dk)) {
+                continue;
+            }
+            mutation m(schema(), std::move(dk));
+            for (auto& hp : partitions) {
+                auto ck = clustering_key::from_exploded(*schema(), {
+                    data_value(hp.table_name).serialize_nonnull(),
+                    data_value(hp.operation).serialize_nonnull(),
+                    data_value(hp.partition_key).serialize_nonnull(),
+                });
+                row& cr = m.partition().clustered_row(*schema(), std::move(ck)).cells();
+                set_cell(cr, "count", hp.count);
+                set_cell(cr, "error", hp.error);
+            }
+            mutation_sink(std::move(m));
+        }
+    }
+};
+
+class prepared_statements_stats_table : public memtable_filling_virtual_table {
+private:
+    sharded<cql3::query_processor>& _qp;
+
+    using stats_map = cql3::prepared_statement_stats::map_type;
+public:
+    explicit prepared_statements_stats_table(sharded<cql3::query_processor>& qp)
+        : memtable_filling_virtual_table(build_schema())
+        , _qp(qp) {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "prepared_statements_stats");
+        return schema_builder(system_keyspace::NAME, "prepared_statements_stats", std::make_optional(id))
+            .with_column("prepared_id", bytes_type, column_kind::partition_key)
+            .with_column("query_string", utf8_type)
+            .with_column("calls", long_type)
+            .with_column("errors", long_type)
+            .with_column("total_latency_us", long_type)
+            .with_column("mean_latency_us", long_type)
+            .with_column("p50_latency_us", long_type)
+            .with_column("p99_latency_us", long_type)
+            .with_column("max_latency_us", long_type)
+            .set_comment("Execution statistics of the prepared statements executed on this node, summed over all shards.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        // Statements are prepared on every shard, so the shards' entries are merged.
+        auto stats = co_await _qp.map_reduce0([] (cql3::query_processor& qp) {
+            return qp.get_prepared_statement_stats().entries();
+        }, stats_map(), [] (stats_map a, const stats_map& b) {
+            for (auto& [key, e] : b) {
+                auto [it, inserted] = a.try_emplace(key, e);
+                if (!inserted) {
+                    it->second.merge(e);
+                }
+            }
+            return a;
+        });
+
+        for (auto& [key, e] : stats) {
+            auto id = cql3::prepared_cache_key_type::cql_id(key);
+            if (id.empty()) {
+                id = serialized(cql3::prepared_cache_key_type::thrift_id(key));
+            }
+            auto dk = dht::decorate_key(*_s, partition_key::from_single_value(*schema(), std::move(id)));
+            if (!this_shard_owns(dk)) {
+                continue;
+            }
+            mutation m(schema(), std::move(dk));
+            row& cr = m.partition().clustered_row(*schema(), clustering_key::make_empty()).cells();
+            set_cell(cr, "query_string", e.query_string);
+            set_cell(cr, "calls", int64_t(e.calls));
+            set_cell(cr, "errors", int64_t(e.errors));
+            set_cell(cr, "total_latency_us", int64_t(e.total_latency.count()));
+            set_cell(cr, "mean_latency_us", int64_t(e.calls ? e.total_latency.count() / e.calls : 0));
+            set_cell(cr, "p50_latency_us", int64_t(e.latency.quantile(0.5)));
+            set_cell(cr, "p99_latency_us", int64_t(e.latency.quantile(0.99)));
+            set_cell(cr, "max_latency_us", int64_t(e.latency.max()));
+            mutation_sink(std::move(m));
+        }
+    }
+};
+
 class versions_table : public memtable_filling_virtual_table {
 public:
     explicit versions_table()
@@ -2542,7 +2696,9 @@ class clients_table : public streaming_virtual_table {
             .with_column("ssl_enabled", boolean_type)
             .with_column("ssl_protocol", utf8_type)
             .with_column("username", utf8_type)
-            .with_version(system_keyspace::generate_schema_version(id))
+            .with_column("routable_requests", long_type)
+            .with_column("misrouted_requests", long_type)
+            .with_version(system_keyspace::generate_schema_version(id, 1))
             .build();
     }
 
@@ -2648,6 +2804,12 @@ class clients_table : public streaming_virtual_table {
                     set_cell(cr.cells(), "ssl_protocol", *cd.ssl_protocol);
                 }
                 set_cell(cr.cells(), "username", cd.username ? *cd.username : sstring("anonymous"));
+                if (cd.routable_requests) {
+                    set_cell(cr.cells(), "routable_requests", *cd.routable_requests);
+                }
+                if (cd.misrouted_requests) {
+                    set_cell(cr.cells(), "misrouted_requests", *cd.misrouted_requests);
+                }
                 co_await result.emit_row(std::move(cr));
             }
             co_await result.emit_partition_end();
@@ -2666,7 +2828,8 @@ class clients_table : public streaming_virtual_table {
 // Map from table's schema ID to table itself. Helps avoiding accidental duplication.
 static thread_local std::map<table_id, std::unique_ptr<virtual_table>> virtual_tables;
 
-void register_virtual_tables(distributed<replica::database>& dist_db, distributed<service::storage_service>& dist_ss, sharded<gms::gossiper>& dist_gossiper, db::config& cfg) {
+void register_virtual_tables(distributed<replica::database>& dist_db, distributed<service::storage_service>& dist_ss, sharded<gms::gossiper>& dist_gossiper,
+        sharded<cql3::query_processor>& dist_qp, db::config& cfg) {
     auto add_table = [] (std::unique_ptr<virtual_table>&& tbl) {
         virtual_tables[tbl->schema()->id()] = std::move(tbl);
     };
@@ -2682,6 +2845,8 @@ void register_virtual_tables(distributed<replica::database>& dist_db, distribute
     add_table(std::make_unique<protocol_servers_table>(ss));
     add_table(std::make_unique<runtime_info_table>(dist_db, ss));
     add_table(std::make_unique<versions_table>());
+    add_table(std::make_unique<hot_partitions_table>(dist_db));
+    add_table(std::make_unique<prepared_statements_stats_table>(dist_qp));
     add_table(std::make_unique<db_config_table>(cfg));
     add_table(std::make_unique<clients_table>(ss));
 }
@@ -2743,7 +2908,7 @@ static bool maybe_write_in_user_memory(schema_ptr s) {
 
 future<> system_keyspace_make(db::system_keyspace& sys_ks, distributed<replica::database>& dist_db, distributed<service::storage_service>& dist_ss, sharded<gms::gossiper>& dist_gossiper, db::config& cfg, table_selector& tables) {
     if (tables.contains_keyspace(system_keyspace::NAME)) {
-        register_virtual_tables(dist_db, dist_ss, dist_gossiper, cfg);
+        register_virtual_tables(dist_db, dist_ss, dist_gossiper, sys_ks._qp, cfg);
     }
 
     auto& db = dist_db.local();
@@ -91,6 +91,8 @@ class system_keyspace : public seastar::peering_sharded_service<system_keyspace>
     sharded<replica::database>& _db;
     std::unique_ptr<local_cache> _cache;
 
+    friend future<> system_keyspace_make(system_keyspace& sys_ks, distributed<replica::database>& db, distributed<service::storage_service>& ss, sharded<gms::gossiper>& g, db::config& cfg, table_selector& tables);
+
     static schema_ptr raft_config();
     static schema_ptr local();
     static schema_ptr peers();
@@ -10,7 +10,9 @@
 #include "log.hh"
 #include "utils/latency.hh"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/when_all.hh>
+#include <seastar/util/defer.hh>
 
 static logging::logger mylog("row_locking");
 
@@ -32,7 +34,6 @@ row_locker::lock_holder::lock_holder()
     : _locker(nullptr)
     , _partition(nullptr)
     , _partition_exclusive(true)
-    , _row(nullptr)
     , _row_exclusive(true) {
 }
 
@@ -40,7 +41,6 @@ row_locker::lock_holder::lock_holder(row_locker* locker, const dht::decorated_ke
     : _locker(locker)
     , _partition(pk)
     , _partition_exclusive(exclusive)
-    , _row(nullptr)
     , _row_exclusive(true) {
 }
 
@@ -48,7 +48,7 @@ row_locker::lock_holder::lock_holder(row_locker* locker, const dht::decorated_ke
     : _locker(locker)
     , _partition(pk)
     , _partition_exclusive(false)
-    , _row(cpk)
+    , _rows({cpk})
     , _row_exclusive(exclusive) {
 }
 
@@ -115,18 +115,57 @@ row_locker::lock_ck(const dht::decorated_key& pk, const clustering_key_prefix& c
     });
 }
 
+future<row_locker::lock_holder>
+row_locker::lock_cks(const dht::decorated_key& pk, std::vector<clustering_key_prefix> cpks, bool exclusive, db::timeout_clock::time_point timeout, stats& stats) {
+    mylog.debug("taking shared lock on partition {}, and {} lock on {} rows in it", pk, (exclusive ? "exclusive" : "shared"), cpks.size());
+    std::sort(cpks.begin(), cpks.end(), clustering_key_prefix::less_compare(*_schema));
+    cpks.erase(std::unique(cpks.begin(), cpks.end(), clustering_key_prefix::equality(*_schema)), cpks.end());
+    auto i = _two_level_locks.try_emplace(pk, this).first;
+    single_lock_stats &single_lock_stats = exclusive ? stats.exclusive_row : stats.shared_row;
+    single_lock_stats.operations_currently_waiting_for_lock++;
+    auto done_waiting = defer([&single_lock_stats] () noexcept {
+        single_lock_stats.operations_currently_waiting_for_lock--;
+    });
+    utils::latency_counter waiting_latency;
+    waiting_latency.start();
+    // The partition is locked only once, the row locks alone are taken for
+    // each row. Taking the partition lock again for every row could
+    // deadlock with an exclusive partition lock queued in between.
+    co_await i->second._partition_lock.read_lock(timeout);
+    // From here on, the holder releases whatever was locked if locking
+    // one of the rows fails.
+    lock_holder holder(this, &i->first, false);
+    holder._row_exclusive = exclusive;
+    for (auto& cpk : cpks) {
+        auto j = i->second._row_locks.try_emplace(std::move(cpk)).first;
+        try {
+            co_await (exclusive ? j->second.write_lock(timeout) : j->second.read_lock(timeout));
+        } catch (...) {
+            if (!j->second.locked()) {
+                i->second._row_locks.erase(j);
+            }
+            throw;
+        }
+        holder._rows.push_back(&j->first);
+    }
+    waiting_latency.stop();
+    single_lock_stats.estimated_waiting_for_lock.add(waiting_latency.latency());
+    single_lock_stats.lock_acquisitions += holder._rows.size();
+    co_return holder;
+}
+
 row_locker::lock_holder::lock_holder(row_locker::lock_holder&& old) noexcept
         : _locker(old._locker)
         , _partition(old._partition)
         , _partition_exclusive(old._partition_exclusive)
-        , _row(old._row)
+        , _rows(std::move(old._rows))
         , _row_exclusive(old._row_exclusive)
 {
-    // We also need to zero old's _partition and _row, so when destructed
+    // We also need to zero old's _partition and _rows, so when destructed
     // the destructor will do nothing and further moves will not create
     // duplicates.
     old._partition = nullptr;
-    old._row = nullptr;
+    old._rows.clear();
 }
 
 row_locker::lock_holder& row_locker::lock_holder::operator=(row_locker::lock_holder&& old) noexcept {
@@ -135,18 +174,18 @@ row_locker::lock_holder& row_locker::lock_holder::operator=(row_locker::lock_hol
         _locker = old._locker;
         _partition = old._partition;
         _partition_exclusive = old._partition_exclusive;
-        _row = old._row;
+        _rows = std::move(old._rows);
         _row_exclusive = old._row_exclusive;
         // As above, need to also zero other's data
         old._partition = nullptr;
-        old._row = nullptr;
+        old._rows.clear();
     }
     return *this;
 }
 
 void
 row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
-                    const clustering_key_prefix* cpk, bool row_exclusive) {
+                    std::span<const clustering_key_prefix* const> cpks, bool row_exclusive) {
     // Look for the partition and/or row locks given keys, release the locks,
     // and if nobody is using one of lock objects any more, delete it:
     if (pk) {
@@ -157,7 +196,7 @@ row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
             return;
         }
         assert(&pli->first == pk);
-        if (cpk) {
+        for (auto cpk : cpks) {
             auto rli = pli->second._row_locks.find(*cpk);
             if (rli == pli->second._row_locks.end()) {
                 mylog.error("column_family::local_base_lock_holder::~local_base_lock_holder() can't find lock for row", *cpk);
@@ -192,6 +231,6 @@ row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
 
 row_locker::lock_holder::~lock_holder() {
     if (_locker) {
-        _locker->unlock(_partition,  _partition_exclusive, _row, _row_exclusive);
+        _locker->unlock(_partition,  _partition_exclusive, _rows, _row_exclusive);
     }
 }
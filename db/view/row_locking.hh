@@ -21,6 +21,7 @@
 
 #include <unordered_map>
 #include <memory>
+#include <span>
 
 #include <seastar/core/rwlock.hh>
 #include <seastar/core/future.hh>
@@ -30,6 +31,7 @@
 #include "dht/i_partitioner.hh"
 #include "query-request.hh"
 #include "utils/estimated_histogram.hh"
+#include "utils/small_vector.hh"
 
 class row_locker {
 public:
@@ -44,10 +46,10 @@ class row_locker {
         single_lock_stats exclusive_partition;
         single_lock_stats shared_partition;
     };
-    // row_locker's locking functions lock_pk(), lock_ck() return a
-    // "lock_holder" object. When the caller destroys the object it received,
-    // the lock is released. The same type "lock_holder" is used regardless
-    // of whether a row or partition was locked, for read or write.
+    // row_locker's locking functions lock_pk(), lock_ck(), lock_cks() return
+    // a "lock_holder" object. When the caller destroys the object it received,
+    // the locks are released. The same type "lock_holder" is used regardless
+    // of whether rows or a partition were locked, for read or write.
     class lock_holder {
         row_locker* _locker;
         // The lock holder pointers to the partition and clustering keys,
@@ -56,8 +58,10 @@ class row_locker {
         // this partition or row are released).
         const dht::decorated_key* _partition;
         bool _partition_exclusive;
-        const clustering_key_prefix* _row;
+        utils::small_vector<const clustering_key_prefix*, 1> _rows;
         bool _row_exclusive;
+
+        friend class row_locker;
     public:
         lock_holder();
         lock_holder(row_locker* locker, const dht::decorated_key* pk, bool exclusive);
@@ -98,7 +102,7 @@ class row_locker {
         }
     };
     std::unordered_map<dht::decorated_key, two_level_lock, decorated_key_hash, decorated_key_equals_comparator> _two_level_locks;
-    void unlock(const dht::decorated_key* pk, bool partition_exclusive, const clustering_key_prefix* cpk, bool row_exclusive);
+    void unlock(const dht::decorated_key* pk, bool partition_exclusive, std::span<const clustering_key_prefix* const> cpks, bool row_exclusive);
 public:
     // row_locker needs to know the column_family's schema because key
     // comparisons needs the schema.
@@ -124,5 +128,13 @@ class row_locker {
     // schema, call upgrade() before taking the lock.
     future<lock_holder> lock_ck(const dht::decorated_key& pk, const clustering_key_prefix& ckp, bool exclusive, db::timeout_clock::time_point timeout, stats& stats);
 
+    // Lock several clustering rows of a partition with a shared or exclusive
+    // lock, with a single shared lock on the partition. Cheaper than
+    // lock_ck() for every row, and unlike locking the whole partition it
+    // still lets writes to other rows of the partition through.
+    // The rows are locked in key order, so callers locking overlapping sets
+    // of rows can't deadlock each other. Duplicate keys are locked once.
+    future<lock_holder> lock_cks(const dht::decorated_key& pk, std::vector<clustering_key_prefix> ckps, bool exclusive, db::timeout_clock::time_point timeout, stats& stats);
+
     bool empty() const { return _two_level_locks.empty(); }
 };
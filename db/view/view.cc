@@ -235,6 +235,8 @@ void stats::register_stats() {
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_local", view_updates_failed_local, ms::description("Number of updates (mutations) that failed to be pushed to local view replicas"),
                     {_cf_label, _ks_label}),
+            ms::make_total_operations("view_updates_coalesced", view_updates_coalesced, ms::description("Number of updates (mutations) merged into another update to the same view partition before being pushed"),
+                    {_cf_label, _ks_label}),
             ms::make_gauge("view_updates_pending", ms::description("Number of updates pushed to view and are still to be completed"),
                     {_cf_label, _ks_label}, writes),
     });
@@ -1444,6 +1446,204 @@ static bool should_update_synchronously(const schema& s) {
     return *tag_opt == "true";
 }
 
+// Applies a single view update to its paired view replica, target_endpoint,
+// and to the pending replicas of the view partition. Resolves when the local
+// update, if any, is applied, and also when the remote ones are, if
+// apply_update_synchronously is set.
+static future<> apply_view_update(
+        dht::token base_token,
+        std::optional<gms::inet_address> target_endpoint,
+        frozen_mutation_and_schema mut,
+        db::view::stats& stats,
+        replica::cf_stats& cf_stats,
+        tracing::trace_state_ptr tr_state,
+        db::timeout_semaphore_units sem_units,
+        service::allow_hints allow_hints,
+        bool apply_update_synchronously) {
+    auto view_token = dht::get_token(*mut.s, mut.fm.key());
+    auto& keyspace_name = mut.s->ks_name();
+    auto remote_endpoints = service::get_local_storage_proxy().get_token_metadata_ptr()->pending_endpoints_for(view_token, keyspace_name);
+
+    // First, find the local endpoint and ensure that if it exists,
+    // it will be the target endpoint. That way, all endpoints in the
+    // remote_endpoints list are guaranteed to be remote.
+    auto my_address = utils::fb_utilities::get_broadcast_address();
+    auto remote_it = std::find(remote_endpoints.begin(), remote_endpoints.end(), my_address);
+    if (remote_it != remote_endpoints.end()) {
+        if (!target_endpoint) {
+            target_endpoint = *remote_it;
+            remote_endpoints.erase(remote_it);
+        } else {
+            // Remove the duplicated entry
+            if (*target_endpoint == *remote_it) {
+                remote_endpoints.erase(remote_it);
+            } else {
+                std::swap(*target_endpoint, *remote_it);
+            }
+        }
+    }
+    // It's still possible that a target endpoint is dupliated in the remote endpoints list,
+    // so let's get rid of the duplicate if it exists
+    if (target_endpoint) {
+        auto remote_it = std::find(remote_endpoints.begin(), remote_endpoints.end(), *target_endpoint);
+        if (remote_it != remote_endpoints.end()) {
+            remote_endpoints.erase(remote_it);
+        }
+    }
+
+    future<> local_view_update = make_ready_future<>();
+    if (target_endpoint && *target_endpoint == my_address) {
+        ++stats.view_updates_pushed_local;
+        ++cf_stats.total_view_updates_pushed_local;
+        ++stats.writes;
+        auto mut_ptr = remote_endpoints.empty() ? std::make_unique<frozen_mutation>(std::move(mut.fm)) : std::make_unique<frozen_mutation>(mut.fm);
+        tracing::trace(tr_state, "Locally applying view update for {}.{}; base token = {}; view token = {}",
+                mut.s->ks_name(), mut.s->cf_name(), base_token, view_token);
+        local_view_update = service::get_local_storage_proxy().mutate_locally(mut.s, *mut_ptr, tr_state, db::commitlog::force_sync::no).then_wrapped(
+                [s = mut.s, &stats, &cf_stats, tr_state, base_token, view_token, my_address, mut_ptr = std::move(mut_ptr),
+                        units = sem_units.split(sem_units.count())] (future<>&& f) {
+            --stats.writes;
+            if (f.failed()) {
+                ++stats.view_updates_failed_local;
+                ++cf_stats.total_view_updates_failed_local;
+                auto ep = f.get_exception();
+                tracing::trace(tr_state, "Failed to apply local view update for {}", my_address);
+                vlogger.error("Error applying view update to {} (view: {}.{}, base token: {}, view token: {}): {}",
+                        my_address, s->ks_name(), s->cf_name(), base_token, view_token, ep);
+                return make_exception_future<>(std::move(ep));
+            }
+            tracing::trace(tr_state, "Successfully applied local view update for {}", my_address);
+            return make_ready_future<>();
+        });
+        // We just applied a local update to the target endpoint, so it should now be removed
+        // from the possible targets
+        target_endpoint.reset();
+    }
+
+    // If target endpoint is not engaged, but there are remote endpoints,
+    // one of the remote endpoints should become a primary target
+    if (!target_endpoint && !remote_endpoints.empty()) {
+        target_endpoint = std::move(remote_endpoints.back());
+        remote_endpoints.pop_back();
+    }
+
+    future<> remote_view_update = make_ready_future<>();
+    // If target_endpoint is engaged by this point, then either the update
+    // is not local, or the local update was already applied but we still
+    // have pending endpoints to send to.
+    if (target_endpoint) {
+        size_t updates_pushed_remote = remote_endpoints.size() + 1;
+        stats.view_updates_pushed_remote += updates_pushed_remote;
+        cf_stats.total_view_updates_pushed_remote += updates_pushed_remote;
+        schema_ptr s = mut.s;
+        future<> view_update = apply_to_remote_endpoints(*target_endpoint, std::move(remote_endpoints), std::move(mut), base_token, view_token, allow_hints, tr_state).then_wrapped(
+                [s = std::move(s), &stats, &cf_stats, tr_state, base_token, view_token, target_endpoint, updates_pushed_remote,
+                        units = sem_units.split(sem_units.count()), apply_update_synchronously] (future<>&& f) mutable {
+            if (f.failed()) {
+                stats.view_updates_failed_remote += updates_pushed_remote;
+                cf_stats.total_view_updates_failed_remote += updates_pushed_remote;
+                auto ep = f.get_exception();
+                tracing::trace(tr_state, "Failed to apply view update for {} and {} remote endpoints",
+                        *target_endpoint, updates_pushed_remote);
+                vlogger.error("Error applying view update to {} (view: {}.{}, base token: {}, view token: {}): {}",
+                        *target_endpoint, s->ks_name(), s->cf_name(), base_token, view_token, ep);
+                return apply_update_synchronously ? make_exception_future<>(std::move(ep)) : make_ready_future<>();
+            }
+            tracing::trace(tr_state, "Successfully applied view update for {} and {} remote endpoints",
+                    *target_endpoint, updates_pushed_remote);
+            return make_ready_future<>();
+        });
+        if (apply_update_synchronously) {
+            remote_view_update = std::move(view_update);
+        } else {
+            // The update is sent to background in order to preserve availability,
+            // its parallelism is limited by view_update_concurrency_semaphore
+            (void)view_update;
+        }
+    }
+    return when_all_succeed(std::move(local_view_update), std::move(remote_view_update)).discard_result();
+}
+
+view_update_coalescer::view_update_coalescer(stats& stats, replica::cf_stats& cf_stats)
+        : view_update_coalescer(stats, [&stats, &cf_stats] (dht::token base_token, std::optional<gms::inet_address> target_endpoint,
+                frozen_mutation_and_schema mut, db::timeout_semaphore_units units, tracing::trace_state_ptr tr_state) {
+            return apply_view_update(base_token, std::move(target_endpoint), std::move(mut), stats, cf_stats, std::move(tr_state),
+                    std::move(units), service::allow_hints::yes, false);
+        })
+{ }
+
+view_update_coalescer::view_update_coalescer(stats& stats, send_function send)
+        : _stats(stats)
+        , _send(std::move(send))
+        , _timer([this] { flush(); })
+{ }
+
+void view_update_coalescer::add(dht::token base_token, std::optional<gms::inet_address> target_endpoint,
+        frozen_mutation_and_schema mut, db::timeout_semaphore_units units, tracing::trace_state_ptr tr_state) {
+    if (_gate.is_closed()) {
+        (void)_send(base_token, std::move(target_endpoint), std::move(mut), std::move(units), std::move(tr_state))
+                .handle_exception([] (std::exception_ptr) { });
+        return;
+    }
+    _pending_bytes += mut.fm.representation().size();
+    auto& partitions = _pending.try_emplace(std::make_pair(mut.s->version(), target_endpoint),
+            dht::decorated_key::less_comparator(mut.s)).first->second;
+    auto dk = mut.fm.decorated_key(*mut.s);
+    auto i = partitions.find(dk);
+    if (i == partitions.end()) {
+        i = partitions.emplace(std::move(dk), pending_update{std::move(mut), std::nullopt, base_token, std::move(units)}).first;
+    } else {
+        // Only updates which are merged with another one are unfrozen.
+        auto& update = i->second;
+        if (!update.merged) {
+            update.merged = update.frozen->fm.unfreeze(update.frozen->s);
+            update.frozen.reset();
+        }
+        update.merged->apply(mut.fm.unfreeze(mut.s));
+        update.units.adopt(std::move(units));
+        ++_stats.view_updates_coalesced;
+    }
+    if (tr_state) {
+        i->second.tr_states.push_back(std::move(tr_state));
+    }
+    if (_pending_bytes >= max_pending_bytes) {
+        flush();
+    } else if (!_timer.armed()) {
+        _timer.arm(window);
+    }
+}
+
+void view_update_coalescer::flush() {
+    _timer.cancel();
+    _pending_bytes = 0;
+    auto pending = std::exchange(_pending, {});
+    for (auto& [key, partitions] : pending) {
+        for (auto& [dk, update] : partitions) {
+            auto mut = update.merged
+                    ? frozen_mutation_and_schema{freeze(*update.merged), update.merged->schema()}
+                    : std::move(*update.frozen);
+            tracing::trace_state_ptr tr_state;
+            for (auto& tr : update.tr_states) {
+                tracing::trace(tr, "Sending coalesced view update for {}.{}; base token = {}",
+                        mut.s->ks_name(), mut.s->cf_name(), update.base_token);
+                if (!tr_state) {
+                    tr_state = tr;
+                }
+            }
+            // Failures are reported by the send function.
+            (void)with_gate(_gate, [this, base_token = update.base_token, target_endpoint = key.second,
+                    mut = std::move(mut), units = std::move(update.units), tr_state = std::move(tr_state)] () mutable {
+                return _send(base_token, std::move(target_endpoint), std::move(mut), std::move(units), std::move(tr_state));
+            }).handle_exception([] (std::exception_ptr) { });
+        }
+    }
+}
+
+future<> view_update_coalescer::stop() {
+    flush();
+    return _gate.close();
+}
+
 // Take the view mutations generated by generate_view_updates(), which pertain
 // to a modification of a single base partition, and apply them to the
 // appropriate paired replicas. This is done asynchronously - we do not wait
@@ -1456,15 +1656,14 @@ future<> mutate_MV(
         tracing::trace_state_ptr tr_state,
         db::timeout_semaphore_units pending_view_updates,
         service::allow_hints allow_hints,
-        wait_for_all_updates wait_for_all)
+        wait_for_all_updates wait_for_all,
+        view_update_coalescer* coalescer)
 {
     static constexpr size_t max_concurrent_updates = 128;
     co_await max_concurrent_for_each(view_updates, max_concurrent_updates,
-            [base_token, &stats, &cf_stats, tr_state, &pending_view_updates, allow_hints, wait_for_all] (frozen_mutation_and_schema mut) mutable -> future<> {
+            [base_token, &stats, &cf_stats, tr_state, &pending_view_updates, allow_hints, wait_for_all, coalescer] (frozen_mutation_and_schema mut) mutable -> future<> {
         auto view_token = dht::get_token(*mut.s, mut.fm.key());
-        auto& keyspace_name = mut.s->ks_name();
-        auto target_endpoint = get_view_natural_endpoint(keyspace_name, base_token, view_token);
-        auto remote_endpoints = service::get_local_storage_proxy().get_token_metadata_ptr()->pending_endpoints_for(view_token, keyspace_name);
+        auto target_endpoint = get_view_natural_endpoint(mut.s->ks_name(), base_token, view_token);
         auto sem_units = pending_view_updates.split(mut.fm.representation().size());
 
         const bool update_synchronously = should_update_synchronously(*mut.s);
@@ -1476,104 +1675,16 @@ future<> mutate_MV(
         // If a view is marked with the synchronous_updates property, we should wait for all.
         const bool apply_update_synchronously = wait_for_all || update_synchronously;
 
-        // First, find the local endpoint and ensure that if it exists,
-        // it will be the target endpoint. That way, all endpoints in the
-        // remote_endpoints list are guaranteed to be remote.
-        auto my_address = utils::fb_utilities::get_broadcast_address();
-        auto remote_it = std::find(remote_endpoints.begin(), remote_endpoints.end(), my_address);
-        if (remote_it != remote_endpoints.end()) {
-            if (!target_endpoint) {
-                target_endpoint = *remote_it;
-                remote_endpoints.erase(remote_it);
-            } else {
-                // Remove the duplicated entry
-                if (*target_endpoint == *remote_it) {
-                    remote_endpoints.erase(remote_it);
-                } else {
-                    std::swap(*target_endpoint, *remote_it);
-                }
-            }
-        }
-        // It's still possible that a target endpoint is dupliated in the remote endpoints list,
-        // so let's get rid of the duplicate if it exists
-        if (target_endpoint) {
-            auto remote_it = std::find(remote_endpoints.begin(), remote_endpoints.end(), *target_endpoint);
-            if (remote_it != remote_endpoints.end()) {
-                remote_endpoints.erase(remote_it);
-            }
-        }
-
-        future<> local_view_update = make_ready_future<>();
-        if (target_endpoint && *target_endpoint == my_address) {
-            ++stats.view_updates_pushed_local;
-            ++cf_stats.total_view_updates_pushed_local;
-            ++stats.writes;
-            auto mut_ptr = remote_endpoints.empty() ? std::make_unique<frozen_mutation>(std::move(mut.fm)) : std::make_unique<frozen_mutation>(mut.fm);
-            tracing::trace(tr_state, "Locally applying view update for {}.{}; base token = {}; view token = {}",
+        // Local updates are applied before the base write completes, so they're never delayed.
+        const bool remote = target_endpoint && *target_endpoint != utils::fb_utilities::get_broadcast_address();
+        if (coalescer && remote && !apply_update_synchronously && allow_hints) {
+            tracing::trace(tr_state, "Queueing view update for {}.{} to be coalesced; base token = {}; view token = {}",
                     mut.s->ks_name(), mut.s->cf_name(), base_token, view_token);
-            local_view_update = service::get_local_storage_proxy().mutate_locally(mut.s, *mut_ptr, tr_state, db::commitlog::force_sync::no).then_wrapped(
-                    [s = mut.s, &stats, &cf_stats, tr_state, base_token, view_token, my_address, mut_ptr = std::move(mut_ptr),
-                            units = sem_units.split(sem_units.count())] (future<>&& f) {
-                --stats.writes;
-                if (f.failed()) {
-                    ++stats.view_updates_failed_local;
-                    ++cf_stats.total_view_updates_failed_local;
-                    auto ep = f.get_exception();
-                    tracing::trace(tr_state, "Failed to apply local view update for {}", my_address);
-                    vlogger.error("Error applying view update to {} (view: {}.{}, base token: {}, view token: {}): {}",
-                            my_address, s->ks_name(), s->cf_name(), base_token, view_token, ep);
-                    return make_exception_future<>(std::move(ep));
-                }
-                tracing::trace(tr_state, "Successfully applied local view update for {}", my_address);
-                return make_ready_future<>();
-            });
-            // We just applied a local update to the target endpoint, so it should now be removed
-            // from the possible targets
-            target_endpoint.reset();
-        }
-
-        // If target endpoint is not engaged, but there are remote endpoints,
-        // one of the remote endpoints should become a primary target
-        if (!target_endpoint && !remote_endpoints.empty()) {
-            target_endpoint = std::move(remote_endpoints.back());
-            remote_endpoints.pop_back();
-        }
-
-        future<> remote_view_update = make_ready_future<>();
-        // If target_endpoint is engaged by this point, then either the update
-        // is not local, or the local update was already applied but we still
-        // have pending endpoints to send to.
-        if (target_endpoint) {
-            size_t updates_pushed_remote = remote_endpoints.size() + 1;
-            stats.view_updates_pushed_remote += updates_pushed_remote;
-            cf_stats.total_view_updates_pushed_remote += updates_pushed_remote;
-            schema_ptr s = mut.s;
-            future<> view_update = apply_to_remote_endpoints(*target_endpoint, std::move(remote_endpoints), std::move(mut), base_token, view_token, allow_hints, tr_state).then_wrapped(
-                    [s = std::move(s), &stats, &cf_stats, tr_state, base_token, view_token, target_endpoint, updates_pushed_remote,
-                            units = sem_units.split(sem_units.count()), apply_update_synchronously] (future<>&& f) mutable {
-                if (f.failed()) {
-                    stats.view_updates_failed_remote += updates_pushed_remote;
-                    cf_stats.total_view_updates_failed_remote += updates_pushed_remote;
-                    auto ep = f.get_exception();
-                    tracing::trace(tr_state, "Failed to apply view update for {} and {} remote endpoints",
-                            *target_endpoint, updates_pushed_remote);
-                    vlogger.error("Error applying view update to {} (view: {}.{}, base token: {}, view token: {}): {}",
-                            *target_endpoint, s->ks_name(), s->cf_name(), base_token, view_token, ep);
-                    return apply_update_synchronously ? make_exception_future<>(std::move(ep)) : make_ready_future<>();
-                }
-                tracing::trace(tr_state, "Successfully applied view update for {} and {} remote endpoints",
-                        *target_endpoint, updates_pushed_remote);
-                return make_ready_future<>();
-            });
-            if (apply_update_synchronously) {
-                remote_view_update = std::move(view_update);
-            } else {
-                // The update is sent to background in order to preserve availability,
-                // its parallelism is limited by view_update_concurrency_semaphore
-                (void)view_update;
-            }
+            coalescer->add(base_token, std::move(target_endpoint), std::move(mut), std::move(sem_units), tr_state);
+            return make_ready_future<>();
         }
-        return when_all_succeed(std::move(local_view_update), std::move(remote_view_update)).discard_result();
+        return apply_view_update(base_token, std::move(target_endpoint), std::move(mut), stats, cf_stats, tr_state,
+                std::move(sem_units), allow_hints, apply_update_synchronously);
     });
 }
 
@@ -2098,6 +2209,7 @@ class view_builder::consumer {
 private:
     view_builder& _builder;
     build_step& _step;
+    pending_view_updates& _pending;
     built_views _built_views;
     gc_clock::time_point _now;
     std::vector<view_ptr> _views_to_build;
@@ -2113,9 +2225,10 @@ class view_builder::consumer {
     // beyond our limit on mutation size (by default 32 MB).
     size_t _fragments_memory_usage = 0;
 public:
-    consumer(view_builder& builder, build_step& step, gc_clock::time_point now)
+    consumer(view_builder& builder, build_step& step, pending_view_updates& pending, gc_clock::time_point now)
             : _builder(builder)
             , _step(step)
+            , _pending(pending)
             , _built_views{step}
             , _now(now) {
         if (!step.current_key.key().is_empty(*_step.reader.schema())) {
@@ -2208,15 +2321,19 @@ class view_builder::consumer {
             _fragments.emplace_front(*_step.reader.schema(), _builder._permit, partition_start(_step.current_key, tombstone()));
             auto base_schema = _step.base->schema();
             auto views = with_base_info_snapshot(_views_to_build);
+            const auto concurrent = _builder._db.get_view_update_backlog().relative_size() < max_backlog_for_concurrent_view_updates;
+            auto units = get_units(_pending.sem, concurrent ? 1 : max_view_updates_in_flight).get0();
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), _builder._permit, std::move(_fragments));
-            auto close_reader = defer([&reader] { reader.close().get(); });
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
-                    std::move(views),
-                    _step.current_token(),
-                    std::move(reader),
-                    _now).get();
-            close_reader.cancel();
+            // Propagated in the background, execute() waits for it.
+            (void)with_gate(_pending.gate, [&pending = _pending, base = _step.base, views = std::move(views), token = _step.current_token(),
+                    reader = std::move(reader), now = _now, units = std::move(units)] () mutable {
+                return base->populate_views(std::move(views), token, std::move(reader), now).handle_exception([&pending] (std::exception_ptr ep) {
+                    if (!pending.error) {
+                        pending.error = std::move(ep);
+                    }
+                }).finally([units = std::move(units)] { });
+            });
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -2254,14 +2371,38 @@ class view_builder::consumer {
 // Called in the context of a seastar::thread.
 void view_builder::execute(build_step& step, exponential_backoff_retry r) {
     gc_clock::time_point now = gc_clock::now();
+    // View updates are propagated in the background, so the step may have
+    // read past a batch whose updates fail. It then restarts from where it
+    // started; the views get some updates twice, which is harmless.
+    auto start_key = step.current_key;
+    auto start_status = step.build_status;
+    auto restart_step = [&] {
+        step.current_key = std::move(start_key);
+        step.build_status = std::move(start_status);
+    };
+    pending_view_updates pending;
     auto compaction_state = make_lw_shared<compact_for_query_state_v2>(
             *step.reader.schema(),
             now,
             step.pslice,
             batch_size,
             query::max_partitions);
-    auto consumer = compact_for_query_v2<view_builder::consumer>(compaction_state, view_builder::consumer{*this, step, now});
-    auto built = step.reader.consume_in_thread(std::move(consumer));
+    auto consumer = compact_for_query_v2<view_builder::consumer>(compaction_state, view_builder::consumer{*this, step, pending, now});
+    auto built = [&] {
+        try {
+            return step.reader.consume_in_thread(std::move(consumer));
+        } catch (...) {
+            pending.gate.close().get();
+            restart_step();
+            throw;
+        }
+    }();
+    pending.gate.close().get();
+    if (pending.error) {
+        built.release();
+        restart_step();
+        std::rethrow_exception(pending.error);
+    }
     if (auto ds = std::move(*compaction_state).detach_state()) {
         if (ds->current_tombstone) {
             step.reader.unpop_mutation_fragment(mutation_fragment_v2(*step.reader.schema(), step.reader.permit(), std::move(*ds->current_tombstone)));
@@ -14,6 +14,16 @@
 #include "schema_fwd.hh"
 #include "readers/flat_mutation_reader_v2.hh"
 #include "frozen_mutation.hh"
+#include "mutation.hh"
+#include "gms/inet_address.hh"
+#include "db/timeout_clock.hh"
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include <map>
 
 class frozen_mutation_and_schema;
 
@@ -264,8 +274,64 @@ future<query::clustering_row_ranges> calculate_affected_clustering_ranges(
         const mutation_partition& mp,
         const std::vector<view_and_base>& views);
 
+// Merges the asynchronous remote view updates of a base table which are
+// generated within a short window. Updates to the same view partition, to be sent to
+// the same paired view replica, are applied as a single mutation. So a burst
+// of base writes which all update the same view partition, e.g. rows sharing
+// the value of the view's partition key column, produces one view update
+// instead of one per base write.
+//
+// Updates are held until the window expires, or until enough of them are
+// pending; their semaphore units are held along with them, so they still
+// count in the view update backlog. Updates which end up not being merged
+// with any other are sent as they were given.
+class view_update_coalescer {
+public:
+    static constexpr std::chrono::milliseconds window{10};
+    static constexpr size_t max_pending_bytes = 1 << 20;
+
+    // Sends an update to its paired view replica. The tracing state is the
+    // one of the first traced base write the update was coalesced from.
+    using send_function = noncopyable_function<future<> (dht::token base_token, std::optional<gms::inet_address> target_endpoint,
+            frozen_mutation_and_schema mut, db::timeout_semaphore_units units, tracing::trace_state_ptr tr_state)>;
+private:
+    struct pending_update {
+        // The update as it was given, until another one is merged into it.
+        std::optional<frozen_mutation_and_schema> frozen;
+        std::optional<mutation> merged;
+        // Of the first coalesced update, for logging.
+        dht::token base_token;
+        db::timeout_semaphore_units units;
+        // Of the coalesced updates which are traced.
+        std::vector<tracing::trace_state_ptr> tr_states;
+    };
+    using partitions = std::map<dht::decorated_key, pending_update, dht::decorated_key::less_comparator>;
+
+    stats& _stats;
+    send_function _send;
+    // Keyed by view schema version and paired view replica.
+    std::map<std::pair<table_schema_version, std::optional<gms::inet_address>>, partitions> _pending;
+    size_t _pending_bytes = 0;
+    timer<lowres_clock> _timer;
+    seastar::gate _gate;
+public:
+    // Sends the updates to the paired view replica and to the pending
+    // replicas of the view partition.
+    view_update_coalescer(stats& stats, replica::cf_stats& cf_stats);
+    view_update_coalescer(stats& stats, send_function send);
+
+    void add(dht::token base_token, std::optional<gms::inet_address> target_endpoint,
+            frozen_mutation_and_schema mut, db::timeout_semaphore_units units, tracing::trace_state_ptr tr_state);
+    // Sends all pending updates.
+    void flush();
+    // Sends all pending updates, and waits for the local ones to be applied.
+    future<> stop();
+};
+
 struct wait_for_all_updates_tag {};
 using wait_for_all_updates = bool_class<wait_for_all_updates_tag>;
+// If coalescer is given, the updates to remote replicas which don't need to
+// be waited for are handed to it, instead of being sent right away.
 future<> mutate_MV(
         dht::token base_token,
         utils::chunked_vector<frozen_mutation_and_schema> view_updates,
@@ -274,7 +340,8 @@ future<> mutate_MV(
         tracing::trace_state_ptr tr_state,
         db::timeout_semaphore_units pending_view_updates,
         service::allow_hints allow_hints,
-        wait_for_all_updates wait_for_all);
+        wait_for_all_updates wait_for_all,
+        view_update_coalescer* coalescer = nullptr);
 
 /**
  * create_virtual_column() adds a "virtual column" to a schema builder.
@@ -17,6 +17,7 @@
 
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
@@ -62,10 +63,14 @@ namespace db::view {
  * We aim to be resource-conscious. On a given shard, at any given moment, we consume at most
  * from one reader. We also strive for fairness, in that each build step inserts entries for
  * the views of a different base. Each build step reads and generates updates for batch_size rows.
+ * All the views of a base being built share the reader, so the base is scanned once for all of them.
  *
- * We lack a controller, which could potentially allow us to go faster (to execute multiple steps at
- * the same time, or consume more rows per batch), and also which would apply backpressure, so we
- * could, for example, delay executing a build step.
+ * The view updates of a build step are propagated in the background while the step goes on
+ * reading, up to max_view_updates_in_flight batches at a time, so that the scan doesn't wait for
+ * the view replicas after every partition. When the shard's view update backlog is more than
+ * max_backlog_for_concurrent_view_updates full, batches are propagated one at a time. A step
+ * completes, and its progress is recorded, only after all its view updates were propagated. If
+ * any of them failed, the step is restarted from where it started.
  *
  * View building is necessarily a sharded process. That means that on restart, if the number of shards
  * has changed, we need to calculate the most conservative token range that has been built, and build
@@ -146,6 +151,13 @@ class view_builder final : public service::migration_listener::only_view_notific
 
     using base_to_build_step_type = std::unordered_map<table_id, build_step>;
 
+    // The view updates of a build step being propagated in the background.
+    struct pending_view_updates {
+        seastar::gate gate;
+        seastar::semaphore sem{max_view_updates_in_flight};
+        std::exception_ptr error;
+    };
+
     replica::database& _db;
     db::system_distributed_keyspace& _sys_dist_ks;
     service::migration_notifier& _mnotifier;
@@ -183,6 +195,8 @@ class view_builder final : public service::migration_listener::only_view_notific
     // collected batch_memory_max bytes, we can process the rows read so far.
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
+    static constexpr size_t max_view_updates_in_flight = 8;
+    static constexpr float max_backlog_for_concurrent_view_updates = 0.5;
 
 public:
     view_builder(replica::database&, db::system_distributed_keyspace&, service::migration_notifier&);
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <cmath>
 #include <seastar/util/defer.hh>
 #include <boost/range/adaptor/map.hpp>
 #include "view_update_generator.hh"
@@ -14,6 +15,7 @@
 #include "db/view/view_updating_consumer.hh"
 #include "sstables/sstables.hh"
 #include "readers/evictable.hh"
+#include <seastar/util/closeable.hh>
 
 static logging::logger vug_logger("view_update_generator");
 
@@ -55,42 +57,16 @@ future<> view_update_generator::start() {
                 const auto num_sstables = sstables.size();
 
                 try {
-                    // Exploit the fact that sstables in the staging directory
-                    // are usually non-overlapping and use a partitioned set for
-                    // the read.
-                    auto ssts = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s, false));
-                    for (auto& sst : sstables) {
-                        ssts->insert(sst);
-                    }
-
-                    auto permit = _db.obtain_reader_permit(*t, "view_update_generator", db::no_timeout).get0();
-                    auto ms = mutation_source([this, ssts] (
-                                schema_ptr s,
-                                reader_permit permit,
-                                const dht::partition_range& pr,
-                                const query::partition_slice& ps,
-                                const io_priority_class& pc,
-                                tracing::trace_state_ptr ts,
-                                streamed_mutation::forwarding fwd_ms,
-                                mutation_reader::forwarding fwd_mr) {
-                        return ssts->make_range_sstable_reader(s, std::move(permit), pr, ps, pc, std::move(ts), fwd_ms, fwd_mr);
-                    });
-                    auto [staging_sstable_reader, staging_sstable_reader_handle] = make_manually_paused_evictable_reader_v2(
-                            std::move(ms),
-                            s,
-                            permit,
-                            query::full_partition_range,
-                            s->full_slice(),
-                            service::get_local_streaming_priority(),
-                            nullptr,
-                            ::mutation_reader::forwarding::no);
-
                     inject_failure("view_update_generator_consume_staging_sstable");
-                    auto result = staging_sstable_reader.consume_in_thread(view_updating_consumer(s, std::move(permit), *t, sstables, _as, staging_sstable_reader_handle));
-                    staging_sstable_reader.close().get();
+                    auto result = process_staging_sstables(t, sstables);
                     if (result == stop_iteration::yes) {
                         break;
                     }
+                    // Only sstables whose view updates were all generated are counted.
+                    _stats.sstables_processed += num_sstables;
+                    for (auto& sst : sstables) {
+                        _stats.bytes_processed += sst->data_size();
+                    }
                 } catch (...) {
                     vug_logger.warn("Processing {} failed for table {}:{}. Will retry...", s->ks_name(), s->cf_name(), std::current_exception());
                     // Need to add sstables back to the set so we can retry later. By now it may
@@ -125,6 +101,103 @@ future<> view_update_generator::start() {
     return make_ready_future<>();
 }
 
+size_t view_update_generator::worker_count() const {
+    // Leave room for the updates of regular writes when view replicas lag behind.
+    auto free = 1.0f - std::clamp(_db.get_view_update_backlog().relative_size(), 0.0f, 1.0f);
+    return std::clamp<size_t>(std::ceil(max_workers * free), 1, max_workers);
+}
+
+std::vector<dht::partition_range> view_update_generator::split_staging_ranges(const std::vector<sstables::shared_sstable>& sstables, size_t n) {
+    if (sstables.empty()) {
+        return {query::full_partition_range};
+    }
+    auto lo = std::numeric_limits<int64_t>::max();
+    auto hi = std::numeric_limits<int64_t>::min();
+    for (auto& sst : sstables) {
+        lo = std::min(lo, dht::token::to_int64(sst->get_first_decorated_key().token()));
+        hi = std::max(hi, dht::token::to_int64(sst->get_last_decorated_key().token()));
+    }
+    return split_staging_ranges(dht::token::from_int64(lo), dht::token::from_int64(hi), n);
+}
+
+std::vector<dht::partition_range> view_update_generator::split_staging_ranges(dht::token first, dht::token last, size_t n) {
+    if (n <= 1) {
+        return {query::full_partition_range};
+    }
+    const auto lo = dht::token::to_int64(first);
+    const auto hi = dht::token::to_int64(last);
+    if (hi <= lo) {
+        return {query::full_partition_range};
+    }
+    auto step = (uint64_t(hi) - uint64_t(lo)) / n;
+    if (step == 0) {
+        return {query::full_partition_range};
+    }
+    // Ranges cover the whole ring, so that no partition is missed, but they're split evenly
+    // over the tokens the sstables actually have.
+    std::vector<dht::partition_range> ranges;
+    ranges.reserve(n);
+    std::optional<dht::token_range::bound> start;
+    for (size_t i = 1; i <= n; ++i) {
+        std::optional<dht::token_range::bound> end;
+        if (i < n) {
+            end = dht::token_range::bound(dht::token::from_int64(int64_t(uint64_t(lo) + step * i)), true);
+        }
+        ranges.push_back(dht::to_partition_range(dht::token_range(start, end)));
+        if (end) {
+            start = dht::token_range::bound(end->value(), false);
+        }
+    }
+    return ranges;
+}
+
+stop_iteration view_update_generator::process_staging_sstables(lw_shared_ptr<replica::table> t, const std::vector<sstables::shared_sstable>& sstables) {
+    schema_ptr s = t->schema();
+    // Exploit the fact that sstables in the staging directory
+    // are usually non-overlapping and use a partitioned set for
+    // the read.
+    auto ssts = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s, false));
+    for (auto& sst : sstables) {
+        ssts->insert(sst);
+    }
+    auto ms = mutation_source([ssts] (
+                schema_ptr s,
+                reader_permit permit,
+                const dht::partition_range& pr,
+                const query::partition_slice& ps,
+                const io_priority_class& pc,
+                tracing::trace_state_ptr ts,
+                streamed_mutation::forwarding fwd_ms,
+                mutation_reader::forwarding fwd_mr) {
+        return ssts->make_range_sstable_reader(s, std::move(permit), pr, ps, pc, std::move(ts), fwd_ms, fwd_mr);
+    });
+
+    // Each worker reads a disjoint token range of all the sstables, so their view updates don't overlap.
+    const auto ranges = split_staging_ranges(sstables, worker_count());
+    vug_logger.debug("Processing {} sstables of {}.{} with {} workers", sstables.size(), s->ks_name(), s->cf_name(), ranges.size());
+    bool stopped = false;
+    parallel_for_each(ranges, [&] (const dht::partition_range& pr) {
+        return seastar::async([&] {
+            ++_stats.active_workers;
+            auto dec = defer([&] () noexcept { --_stats.active_workers; });
+            auto permit = _db.obtain_reader_permit(*t, "view_update_generator", db::no_timeout).get0();
+            auto [staging_sstable_reader, staging_sstable_reader_handle] = make_manually_paused_evictable_reader_v2(
+                    ms,
+                    s,
+                    permit,
+                    pr,
+                    s->full_slice(),
+                    service::get_local_streaming_priority(),
+                    nullptr,
+                    ::mutation_reader::forwarding::no);
+            auto close_reader = deferred_close(staging_sstable_reader);
+            auto result = staging_sstable_reader.consume_in_thread(view_updating_consumer(s, std::move(permit), *t, sstables, _as, staging_sstable_reader_handle));
+            stopped |= result == stop_iteration::yes;
+        });
+    }).get();
+    return stop_iteration(stopped);
+}
+
 future<> view_update_generator::stop() {
     _as.request_abort();
     _pending_sstables.signal();
@@ -166,7 +239,19 @@ void view_update_generator::setup_metrics() {
 
         sm::make_gauge("sstables_to_move_count",
                 sm::description("Number of sets of sstables which are already processed and wait to be moved from their staging directory"),
-                [this] { return _sstables_to_move.size(); })
+                [this] { return _sstables_to_move.size(); }),
+
+        sm::make_counter("sstables_processed",
+                sm::description("Number of staging sstables whose view updates were generated"),
+                _stats.sstables_processed),
+
+        sm::make_counter("bytes_processed",
+                sm::description("Total data size of the staging sstables whose view updates were generated"),
+                _stats.bytes_processed),
+
+        sm::make_gauge("active_workers",
+                sm::description("Number of token ranges of staging sstables being processed in parallel"),
+                _stats.active_workers),
     });
 }
 
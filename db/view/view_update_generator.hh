@@ -20,6 +20,14 @@ namespace db::view {
 class view_update_generator {
 public:
     static constexpr size_t registration_queue_size = 5;
+    // Maximum number of token ranges of staging sstables processed in parallel.
+    static constexpr size_t max_workers = 4;
+
+    struct stats {
+        uint64_t sstables_processed = 0;
+        uint64_t bytes_processed = 0;
+        uint64_t active_workers = 0;
+    };
 
 private:
     replica::database& _db;
@@ -30,6 +38,7 @@ class view_update_generator {
     std::unordered_map<lw_shared_ptr<replica::table>, std::vector<sstables::shared_sstable>> _sstables_with_tables;
     std::unordered_map<lw_shared_ptr<replica::table>, std::vector<sstables::shared_sstable>> _sstables_to_move;
     metrics::metric_groups _metrics;
+    stats _stats;
 public:
     view_update_generator(replica::database& db) : _db(db) {
         setup_metrics();
@@ -41,8 +50,18 @@ class view_update_generator {
     future<> register_staging_sstable(sstables::shared_sstable sst, lw_shared_ptr<replica::table> table);
 
     ssize_t available_register_units() const { return _registration_sem.available_units(); }
+    const stats& get_stats() const noexcept { return _stats; }
+
+    // Splits the ring into n ranges, evenly over the tokens of the given sstables.
+    static std::vector<dht::partition_range> split_staging_ranges(const std::vector<sstables::shared_sstable>& sstables, size_t n);
+    // Splits the ring into n ranges, evenly over the tokens from first to last.
+    static std::vector<dht::partition_range> split_staging_ranges(dht::token first, dht::token last, size_t n);
 private:
     bool should_throttle() const;
+    // The number of workers shrinks as the view update backlog grows.
+    size_t worker_count() const;
+    // Must be called in a seastar thread.
+    stop_iteration process_staging_sstables(lw_shared_ptr<replica::table> t, const std::vector<sstables::shared_sstable>& sstables);
     void setup_metrics();
     void discover_staging_sstables();
 };
@@ -41,6 +41,14 @@ sharder::token_for_next_shard(const token& t, shard_id shard, unsigned spans) co
     return dht::token_for_next_shard(_shard_start, _shard_count, _sharding_ignore_msb_bits, t, shard, spans);
 }
 
+void
+i_partitioner::get_tokens(const schema& s, std::span<const partition_key_view> keys, std::span<token> tokens) const {
+    assert(keys.size() == tokens.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tokens[i] = get_token(s, keys[i]);
+    }
+}
+
 std::ostream& operator<<(std::ostream& out, const decorated_key& dk) {
     return out << "{key: " << dk._key << ", token:" << dk._token << "}";
 }
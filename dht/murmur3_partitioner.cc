@@ -52,6 +52,32 @@ murmur3_partitioner::get_token(const schema& s, partition_key_view key) const {
     return get_token(hash[0]);
 }
 
+void
+murmur3_partitioner::get_tokens(const schema& s, std::span<const partition_key_view> keys, std::span<token> tokens) const {
+    assert(keys.size() == tokens.size());
+    // Linearize the legacy forms of all keys into one buffer, to hash
+    // them together.
+    size_t total_size = 0;
+    for (auto& key : keys) {
+        total_size += key.legacy_form(s).size();
+    }
+    bytes buf(bytes::initialized_later(), total_size);
+    std::vector<bytes_view> views;
+    views.reserve(keys.size());
+    auto out = buf.begin();
+    for (auto& key : keys) {
+        auto&& legacy = key.legacy_form(s);
+        auto begin = out;
+        out = std::copy(legacy.begin(), legacy.end(), out);
+        views.emplace_back(begin, out - begin);
+    }
+    std::vector<std::array<uint64_t, 2>> hashes(keys.size());
+    utils::murmur_hash::hash3_x64_128(views, 0, hashes);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tokens[i] = get_token(hashes[i][0]);
+    }
+}
+
 using registry = class_registrator<i_partitioner, murmur3_partitioner>;
 static registry registrator("org.apache.cassandra.dht.Murmur3Partitioner");
 static registry registrator_short_name("Murmur3Partitioner");
@@ -32,10 +32,13 @@ range_streamer::get_range_fetch_map(const std::unordered_map<dht::token_range, s
                                     const std::unordered_set<std::unique_ptr<i_source_filter>>& source_filters,
                                     const sstring& keyspace) {
     std::unordered_map<inet_address, dht::token_range_vector> range_fetch_map_map;
+    auto& topo = get_token_metadata().get_topology();
     for (auto x : ranges_with_sources) {
         const dht::token_range& range_ = x.first;
         const std::vector<inet_address>& addresses = x.second;
         bool found_source = false;
+        // Sources in the closest data center which has any, sorted by proximity.
+        std::vector<inet_address> candidates;
         for (auto address : addresses) {
             if (address == utils::fb_utilities::get_broadcast_address()) {
                 // If localhost is a source, we have found one, but we don't add it to the map to avoid streaming locally
@@ -56,9 +59,27 @@ range_streamer::get_range_fetch_map(const std::unordered_map<dht::token_range, s
                 continue;
             }
 
-            range_fetch_map_map[address].push_back(range_);
+            if (!candidates.empty() && topo.get_datacenter(address) != topo.get_datacenter(candidates.front())) {
+                break;
+            }
+            candidates.push_back(address);
+        }
+
+        if (!candidates.empty()) {
+            // Spread the ranges over the candidates instead of fetching all of them
+            // from the closest one. Ties go to the closest source.
+            auto source = *std::min_element(candidates.begin(), candidates.end(), [&] (inet_address a, inet_address b) {
+                auto load = [&] (inet_address ep) {
+                    auto it = range_fetch_map_map.find(ep);
+                    return it == range_fetch_map_map.end() ? 0 : it->second.size();
+                };
+                return load(a) < load(b);
+            });
+            range_fetch_map_map[source].push_back(range_); // ensure we only stream from one other node for each range
             found_source = true;
-            break; // ensure we only stream from one other node for each range
+            if (candidates.size() > 1) {
+                _range_candidates[keyspace][range_] = std::move(candidates);
+            }
         }
 
         if (!found_source) {
@@ -252,11 +273,11 @@ future<> range_streamer::stream_async() {
         auto ips = boost::copy_range<std::list<inet_address>>(ip_range_vec | boost::adaptors::map_keys);
         // Fetch from or send to peer node in parallel
         logger.info("{} with {} for keyspace={} started, nodes_to_stream={}", description, ips, keyspace, ip_range_vec.size());
-        return parallel_for_each(ip_range_vec, [this, description, keyspace] (auto& ip_range) {
+        return parallel_for_each(ip_range_vec, [this, description, keyspace, &ip_range_vec] (auto& ip_range) {
           auto& source = ip_range.first;
           auto& range_vec = ip_range.second;
-          return seastar::with_semaphore(_limiter, 1, [this, description, keyspace, source, &range_vec] () mutable {
-            return seastar::async([this, description, keyspace, source, &range_vec] () mutable {
+          return seastar::with_semaphore(_limiter, 1, [this, description, keyspace, source, &range_vec, &ip_range_vec] () mutable {
+            return seastar::async([this, description, keyspace, source, &range_vec, &ip_range_vec] () mutable {
                 // TODO: It is better to use fiber instead of thread here because
                 // creating a thread per peer can be some memory in a large cluster.
                 auto start_time = lowres_clock::now();
@@ -287,10 +308,21 @@ future<> range_streamer::stream_async() {
                     logger.info("Finished {} out of {} ranges for {}, finished percentage={}",
                             _nr_total_ranges - remaining, _nr_total_ranges, _reason, percentage);
                 };
+                auto next_range = [&] () -> std::optional<dht::token_range> {
+                    if (!range_vec.empty()) {
+                        auto range = std::move(range_vec.front());
+                        range_vec.erase(range_vec.begin());
+                        return range;
+                    }
+                    auto range = steal_range(keyspace, source, ip_range_vec);
+                    if (range) {
+                        nr_ranges_total++;
+                    }
+                    return range;
+                };
                 try {
-                    for (auto it = range_vec.begin(); it < range_vec.end();) {
-                        ranges_to_stream.push_back(*it);
-                        it = range_vec.erase(it);
+                    while (auto range = next_range()) {
+                        ranges_to_stream.push_back(std::move(*range));
                         if (ranges_to_stream.size() < nr_ranges_per_stream_plan) {
                             continue;
                         } else {
@@ -324,6 +356,38 @@ future<> range_streamer::stream_async() {
     });
 }
 
+std::optional<dht::token_range>
+range_streamer::steal_range(const sstring& keyspace, inet_address source, std::unordered_map<inet_address, dht::token_range_vector>& ip_range_vec) {
+    auto candidates = _range_candidates.find(keyspace);
+    if (candidates == _range_candidates.end()) {
+        return std::nullopt;
+    }
+    // Take from the source which has the most ranges left. The ranges still
+    // queued for a source haven't been requested from it yet; it takes them
+    // from the front, so take from the back.
+    std::vector<std::pair<inet_address, dht::token_range_vector*>> victims;
+    for (auto& [ep, ranges] : ip_range_vec) {
+        if (ep != source && !ranges.empty()) {
+            victims.emplace_back(ep, &ranges);
+        }
+    }
+    std::sort(victims.begin(), victims.end(), [] (const auto& a, const auto& b) {
+        return a.second->size() > b.second->size();
+    });
+    for (auto& [victim, ranges] : victims) {
+        for (auto it = ranges->rbegin(); it != ranges->rend(); ++it) {
+            auto c = candidates->second.find(*it);
+            if (c != candidates->second.end() && std::find(c->second.begin(), c->second.end(), source) != c->second.end()) {
+                auto range = std::move(*it);
+                ranges->erase(std::next(it).base());
+                logger.debug("{} : keyspace={}, moving range {} from source={} to source={}", _description, keyspace, range, victim, source);
+                return range;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
 size_t range_streamer::nr_ranges_to_stream() {
     size_t nr_ranges_remaining = 0;
     for (auto& fetch : _to_stream) {
@@ -18,6 +18,7 @@
 #include "range.hh"
 #include <seastar/core/distributed.hh>
 #include <seastar/core/abort_source.hh>
+#include <optional>
 #include <unordered_map>
 #include <memory>
 
@@ -130,6 +131,14 @@ class range_streamer {
                         const std::unordered_set<std::unique_ptr<i_source_filter>>& source_filters,
                         const sstring& keyspace);
 
+    /**
+     * Takes a range which is still queued for another source, but which the given source
+     * also has, off that source's queue. Used to move ranges away from slow sources
+     * once a faster one is done with its own ranges.
+     */
+    std::optional<dht::token_range>
+    steal_range(const sstring& keyspace, inet_address source, std::unordered_map<inet_address, dht::token_range_vector>& ip_range_vec);
+
 #if 0
 
     // For testing purposes
@@ -157,6 +166,8 @@ class range_streamer {
     streaming::stream_reason _reason;
     std::unordered_multimap<sstring, std::unordered_map<inet_address, dht::token_range_vector>> _to_stream;
     std::unordered_set<std::unique_ptr<i_source_filter>> _source_filters;
+    // Sources which each range can be fetched from equally well, for ranges with more than one.
+    std::unordered_map<sstring, std::unordered_map<dht::token_range, std::vector<inet_address>>> _range_candidates;
     // Number of tx and rx ranges added
     unsigned _nr_tx_added = 0;
     unsigned _nr_rx_added = 0;
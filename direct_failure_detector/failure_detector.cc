@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <cmath>
+#include <map>
 #include <unordered_set>
 
 #include <seastar/core/abort_source.hh>
@@ -71,6 +73,18 @@ struct endpoint_worker {
     // that it sent the update (`endpoint_liveness:marked_alive`)
     condition_variable _alive_changed;
 
+    // Moving estimates of the mean and the mean deviation of this endpoint's ping round trips,
+    // for adaptive thresholds. Valid once `_has_rtt` is set.
+    double _rtt_mean = 0;
+    double _rtt_deviation = 0;
+    bool _has_rtt = false;
+
+    void update_rtt(clock::interval_t rtt) noexcept;
+
+    // The time after the last ping response which the endpoint has to respond within
+    // to be considered alive for listeners with the given threshold.
+    clock::interval_t threshold_interval(const adaptive_threshold&) const noexcept;
+
     // Pings endpoints and updates `endpoint_liveness::alive`.
     // The only exception possibly returned from the future is `sleep_aborted` when destroying the worker.
     future<> ping_fiber() noexcept;
@@ -129,7 +143,9 @@ struct failure_detector::impl {
     //
     // Each `endpoint_worker` running on this shard is managing, for each threshold, the `endpoint_liveness` state
     // at `listeners_liveness::endpoint_liveness[ep]`, where `ep` is the endpoint of that worker.
-    std::unordered_map<clock::interval_t, listeners_liveness> _listeners_liveness;
+    //
+    // Fixed thresholds are kept as adaptive ones with `min == max`.
+    std::map<adaptive_threshold, listeners_liveness> _listeners_liveness;
 
     // The listeners registered on this shard.
     std::unordered_set<listener*> _registered;
@@ -166,7 +182,7 @@ struct failure_detector::impl {
 
     // Add information about a listener registered on shard `s` with threshold `t`
     // on the current shard so workers running on this shard can notify it.
-    void add_listener(listener_id, clock::interval_t t, seastar::shard_id s);
+    void add_listener(listener_id, adaptive_threshold t, seastar::shard_id s);
     // Remove information about a registered listener from the current shard.
     void remove_listener(listener_id);
 
@@ -376,6 +392,17 @@ endpoint_worker::~endpoint_worker() {
 }
 
 future<subscription> failure_detector::register_listener(listener& l, clock::interval_t threshold) {
+    return register_listener(l, adaptive_threshold{threshold, threshold, 0});
+}
+
+future<subscription> failure_detector::register_listener(listener& l, adaptive_threshold threshold) {
+    if (threshold.min > threshold.max) {
+        throw std::invalid_argument{format("direct_failure_detector: minimum threshold {} is larger than maximum {}", threshold.min, threshold.max)};
+    }
+    if (threshold.min != threshold.max && !(threshold.false_positive_rate > 0 && threshold.false_positive_rate < 1)) {
+        throw std::invalid_argument{format("direct_failure_detector: false positive rate {} is not between 0 and 1", threshold.false_positive_rate)};
+    }
+
     // The pointer acts as a listener ID.
     if (!_impl->_registered.insert(&l).second) {
         throw std::runtime_error{format("direct_failure_detector: trying to register the same listener ({}) twice", fmt::ptr(&l))};
@@ -427,7 +454,7 @@ subscription::~subscription() {
     });
 }
 
-void failure_detector::impl::add_listener(listener_id id, clock::interval_t threshold, seastar::shard_id shard) {
+void failure_detector::impl::add_listener(listener_id id, adaptive_threshold threshold, seastar::shard_id shard) {
     if (!_shard_workers.empty()) {
         throw std::runtime_error{"direct_failure_detector: trying to register a listener after endpoints were added"};
     }
@@ -516,6 +543,31 @@ static future<bool> ping_with_timeout(pinger::endpoint_id id, clock::timepoint_t
     co_return result;
 }
 
+void endpoint_worker::update_rtt(clock::interval_t rtt) noexcept {
+    // The gains of TCP's retransmission timeout estimator (RFC 6298).
+    static constexpr double mean_gain = 1.0 / 8;
+    static constexpr double deviation_gain = 1.0 / 4;
+    if (!_has_rtt) {
+        _rtt_mean = rtt;
+        _rtt_deviation = rtt / 2.0;
+        _has_rtt = true;
+        return;
+    }
+    _rtt_deviation += deviation_gain * (std::abs(rtt - _rtt_mean) - _rtt_deviation);
+    _rtt_mean += mean_gain * (rtt - _rtt_mean);
+}
+
+clock::interval_t endpoint_worker::threshold_interval(const adaptive_threshold& t) const noexcept {
+    if (t.min == t.max || !_has_rtt) {
+        return t.max;
+    }
+    // An upper bound of the normal quantile, from the Chernoff bound of its tail. The mean
+    // deviation of a normal distribution is about 0.8 of its standard deviation.
+    auto deviations = std::sqrt(-2 * std::log(t.false_positive_rate)) / 0.8;
+    auto interval = _fd._ping_period + _rtt_mean + deviations * _rtt_deviation;
+    return std::clamp(clock::interval_t(std::ceil(interval)), t.min, t.max);
+}
+
 future<> endpoint_worker::ping_fiber() noexcept {
     auto& pinger = _fd._pinger;
     auto& clock = _fd._clock;
@@ -536,8 +588,9 @@ future<> endpoint_worker::ping_fiber() noexcept {
         // the listener (mark it as dead).
         auto timeout = start + 3 * _fd._ping_period;
         for (auto& [threshold, l]: _fd._listeners_liveness) {
-            if (l.endpoint_liveness[_id].alive && last_response + threshold < timeout) {
-                timeout = last_response + threshold;
+            auto t = threshold_interval(threshold);
+            if (l.endpoint_liveness[_id].alive && last_response + t < timeout) {
+                timeout = last_response + t;
             }
         }
 
@@ -565,6 +618,7 @@ future<> endpoint_worker::ping_fiber() noexcept {
         bool alive_changed = false;
         if (success) {
             last_response = clock.now();
+            update_rtt(last_response - start);
 
             for (auto& [_, l]: _fd._listeners_liveness) {
                 bool& alive = l.endpoint_liveness[_id].alive;
@@ -579,7 +633,7 @@ future<> endpoint_worker::ping_fiber() noexcept {
             // and there's no way to save them, it's simpler to just send the notifications immediately.
             for (auto& [threshold, l]: _fd._listeners_liveness) {
                 bool& alive = l.endpoint_liveness[_id].alive;
-                if (alive && last_response + threshold <= next_ping_start) {
+                if (alive && last_response + threshold_interval(threshold) <= next_ping_start) {
                     alive = false;
                     alive_changed = true;
                 }
@@ -630,7 +684,7 @@ future<> endpoint_worker::notify_fiber() noexcept {
                 // Unexpected exception. If `mark` failed for some reason, there's not much we can do.
                 // Log and continue.
                 logger.error("unexpected exception when marking endpoint {} as {} for threshold {}: {}",
-                        _id, alive ? "alive" : "dead", it->first, std::current_exception());
+                        _id, alive ? "alive" : "dead", it->first.max, std::current_exception());
             }
         }
 
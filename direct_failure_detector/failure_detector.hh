@@ -85,6 +85,23 @@ class listener {
     ~listener() = default;
 };
 
+// A threshold which adapts to the round trip times of the pings of each endpoint.
+//
+// For each endpoint, the failure detector maintains moving estimates of the mean and the deviation
+// of its ping round trips. The endpoint is considered dead if no response came in `ping_period`
+// plus its mean round trip plus as many deviations as a normal distribution exceeds with probability
+// `false_positive_rate`, clamped to [`min`, `max`]. Until an endpoint responds for the first time, `max` applies.
+//
+// Endpoints answering quickly and regularly are thus marked dead within a fraction of `max`,
+// while slow or jittery links get more time.
+struct adaptive_threshold {
+    clock::interval_t min;
+    clock::interval_t max;
+    double false_positive_rate;
+
+    auto operator<=>(const adaptive_threshold&) const = default;
+};
+
 class failure_detector;
 
 // A RAII object returned when registering a `listener`.
@@ -158,6 +175,12 @@ class failure_detector : public seastar::peering_sharded_service<failure_detecto
             listener&,
             clock::interval_t threshold);
 
+    // Like above, but the threshold adapts to the round trips of each endpoint's pings.
+    // `threshold.max` should be significantly larger than `ping_period`.
+    future<subscription> register_listener(
+            listener&,
+            adaptive_threshold threshold);
+
     // Add this endpoint to the detected set.
     // Has no effect if the endpoint is already there.
     // The newly added endpoing is initially considered dead for all listeners.
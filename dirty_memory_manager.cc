@@ -52,6 +52,15 @@ dirty_memory_manager_logalloc::size_tracked_region* region_group::get_largest_re
     return _regions.empty() ? nullptr : _regions.top();
 }
 
+std::vector<size_tracked_region*> region_group::get_largest_regions(size_t n) {
+    std::vector<size_tracked_region*> ret;
+    ret.reserve(std::min(n, _regions.size()));
+    for (auto it = _regions.ordered_begin(); it != _regions.ordered_end() && ret.size() < n; ++it) {
+        ret.push_back(*it);
+    }
+    return ret;
+}
+
 void
 region_group::add(region* child_r) {
     auto child = static_cast<size_tracked_region*>(child_r);
@@ -338,6 +338,9 @@ class region_group : public region_listener {
     // children.
     size_tracked_region* get_largest_region() noexcept;
 
+    // returns up to n of the largest regions below this region group, largest first.
+    std::vector<size_tracked_region*> get_largest_regions(size_t n);
+
     // Shutdown is mandatory for every user who has set a threshold
     // Can be called at most once.
     future<> shutdown() noexcept;
@@ -436,6 +439,11 @@ class dirty_memory_manager {
 
     future<> flush_when_needed();
 
+    // The number of largest memtables considered for flushing under pressure.
+    static constexpr size_t flush_candidates = 8;
+    // Picks the memtable to flush under pressure, see flush_when_needed().
+    replica::memtable& pick_flush_candidate();
+
     future<> _waiting_flush;
     void start_reclaiming() noexcept;
 
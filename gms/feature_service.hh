@@ -109,9 +109,15 @@ class feature_service final {
     gms::feature typed_errors_in_read_rpc { *this, "TYPED_ERRORS_IN_READ_RPC"sv };
     gms::feature schema_commitlog { *this, "SCHEMA_COMMITLOG"sv };
     gms::feature uda_native_parallelized_aggregation { *this, "UDA_NATIVE_PARALLELIZED_AGGREGATION"sv };
+    gms::feature parallelized_group_by_aggregation { *this, "PARALLELIZED_GROUP_BY_AGGREGATION"sv };
     gms::feature aggregate_storage_options { *this, "AGGREGATE_STORAGE_OPTIONS"sv };
     gms::feature collection_indexing { *this, "COLLECTION_INDEXING"sv };
     gms::feature large_collection_detection { *this, "LARGE_COLLECTION_DETECTION"sv };
+    gms::feature cdc_preimage_source { *this, "CDC_PREIMAGE_SOURCE"sv };
+    gms::feature lwt_ballot_lease { *this, "LWT_BALLOT_LEASE"sv };
+    gms::feature cache_admission { *this, "CACHE_ADMISSION"sv };
+    gms::feature repair_adaptive_row_buf { *this, "REPAIR_ADAPTIVE_ROW_BUF"sv };
+    gms::feature repair_row_hash_sketch { *this, "REPAIR_ROW_HASH_SKETCH"sv };
 
 public:
 
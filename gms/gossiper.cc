@@ -132,6 +132,16 @@ gossiper::gossiper(abort_source& as, feature_service& features, const locator::s
             [this] {
                 return _unreachable_endpoints.size();
             }, sm::description("How many unreachable nodes the current node sees")),
+        sm::make_counter("local_state_convergences", _convergence.converged,
+            sm::description("How many times changes of the local application states were propagated to all live nodes")),
+        sm::make_counter("local_state_convergence_time_ms", _convergence.total_time_ms,
+            sm::description("Total time, in milliseconds, it took changes of the local application states to be propagated to all live nodes")),
+        sm::make_gauge("last_local_state_convergence_time_ms", _convergence.last_time_ms,
+            sm::description("Time, in milliseconds, it took the last changes of the local application states to be propagated to all live nodes")),
+        sm::make_gauge("local_state_unconverged",
+            [this] {
+                return _convergence.pending ? 1 : 0;
+            }, sm::description("Whether some changes of the local application states are yet to be propagated to all live nodes")),
     });
 }
 
@@ -143,34 +153,32 @@ gossiper::gossiper(abort_source& as, feature_service& features, const locator::s
  * to the endpoint from the map that was initially constructed.
 */
 void gossiper::do_sort(utils::chunked_vector<gossip_digest>& g_digest_list) {
-    /* Construct a map of endpoint to GossipDigest. */
-    std::map<inet_address, gossip_digest> ep_to_digest_map;
-    for (auto g_digest : g_digest_list) {
-        ep_to_digest_map.emplace(g_digest.get_endpoint(), g_digest);
-    }
-
     /*
      * These digests have their maxVersion set to the difference of the version
      * of the local EndpointState and the version found in the GossipDigest.
+     * The original digest is kept alongside, so that it doesn't have to be
+     * looked up again after sorting.
     */
-    utils::chunked_vector<gossip_digest> diff_digests;
-    for (auto g_digest : g_digest_list) {
+    std::vector<std::pair<gossip_digest, gossip_digest>> diff_digests;
+    diff_digests.reserve(g_digest_list.size());
+    for (auto& g_digest : g_digest_list) {
         auto ep = g_digest.get_endpoint();
         auto* ep_state = this->get_endpoint_state_for_endpoint_ptr(ep);
         int version = ep_state ? this->get_max_endpoint_state_version(*ep_state) : 0;
         int diff_version = ::abs(version - g_digest.get_max_version());
-        diff_digests.emplace_back(gossip_digest(ep, g_digest.get_generation(), diff_version));
+        diff_digests.emplace_back(gossip_digest(ep, g_digest.get_generation(), diff_version), g_digest);
     }
 
-    g_digest_list.clear();
-    std::sort(diff_digests.begin(), diff_digests.end());
-    int size = diff_digests.size();
     /*
      * Report the digests in descending order. This takes care of the endpoints
      * that are far behind w.r.t this local endpoint
     */
-    for (int i = size - 1; i >= 0; --i) {
-        g_digest_list.emplace_back(ep_to_digest_map[diff_digests[i].get_endpoint()]);
+    std::sort(diff_digests.begin(), diff_digests.end(), [] (const auto& a, const auto& b) {
+        return b.first < a.first;
+    });
+    g_digest_list.clear();
+    for (auto& d : diff_digests) {
+        g_digest_list.emplace_back(d.second);
     }
 }
 
@@ -244,6 +252,7 @@ future<> gossiper::handle_syn_msg(msg_addr from, gossip_digest_syn syn_msg) {
 future<> gossiper::do_send_ack_msg(msg_addr from, gossip_digest_syn syn_msg) {
     return futurize_invoke([this, from, syn_msg = std::move(syn_msg)] () mutable {
         auto g_digest_list = syn_msg.get_gossip_digests();
+        note_known_local_version(from.addr, g_digest_list);
         do_sort(g_digest_list);
         utils::chunked_vector<gossip_digest> delta_gossip_digest_list;
         std::map<inet_address, endpoint_state> delta_ep_state_map;
@@ -254,15 +263,20 @@ future<> gossiper::do_send_ack_msg(msg_addr from, gossip_digest_syn syn_msg) {
     });
 }
 
+// States which are periodically refreshed, rather than changed by events such as topology changes.
+static bool is_frequently_updated(application_state app_state) noexcept {
+    return app_state == application_state::LOAD ||
+           app_state == application_state::VIEW_BACKLOG ||
+           app_state == application_state::CACHE_HITRATES;
+}
+
 static bool should_count_as_msg_processing(const std::map<inet_address, endpoint_state>& map) {
     bool count_as_msg_processing  = false;
     for (auto& x : map) {
         auto& state = x.second;
         for (const auto& entry : state.get_application_state_map()) {
             auto& app_state = entry.first;
-            if (!(app_state == application_state::LOAD ||
-                  app_state == application_state::VIEW_BACKLOG ||
-                  app_state == application_state::CACHE_HITRATES)) {
+            if (!is_frequently_updated(app_state)) {
                 count_as_msg_processing = true;
                 logger.debug("node={}, app_state={}, count_as_msg_processing={}",
                         x.first, app_state, count_as_msg_processing);
@@ -695,6 +709,8 @@ future<> gossiper::remove_endpoint(inet_address endpoint) {
     _unreachable_endpoints.erase(endpoint);
     _syn_handlers.erase(endpoint);
     _ack_handlers.erase(endpoint);
+    _convergence.known_version.erase(endpoint);
+    maybe_converged();
     quarantine_endpoint(endpoint);
     logger.debug("removing endpoint {}", endpoint);
 }
@@ -1075,7 +1091,7 @@ std::set<inet_address> gossiper::get_unreachable_members() const {
     return ret;
 }
 
-int gossiper::get_max_endpoint_state_version(endpoint_state state) const noexcept {
+int gossiper::get_max_endpoint_state_version(const endpoint_state& state) const noexcept {
     int max_version = state.get_heart_beat_state().get_heart_beat_version();
     for (auto& entry : state.get_application_state_map()) {
         auto& value = entry.second;
@@ -1084,6 +1100,50 @@ int gossiper::get_max_endpoint_state_version(endpoint_state state) const noexcep
     return max_version;
 }
 
+void gossiper::note_local_state_change(int version) noexcept {
+    if (_convergence.pending) {
+        _convergence.pending->first = version;
+    } else {
+        _convergence.pending.emplace(version, now());
+    }
+    maybe_converged();
+}
+
+void gossiper::note_known_local_version(inet_address from, const utils::chunked_vector<gossip_digest>& digests) {
+    auto ep = get_broadcast_address();
+    auto* es = get_endpoint_state_for_endpoint_ptr(ep);
+    if (!es) {
+        return;
+    }
+    auto it = std::find_if(digests.begin(), digests.end(), [ep] (const gossip_digest& d) { return d.get_endpoint() == ep; });
+    // Versions of our previous incarnations don't tell anything about what the peer knows.
+    if (it == digests.end() || it->get_generation() != es->get_heart_beat_state().get_generation()) {
+        return;
+    }
+    auto& known = _convergence.known_version[from];
+    known = std::max(known, it->get_max_version());
+    maybe_converged();
+}
+
+void gossiper::maybe_converged() noexcept {
+    if (!_convergence.pending) {
+        return;
+    }
+    auto [version, start] = *_convergence.pending;
+    for (auto& ep : _live_endpoints) {
+        auto it = _convergence.known_version.find(ep);
+        if (it == _convergence.known_version.end() || it->second < version) {
+            return;
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now() - start).count();
+    logger.debug("Local application states up to version {} were propagated to {} live nodes in {} ms", version, _live_endpoints.size(), elapsed);
+    _convergence.converged++;
+    _convergence.total_time_ms += elapsed;
+    _convergence.last_time_ms = elapsed;
+    _convergence.pending.reset();
+}
+
 future<> gossiper::evict_from_membership(inet_address endpoint) {
     auto permit = co_await lock_endpoint(endpoint);
     _unreachable_endpoints.erase(endpoint);
@@ -2048,6 +2108,7 @@ future<> gossiper::add_local_application_state(std::list<std::pair<application_s
                 return;
             }
 
+            std::optional<int> tracked_version;
             for (auto& p : states) {
                 auto& state = p.first;
                 auto& value = p.second;
@@ -2057,6 +2118,12 @@ future<> gossiper::add_local_application_state(std::list<std::pair<application_s
                 value = versioned_value::clone_with_higher_version(value);
                 // Add to local application state
                 es->add_application_state(state, value);
+                if (!is_frequently_updated(state)) {
+                    tracked_version = std::max(tracked_version.value_or(value.version), value.version);
+                }
+            }
+            if (tracked_version) {
+                gossiper.note_local_state_change(*tracked_version);
             }
             for (auto& p : states) {
                 auto& state = p.first;
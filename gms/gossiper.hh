@@ -281,7 +281,7 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
      * @param ep_state
      * @return
      */
-    int get_max_endpoint_state_version(endpoint_state state) const noexcept;
+    int get_max_endpoint_state_version(const endpoint_state& state) const noexcept;
 
 
 private:
@@ -593,6 +593,27 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
     future<> maybe_enable_features();
 private:
     seastar::metrics::metric_groups _metrics;
+
+    // Tracking of the propagation of local application states to the live endpoints.
+    //
+    // Versions are generated in increasing order and a peer which knows a version
+    // was sent all the states with lower versions, so the max version of our state
+    // in the digests a peer gossips to us tells which of our changes it has seen.
+    // Frequently updated states (see is_frequently_updated()) are not tracked, as
+    // they would keep the state from ever converging.
+    struct local_state_convergence {
+        // The latest version of a tracked local application state, and the time
+        // of the first change since all live endpoints converged.
+        std::optional<std::pair<int, clk::time_point>> pending;
+        std::unordered_map<inet_address, int> known_version;
+        uint64_t converged = 0;
+        uint64_t total_time_ms = 0;
+        uint64_t last_time_ms = 0;
+    } _convergence;
+
+    void note_local_state_change(int version) noexcept;
+    void note_known_local_version(inet_address from, const utils::chunked_vector<gossip_digest>& digests);
+    void maybe_converged() noexcept;
 public:
     void append_endpoint_state(std::stringstream& ss, const endpoint_state& state);
 public:
@@ -11,6 +11,7 @@ namespace netw {
 struct schema_pull_options {
     bool remote_supports_canonical_mutation_retval;
     bool group0_snapshot_transfer [[version 4.7]] = false;
+    std::optional<table_schema_version> known_schema_version [[version 5.3]] = std::nullopt;
 };
 
 } // namespace netw
@@ -18,6 +18,16 @@ class repair_hash {
     uint64_t hash;
 };
 
+struct repair_hash_sketch_cell final {
+    int32_t count;
+    uint64_t hash_sum;
+    uint64_t check_sum;
+};
+
+class repair_hash_sketch {
+    std::vector<repair_hash_sketch_cell> cells;
+};
+
 struct partition_key_and_mutation_fragments {
     partition_key get_key();
     std::list<frozen_mutation_fragment> get_mutation_fragments();
@@ -69,6 +79,7 @@ enum class repair_row_level_start_status: uint8_t {
 
 struct repair_row_level_start_response {
     repair_row_level_start_status status;
+    std::optional<repair_hash> range_hash [[version 5.2]];
 };
 
 enum class node_ops_cmd : uint32_t {
@@ -143,3 +154,4 @@ struct repair_flush_hints_batchlog_response {
 
 verb [[with_client_info]] repair_update_system_table (repair_update_system_table_request) -> repair_update_system_table_response;
 verb [[with_client_info]] repair_flush_hints_batchlog (repair_flush_hints_batchlog_request) -> repair_flush_hints_batchlog_response;
+verb [[with_client_info]] repair_get_row_hash_sketch (uint32_t repair_meta_id, uint32_t nr_cells) -> repair_hash_sketch;
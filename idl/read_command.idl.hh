@@ -46,6 +46,23 @@ struct max_result_size {
     uint64_t page_size [[version 4.7]] = 0;
 }
 
+struct row_filter {
+    enum class comparison_op : uint8_t {
+        eq,
+        neq,
+        lt,
+        lte,
+        gt,
+        gte,
+    };
+    struct comparison {
+        uint32_t column;
+        query::row_filter::comparison_op op;
+        bytes value;
+    };
+    std::vector<query::row_filter::comparison> comparisons;
+};
+
 class read_command {
     table_id cf_id;
     table_schema_version schema_version;
@@ -59,6 +76,7 @@ class read_command {
     std::optional<query::max_result_size> max_result_size [[version 4.3]] = std::nullopt;
     uint32_t row_limit_high_bits [[version 4.3]] = 0;
     uint64_t tombstone_limit [[version 5.2]] = query::max_tombstones;
+    std::optional<query::row_filter> filter [[version 5.3]] = std::nullopt;
 };
 
 }
@@ -117,21 +117,53 @@ void compile(context& ctx, const std::vector<sstring>& arg_names, std::string sc
     create_instance_and_func(ctx, store);
 }
 
-static void init_abstract_arg(const abstract_type& t, const bytes_opt& param, std::vector<wasmtime::Val>& argv, wasmtime::Store& store, wasmtime::Instance& instance) {
-        // set up exported memory's underlying buffer,
-        // `memory` is required to be exported in the WebAssembly module
-        auto memory_export = instance.get(store, "memory");
-        if (!memory_export) {
-            throw wasm::exception("memory export not found - please export `memory` in the wasm module");
+// The exports of an instance which are used to pass serialized values in and
+// out of its memory. They are looked up by name on first use and kept for the
+// rest of the call, instead of being looked up again for every argument and
+// for the returned value.
+struct guest_memory {
+    struct exports {
+        wasmtime::Memory memory;
+        uint32_t abi;
+        std::optional<wasmtime::Func> malloc_func;
+        std::optional<wasmtime::Func> free_func;
+    };
+
+    wasmtime::Store& store;
+    wasmtime::Instance& instance;
+    std::optional<exports> _exports;
+
+    guest_memory(wasmtime::Store& store, wasmtime::Instance& instance) : store(store), instance(instance) {}
+
+    exports& get() {
+        if (!_exports) {
+            // `memory` is required to be exported in the WebAssembly module
+            auto memory_export = instance.get(store, "memory");
+            if (!memory_export) {
+                throw wasm::exception("memory export not found - please export `memory` in the wasm module");
+            }
+            auto memory = std::get<wasmtime::Memory>(*memory_export);
+            auto abi = get_abi(instance, store, memory.data(store).data());
+            _exports.emplace(exports{std::move(memory), abi, std::nullopt, std::nullopt});
+            if (abi == 2) {
+                _exports->malloc_func = import_func(instance, store, "_scylla_malloc");
+                _exports->free_func = import_func(instance, store, "_scylla_free");
+            }
         }
-        auto memory = std::get<wasmtime::Memory>(*memory_export);
-        uint8_t* data = memory.data(store).data();
+        return *_exports;
+    }
+};
+
+static void init_abstract_arg(const abstract_type& t, const bytes_opt& param, std::vector<wasmtime::Val>& argv, guest_memory& mem) {
+        auto& store = mem.store;
+        auto& exports = mem.get();
+        auto& memory = exports.memory;
         size_t mem_size = memory.size(store) * WASM_PAGE_SIZE;
         int32_t serialized_size = param ? param->size() : 0;
         if (serialized_size > std::numeric_limits<int32_t>::max()) {
             throw wasm::exception(format("Serialized parameter is too large: {} > {}", param->size(), std::numeric_limits<int32_t>::max()));
         }
-        switch (uint32_t abi_ver = get_abi(instance, store, data)) {
+        switch (exports.abi) {
             case 1: {
                 auto grown = memory.grow(store, 1 + (sizeof(int32_t) + serialized_size - 1) / WASM_PAGE_SIZE); // for fitting serialized size + the buffer itself
                 if (!grown) {
@@ -141,17 +173,17 @@ static void init_abstract_arg(const abstract_type& t, const bytes_opt& param, st
                 break;
             }
             case 2: {
-                auto malloc_func = import_func(instance, store, "_scylla_malloc");
-                import_func(instance, store, "_scylla_free");
-                auto size = call_func(store, malloc_func, {int32_t(sizeof(int32_t) + serialized_size)});
+                auto size = call_func(store, *exports.malloc_func, {int32_t(sizeof(int32_t) + serialized_size)});
                 mem_size = size.i32();
                 break;
             }
             default:
-                throw wasm::exception(format("ABI version {} not recognized", abi_ver));
+                throw wasm::exception(format("ABI version {} not recognized", exports.abi));
         }
         if (param) {
-            // put the argument in wasm module's memory
+            // put the argument in wasm module's memory, which may have moved
+            // while it was growing
+            uint8_t* data = memory.data(store).data();
             std::memcpy(data + mem_size, param->data(), serialized_size);
         } else {
             // size of -1 means that the value is null
@@ -166,8 +198,7 @@ static void init_abstract_arg(const abstract_type& t, const bytes_opt& param, st
 struct init_arg_visitor {
     const bytes_opt& param;
     std::vector<wasmtime::Val>& argv;
-    wasmtime::Store& store;
-    wasmtime::Instance& instance;
+    guest_memory& mem;
 
     void operator()(const boolean_type_impl&) {
         auto dv = boolean_type->deserialize(*param);
@@ -209,26 +240,24 @@ struct init_arg_visitor {
         if (!param) {
             on_internal_error(wasm_logger, "init_arg_visitor does not accept null values");
         }
-        init_abstract_arg(t, param, argv, store, instance);
+        init_abstract_arg(t, param, argv, mem);
     }
 };
 
 struct init_nullable_arg_visitor {
     const bytes_opt& param;
     std::vector<wasmtime::Val>& argv;
-    wasmtime::Store& store;
-    wasmtime::Instance& instance;
+    guest_memory& mem;
 
     void operator()(const abstract_type& t) {
-        init_abstract_arg(t, param, argv, store, instance);
+        init_abstract_arg(t, param, argv, mem);
     }
 };
 
 
 struct from_val_visitor {
     const wasmtime::Val& val;
-    wasmtime::Store& store;
-    wasmtime::Instance& instance;
+    guest_memory& mem;
 
     bytes_opt operator()(const boolean_type_impl&) {
         expect_kind(wasmtime::ValKind::I32);
@@ -261,22 +290,16 @@ struct from_val_visitor {
 
     bytes_opt operator()(const abstract_type& t) {
         expect_kind(wasmtime::ValKind::I64);
-        auto memory_export = instance.get(store, "memory");
-        if (!memory_export) {
-            throw wasm::exception("memory export not found - please export `memory` in the wasm module");
-        }
-        auto memory = std::get<wasmtime::Memory>(*memory_export);
-        uint8_t* mem_base = memory.data(store).data();
-        uint8_t* data = mem_base + (val.i64() & 0xffffffff);
+        auto& exports = mem.get();
+        uint8_t* data = exports.memory.data(mem.store).data() + (val.i64() & 0xffffffff);
         int32_t ret_size = val.i64() >> 32;
         if (ret_size == -1) {
             return bytes_opt{};
         }
         bytes_opt ret = t.decompose(t.deserialize(bytes_view(reinterpret_cast<int8_t*>(data), ret_size)));
 
-        if (get_abi(instance, store, mem_base) == 2) {
-            auto free_func = import_func(instance, store, "_scylla_free");
-            call_void_func(store, free_func, {wasmtime::Val((int32_t)val.i64())});
+        if (exports.abi == 2) {
+            call_void_func(mem.store, *exports.free_func, {wasmtime::Val((int32_t)val.i64())});
         }
 
         return ret;
@@ -307,16 +330,18 @@ seastar::future<bytes_opt> run_script(context& ctx, wasmtime::Store& store, wasm
     if (!added) {
         co_await coroutine::return_exception(wasm::exception(added.err().message()));
     }
+    guest_memory mem(store, instance);
     std::vector<wasmtime::Val> argv;
+    argv.reserve(arg_types.size());
     for (size_t i = 0; i < arg_types.size(); ++i) {
         const abstract_type& type = *arg_types[i];
         const bytes_opt& param = params[i];
         // If nulls are allowed, each type will be passed indirectly
         // as a struct {bool is_null; int32_t serialized_size, char[] serialized_buf}
         if (allow_null_input) {
-            visit(type, init_nullable_arg_visitor{param, argv, store, instance});
+            visit(type, init_nullable_arg_visitor{param, argv, mem});
         } else if (param) {
-            visit(type, init_arg_visitor{param, argv, store, instance});
+            visit(type, init_arg_visitor{param, argv, mem});
         } else {
             co_await coroutine::return_exception(wasm::exception(format("Function {} cannot be called on null values", ctx.function_name)));
         }
@@ -352,9 +377,9 @@ seastar::future<bytes_opt> run_script(context& ctx, wasmtime::Store& store, wasm
     if (allow_null_input) {
         // Force calling the default method for abstract_type, which checks for nulls
         // and expects a serialized input
-        co_return from_val_visitor{result_vec[0], store, instance}(static_cast<const abstract_type&>(*return_type));
+        co_return from_val_visitor{result_vec[0], mem}(static_cast<const abstract_type&>(*return_type));
     } else {
-        co_return visit(*return_type, from_val_visitor{result_vec[0], store, instance});
+        co_return visit(*return_type, from_val_visitor{result_vec[0], mem});
     }
 }
 
@@ -61,7 +61,11 @@ sstring abstract_replication_strategy::to_qualified_class_name(std::string_view
 }
 
 inet_address_vector_replica_set abstract_replication_strategy::get_natural_endpoints(const token& search_token, const effective_replication_map& erm) const {
-    const token& key_token = erm.get_token_metadata_ptr()->first_token(search_token);
+    const auto& tm = *erm.get_token_metadata_ptr();
+    if (!erm._replicas_by_token_index.empty()) {
+        return *erm._replicas_by_token_index[tm.first_token_index(search_token)];
+    }
+    const token& key_token = tm.first_token(search_token);
     auto res = erm.get_replication_map().find(key_token);
     return res->second;
 }
@@ -322,7 +326,9 @@ future<mutable_effective_replication_map_ptr> calculate_effective_replication_ma
     }
 
     auto rf = rs->get_replication_factor(*tmptr);
-    co_return make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(replication_map), rf);
+    auto erm = make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(replication_map), rf);
+    co_await erm->index_replicas();
+    co_return erm;
 }
 
 future<replication_map> effective_replication_map::clone_endpoints_gently() const {
@@ -336,11 +342,30 @@ future<replication_map> effective_replication_map::clone_endpoints_gently() cons
     co_return cloned_endpoints;
 }
 
+future<> effective_replication_map::index_replicas() {
+    const auto& sorted_tokens = _tmptr->sorted_tokens();
+    if (_replication_map.size() != sorted_tokens.size()) {
+        co_return;
+    }
+    std::vector<const inet_address_vector_replica_set*> replicas;
+    replicas.reserve(sorted_tokens.size());
+    for (const auto& t : sorted_tokens) {
+        auto it = _replication_map.find(t);
+        if (it == _replication_map.end()) {
+            co_return;
+        }
+        replicas.push_back(&it->second);
+        co_await coroutine::maybe_yield();
+    }
+    _replicas_by_token_index = std::move(replicas);
+}
+
 inet_address_vector_replica_set effective_replication_map::get_natural_endpoints(const token& search_token) const {
     return _rs->get_natural_endpoints(search_token, *this);
 }
 
 future<> effective_replication_map::clear_gently() noexcept {
+    _replicas_by_token_index = {};
     co_await utils::clear_gently(_replication_map);
     co_await utils::clear_gently(_tmptr);
 }
@@ -388,6 +413,7 @@ future<effective_replication_map_ptr> effective_replication_map_factory::create_
         auto rf = ref_erm->get_replication_factor();
         auto local_replication_map = co_await ref_erm->clone_endpoints_gently();
         new_erm = make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(local_replication_map), rf);
+        co_await new_erm->index_replicas();
     } else {
         new_erm = co_await calculate_effective_replication_map(std::move(rs), std::move(tmptr));
     }
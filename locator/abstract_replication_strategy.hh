@@ -155,6 +155,9 @@ class effective_replication_map : public enable_lw_shared_from_this<effective_re
     abstract_replication_strategy::ptr_type _rs;
     token_metadata_ptr _tmptr;
     replication_map _replication_map;
+    // The replicas of each of the sorted tokens of _tmptr, pointing into _replication_map,
+    // so that lookups don't need to hash the token. Empty until index_replicas() is called.
+    std::vector<const inet_address_vector_replica_set*> _replicas_by_token_index;
     size_t _replication_factor;
     std::optional<factory_key> _factory_key = std::nullopt;
     effective_replication_map_factory* _factory = nullptr;
@@ -196,6 +199,9 @@ class effective_replication_map : public enable_lw_shared_from_this<effective_re
 
     future<replication_map> clone_endpoints_gently() const;
 
+    // Builds the lookup of replicas by token position.
+    future<> index_replicas();
+
     inet_address_vector_replica_set get_natural_endpoints(const token& search_token) const;
     inet_address_vector_replica_set get_natural_endpoints_without_node_being_replaced(const token& search_token) const;
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "dht/token.hh"
+
+namespace locator {
+
+// Immutable search structure over the sorted tokens of the ring.
+//
+// Tokens are laid out in Eytzinger (breadth-first) order, so the first steps
+// of a search hit the same few cache lines for every lookup, and the
+// elements of the steps after the next one can be prefetched. A binary search
+// over the sorted vector instead misses the cache on almost every step once
+// the ring has tens of thousands of tokens.
+//
+// The index only handles rings made of key tokens, which is what rings are
+// made of; it is left empty otherwise and callers fall back to searching the
+// sorted tokens.
+class token_index {
+    // 1-based; element 0 is unused.
+    std::vector<int64_t> _keys;
+    // Position in the sorted tokens of each element of _keys.
+    std::vector<uint32_t> _positions;
+    size_t _size = 0;
+private:
+    size_t fill(const std::vector<dht::token>& sorted, size_t i, size_t k) {
+        if (k <= _size) {
+            i = fill(sorted, i, 2 * k);
+            _keys[k] = sorted[i]._data;
+            _positions[k] = i++;
+            i = fill(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+public:
+    token_index() = default;
+
+    explicit token_index(const std::vector<dht::token>& sorted) {
+        for (auto& t : sorted) {
+            if (t._kind != dht::token::kind::key) {
+                return;
+            }
+        }
+        if (sorted.size() > std::numeric_limits<uint32_t>::max()) {
+            return;
+        }
+        _size = sorted.size();
+        _keys.resize(_size + 1);
+        _positions.resize(_size + 1);
+        fill(sorted, 0, 1);
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    // Returns the position of the first token not smaller than t in the
+    // sorted tokens, or their size if there is no such token.
+    // Must not be called if empty().
+    size_t lower_bound(const dht::token& t) const noexcept {
+        if (t._kind == dht::token::kind::before_all_keys) {
+            return 0;
+        }
+        if (t._kind == dht::token::kind::after_all_keys) {
+            return _size;
+        }
+        auto key = t._data;
+        // 16 int64_t per 2 cache lines: the elements 4 levels down are contiguous.
+        constexpr size_t prefetch_distance = 16;
+        size_t k = 1;
+        while (k <= _size) {
+            __builtin_prefetch(_keys.data() + std::min(prefetch_distance * k, _size));
+            k = 2 * k + (_keys[k] < key);
+        }
+        // Undo the right turns taken after the last left turn, which led to the answer.
+        k >>= __builtin_ffsll(~k);
+        return k ? _positions[k] : _size;
+    }
+};
+
+}
@@ -7,6 +7,7 @@
  */
 
 #include "token_metadata.hh"
+#include "token_index.hh"
 #include <optional>
 #include "locator/snitch_base.hh"
 #include "locator/abstract_replication_strategy.hh"
@@ -63,6 +64,8 @@ class token_metadata_impl final {
     std::unordered_map<sstring, boost::icl::interval_map<token, std::unordered_set<inet_address>>> _pending_ranges_interval_map;
 
     std::vector<token> _sorted_tokens;
+    // Rebuilt along with _sorted_tokens.
+    token_index _token_index;
 
     topology _topology;
 
@@ -370,6 +373,7 @@ future<token_metadata_impl> token_metadata_impl::clone_only_token_map(bool clone
         }).then([this, &ret, clone_sorted_tokens] {
             if (clone_sorted_tokens) {
                 ret._sorted_tokens = _sorted_tokens;
+                ret._token_index = _token_index;
             }
             return make_ready_future<token_metadata_impl>(std::move(ret));
         });
@@ -385,6 +389,7 @@ future<> token_metadata_impl::clear_gently() noexcept {
     co_await utils::clear_gently(_replacing_endpoints);
     co_await utils::clear_gently(_pending_ranges_interval_map);
     co_await utils::clear_gently(_sorted_tokens);
+    _token_index = {};
     co_await _topology.clear_gently();
     co_return;
 }
@@ -399,6 +404,7 @@ void token_metadata_impl::sort_tokens() {
 
     std::sort(sorted.begin(), sorted.end());
 
+    _token_index = token_index(sorted);
     _sorted_tokens = std::move(sorted);
 }
 
@@ -480,12 +486,10 @@ size_t token_metadata_impl::first_token_index(const token& start) const {
         tlogger.error("{}", msg);
         throw std::runtime_error(msg);
     }
-    auto it = std::lower_bound(_sorted_tokens.begin(), _sorted_tokens.end(), start);
-    if (it == _sorted_tokens.end()) {
-        return 0;
-    } else {
-        return std::distance(_sorted_tokens.begin(), it);
-    }
+    auto i = _token_index.empty()
+            ? size_t(std::distance(_sorted_tokens.begin(), std::lower_bound(_sorted_tokens.begin(), _sorted_tokens.end(), start)))
+            : _token_index.lower_bound(start);
+    return i == _sorted_tokens.size() ? 0 : i;
 }
 
 const token& token_metadata_impl::first_token(const token& start) const {
@@ -83,6 +83,7 @@
 #include "db/paxos_grace_seconds_extension.hh"
 #include "service/qos/standard_service_level_distributed_data_accessor.hh"
 #include "service/storage_proxy.hh"
+#include "service/replica_suspicion_listener.hh"
 #include "service/forward_service.hh"
 #include "alternator/controller.hh"
 #include "alternator/ttl.hh"
@@ -93,6 +94,7 @@
 #include "service/raft/raft_group_registry.hh"
 #include "service/raft/raft_group0_client.hh"
 #include "service/raft/raft_group0.hh"
+#include "utils/stall_attribution.hh"
 
 #include <boost/algorithm/string/join.hpp>
 
@@ -494,6 +496,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
 
     sharded<locator::shared_token_metadata> token_metadata;
     sharded<locator::effective_replication_map_factory> erm_factory;
+    sharded<utils::stall_attribution::tracker> stall_tracker;
     sharded<service::migration_notifier> mm_notifier;
     sharded<service::endpoint_lifecycle_notifier> lifecycle_notifier;
     sharded<compaction_manager> cm;
@@ -580,6 +583,9 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 sighup_handler.stop().get();
             });
 
+            if (cfg->lsa_transparent_huge_pages() && !opts.contains("hugepages")) {
+                logalloc::use_huge_pages_for_segment_pool().get();
+            }
             logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
             logging::apply_settings(cfg->logging_settings(app.options().log_opts));
 
@@ -638,6 +644,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 st_cfg.abort_on_lsa_bad_alloc = cfg->abort_on_lsa_bad_alloc();
                 st_cfg.lsa_reclamation_step = cfg->lsa_reclamation_step();
                 st_cfg.background_reclaim_sched_group = background_reclaim_scheduling_group;
+                st_cfg.background_reclaim_free_memory_threshold = cfg->lsa_background_reclaim_reserve_in_mb() * 1024 * 1024;
+                st_cfg.background_reclaim_max_shares = cfg->lsa_background_reclaim_max_shares();
                 st_cfg.sanitizer_report_backtrace = cfg->sanitizer_report_backtrace();
                 logalloc::shard_tracker().configure(st_cfg);
             }).get();
@@ -727,6 +735,9 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             //});
 
             supervisor::notify("starting effective_replication_map factory");
+            stall_tracker.start().get();
+            auto stop_stall_tracker = deferred_stop(stall_tracker);
+
             erm_factory.start().get();
             auto stop_erm_factory = deferred_stop(erm_factory);
 
@@ -771,6 +782,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             dbcfg.memory_compaction_scheduling_group = make_sched_group("mem_compaction", 1000);
             dbcfg.streaming_scheduling_group = maintenance_scheduling_group;
             dbcfg.statement_scheduling_group = make_sched_group("statement", 1000);
+            // The admission weight of heavy statements in the user read semaphore matches these shares.
+            dbcfg.heavy_statement_scheduling_group = make_sched_group("heavy_statement", 200);
             dbcfg.memtable_scheduling_group = make_sched_group("memtable", 1000);
             dbcfg.memtable_to_cache_scheduling_group = make_sched_group("memtable_to_cache", 200);
             dbcfg.gossip_scheduling_group = make_sched_group("gossip", 1000);
@@ -831,7 +844,11 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             sl_controller.local().update_from_distributed_data(std::chrono::seconds(10));
 
             netw::messaging_service::scheduling_config scfg;
-            scfg.statement_tenants = { {dbcfg.statement_scheduling_group, "$user"}, {default_scheduling_group(), "$system"} };
+            scfg.statement_tenants = {
+                {dbcfg.statement_scheduling_group, "$user"},
+                {default_scheduling_group(), "$system"},
+                {dbcfg.heavy_statement_scheduling_group, "$heavy"},
+            };
             scfg.streaming = dbcfg.streaming_scheduling_group;
             scfg.gossip = dbcfg.gossip_scheduling_group;
 
@@ -963,6 +980,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             utils::directories::set dir_set;
             dir_set.add(cfg->data_file_directories());
             dir_set.add(cfg->commitlog_directory());
+            dir_set.add(cfg->commitlog_extra_directories());
             dirs.emplace(cfg->developer_mode());
             dirs->create_and_verify(std::move(dir_set)).get();
 
@@ -1004,6 +1022,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .shares_smoothing = std::chrono::milliseconds(cfg->compaction_shares_smoothing_in_ms()),
+                    .max_concurrent_offstrategy_compactions = std::max(cfg->max_concurrent_offstrategy_compactions(), 1u),
                 };
             });
             cm.start(std::move(get_cm_cfg), std::ref(stop_signal.as_sharded_abort_source())).get();
@@ -1065,6 +1085,19 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             proxy.start(std::ref(db), std::ref(gossiper), spcfg, std::ref(node_backlog),
                     scheduling_group_key_create(storage_proxy_stats_cfg).get0(),
                     std::ref(feature_service), std::ref(token_metadata), std::ref(erm_factory), std::ref(messaging)).get();
+
+            // Must subscribe to the direct failure detector before group 0 gives it endpoints.
+            static sharded<service::replica_suspicion_listener> replica_suspicion;
+            replica_suspicion.start(
+                sharded_parameter([] (gms::gossiper& g) { return std::ref(g.get_direct_fd_pinger()); }, std::ref(gossiper)),
+                std::ref(proxy)).get();
+            auto stop_replica_suspicion = defer_verbose_shutdown("replica suspicion listener", [] {
+                replica_suspicion.stop().get();
+            });
+            replica_suspicion.invoke_on_all([] (service::replica_suspicion_listener& l) {
+                return l.start(fd.local());
+            }).get();
+
             supervisor::notify("starting forward service");
             forward_service.start(std::ref(messaging), std::ref(proxy), std::ref(db), std::ref(token_metadata)).get();
             auto stop_forward_service_handlers = defer_verbose_shutdown("forward service", [&forward_service] {
@@ -179,7 +179,8 @@ enum class messaging_verb : int32_t {
     REPAIR_FLUSH_HINTS_BATCHLOG = 60,
     FORWARD_REQUEST = 61,
     GET_GROUP0_UPGRADE_STATE = 62,
-    LAST = 63,
+    REPAIR_GET_ROW_HASH_SKETCH = 63,
+    LAST = 64,
 };
 
 } // namespace netw
@@ -205,6 +206,11 @@ struct schema_pull_options {
     // which contain additional data (besides schema tables mutations).
     // When used inside group 0 snapshot transfer, this is `true`.
     bool group0_snapshot_transfer = false;
+
+    // Schema version of the puller. If it matches the version of the remote,
+    // the remote skips the schema tables and returns only the group 0 history.
+    // Remotes which don't know this option return the full schema regardless.
+    std::optional<table_schema_version> known_schema_version;
 };
 
 class messaging_service : public seastar::async_sharded_service<messaging_service>, public peering_sharded_service<messaging_service> {
@@ -393,9 +399,9 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<get_combined_row_hash_response> send_repair_get_combined_row_hash(msg_addr id, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary);
 
     // Wrapper for REPAIR_GET_SYNC_BOUNDARY
-    void register_repair_get_sync_boundary(std::function<future<get_sync_boundary_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> skipped_sync_boundary)>&& func);
+    void register_repair_get_sync_boundary(std::function<future<get_sync_boundary_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> skipped_sync_boundary, rpc::optional<uint64_t> max_row_buf_size)>&& func);
     future<> unregister_repair_get_sync_boundary();
-    future<get_sync_boundary_response> send_repair_get_sync_boundary(msg_addr id, uint32_t repair_meta_id, std::optional<repair_sync_boundary> skipped_sync_boundary);
+    future<get_sync_boundary_response> send_repair_get_sync_boundary(msg_addr id, uint32_t repair_meta_id, std::optional<repair_sync_boundary> skipped_sync_boundary, std::optional<uint64_t> max_row_buf_size);
 
     // Wrapper for REPAIR_GET_ROW_DIFF
     void register_repair_get_row_diff(std::function<future<repair_rows_on_wire> (const rpc::client_info& cinfo, uint32_t repair_meta_id, repair_hash_set set_diff, bool needs_all_rows)>&& func);
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "zstd_rpc_compressor.hh"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <variant>
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/print.hh>
+
+#include "zstd.h"
+
+namespace netw {
+
+using namespace seastar;
+
+using fragments = std::vector<temporary_buffer<char>>;
+
+template <typename Buffers, typename Func>
+static void for_each_fragment(Buffers& bufs, Func&& func) {
+    std::visit([&func] (auto& b) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(b)>, fragments>) {
+            for (auto& f : b) {
+                func(f);
+            }
+        } else {
+            func(b);
+        }
+    }, bufs);
+}
+
+static fragments take_fragments(std::variant<fragments, temporary_buffer<char>>& bufs) {
+    fragments ret;
+    for_each_fragment(bufs, [&ret] (temporary_buffer<char>& f) {
+        if (!f.empty()) {
+            ret.push_back(std::move(f));
+        }
+    });
+    return ret;
+}
+
+template <typename Buf>
+static Buf make_buf(fragments frags, size_t size) {
+    if (frags.size() == 1) {
+        return Buf(std::move(frags.front()));
+    }
+    Buf ret;
+    ret.size = size;
+    ret.bufs = std::move(frags);
+    return ret;
+}
+
+static void check_zstd(size_t ret, const char* what) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("ZSTD {} failure: {}", what, ZSTD_getErrorName(ret)));
+    }
+}
+
+std::unique_ptr<rpc::compressor> zstd_rpc_compressor::factory::negotiate(sstring feature, bool is_server) const {
+    if (feature != _name) {
+        return nullptr;
+    }
+    return std::make_unique<zstd_rpc_compressor>();
+}
+
+zstd_rpc_compressor::zstd_rpc_compressor()
+        : _cctx(ZSTD_createCCtx())
+        , _dctx(ZSTD_createDCtx()) {
+    if (!_cctx || !_dctx) {
+        ZSTD_freeCCtx(_cctx);
+        ZSTD_freeDCtx(_dctx);
+        throw std::bad_alloc();
+    }
+}
+
+zstd_rpc_compressor::~zstd_rpc_compressor() {
+    ZSTD_freeCCtx(_cctx);
+    ZSTD_freeDCtx(_dctx);
+}
+
+sstring zstd_rpc_compressor::name() const {
+    return "ZSTD";
+}
+
+rpc::snd_buf zstd_rpc_compressor::uncompressed(size_t head_space, rpc::snd_buf data) {
+    temporary_buffer<char> header(head_space + header_size);
+    header.get_write()[head_space] = method_none;
+    write_le<uint32_t>(header.get_write() + head_space + 1, data.size);
+    fragments frags;
+    frags.push_back(std::move(header));
+    for (auto& f : take_fragments(data.bufs)) {
+        frags.push_back(std::move(f));
+    }
+    return make_buf<rpc::snd_buf>(std::move(frags), head_space + header_size + data.size);
+}
+
+void zstd_rpc_compressor::adjust_level(size_t size, clock_type::duration took) noexcept {
+    if (size < min_timed_size) {
+        return;
+    }
+    auto budget = cpu_budget_per_byte * size;
+    if (took > budget && _level > min_level) {
+        --_level;
+    } else if (took < budget / 4 && _level < max_level) {
+        ++_level;
+    }
+}
+
+rpc::snd_buf zstd_rpc_compressor::compress(size_t head_space, rpc::snd_buf data) {
+    if (data.size < min_compressed_size) {
+        return uncompressed(head_space, std::move(data));
+    }
+    if (_skip) {
+        --_skip;
+        return uncompressed(head_space, std::move(data));
+    }
+
+    auto start = clock_type::now();
+    check_zstd(ZSTD_CCtx_reset(_cctx, ZSTD_reset_session_only), "compression");
+    check_zstd(ZSTD_CCtx_setParameter(_cctx, ZSTD_c_compressionLevel, _level), "compression");
+    check_zstd(ZSTD_CCtx_setPledgedSrcSize(_cctx, data.size), "compression");
+
+    const size_t max_size = data.size * max_compression_ratio;
+    size_t compressed_size = 0;
+    fragments out;
+    temporary_buffer<char> chunk(head_space + header_size + std::min<size_t>(ZSTD_compressBound(data.size), rpc::snd_buf::chunk_size));
+    ZSTD_outBuffer obuf{chunk.get_write(), chunk.size(), head_space + header_size};
+
+    auto flush_chunk = [&] {
+        compressed_size += obuf.pos - (out.empty() ? head_space + header_size : 0);
+        chunk.trim(obuf.pos);
+        out.push_back(std::move(chunk));
+        chunk = temporary_buffer<char>(rpc::snd_buf::chunk_size);
+        obuf = ZSTD_outBuffer{chunk.get_write(), chunk.size(), 0};
+    };
+    // Returns false if the output grew too large to be worth sending.
+    auto feed = [&] (const char* p, size_t n, ZSTD_EndDirective mode) {
+        ZSTD_inBuffer ibuf{p, n, 0};
+        bool done;
+        do {
+            auto ret = ZSTD_compressStream2(_cctx, &obuf, &ibuf, mode);
+            check_zstd(ret, "compression");
+            done = mode == ZSTD_e_end ? ret == 0 : ibuf.pos == ibuf.size;
+            if (obuf.pos == obuf.size) {
+                flush_chunk();
+            }
+            if (compressed_size + obuf.pos > max_size) {
+                return false;
+            }
+        } while (!done);
+        return true;
+    };
+
+    bool ok = true;
+    for_each_fragment(data.bufs, [&] (const temporary_buffer<char>& f) {
+        ok = ok && feed(f.get(), f.size(), ZSTD_e_continue);
+    });
+    ok = ok && feed(nullptr, 0, ZSTD_e_end);
+    if (!ok) {
+        _skip = _next_skip;
+        _next_skip = std::min(_next_skip * 2, max_skipped_messages);
+        return uncompressed(head_space, std::move(data));
+    }
+    _next_skip = 1;
+    if (obuf.pos) {
+        flush_chunk();
+    }
+    adjust_level(data.size, clock_type::now() - start);
+
+    out.front().get_write()[head_space] = method_zstd;
+    write_le<uint32_t>(out.front().get_write() + head_space + 1, data.size);
+    return make_buf<rpc::snd_buf>(std::move(out), head_space + header_size + compressed_size);
+}
+
+rpc::rcv_buf zstd_rpc_compressor::decompress(rpc::rcv_buf data) {
+    auto in = take_fragments(data.bufs);
+
+    // The header may be split between fragments.
+    std::array<char, header_size> header;
+    size_t header_pos = 0;
+    for (auto& f : in) {
+        auto len = std::min(f.size(), header_size - header_pos);
+        std::copy_n(f.get(), len, header.data() + header_pos);
+        f.trim_front(len);
+        header_pos += len;
+    }
+    if (header_pos != header_size) {
+        throw std::runtime_error("Truncated ZSTD RPC message");
+    }
+    std::erase_if(in, [] (const temporary_buffer<char>& f) { return f.empty(); });
+    auto method = uint8_t(header[0]);
+    auto size = read_le<uint32_t>(header.data() + 1);
+
+    if (method == method_none) {
+        if (in.empty()) {
+            return rpc::rcv_buf(temporary_buffer<char>());
+        }
+        return make_buf<rpc::rcv_buf>(std::move(in), size);
+    }
+    if (method != method_zstd) {
+        throw std::runtime_error(format("Unknown ZSTD RPC message compression method {}", method));
+    }
+
+    check_zstd(ZSTD_DCtx_reset(_dctx, ZSTD_reset_session_only), "decompression");
+    fragments out;
+    size_t left = size;
+    auto next_chunk = [&] {
+        auto len = std::min<size_t>(left, rpc::snd_buf::chunk_size);
+        out.emplace_back(len);
+        left -= len;
+        return ZSTD_outBuffer{out.back().get_write(), len, 0};
+    };
+    ZSTD_outBuffer obuf = next_chunk();
+    // Data is decompressed until the end of the frame, which ZSTD_decompressStream() reports by returning 0.
+    size_t ret = 1;
+    auto step = [&] (ZSTD_inBuffer& ibuf) {
+        if (obuf.pos == obuf.size && left) {
+            obuf = next_chunk();
+        }
+        auto in_pos = ibuf.pos;
+        auto out_pos = obuf.pos;
+        ret = ZSTD_decompressStream(_dctx, &obuf, &ibuf);
+        check_zstd(ret, "decompression");
+        return ibuf.pos != in_pos || obuf.pos != out_pos;
+    };
+    for (auto& f : in) {
+        ZSTD_inBuffer ibuf{f.get(), f.size(), 0};
+        while (ibuf.pos < ibuf.size) {
+            if (!step(ibuf)) {
+                throw std::runtime_error("ZSTD RPC message is larger than its declared size");
+            }
+        }
+    }
+    // Flush what the decompressor still holds.
+    ZSTD_inBuffer no_input{nullptr, 0, 0};
+    while (ret && step(no_input)) {
+    }
+    if (ret || left || obuf.pos != obuf.size) {
+        throw std::runtime_error("Truncated ZSTD RPC message");
+    }
+    return make_buf<rpc::rcv_buf>(std::move(out), size);
+}
+
+}
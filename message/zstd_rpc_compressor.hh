@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include <seastar/rpc/rpc_types.hh>
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+namespace netw {
+
+// RPC compressor for links where bandwidth is worth more than CPU, like the
+// ones between datacenters.
+//
+// Every message is compressed as a separate zstd frame, preceded by a header
+// telling whether the message was compressed and its uncompressed size:
+//
+//   u8    method           // 0: uncompressed, 1: zstd frame
+//   le32  uncompressed_size
+//
+// The compressor adapts to the traffic of its connection:
+//  - messages which don't compress well are sent uncompressed, and after such
+//    a message the following ones are sent uncompressed without trying, for a
+//    number of messages growing exponentially while compression keeps failing;
+//  - the compression level is lowered when compressing costs more CPU per
+//    byte than cpu_budget_per_byte, and raised back when it costs much less.
+class zstd_rpc_compressor final : public seastar::rpc::compressor {
+    using clock_type = std::chrono::steady_clock;
+public:
+    static constexpr size_t header_size = 5;
+    static constexpr uint8_t method_none = 0;
+    static constexpr uint8_t method_zstd = 1;
+
+    static constexpr int min_level = 1;
+    static constexpr int max_level = 6;
+    static constexpr int default_level = 3;
+    // Messages smaller than this aren't worth compressing.
+    static constexpr size_t min_compressed_size = 256;
+    // Compressed messages must be at most this fraction of their size, or they're sent uncompressed.
+    static constexpr double max_compression_ratio = 0.875;
+    static constexpr unsigned max_skipped_messages = 64;
+    static constexpr std::chrono::nanoseconds cpu_budget_per_byte{5};
+    // Level changes are based on messages of at least this size, for which timing is meaningful.
+    static constexpr size_t min_timed_size = 16 * 1024;
+
+    class factory final : public seastar::rpc::compressor::factory {
+        const seastar::sstring _name = "ZSTD";
+    public:
+        const seastar::sstring& supported() const override {
+            return _name;
+        }
+        std::unique_ptr<seastar::rpc::compressor> negotiate(seastar::sstring feature, bool is_server) const override;
+    };
+private:
+    ZSTD_CCtx_s* _cctx;
+    ZSTD_DCtx_s* _dctx;
+    int _level = default_level;
+    // Messages to send uncompressed before trying to compress again, and the length of the next such streak.
+    unsigned _skip = 0;
+    unsigned _next_skip = 1;
+private:
+    seastar::rpc::snd_buf uncompressed(size_t head_space, seastar::rpc::snd_buf data);
+    void adjust_level(size_t size, clock_type::duration took) noexcept;
+public:
+    zstd_rpc_compressor();
+    ~zstd_rpc_compressor();
+    zstd_rpc_compressor(const zstd_rpc_compressor&) = delete;
+    zstd_rpc_compressor& operator=(const zstd_rpc_compressor&) = delete;
+
+    seastar::rpc::snd_buf compress(size_t head_space, seastar::rpc::snd_buf data) override;
+    seastar::rpc::rcv_buf decompress(seastar::rpc::rcv_buf data) override;
+    seastar::sstring name() const;
+
+    int level() const noexcept {
+        return _level;
+    }
+};
+
+}
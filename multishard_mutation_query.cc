@@ -832,9 +832,10 @@ class data_query_result_builder {
 
 public:
     data_query_result_builder(const schema& s, const query::partition_slice& slice, query::result_options opts,
-            query::result_memory_accounter&& accounter, const compact_for_query_state_v2& compaction_state, uint64_t tombstone_limit)
+            query::result_memory_accounter&& accounter, const compact_for_query_state_v2& compaction_state, uint64_t tombstone_limit,
+            const query::row_filter* filter)
         : _compaction_state(compaction_state)
-        , _res_builder(std::make_unique<query::result::builder>(slice, opts, std::move(accounter), tombstone_limit))
+        , _res_builder(std::make_unique<query::result::builder>(slice, opts, std::move(accounter), tombstone_limit, filter))
         , _builder(s, *_res_builder) { }
 
     void consume_new_partition(const dht::decorated_key& dk) { _builder.consume_new_partition(dk); }
@@ -845,6 +846,9 @@ class data_query_result_builder {
     stop_iteration consume_end_of_partition()  { return _builder.consume_end_of_partition(); }
     result_type consume_end_of_stream() {
         _builder.consume_end_of_stream();
+        if (_compaction_state.are_limits_reached()) {
+            _res_builder->on_limits_reached();
+        }
         if (_compaction_state.are_limits_reached() || _res_builder->is_short_read()) {
             return _res_builder->build(_compaction_state.current_full_position());
         }
@@ -881,6 +885,7 @@ future<std::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>
 
     return do_query_on_all_shards<data_query_result_builder>(db, query_schema, cmd, ranges, std::move(trace_state), timeout,
             [table_schema, &cmd, opts] (query::result_memory_accounter&& accounter, const compact_for_query_state_v2& compaction_state) {
-        return data_query_result_builder(*table_schema, cmd.slice, opts, std::move(accounter), compaction_state, cmd.tombstone_limit);
+        return data_query_result_builder(*table_schema, cmd.slice, opts, std::move(accounter), compaction_state, cmd.tombstone_limit,
+                cmd.filter ? &*cmd.filter : nullptr);
     });
 }
@@ -16,9 +16,8 @@
 class mutation_cleaner;
 
 class mutation_cleaner_impl final {
-    using snapshot_list = boost::intrusive::slist<partition_snapshot,
-        boost::intrusive::member_hook<partition_snapshot, boost::intrusive::slist_member_hook<>, &partition_snapshot::_cleaner_hook>,
-                boost::intrusive::cache_last<true>>;
+    using snapshot_list = boost::intrusive::list<partition_snapshot,
+        boost::intrusive::member_hook<partition_snapshot, boost::intrusive::list_member_hook<>, &partition_snapshot::_cleaner_hook>>;
     struct worker {
         condition_variable cv;
         snapshot_list snapshots;
@@ -63,6 +62,7 @@ class mutation_cleaner_impl final {
     bool empty() const noexcept { return _versions.empty(); }
     future<> drain();
     void merge_and_destroy(partition_snapshot&) noexcept;
+    void prioritize(partition_snapshot&) noexcept;
     void set_scheduling_group(seastar::scheduling_group sg) {
         _scheduling_group = sg;
         _worker_state->cv.broadcast();
@@ -96,6 +96,15 @@ void mutation_cleaner_impl::merge_and_destroy(partition_snapshot& ps) noexcept {
     }
 }
 
+inline
+void mutation_cleaner_impl::prioritize(partition_snapshot& ps) noexcept {
+    auto& snapshots = _worker_state->snapshots;
+    if (ps._cleaner_hook.is_linked() && &snapshots.front() != &ps) {
+        snapshots.erase(snapshots.iterator_to(ps));
+        snapshots.push_front(ps);
+    }
+}
+
 // Container for garbage partition_version objects, used for freeing them incrementally.
 //
 // Mutation cleaner extends the lifetime of mutation_partition without doing
@@ -178,4 +187,10 @@ class mutation_cleaner final {
     void merge_and_destroy(partition_snapshot& ps) {
         return _impl->merge_and_destroy(ps);
     }
+
+    // If the given snapshot is queued for merging by this cleaner, moves it to
+    // the front of the queue, so that it is merged before the others.
+    void prioritize(partition_snapshot& ps) noexcept {
+        _impl->prioritize(ps);
+    }
 };
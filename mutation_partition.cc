@@ -687,14 +687,21 @@ mutation_partition::clustered_row(const schema& s, clustering_key_view key) {
 
 deletable_row&
 mutation_partition::clustered_row(const schema& s, position_in_partition_view pos, is_dummy dummy, is_continuous continuous) {
+    return find_or_insert_clustered_row(s, pos, dummy, continuous).first.row();
+}
+
+std::pair<rows_entry&, bool>
+mutation_partition::find_or_insert_clustered_row(const schema& s, position_in_partition_view pos, is_dummy dummy, is_continuous continuous) {
     check_schema(s);
     auto i = _rows.find(pos, rows_entry::tri_compare(s));
+    bool inserted = false;
     if (i == _rows.end()) {
         auto e = alloc_strategy_unique_ptr<rows_entry>(
             current_allocator().construct<rows_entry>(s, pos, dummy, continuous));
         i = _rows.insert_before_hint(i, std::move(e), rows_entry::tri_compare(s)).first;
+        inserted = true;
     }
-    return i->row();
+    return {*i, inserted};
 }
 
 deletable_row&
@@ -2048,7 +2055,9 @@ uint64_t mutation_querier::consume_end_of_stream() {
     bool return_static_content_on_partition_with_no_rows =
         _pw.slice().options.contains(query::partition_slice::option::always_return_static_content) ||
         !has_ck_selector(_pw.ranges());
-    if (!_live_clustering_rows && (!return_static_content_on_partition_with_no_rows || !_live_data_in_static_row)) {
+    // A partition whose rows were all dropped by the filter doesn't match, even if
+    // it has static content.
+    if (!_live_clustering_rows && (!return_static_content_on_partition_with_no_rows || !_live_data_in_static_row || _filtered_clustering_rows)) {
         _pw.retract();
         return 0;
     } else {
@@ -2056,6 +2065,9 @@ uint64_t mutation_querier::consume_end_of_stream() {
         _pw.row_count() += live_rows;
         _pw.partition_count() += 1;
         std::move(*_rows_wr).end_rows().end_qr_partition();
+        if (!_pw.requested_result()) {
+            _pw.discard_serialized();
+        }
         return live_rows;
     }
 }
@@ -2085,6 +2097,11 @@ stop_iteration query_result_builder::consume(clustering_row&& cr, row_tombstone
         _stop = _rb.bump_and_check_tombstone_limit();
         return _stop;
     }
+    if (auto filter = _rb.filter(); filter && !filter->is_satisfied_by(_schema, cr.cells())) {
+        _mutation_consumer->on_filtered_row();
+        _rb.on_filtered_row();
+        return stop_iteration::no;
+    }
     _stop = _mutation_consumer->consume(std::move(cr), t);
     return _stop;
 }
@@ -1381,6 +1381,8 @@ class mutation_partition final {
     deletable_row& clustered_row(const schema& s, clustering_key&& key);
     deletable_row& clustered_row(const schema& s, clustering_key_view key);
     deletable_row& clustered_row(const schema& s, position_in_partition_view pos, is_dummy, is_continuous);
+    // Like clustered_row(), but returns the entry and tells whether it was inserted.
+    std::pair<rows_entry&, bool> find_or_insert_clustered_row(const schema& s, position_in_partition_view pos, is_dummy, is_continuous);
     // Throws if the row already exists or if the row was not inserted to the
     // last position (one or more greater row already exists).
     // Weak exception guarantees.
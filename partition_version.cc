@@ -544,6 +544,16 @@ partition_snapshot_ptr partition_entry::read(logalloc::region& r,
         }
     }
 
+    // Older versions which are still being merged by the cleaner have to be
+    // merged by every read of this entry. Have them merged first, so that
+    // the chains of partitions which are read are kept short.
+    for (partition_version* v = _version->next(); v; v = v->next()) {
+        if (v->is_referenced()) {
+            auto& older = partition_snapshot::container_of(v->_backref);
+            older.cleaner().prioritize(older);
+        }
+    }
+
     auto snp = make_lw_shared<partition_snapshot>(entry_schema, r, cleaner, this, tracker, phase);
     _snapshot = snp.get();
     return partition_snapshot_ptr(std::move(snp));
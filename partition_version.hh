@@ -15,6 +15,7 @@
 #include "utils/chunked_vector.hh"
 
 #include <boost/intrusive/parent_from_member.hpp>
+#include <boost/intrusive/list.hpp>
 #include <boost/intrusive/slist.hpp>
 
 class static_row;
@@ -294,7 +295,7 @@ class partition_snapshot : public enable_lw_shared_from_this<partition_snapshot>
     logalloc::region* _region;
     mutation_cleaner* _cleaner;
     cache_tracker* _tracker;
-    boost::intrusive::slist_member_hook<> _cleaner_hook;
+    boost::intrusive::list_member_hook<> _cleaner_hook;
     std::optional<std::pair<version_number_type, apply_resume>> _version_merging_state;
     bool _locked = false;
     friend class partition_entry;
@@ -530,6 +531,13 @@ class partition_entry {
         return _version->all_elements_reversed();
     }
 
+    // Returns the partition of the latest version if no snapshot refers to it,
+    // so that writes can be applied into it directly, or nullptr otherwise.
+    // Use only on non-evictable entries.
+    mutation_partition* unreferenced_latest_partition() noexcept {
+        return _snapshot ? nullptr : &_version->partition();
+    }
+
     // Tells whether this entry is locked.
     // Locked entries are undergoing an update and should not have their snapshots
     // detached from the entry.
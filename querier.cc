@@ -202,6 +202,64 @@ querier_cache::querier_cache(std::chrono::seconds entry_ttl)
     : _entry_ttl(entry_ttl) {
 }
 
+size_t querier_cache::memory_usage() const {
+    size_t ret = 0;
+    for (auto* index : {&_data_querier_index, &_mutation_querier_index, &_shard_mutation_querier_index}) {
+        for (auto& [key, q] : *index) {
+            ret += q->memory_usage();
+        }
+    }
+    return ret;
+}
+
+void querier_cache::record_eviction(query_id key, reader_concurrency_semaphore::evict_reason reason, std::chrono::seconds ttl) {
+    if (reason == reader_concurrency_semaphore::evict_reason::manual) {
+        return;
+    }
+    auto seq = _eviction_seq++;
+    _recent_evictions.insert_or_assign(key, eviction_record{reason, ttl, false, seq});
+    _recent_evictions_order.emplace_back(key, seq);
+    while (_recent_evictions_order.size() > max_recent_evictions) {
+        auto [oldest_key, oldest_seq] = _recent_evictions_order.front();
+        _recent_evictions_order.pop_front();
+        // The key may have been evicted again since, in which case its
+        // record is newer than this entry of the order.
+        if (auto it = _recent_evictions.find(oldest_key); it != _recent_evictions.end() && it->second.seq == oldest_seq) {
+            _recent_evictions.erase(it);
+        }
+    }
+}
+
+void querier_cache::record_miss(query_id key) {
+    auto it = _recent_evictions.find(key);
+    if (it == _recent_evictions.end() || it->second.missed) {
+        return;
+    }
+    it->second.missed = true;
+    if (it->second.reason == reader_concurrency_semaphore::evict_reason::time) {
+        ++_stats.misses_after_time_based_eviction;
+    } else {
+        ++_stats.misses_after_resource_based_eviction;
+    }
+}
+
+std::chrono::seconds querier_cache::admission_ttl(query_id key, std::optional<std::chrono::seconds> current_ttl) {
+    auto ttl = current_ttl.value_or(_entry_ttl);
+    auto it = _recent_evictions.find(key);
+    if (it == _recent_evictions.end()) {
+        return ttl;
+    }
+    auto record = it->second;
+    // The record is consumed, the next eviction of this query (if any)
+    // creates a new one.
+    _recent_evictions.erase(it);
+    if (record.reason != reader_concurrency_semaphore::evict_reason::time || !record.missed) {
+        return ttl;
+    }
+    ++_stats.extended_ttl_inserts;
+    return std::min(std::max(record.ttl, ttl) * 2, _entry_ttl * max_entry_ttl_factor);
+}
+
 struct querier_utils {
     static flat_mutation_reader_v2 get_reader(querier_base& q) noexcept {
         return std::move(std::get<flat_mutation_reader_v2>(q._reader));
@@ -215,6 +273,12 @@ struct querier_utils {
     static void set_inactive_read_handle(querier_base& q, reader_concurrency_semaphore::inactive_read_handle h) noexcept {
         q._reader = std::move(h);
     }
+    static std::optional<std::chrono::seconds> get_cache_ttl(const querier_base& q) noexcept {
+        return q._cache_ttl;
+    }
+    static void set_cache_ttl(querier_base& q, std::chrono::seconds ttl) noexcept {
+        q._cache_ttl = ttl;
+    }
 };
 
 template <typename Querier>
@@ -223,7 +287,6 @@ void querier_cache::insert_querier(
         querier_cache::index& index,
         querier_cache::stats& stats,
         Querier&& q,
-        std::chrono::seconds ttl,
         tracing::trace_state_ptr trace_state) {
     // FIXME: see #3159
     // In reverse mode flat_mutation_reader drops any remaining rows of the
@@ -238,12 +301,16 @@ void querier_cache::insert_querier(
 
     ++stats.inserts;
 
+    auto ttl = admission_ttl(key, querier_utils::get_cache_ttl(q));
+    querier_utils::set_cache_ttl(q, ttl);
+
     tracing::trace(trace_state, "Caching querier with key {}", key);
 
     auto& sem = q.permit().semaphore();
 
     auto irh = sem.register_inactive_read(querier_utils::get_reader(q));
     if (!irh) {
+        record_eviction(key, reader_concurrency_semaphore::evict_reason::permit, ttl);
         ++stats.resource_based_evictions;
         return;
     }
@@ -260,8 +327,9 @@ void querier_cache::insert_querier(
         --stats.population;
     });
 
-    auto notify_handler = [&stats, &index, it] (reader_concurrency_semaphore::evict_reason reason) {
+    auto notify_handler = [this, &stats, &index, it, key, ttl] (reader_concurrency_semaphore::evict_reason reason) {
         index.erase(it);
+        record_eviction(key, reason, ttl);
         switch (reason) {
             case reader_concurrency_semaphore::evict_reason::permit:
                 ++stats.resource_based_evictions;
@@ -289,15 +357,15 @@ void querier_cache::insert_querier(
 }
 
 void querier_cache::insert_data_querier(query_id key, querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(key, _data_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state));
+    insert_querier(key, _data_querier_index, _stats, std::move(q), std::move(trace_state));
 }
 
 void querier_cache::insert_mutation_querier(query_id key, querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(key, _mutation_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state));
+    insert_querier(key, _mutation_querier_index, _stats, std::move(q), std::move(trace_state));
 }
 
 void querier_cache::insert_shard_querier(query_id key, shard_mutation_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(key, _shard_mutation_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state));
+    insert_querier(key, _shard_mutation_querier_index, _stats, std::move(q), std::move(trace_state));
 }
 
 template <typename Querier>
@@ -314,6 +382,7 @@ std::optional<Querier> querier_cache::lookup_querier(
     ++stats.lookups;
     if (!base_ptr) {
         ++stats.misses;
+        record_miss(key);
         return std::nullopt;
     }
 
@@ -403,6 +472,7 @@ future<bool> querier_cache::evict_one() noexcept {
         }
         auto it = idx.begin();
         auto reader_opt = it->second->permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(*it->second));
+        record_eviction(it->first, reader_concurrency_semaphore::evict_reason::permit, querier_utils::get_cache_ttl(*it->second).value_or(_entry_ttl));
         idx.erase(it);
         ++_stats.resource_based_evictions;
         --_stats.population;
@@ -17,6 +17,8 @@
 
 #include <boost/intrusive/set.hpp>
 
+#include <deque>
+#include <unordered_map>
 #include <variant>
 
 namespace query {
@@ -69,6 +71,8 @@ class querier_base {
     std::variant<flat_mutation_reader_v2, reader_concurrency_semaphore::inactive_read_handle> _reader;
     dht::partition_ranges_view _query_ranges;
     querier_config _qr_config;
+    // The TTL the querier was last cached with, kept for the next pages.
+    std::optional<std::chrono::seconds> _cache_ttl;
 
 public:
     querier_base(reader_permit permit, lw_shared_ptr<const dht::partition_range> range,
@@ -309,26 +313,61 @@ class querier_cache {
         uint64_t resource_based_evictions = 0;
         // The number of queriers currently in the cache.
         uint64_t population = 0;
+        // The subset of misses for queries whose last querier was evicted
+        // because its TTL expired.
+        uint64_t misses_after_time_based_eviction = 0;
+        // The subset of misses for queries whose last querier was evicted to
+        // free up resources.
+        uint64_t misses_after_resource_based_eviction = 0;
+        // The subset of inserts which were given an extended TTL, because the
+        // query came back after its previous querier expired.
+        uint64_t extended_ttl_inserts = 0;
     };
 
     using index = std::unordered_multimap<query_id, std::unique_ptr<querier_base>>;
 
+    // The number of recently evicted queries remembered for admission.
+    static constexpr size_t max_recent_evictions = 4096;
+    // The TTL of an entry is extended up to this multiple of the entry TTL.
+    static constexpr unsigned max_entry_ttl_factor = 8;
+
 private:
+    struct eviction_record {
+        reader_concurrency_semaphore::evict_reason reason;
+        std::chrono::seconds ttl;
+        // Whether the query came back after the eviction.
+        bool missed = false;
+        uint64_t seq;
+    };
+
     index _data_querier_index;
     index _mutation_querier_index;
     index _shard_mutation_querier_index;
     std::chrono::seconds _entry_ttl;
     stats _stats;
     gate _closing_gate;
+    // Queries whose querier was evicted recently. Bounded to
+    // max_recent_evictions, _recent_evictions_order is oldest first.
+    std::unordered_map<query_id, eviction_record> _recent_evictions;
+    std::deque<std::pair<query_id, uint64_t>> _recent_evictions_order;
+    uint64_t _eviction_seq = 0;
 
 private:
+    void record_eviction(query_id key, reader_concurrency_semaphore::evict_reason reason, std::chrono::seconds ttl);
+    void record_miss(query_id key);
+    // The TTL of a new entry for the given query, given the TTL its querier
+    // was cached with for the previous page, if any. Queries which came back
+    // after their previous querier expired are expected to do so again, so
+    // their TTL is doubled, up to max_entry_ttl_factor times the entry TTL.
+    // The querier keeps the TTL for the following pages.
+    std::chrono::seconds admission_ttl(query_id key, std::optional<std::chrono::seconds> current_ttl);
+
     template <typename Querier>
     void insert_querier(
             query_id key,
             querier_cache::index& index,
             querier_cache::stats& stats,
             Querier&& q,
-            std::chrono::seconds ttl,
             tracing::trace_state_ptr trace_state);
 
     template <typename Querier>
@@ -416,6 +455,9 @@ class querier_cache {
     const stats& get_stats() const {
         return _stats;
     }
+
+    // The memory used by the cached queriers, that is, by their readers.
+    size_t memory_usage() const;
 };
 
 } // namespace query
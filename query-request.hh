@@ -28,6 +28,7 @@
 
 class position_in_partition_view;
 class partition_slice_builder;
+class row;
 
 using query_id = utils::tagged_uuid<struct query_id_tag>;
 
@@ -276,6 +277,33 @@ enum class tombstone_limit : uint64_t { max = max_tombstones };
 
 using is_first_page = bool_class<class is_first_page_tag>;
 
+// Restrictions on regular columns which rows have to satisfy to be included
+// in the result of a data query.
+//
+// Sent by coordinators of filtering queries, so that replicas don't send rows
+// which the coordinator would filter out anyway. The coordinator still checks
+// all restrictions on the rows it receives, so replicas which don't know about
+// the filter are free to ignore it. A row in which a restricted column is null
+// satisfies only `neq`.
+struct row_filter {
+    enum class comparison_op : uint8_t {
+        eq,
+        neq,
+        lt,
+        lte,
+        gt,
+        gte,
+    };
+    struct comparison {
+        column_id column; // Of a regular, atomic column
+        comparison_op op;
+        bytes value;
+    };
+    std::vector<comparison> comparisons;
+
+    bool is_satisfied_by(const schema& s, const row& cells) const;
+};
+
 // Full specification of a query to the database.
 // Intended for passing across replicas.
 // Can be accessed across cores.
@@ -308,6 +336,10 @@ class read_command {
     uint32_t row_limit_high_bits;
     // Cut the page after processing this many tombstones (even if the page is empty).
     uint64_t tombstone_limit;
+    // Rows of a data query result which don't satisfy the filter are dropped.
+    // They still count towards the row limit, and a page which hit the limit
+    // after dropping some rows is marked as a short read.
+    std::optional<row_filter> filter;
     api::timestamp_type read_timestamp; // not serialized
     db::allow_per_partition_rate_limit allow_limit; // not serialized
 public:
@@ -323,7 +355,8 @@ class read_command {
                  query::is_first_page is_first_page,
                  std::optional<query::max_result_size> max_result_size,
                  uint32_t row_limit_high_bits,
-                 uint64_t tombstone_limit)
+                 uint64_t tombstone_limit,
+                 std::optional<row_filter> filter = std::nullopt)
         : cf_id(std::move(cf_id))
         , schema_version(std::move(schema_version))
         , slice(std::move(slice))
@@ -336,6 +369,7 @@ class read_command {
         , max_result_size(max_result_size)
         , row_limit_high_bits(row_limit_high_bits)
         , tombstone_limit(tombstone_limit)
+        , filter(std::move(filter))
         , read_timestamp(api::new_timestamp())
         , allow_limit(db::allow_per_partition_rate_limit::no)
     { }
@@ -403,6 +437,17 @@ struct forward_request {
     db::consistency_level cl;
     lowres_clock::time_point timeout;
     std::optional<std::vector<aggregation_info>> aggregation_infos;
+    // Set for queries with GROUP BY. Names the grouping columns: the full
+    // partition key followed by a prefix of the clustering key.
+    std::optional<std::vector<sstring>> group_by_column_names;
+    // For grouped requests, the number of groups the coordinator is willing
+    // to take in a single result. Results with more groups are cut short
+    // once past this number, and the coordinator aggregates the query itself.
+    std::optional<uint64_t> max_groups;
+
+    bool is_grouped() const {
+        return group_by_column_names && !group_by_column_names->empty();
+    }
 };
 
 std::ostream& operator<<(std::ostream& out, const forward_request& r);
@@ -412,6 +457,11 @@ std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_i
 struct forward_result {
     // vector storing query result for each selected column
     std::vector<bytes_opt> query_results;
+    // Results of grouped requests, one row per group: the values of the
+    // grouping columns followed by the partial result of each aggregate.
+    // The coordinator finalizes the aggregates and sorts the rows in the
+    // ring order of their groups.
+    std::optional<std::vector<std::vector<bytes_opt>>> grouped_query_results;
 
     struct printer {
         const std::vector<::shared_ptr<db::functions::aggregate_function>>& functions;
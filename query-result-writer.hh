@@ -80,6 +80,15 @@ class result::partition_writer {
         _pw.rollback(_pos);
     }
 
+    // Drops the serialized partition element, but keeps its contribution to the
+    // digest and to the counters. For digest-only results, whose partitions
+    // are never sent, so that the result doesn't grow with the number of
+    // partitions hashed into it. Can also be called after the element is
+    // finalized, as long as it is the last one.
+    void discard_serialized() {
+        _pw.rollback(_pos);
+    }
+
     const clustering_row_ranges& ranges() const {
         return _ranges;
     }
@@ -114,20 +123,37 @@ class result::builder {
     result_memory_accounter _memory_accounter;
     const uint64_t _tombstone_limit = query::max_tombstones;
     uint64_t _tombstones = 0;
+    const row_filter* _filter = nullptr;
+    uint64_t _filtered_rows = 0;
 public:
-    builder(const partition_slice& slice, result_options options, result_memory_accounter memory_accounter, uint64_t tombstone_limit)
+    builder(const partition_slice& slice, result_options options, result_memory_accounter memory_accounter, uint64_t tombstone_limit,
+            const row_filter* filter = nullptr)
         : _slice(slice)
         , _w(ser::writer_of_query_result<bytes_ostream>(_out).start_partitions())
         , _request(options.request)
         , _digest(digester(options.digest_algo))
         , _memory_accounter(std::move(memory_accounter))
         , _tombstone_limit(tombstone_limit)
+        , _filter(filter ? (filter->comparisons.empty() ? nullptr : filter) : nullptr)
     { }
     builder(builder&&) = delete; // _out is captured by reference
 
     void mark_as_short_read() { _short_read = short_read::yes; }
     short_read is_short_read() const { return _short_read; }
 
+    const row_filter* filter() const { return _filter; }
+    void on_filtered_row() { ++_filtered_rows; }
+
+    // Rows dropped by the filter still count towards the row limit, so if the
+    // limit was reached, the page may have fewer rows than the limit even
+    // though there is more data. Marks such pages as short reads, so that the
+    // coordinator knows to ask for the next one.
+    void on_limits_reached() {
+        if (_filtered_rows && _slice.options.contains<partition_slice::option::allow_short_read>()) {
+            mark_as_short_read();
+        }
+    }
+
     result_memory_accounter& memory_accounter() { return _memory_accounter; }
 
     stop_iteration bump_and_check_tombstone_limit() {
@@ -206,6 +232,7 @@ class mutation_querier {
     ser::qr_partition__static_row__cells<bytes_ostream> _static_cells_wr;
     bool _live_data_in_static_row{};
     uint64_t _live_clustering_rows = 0;
+    uint64_t _filtered_clustering_rows = 0;
     std::optional<ser::qr_partition__rows<bytes_ostream>> _rows_wr;
 private:
     void query_static_row(const row& r, tombstone current_tombstone);
@@ -219,6 +246,8 @@ class mutation_querier {
     // Requires that cr.has_any_live_data()
     stop_iteration consume(clustering_row&& cr, row_tombstone current_tombstone);
     stop_iteration consume(range_tombstone_change&&) { return stop_iteration::no; }
+    // Called instead of consume() for live rows dropped by the row filter.
+    void on_filtered_row() { ++_filtered_clustering_rows; }
     uint64_t consume_end_of_stream();
 };
 
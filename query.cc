@@ -54,6 +54,36 @@ std::ostream& operator<<(std::ostream& out, const partition_slice& ps) {
     return out << "}";
 }
 
+bool row_filter::is_satisfied_by(const schema& s, const row& cells) const {
+    for (auto& c : comparisons) {
+        const column_definition& cdef = s.regular_column_at(c.column);
+        auto cell = cells.find_cell(c.column);
+        if (!cell || !cell->as_atomic_cell(cdef).is_live()) {
+            if (c.op != comparison_op::neq) {
+                return false;
+            }
+            continue;
+        }
+        auto value = cell->as_atomic_cell(cdef).value();
+        auto rhs = managed_bytes_view(bytes_view(c.value));
+        auto& type = cdef.type->without_reversed();
+        bool satisfied;
+        switch (c.op) {
+        case comparison_op::eq: satisfied = type.equal(value, rhs); break;
+        case comparison_op::neq: satisfied = !type.equal(value, rhs); break;
+        case comparison_op::lt: satisfied = type.compare(value, rhs) < 0; break;
+        case comparison_op::lte: satisfied = type.compare(value, rhs) <= 0; break;
+        case comparison_op::gt: satisfied = type.compare(value, rhs) > 0; break;
+        case comparison_op::gte: satisfied = type.compare(value, rhs) >= 0; break;
+        default: satisfied = false;
+        }
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::ostream& operator<<(std::ostream& out, const read_command& r) {
     return out << "read_command{"
         << "cf_id=" << r.cf_id
@@ -65,6 +95,7 @@ std::ostream& operator<<(std::ostream& out, const read_command& r) {
         << ", query_uuid=" << r.query_uuid
         << ", is_first_page=" << r.is_first_page
         << ", read_timestamp=" << r.read_timestamp
+        << ", filtered=" << bool(r.filter)
         << "}";
 }
 
@@ -96,6 +127,12 @@ std::ostream& operator<<(std::ostream& out, const forward_request& r) {
     if(r.aggregation_infos) {
         out << ", aggregation_infos=[" << join(",", r.aggregation_infos.value()) << "]";
     }
+    if (r.group_by_column_names) {
+        out << ", group_by_column_names=[" << join(",", *r.group_by_column_names) << "]";
+    }
+    if (r.max_groups) {
+        out << ", max_groups=" << *r.max_groups;
+    }
     return out << ", cmd=" << r.cmd
         << ", pr=" << r.pr
         << ", cl=" << r.cl
@@ -422,6 +459,9 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
 }
 
 std::ostream& operator<<(std::ostream& out, const query::forward_result::printer& p) {
+    if (p.res.grouped_query_results) {
+        return out << "[" << p.res.grouped_query_results->size() << " groups]";
+    }
     if (p.functions.size() != p.res.query_results.size()) {
         return out << "[malformed forward_result (" << p.res.query_results.size()
             << " results, " << p.functions.size() << " aggregates)]";
@@ -884,12 +884,53 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 _state_machine->drop_snapshot(snp_id);
             }
 
+            // Update RPC server address mappings. Add servers which are joining
+            // the cluster according to the new configuration (obtained from the
+            // last_conf_idx).
+            //
+            // It should be done prior to sending the messages since the RPC
+            // module needs to know who should it send the messages to (actual
+            // network addresses of the joining servers).
+            rpc_config_diff rpc_diff;
+            if (batch.configuration) {
+                rpc_diff = diff_address_sets(get_rpc_config(), *batch.configuration);
+                for (const auto& addr: rpc_diff.joining) {
+                    add_to_rpc_config(addr);
+                    _rpc->add_server(addr);
+                }
+            }
+
+            // Sends the messages of the batch which satisfy the predicate, at most once.
+            auto send_messages = [this, &batch, sent = std::vector<bool>(batch.messages.size())] (auto pred) mutable {
+                for (size_t i = 0; i < batch.messages.size(); ++i) {
+                    auto& m = batch.messages[i];
+                    if (sent[i] || !pred(m.second)) {
+                        continue;
+                    }
+                    sent[i] = true;
+                    try {
+                        send_message(m.first, std::move(m.second));
+                    } catch(...) {
+                        // Not being able to send a message is not a critical error
+                        logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
+                    }
+                }
+            };
+
             if (batch.log_entries.size()) {
                 auto& entries = batch.log_entries;
 
                 if (last_stable >= entries[0]->idx) {
                     co_await _persistence->truncate_log(entries[0]->idx);
                     _stats.truncate_persisted_log++;
+                } else {
+                    // Only a leader sends entries, and it may replicate them while
+                    // it is still persisting them itself (section 10.2.1 of the
+                    // Raft thesis). The commit index in these messages can't
+                    // cover entries of this batch, and entries committed thanks
+                    // to them are only output by the following batches, which
+                    // are processed after this one is persisted.
+                    send_messages([] (const rpc_message& m) { return std::holds_alternative<append_request>(m); });
                 }
 
                 utils::get_local_injector().inject("store_log_entries/test-failure",
@@ -903,31 +944,8 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 _stats.persisted_log_entries += entries.size();
             }
 
-            // Update RPC server address mappings. Add servers which are joining
-            // the cluster according to the new configuration (obtained from the
-            // last_conf_idx).
-            //
-            // It should be done prior to sending the messages since the RPC
-            // module needs to know who should it send the messages to (actual
-            // network addresses of the joining servers).
-            rpc_config_diff rpc_diff;
-            if (batch.configuration) {
-                rpc_diff = diff_address_sets(get_rpc_config(), *batch.configuration);
-                for (const auto& addr: rpc_diff.joining) {
-                    add_to_rpc_config(addr);
-                    _rpc->add_server(addr);
-                }
-            }
-
-             // After entries are persisted we can send messages.
-            for (auto&& m : batch.messages) {
-                try {
-                    send_message(m.first, std::move(m.second));
-                } catch(...) {
-                    // Not being able to send a message is not a critical error
-                    logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
-                }
-            }
+            // After entries are persisted we can send messages.
+            send_messages([] (const rpc_message&) { return true; });
 
             if (batch.configuration) {
                 for (const auto& addr: rpc_diff.leaving) {
@@ -10,6 +10,7 @@
 #include "range_tombstone_list.hh"
 #include "utils/allocation_strategy.hh"
 #include "utils/amortized_reserve.hh"
+#include "utils/stall_attribution.hh"
 #include <seastar/util/variant_utils.hh>
 
 range_tombstone_list::range_tombstone_list(const range_tombstone_list& x)
@@ -439,12 +440,25 @@ bool range_tombstone_list::equal(const schema& s, const range_tombstone_list& ot
 }
 
 stop_iteration range_tombstone_list::apply_monotonically(const schema& s, range_tombstone_list&& list, is_preemptible preemptible) {
+    utils::stall_attribution::scope stall_scope(utils::stall_attribution::operation::range_tombstone_apply);
     auto del = current_deleter<range_tombstone_entry>();
+    position_in_partition::less_compare less(s);
     auto it = list.begin();
     while (it != list.end()) {
-        // FIXME: Optimize by stealing the entry
-        apply_monotonically(s, it->tombstone());
-        it = list._tombstones.erase_and_dispose(it, del);
+        auto& rt = *it;
+        auto next = _tombstones.upper_bound(rt.position(), [less] (auto&& sb, auto&& e) {
+            return less(sb, e.end_position());
+        });
+        // An entry which neither overlaps nor touches any of ours can be moved
+        // over as is, sparing the allocation and the merge.
+        if ((next == _tombstones.end() || less(rt.end_position(), next->position()))
+                && (next == _tombstones.begin() || less(std::prev(next)->end_position(), rt.position()))) {
+            it = list._tombstones.erase(it);
+            _tombstones.insert_before(next, rt);
+        } else {
+            apply_monotonically(s, rt.tombstone());
+            it = list._tombstones.erase_and_dispose(it, del);
+        }
         if (preemptible && need_preempt()) {
             return stop_iteration::no;
         }
@@ -12,6 +12,7 @@
 #include <seastar/util/lazy.hh>
 #include <seastar/util/log.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 
 #include "reader_concurrency_semaphore.hh"
@@ -82,6 +83,7 @@ class reader_permit::impl
     bool _marked_as_blocked = false;
     db::timeout_clock::time_point _timeout;
     query::max_result_size _max_result_size{query::result_memory_limiter::unlimited_result_size};
+    reader_permit::read_stats _read_stats;
 
 private:
     void on_permit_used() {
@@ -326,6 +328,10 @@ class reader_permit::impl
     void set_max_result_size(query::max_result_size s) {
         _max_result_size = std::move(s);
     }
+
+    reader_permit::read_stats& get_read_stats() noexcept {
+        return _read_stats;
+    }
 };
 
 static_assert(std::is_nothrow_copy_constructible_v<reader_permit>);
@@ -434,6 +440,10 @@ void reader_permit::set_max_result_size(query::max_result_size s) {
     _impl->set_max_result_size(std::move(s));
 }
 
+reader_permit::read_stats& reader_permit::get_read_stats() noexcept {
+    return _impl->get_read_stats();
+}
+
 std::ostream& operator<<(std::ostream& os, reader_permit::state s) {
     switch (s) {
         case reader_permit::state::waiting:
@@ -458,6 +468,12 @@ std::ostream& operator<<(std::ostream& os, reader_permit::state s) {
     return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const reader_permit::read_stats& s) {
+    fmt::print(os, "sstables read: {}, disk reads: {}, disk bytes read: {}, cache row hits: {}, cache row misses: {}",
+            s.sstables_read, s.disk_reads, s.disk_bytes_read, s.cache_row_hits, s.cache_row_misses);
+    return os;
+}
+
 namespace {
 
 struct permit_stats {
@@ -637,7 +653,6 @@ void reader_concurrency_semaphore::signal(const resources& r) noexcept {
 reader_concurrency_semaphore::reader_concurrency_semaphore(int count, ssize_t memory, sstring name, size_t max_queue_length)
     : _initial_resources(count, memory)
     , _resources(count, memory)
-    , _wait_list(expiry_handler(*this))
     , _ready_list(max_queue_length)
     , _name(std::move(name))
     , _max_queue_length(max_queue_length)
@@ -669,9 +684,9 @@ reader_concurrency_semaphore::inactive_read_handle reader_concurrency_semaphore:
     permit_impl.on_register_as_inactive();
     // Implies _inactive_reads.empty(), we don't queue new readers before
     // evicting all inactive reads.
-    // Checking the _wait_list covers the count resources only, so check memory
+    // Checking the wait queues covers the count resources only, so check memory
     // separately.
-    if (_wait_list.empty() && _resources.memory > 0) {
+    if (!waiters() && _resources.memory > 0) {
       try {
         auto irp = std::make_unique<inactive_read>(std::move(reader));
         auto& ir = *irp;
@@ -842,7 +857,7 @@ bool reader_concurrency_semaphore::all_used_permits_are_stalled() const {
 }
 
 std::exception_ptr reader_concurrency_semaphore::check_queue_size(std::string_view queue_name) {
-    if ((_wait_list.size() + _ready_list.size()) >= _max_queue_length) {
+    if ((waiters() + _ready_list.size()) >= _max_queue_length) {
         _stats.total_reads_shed_due_to_overload++;
         maybe_dump_reader_permit_diagnostics(*this, _permit_list, fmt::format("{} queue overload", queue_name));
         return std::make_exception_ptr(std::runtime_error(format("{}: {} queue overload", _name, queue_name)));
@@ -850,15 +865,108 @@ std::exception_ptr reader_concurrency_semaphore::check_queue_size(std::string_vi
     return {};
 }
 
+// Rejects reads which would time out waiting for admission anyway, before
+// they take a place in the queue, so that the reads ahead of them don't
+// time out too. The wait is predicted from the recent rate of admissions.
+std::exception_ptr reader_concurrency_semaphore::check_deadline(const reader_permit& permit) {
+    auto queued = waiters() + _ready_list.size();
+    if (!queued || _queued_admission_interval.count() == 0 || permit.timeout() == db::no_timeout) {
+        return {};
+    }
+    auto predicted_wait = std::chrono::duration_cast<db::timeout_clock::duration>(_queued_admission_interval * queued);
+    auto now = db::timeout_clock::now();
+    if (permit.timeout() - now > predicted_wait) {
+        return {};
+    }
+    _stats.total_reads_shed_due_to_deadline++;
+    return std::make_exception_ptr(std::runtime_error(format("{}: wait queue overload: predicted admission wait of {} reads ({}ms) exceeds the read's timeout",
+            _name, queued, std::chrono::duration_cast<std::chrono::milliseconds>(predicted_wait).count())));
+}
+
+void reader_concurrency_semaphore::on_queued_admission() noexcept {
+    static constexpr double alpha = 0.1;
+    auto now = db::timeout_clock::now();
+    std::chrono::duration<double> interval = now - _last_queued_admission;
+    _last_queued_admission = now;
+    _queued_admission_interval += alpha * (interval - _queued_admission_interval);
+}
+
+reader_concurrency_semaphore::wait_queue& reader_concurrency_semaphore::get_wait_queue(scheduling_group sg) {
+    auto it = std::find_if(_wait_queues.begin(), _wait_queues.end(), [sg] (const std::unique_ptr<wait_queue>& q) { return q->sg == sg; });
+    if (it != _wait_queues.end()) {
+        return **it;
+    }
+    return *_wait_queues.emplace_back(std::make_unique<wait_queue>(sg, *this));
+}
+
+reader_concurrency_semaphore::wait_queue* reader_concurrency_semaphore::next_wait_queue() noexcept {
+    wait_queue* next = nullptr;
+    for (auto& q : _wait_queues) {
+        if (!q->list.empty() && (!next || q->virtual_time < next->virtual_time)) {
+            next = q.get();
+        }
+    }
+    return next;
+}
+
+double reader_concurrency_semaphore::admission_cost(const resources& r) const noexcept {
+    return std::max(double(r.count) / std::max(_initial_resources.count, 1), double(r.memory) / std::max(_initial_resources.memory, ssize_t(1)));
+}
+
+size_t reader_concurrency_semaphore::waiters() const {
+    size_t n = 0;
+    for (auto& q : _wait_queues) {
+        n += q->list.size();
+    }
+    return n;
+}
+
+size_t reader_concurrency_semaphore::waiters(scheduling_group sg) const {
+    auto it = std::find_if(_wait_queues.begin(), _wait_queues.end(), [sg] (const std::unique_ptr<wait_queue>& q) { return q->sg == sg; });
+    return it == _wait_queues.end() ? 0 : (*it)->list.size();
+}
+
+void reader_concurrency_semaphore::set_admission_weight(scheduling_group sg, float weight) {
+    if (weight <= 0) {
+        throw std::invalid_argument(format("{}: admission weight of scheduling group {} must be positive, got {}", _name, sg.name(), weight));
+    }
+    auto& q = get_wait_queue(sg);
+    q.weight = weight;
+    if (std::exchange(q.has_metrics, true)) {
+        return;
+    }
+    namespace sm = seastar::metrics;
+    _metrics.add_group("reader_concurrency_semaphore", {
+        sm::make_gauge("queued_reads", [&q] { return q.list.size(); },
+                       sm::description("Holds the number of reads queued for admission from the scheduling group."),
+                       {sm::label("semaphore")(_name), sm::label("group")(sg.name())}),
+    });
+}
+
 future<> reader_concurrency_semaphore::enqueue_waiter(reader_permit permit, read_func func) {
     if (auto ex = check_queue_size("wait")) {
         return make_exception_future<>(std::move(ex));
     }
+    if (auto ex = check_deadline(permit)) {
+        return make_exception_future<>(std::move(ex));
+    }
+    if (!waiters() && _ready_list.empty()) {
+        // The wait of this read starts the interval to its admission.
+        _last_queued_admission = db::timeout_clock::now();
+    }
+    auto& q = get_wait_queue(current_scheduling_group());
+    if (q.list.empty()) {
+        // Don't let a queue which was idle catch up with the ones which were
+        // busy meanwhile, by admitting a burst of its reads.
+        if (auto* next = next_wait_queue()) {
+            q.virtual_time = std::max(q.virtual_time, next->virtual_time);
+        }
+    }
     promise<> pr;
     auto fut = pr.get_future();
     permit.on_waiting();
     auto timeout = permit.timeout();
-    _wait_list.push_back(entry(std::move(pr), std::move(permit), std::move(func)), timeout);
+    q.list.push_back(entry(std::move(pr), std::move(permit), std::move(func)), timeout);
     ++_stats.reads_enqueued;
     return fut;
 }
@@ -867,7 +975,7 @@ void reader_concurrency_semaphore::evict_readers_in_background() {
     // Evict inactive readers in the background while wait list isn't empty
     // This is safe since stop() closes _gate;
     (void)with_gate(_close_readers_gate, [this] {
-        return do_until([this] { return _wait_list.empty() || _inactive_reads.empty(); }, [this] {
+        return do_until([this] { return !waiters() || _inactive_reads.empty(); }, [this] {
             return detach_inactive_reader(_inactive_reads.front(), evict_reason::permit).close();
         });
     });
@@ -877,7 +985,7 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
     if (!_execution_loop_future) {
         _execution_loop_future.emplace(execution_loop());
     }
-    if (!_wait_list.empty() || !_ready_list.empty()) {
+    if (waiters() || !_ready_list.empty()) {
         return enqueue_waiter(std::move(permit), std::move(func));
     }
 
@@ -902,11 +1010,17 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
 }
 
 void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
-    while (!_wait_list.empty() && _ready_list.empty() && has_available_units(_wait_list.front().permit.base_resources()) && all_used_permits_are_stalled()) {
-        auto& x = _wait_list.front();
+    while (_ready_list.empty() && all_used_permits_are_stalled()) {
+        auto* q = next_wait_queue();
+        if (!q || !has_available_units(q->list.front().permit.base_resources())) {
+            break;
+        }
+        auto& x = q->list.front();
+        q->virtual_time += admission_cost(x.permit.base_resources()) / q->weight;
         try {
             x.permit.on_admission();
             ++_stats.reads_admitted;
+            on_queued_admission();
             if (x.func) {
                 _ready_list.push(std::move(x));
             } else {
@@ -915,7 +1029,7 @@ void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
         } catch (...) {
             x.pr.set_exception(std::current_exception());
         }
-        _wait_list.pop_front();
+        q->list.pop_front();
     }
 }
 
@@ -997,9 +1111,11 @@ void reader_concurrency_semaphore::broken(std::exception_ptr ex) {
     if (!ex) {
         ex = std::make_exception_ptr(broken_semaphore{});
     }
-    while (!_wait_list.empty()) {
-        _wait_list.front().pr.set_exception(ex);
-        _wait_list.pop_front();
+    for (auto& q : _wait_queues) {
+        while (!q->list.empty()) {
+            q->list.front().pr.set_exception(ex);
+            q->list.pop_front();
+        }
     }
 }
 
@@ -1010,11 +1126,17 @@ std::string reader_concurrency_semaphore::dump_diagnostics(unsigned max_lines) c
 }
 
 // A file that tracks the memory usage of buffers resulting from read
-// operations.
+// operations, and accounts the reads to the permit's read stats.
 class tracking_file_impl : public file_impl {
     file _tracked_file;
     reader_permit _permit;
 
+private:
+    void account_read(size_t size) noexcept {
+        auto& stats = _permit.get_read_stats();
+        ++stats.disk_reads;
+        stats.disk_bytes_read += size;
+    }
 public:
     tracking_file_impl(file file, reader_permit permit)
         : file_impl(*get_file_impl(file))
@@ -1036,11 +1158,17 @@ class tracking_file_impl : public file_impl {
     }
 
     virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->read_dma(pos, buffer, len, pc);
+        return get_file_impl(_tracked_file)->read_dma(pos, buffer, len, pc).then([this] (size_t size) {
+            account_read(size);
+            return size;
+        });
     }
 
     virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->read_dma(pos, iov, pc);
+        return get_file_impl(_tracked_file)->read_dma(pos, iov, pc).then([this] (size_t size) {
+            account_read(size);
+            return size;
+        });
     }
 
     virtual future<> flush(void) override {
@@ -1081,6 +1209,7 @@ class tracking_file_impl : public file_impl {
 
     virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
         return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([this, units = _permit.consume_memory(range_size)] (temporary_buffer<uint8_t> buf) {
+            account_read(buf.size());
             return make_ready_future<temporary_buffer<uint8_t>>(make_tracked_temporary_buffer(std::move(buf), _permit));
         });
     }
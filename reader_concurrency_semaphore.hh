@@ -13,8 +13,11 @@
 #include <seastar/core/gate.hh>
 #include <seastar/core/queue.hh>
 #include <seastar/core/expiring_fifo.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/metrics_registration.hh>
 #include "reader_permit.hh"
 #include "readers/flat_mutation_reader_v2.hh"
+#include "utils/timer_wheel.hh"
 
 namespace bi = boost::intrusive;
 
@@ -71,6 +74,9 @@ class reader_concurrency_semaphore {
         uint64_t total_failed_reads = 0;
         // Total number of reads rejected because the admission queue reached its max capacity
         uint64_t total_reads_shed_due_to_overload = 0;
+        // Total number of reads rejected because they were predicted to wait for
+        // admission past their timeout
+        uint64_t total_reads_shed_due_to_deadline = 0;
         // Total number of reads admitted, via all admission paths.
         uint64_t reads_admitted = 0;
         // Total number of reads enqueued to wait for admission.
@@ -114,7 +120,7 @@ class reader_concurrency_semaphore {
     struct inactive_read : public bi::list_base_hook<bi::link_mode<bi::auto_unlink>> {
         flat_mutation_reader_v2 reader;
         eviction_notify_handler notify_handler;
-        timer<lowres_clock> ttl_timer;
+        utils::coarse_timer ttl_timer;
         inactive_read_handle* handle = nullptr;
 
         explicit inactive_read(flat_mutation_reader_v2 reader_) noexcept
@@ -126,6 +132,23 @@ class reader_concurrency_semaphore {
 
     using inactive_reads_type = bi::list<inactive_read, bi::constant_time_size<false>>;
 
+    // Waiters enqueued from the same scheduling group.
+    //
+    // Queues are served in weighted fair order: the next waiter to be admitted
+    // is the front of the non-empty queue with the smallest virtual time,
+    // which grows by the dominant share (count or memory) of the resources
+    // each admitted waiter asked for, divided by the weight of the queue.
+    struct wait_queue {
+        scheduling_group sg;
+        float weight = 1.0f;
+        double virtual_time = 0;
+        bool has_metrics = false;
+        expiring_fifo<entry, expiry_handler, db::timeout_clock> list;
+
+        wait_queue(scheduling_group sg, reader_concurrency_semaphore& semaphore)
+            : sg(sg), list(expiry_handler(semaphore)) {}
+    };
+
 public:
     class inactive_read_handle {
         reader_concurrency_semaphore* _sem = nullptr;
@@ -173,11 +196,18 @@ class reader_concurrency_semaphore {
     const resources _initial_resources;
     resources _resources;
 
-    expiring_fifo<entry, expiry_handler, db::timeout_clock> _wait_list;
+    // Few scheduling groups exist, so a linear search is cheap. The queues
+    // are not movable, as their timers refer to them.
+    std::vector<std::unique_ptr<wait_queue>> _wait_queues;
     queue<entry> _ready_list;
 
     sstring _name;
     size_t _max_queue_length = std::numeric_limits<size_t>::max();
+    // The moving average of the time between admissions of queued reads,
+    // while the queue stays non-empty, for predicting how long a new read
+    // would wait for admission.
+    std::chrono::duration<double> _queued_admission_interval{0};
+    db::timeout_clock::time_point _last_queued_admission;
     inactive_reads_type _inactive_reads;
     stats _stats;
     permit_list_type _permit_list;
@@ -185,6 +215,7 @@ class reader_concurrency_semaphore {
     gate _close_readers_gate;
     gate _permit_gate;
     std::optional<future<>> _execution_loop_future;
+    seastar::metrics::metric_groups _metrics;
 
 private:
     void do_detach_inactive_reader(inactive_read&, evict_reason reason) noexcept;
@@ -196,9 +227,15 @@ class reader_concurrency_semaphore {
     bool all_used_permits_are_stalled() const;
 
     [[nodiscard]] std::exception_ptr check_queue_size(std::string_view queue_name);
+    [[nodiscard]] std::exception_ptr check_deadline(const reader_permit& permit);
+    void on_queued_admission() noexcept;
 
-    // Add the permit to the wait queue and return the future which resolves when
-    // the permit is admitted (popped from the queue).
+    wait_queue& get_wait_queue(scheduling_group sg);
+    wait_queue* next_wait_queue() noexcept;
+    double admission_cost(const resources& r) const noexcept;
+
+    // Add the permit to the wait queue of the current scheduling group and return
+    // the future which resolves when the permit is admitted (popped from the queue).
     future<> enqueue_waiter(reader_permit permit, read_func func);
     void evict_readers_in_background();
     future<> do_wait_admission(reader_permit permit, read_func func = {});
@@ -409,9 +446,19 @@ class reader_concurrency_semaphore {
 
     void signal(const resources& r) noexcept;
 
-    size_t waiters() const {
-        return _wait_list.size();
-    }
+    size_t waiters() const;
+
+    /// Returns the number of waiters enqueued from the given scheduling group.
+    size_t waiters(scheduling_group sg) const;
+
+    /// Set the admission weight of reads enqueued from the given scheduling group
+    ///
+    /// When reads from several scheduling groups are waiting, they are admitted
+    /// in proportion to the weights of their groups, so a group flooding the
+    /// semaphore doesn't make reads of the other groups queue behind it.
+    /// Groups without a weight set have a weight of 1.
+    /// Also registers a metric with the queue length of the group.
+    void set_admission_weight(scheduling_group sg, float weight);
 
     void broken(std::exception_ptr ex = {});
 
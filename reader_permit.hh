@@ -91,6 +91,25 @@ class reader_permit {
         evicted,
     };
 
+    // Work done on behalf of the read, for accounting the cost of queries.
+    struct read_stats {
+        uint64_t sstables_read = 0;
+        uint64_t disk_reads = 0;
+        uint64_t disk_bytes_read = 0;
+        uint64_t cache_row_hits = 0;
+        uint64_t cache_row_misses = 0;
+
+        read_stats operator-(const read_stats& o) const noexcept {
+            return read_stats{
+                sstables_read - o.sstables_read,
+                disk_reads - o.disk_reads,
+                disk_bytes_read - o.disk_bytes_read,
+                cache_row_hits - o.cache_row_hits,
+                cache_row_misses - o.cache_row_misses,
+            };
+        }
+    };
+
     class impl;
 
 private:
@@ -161,8 +180,12 @@ class reader_permit {
 
     query::max_result_size max_result_size() const;
     void set_max_result_size(query::max_result_size);
+
+    read_stats& get_read_stats() noexcept;
 };
 
+std::ostream& operator<<(std::ostream& os, const reader_permit::read_stats& s);
+
 using reader_permit_opt = optimized_optional<reader_permit>;
 
 class reader_permit::resource_units {
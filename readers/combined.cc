@@ -229,10 +229,15 @@ class mutation_reader_merger {
     struct reader_and_fragment {
         reader_iterator reader{};
         mutation_fragment_v2 fragment;
+        // The raw token of the partition, if the fragment is a partition_start.
+        // Cached, so that ordering readers by partition mostly compares
+        // integers, without reaching into the fragment.
+        int64_t token = 0;
 
         reader_and_fragment(reader_iterator r, mutation_fragment_v2 f)
             : reader(r)
-            , fragment(std::move(f)) {
+            , fragment(std::move(f))
+            , token(fragment.is_partition_start() ? fragment.as_partition_start().key().token().raw() : 0) {
         }
     };
 
@@ -402,6 +407,9 @@ struct mutation_reader_merger::reader_heap_compare {
 
     bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) {
         // Invert comparison as this is a max-heap.
+        if (a.token != b.token) {
+            return b.token < a.token;
+        }
         return b.fragment.as_partition_start().key().less_compare(s, a.fragment.as_partition_start().key());
     }
 };
@@ -587,8 +595,8 @@ future<mutation_fragment_batch> mutation_reader_merger::operator()() {
             return make_ready_future<mutation_fragment_batch>(_current);
         }
 
-        auto key = [] (const merger_vector<reader_and_fragment>& heap) -> const dht::decorated_key& {
-            return heap.front().fragment.as_partition_start().key();
+        auto same_partition = [this] (const reader_and_fragment& a, const reader_and_fragment& b) {
+            return a.token == b.token && a.fragment.as_partition_start().key().equal(*_schema, b.fragment.as_partition_start().key());
         };
 
         do {
@@ -598,7 +606,7 @@ future<mutation_fragment_batch> mutation_reader_merger::operator()() {
             _fragment_heap.emplace_back(std::move(_reader_heap.back()));
             _reader_heap.pop_back();
         }
-        while (!_reader_heap.empty() && key(_fragment_heap).equal(*_schema, key(_reader_heap)));
+        while (!_reader_heap.empty() && same_partition(_fragment_heap.front(), _reader_heap.front()));
         if (_fragment_heap.size() == 1) {
             _single_reader = { _fragment_heap.back().reader, mutation_fragment_v2::kind::partition_start };
             _current.emplace_back(std::move(_fragment_heap.back().fragment), &*_single_reader.reader);
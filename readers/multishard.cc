@@ -947,6 +947,8 @@ class multishard_combining_reader_v2 : public flat_mutation_reader_v2::impl {
 
     void on_partition_range_change(const dht::partition_range& pr);
     bool maybe_move_to_next_shard(const dht::token* const t = nullptr);
+    // Keeps the readers of the next _concurrency - 1 shards filling in the background.
+    void read_ahead_next_shards();
     future<> handle_empty_reader_buffer();
 
 public:
@@ -1010,9 +1012,37 @@ bool multishard_combining_reader_v2::maybe_move_to_next_shard(const dht::token*
 
     _crossed_shards = true;
     _current_shard = next_shard;
+    // Moving to the next shard makes room for the read-ahead of one more
+    // shard, start it now rather than when the consumer gets there.
+    read_ahead_next_shards();
     return true;
 }
 
+void multishard_combining_reader_v2::read_ahead_next_shards() {
+    // Read-ahead buffers are admitted by the semaphores of the remote
+    // shards, but when our own semaphore has queued reads the node is
+    // likely short on memory, so back off instead of reading further ahead.
+    if (_permit.semaphore().waiters()) {
+        _concurrency = std::max(_concurrency / 2, 1u);
+        return;
+    }
+    if (_concurrency == 1) {
+        return;
+    }
+
+    // Read ahead shouldn't change the min selection heap so we work on a local copy.
+    auto shard_selection_min_heap_copy = _shard_selection_min_heap;
+
+    // Read-aheads run in the background. They will be brought to the
+    // foreground when we move to their respective shard.
+    for (unsigned i = 1; i < _concurrency && !shard_selection_min_heap_copy.empty(); ++i) {
+        boost::pop_heap(shard_selection_min_heap_copy);
+        const auto next_shard = shard_selection_min_heap_copy.back().shard;
+        shard_selection_min_heap_copy.pop_back();
+        _shard_readers[next_shard]->read_ahead();
+    }
+}
+
 future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
     auto& reader = *_shard_readers[_current_shard];
 
@@ -1024,6 +1054,12 @@ future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
         }
         return make_ready_future<>();
     } else if (reader.is_read_ahead_in_progress()) {
+        // The read-ahead was started, but too late to complete before the
+        // consumer got to this shard. Read one more shard ahead.
+        if (_crossed_shards) {
+            _concurrency = std::min(_concurrency + 1, _sharder.shard_count());
+            read_ahead_next_shards();
+        }
         return reader.fill_buffer();
     } else {
         // If we crossed shards and the next reader has an empty buffer we
@@ -1031,19 +1067,7 @@ future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
         // more chances of hitting the reader's buffer.
         if (_crossed_shards) {
             _concurrency = std::min(_concurrency * 2, _sharder.shard_count());
-
-            // Read ahead shouldn't change the min selection heap so we work on a local copy.
-            auto shard_selection_min_heap_copy = _shard_selection_min_heap;
-
-            // If concurrency > 1 we kick-off concurrency-1 read-aheads in the
-            // background. They will be brought to the foreground when we move
-            // to their respective shard.
-            for (unsigned i = 1; i < _concurrency && !shard_selection_min_heap_copy.empty(); ++i) {
-                boost::pop_heap(shard_selection_min_heap_copy);
-                const auto next_shard = shard_selection_min_heap_copy.back().shard;
-                shard_selection_min_heap_copy.pop_back();
-                _shard_readers[next_shard]->read_ahead();
-            }
+            read_ahead_next_shards();
         }
         return reader.fill_buffer();
     }
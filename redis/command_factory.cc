@@ -22,15 +22,18 @@ future<redis_message> command_factory::create_execute(service::storage_proxy& pr
         { "ping", commands::ping },
         { "select", commands::select },
         { "get", commands::get },
+        { "mget", commands::mget },
         { "exists", commands::exists },
         { "ttl", commands::ttl },
         { "strlen", commands::strlen },
         { "set", commands::set },
+        { "mset", commands::mset },
         { "setex", commands::setex },
         { "del", commands::del },
         { "echo", commands::echo },
         { "lolwut", commands::lolwut },
         { "hget", commands::hget },
+        { "hmget", commands::hmget },
         { "hset", commands::hset },
         { "hgetall", commands::hgetall },
         { "hdel", commands::hdel },
@@ -36,6 +36,22 @@ future<redis_message> get(service::storage_proxy& proxy, request& req, redis::re
     });
 }
 
+future<redis_message> mget(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 1) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    return redis::read_strings(proxy, options, req._args, permit).then([] (std::vector<lw_shared_ptr<strings_result>> results) {
+        std::vector<bytes_opt> values;
+        values.reserve(results.size());
+        for (auto& result : results) {
+            // nil for keys which do not exist. Repeated keys share a result,
+            // so the value is copied rather than moved out of it.
+            values.push_back(result->has_result() ? bytes_opt(result->result()) : std::nullopt);
+        }
+        return redis_message::make_strings_list_result(values);
+    });
+}
+
 future<redis_message> exists(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() < 1) {
         throw wrong_arguments_exception(1, req.arguments_size(), req._command);
@@ -109,6 +125,24 @@ future<redis_message> hget(service::storage_proxy& proxy, request& req, redis::r
     });
 }
 
+future<redis_message> hmget(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 2) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    auto fields = std::vector<bytes>(req._args.begin() + 1, req._args.end());
+    return redis::read_hashes(proxy, options, req._args[0], fields, permit).then([fields] (auto result) {
+        std::vector<bytes_opt> values;
+        values.reserve(fields.size());
+        for (auto& field : fields) {
+            auto it = result->find(field);
+            // nil for fields which do not exist. Fields may be repeated, so
+            // the value is copied rather than moved out of the map.
+            values.push_back(it != result->end() ? bytes_opt(it->second) : std::nullopt);
+        }
+        return redis_message::make_strings_list_result(values);
+    });
+}
+
 future<redis_message> hset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() != 3) {
         throw wrong_number_of_arguments_exception(req._command);
@@ -162,6 +196,20 @@ future<redis_message> set(service::storage_proxy& proxy, request& req, redis::re
     });
 }
 
+future<redis_message> mset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() == 0 || req.arguments_size() % 2 != 0) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    std::vector<std::pair<bytes, bytes>> entries;
+    entries.reserve(req.arguments_size() / 2);
+    for (size_t i = 0; i < req.arguments_size(); i += 2) {
+        entries.emplace_back(std::move(req._args[i]), std::move(req._args[i + 1]));
+    }
+    return redis::write_strings(proxy, options, std::move(entries), permit).then([] {
+        return redis_message::ok();
+    });
+}
+
 future<redis_message> setex(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() != 3) {
         throw wrong_arguments_exception(3, req.arguments_size(), req._command);
@@ -20,6 +20,8 @@
 #include "service_permit.hh"
 #include "redis/keyspace_utils.hh"
 
+#include <unordered_set>
+
 namespace redis {
 
 class strings_result_builder {
@@ -30,10 +32,9 @@ class strings_result_builder {
     void add_cell(const column_definition& col, const std::optional<query::result_atomic_cell_view>& cell)
     {
         if (cell) {
-            cell->value().with_linearized([this, &col, &cell] (bytes_view cell_view) {
-                auto&& dv = col.type->deserialize_value(cell_view);
-                auto&& d = dv.serialize_nonnull();
-                _data->_result = std::move(d);
+            cell->value().with_linearized([this, &cell] (bytes_view cell_view) {
+                // Values are kept serialized, and that's how they're returned.
+                _data->_result = to_bytes(cell_view);
                 if (cell->expiry().has_value()) {
                     _data->_ttl = cell->expiry().value() - gc_clock::now();
                 }
@@ -62,6 +63,36 @@ class strings_result_builder {
 };
 
 
+// Collects the results of a multi-partition read, keyed by the partition key.
+class multi_strings_result_builder {
+    std::unordered_map<bytes, lw_shared_ptr<strings_result>>& _data;
+    std::optional<strings_result_builder> _current;
+    const query::partition_slice& _partition_slice;
+    const schema_ptr _schema;
+public:
+    multi_strings_result_builder(std::unordered_map<bytes, lw_shared_ptr<strings_result>>& data, const schema_ptr schema, const query::partition_slice& ps)
+        : _data(data)
+        , _partition_slice(ps)
+        , _schema(schema)
+    {
+    }
+    void accept_new_partition(const partition_key& key, uint32_t row_count) {
+        auto pd = make_lw_shared<strings_result>();
+        _data.emplace(key.explode().front(), pd);
+        _current.emplace(pd, _schema, _partition_slice);
+    }
+    void accept_new_partition(uint32_t row_count) {
+        _current.reset();
+    }
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row) {
+        if (_current) {
+            _current->accept_new_row(key, static_row, row);
+        }
+    }
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {}
+    void accept_partition_end(const query::result_row_view& static_row) {}
+};
+
 future<lw_shared_ptr<strings_result>> read_strings(service::storage_proxy& proxy, const redis_options& options, const bytes& key, service_permit permit) {
     auto schema = get_schema(proxy, options.get_keyspace_name(), redis::STRINGs);
     auto ps = partition_slice_builder(*schema).build();
@@ -87,6 +118,39 @@ future<lw_shared_ptr<strings_result>> query_strings(service::storage_proxy& prox
     });
 }
 
+future<std::vector<lw_shared_ptr<strings_result>>> read_strings(service::storage_proxy& proxy, const redis_options& options, const std::vector<bytes>& keys, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::STRINGs);
+    auto ps = partition_slice_builder(*schema).build();
+    // All keys are read by a single command, so the coordination cost is paid
+    // once per request rather than once per key.
+    dht::partition_range_vector partition_ranges;
+    std::unordered_set<bytes> distinct_keys;
+    for (auto& key : keys) {
+        if (distinct_keys.insert(key).second) {
+            auto pkey = partition_key::from_single_value(*schema, key);
+            partition_ranges.emplace_back(dht::partition_range::make_singular(dht::decorate_key(*schema, std::move(pkey))));
+        }
+    }
+    const auto max_result_size = proxy.get_max_result_size(ps);
+    const auto max_tombstones = proxy.get_tombstone_limit();
+    query::read_command cmd(schema->id(), schema->version(), ps, max_result_size, max_tombstones, query::row_limit(partition_ranges.size()), query::partition_limit(partition_ranges.size()), gc_clock::now(), std::nullopt, query_id::create_null_id(), query::is_first_page::no);
+    auto read_consistency_level = options.get_read_consistency_level();
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_read_timeout();
+    return proxy.query(schema, make_lw_shared<query::read_command>(std::move(cmd)), std::move(partition_ranges), read_consistency_level, {timeout, permit, service::client_state::for_internal_calls()}).then([ps, schema, keys] (auto qr) {
+        return query::result_view::do_with(*qr.query_result, [&] (query::result_view v) {
+            std::unordered_map<bytes, lw_shared_ptr<strings_result>> found;
+            v.consume(ps, multi_strings_result_builder(found, schema, ps));
+            std::vector<lw_shared_ptr<strings_result>> ret;
+            ret.reserve(keys.size());
+            for (auto& key : keys) {
+                auto it = found.find(key);
+                ret.push_back(it != found.end() ? it->second : make_lw_shared<strings_result>());
+            }
+            return ret;
+        });
+    });
+}
+
 
 class hashes_result_builder {
     lw_shared_ptr<std::map<bytes, bytes>> _data;
@@ -96,10 +160,8 @@ class hashes_result_builder {
     void add_cell(const bytes& ckey, const column_definition& col, const std::optional<query::result_atomic_cell_view>& cell)
     {
         if (cell) {
-            cell->value().with_linearized([this, &col, &cell, &ckey] (bytes_view cell_view) {
-                auto&& dv = col.type->deserialize_value(cell_view);
-                auto&& d = dv.serialize_nonnull();
-                _data->emplace(std::move(ckey), std::move(d));
+            cell->value().with_linearized([this, &ckey] (bytes_view cell_view) {
+                _data->emplace(std::move(ckey), to_bytes(cell_view));
             });
         }
     }
@@ -145,6 +207,27 @@ future<lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy
     return query_hashes(proxy, options, key, permit, schema, ps);
 }
 
+future<lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy& proxy, const redis_options& options, const bytes& key, const std::vector<bytes>& fields, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::HASHes);
+    std::vector<bytes> sorted_fields(fields.begin(), fields.end());
+    std::sort(sorted_fields.begin(), sorted_fields.end());
+    sorted_fields.erase(std::unique(sorted_fields.begin(), sorted_fields.end()), sorted_fields.end());
+    // Clustering ranges of a slice must be sorted and non-overlapping.
+    std::vector<query::clustering_range> clustering_ranges;
+    clustering_ranges.reserve(sorted_fields.size());
+    for (auto& field : sorted_fields) {
+        clustering_ranges.push_back(query::clustering_range::make_singular(clustering_key::from_single_value(*schema, field)));
+    }
+    std::sort(clustering_ranges.begin(), clustering_ranges.end(), [less = clustering_key::less_compare(*schema)] (const query::clustering_range& a, const query::clustering_range& b) {
+        return less(a.start()->value(), b.start()->value());
+    });
+
+    auto ps = partition_slice_builder(*schema)
+        .with_ranges(std::move(clustering_ranges))
+        .build();
+    return query_hashes(proxy, options, key, permit, schema, ps);
+}
+
 future<lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_proxy& proxy, const redis_options& options, const bytes& key, service_permit permit, schema_ptr schema, query::partition_slice ps) {
     const auto max_result_size = proxy.get_max_result_size(ps);
     const auto max_tombstones = proxy.get_tombstone_limit();
@@ -14,6 +14,8 @@
 #include "gc_clock.hh"
 #include "query-request.hh"
 
+#include <vector>
+
 namespace service {
 class storage_proxy;
 class client_state;
@@ -36,10 +38,13 @@ struct strings_result {
 };
 
 seastar::future<seastar::lw_shared_ptr<strings_result>> read_strings(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
+// Reads all keys with a single multi-partition query. Results are in the order of the keys.
+seastar::future<std::vector<seastar::lw_shared_ptr<strings_result>>> read_strings(service::storage_proxy&, const redis_options&, const std::vector<bytes>&, service_permit);
 seastar::future<seastar::lw_shared_ptr<strings_result>> query_strings(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
 
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, const bytes&, service_permit);
+seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, const std::vector<bytes>&, service_permit);
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
 
 }
@@ -62,15 +62,27 @@ class redis_message final {
     static seastar::future<redis_message> make_list_result(std::map<bytes, bytes>& list_result) {
         auto m = make_lw_shared<scattered_message<char>> ();
         m->append(fmt::format("*{}\r\n", list_result.size() * 2));
-        for (auto r : list_result) {
-            write_bytes(m, (bytes&)r.first);
-            write_bytes(m, r.second);
+        for (auto& r : list_result) {
+            write_bytes(m, bytes(r.first));
+            write_bytes(m, std::move(r.second));
+        }
+        return make_ready_future<redis_message>(m);
+    }
+    static seastar::future<redis_message> make_strings_list_result(std::vector<bytes_opt>& list_result) {
+        auto m = make_lw_shared<scattered_message<char>> ();
+        m->append(fmt::format("*{}\r\n", list_result.size()));
+        for (auto& r : list_result) {
+            if (r) {
+                write_bytes(m, std::move(*r));
+            } else {
+                m->append_static("$-1\r\n");
+            }
         }
         return make_ready_future<redis_message>(m);
     }
     static seastar::future<redis_message> make_strings_result(bytes result) {
         auto m = make_lw_shared<scattered_message<char>> ();
-        write_bytes(m, result);
+        write_bytes(m, std::move(result));
         return make_ready_future<redis_message>(m);
     }
     static seastar::future<redis_message> unknown(const bytes& name) {
@@ -102,11 +114,21 @@ class redis_message final {
     static sstring to_sstring(const bytes& b) {
         return sstring(reinterpret_cast<const char*>(b.data()), b.size());
     }
-    static void write_bytes(lw_shared_ptr<scattered_message<char>> m, bytes& b) {
+    // Values at least this big are handed over to the message instead of
+    // being copied into it.
+    static constexpr size_t zero_copy_threshold = 1024;
+
+    static void write_bytes(lw_shared_ptr<scattered_message<char>> m, bytes&& b) {
         m->append(fmt::format("${}\r\n", b.size()));
-        m->append(std::string_view(reinterpret_cast<const char*>(b.data()), b.size()));
+        if (b.size() < zero_copy_threshold) {
+            m->append(std::string_view(reinterpret_cast<const char*>(b.data()), b.size()));
+        } else {
+            auto value = std::make_unique<bytes>(std::move(b));
+            m->append_static(reinterpret_cast<const char*>(value->data()), value->size());
+            m->on_delete([value = std::move(value)] { });
+        }
         m->append_static("\r\n");
-    }   
+    }
 };
 
 }
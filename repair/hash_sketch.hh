@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "repair/hash.hh"
+
+struct repair_hash_sketch_cell {
+    int32_t count = 0;
+    uint64_t hash_sum = 0;
+    uint64_t check_sum = 0;
+
+    bool empty() const noexcept {
+        return count == 0 && hash_sum == 0 && check_sum == 0;
+    }
+};
+
+// An invertible Bloom lookup table of row hashes.
+//
+// Two nodes can find the difference between their row hash sets by
+// exchanging sketches instead of the full sets: the sketch of one set is
+// subtracted from the sketch of the other and the result is decoded into the
+// hashes present on only one of the sides. Decoding succeeds with high
+// probability as long as the difference has fewer than about 2/3 of the
+// cells, regardless of how big the sets are. When it fails, the sets have to
+// be compared in full.
+class repair_hash_sketch {
+public:
+    static constexpr unsigned nr_hash_functions = 3;
+
+    std::vector<repair_hash_sketch_cell> cells;
+
+    struct difference {
+        repair_hash_set only_in_this;
+        repair_hash_set only_in_other;
+    };
+private:
+    static uint64_t mix(uint64_t x) noexcept {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    static uint64_t check_hash(uint64_t h) noexcept {
+        return mix(h ^ 0x9e3779b97f4a7c15ull);
+    }
+
+    // Each hash function maps to its own part of the table, so that a hash
+    // always lands in nr_hash_functions distinct cells.
+    size_t cell_index(uint64_t h, unsigned fn) const noexcept {
+        const auto part = cells.size() / nr_hash_functions;
+        return fn * part + mix(h + fn) % part;
+    }
+
+    void update(uint64_t h, int32_t delta) noexcept {
+        const auto check = check_hash(h);
+        for (unsigned fn = 0; fn < nr_hash_functions; ++fn) {
+            auto& c = cells[cell_index(h, fn)];
+            c.count += delta;
+            c.hash_sum ^= h;
+            c.check_sum ^= check;
+        }
+    }
+
+    bool is_pure(const repair_hash_sketch_cell& c) const noexcept {
+        return (c.count == 1 || c.count == -1) && c.check_sum == check_hash(c.hash_sum);
+    }
+public:
+    repair_hash_sketch() = default;
+
+    explicit repair_hash_sketch(std::vector<repair_hash_sketch_cell> c)
+        : cells(std::move(c))
+    {}
+
+    // The number of cells is rounded up to a multiple of nr_hash_functions.
+    explicit repair_hash_sketch(size_t nr_cells)
+        : cells(std::max<size_t>(1, (nr_cells + nr_hash_functions - 1) / nr_hash_functions) * nr_hash_functions)
+    {}
+
+    repair_hash_sketch(size_t nr_cells, const repair_hash_set& hashes)
+        : repair_hash_sketch(nr_cells)
+    {
+        for (auto& h : hashes) {
+            add(h);
+        }
+    }
+
+    void add(const repair_hash& h) noexcept {
+        update(h.hash, 1);
+    }
+
+    // Subtracts the sketch of another set, which must have as many cells.
+    void subtract(const repair_hash_sketch& other) noexcept {
+        for (size_t i = 0; i < cells.size(); ++i) {
+            cells[i].count -= other.cells[i].count;
+            cells[i].hash_sum ^= other.cells[i].hash_sum;
+            cells[i].check_sum ^= other.cells[i].check_sum;
+        }
+    }
+
+    // Decodes a sketch which had the sketch of another set subtracted from
+    // it into the hashes only this set has and the hashes only the other
+    // set has. Returns std::nullopt if the difference is too big for the
+    // sketch to decode. The sketch is consumed by decoding.
+    std::optional<difference> decode() {
+        difference diff;
+        std::vector<size_t> pure;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            if (is_pure(cells[i])) {
+                pure.push_back(i);
+            }
+        }
+        while (!pure.empty()) {
+            const auto i = pure.back();
+            pure.pop_back();
+            if (!is_pure(cells[i])) {
+                continue;
+            }
+            const auto h = cells[i].hash_sum;
+            const auto count = cells[i].count;
+            auto& side = count > 0 ? diff.only_in_this : diff.only_in_other;
+            if (!side.insert(repair_hash(h)).second) {
+                // The same hash peeled twice, the sketch is inconsistent.
+                return std::nullopt;
+            }
+            update(h, -count);
+            for (unsigned fn = 0; fn < nr_hash_functions; ++fn) {
+                const auto j = cell_index(h, fn);
+                if (is_pure(cells[j])) {
+                    pure.push_back(j);
+                }
+            }
+        }
+        for (auto& c : cells) {
+            if (!c.empty()) {
+                return std::nullopt;
+            }
+        }
+        return diff;
+    }
+};
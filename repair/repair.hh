@@ -27,6 +27,7 @@
 #include "streaming/stream_reason.hh"
 #include "locator/token_metadata.hh"
 #include "repair/hash.hh"
+#include "repair/hash_sketch.hh"
 #include "repair/sync_boundary.hh"
 
 namespace replica {
@@ -269,6 +270,9 @@ enum class repair_row_level_start_status: uint8_t {
 
 struct repair_row_level_start_response {
     repair_row_level_start_status status;
+    // The hash of the follower's rows in the range, recorded by a previous
+    // repair with the same seed, if none of them was written since.
+    std::optional<repair_hash> range_hash;
 };
 
 // Return value of the REPAIR_GET_SYNC_BOUNDARY RPC verb
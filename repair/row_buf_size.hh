@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// The size of the row buffers of a row level repair, adapted to how the
+// rounds go.
+//
+// The size starts at the default size. It is doubled after a round in which
+// the set hashes of all nodes matched, so that ranges in sync are skipped in
+// fewer round trips, and halved after a round which had rows to fix, so that
+// fewer hashes and rows are exchanged per round. It stays within
+// [default_size / min_ratio, max_size], where max_size is what the memory
+// budget of the repair allows and may be above the default size.
+class repair_row_buf_size {
+public:
+    static constexpr size_t min_ratio = 16;
+private:
+    size_t _min_size;
+    size_t _max_size;
+    size_t _size;
+public:
+    repair_row_buf_size(size_t default_size, size_t max_size) noexcept
+        : _min_size(std::max(default_size / min_ratio, size_t(1)))
+        , _max_size(std::max(max_size, default_size))
+        , _size(default_size)
+    { }
+
+    void on_synced_round() noexcept {
+        _size = std::min(_size * 2, _max_size);
+    }
+
+    void on_round_with_diffs() noexcept {
+        _size = std::max(_size / 2, _min_size);
+    }
+
+    size_t get() const noexcept {
+        return _size;
+    }
+
+    size_t max() const noexcept {
+        return _max_size;
+    }
+};
@@ -37,6 +37,7 @@
 #include "repair/row_level.hh"
 #include "mutation_source_metadata.hh"
 #include "utils/stall_free.hh"
+#include "utils/memory_usage_metrics.hh"
 #include "service/migration_manager.hh"
 #include "streaming/consumer.hh"
 #include <seastar/core/coroutine.hh>
@@ -54,6 +55,7 @@
 #include "repair/decorated_key_with_hash.hh"
 #include "repair/row.hh"
 #include "repair/writer.hh"
+#include "repair/row_buf_size.hh"
 #include "xx_hasher.hh"
 
 extern logging::logger rlogger;
@@ -80,6 +82,8 @@ enum class repair_state : uint16_t {
     get_full_row_hashes_with_rpc_stream_finished,
     get_full_row_hashes_started,
     get_full_row_hashes_finished,
+    get_row_hash_sketch_started,
+    get_row_hash_sketch_finished,
     get_row_diff_started,
     get_row_diff_finished,
     put_row_diff_with_rpc_stream_started,
@@ -175,6 +179,8 @@ struct row_level_repair_metrics {
     uint64_t row_from_disk_bytes{0};
     uint64_t tx_hashes_nr{0};
     uint64_t rx_hashes_nr{0};
+    uint64_t row_hash_sketch_decoded{0};
+    uint64_t row_hash_sketch_failed{0};
     row_level_repair_metrics() {
         namespace sm = seastar::metrics;
         _metrics.add_group("repair", {
@@ -194,6 +200,10 @@ struct row_level_repair_metrics {
                             sm::description("Total number of rows read from disk on this shard.")),
             sm::make_counter("row_from_disk_bytes", row_from_disk_bytes,
                             sm::description("Total bytes of rows read from disk on this shard.")),
+            sm::make_counter("row_hash_sketch_decoded", row_hash_sketch_decoded,
+                            sm::description("Total number of peer row hash sets reconciled from a sketch on this shard.")),
+            sm::make_counter("row_hash_sketch_failed", row_hash_sketch_failed,
+                            sm::description("Total number of row hash sketches which failed to decode on this shard.")),
         });
     }
 };
@@ -738,6 +748,13 @@ class repair_meta {
     is_dirty_on_master _dirty_on_master = is_dirty_on_master::no;
     std::optional<shared_future<>> _stopped;
     repair_hasher _repair_hasher;
+    // Set if the rows read from this node are exactly the rows of this shard
+    // in the range, so their hash can be recorded into the table's
+    // range_hash_summaries.
+    bool _track_range_hash = false;
+    // Combines the hashes of all the rows read from disk
+    repair_hash _range_combined_hash;
+    bool _range_read_complete = false;
 public:
     std::vector<repair_node_state>& all_nodes() {
         return _all_node_states;
@@ -839,7 +856,11 @@ class repair_meta {
                 })
             , _row_level_repair_ptr(row_level_repair_ptr)
             , _repair_hasher(_seed, _schema)
+            , _track_range_hash(_repair_master || _same_sharding_config)
             {
+            if (_track_range_hash) {
+                _cf.get_range_hash_summaries().start(_range, _seed);
+            }
             if (master) {
                 add_to_repair_meta_for_masters(*this);
             } else {
@@ -870,6 +891,7 @@ class repair_meta {
         auto f2 = _sink_source_for_get_row_diff.close();
         auto f3 = _sink_source_for_put_row_diff.close();
         rlogger.debug("repair_meta::stop");
+        record_range_hash();
         // move to background.  waited on via _stopped->get_future.
         when_all_succeed(std::move(gate_future), std::move(f1), std::move(f2), std::move(f3)).discard_result().finally([this] {
             return _repair_writer->wait_for_writer_done().finally([this] {
@@ -986,6 +1008,31 @@ class repair_meta {
         return dht::sharder(_master_node_shard_config.shard_count, _master_node_shard_config.ignore_msb);
     }
 
+    // Records the hash of our rows in the range, so that the next repair of the
+    // range can skip it if no node had writes in it since. Only done if
+    // the whole range was read and no rows were written to this node:
+    // the written rows would make the hash stale, and would invalidate it
+    // anyway when they are added to the table.
+    void record_range_hash() {
+        if (_track_range_hash && _range_read_complete && !_repair_writer->created_writer()) {
+            rlogger.debug("repair_meta: Recording hash={} of range={} with seed={}", _range_combined_hash, _range, _seed);
+            _cf.get_range_hash_summaries().finish(_range, _seed, _range_combined_hash.hash);
+        }
+    }
+
+    // Returns the recorded hash of our rows in the range, if it was computed
+    // with the seed of this repair and the range wasn't written to since.
+    std::optional<repair_hash> recorded_range_hash() const {
+        if (!_track_range_hash) {
+            return std::nullopt;
+        }
+        auto summary = _cf.get_range_hash_summaries().get(_range);
+        if (!summary || summary->seed != _seed) {
+            return std::nullopt;
+        }
+        return repair_hash(summary->hash);
+    }
+
     bool is_same_sharding_config() {
         rlogger.debug("is_same_sharding_config: remote_shard={}, remote_shard_count={}, remote_ignore_msb={}",
                 _master_node_shard_config.shard, _master_node_shard_config.shard_count, _master_node_shard_config.ignore_msb);
@@ -1033,6 +1080,7 @@ class repair_meta {
             return stop_iteration::no;
         }
         auto hash = _repair_hasher.do_hash_for_mf(*_repair_reader.get_current_dk(), mf);
+        _range_combined_hash.add(hash);
         repair_row r(freeze(*_schema, mf), position_in_partition(mf.position()), _repair_reader.get_current_dk(), hash, is_dirty_on_master::no);
         rlogger.trace("Reading: r.boundary={}, r.hash={}", r.boundary(), r.hash());
         _metrics.row_from_disk_nr++;
@@ -1057,6 +1105,7 @@ class repair_meta {
                 _gate.check();
                 return _repair_reader.read_mutation_fragment().then([this, &cur_size, &new_rows_size, &cur_rows] (mutation_fragment_opt mfopt) mutable {
                     if (!mfopt) {
+                      _range_read_complete = true;
                       return _repair_reader.on_end_of_stream().then([] {
                         return stop_iteration::yes;
                       });
@@ -1089,7 +1138,10 @@ class repair_meta {
     // Calculate the combined checksum of the rows
     // Calculate the total size of the rows in _row_buf
     future<get_sync_boundary_response>
-    get_sync_boundary(std::optional<repair_sync_boundary> skipped_sync_boundary) {
+    get_sync_boundary(std::optional<repair_sync_boundary> skipped_sync_boundary, std::optional<uint64_t> max_row_buf_size) {
+        if (max_row_buf_size) {
+            _max_row_buf_size = *max_row_buf_size;
+        }
         auto f = make_ready_future<>();
         if (skipped_sync_boundary) {
             _current_sync_boundary = skipped_sync_boundary;
@@ -1419,6 +1471,31 @@ class repair_meta {
         });
     }
 
+    // RPC API
+    // Return a sketch of the hashes of the rows in _working_row_buf
+    future<repair_hash_sketch>
+    get_row_hash_sketch(gms::inet_address remote_node, uint32_t nr_cells) {
+        if (remote_node == _myip) {
+            return get_row_hash_sketch_handler(nr_cells);
+        }
+        return ser::partition_checksum_rpc_verbs::send_repair_get_row_hash_sketch(&_messaging, msg_addr(remote_node),
+                _repair_meta_id, nr_cells).then([this, remote_node] (repair_hash_sketch sketch) {
+            rlogger.debug("Got row hash sketch from peer={}, nr_cells={}", remote_node, sketch.cells.size());
+            stats().rpc_call_nr++;
+            return sketch;
+        });
+    }
+
+    // RPC handler
+    future<repair_hash_sketch>
+    get_row_hash_sketch_handler(uint32_t nr_cells) {
+        return with_gate(_gate, [this, nr_cells] {
+            return working_row_hashes().then([nr_cells] (repair_hash_set hashes) {
+                return repair_hash_sketch(nr_cells, hashes);
+            });
+        });
+    }
+
     // RPC API
     // Return the combined hashes of the current working row buf
     future<get_combined_row_hash_response>
@@ -1448,10 +1525,11 @@ class repair_meta {
     }
 
     // RPC API
-    future<>
+    // Returns the node's recorded hash of its rows in the range, see recorded_range_hash().
+    future<std::optional<repair_hash>>
     repair_row_level_start(gms::inet_address remote_node, sstring ks_name, sstring cf_name, dht::token_range range, table_schema_version schema_version, streaming::stream_reason reason) {
         if (remote_node == _myip) {
-            return make_ready_future<>();
+            return make_ready_future<std::optional<repair_hash>>(recorded_range_hash());
         }
         stats().rpc_call_nr++;
         // Even though remote partitioner name is ignored in the current version of
@@ -1465,9 +1543,9 @@ class repair_meta {
                 _master_node_shard_config.shard, _master_node_shard_config.shard_count, _master_node_shard_config.ignore_msb,
                 remote_partitioner_name, std::move(schema_version), reason).then([ks_name, cf_name] (rpc::optional<repair_row_level_start_response> resp) {
             if (resp && resp->status == repair_row_level_start_status::no_such_column_family) {
-                return make_exception_future<>(replica::no_such_column_family(ks_name, cf_name));
+                return make_exception_future<std::optional<repair_hash>>(replica::no_such_column_family(ks_name, cf_name));
             } else {
-                return make_ready_future<>();
+                return make_ready_future<std::optional<repair_hash>>(resp ? resp->range_hash : std::nullopt);
             }
         });
     }
@@ -1479,8 +1557,9 @@ class repair_meta {
             uint64_t seed, shard_config master_node_shard_config, table_schema_version schema_version, streaming::stream_reason reason) {
         rlogger.debug(">>> Started Row Level Repair (Follower): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, schema_version={}, range={}, seed={}, max_row_buf_siz={}",
             utils::fb_utilities::get_broadcast_address(), from, repair_meta_id, ks_name, cf_name, schema_version, range, seed, max_row_buf_size);
-        return repair.insert_repair_meta(from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, std::move(master_node_shard_config), std::move(schema_version), reason).then([] {
-            return repair_row_level_start_response{repair_row_level_start_status::ok};
+        return repair.insert_repair_meta(from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, std::move(master_node_shard_config), std::move(schema_version), reason).then([&repair, from, repair_meta_id] {
+            auto rm = repair.get_repair_meta(from, repair_meta_id);
+            return repair_row_level_start_response{repair_row_level_start_status::ok, rm->recorded_range_hash()};
         }).handle_exception_type([] (replica::no_such_column_family&) {
             return repair_row_level_start_response{repair_row_level_start_status::no_such_column_family};
         });
@@ -1549,21 +1628,22 @@ class repair_meta {
 
     // RPC API
     // Return the largest sync point contained in the _row_buf , current _row_buf checksum, and the _row_buf size
+    // If max_row_buf_size is set, the node reads rows up to that size for this and the following rounds.
     future<get_sync_boundary_response>
-    get_sync_boundary(gms::inet_address remote_node, std::optional<repair_sync_boundary> skipped_sync_boundary) {
+    get_sync_boundary(gms::inet_address remote_node, std::optional<repair_sync_boundary> skipped_sync_boundary, std::optional<uint64_t> max_row_buf_size) {
         if (remote_node == _myip) {
-            return get_sync_boundary_handler(skipped_sync_boundary);
+            return get_sync_boundary_handler(skipped_sync_boundary, max_row_buf_size);
         }
         stats().rpc_call_nr++;
-        return _messaging.send_repair_get_sync_boundary(msg_addr(remote_node), _repair_meta_id, skipped_sync_boundary);
+        return _messaging.send_repair_get_sync_boundary(msg_addr(remote_node), _repair_meta_id, skipped_sync_boundary, max_row_buf_size);
     }
 
     // RPC handler
     future<get_sync_boundary_response>
-    get_sync_boundary_handler(std::optional<repair_sync_boundary> skipped_sync_boundary) {
-        return with_gate(_gate, [this, skipped_sync_boundary = std::move(skipped_sync_boundary)] () mutable {
+    get_sync_boundary_handler(std::optional<repair_sync_boundary> skipped_sync_boundary, std::optional<uint64_t> max_row_buf_size) {
+        return with_gate(_gate, [this, skipped_sync_boundary = std::move(skipped_sync_boundary), max_row_buf_size] () mutable {
             _cf.update_off_strategy_trigger();
-            return get_sync_boundary(std::move(skipped_sync_boundary));
+            return get_sync_boundary(std::move(skipped_sync_boundary), max_row_buf_size);
         });
     }
 
@@ -2212,14 +2292,18 @@ future<> repair_service::init_ms_handlers() {
         });
     });
     ms.register_repair_get_sync_boundary([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
-            std::optional<repair_sync_boundary> skipped_sync_boundary) {
+            std::optional<repair_sync_boundary> skipped_sync_boundary, rpc::optional<uint64_t> max_row_buf_size_opt) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        std::optional<uint64_t> max_row_buf_size;
+        if (max_row_buf_size_opt) {
+            max_row_buf_size = *max_row_buf_size_opt;
+        }
         return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id,
-                skipped_sync_boundary = std::move(skipped_sync_boundary)] (repair_service& local_repair) mutable {
+                skipped_sync_boundary = std::move(skipped_sync_boundary), max_row_buf_size] (repair_service& local_repair) mutable {
             auto rm = local_repair.get_repair_meta(from, repair_meta_id);
             rm->set_repair_state_for_local_node(repair_state::get_sync_boundary_started);
-            return rm->get_sync_boundary_handler(std::move(skipped_sync_boundary)).then([rm] (get_sync_boundary_response resp) {
+            return rm->get_sync_boundary_handler(std::move(skipped_sync_boundary), max_row_buf_size).then([rm] (get_sync_boundary_response resp) {
                 rm->set_repair_state_for_local_node(repair_state::get_sync_boundary_finished);
                 return resp;
             });
@@ -2319,6 +2403,18 @@ future<> repair_service::init_ms_handlers() {
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return repair_flush_hints_batchlog_handler(from, std::move(req));
     });
+    ser::partition_checksum_rpc_verbs::register_repair_get_row_hash_sketch(&ms, [this] (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint32_t nr_cells) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, nr_cells] (repair_service& local_repair) {
+            auto rm = local_repair.get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_row_hash_sketch_started);
+            return rm->get_row_hash_sketch_handler(nr_cells).then([rm] (repair_hash_sketch sketch) {
+                rm->set_repair_state_for_local_node(repair_state::get_row_hash_sketch_finished);
+                return sketch;
+            });
+        });
+    });
 
     return make_ready_future<>();
 }
@@ -2341,7 +2437,8 @@ future<> repair_service::uninit_ms_handlers() {
         ms.unregister_repair_set_estimated_partitions(),
         ms.unregister_repair_get_diff_algorithms(),
         ser::partition_checksum_rpc_verbs::unregister_repair_update_system_table(&ms),
-        ser::partition_checksum_rpc_verbs::unregister_repair_flush_hints_batchlog(&ms)
+        ser::partition_checksum_rpc_verbs::unregister_repair_flush_hints_batchlog(&ms),
+        ser::partition_checksum_rpc_verbs::unregister_repair_get_row_hash_sketch(&ms)
         ).discard_result();
 }
 
@@ -2416,6 +2513,28 @@ class row_level_repair {
 
     gc_clock::time_point _start_time;
 
+    // The size of the row buffers, adapted to how the rounds go if all nodes
+    // support it. It can grow up to max_row_buf_size_growth times the default
+    // size, as far as the extra memory could be taken from the repair memory
+    // budget when the range started.
+    static constexpr size_t max_row_buf_size_growth = 4;
+    std::optional<repair_row_buf_size> _row_buf_size;
+
+    // Instead of fetching the full row hashes of a peer, the master first
+    // asks for a sketch of them, with one cell per row_hash_sketch_rows_per_cell
+    // local rows, and decodes the peer's hashes from the difference to its
+    // own. That's a fraction of the bytes when only a few rows differ. When
+    // the sketch fails to decode, the full row hashes are fetched, and
+    // sketches aren't tried again for a number of fetches which doubles with
+    // each consecutive failure, so that ranges with many differences don't
+    // pay for sketches in every round.
+    static constexpr size_t row_hash_sketch_rows_per_cell = 8;
+    static constexpr size_t min_rows_for_row_hash_sketch = 128;
+    static constexpr unsigned max_row_hash_sketch_backoff = 64;
+    bool _row_hash_sketch = false;
+    unsigned _row_hash_sketch_backoff = 0;
+    unsigned _row_hash_sketch_fetches_to_skip = 0;
+
 public:
     row_level_repair(repair_info& ri,
             sstring cf_name,
@@ -2461,13 +2580,17 @@ class row_level_repair {
         rlogger.debug("ROUND {}, _last_sync_boundary={}, _current_sync_boundary={}, _skipped_sync_boundary={}",
                 master.stats().round_nr, master.last_sync_boundary(), master.current_sync_boundary(), _skipped_sync_boundary);
         master.stats().round_nr++;
+        std::optional<uint64_t> row_buf_size;
+        if (_row_buf_size) {
+            row_buf_size = _row_buf_size->get();
+        }
         parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
             const auto& node = ns.node;
             // By calling `get_sync_boundary`, the `_last_sync_boundary`
             // is moved to the `_current_sync_boundary` or
             // `_skipped_sync_boundary` if it is not std::nullopt.
             ns.state = repair_state::get_sync_boundary_started;
-            return master.get_sync_boundary(node, _skipped_sync_boundary).then([&, this] (get_sync_boundary_response res) {
+            return master.get_sync_boundary(node, _skipped_sync_boundary, row_buf_size).then([&, this] (get_sync_boundary_response res) {
                 ns.state = repair_state::get_sync_boundary_finished;
                 master.stats().row_from_disk_bytes[node] += res.new_rows_size;
                 master.stats().row_from_disk_nr[node] += res.new_rows_nr;
@@ -2499,9 +2622,15 @@ class row_level_repair {
                 _skipped_sync_boundary = _common_sync_boundary;
                 rlogger.debug("Skip set skipped_sync_boundary={}", _skipped_sync_boundary);
                 master.stats().round_nr_fast_path_already_synced++;
+                if (_row_buf_size) {
+                    _row_buf_size->on_synced_round();
+                }
                 return op_status::next_round;
             } else {
                 _skipped_sync_boundary = std::nullopt;
+                if (_row_buf_size) {
+                    _row_buf_size->on_round_with_diffs();
+                }
             }
         } else {
             master.stats().round_nr_fast_path_already_synced++;
@@ -2599,8 +2728,11 @@ class row_level_repair {
 
             rlogger.debug("Before master.get_full_row_hashes for node {}, hash_sets={}",
                 node, master.peer_row_hash_sets(node_idx).size());
-            // Ask the peer to send the full list hashes in the working row buf.
-            if (master.use_rpc_stream()) {
+            // Ask the peer to send the full list hashes in the working row buf,
+            // unless they can be decoded from a sketch.
+            if (get_peer_row_hashes_from_sketch(master, ns, node_idx)) {
+                // Got them from the sketch.
+            } else if (master.use_rpc_stream()) {
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_started;
                 master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_with_rpc_stream(node, node_idx).get0();
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_finished;
@@ -2641,6 +2773,50 @@ class row_level_repair {
         return op_status::next_step;
     }
 
+    // Sets the row hashes of the peer from a sketch of them, if there are
+    // enough rows for a sketch to pay off and it decodes. Returns false if
+    // the full row hashes have to be fetched instead.
+    bool get_peer_row_hashes_from_sketch(repair_meta& master, repair_node_state& ns, unsigned node_idx) {
+        if (!_row_hash_sketch) {
+            return false;
+        }
+        if (_row_hash_sketch_fetches_to_skip > 0) {
+            --_row_hash_sketch_fetches_to_skip;
+            return false;
+        }
+        repair_hash_set hashes = master.working_row_hashes().get0();
+        if (hashes.size() < min_rows_for_row_hash_sketch) {
+            return false;
+        }
+        const auto nr_cells = hashes.size() / row_hash_sketch_rows_per_cell;
+        ns.state = repair_state::get_row_hash_sketch_started;
+        auto sketch = master.get_row_hash_sketch(ns.node, nr_cells).get0();
+        ns.state = repair_state::get_row_hash_sketch_finished;
+        repair_hash_sketch local_sketch(nr_cells, hashes);
+        std::optional<repair_hash_sketch::difference> diff;
+        if (sketch.cells.size() == local_sketch.cells.size()) {
+            sketch.subtract(local_sketch);
+            diff = sketch.decode();
+        }
+        if (!diff) {
+            rlogger.debug("Failed to decode row hash sketch from node {}, nr_cells={}", ns.node, local_sketch.cells.size());
+            _metrics.row_hash_sketch_failed++;
+            _row_hash_sketch_backoff = std::clamp(_row_hash_sketch_backoff * 2, 1u, max_row_hash_sketch_backoff);
+            _row_hash_sketch_fetches_to_skip = _row_hash_sketch_backoff;
+            return false;
+        }
+        _metrics.row_hash_sketch_decoded++;
+        _row_hash_sketch_backoff = 0;
+        for (auto& h : diff->only_in_other) {
+            hashes.erase(h);
+        }
+        hashes.insert(diff->only_in_this.begin(), diff->only_in_this.end());
+        rlogger.debug("Decoded row hash sketch from node {}, nr_cells={}, only_on_peer={}, only_on_master={}",
+                ns.node, local_sketch.cells.size(), diff->only_in_this.size(), diff->only_in_other.size());
+        master.peer_row_hash_sets(node_idx) = std::move(hashes);
+        return true;
+    }
+
     // Step C: Send missing rows to the peer nodes
     void send_missing_rows_to_follower_nodes(repair_meta& master) {
         // At this time, repair master contains all the rows between (_last_sync_boundary, _current_sync_boundary]
@@ -2721,6 +2897,7 @@ class row_level_repair {
             auto repair_meta_id = _ri.rs.get_next_repair_meta_id().get0();
             auto algorithm = get_common_diff_detect_algorithm(_ri.messaging.local(), _all_live_peer_nodes);
             auto max_row_buf_size = get_max_row_buf_size(algorithm);
+            _row_hash_sketch = _ri.db.local().features().repair_row_hash_sketch;
             auto master_node_shard_config = shard_config {
                     this_shard_id(),
                     _ri.sharder.shard_count(),
@@ -2740,8 +2917,34 @@ class row_level_repair {
             rlogger.trace("repair[{}]: Finished to get memory budget, wanted={}, available={}, max_repair_memory={}",
                     _ri.id.uuid, wanted, mem_sem.current(), max);
 
+            // Bigger row buffers are only taken from memory nobody waits for,
+            // so that they don't hold back other ranges. The buffers of rpc
+            // verbs without streaming are kept small, as they are sent in one
+            // message.
+            std::optional<semaphore_units<>> growth_mem_permit;
+            if (_ri.db.local().features().repair_adaptive_row_buf) {
+                auto nr_nodes = _all_live_peer_nodes.size() + 1;
+                size_t max_row_buf_size_with_growth = wanted / nr_nodes;
+                if (is_rpc_stream_supported(algorithm)) {
+                    auto growth = nr_nodes * max_row_buf_size * (max_row_buf_size_growth - 1);
+                    growth = std::min(growth, size_t(std::max(mem_sem.available_units(), ssize_t(0))));
+                    growth_mem_permit = seastar::try_get_units(mem_sem, growth);
+                    if (growth_mem_permit) {
+                        max_row_buf_size_with_growth += growth / nr_nodes;
+                    }
+                }
+                _row_buf_size.emplace(max_row_buf_size, max_row_buf_size_with_growth);
+                rlogger.trace("repair[{}]: Row buffer size can grow up to {}", _ri.id.uuid, _row_buf_size->max());
+            }
+
             auto permit = _ri.db.local().obtain_reader_permit(_cf, "repair-meta", db::no_timeout).get0();
 
+            // Hash with the seed of the last repair which recorded the hash of the
+            // range, so that the range can be skipped if all nodes still have the same hash.
+            if (auto summary = _cf.get_range_hash_summaries().get(_range)) {
+                _seed = summary->seed;
+            }
+
             repair_meta master(_ri.rs,
                     _cf,
                     s,
@@ -2769,12 +2972,14 @@ class row_level_repair {
 
             std::vector<gms::inet_address> nodes_to_stop;
             nodes_to_stop.reserve(master.all_nodes().size());
+            std::vector<std::optional<repair_hash>> range_hashes;
             try {
                 parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
                     const auto& node = ns.node;
                     ns.state = repair_state::row_level_start_started;
-                    return master.repair_row_level_start(node, _ri.keyspace, _cf_name, _range, schema_version, _ri.reason).then([&] () {
+                    return master.repair_row_level_start(node, _ri.keyspace, _cf_name, _range, schema_version, _ri.reason).then([&] (std::optional<repair_hash> range_hash) {
                         ns.state = repair_state::row_level_start_finished;
+                        range_hashes.push_back(range_hash);
                         nodes_to_stop.push_back(node);
                         ns.state = repair_state::get_estimated_partitions_started;
                         return master.repair_get_estimated_partitions(node).then([this, node, &ns] (uint64_t partitions) {
@@ -2794,7 +2999,15 @@ class row_level_repair {
                     });
                 }).get();
 
-                while (true) {
+                bool in_sync = range_hashes.size() == master.all_nodes().size() && range_hashes.front()
+                        && std::all_of(range_hashes.begin(), range_hashes.end(), [&] (const std::optional<repair_hash>& h) {
+                            return h == range_hashes.front();
+                        });
+                if (in_sync) {
+                    rlogger.debug("repair[{}]: keyspace={}, cf={}, range={} is in sync according to the recorded hashes of all nodes, skipping",
+                            _ri.id.uuid, _ri.keyspace, _cf_name, _range);
+                }
+                while (!in_sync) {
                     auto status = negotiate_sync_boundary(master);
                     if (status == op_status::next_round) {
                         continue;
@@ -2933,6 +3146,10 @@ repair_service::repair_service(distributed<gms::gossiper>& gossiper,
     , _max_repair_memory(max_repair_memory)
     , _memory_sem(max_repair_memory)
 {
+    _metrics.add_group(sstring(utils::memory_usage_metrics_group), {
+        // The memory budget reserved by the running repairs for their row buffers.
+        utils::make_subsystem_memory_gauge("repair", [this] { return _max_repair_memory - _memory_sem.available_units(); }),
+    });
     if (this_shard_id() == 0) {
         _gossip_helper = make_shared<row_level_repair_gossip_helper>(*this);
         _gossiper.local().register_(_gossip_helper);
@@ -3001,23 +3218,33 @@ future<> repair_service::load_history() {
         }
         rlogger.info("Loading repair history for keyspace={}, table={}, table_uuid={}",
                 table->schema()->ks_name(), table->schema()->cf_name(), table_uuid);
-        co_await _sys_ks.local().get_repair_history(table_uuid, [this] (const auto& entry) -> future<> {
+        // The history has an entry for every range repaired, in every
+        // repair. Merge it into one map first, keeping the latest repair
+        // time of every part of the ranges, so that applying it on all
+        // shards takes one cross-shard call per table rather than one per
+        // entry.
+        repair_history_map history;
+        co_await _sys_ks.local().get_repair_history(table_uuid, [&history] (const auto& entry) -> future<> {
             auto start = entry.range_start == std::numeric_limits<int64_t>::min() ? dht::minimum_token() : dht::token::from_int64(entry.range_start);
             auto end = entry.range_end == std::numeric_limits<int64_t>::min() ? dht::maximum_token() : dht::token::from_int64(entry.range_end);
             auto range = dht::token_range(dht::token_range::bound(start, false), dht::token_range::bound(end, true));
             auto repair_time = to_gc_clock(entry.ts);
             rlogger.debug("Loading repair history for keyspace={}, table={}, table_uuid={}, repair_time={}, range={}",
                     entry.ks, entry.cf, entry.table_uuid, entry.ts, range);
-            try {
-                co_await get_db().invoke_on_all([table_uuid = entry.table_uuid, range, repair_time] (replica::database& local_db) {
-                    auto& gc_state = local_db.get_compaction_manager().get_tombstone_gc_state();
-                    gc_state.update_repair_time(table_uuid, range, repair_time);
-                });
-            } catch (...) {
-                rlogger.warn("Failed to update repair history time for keyspace={}, table={}, range={}, repair_time={}",
-                        entry.ks, entry.cf, range, repair_time);
-            }
+            history.map += std::make_pair(locator::token_metadata::range_to_interval(range), repair_time);
+            return make_ready_future<>();
         });
+        try {
+            co_await get_db().invoke_on_all([&table_uuid, &history] (replica::database& local_db) {
+                auto& gc_state = local_db.get_compaction_manager().get_tombstone_gc_state();
+                for (auto& [interval, repair_time] : history.map) {
+                    gc_state.update_repair_time(table_uuid, locator::token_metadata::interval_to_range(interval), repair_time);
+                }
+            });
+        } catch (...) {
+            rlogger.warn("Failed to update repair history time for keyspace={}, table={}: {}",
+                    table->schema()->ks_name(), table->schema()->cf_name(), std::current_exception());
+        }
     }
     co_return;
 }
@@ -13,6 +13,7 @@
 #include "repair/repair.hh"
 #include <seastar/core/distributed.hh>
 #include <seastar/util/bool_class.hh>
+#include <seastar/core/metrics_registration.hh>
 
 using namespace seastar;
 
@@ -101,6 +102,7 @@ class repair_service : public seastar::peering_sharded_service<repair_service> {
 
     size_t _max_repair_memory;
     seastar::semaphore _memory_sem;
+    seastar::metrics::metric_groups _metrics;
 
     future<> init_ms_handlers();
     future<> uninit_ms_handlers();
@@ -116,6 +116,11 @@ class repair_writer : public enable_lw_shared_from_this<repair_writer> {
         _created_writer = true;
     }
 
+    // Returns true if any row was written.
+    bool created_writer() const noexcept {
+        return _created_writer;
+    }
+
     future<> do_write(lw_shared_ptr<const decorated_key_with_hash> dk, mutation_fragment mf);
 
     future<> wait_for_writer_done();
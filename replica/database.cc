@@ -50,6 +50,8 @@
 #include "utils/fb_utilities.hh"
 #include "utils/stall_free.hh"
 #include "utils/fmt-compat.hh"
+#include "utils/memory_usage_metrics.hh"
+#include "utils/fragment_pool.hh"
 
 #include "db/timeout_clock.hh"
 #include "db/large_data_handler.hh"
@@ -86,7 +88,8 @@ namespace replica {
 inline
 flush_controller
 make_flush_controller(const db::config& cfg, backlog_controller::scheduling_group& sg, std::function<double()> fn) {
-    return flush_controller(sg, cfg.memtable_flush_static_shares(), 50ms, cfg.unspooled_dirty_soft_limit(), std::move(fn));
+    return flush_controller(sg, cfg.memtable_flush_static_shares(), 50ms, cfg.unspooled_dirty_soft_limit(), std::move(fn),
+            std::chrono::milliseconds(cfg.memtable_flush_shares_smoothing_in_ms()));
 }
 
 keyspace::keyspace(lw_shared_ptr<keyspace_metadata> metadata, config cfg, locator::effective_replication_map_factory& erm_factory)
@@ -359,6 +362,7 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _system_sstables_manager(std::make_unique<sstables::sstables_manager>(*_nop_large_data_handler, _cfg, feat, _row_cache_tracker, dbcfg.available_memory))
     , _result_memory_limiter(dbcfg.available_memory / 10)
     , _data_listeners(std::make_unique<db::data_listeners>())
+    , _hot_partitions(std::make_unique<db::hot_partitions_data_listener>(*this, utils::updateable_value<uint32_t>(cfg.hot_partitions_sample_period)))
     , _mnotifier(mn)
     , _feat(feat)
     , _shared_token_metadata(stm)
@@ -375,6 +379,14 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
 
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
 
+    // Heavy statements share the user semaphore with the others, but their reads
+    // are admitted at the same ratio as the CPU shares of their scheduling group.
+    if (_dbcfg.heavy_statement_scheduling_group != _dbcfg.statement_scheduling_group
+            && _dbcfg.heavy_statement_scheduling_group != default_scheduling_group()) {
+        _read_concurrency_sem.set_admission_weight(_dbcfg.statement_scheduling_group, 1.0f);
+        _read_concurrency_sem.set_admission_weight(_dbcfg.heavy_statement_scheduling_group, 0.2f);
+    }
+
     setup_scylla_memory_diagnostics_producer();
     if (_dbcfg.sstables_format) {
         set_format(*_dbcfg.sstables_format);
@@ -395,16 +407,21 @@ const data_dictionary::user_types_storage& database::user_types() const noexcept
 
 } // namespace replica
 
+void backlog_controller::set_shares(float shares) {
+    _current_shares = shares;
+    update_controller(shares);
+}
+
 void backlog_controller::adjust() {
     if (controller_disabled()) {
-        update_controller(_static_shares);
+        set_shares(_static_shares);
         return;
     }
 
     auto backlog = _current_backlog();
 
     if (backlog >= _control_points.back().input) {
-        update_controller(_control_points.back().output);
+        set_shares(_control_points.back().output);
         return;
     }
 
@@ -418,7 +435,10 @@ void backlog_controller::adjust() {
     control_point& cp = _control_points[idx];
     control_point& last = _control_points[idx - 1];
     float result = last.output + (backlog - last.input) * (cp.output - last.output)/(cp.input - last.input);
-    update_controller(result);
+    if (_current_shares) {
+        result = *_current_shares + (result - *_current_shares) * _smoothing_factor;
+    }
+    set_shares(result);
 }
 
 float backlog_controller::backlog_of_shares(float shares) const {
@@ -498,6 +518,15 @@ database::setup_metrics() {
 
         sm::make_gauge("unspooled_dirty_bytes", [this] { return _dirty_memory_manager.unspooled_dirty_memory() + _system_dirty_memory_manager.unspooled_dirty_memory(); },
                        sm::description("Holds the size of all (\"regular\", \"system\" and \"streaming\") used memory in bytes. Compare it to \"dirty_bytes\" to see how many memory is wasted (neither used nor available).")),
+
+        sm::make_counter("fragment_pool_hits", [] { return utils::fragment_pool::get_stats().hits; },
+                       sm::description("Counts buffer fragment allocations served from the per-shard fragment pool.")),
+
+        sm::make_counter("fragment_pool_misses", [] { return utils::fragment_pool::get_stats().misses; },
+                       sm::description("Counts buffer fragment allocations which found no free fragment of their size class in the per-shard fragment pool.")),
+
+        sm::make_gauge("fragment_pool_cached_bytes", [] { return utils::fragment_pool::get_stats().cached_bytes; },
+                       sm::description("Holds the size of the free buffer fragments kept in the per-shard fragment pool.")),
     });
 
     _metrics.add_group("memtables", {
@@ -511,6 +540,9 @@ database::setup_metrics() {
         sm::make_gauge("failed_flushes", _cf_stats.failed_memtables_flushes_count,
                        sm::description("Holds the number of failed memtable flushes. "
                                        "High value in this metric may indicate a permanent failure to flush a memtable.")),
+
+        sm::make_gauge("memtable_flush_shares", [this] { return _memtable_controller.current_shares(); },
+                       sm::description("Holds the shares currently assigned to memtable flushes by the flush controller.")),
     });
 
     _metrics.add_group("database", {
@@ -599,6 +631,15 @@ database::setup_metrics() {
         sm::make_gauge("querier_cache_population", _querier_cache.get_stats().population,
                        sm::description("The number of entries currently in the querier cache.")),
 
+        sm::make_counter("querier_cache_misses_after_time_based_eviction", _querier_cache.get_stats().misses_after_time_based_eviction,
+                       sm::description("Counts querier cache misses of queries whose previous querier timed out and was evicted.")),
+
+        sm::make_counter("querier_cache_misses_after_resource_based_eviction", _querier_cache.get_stats().misses_after_resource_based_eviction,
+                       sm::description("Counts querier cache misses of queries whose previous querier was evicted to free up resources.")),
+
+        sm::make_counter("querier_cache_extended_ttl_inserts", _querier_cache.get_stats().extended_ttl_inserts,
+                       sm::description("Counts querier cache entries inserted with an extended TTL, because their query came back after its previous querier timed out.")),
+
         sm::make_counter("sstable_read_queue_overloads", _read_concurrency_sem.get_stats().total_reads_shed_due_to_overload,
                        sm::description("Counts the number of times the sstable read queue was overloaded. "
                                        "A non-zero value indicates that we have to drop read requests because they arrive faster than we can serve them.")),
@@ -609,6 +650,18 @@ database::setup_metrics() {
 
     });
 
+    auto reads_memory = [] (const reader_concurrency_semaphore& sem) {
+        return [&sem] { return sem.initial_resources().memory - sem.available_resources().memory; };
+    };
+    _metrics.add_group(sstring(utils::memory_usage_metrics_group), {
+        utils::make_subsystem_memory_gauge("user_reads", reads_memory(_read_concurrency_sem)),
+        utils::make_subsystem_memory_gauge("streaming_reads", reads_memory(_streaming_concurrency_sem)),
+        utils::make_subsystem_memory_gauge("compaction_reads", reads_memory(_compaction_concurrency_sem)),
+        utils::make_subsystem_memory_gauge("system_reads", reads_memory(_system_read_concurrency_sem)),
+        // The cached queriers' memory is also part of their semaphores'.
+        utils::make_subsystem_memory_gauge("querier_cache", [this] { return _querier_cache.memory_usage(); }),
+    });
+
     // Registering all the metrics with a single call causes the stack size to blow up.
     _metrics.add_group("database", {
         sm::make_gauge("active_reads_memory_consumption", [this] { return max_memory_concurrent_reads() - _read_concurrency_sem.available_resources().memory; },
@@ -636,6 +689,11 @@ database::setup_metrics() {
                                        " When the queue is full, excessive reads are shed to avoid overload."),
                        {user_label_instance}),
 
+        sm::make_counter("reads_shed_due_to_deadline", _read_concurrency_sem.get_stats().total_reads_shed_due_to_deadline,
+                       sm::description("The number of reads shed because, at the recent rate of admissions, they would have had to wait for admission past their timeout."
+                                       " Such reads are rejected right away instead of taking a place in the queue."),
+                       {user_label_instance}),
+
         sm::make_gauge("active_reads", [this] { return max_count_streaming_concurrent_reads - _streaming_concurrency_sem.available_resources().count; },
                        sm::description("Holds the number of currently active read operations issued on behalf of streaming "),
                        {streaming_label_instance}),
@@ -726,6 +784,10 @@ database::setup_metrics() {
             sm::description("Number of large partitions exceeding compaction_large_partition_warning_threshold_mb. "
                 "Large partitions have performance impact and should be avoided, check the documentation for details.")),
 
+        sm::make_counter("large_data_records_dropped", [this] { return _large_data_handler->stats().records_dropped; },
+            sm::description("Number of large partition, row and cell records not written to the system tables "
+                "because too many were pending.")),
+
         sm::make_total_operations("total_view_updates_pushed_local", _cf_stats.total_view_updates_pushed_local,
                 sm::description("Total number of view updates generated for tables and applied locally.")),
 
@@ -1460,6 +1522,23 @@ std::optional<db::rate_limiter::can_proceed> database::account_coordinator_opera
     return _rate_limiter.account_operation(lbl, dht::token::to_int64(token), *table_limit, account_and_enforce_info);
 }
 
+db::rate_limiter::can_proceed database::check_replica_rate_limit_feedback(table& tbl, const dht::token& token,
+        db::per_partition_rate_limit::account_and_enforce account_and_enforce_info,
+        db::operation_type op_type) {
+    db::rate_limiter::label& lbl = tbl.get_rate_limiter_label_for_op_type(op_type);
+    return _rate_limiter.check_replica_feedback(lbl, dht::token::to_int64(token), account_and_enforce_info);
+}
+
+void database::on_rejected_by_replicas(const schema& s, const dht::token& token, db::operation_type op_type) noexcept {
+    auto it = _column_families.find(s.id());
+    if (it == _column_families.end()) {
+        // The table was dropped in the meantime
+        return;
+    }
+    db::rate_limiter::label& lbl = it->second->get_rate_limiter_label_for_op_type(op_type);
+    _rate_limiter.on_rejected_by_replicas(lbl, dht::token::to_int64(token));
+}
+
 static db::rate_limiter::can_proceed account_singular_ranges_to_rate_limit(
         db::rate_limiter& limiter, column_family& cf,
         const dht::partition_range_vector& ranges,
@@ -1490,6 +1569,14 @@ static db::rate_limiter::can_proceed account_singular_ranges_to_rate_limit(
     return ret;
 }
 
+// The permit of a paged read is kept between pages, so only the work done
+// for this page is reported.
+static void trace_read_cost(const tracing::trace_state_ptr& trace_state, reader_permit& permit, const reader_permit::read_stats& before) {
+    if (trace_state) {
+        tracing::trace(trace_state, "Read cost: {}", permit.get_read_stats() - before);
+    }
+}
+
 future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>>
 database::query(schema_ptr s, const query::read_command& cmd, query::result_options opts, const dht::partition_range_vector& ranges,
                 tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout, db::per_partition_rate_limit::info rate_limit_info) {
@@ -1519,8 +1606,10 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
     auto read_func = [&, this] (reader_permit permit) {
         reader_permit::used_guard ug{permit};
         permit.set_max_result_size(max_result_size);
-        return cf.query(std::move(s), std::move(permit), cmd, opts, ranges, trace_state, get_result_memory_limiter(),
-                timeout, &querier_opt).then([&result, ug = std::move(ug)] (lw_shared_ptr<query::result> res) {
+        auto stats_before = permit.get_read_stats();
+        return cf.query(std::move(s), permit, cmd, opts, ranges, trace_state, get_result_memory_limiter(),
+                timeout, &querier_opt).then([&result, &trace_state, permit, stats_before, ug = std::move(ug)] (lw_shared_ptr<query::result> res) mutable {
+            trace_read_cost(trace_state, permit, stats_before);
             result = std::move(res);
         });
     };
@@ -1585,8 +1674,10 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
     auto read_func = [&, this] (reader_permit permit) {
         reader_permit::used_guard ug{permit};
         permit.set_max_result_size(max_result_size);
-        return cf.mutation_query(std::move(s), std::move(permit), cmd, range,
-                std::move(trace_state), std::move(accounter), timeout, &querier_opt).then([&result, ug = std::move(ug)] (reconcilable_result res) {
+        auto stats_before = permit.get_read_stats();
+        return cf.mutation_query(std::move(s), permit, cmd, range,
+                trace_state, std::move(accounter), timeout, &querier_opt).then([&result, &trace_state, permit, stats_before, ug = std::move(ug)] (reconcilable_result res) mutable {
+            trace_read_cost(trace_state, permit, stats_before);
             result = std::move(res);
         });
     };
@@ -1785,6 +1876,29 @@ future<> dirty_memory_manager::flush_one(replica::memtable_list& mtlist, flush_p
     });
 }
 
+// Largest memtables release the biggest amount of memory and are less likely
+// to generate tiny sstables. But a memtable whose writes mostly overwrite
+// rows it already holds (e.g. of counter tables) keeps absorbing these writes
+// in memory without growing much, while once flushed every future overwrite
+// ends up in a new sstable which compaction has to merge. So among the
+// largest memtables, the size of each is discounted by up to a half by its
+// overwrite ratio. This never picks a memtable smaller than half the largest one.
+replica::memtable& dirty_memory_manager::pick_flush_candidate() {
+    using namespace replica;
+    auto candidates = _region_group.get_largest_regions(flush_candidates);
+    memtable* best = &memtable::from_region(*candidates.front());
+    double best_score = -1;
+    for (auto* r : candidates) {
+        auto& mt = memtable::from_region(*r);
+        auto score = double(mt.region().evictable_occupancy().total_space()) * (1 - mt.overwrite_ratio() / 2);
+        if (score > best_score) {
+            best = &mt;
+            best_score = score;
+        }
+    }
+    return *best;
+}
+
 future<> dirty_memory_manager::flush_when_needed() {
     using namespace replica;
     if (!_db) {
@@ -1808,11 +1922,9 @@ future<> dirty_memory_manager::flush_when_needed() {
                 // flush. Most of the time we want some coordination with the commitlog to allow us to
                 // release commitlog segments as early as we can.
                 //
-                // But during pressure condition, we'll just pick the CF that holds the largest
-                // memtable. The advantage of doing this is that this is objectively the one that will
-                // release the biggest amount of memory and is less likely to be generating tiny
-                // SSTables.
-                memtable& candidate_memtable = memtable::from_region(*(this->_region_group.get_largest_region()));
+                // But during pressure condition, we'll pick among the CFs that hold the largest
+                // memtables, see pick_flush_candidate().
+                memtable& candidate_memtable = pick_flush_candidate();
                 memtable_list& mtlist = *(candidate_memtable.get_memtable_list());
 
                 if (!candidate_memtable.region().evictable_occupancy()) {
@@ -38,6 +38,7 @@
 #include "db/snapshot-ctl.hh"
 #include "memtable.hh"
 #include "row_cache.hh"
+#include "replica/range_hash_summaries.hh"
 #include "compaction/compaction_strategy.hh"
 #include "utils/estimated_histogram.hh"
 #include <seastar/core/metrics_registration.hh>
@@ -60,6 +61,7 @@
 #include "absl-flat_hash_map.hh"
 #include "utils/cross-shard-barrier.hh"
 #include "sstables/generation_type.hh"
+#include "sstables/io_stats.hh"
 #include "db/rate_limiter.hh"
 #include "db/operation_type.hh"
 #include "utils/serialized_action.hh"
@@ -113,6 +115,7 @@ class config;
 class extensions;
 class rp_handle;
 class data_listeners;
+class hot_partitions_data_listener;
 class large_data_handler;
 class system_keyspace;
 class table_selector;
@@ -394,6 +397,7 @@ class table : public enable_lw_shared_from_this<table> {
     config _config;
     mutable table_stats _stats;
     mutable db::view::stats _view_stats;
+    mutable db::view::view_update_coalescer _view_update_coalescer;
     mutable row_locker::stats _row_locker_stats;
 
     uint64_t _failed_counter_applies_to_memtable = 0;
@@ -420,6 +424,7 @@ class table : public enable_lw_shared_from_this<table> {
     // Ensures that concurrent updates to sstable set will work correctly
     seastar::named_semaphore _sstable_set_mutation_sem = {1, named_semaphore_exception_factory{"sstable set mutation"}};
     mutable row_cache _cache; // Cache covers only sstables.
+    range_hash_summaries _range_hash_summaries;
     std::optional<int64_t> _sstable_generation = {};
 
     db::replay_position _highest_rp;
@@ -430,6 +435,7 @@ class table : public enable_lw_shared_from_this<table> {
     db::commitlog* _commitlog;
     bool _durable_writes;
     sstables::sstables_manager& _sstables_manager;
+    lw_shared_ptr<sstables::io_stats> _sstables_io_stats;
     secondary_index::secondary_index_manager _index_manager;
     bool _compaction_disabled_by_user = false;
     utils::phased_barrier _flush_barrier;
@@ -730,6 +736,14 @@ class table : public enable_lw_shared_from_this<table> {
         return _cache;
     }
 
+    // Returns true iff the given slice of the partition can be read from memtables and the row cache
+    // only, without reading sstables.
+    bool is_cached(const dht::decorated_key& dk, const query::partition_slice& slice) const;
+
+    range_hash_summaries& get_range_hash_summaries() noexcept {
+        return _range_hash_summaries;
+    }
+
     db::rate_limiter::label& get_rate_limiter_label_for_op_type(db::operation_type op_type) {
         switch (op_type) {
         case db::operation_type::write:
@@ -1025,6 +1039,10 @@ class table : public enable_lw_shared_from_this<table> {
         return _sstables_manager;
     }
 
+    const sstables::io_stats& get_sstables_io_stats() const noexcept {
+        return *_sstables_io_stats;
+    }
+
     // Reader's schema must be the same as the base schema of each of the views.
     future<> populate_views(
             std::vector<db::view::view_and_base>,
@@ -1211,6 +1229,8 @@ struct database_config {
     seastar::scheduling_group compaction_scheduling_group;
     seastar::scheduling_group memory_compaction_scheduling_group;
     seastar::scheduling_group statement_scheduling_group;
+    // Statements classified as heavy by the query processor run here.
+    seastar::scheduling_group heavy_statement_scheduling_group;
     seastar::scheduling_group streaming_scheduling_group;
     seastar::scheduling_group gossip_scheduling_group;
     size_t available_memory;
@@ -1300,6 +1320,8 @@ class database : public peering_sharded_service<database> {
     reader_concurrency_semaphore _system_read_concurrency_sem;
 
     db::timeout_semaphore _view_update_concurrency_sem{max_memory_pending_view_updates()};
+    // Bounds the sstables being linked into snapshots, across all tables.
+    semaphore _snapshot_link_sem{_cfg.snapshot_link_concurrency()};
 
     cache_tracker _row_cache_tracker;
 
@@ -1341,6 +1363,7 @@ class database : public peering_sharded_service<database> {
 
     friend db::data_listeners;
     std::unique_ptr<db::data_listeners> _data_listeners;
+    std::unique_ptr<db::hot_partitions_data_listener> _hot_partitions;
 
     service::migration_notifier& _mnotifier;
     gms::feature_service& _feat;
@@ -1454,6 +1477,7 @@ class database : public peering_sharded_service<database> {
     }
 
     seastar::scheduling_group get_statement_scheduling_group() const { return _dbcfg.statement_scheduling_group; }
+    seastar::scheduling_group get_heavy_statement_scheduling_group() const { return _dbcfg.heavy_statement_scheduling_group; }
     seastar::scheduling_group get_streaming_scheduling_group() const { return _dbcfg.streaming_scheduling_group; }
 
     compaction_manager& get_compaction_manager() {
@@ -1535,6 +1559,18 @@ class database : public peering_sharded_service<database> {
             db::per_partition_rate_limit::account_and_enforce account_and_enforce_info,
             db::operation_type op_type);
 
+    /// Decides whether an operation should be rejected by a coordinator which is not a replica
+    /// for it, based on how often replicas recently rejected operations on the same partition.
+    /// Like `account_coordinator_operation_to_rate_limit`, can be called ONLY when rate limiting
+    /// can be applied to the operation.
+    db::rate_limiter::can_proceed check_replica_rate_limit_feedback(table& tbl, const dht::token& token,
+            db::per_partition_rate_limit::account_and_enforce account_and_enforce_info,
+            db::operation_type op_type);
+
+    /// Records that replicas rejected an operation which the coordinator sent them
+    /// with account_and_enforce.
+    void on_rejected_by_replicas(const schema& s, const dht::token& token, db::operation_type op_type) noexcept;
+
     future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>> query(schema_ptr, const query::read_command& cmd, query::result_options opts,
                                                                   const dht::partition_range_vector& ranges, tracing::trace_state_ptr trace_state,
                                                                   db::timeout_clock::time_point timeout, db::per_partition_rate_limit::info rate_limit_info = std::monostate{});
@@ -1690,6 +1726,10 @@ class database : public peering_sharded_service<database> {
         return *_data_listeners;
     }
 
+    const db::hot_partitions_data_listener& hot_partitions() const {
+        return *_hot_partitions;
+    }
+
     // Get the maximum result size for an unlimited query, appropriate for the
     // query class, which is deduced from the current scheduling group.
     query::max_result_size get_unlimited_query_max_result_size() const;
@@ -1708,6 +1748,10 @@ class database : public peering_sharded_service<database> {
         return _sst_dir_semaphore;
     }
 
+    semaphore& get_snapshot_link_semaphore() noexcept {
+        return _snapshot_link_sem;
+    }
+
     bool uses_schema_commitlog() const {
         return _uses_schema_commitlog;
     }
@@ -15,6 +15,8 @@
 #include "readers/empty_v2.hh"
 #include "readers/forwardable_v2.hh"
 
+#include <bit>
+
 namespace replica {
 
 static flat_mutation_reader_v2 make_partition_snapshot_flat_reader_from_snp_schema(
@@ -123,10 +125,18 @@ memtable::memtable(schema_ptr schema, dirty_memory_manager& dmm, replica::table_
         , _memtable_list(memtable_list)
         , _schema(std::move(schema))
         , partitions(dht::raw_token_less_comparator{})
-        , _table_stats(table_stats) {
+        , _table_stats(table_stats)
+        , _app_stats_at_creation(table_stats.memtable_app_stats) {
     logalloc::region::listen(&dmm.region_group());
 }
 
+double memtable::overwrite_ratio() const noexcept {
+    auto& stats = _table_stats.memtable_app_stats;
+    auto writes = stats.row_writes - _app_stats_at_creation.row_writes;
+    auto hits = stats.row_hits - _app_stats_at_creation.row_hits;
+    return writes ? std::min(double(hits) / writes, 1.0) : 0.0;
+}
+
 static thread_local dirty_memory_manager mgr_for_tests;
 static thread_local replica::table_stats stats_for_tests;
 
@@ -147,6 +157,7 @@ uint64_t memtable::dirty_size() const {
 void memtable::evict_entry(memtable_entry& e, mutation_cleaner& cleaner) noexcept {
     e.partition().evict(cleaner);
     nr_partitions--;
+    _partition_index.disable();
 }
 
 void memtable::clear() noexcept {
@@ -164,6 +175,7 @@ future<> memtable::clear_gently() noexcept {
         auto t = std::make_unique<seastar::thread>([this] {
             auto& alloc = allocator();
 
+            _partition_index.disable();
             auto p = std::move(partitions);
             nr_partitions = 0;
             while (!p.empty()) {
@@ -197,6 +209,125 @@ future<> memtable::clear_gently() noexcept {
     });
 }
 
+size_t memtable_partition_index::slot_of(int64_t token) const noexcept {
+    // Tokens of the murmur3 partitioner are well distributed already, but other partitioners'
+    // aren't, so mix them anyway.
+    return (uint64_t(token) * 0x9e3779b97f4a7c15ull) & (_slots.size() - 1);
+}
+
+void memtable_partition_index::insert_unchecked(int64_t token, memtable_entry* e) noexcept {
+    for (auto i = slot_of(token);; i = (i + 1) & (_slots.size() - 1)) {
+        if (!_slots[i].entry) {
+            _slots[i] = slot{token, e};
+            ++_size;
+            return;
+        }
+        if (_slots[i].token == token) {
+            return;
+        }
+    }
+}
+
+void memtable_partition_index::invalidate() noexcept {
+    _valid = false;
+}
+
+memtable_entry* memtable_partition_index::find(int64_t token) const noexcept {
+    for (auto i = slot_of(token);; i = (i + 1) & (_slots.size() - 1)) {
+        auto& s = _slots[i];
+        if (!s.entry || s.token == token) {
+            return s.entry;
+        }
+    }
+}
+
+void memtable_partition_index::on_insert(memtable_entry& e, uint64_t counter_before, uint64_t counter_after) noexcept {
+    if (!valid(counter_before) || counter_after != counter_before) {
+        invalidate();
+        return;
+    }
+    if ((_size + 1) * 2 > _slots.size()) {
+        // Grow by rebuilding from the old table, which is still valid.
+        std::vector<slot> old;
+        try {
+            old = std::exchange(_slots, std::vector<slot>(std::max<size_t>(_slots.size() * 2, min_partitions * 2)));
+        } catch (...) {
+            invalidate();
+            return;
+        }
+        _size = 0;
+        for (auto& s : old) {
+            if (s.entry) {
+                insert_unchecked(s.token, s.entry);
+            }
+        }
+    }
+    insert_unchecked(e.key().token().raw(), &e);
+}
+
+bool memtable_partition_index::should_rebuild(size_t nr_partitions) noexcept {
+    if (_disabled || nr_partitions < min_partitions) {
+        return false;
+    }
+    // A rebuild visits every partition, so it pays for itself after
+    // a number of tree lookups proportional to the number of partitions.
+    return ++_stale_lookups * 16 >= nr_partitions;
+}
+
+template <typename Partitions>
+void memtable_partition_index::rebuild(Partitions& partitions, size_t nr_partitions, uint64_t reclaim_counter) noexcept {
+    invalidate();
+    _stale_lookups = 0;
+    try {
+        _slots.assign(std::bit_ceil(std::max(nr_partitions, min_partitions) * 2), slot{0, nullptr});
+    } catch (...) {
+        _slots = {};
+        return;
+    }
+    _size = 0;
+    for (auto& e : partitions) {
+        insert_unchecked(e.key().token().raw(), &e);
+    }
+    _reclaim_counter = reclaim_counter;
+    _valid = true;
+}
+
+void memtable_partition_index::disable() noexcept {
+    invalidate();
+    _disabled = true;
+    _slots = {};
+    _size = 0;
+}
+
+bool memtable::contains(const dht::decorated_key& dk) {
+    return _read_section(*this, [&] {
+        return find_partition(dht::ring_position(dk)) != nullptr;
+    });
+}
+
+memtable_entry* memtable::find_partition(const dht::ring_position& pos) {
+    assert(!reclaiming_enabled());
+    auto token = pos.token().raw();
+    if (!_partition_index.valid(reclaim_counter()) && _partition_index.should_rebuild(nr_partitions)) {
+        _partition_index.rebuild(partitions, nr_partitions, reclaim_counter());
+    }
+    if (_partition_index.valid(reclaim_counter())) {
+        auto e = _partition_index.find(token);
+        if (!e) {
+            return nullptr;
+        }
+        if (dht::ring_position_comparator(*_schema)(pos, e->key()) == 0) {
+            return e;
+        }
+        if (e->is_head() && e->is_tail()) {
+            return nullptr;
+        }
+        // There are other keys with the same token, look it up in the tree.
+    }
+    auto i = partitions.find(pos, dht::ring_position_comparator(*_schema));
+    return i != partitions.end() ? &*i : nullptr;
+}
+
 partition_entry&
 memtable::find_or_create_partition_slow(partition_key_view key) {
     assert(!reclaiming_enabled());
@@ -220,9 +351,19 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
     assert(!reclaiming_enabled());
 
     // call lower_bound so we have a hint for the insert, just in case.
+    if (_partition_index.valid(reclaim_counter())) {
+        auto e = _partition_index.find(key.token().raw());
+        if (e && e->key().equal(*_schema, key)) {
+            ++_table_stats.memtable_partition_hits;
+            upgrade_entry(*e);
+            return e->partition();
+        }
+    }
+
     partitions_type::bound_hint hint;
     auto i = partitions.lower_bound(key, dht::ring_position_comparator(*_schema), hint);
     if (i == partitions.end() || !hint.match) {
+        auto counter_before = reclaim_counter();
         partitions_type::iterator entry = partitions.emplace_before(i,
                 key.token().raw(), hint,
                 _schema, dht::decorated_key(key), mutation_partition(_schema));
@@ -231,6 +372,7 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
         if (!hint.emplace_keeps_iterators()) {
             current_allocator().invalidate_references();
         }
+        _partition_index.on_insert(*entry, counter_before, reclaim_counter());
         return entry->partition();
     } else {
         ++_table_stats.memtable_partition_hits;
@@ -619,30 +761,64 @@ class flush_reader final : public flat_mutation_reader_v2::impl, private iterato
     // without using any intermediate buffers.
     flat_mutation_reader_v2_opt _partition_reader;
     flush_memory_accounter _flushed_memory;
+    memtable::can_purge_fn _can_purge;
 public:
-    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m)
+    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m, memtable::can_purge_fn can_purge)
         : impl(s, std::move(permit))
         , iterator_reader(std::move(s), m, query::full_partition_range)
         , _flushed_memory(*m)
+        , _can_purge(m->schema()->purge_dead_partitions_on_flush() ? std::move(can_purge) : memtable::can_purge_fn())
     {}
     flush_reader(const flush_reader&) = delete;
     flush_reader(flush_reader&&) = delete;
     flush_reader& operator=(flush_reader&&) = delete;
     flush_reader& operator=(const flush_reader&) = delete;
 private:
-    void get_next_partition() {
-        uint64_t component_size = 0;
-        auto key_and_snp = read_section()(region(), [&] () -> std::optional<std::pair<dht::decorated_key, partition_snapshot_ptr>> {
+    // Must be called with reclaim disabled.
+    static bool has_live_data(partition_snapshot& snp, gc_clock::time_point now) {
+        const schema& s = *snp.schema();
+        auto tomb = snp.partition_tombstone();
+        for (auto&& v : snp.versions()) {
+            const mutation_partition& p = v.partition();
+            if (p.static_row().is_live(s, column_kind::static_column, tomb, now)) {
+                return true;
+            }
+            for (const rows_entry& e : p.clustered_rows()) {
+                if (!e.dummy() && e.row().is_live(s, tomb, now)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    std::optional<std::pair<dht::decorated_key, partition_snapshot_ptr>> fetch_next(uint64_t& component_size, bool& dead, gc_clock::time_point now) {
+        return read_section()(region(), [&] () -> std::optional<std::pair<dht::decorated_key, partition_snapshot_ptr>> {
             memtable_entry* e = fetch_entry();
             if (e) {
                 auto dk = e->key();
                 auto snp = e->snapshot(*mtbl());
                 component_size = _flushed_memory.compute_size(*e, *snp);
+                dead = _can_purge && !has_live_data(*snp, now);
                 advance_iterator();
                 return std::pair(std::move(dk), std::move(snp));
             }
             return { };
         });
+    }
+
+    void get_next_partition() {
+        uint64_t component_size = 0;
+        bool dead = false;
+        auto now = gc_clock::now();
+        auto key_and_snp = fetch_next(component_size, dead, now);
+        while (key_and_snp && dead && _can_purge(key_and_snp->first)) {
+            // Left out before any of it is read, so only the memory of its
+            // entry is accounted as flushed.
+            _flushed_memory.update_bytes_read(component_size);
+            update_last(key_and_snp->first);
+            key_and_snp = fetch_next(component_size, dead, now);
+        }
         if (key_and_snp) {
             _flushed_memory.update_bytes_read(component_size);
             update_last(key_and_snp->first);
@@ -712,10 +888,10 @@ memtable::make_flat_reader_opt(schema_ptr s,
     if (query::is_single_partition(range) && !fwd_mr) {
         const query::ring_position& pos = range.start()->value();
         auto snp = _read_section(*this, [&] () -> partition_snapshot_ptr {
-            auto i = partitions.find(pos, dht::ring_position_comparator(*_schema));
-            if (i != partitions.end()) {
-                upgrade_entry(*i);
-                return i->snapshot(*this);
+            auto e = find_partition(pos);
+            if (e) {
+                upgrade_entry(*e);
+                return e->snapshot(*this);
             } else {
                 return { };
             }
@@ -744,9 +920,9 @@ memtable::make_flat_reader_opt(schema_ptr s,
 }
 
 flat_mutation_reader_v2
-memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc) {
+memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc, can_purge_fn can_purge) {
     if (!_merged_into_cache) {
-        return make_flat_mutation_reader_v2<flush_reader>(std::move(s), std::move(permit), shared_from_this());
+        return make_flat_mutation_reader_v2<flush_reader>(std::move(s), std::move(permit), shared_from_this(), std::move(can_purge));
     } else {
         auto& full_slice = s->full_slice();
         return make_flat_mutation_reader_v2<scanning_reader>(std::move(s), shared_from_this(), std::move(permit),
@@ -788,11 +964,102 @@ memtable::apply(const mutation& m, db::rp_handle&& h) {
     update(std::move(h));
 }
 
+// Visits a frozen partition and applies it into an existing mutation_partition,
+// updating the encoding stats on the way. Saves building a mutation_partition
+// for the frozen partition and merging it in a second step.
+//
+// Weak exception guarantees, but since applying is idempotent, retrying after
+// a failure yields the same result as a successful first attempt.
+class memtable::frozen_partition_applier final : public mutation_partition_view_virtual_visitor {
+    const schema& _schema;
+    mutation_partition& _partition;
+    memtable_encoding_stats_collector& _stats_collector;
+    mutation_application_stats& _app_stats;
+    deletable_row* _current_row = nullptr;
+private:
+    void update_stats(const column_definition& cdef, collection_mutation_view cmv) {
+        cmv.with_deserialized(*cdef.type, [&] (collection_mutation_view_description mview) {
+            _stats_collector.update(mview.tomb);
+            for (auto& entry : mview.cells) {
+                _stats_collector.update(entry.second);
+            }
+        });
+    }
+public:
+    frozen_partition_applier(const schema& s, mutation_partition& p, memtable_encoding_stats_collector& stats_collector,
+            mutation_application_stats& app_stats)
+        : _schema(s)
+        , _partition(p)
+        , _stats_collector(stats_collector)
+        , _app_stats(app_stats)
+    { }
+
+    virtual void accept_partition_tombstone(tombstone t) override {
+        _stats_collector.update(t);
+        _partition.apply(t);
+    }
+
+    virtual void accept_static_cell(column_id id, atomic_cell ac) override {
+        _stats_collector.update(ac);
+        _partition.static_row().apply(_schema.static_column_at(id), atomic_cell_or_collection(std::move(ac)));
+    }
+
+    virtual void accept_static_cell(column_id id, collection_mutation_view cmv) override {
+        auto& cdef = _schema.static_column_at(id);
+        update_stats(cdef, cmv);
+        _partition.static_row().apply(cdef, collection_mutation(*cdef.type, cmv));
+    }
+
+    virtual stop_iteration accept_row_tombstone(range_tombstone rt) override {
+        _stats_collector.update(rt);
+        _partition.apply_row_tombstone(_schema, std::move(rt));
+        return stop_iteration::no;
+    }
+
+    virtual stop_iteration accept_row(position_in_partition_view key, row_tombstone deleted_at, row_marker rm, is_dummy dummy, is_continuous continuous) override {
+        _stats_collector.update(rm);
+        _stats_collector.update(deleted_at.regular());
+        _stats_collector.update(deleted_at.tomb());
+        auto [e, inserted] = _partition.find_or_insert_clustered_row(_schema, key, dummy, continuous);
+        if (!inserted && !dummy) {
+            e.set_dummy(false);
+        }
+        deletable_row& r = e.row();
+        r.apply(rm);
+        r.apply(deleted_at);
+        _current_row = &r;
+        ++_app_stats.row_writes;
+        if (!inserted) {
+            ++_app_stats.row_hits;
+        }
+        return stop_iteration::no;
+    }
+
+    virtual void accept_row_cell(column_id id, atomic_cell ac) override {
+        _stats_collector.update(ac);
+        _current_row->cells().apply(_schema.regular_column_at(id), atomic_cell_or_collection(std::move(ac)));
+    }
+
+    virtual void accept_row_cell(column_id id, collection_mutation_view cmv) override {
+        auto& cdef = _schema.regular_column_at(id);
+        update_stats(cdef, cmv);
+        _current_row->cells().apply(cdef, collection_mutation(*cdef.type, cmv));
+    }
+};
+
 void
 memtable::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle&& h) {
     with_allocator(allocator(), [this, &m, &m_schema] {
         _allocating_section(*this, [&, this] {
             auto& p = find_or_create_partition_slow(m.key());
+            // Fast path: apply straight into the latest version, if no reader holds a snapshot of it
+            // and no upgrade is needed.
+            if (auto* latest = p.partition().unreferenced_latest_partition();
+                    latest && m_schema->version() == _schema->version()) {
+                frozen_partition_applier applier(*_schema, *latest, _stats_collector, _table_stats.memtable_app_stats);
+                m.partition().accept(_schema->get_column_mapping(), applier);
+                return;
+            }
             mutation_partition mp(m_schema);
             partition_builder pb(*m_schema, mp);
             m.partition().accept(*m_schema, pb);
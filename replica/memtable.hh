@@ -10,6 +10,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 #include <iosfwd>
 #include "replica/database_fwd.hh"
 #include "dht/i_partitioner.hh"
@@ -103,6 +104,52 @@ namespace replica {
 
 struct table_stats;
 
+// Side index of memtable partitions by token, for point lookups.
+//
+// Maps tokens to entries in an open-addressing hash table, which replaces the
+// walk down the partition tree with (usually) a single probe. The table lives
+// in standard memory and holds raw pointers into the memtable's region, so it
+// is only valid as long as the region's reclaim counter doesn't change. Stale
+// tables are not used, and are rebuilt once enough lookups missed them to pay
+// for the rebuild.
+//
+// Only the first entry of a token is indexed. Lookups of other keys with the
+// same token fall back to the tree.
+class memtable_partition_index {
+    struct slot {
+        int64_t token;
+        memtable_entry* entry; // nullptr if the slot is empty
+    };
+    // Memtables smaller than that are searched fast enough through the tree.
+    static constexpr size_t min_partitions = 256;
+    std::vector<slot> _slots;
+    size_t _size = 0;
+    uint64_t _reclaim_counter = 0;
+    size_t _stale_lookups = 0;
+    bool _valid = false;
+    bool _disabled = false;
+private:
+    size_t slot_of(int64_t token) const noexcept;
+    void insert_unchecked(int64_t token, memtable_entry* e) noexcept;
+    void invalidate() noexcept;
+public:
+    bool valid(uint64_t reclaim_counter) const noexcept {
+        return _valid && _reclaim_counter == reclaim_counter;
+    }
+    // Returns the indexed entry for the token, or nullptr if missing.
+    // Must only be called when valid().
+    memtable_entry* find(int64_t token) const noexcept;
+    // Indexes an entry which was just inserted into the memtable. The reclaim counters
+    // are the ones from before and after the insertion.
+    void on_insert(memtable_entry& e, uint64_t counter_before, uint64_t counter_after) noexcept;
+    // Returns true if the caller should rebuild the index, given the number of partitions.
+    bool should_rebuild(size_t nr_partitions) noexcept;
+    template <typename Partitions>
+    void rebuild(Partitions& partitions, size_t nr_partitions, uint64_t reclaim_counter) noexcept;
+    // Called when entries are removed from the memtable. The index is not maintained anymore.
+    void disable() noexcept;
+};
+
 // Managed by lw_shared_ptr<>.
 class memtable final : public enable_lw_shared_from_this<memtable>, private dirty_memory_manager_logalloc::size_tracked_region {
 public:
@@ -118,6 +165,7 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     logalloc::allocating_section _allocating_section;
     partitions_type partitions;
     size_t nr_partitions = 0;
+    mutable memtable_partition_index _partition_index;
     db::replay_position _replay_position;
     db::rp_set _rp_set;
     // mutation source to which reads fall-back after mark_flushed()
@@ -130,6 +178,10 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     uint64_t _flushed_memory = 0;
     bool _merged_into_cache = false;
     replica::table_stats& _table_stats;
+    // The table's row application stats when this memtable was created.
+    // Only the active memtable of a table receives writes, so the difference
+    // with the current stats are the writes of this memtable.
+    mutation_application_stats _app_stats_at_creation;
 
     class memtable_encoding_stats_collector : public encoding_stats_collector {
     private:
@@ -159,6 +211,9 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     } _stats_collector;
 
     void update(db::rp_handle&&);
+
+    // Applies a frozen partition directly into a memtable partition.
+    class frozen_partition_applier;
     friend class ::row_cache;
     friend class memtable_entry;
     friend class flush_reader;
@@ -168,6 +223,8 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     boost::iterator_range<partitions_type::const_iterator> slice(const dht::partition_range& r) const;
     partition_entry& find_or_create_partition(const dht::decorated_key& key);
     partition_entry& find_or_create_partition_slow(partition_key_view key);
+    // Returns the entry with the given key, or nullptr. Must be called with reclaim disabled.
+    memtable_entry* find_partition(const dht::ring_position& pos);
     void upgrade_entry(memtable_entry&);
     void add_flushed_memory(uint64_t);
     void remove_flushed_memory(uint64_t);
@@ -192,6 +249,12 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     void apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle&& = {});
     void evict_entry(memtable_entry& e, mutation_cleaner& cleaner) noexcept;
 
+    // The fraction of the row writes applied to this memtable which hit a row
+    // already present in it. Writes to a memtable with a high ratio mostly
+    // replace data in memory, and compaction would have to do the same work
+    // if that data was flushed.
+    double overwrite_ratio() const noexcept;
+
     static memtable& from_region(logalloc::region& r) noexcept {
         return static_cast<memtable&>(r);
     }
@@ -266,7 +329,15 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
         return make_flat_reader(s, std::move(permit), range, full_slice);
     }
 
-    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc);
+    // Decides whether a partition without live data can be left out of the flush.
+    // Called only for such partitions, and only if the schema has
+    // purge_dead_partitions_on_flush() set.
+    using can_purge_fn = noncopyable_function<bool(const dht::decorated_key&)>;
+
+    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc, can_purge_fn can_purge = {});
+
+    // Returns true if the memtable has an entry for the key.
+    bool contains(const dht::decorated_key& dk);
 
     mutation_source as_data_source();
 
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+
+#include "dht/i_partitioner.hh"
+
+namespace replica {
+
+// Summaries of the contents of token ranges of a table on this shard.
+//
+// Repair records the combined hash of the rows it read from a range, along
+// with the seed the rows were hashed with. A later repair of the same range
+// can hash with the same seed, and skip the range without reading it if all
+// replicas still have the same summary. Any write into a range drops its
+// summary. Summaries are kept in memory only, so they don't survive restarts.
+class range_hash_summaries {
+public:
+    struct summary {
+        uint64_t seed;
+        uint64_t hash;
+    };
+private:
+    struct entry {
+        dht::token_range range;
+        uint64_t seed;
+        // Disengaged while the range is being read.
+        std::optional<uint64_t> hash;
+    };
+    // Keyed by the start of the range. Entries don't overlap.
+    std::map<dht::token, entry> _entries;
+private:
+    static const dht::token& start_of(const dht::token_range& r) {
+        return r.start() ? r.start()->value() : dht::minimum_token();
+    }
+
+    void erase_overlapping(const dht::token_range& r) {
+        auto cmp = dht::token_comparator();
+        auto i = _entries.upper_bound(start_of(r));
+        if (i != _entries.begin()) {
+            --i;
+        }
+        while (i != _entries.end() && !(r.end() && cmp(r.end()->value(), i->first) < 0)) {
+            if (i->second.range.overlaps(r, cmp)) {
+                i = _entries.erase(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+public:
+    bool empty() const noexcept {
+        return _entries.empty();
+    }
+
+    // Returns the summary of exactly the given range, if there is one.
+    std::optional<summary> get(const dht::token_range& r) const {
+        auto i = _entries.find(start_of(r));
+        if (i == _entries.end() || !i->second.hash || !i->second.range.equal(r, dht::token_comparator())) {
+            return std::nullopt;
+        }
+        return summary{i->second.seed, *i->second.hash};
+    }
+
+    // Starts tracking writes to the range, before it is read with the given seed.
+    // Keeps the current summary of the range if it was computed with the same seed.
+    void start(const dht::token_range& r, uint64_t seed) {
+        if (auto s = get(r); s && s->seed == seed) {
+            return;
+        }
+        erase_overlapping(r);
+        _entries.insert_or_assign(start_of(r), entry{r, seed, std::nullopt});
+    }
+
+    // Records the hash of the whole range, read with the given seed after start().
+    // Does nothing if the range was written to in between.
+    void finish(const dht::token_range& r, uint64_t seed, uint64_t hash) {
+        auto i = _entries.find(start_of(r));
+        if (i != _entries.end() && i->second.seed == seed && i->second.range.equal(r, dht::token_comparator())) {
+            i->second.hash = hash;
+        }
+    }
+
+    void invalidate(const dht::token& t) {
+        invalidate(dht::token_range::make_singular(t));
+    }
+
+    void invalidate(const dht::token_range& r) {
+        erase_overlapping(r);
+    }
+
+    void clear() noexcept {
+        _entries.clear();
+    }
+};
+
+}
@@ -30,6 +30,7 @@
 #include "memtable-sstable.hh"
 #include "compaction/compaction_manager.hh"
 #include "compaction/table_state.hh"
+#include "compaction/leveled_manifest.hh"
 #include "sstables/sstable_directory.hh"
 #include "db/system_keyspace.hh"
 #include "db/query_context.hh"
@@ -61,6 +62,8 @@ namespace replica {
 static logging::logger tlogger("table");
 static seastar::metrics::label column_family_label("cf");
 static seastar::metrics::label keyspace_label("ks");
+static seastar::metrics::label component_label("component");
+static seastar::metrics::label io_reason_label("reason");
 
 using namespace std::chrono_literals;
 
@@ -221,6 +224,13 @@ table::make_reader_v2(schema_ptr s,
     return rd;
 }
 
+bool table::is_cached(const dht::decorated_key& dk, const query::partition_slice& slice) const {
+    if (!cache_enabled() || slice.options.contains(query::partition_slice::option::bypass_cache) || slice.is_reversed()) {
+        return false;
+    }
+    return _cache.is_cached(dk, slice.row_ranges(*_schema, dk.key()), !slice.static_columns.empty());
+}
+
 sstables::shared_sstable table::make_streaming_sstable_for_write(std::optional<sstring> subdir) {
     sstring dir = _config.datadir;
     if (subdir) {
@@ -500,6 +510,7 @@ table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::o
         // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
         // atomically load all opened sstables into column family.
         compaction_group& cg = compaction_group_for_sstable(sst);
+        _range_hash_summaries.invalidate(dht::token_range::make(sst->get_first_decorated_key().token(), sst->get_last_decorated_key().token()));
         if (!offstrategy) {
             add_sstable(cg, sst);
         } else {
@@ -807,10 +818,26 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
           co_await coroutine::return_exception_ptr(std::move(ex));
         });
 
+        // A partition with no live data can be left out of the sstable only if
+        // nothing else may have older data which its tombstones shadow.
+        auto can_purge = [this, old] (const dht::decorated_key& dk) {
+            for (auto& mt : *compaction_group_for_token(dk.token()).memtables()) {
+                if (mt != old && mt->contains(dk)) {
+                    return false;
+                }
+            }
+            for (auto& sst : *get_sstables()) {
+                if (sst->filter_has_key(*_schema, dk)) {
+                    return false;
+                }
+            }
+            return true;
+        };
         auto f = consumer(old->make_flush_reader(
             old->schema(),
             compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout),
-            service::get_local_memtable_flush_priority()));
+            service::get_local_memtable_flush_priority(),
+            std::move(can_purge)));
 
         // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
         // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
@@ -859,6 +886,7 @@ table::stop() {
     }
     co_await _async_gate.close();
     co_await await_pending_ops();
+    co_await _view_update_coalescer.stop();
     co_await _compaction_group->stop();
     co_await _sstable_deletion_gate.close();
     co_await get_row_cache().invalidate(row_cache::external_updater([this] {
@@ -894,6 +922,16 @@ void table::set_metrics() {
                         [this] { return _sstable_deletion_sem.waiters(); })(cf)(ks)
         });
 
+        static const seastar::metrics::label level_label("level");
+        for (int level = 0; level < leveled_manifest::MAX_LEVELS; level++) {
+            _metrics.add_group("column_family", {
+                ms::make_gauge("pending_compaction_by_level", ms::description("Estimated number of compactions pending on each level, for tables using leveled compaction"), [this, level] {
+                    auto pending = _compaction_strategy.estimated_pending_compactions_per_level();
+                    return size_t(level) < pending.size() ? pending[level] : 0;
+                })(cf)(ks)(level_label(level)).set_skip_when_empty()
+            });
+        }
+
         // Metrics related to row locking
         auto add_row_lock_metrics = [this, ks, cf] (row_locker::single_lock_stats& stats, sstring stat_name) {
             _metrics.add_group("column_family", {
@@ -928,6 +966,23 @@ void table::set_metrics() {
                     ms::make_histogram("cas_commit_latency", ms::description("CAS learn round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_learn.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks)
             });
+
+            using io_stats = sstables::io_stats;
+            for (size_t c = 0; c < io_stats::component_count; ++c) {
+                for (size_t r = 0; r < io_stats::reason_count; ++r) {
+                    auto& counters = _sstables_io_stats->get(io_stats::component(c), io_stats::reason(r));
+                    auto component = component_label(sstables::to_string(io_stats::component(c)));
+                    auto reason = io_reason_label(sstables::to_string(io_stats::reason(r)));
+                    _metrics.add_group("column_family", {
+                            ms::make_counter("sstable_read_ops", counters.read_ops, ms::description("Number of disk reads from sstable components"))(cf)(ks)(component)(reason).set_skip_when_empty(),
+                            ms::make_counter("sstable_read_bytes", counters.read_bytes, ms::description("Number of bytes read from disk from sstable components"))(cf)(ks)(component)(reason).set_skip_when_empty(),
+                            ms::make_counter("sstable_write_ops", counters.write_ops, ms::description("Number of disk writes to sstable components"))(cf)(ks)(component)(reason).set_skip_when_empty(),
+                            ms::make_counter("sstable_write_bytes", counters.write_bytes, ms::description("Number of bytes written to disk to sstable components"))(cf)(ks)(component)(reason).set_skip_when_empty(),
+                            ms::make_histogram("sstable_read_latency", ms::description("Latency histogram of disk reads from sstable components"),
+                                    [&counters] {return to_metrics_histogram(counters.read_latency);})(cf)(ks)(component)(reason).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                    });
+                }
+            }
         }
     }
 }
@@ -1301,6 +1356,7 @@ table::table(schema_ptr schema, config config, db::commitlog* cl, compaction_man
                          keyspace_label(_schema->ks_name()),
                          column_family_label(_schema->cf_name())
                         )
+    , _view_update_coalescer(_view_stats, *_config.cf_stats)
     , _compaction_manager(compaction_manager)
     , _compaction_strategy(make_compaction_strategy(_schema->compaction_strategy(), _schema->compaction_strategy_options()))
     , _compaction_group(std::make_unique<compaction_group>(*this))
@@ -1309,6 +1365,7 @@ table::table(schema_ptr schema, config config, db::commitlog* cl, compaction_man
     , _commitlog(cl)
     , _durable_writes(true)
     , _sstables_manager(sst_manager)
+    , _sstables_io_stats(sst_manager.get_io_stats(_schema->id()))
     , _index_manager(this->as_data_dictionary())
     , _counter_cell_locks(_schema->is_counter() ? std::make_unique<cell_locker>(_schema, cl_stats) : nullptr)
     , _row_locker(_schema)
@@ -1367,6 +1424,7 @@ table::sstables_as_snapshot_source() {
 
 // define in .cc, since sstable is forward-declared in .hh
 table::~table() {
+    _sstables_manager.remove_io_stats(_schema->id());
 }
 
 
@@ -1474,10 +1532,11 @@ future<table::snapshot_file_set> table::take_snapshot(database& db, sstring json
 
     auto tables = boost::copy_range<std::vector<sstables::shared_sstable>>(*_sstables->all());
     co_await io_check([&jsondir] { return recursive_touch_directory(jsondir); });
-    co_await max_concurrent_for_each(tables, db.get_config().initial_sstable_loading_concurrency(), [&db, &jsondir] (sstables::shared_sstable sstable) {
-        return with_semaphore(db.get_sharded_sst_dir_semaphore().local(), 1, [&jsondir, sstable] {
+    // The links are synced once, below, rather than once per sstable.
+    co_await max_concurrent_for_each(tables, db.get_config().snapshot_link_concurrency(), [&db, &jsondir] (sstables::shared_sstable sstable) {
+        return with_semaphore(db.get_snapshot_link_semaphore(), 1, [&jsondir, sstable] {
             return io_check([sstable, &dir = jsondir] {
-                return sstable->create_links(dir);
+                return sstable->snapshot(dir);
             });
         });
     });
@@ -1618,6 +1677,8 @@ future<> compaction_group::clear_memtables() {
 future<> table::clear() {
     auto permits = co_await _config.dirty_memory_manager->get_all_flush_permits();
 
+    _range_hash_summaries.clear();
+
     co_await _compaction_group->clear_memtables();
 
     co_await _cache.invalidate(row_cache::external_updater([] { /* There is no underlying mutation source */ }));
@@ -1627,6 +1688,7 @@ future<> table::clear() {
 // if we implement notifications, whatnot.
 future<db::replay_position> table::discard_sstables(db_clock::time_point truncated_at) {
     assert(_compaction_manager.compaction_disabled(as_table_state()));
+    _range_hash_summaries.clear();
 
     struct pruner {
         column_family& cf;
@@ -1690,6 +1752,9 @@ void table::set_schema(schema_ptr s) {
     tlogger.debug("Changing schema version of {}.{} ({}) from {} to {}",
                 _schema->ks_name(), _schema->cf_name(), _schema->id(), _schema->version(), s->version());
 
+    // The hashes of rows depend on the schema.
+    _range_hash_summaries.clear();
+
     for (auto& m : *_compaction_group->memtables()) {
         m->set_schema(s);
     }
@@ -1812,7 +1877,7 @@ future<> table::generate_and_propagate_view_updates(const schema_ptr& base,
         auto units = seastar::consume_units(*_config.view_update_concurrency_semaphore, memory_usage_of(updates));
         try {
             co_await db::view::mutate_MV(base_token, std::move(updates), _view_stats, *_config.cf_stats, tr_state,
-                std::move(units), service::allow_hints::yes, db::view::wait_for_all_updates::no);
+                std::move(units), service::allow_hints::yes, db::view::wait_for_all_updates::no, &_view_update_coalescer);
         } catch (...) {
             // Ignore exceptions: any individual failure to propagate a view update will be reported
             // by a separate mechanism in mutate_MV() function. Moreover, we should continue trying
@@ -1897,14 +1962,26 @@ table::local_base_lock(
     if (rows.size() == 1 && rows[0].is_singular() && rows[0].start() && !rows[0].start()->value().is_empty(*s)) {
         // A single clustering row is involved.
         return _row_locker.lock_ck(pk, rows[0].start()->value(), true, timeout, _row_locker_stats);
-    } else {
-        // More than a single clustering row is involved. Most commonly it's
-        // the entire partition, so let's lock the entire partition. We could
-        // lock less than the entire partition in more elaborate cases where
-        // just a few individual rows are involved, or row ranges, but we
-        // don't think this will make a practical difference.
-        return _row_locker.lock_pk(pk, true, timeout, _row_locker_stats);
     }
+    auto is_full_row = [&s] (const query::clustering_range& r) {
+        return r.is_singular() && r.start() && r.start()->value().is_full(*s);
+    };
+    if (!rows.empty() && std::ranges::all_of(rows, is_full_row)) {
+        // Several individual rows are involved, e.g. a batch writing a few
+        // rows of the partition. Lock just them, so that writes to other
+        // rows of the partition can proceed concurrently.
+        std::vector<clustering_key_prefix> cks;
+        cks.reserve(rows.size());
+        for (auto& r : rows) {
+            cks.push_back(r.start()->value());
+        }
+        return _row_locker.lock_cks(pk, std::move(cks), true, timeout, _row_locker_stats);
+    }
+    // Row ranges or the entire partition are involved, lock the entire
+    // partition. We could lock less than the entire partition in more
+    // elaborate cases where row ranges are involved, but we don't think
+    // this will make a practical difference.
+    return _row_locker.lock_pk(pk, true, timeout, _row_locker_stats);
 }
 
 /**
@@ -2036,6 +2113,9 @@ void table::do_apply(compaction_group& cg, db::rp_handle&& h, Args&&... args) {
 
 future<> table::apply(const mutation& m, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
     return dirty_memory_region_group().run_when_memory_available([this, &m, h = std::move(h)] () mutable {
+        if (!_range_hash_summaries.empty()) {
+            _range_hash_summaries.invalidate(m.token());
+        }
         do_apply(compaction_group_for_token(m.token()), std::move(h), m);
     }, timeout);
 }
@@ -2048,6 +2128,9 @@ future<> table::apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_hand
     }
 
     return dirty_memory_region_group().run_when_memory_available([this, &m, m_schema = std::move(m_schema), h = std::move(h)]() mutable {
+        if (!_range_hash_summaries.empty()) {
+            _range_hash_summaries.invalidate(dht::get_token(*m_schema, m.key()));
+        }
         do_apply(compaction_group_for_key(m.key(), m_schema), std::move(h), m, m_schema);
     }, timeout);
 }
@@ -2098,7 +2181,7 @@ struct query_state {
                          query::result_memory_accounter memory_accounter)
             : schema(std::move(s))
             , cmd(cmd)
-            , builder(cmd.slice, opts, std::move(memory_accounter), cmd.tombstone_limit)
+            , builder(cmd.slice, opts, std::move(memory_accounter), cmd.tombstone_limit, cmd.filter ? &*cmd.filter : nullptr)
             , limit(cmd.get_row_limit())
             , partition_limit(cmd.partition_limit)
             , current_partition_range(ranges.begin())
@@ -2174,13 +2257,20 @@ table::query(schema_ptr s,
       } catch (...) {
         ex = std::current_exception();
       }
-        if (ex || !qs.done()) {
+        // Rows dropped by the filter count towards the limits, but not towards
+        // the rows of the result, so the limits can be reached before qs.done().
+        const bool limits_reached = !ex && q.are_limits_reached();
+        if (ex || (!qs.done() && !limits_reached)) {
             co_await q.close();
             querier_opt = {};
         }
         if (ex) {
             co_return coroutine::exception(std::move(ex));
         }
+        if (limits_reached) {
+            qs.builder.on_limits_reached();
+            break;
+        }
     }
 
     std::optional<full_position> last_pos;
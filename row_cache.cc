@@ -24,6 +24,8 @@
 #include "readers/nonforwardable.hh"
 #include "cache_flat_mutation_reader.hh"
 #include "clustering_key_filter.hh"
+#include "clustering_interval_set.hh"
+#include "utils/stall_attribution.hh"
 
 namespace cache {
 
@@ -50,6 +52,7 @@ row_cache::create_underlying_reader(read_context& ctx, mutation_source& src, con
 }
 
 static thread_local mutation_application_stats dummy_app_stats;
+static constexpr size_t protected_entry_size_estimate = 4096;
 
 cache_tracker::cache_tracker(register_metrics with_metrics)
     : cache_tracker(dummy_app_stats, with_metrics)
@@ -66,6 +69,11 @@ cache_tracker::cache_tracker(mutation_application_stats& app_stats, register_met
         setup_metrics();
     }
 
+    // Protected entries are index pages, file pages and decompressed chunks, which
+    // are mostly a few KiB each. Bound their count so that they can't take more
+    // than about half of the memory away from cache rows.
+    _lru.set_max_protected_size(memory::stats().total_memory() / 2 / protected_entry_size_estimate);
+
     _region.make_evictable([this] {
         return with_allocator(_region.allocator(), [this] () noexcept {
             if (!_garbage.empty()) {
@@ -114,6 +122,15 @@ cache_tracker::setup_metrics() {
         sm::make_counter("partition_evictions", sm::description("total number of evicted partitions"), _stats.partition_evictions),
         sm::make_counter("partition_removals", sm::description("total number of invalidated partitions"), _stats.partition_removals),
         sm::make_counter("mispopulations", sm::description("number of entries not inserted by reads"), _stats.mispopulations),
+        sm::make_counter("admission_rejections", sm::description("number of partitions not inserted by reads because they weren't read recently, in tables with frequent-only cache admission"), _stats.admission_rejections),
+        sm::make_counter("lru_promotions", sm::description("number of cache entries moved to the protected segment of the LRU because they were used again"),
+                [this] { return _lru.get_stats().promotions; }),
+        sm::make_counter("lru_demotions", sm::description("number of cache entries moved from the protected segment of the LRU back to probation"),
+                [this] { return _lru.get_stats().demotions; }),
+        sm::make_counter("lru_probation_evictions", sm::description("number of cache entries evicted from the probation segment of the LRU"),
+                [this] { return _lru.get_stats().probation_evictions; }),
+        sm::make_counter("lru_protected_evictions", sm::description("number of cache entries evicted from the protected segment of the LRU"),
+                [this] { return _lru.get_stats().protected_evictions; }),
         sm::make_gauge("partitions", sm::description("total number of cached partitions"), _stats.partitions),
         sm::make_gauge("rows", sm::description("total number of cached rows"), _stats.rows),
         sm::make_counter("reads", sm::description("number of started reads"), _stats.reads),
@@ -188,9 +205,35 @@ void cache_tracker::on_partition_miss() noexcept {
     ++_stats.partition_misses;
 }
 
-void cache_tracker::on_partition_eviction() noexcept {
+void cache_tracker::on_partition_eviction(const cache_entry& e) noexcept {
     --_stats.partitions;
     ++_stats.partition_evictions;
+    if (_admission_sketch) {
+        _victim_frequency = _admission_sketch->estimate(admission_hash(*e.schema(), e.key()));
+    }
+}
+
+uint64_t cache_tracker::admission_hash(const schema& s, const dht::decorated_key& dk) noexcept {
+    // Tokens are hashes of the keys already, the sketch mixes them further.
+    return uint64_t(dk.token().raw()) ^ uint64_t(s.id().uuid().get_least_significant_bits());
+}
+
+void cache_tracker::record_access(const schema& s, const dht::decorated_key& dk) {
+    if (!_admission_sketch) {
+        _admission_sketch = std::make_unique<utils::frequency_sketch>(admission_sketch_width);
+    }
+    _admission_sketch->increment(admission_hash(s, dk));
+}
+
+bool cache_tracker::should_admit(const schema& s, const dht::decorated_key& dk) {
+    record_access(s, dk);
+    // Until something is evicted, the victim's frequency is 0 and everything is admitted.
+    // On a tie the partition already in the cache is kept.
+    const bool admit = _admission_sketch->estimate(admission_hash(s, dk)) > _victim_frequency;
+    if (!admit) {
+        ++_stats.admission_rejections;
+    }
+    return admit;
 }
 
 void cache_tracker::on_row_eviction() noexcept {
@@ -326,6 +369,12 @@ class partition_range_cursor final {
         return _it != _end;
     }
 
+    // Makes the cursor invalid, so that the next advance_to() or refresh()
+    // looks its position up again.
+    void invalidate() noexcept {
+        _last_reclaim_count = std::numeric_limits<uint64_t>::max();
+    }
+
     // Returns current position of the cursor.
     // Result valid as long as this instance is valid and not advanced.
     dht::ring_position_view position() const {
@@ -364,7 +413,14 @@ class single_partition_populating_reader final : public flat_mutation_reader_v2:
         _read_context->enter_partition(_read_context->range().start()->value().as_decorated_key(), src_and_phase.snapshot, phase);
         return _read_context->create_underlying().then([this, phase] {
           return _read_context->underlying().underlying()().then([this, phase] (auto&& mfopt) {
-            if (!mfopt) {
+            if (!_cache.should_admit(_read_context->key())) {
+                if (mfopt) {
+                    _reader = read_directly_from_underlying(*_read_context);
+                    this->push_mutation_fragment(std::move(*mfopt));
+                } else {
+                    _end_of_stream = true;
+                }
+            } else if (!mfopt) {
                 if (phase == _cache.phase_of(_read_context->range().start()->value())) {
                     _cache._read_section(_cache._tracker.region(), [this] {
                         _cache.find_or_create_missing(_read_context->key());
@@ -437,8 +493,11 @@ void cache_tracker::clear_continuity(cache_entry& ce) noexcept {
     ce.set_continuous(false);
 }
 
-void row_cache::on_partition_hit() {
+void row_cache::on_partition_hit(const cache_entry& e) {
     _tracker.on_partition_hit();
+    if (_schema->caching_options().admit_frequent_only()) {
+        _tracker.record_access(*_schema, e.key());
+    }
 }
 
 void row_cache::on_partition_miss() {
@@ -454,6 +513,10 @@ void row_cache::on_mispopulate() {
     _tracker.on_mispopulate();
 }
 
+bool row_cache::should_admit(const dht::decorated_key& dk) {
+    return !_schema->caching_options().admit_frequent_only() || _tracker.should_admit(*_schema, dk);
+}
+
 void row_cache::on_row_miss() {
     _stats.misses.mark();
     _tracker.on_row_miss();
@@ -520,7 +583,12 @@ class range_populating_reader {
                 _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
-                if (_reader.creation_phase() == _cache.phase_of(key)) {
+                if (!_cache.should_admit(key)) {
+                    // The partition is skipped, so the next populated entry can't be continuous with the previous one.
+                    _last_key = {};
+                    return make_ready_future<read_result>(
+                            read_result(read_directly_from_underlying(_read_context), std::move(mfopt)));
+                } else if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
                                                                this->can_set_continuity() ? &*_last_key : nullptr);
@@ -556,6 +624,9 @@ class range_populating_reader {
 };
 
 class scanning_and_populating_reader final : public flat_mutation_reader_v2::impl {
+    // Bounds how many cached partitions a single underlying read may span.
+    static constexpr unsigned max_gaps_per_underlying_read = 16;
+
     const dht::partition_range* _pr;
     row_cache& _cache;
     std::unique_ptr<read_context> _read_context;
@@ -570,7 +641,7 @@ class scanning_and_populating_reader final : public flat_mutation_reader_v2::imp
 private:
     flat_mutation_reader_v2 read_from_entry(cache_entry& ce) {
         _cache.upgrade_entry(ce);
-        _cache.on_partition_hit();
+        _cache.on_partition_hit(ce);
         return ce.read(_cache, *_read_context);
     }
 
@@ -604,10 +675,23 @@ class scanning_and_populating_reader final : public flat_mutation_reader_v2::imp
                 return flat_mutation_reader_v2_opt(std::move(fr));
             } else {
                 if (_primary.in_range()) {
-                    cache_entry& e = _primary.entry();
+                    // Extend the underlying read over the following entries for as long as
+                    // they are discontinuous with their predecessors, so that a run of gaps
+                    // costs one fast-forward of the underlying reader rather than one per gap.
+                    // Entries inside the run are still served from the cache, through
+                    // find_or_create_incomplete(), which also marks them continuous.
+                    dht::decorated_key run_end = _primary.entry().key();
+                    for (unsigned gaps = 1; gaps < max_gaps_per_underlying_read; ++gaps) {
+                        _primary.next();
+                        if (!_primary.in_range() || _primary.entry().continuous()) {
+                            break;
+                        }
+                        run_end = _primary.entry().key();
+                    }
+                    _primary.invalidate();
                     _secondary_range = dht::partition_range(_lower_bound,
-                        dht::partition_range::bound{e.key(), false});
-                    _lower_bound = dht::partition_range::bound{e.key(), true};
+                        dht::partition_range::bound{run_end, false});
+                    _lower_bound = dht::partition_range::bound{std::move(run_end), true};
                     _secondary_in_progress = true;
                     return std::nullopt;
                 } else {
@@ -720,6 +804,39 @@ row_cache::make_scanning_reader(const dht::partition_range& range, std::unique_p
     return make_flat_mutation_reader_v2<scanning_and_populating_reader>(*this, range, std::move(context));
 }
 
+bool row_cache::is_cached(const dht::decorated_key& dk, const query::clustering_row_ranges& ranges, bool static_row) {
+    return _read_section(_tracker.region(), [&] {
+        dht::ring_position_comparator cmp(*_schema);
+        partitions_type::bound_hint hint;
+        auto i = _partitions.lower_bound(dht::ring_position_view(dk), cmp, hint);
+        if (!hint.match) {
+            return i->continuous();
+        }
+        cache_entry& e = *i;
+        const schema& s = *e.schema();
+        // Continuity of an entry is the union of continuities of its versions.
+        clustering_interval_set continuity;
+        bool static_row_continuous = false;
+        for (partition_version& v : e.partition().versions()) {
+            static_row_continuous |= v.partition().static_row_continuous();
+            continuity.add(s, v.partition().get_continuity(s));
+        }
+        if (static_row && !static_row_continuous) {
+            return false;
+        }
+        clustering_interval_set needed;
+        for (auto&& r : ranges) {
+            auto pr = position_range::from_range(r);
+            // A row which is present covers the range from its key, even if the range before it is discontinuous.
+            if (r.start() && r.start()->is_inclusive() && r.start()->value().is_full(s)) {
+                pr = position_range(position_in_partition::for_key(r.start()->value()), position_in_partition(pr.end()));
+            }
+            needed.add(s, pr);
+        }
+        return needed.contained_in(continuity);
+    });
+}
+
 flat_mutation_reader_v2_opt
 row_cache::make_reader_opt(schema_ptr s,
                        reader_permit permit,
@@ -745,7 +862,7 @@ row_cache::make_reader_opt(schema_ptr s,
             if (hint.match) {
                 cache_entry& e = *i;
                 upgrade_entry(e);
-                on_partition_hit();
+                on_partition_hit(e);
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return {};
@@ -954,6 +1071,7 @@ future<> row_cache::do_update(external_updater eu, replica::memtable& m, Updater
         partition_presence_checker is_present = _prev_snapshot->make_partition_presence_checker();
         while (!m.partitions.empty()) {
             with_allocator(_tracker.allocator(), [&] () {
+                utils::stall_attribution::scope stall_scope(utils::stall_attribution::operation::cache_update);
                 auto cmp = dht::ring_position_comparator(*_schema);
                 {
                     size_t partition_count = 0;
@@ -1207,7 +1325,7 @@ void cache_entry::on_evicted(cache_tracker& tracker) noexcept {
     row_cache::partitions_type::iterator it(this);
     std::next(it)->set_continuous(false);
     evict(tracker);
-    tracker.on_partition_eviction();
+    tracker.on_partition_eviction(*this);
     it.erase(dht::raw_token_less_comparator{});
 }
 
@@ -257,14 +257,18 @@ class row_cache final {
     logalloc::allocating_section _update_section;
     logalloc::allocating_section _populate_section;
     logalloc::allocating_section _read_section;
+
     flat_mutation_reader_v2 create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader_v2 make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
-    void on_partition_hit();
+    void on_partition_hit(const cache_entry&);
     void on_partition_miss();
     void on_row_hit();
     void on_row_miss();
     void on_static_row_insert();
     void on_mispopulate();
+    // Records a read of a partition missing from cache, and tells whether
+    // the read should populate the cache with it.
+    bool should_admit(const dht::decorated_key&);
     void upgrade_entry(cache_entry&);
     void invalidate_locked(const dht::decorated_key&);
     void clear_now() noexcept;
@@ -391,6 +395,12 @@ class row_cache final {
         return make_reader(std::move(s), std::move(permit), range, full_slice);
     }
 
+    // Returns true iff the static row, if static_row is set, and the given clustering ranges of the
+    // partition can be read from cache without reading from the underlying mutation source.
+    // This includes partitions which cache knows to be absent.
+    // Doesn't populate cache nor affect its statistics.
+    bool is_cached(const dht::decorated_key& dk, const query::clustering_row_ranges& ranges, bool static_row);
+
     const stats& stats() const { return _stats; }
 public:
     // Populate cache from given mutation, which must be fully continuous.
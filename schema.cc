@@ -169,6 +169,20 @@ schema::make_column_specification(const column_definition& def) const {
     return make_lw_shared<cql3::column_specification>(_raw._ks_name, _raw._cf_name, std::move(id), def.type);
 }
 
+// Column definitions copied from another version of the same table (which is
+// how schema_builder creates new versions) carry that version's column
+// specification. When it still describes the column, keep it, so that the
+// versions share it instead of each holding its own copy.
+bool schema::can_share_column_specification(const column_definition& def) const {
+    const auto& spec = def.column_specification;
+    return spec
+        && column_name_type(def) == utf8_type
+        && spec->type == def.type
+        && spec->name->name() == def.name()
+        && spec->ks_name == _raw._ks_name
+        && spec->cf_name == _raw._cf_name;
+}
+
 v3_columns::v3_columns(std::vector<column_definition> cols, bool is_dense, bool is_compound)
     : _is_dense(is_dense)
     , _is_compound(is_compound)
@@ -180,6 +194,16 @@ v3_columns::v3_columns(std::vector<column_definition> cols, bool is_dense, bool
 }
 
 v3_columns v3_columns::from_v2_schema(const schema& s) {
+    if (!s.is_compact_table() && s.regular_column_name_type() == utf8_type) {
+        // The v3 layout is the same as ours, down to the column specifications.
+        v3_columns ret;
+        ret._is_dense = s.is_dense();
+        ret._is_compound = s.is_compound();
+        ret._schema_columns = &s.all_columns();
+        ret._schema_columns_by_name = &s.columns_by_name();
+        return ret;
+    }
+
     data_type static_column_name_type = utf8_type;
     std::vector<column_definition> cols;
 
@@ -221,7 +245,7 @@ v3_columns v3_columns::from_v2_schema(const schema& s) {
 
 void v3_columns::apply_to(schema_builder& builder) const {
     if (is_static_compact()) {
-        for (auto& c : _columns) {
+        for (auto& c : all_columns()) {
             if (c.kind == column_kind::regular_column) {
                 builder.set_default_validation_class(c.type);
             } else if (c.kind == column_kind::static_column) {
@@ -235,7 +259,7 @@ void v3_columns::apply_to(schema_builder& builder) const {
             }
         }
     } else {
-        for (auto& c : _columns) {
+        for (auto& c : all_columns()) {
             if (is_compact() && c.kind == column_kind::regular_column) {
                 builder.set_default_validation_class(c.type);
             }
@@ -253,11 +277,11 @@ bool v3_columns::is_compact() const {
 }
 
 const std::unordered_map<bytes, const column_definition*>& v3_columns::columns_by_name() const {
-    return _columns_by_name;
+    return _schema_columns_by_name ? *_schema_columns_by_name : _columns_by_name;
 }
 
 const std::vector<column_definition>& v3_columns::all_columns() const {
-    return _columns;
+    return _schema_columns ? *_schema_columns : _columns;
 }
 
 void schema::rebuild() {
@@ -364,7 +388,9 @@ schema::schema(private_tag, const raw_schema& raw, std::optional<raw_view_info>
 
     column_id id = 0;
     for (auto& def : _raw._columns) {
-        def.column_specification = make_column_specification(def);
+        if (!can_share_column_specification(def)) {
+            def.column_specification = make_column_specification(def);
+        }
         assert(!def.id || def.id == id - column_offset(def.kind));
         def.ordinal_id = static_cast<ordinal_column_id>(id);
         def.id = id - column_offset(def.kind);
@@ -515,6 +515,11 @@ class v3_columns {
     bool _is_compound = false;
     std::vector<column_definition> _columns;
     std::unordered_map<bytes, const column_definition*> _columns_by_name;
+    // Set when the v3 layout is identical to the schema's own, which is the
+    // case for all CQL3 tables. The schema's columns are used then, instead
+    // of keeping a second copy of every column definition.
+    const std::vector<column_definition>* _schema_columns = nullptr;
+    const std::unordered_map<bytes, const column_definition*>* _schema_columns_by_name = nullptr;
 public:
     v3_columns(std::vector<column_definition> columns, bool is_dense, bool is_compound);
     v3_columns() = default;
@@ -622,6 +627,9 @@ class schema final : public enable_lw_shared_from_this<schema> {
         // The flag is not stored in the schema mutation and does not affects schema digest.
         // It is set locally on a system tables that should be extra durable
         bool _wait_for_sync = false; // true if all writes using this schema have to be synced immediately by commitlog
+        // Not stored in the schema mutation either. Set locally on system tables
+        // whose partitions are usually deleted soon after they are written.
+        bool _purge_dead_partitions_on_flush = false;
         std::reference_wrapper<const dht::i_partitioner> _partitioner;
         // Sharding info is not stored in the schema mutation and does not affect
         // schema digest. It is also not set locally on a schema tables.
@@ -674,6 +682,7 @@ class schema final : public enable_lw_shared_from_this<schema> {
     struct reversed_tag { };
 
     lw_shared_ptr<cql3::column_specification> make_column_specification(const column_definition& def) const;
+    bool can_share_column_specification(const column_definition& def) const;
     void rebuild();
     schema(const schema&, const std::function<void(schema&)>&);
     class private_tag{};
@@ -951,6 +960,12 @@ class schema final : public enable_lw_shared_from_this<schema> {
     bool wait_for_sync_to_commitlog() const {
         return _raw._wait_for_sync;
     }
+    // If true, memtable flush drops partitions which have no live data, as long
+    // as no other memtable or sstable may have data for them. Requires
+    // gc_grace_seconds to be zero, since the tombstones are dropped too.
+    bool purge_dead_partitions_on_flush() const {
+        return _raw._purge_dead_partitions_on_flush && _raw._gc_grace_seconds == 0;
+    }
 public:
     const v3_columns& v3() const {
         return _v3_columns;
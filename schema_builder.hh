@@ -236,6 +236,10 @@ struct schema_builder {
         _raw._wait_for_sync = sync;
         return *this;
     }
+    schema_builder& set_purge_dead_partitions_on_flush(bool purge) {
+        _raw._purge_dead_partitions_on_flush = purge;
+        return *this;
+    }
     schema_builder& with_partitioner(sstring name);
     schema_builder& with_sharder(unsigned shard_count, unsigned sharding_ignore_msb_bits);
     schema_builder& with_null_sharder(); // a sharder that puts everything on shard 0
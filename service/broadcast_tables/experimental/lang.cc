@@ -27,7 +27,14 @@ bool is_broadcast_table_statement(const sstring& keyspace, const sstring& column
     return keyspace == db::system_keyspace::NAME && column_family == db::system_keyspace::BROADCAST_KV_STORE;
 }
 
-future<query_result> execute(service::raft_group0_client& group0_client, const query& query) {
+future<query_result> execute(service::raft_group0_client& group0_client, service::storage_proxy& proxy, const query& query) {
+    if (std::holds_alternative<select_query>(query.q)) {
+        // Reads don't change the state, so instead of going through the log they only need to see
+        // everything committed before they started: wait for it to be applied locally, then read.
+        co_await group0_client.read_barrier_unguarded();
+        co_return co_await execute_broadcast_table_query(proxy, query, utils::UUID{});
+    }
+
     auto group0_cmd = group0_client.prepare_command(broadcast_table_query{query});
     auto guard = group0_client.create_result_guard(group0_cmd.new_state_id);
     co_await group0_client.add_entry_unguarded(std::move(group0_cmd));
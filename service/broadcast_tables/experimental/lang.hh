@@ -50,7 +50,7 @@ struct query {
 // For now it returns true if and only if target table is system.broadcast_kv_store.
 bool is_broadcast_table_statement(const sstring& keyspace, const sstring& column_family);
 
-future<query_result> execute(service::raft_group0_client& group0_client, const query& query);
+future<query_result> execute(service::raft_group0_client& group0_client, service::storage_proxy& proxy, const query& query);
 
 future<query_result> execute_broadcast_table_query(service::storage_proxy& proxy, const query& query, utils::UUID cmd_id);
 
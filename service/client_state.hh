@@ -331,6 +331,9 @@ class client_state {
 
 public:
     future<bool> check_has_permission(auth::command_desc) const;
+    // Like check_has_permission(), from cached permissions only. Returns
+    // nullopt if the permissions of the resource or of a parent aren't cached.
+    std::optional<bool> check_has_cached_permission(const auth::command_desc&) const;
     future<> ensure_has_permission(auth::command_desc) const;
     future<> maybe_update_per_service_level_params();
 
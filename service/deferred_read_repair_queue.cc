@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/range/algorithm/find_if.hpp>
+
+#include "service/deferred_read_repair_queue.hh"
+
+namespace service {
+
+void deferred_read_repair_queue::push(diffs_type diffs, size_t max_pending) {
+    for (auto& [token, diff] : diffs) {
+        auto m = boost::find_if(diff, [] (const auto& e) { return bool(e.second); });
+        if (m == diff.end()) {
+            continue;
+        }
+        const schema_ptr s = m->second->schema();
+        const auto key = m->second->decorated_key();
+        auto& pending = _pending[s->id()];
+        auto [it, added] = pending.try_emplace(token);
+        if (added) {
+            if (_partitions >= max_pending) {
+                pending.erase(it);
+                ++_stats.dropped;
+                continue;
+            }
+            it->second = std::move(diff);
+            ++_partitions;
+            ++_stats.queued;
+            continue;
+        }
+        // Coalesce with the repair of the partition which is already queued.
+        for (auto& [ep, mdiff] : diff) {
+            if (!mdiff) {
+                continue;
+            }
+            auto& queued = it->second[ep];
+            if (!queued) {
+                queued = std::move(mdiff);
+            } else if (queued->decorated_key().equal(*s, key)) {
+                queued->apply(std::move(*mdiff));
+            } else {
+                // Token collision, should not really happen.
+                ++_stats.dropped;
+            }
+        }
+    }
+    std::erase_if(_pending, [] (const auto& e) { return e.second.empty(); });
+}
+
+std::vector<deferred_read_repair_queue::partition_diffs> deferred_read_repair_queue::pop(size_t max_partitions) {
+    std::vector<partition_diffs> batch;
+    batch.reserve(std::min(max_partitions, _partitions));
+    while (batch.size() < max_partitions && !_pending.empty()) {
+        auto t = _pending.begin();
+        auto& partitions = t->second;
+        while (batch.size() < max_partitions && !partitions.empty()) {
+            batch.push_back(std::move(partitions.begin()->second));
+            partitions.erase(partitions.begin());
+        }
+        if (partitions.empty()) {
+            _pending.erase(t);
+        }
+    }
+    _partitions -= batch.size();
+    return batch;
+}
+
+void deferred_read_repair_queue::clear() {
+    _pending.clear();
+    _partitions = 0;
+}
+
+} // namespace service
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "dht/token.hh"
+#include "gms/inet_address.hh"
+#include "mutation.hh"
+#include "schema_fwd.hh"
+
+namespace service {
+
+// Read repair mutations waiting to be sent in the background, when the
+// deferred_read_repair option is set. Repairs are coalesced per table and
+// partition, and the number of queued partitions is bounded by the caller.
+class deferred_read_repair_queue {
+public:
+    using partition_diffs = std::unordered_map<gms::inet_address, std::optional<mutation>>;
+    using diffs_type = std::unordered_map<dht::token, partition_diffs>;
+    struct stats {
+        uint64_t queued = 0;
+        uint64_t dropped = 0;
+    };
+private:
+    std::unordered_map<table_id, diffs_type> _pending;
+    size_t _partitions = 0;
+    stats _stats;
+public:
+    // Queues the diffs of a read repair. Repairs of partitions which are
+    // already queued are merged into them, repairs of new partitions are
+    // dropped once max_pending partitions are queued.
+    void push(diffs_type diffs, size_t max_pending);
+    // Removes and returns up to max_partitions queued partition repairs.
+    std::vector<partition_diffs> pop(size_t max_partitions);
+    void clear();
+
+    size_t size() const noexcept { return _partitions; }
+    bool empty() const noexcept { return !_partitions; }
+    const stats& get_stats() const noexcept { return _stats; }
+
+    // The time it takes to send the given number of partitions at the given
+    // rate, in partitions per second.
+    static std::chrono::microseconds pacing_period(size_t partitions, unsigned rate) noexcept {
+        return std::chrono::microseconds(1'000'000 * partitions / std::max(rate, 1u));
+    }
+};
+
+} // namespace service
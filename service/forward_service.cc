@@ -43,6 +43,7 @@
 #include "cql3/cql_config.hh"
 #include "cql3/query_options.hh"
 #include "cql3/result_set.hh"
+#include "cql3/result_generator.hh"
 #include "cql3/selection/raw_selector.hh"
 #include "cql3/selection/selectable-expr.hh"
 #include "cql3/selection/selectable.hh"
@@ -61,7 +62,13 @@ class forward_aggregates {
 private:
     std::vector<::shared_ptr<db::functions::aggregate_function>> _funcs;
     std::vector<std::unique_ptr<db::functions::aggregate_function::aggregate>> _aggrs;
+    table_schema_version _schema_version;
+    // The number of grouping columns preceding the aggregates in the rows
+    // of grouped results.
+    std::optional<size_t> _group_by_size;
+    uint64_t _max_groups = std::numeric_limits<uint64_t>::max();
 
+    void finalize_grouped(query::forward_result& result);
 public:
     forward_aggregates(const query::forward_request& request);
     void merge(query::forward_result& result, query::forward_result&& other);
@@ -83,8 +90,13 @@ class forward_aggregates {
     }
 };
 
-forward_aggregates::forward_aggregates(const query::forward_request& request) {
+forward_aggregates::forward_aggregates(const query::forward_request& request)
+        : _schema_version(request.cmd.schema_version) {
     _funcs = get_functions(request);
+    if (request.is_grouped()) {
+        _group_by_size = request.group_by_column_names->size();
+        _max_groups = request.max_groups.value_or(_max_groups);
+    }
     std::vector<std::unique_ptr<db::functions::aggregate_function::aggregate>> aggrs;
 
     for (auto& func: _funcs) {
@@ -94,6 +106,19 @@ forward_aggregates::forward_aggregates(const query::forward_request& request) {
 }
 
 void forward_aggregates::merge(query::forward_result &result, query::forward_result&& other) {
+    if (_group_by_size) {
+        // Groups never span partitions, so they don't span results either:
+        // merging grouped results is just concatenating them. Once there
+        // are more groups than the coordinator takes, the rest is dropped.
+        if (!result.grouped_query_results) {
+            result.grouped_query_results.emplace();
+        }
+        if (other.grouped_query_results && result.grouped_query_results->size() <= _max_groups) {
+            std::move(other.grouped_query_results->begin(), other.grouped_query_results->end(),
+                    std::back_inserter(*result.grouped_query_results));
+        }
+        return;
+    }
     if (result.query_results.empty()) {
         result.query_results = std::move(other.query_results);
         return;
@@ -120,6 +145,10 @@ void forward_aggregates::merge(query::forward_result &result, query::forward_res
 }
 
 void forward_aggregates::finalize(query::forward_result &result) {
+    if (_group_by_size) {
+        finalize_grouped(result);
+        return;
+    }
     if (result.query_results.size() != _aggrs.size()) {
         on_internal_error(
             flogger,
@@ -136,6 +165,66 @@ void forward_aggregates::finalize(query::forward_result &result) {
     }
 }
 
+// Sorts the groups in ring order, in which they are returned by queries which
+// aren't forwarded, and computes the final values of their aggregates.
+void forward_aggregates::finalize_grouped(query::forward_result& result) {
+    if (!result.grouped_query_results) {
+        result.grouped_query_results.emplace();
+    }
+    auto& rows = *result.grouped_query_results;
+    if (rows.size() > _max_groups) {
+        // The coordinator aggregates the query itself.
+        return;
+    }
+    for (auto& row : rows) {
+        if (row.size() != *_group_by_size + _aggrs.size()) {
+            on_internal_error(flogger, format("forward_aggregates::finalize_grouped(): invalid row size {}, expected {} grouping columns and {} aggregates",
+                    row.size(), *_group_by_size, _aggrs.size()));
+        }
+    }
+
+    schema_ptr schema = local_schema_registry().get(_schema_version);
+    struct group {
+        dht::decorated_key dk;
+        clustering_key_prefix ck;
+        std::vector<bytes_opt>* row;
+    };
+    std::vector<group> groups;
+    groups.reserve(rows.size());
+    const auto pk_size = schema->partition_key_size();
+    for (auto& row : rows) {
+        std::vector<bytes> pk_values;
+        std::vector<bytes> ck_values;
+        for (size_t i = 0; i < *_group_by_size; i++) {
+            // Clustering columns of static rows are null.
+            if (!row[i]) {
+                break;
+            }
+            (i < pk_size ? pk_values : ck_values).push_back(*row[i]);
+        }
+        auto pk = partition_key::from_exploded(*schema, pk_values);
+        groups.push_back(group{dht::decorate_key(*schema, std::move(pk)), clustering_key_prefix::from_exploded(*schema, ck_values), &row});
+    }
+    clustering_key_prefix::tri_compare ck_cmp(*schema);
+    std::sort(groups.begin(), groups.end(), [&] (const group& a, const group& b) {
+        auto c = a.dk.tri_compare(*schema, b.dk);
+        return c < 0 || (c == 0 && ck_cmp(a.ck, b.ck) < 0);
+    });
+
+    std::vector<std::vector<bytes_opt>> finalized;
+    finalized.reserve(rows.size());
+    for (auto& g : groups) {
+        auto& row = *g.row;
+        for (size_t i = 0; i < _aggrs.size(); i++) {
+            auto& value = row[*_group_by_size + i];
+            _aggrs[i]->set_accumulator(value);
+            value = _aggrs[i]->compute(cql_serialization_format::internal());
+        }
+        finalized.push_back(std::move(row));
+    }
+    rows = std::move(finalized);
+}
+
 static std::vector<::shared_ptr<db::functions::aggregate_function>> get_functions(const query::forward_request& request) {
     
     schema_ptr schema = local_schema_registry().get(request.cmd.schema_version);
@@ -179,6 +268,113 @@ static std::vector<::shared_ptr<db::functions::aggregate_function>> get_function
     return aggrs;
 }
 
+// Aggregates the rows of each page column-wise: the values of the argument of
+// each aggregate are gathered into a batch, which is passed to the aggregate
+// at once instead of feeding every row through the selectors. Only requests
+// whose reductions take at most one non-collection column and don't need
+// a seastar thread are aggregated this way.
+class batch_aggregates {
+    struct aggregate_and_argument {
+        std::unique_ptr<db::functions::aggregate_function::aggregate> aggregate;
+        // Index of the argument in the selected columns, disengaged for countRows.
+        std::optional<size_t> argument;
+    };
+    std::vector<aggregate_and_argument> _aggrs;
+    std::vector<db::functions::argument_batch> _columns;
+    db::functions::argument_batch _rows;
+
+    class page_visitor {
+        std::vector<db::functions::argument_batch>& _columns;
+        size_t _column = 0;
+        uint64_t _row_count = 0;
+    public:
+        explicit page_visitor(std::vector<db::functions::argument_batch>& columns) : _columns(columns) {}
+
+        void start_row() {
+            _column = 0;
+            ++_row_count;
+        }
+        void accept_value(std::optional<query::result_bytes_view> value) {
+            auto& column = _columns[_column++];
+            if (value) {
+                column.push_back(*value);
+            } else {
+                column.push_null();
+            }
+        }
+        void end_row() {}
+
+        uint64_t row_count() const {
+            return _row_count;
+        }
+    };
+
+    explicit batch_aggregates(size_t column_count) : _columns(column_count) {}
+public:
+    static std::optional<batch_aggregates> make(const query::forward_request& request, const cql3::selection::selection& selection) {
+        if (request.is_grouped()) {
+            return std::nullopt;
+        }
+        auto& columns = selection.get_columns();
+        auto functions = get_functions(request);
+        batch_aggregates ret(columns.size());
+
+        for (size_t i = 0; i < request.reduction_types.size(); i++) {
+            if (request.reduction_types[i] == query::forward_request::reduction_type::count) {
+                // Matches the count(*) selector created by mock_selection().
+                auto func = cql3::functions::functions::find(db::functions::function_name::native_function("countRows"), {});
+                auto aggr = dynamic_pointer_cast<db::functions::aggregate_function>(func);
+                if (!aggr) {
+                    return std::nullopt;
+                }
+                ret._aggrs.push_back(aggregate_and_argument{aggr->new_aggregate(), std::nullopt});
+                continue;
+            }
+            if (!request.aggregation_infos || functions[i]->requires_thread()) {
+                return std::nullopt;
+            }
+            auto& column_names = request.aggregation_infos->at(i).column_names;
+            if (column_names.size() != 1) {
+                return std::nullopt;
+            }
+            auto it = std::find_if(columns.begin(), columns.end(), [&] (const column_definition* def) {
+                return def->name_as_text() == column_names.front();
+            });
+            if (it == columns.end() || (*it)->is_multi_cell()) {
+                return std::nullopt;
+            }
+            auto reducible = functions[i]->reducible_aggregate_function();
+            if (!reducible) {
+                return std::nullopt;
+            }
+            ret._aggrs.push_back(aggregate_and_argument{reducible->new_aggregate(), size_t(it - columns.begin())});
+        }
+        return ret;
+    }
+
+    void consume(const cql3::result_generator& page) {
+        for (auto& column : _columns) {
+            column.clear();
+        }
+        page_visitor visitor(_columns);
+        page.visit(visitor);
+
+        _rows.clear();
+        for (uint64_t i = 0; i < visitor.row_count(); i++) {
+            _rows.push_null();
+        }
+        for (auto& a : _aggrs) {
+            a.aggregate->add_input_batch(cql_serialization_format::latest(), a.argument ? _columns[*a.argument] : _rows);
+        }
+    }
+
+    std::vector<bytes_opt> compute() {
+        return boost::copy_range<std::vector<bytes_opt>>(_aggrs | boost::adaptors::transformed([] (aggregate_and_argument& a) {
+            return a.aggregate->compute(cql_serialization_format::latest());
+        }));
+    }
+};
+
 static const dht::token& end_token(const dht::partition_range& r) {
     static const dht::token max_token = dht::maximum_token();
     return r.end() ? r.end()->value().token() : max_token;
@@ -320,6 +516,15 @@ static shared_ptr<cql3::selection::selection> mock_selection(
         return make_shared<cql3::selection::raw_selector>(fc_expr, column_identifier);
     };
 
+    // Grouping columns are selected as is, ahead of the aggregates.
+    if (request.is_grouped()) {
+        for (auto& name : *request.group_by_column_names) {
+            // The names are the columns' text, which must be matched case-sensitively.
+            auto column = cql3::expr::unresolved_identifier{make_shared<cql3::column_identifier_raw>(name, true)};
+            raw_selectors.emplace_back(make_shared<cql3::selection::raw_selector>(std::move(column), nullptr));
+        }
+    }
+
     for (size_t i = 0; i < request.reduction_types.size(); i++) {
         auto info = (request.aggregation_infos) ? std::optional(request.aggregation_infos->at(i)) : std::nullopt;
         raw_selectors.emplace_back(mock_singular_selection(functions[i], request.reduction_types[i], info));
@@ -394,13 +599,28 @@ future<query::forward_result> forward_service::execute_on_this_shard(
         cql_serialization_format::latest()
     );
 
+    std::vector<size_t> group_by_cell_indices;
+    if (req.is_grouped()) {
+        for (auto& name : *req.group_by_column_names) {
+            group_by_cell_indices.push_back(selection->index_of(*schema->get_column_definition(to_bytes(name))));
+        }
+    }
+
+    auto batch_aggrs = batch_aggregates::make(req, *selection);
+    cql3::cql_stats cql_stats;
     auto rs_builder = cql3::selection::result_set_builder(
         *selection,
         now,
         cql_serialization_format::latest(),
-        std::vector<size_t>() // Represents empty GROUP BY indices.
+        std::move(group_by_cell_indices)
     );
 
+    // Stop reading once a grouped request has more groups than the
+    // coordinator takes, it is going to aggregate the query itself.
+    auto too_many_groups = [&] {
+        return req.max_groups && rs_builder.result_set_size() > *req.max_groups;
+    };
+
     // We serve up to 256 ranges at a time to avoid allocating a huge vector for ranges
     static constexpr size_t max_ranges = 256;
     dht::partition_range_vector ranges_owned_by_this_shard;
@@ -433,15 +653,52 @@ future<query::forward_result> forward_service::execute_on_this_shard(
 
         // Execute query.
         while (!pager->is_exhausted()) {
-            co_await pager->fetch_page(rs_builder, DEFAULT_INTERNAL_PAGING_SIZE, now, timeout);
+            if (batch_aggrs) {
+                auto page = co_await pager->fetch_page_generator(DEFAULT_INTERNAL_PAGING_SIZE, now, timeout, cql_stats);
+                batch_aggrs->consume(page);
+            } else {
+                co_await pager->fetch_page(rs_builder, DEFAULT_INTERNAL_PAGING_SIZE, now, timeout);
+                if (too_many_groups()) {
+                    break;
+                }
+            }
         }
 
         ranges_owned_by_this_shard.clear();
-    } while (current_range);
+    } while (current_range && !too_many_groups());
+
+    if (batch_aggrs) {
+        _stats.requests_aggregated_in_batches += 1;
+        query::forward_result res = { .query_results = batch_aggrs->compute() };
+        query::forward_result::printer res_printer{
+            .functions = get_functions(req),
+            .res = res
+        };
+        tracing::trace(tr_state, "On shard execution result is {}", res_printer);
+        co_return res;
+    }
 
     co_return co_await rs_builder.with_thread_if_needed([&req, &rs_builder, reductions = req.reduction_types, tr_state = std::move(tr_state)] {
         auto rs = rs_builder.build();
         auto& rows = rs->rows();
+        if (req.is_grouped()) {
+            const auto row_size = req.group_by_column_names->size() + reductions.size();
+            query::forward_result res = { .grouped_query_results = std::vector<std::vector<bytes_opt>>() };
+            for (auto& row : rows) {
+                // Aggregating no rows yields a single row with null grouping
+                // columns. Partition key columns are never null otherwise.
+                if (!row[0]) {
+                    continue;
+                }
+                if (row.size() != row_size) {
+                    flogger.error("grouped aggregation result column count does not match requested column count");
+                    throw std::runtime_error("grouped aggregation result column count does not match requested column count");
+                }
+                res.grouped_query_results->push_back(row);
+            }
+            tracing::trace(tr_state, "On shard execution result is {} groups", res.grouped_query_results->size());
+            return res;
+        }
         if (rows.size() != 1) {
             flogger.error("aggregation result row count != 1");
             throw std::runtime_error("aggregation result row count != 1");
@@ -589,6 +846,8 @@ void forward_service::register_metrics() {
              sm::description("how many forward requests were dispatched to local shards"), {}),
         sm::make_total_operations("requests_executed", _stats.requests_executed,
              sm::description("how many forward requests were executed"), {}),
+        sm::make_total_operations("requests_aggregated_in_batches", _stats.requests_aggregated_in_batches,
+             sm::description("how many executed forward requests were aggregated a page at a time, bypassing the selectors"), {}),
     });
 }
 
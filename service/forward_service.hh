@@ -124,6 +124,7 @@ class forward_service : public seastar::peering_sharded_service<forward_service>
         uint64_t requests_dispatched_to_other_nodes = 0;
         uint64_t requests_dispatched_to_own_shards = 0;
         uint64_t requests_executed = 0;
+        uint64_t requests_aggregated_in_batches = 0;
     } _stats;
     seastar::metrics::metric_groups _metrics;
 
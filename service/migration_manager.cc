@@ -123,7 +123,16 @@ void migration_manager::init_messaging_service()
 
         auto features = self._feat.cluster_schema_features();
         auto& proxy = self._storage_proxy.container();
-        auto cm = co_await db::schema_tables::convert_schema_to_mutations(proxy, features);
+        std::vector<canonical_mutation> cm;
+        // A group 0 follower whose schema is already identical to ours only needs the history,
+        // so don't build and ship the schema tables, which can be large with many tables.
+        const auto up_to_date = options && options->group0_snapshot_transfer
+                && options->known_schema_version == proxy.local().get_db().local().get_version();
+        if (up_to_date) {
+            mlogger.debug("migration request handler: schema of {} is up to date, sending group 0 history only", netw::messaging_service::get_source(cinfo));
+        } else {
+            cm = co_await db::schema_tables::convert_schema_to_mutations(proxy, features);
+        }
         if (options->group0_snapshot_transfer) {
             // if `group0_snapshot_transfer` is `true`, the sender must also understand canonical mutations
             // (`group0_snapshot_transfer` was added more recently).
@@ -75,6 +75,11 @@ class query_pager {
     paging_state::replicas_per_token_range _last_replicas;
     std::optional<db::read_repair_decision> _query_read_repair_decision;
     uint64_t _rows_fetched_for_last_partition = 0;
+    // Number of partitions of a multi-partition query read at once, 0 if unlimited.
+    size_t _partition_window = 0;
+    // The last partition of the window read for the current page, if the
+    // window left out some of the partitions.
+    std::optional<partition_key> _window_last_pkey;
     stats _stats;
 public:
     query_pager(service::storage_proxy& p, schema_ptr s, shared_ptr<const cql3::selection::selection> selection,
@@ -8,6 +8,8 @@
  * SPDX-License-Identifier: (AGPL-3.0-or-later and Apache-2.0)
  */
 
+#include <algorithm>
+
 #include "query_pagers.hh"
 #include "query_pager.hh"
 #include "cql3/selection/selection.hh"
@@ -19,6 +21,8 @@
 #include "utils/result_combinators.hh"
 #include "view_info.hh"
 #include "db/view/delete_ghost_rows_visitor.hh"
+#include "db/config.hh"
+#include "replica/database.hh"
 
 template<typename T = void>
 using result = service::pager::query_pager::result<T>;
@@ -177,6 +181,22 @@ future<result<service::storage_proxy::coordinator_query_result>> query_pager::do
             );
 
     auto ranges = _ranges;
+    // Multi-partition IN queries read all their remaining partitions for
+    // every page, and the page is sent only once all of them are read. Read
+    // at most a window of them, so the rows of the first partitions don't
+    // wait for the others. If the window doesn't fill the page, the next
+    // page continues after it.
+    _window_last_pkey.reset();
+    if (!_partition_window) {
+        _partition_window = _proxy->local_db().get_config().max_partitions_per_in_query_page();
+    }
+    if (_partition_window && ranges.size() > _partition_window && std::ranges::all_of(ranges, [] (const dht::partition_range& r) {
+            return r.is_singular() && r.start()->value().has_key();
+        })) {
+        ranges.resize(_partition_window);
+        _window_last_pkey = *ranges.back().start()->value().key();
+        qlogger.trace("Reading a window of {} partitions, up to {}", _partition_window, *_window_last_pkey);
+    }
     auto command = ::make_lw_shared<query::read_command>(*_cmd);
     return _proxy->query_result(_schema,
             std::move(command),
@@ -417,6 +437,19 @@ void query_pager::handle_result(
         }
     }
 
+    if (_exhausted && _max && _window_last_pkey) {
+        // All partitions of the window were read, and the page wasn't filled.
+        // Continue after the window, allowing the pager to read a wider one.
+        if (_last_pkey) {
+            update_slice(*_last_pkey);
+        }
+        _exhausted = false;
+        _last_pkey = std::exchange(_window_last_pkey, std::nullopt);
+        _last_pos = position_in_partition(position_in_partition::partition_start_tag_t());
+        _rows_fetched_for_last_partition = 0;
+        _partition_window *= 2;
+    }
+
     qlogger.debug("Fetched {} rows, max_remain={} {}", row_count, _max, _exhausted ? "(exh)" : "");
 
     if (_last_pkey) {
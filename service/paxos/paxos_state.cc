@@ -25,6 +25,7 @@ namespace service::paxos {
 logging::logger paxos_state::logger("paxos");
 thread_local paxos_state::key_lock_map paxos_state::_paxos_table_lock;
 thread_local paxos_state::key_lock_map paxos_state::_coordinator_lock;
+thread_local paxos_state::ballot_lease_map paxos_state::_ballot_leases;
 
 paxos_state::key_lock_map::semaphore& paxos_state::key_lock_map::get_semaphore_for_key(const dht::token& key) {
     return _locks.try_emplace(key, 1).first->second;
@@ -37,6 +38,49 @@ void paxos_state::key_lock_map::release_semaphore_for_key(const dht::token& key)
     }
 }
 
+std::optional<utils::UUID> paxos_state::ballot_lease_map::get(table_id table, const dht::token& key) const {
+    auto it = _leases.find(key);
+    if (it == _leases.end() || it->second.table != table || it->second.expiry <= clock_type::now()) {
+        return std::nullopt;
+    }
+    return it->second.ballot;
+}
+
+void paxos_state::ballot_lease_map::grant(table_id table, const dht::token& key, utils::UUID ballot, clock_type::time_point expiry) {
+    if (_leases.size() >= max_leases && !_leases.contains(key)) {
+        auto now = clock_type::now();
+        std::erase_if(_leases, [now] (const auto& e) { return e.second.expiry <= now; });
+        if (_leases.size() >= max_leases) {
+            return;
+        }
+    }
+    auto& l = _leases[key];
+    // Leases of concurrent rounds on the same key may be granted out of order.
+    if (l.table == table && l.ballot.timestamp() > ballot.timestamp() && l.expiry > clock_type::now()) {
+        return;
+    }
+    l = lease{table, ballot, expiry};
+}
+
+void paxos_state::ballot_lease_map::revoke(table_id table, const dht::token& key) {
+    auto it = _leases.find(key);
+    if (it != _leases.end() && it->second.table == table) {
+        _leases.erase(it);
+    }
+}
+
+std::optional<utils::UUID> paxos_state::get_ballot_lease(const schema& s, const dht::token& key) {
+    return _ballot_leases.get(s.id(), key);
+}
+
+void paxos_state::grant_ballot_lease(const schema& s, const dht::token& key, utils::UUID ballot, clock_type::time_point expiry) {
+    _ballot_leases.grant(s.id(), key, ballot, expiry);
+}
+
+void paxos_state::revoke_ballot_lease(const schema& s, const dht::token& key) {
+    _ballot_leases.revoke(s.id(), key);
+}
+
 future<paxos_state::guard> paxos_state::get_cas_lock(const dht::token& key, clock_type::time_point timeout) {
     guard m(_coordinator_lock, key, timeout);
     co_await m.lock();
@@ -123,15 +167,26 @@ future<prepare_response> paxos_state::prepare(storage_proxy& sp, tracing::trace_
 }
 
 future<bool> paxos_state::accept(storage_proxy& sp, tracing::trace_state_ptr tr_state, schema_ptr schema, dht::token token, const proposal& proposal,
-        clock_type::time_point timeout) {
+        clock_type::time_point timeout, std::optional<utils::UUID> leased_ballot) {
     return utils::get_local_injector().inject("paxos_accept_proposal_timeout", timeout,
-            [&sp, token = std::move(token), &proposal, schema, tr_state, timeout] {
+            [&sp, token = std::move(token), &proposal, schema, tr_state, timeout, leased_ballot] {
         utils::latency_counter lc;
         lc.start();
-        return with_locked_key(token, timeout, [&proposal, schema, tr_state, timeout] () mutable {
+        return with_locked_key(token, timeout, [&proposal, schema, tr_state, timeout, leased_ballot] () mutable {
             auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(proposal.ballot);
             auto f = db::system_keyspace::load_paxos_state(proposal.update.key(), schema, gc_clock::time_point(now_in_sec), timeout);
-            return f.then([&proposal, tr_state, schema, timeout] (paxos_state state) {
+            return f.then([&proposal, tr_state, schema, timeout, leased_ballot] (paxos_state state) {
+                // A proposal which skipped prepare can only be accepted if nothing happened to the key since
+                // the round which was decided with the leased ballot. Any prepare by another coordinator
+                // changes the promised ballot, so a quorum of replicas which pass the check guarantees
+                // that any later prepare will see this proposal as in progress and complete it.
+                // The lease is granted only once every participant learned the decision, so there is
+                // no need to check the most recent commit, which prune deletes anyway.
+                if (leased_ballot && state._promised_ballot != *leased_ballot) {
+                    logger.debug("Rejecting proposal {} for lease {} because promise is now {}", proposal, *leased_ballot, state._promised_ballot);
+                    tracing::trace(tr_state, "Rejecting proposal {} for lease {} because promise is now {}", proposal, *leased_ballot, state._promised_ballot);
+                    return make_ready_future<bool>(false);
+                }
                 // Accept the proposal if we promised to accept it or the proposal is newer than the one we promised.
                 // Otherwise the proposal was cutoff by another Paxos proposer and has to be rejected.
                 if (proposal.ballot == state._promised_ballot || proposal.ballot.timestamp() > state._promised_ballot.timestamp()) {
@@ -8,6 +8,7 @@
  */
 #pragma once
 #include "service/paxos/proposal.hh"
+#include "schema_fwd.hh"
 #include "log.hh"
 #include "digest_algorithm.hh"
 #include "db/timeout_clock.hh"
@@ -63,6 +64,29 @@ class paxos_state {
     // eachother.
     static thread_local key_lock_map _coordinator_lock;
 
+    // Ballots which this shard, as a coordinator, recently got learned by all
+    // the participants of a round, and nobody else has prepared since as far
+    // as the coordinator knows. A lease only saves a wasted round trip, it is
+    // not required for correctness: the replicas check on accept that they
+    // are still promised to the leased ballot (see accept()).
+    class ballot_lease_map {
+        struct lease {
+            table_id table;
+            utils::UUID ballot;
+            clock_type::time_point expiry;
+        };
+        // Upper bound on the number of leases tracked per shard.
+        static constexpr size_t max_leases = 10000;
+
+        std::unordered_map<dht::token, lease> _leases;
+    public:
+        std::optional<utils::UUID> get(table_id table, const dht::token& key) const;
+        void grant(table_id table, const dht::token& key, utils::UUID ballot, clock_type::time_point expiry);
+        void revoke(table_id table, const dht::token& key);
+    };
+
+    static thread_local ballot_lease_map _ballot_leases;
+
 
     // protects acess to system.paxos
     template<typename Func>
@@ -102,6 +126,11 @@ class paxos_state {
 
     static future<guard> get_cas_lock(const dht::token& key, clock_type::time_point timeout);
 
+    // Coordinator side ballot leases, local to the shard which owns the key.
+    static std::optional<utils::UUID> get_ballot_lease(const schema& s, const dht::token& key);
+    static void grant_ballot_lease(const schema& s, const dht::token& key, utils::UUID ballot, clock_type::time_point expiry);
+    static void revoke_ballot_lease(const schema& s, const dht::token& key);
+
     static logging::logger logger;
 
     paxos_state() {}
@@ -115,8 +144,12 @@ class paxos_state {
             const query::read_command& cmd, const partition_key& key, utils::UUID ballot,
             bool only_digest, query::digest_algorithm da, clock_type::time_point timeout);
     // Replica RPC endpoint for Paxos "accept" phase.
+    //
+    // If leased_ballot is engaged, the proposal is sent without a prepare of its own, and is
+    // accepted only if the replica is still promised to the leased ballot, i.e. no other
+    // coordinator prepared the key since.
     static future<bool> accept(storage_proxy& sp, tracing::trace_state_ptr tr_state, schema_ptr schema, dht::token token, const proposal& proposal,
-            clock_type::time_point timeout);
+            clock_type::time_point timeout, std::optional<utils::UUID> leased_ballot = std::nullopt);
     // Replica RPC endpoint for Paxos "learn".
     static future<> learn(storage_proxy& sp, schema_ptr schema, proposal decision, clock_type::time_point timeout, tracing::trace_state_ptr tr_state);
     // Replica RPC endpoint for pruning Paxos table
@@ -130,7 +130,11 @@ future<> group0_state_machine::transfer_snapshot(gms::inet_address from, raft::s
     slogger.trace("transfer snapshot from {} index {} snp id {}", from, snp.idx, snp.id);
     netw::messaging_service::msg_addr addr{from, 0};
     // (Ab)use MIGRATION_REQUEST to also transfer group0 history table mutation besides schema tables mutations.
-    auto [_, cm] = co_await _mm._messaging.send_migration_request(addr, netw::schema_pull_options { .group0_snapshot_transfer = true });
+    // Send our schema version, so that the remote can skip the schema tables if we already have them.
+    auto [_, cm] = co_await _mm._messaging.send_migration_request(addr, netw::schema_pull_options {
+        .group0_snapshot_transfer = true,
+        .known_schema_version = _sp.get_db().local().get_version(),
+    });
     if (!cm) {
         // If we're running this code then remote supports Raft group 0, so it should also support canonical mutations
         // (which were introduced a long time ago).
@@ -142,7 +146,11 @@ future<> group0_state_machine::transfer_snapshot(gms::inet_address from, raft::s
 
     auto read_apply_mutex_holder = co_await get_units(_client._read_apply_mutex, 1);
 
-    co_await _mm.merge_schema_from(addr, std::move(*cm));
+    if (cm->empty()) {
+        slogger.trace("transfer snapshot from {}: schema is up to date, applying group 0 history only", from);
+    } else {
+        co_await _mm.merge_schema_from(addr, std::move(*cm));
+    }
 
     co_await _sp.mutate_locally({std::move(history_mut)}, nullptr);
 }
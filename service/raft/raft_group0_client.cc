@@ -219,6 +219,14 @@ future<> raft_group0_client::add_entry_unguarded(group0_command group0_cmd, seas
     }
 }
 
+future<> raft_group0_client::read_barrier_unguarded(seastar::abort_source* as) {
+    if (this_shard_id() != 0) {
+        on_internal_error(logger, "read_barrier_unguarded: must run on shard 0");
+    }
+
+    return _raft_gr.group0().read_barrier(as);
+}
+
 static utils::UUID generate_group0_state_id(utils::UUID prev_state_id) {
     auto ts = api::new_timestamp();
     if (prev_state_id != utils::UUID{}) {
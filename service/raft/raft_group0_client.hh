@@ -105,6 +105,14 @@ class raft_group0_client {
 
     future<> add_entry_unguarded(group0_command group0_cmd, seastar::abort_source* as = nullptr);
 
+    // Performs a Raft read barrier on group 0: once it resolves, everything committed to group 0
+    // before the call is applied on this node. Unlike `start_operation`, it doesn't serialize with
+    // other operations, so concurrent readers don't wait for each other; the leader answers
+    // concurrent barriers with one round of read quorum messages.
+    //
+    // Call only on shard 0.
+    future<> read_barrier_unguarded(seastar::abort_source* as = nullptr);
+
     // Ensures that all previously finished operations on group 0 are visible on this node;
     // in particular, performs a Raft read barrier on group 0.
     //
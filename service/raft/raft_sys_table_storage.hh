@@ -22,12 +22,6 @@ namespace cql3 {
 
 class query_processor;
 
-namespace statements {
-
-class modification_statement;
-
-} // namespace cql3::statements
-
 } // namespace cql3
 
 namespace service {
@@ -38,9 +32,6 @@ namespace service {
 class raft_sys_table_storage : public raft::persistence {
     raft::group_id _group_id;
     raft::server_id _server_id;
-    // Prepared statement instance used for construction of batch statements on
-    // `store_log_entries` calls.
-    shared_ptr<cql3::statements::modification_statement> _store_entry_stmt;
     cql3::query_processor& _qp;
     service::query_state _dummy_query_state;
     // The future of the currently executing (or already finished) write operation.
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "gms/inet_address.hh"
+
+namespace service {
+
+// The latency of the read requests this shard sent to each replica, and the
+// number of them still in flight, for ranking replicas the way C3 does: a
+// replica's score grows with its response time and, steeply, with the
+// requests already queued on it, so a replica with a slow disk or a stalled
+// process is moved to the back of the list soon after it starts lagging.
+//
+// Only this shard's requests are seen, which is what matters for the
+// requests this shard is about to send.
+class replica_latency_tracker {
+public:
+    using clock = seastar::lowres_clock;
+    // The weight of a new sample in the moving average.
+    static constexpr double alpha = 0.25;
+    // Averages not updated for that long are no longer trusted, so that a
+    // replica which was slow once can be tried again.
+    static constexpr std::chrono::seconds max_sample_age{2};
+private:
+    struct replica_stats {
+        double latency_us = 0;
+        unsigned in_flight = 0;
+        clock::time_point last_update;
+    };
+    std::unordered_map<gms::inet_address, replica_stats> _replicas;
+    // Replicas the failure detector suspects to be down, or too slow to
+    // answer its pings.
+    std::unordered_set<gms::inet_address> _suspected;
+public:
+    void set_suspected(gms::inet_address ep, bool suspected) {
+        if (suspected) {
+            _suspected.insert(ep);
+        } else {
+            _suspected.erase(ep);
+        }
+    }
+
+    bool is_suspected(gms::inet_address ep) const {
+        return _suspected.contains(ep);
+    }
+
+    bool has_suspected() const {
+        return !_suspected.empty();
+    }
+
+    void request_started(gms::inet_address ep) {
+        ++_replicas[ep].in_flight;
+    }
+
+    void request_finished(gms::inet_address ep, std::chrono::microseconds latency, clock::time_point now = clock::now()) {
+        auto& s = _replicas[ep];
+        if (s.in_flight) {
+            --s.in_flight;
+        }
+        if (s.last_update + max_sample_age < now) {
+            s.latency_us = latency.count();
+        } else {
+            s.latency_us += alpha * (latency.count() - s.latency_us);
+        }
+        s.last_update = now;
+    }
+
+    // The average latency of the replica, in microseconds, if it has recent
+    // samples.
+    std::optional<double> latency(gms::inet_address ep, clock::time_point now = clock::now()) const {
+        auto it = _replicas.find(ep);
+        if (it == _replicas.end() || it->second.last_update + max_sample_age < now) {
+            return std::nullopt;
+        }
+        return it->second.latency_us;
+    }
+
+    // The expected wait for a reply of the replica, in microseconds.
+    // Replicas without recent samples are assumed to have the given latency.
+    // Their requests in flight still count, so only a few reads at a time
+    // probe such a replica, instead of all of them until its first reply
+    // comes back. Suspected replicas come last.
+    double score(gms::inet_address ep, double unsampled_latency_us, clock::time_point now = clock::now()) const {
+        if (is_suspected(ep)) {
+            return std::numeric_limits<double>::infinity();
+        }
+        auto it = _replicas.find(ep);
+        unsigned in_flight = it != _replicas.end() ? it->second.in_flight : 0;
+        double queue = 1 + in_flight;
+        return latency(ep, now).value_or(unsampled_latency_us) * queue * queue * queue;
+    }
+
+    // Orders the replicas in [begin, end) from the best score to the worst.
+    // Replicas without recent samples are assumed to be as fast as the
+    // average of the others, so they are neither avoided nor flooded.
+    // Replicas with equal scores keep their order.
+    template <typename Iterator>
+    void sort_by_score(Iterator begin, Iterator end, clock::time_point now = clock::now()) const {
+        double sum = 0;
+        unsigned sampled = 0;
+        for (auto it = begin; it != end; ++it) {
+            if (auto l = latency(*it, now)) {
+                sum += *l;
+                ++sampled;
+            }
+        }
+        // Without samples, only the requests in flight tell replicas apart.
+        double unsampled_latency_us = sampled ? sum / sampled : 1;
+        std::stable_sort(begin, end, [this, unsampled_latency_us, now] (gms::inet_address a, gms::inet_address b) {
+            return score(a, unsampled_latency_us, now) < score(b, unsampled_latency_us, now);
+        });
+    }
+};
+
+// Limits speculative reads to a fraction of all reads: every read deposits
+// that fraction of a token, and every speculative read withdraws a whole
+// one. Up to max_tokens can be saved, to let a short burst of speculation
+// through while a replica gets slow.
+class retry_budget {
+public:
+    static constexpr double max_tokens = 10;
+private:
+    double _tokens = max_tokens;
+public:
+    void deposit(double ratio) noexcept {
+        _tokens = std::min(max_tokens, _tokens + ratio);
+    }
+
+    bool try_withdraw() noexcept {
+        if (_tokens < 1) {
+            return false;
+        }
+        _tokens -= 1;
+        return true;
+    }
+};
+
+} // namespace service
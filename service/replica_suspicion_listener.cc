@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+
+#include "service/replica_suspicion_listener.hh"
+#include "service/storage_proxy.hh"
+#include "log.hh"
+
+namespace service {
+
+static logging::logger rsllog("replica_suspicion");
+
+future<> replica_suspicion_listener::start(direct_failure_detector::failure_detector& fd) {
+    // The failure detector pings every 100ms. Even on a quiet, fast network,
+    // give a node three ping periods before suspecting it, and never more
+    // than the second Raft allows.
+    using duration = direct_fd_clock::base::duration;
+    _subscription.emplace(co_await fd.register_listener(*this, direct_failure_detector::adaptive_threshold{
+        .min = duration{std::chrono::milliseconds{300}}.count(),
+        .max = duration{std::chrono::seconds{1}}.count(),
+        .false_positive_rate = 1e-4,
+    }));
+}
+
+future<> replica_suspicion_listener::stop() {
+    _subscription.reset();
+    return make_ready_future<>();
+}
+
+future<> replica_suspicion_listener::mark_alive(direct_failure_detector::pinger::endpoint_id id) {
+    auto addr = co_await _pinger.get_address(id);
+    rsllog.debug("replica {} is no longer suspected", addr);
+    _proxy.set_replica_suspected(addr, false);
+}
+
+future<> replica_suspicion_listener::mark_dead(direct_failure_detector::pinger::endpoint_id id) {
+    auto addr = co_await _pinger.get_address(id);
+    rsllog.debug("replica {} is suspected to be down", addr);
+    _proxy.set_replica_suspected(addr, true);
+}
+
+} // namespace service
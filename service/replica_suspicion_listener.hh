@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <seastar/core/sharded.hh>
+
+#include "direct_failure_detector/failure_detector.hh"
+#include "gms/gossiper.hh"
+
+namespace service {
+
+class storage_proxy;
+
+// Tells storage_proxy which replicas the direct failure detector suspects,
+// with a threshold that adapts to each node's ping round trips, so that
+// reads steer away from a dead or stalled node well before gossip convicts it.
+class replica_suspicion_listener : public direct_failure_detector::listener {
+    gms::gossiper::direct_fd_pinger& _pinger;
+    storage_proxy& _proxy;
+    std::optional<direct_failure_detector::subscription> _subscription;
+public:
+    replica_suspicion_listener(gms::gossiper::direct_fd_pinger& pinger, storage_proxy& proxy)
+        : _pinger(pinger), _proxy(proxy) {}
+
+    // Must be called before the failure detector gets its endpoints.
+    future<> start(direct_failure_detector::failure_detector& fd);
+    future<> stop();
+
+    future<> mark_alive(direct_failure_detector::pinger::endpoint_id id) override;
+    future<> mark_dead(direct_failure_detector::pinger::endpoint_id id) override;
+};
+
+} // namespace service
@@ -93,6 +93,7 @@
 #include "utils/result_try.hh"
 #include "utils/error_injection.hh"
 #include "utils/exceptions.hh"
+#include "utils/timer_wheel.hh"
 #include "replica/exceptions.hh"
 #include "db/operation_type.hh"
 
@@ -306,9 +307,9 @@ class storage_proxy::remote {
 
     future<bool> send_paxos_accept(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
-            const service::paxos::proposal& proposal) {
+            const service::paxos::proposal& proposal, std::optional<utils::UUID> leased_ballot) {
         tracing::trace(tr_state, "accept_proposal: send accept {} to {}", proposal, addr.addr);
-        return ser::storage_proxy_rpc_verbs::send_paxos_accept(&_ms, std::move(addr), timeout, proposal, tracing::make_trace_info(tr_state));
+        return ser::storage_proxy_rpc_verbs::send_paxos_accept(&_ms, std::move(addr), timeout, proposal, tracing::make_trace_info(tr_state), leased_ballot);
     }
 
     future<> send_paxos_learn(
@@ -727,7 +728,7 @@ class storage_proxy::remote {
 
     future<bool> handle_paxos_accept(
             const rpc::client_info& cinfo, rpc::opt_time_point timeout,
-            paxos::proposal proposal, std::optional<tracing::trace_info> trace_info) {
+            paxos::proposal proposal, std::optional<tracing::trace_info> trace_info, rpc::optional<std::optional<utils::UUID>> leased_ballot_opt) {
         auto src_addr = netw::messaging_service::get_source(cinfo);
         auto src_ip = src_addr.addr;
         tracing::trace_state_ptr tr_state;
@@ -737,15 +738,16 @@ class storage_proxy::remote {
             tracing::trace(tr_state, "paxos_accept: message received from /{} ballot {}", src_ip, proposal);
         }
 
+        auto leased_ballot = leased_ballot_opt ? std::move(*leased_ballot_opt) : std::nullopt;
         auto f = get_schema_for_read(proposal.update.schema_version(), src_addr).then([&sp = _sp, tr_state = std::move(tr_state),
-                                                              proposal = std::move(proposal), timeout] (schema_ptr schema) mutable {
+                                                              proposal = std::move(proposal), timeout, leased_ballot] (schema_ptr schema) mutable {
             dht::token token = proposal.update.decorated_key(*schema).token();
             unsigned shard = dht::shard_of(*schema, token);
             bool local = shard == this_shard_id();
             sp.get_stats().replica_cross_shard_ops += !local;
             return sp.container().invoke_on(shard, sp._write_smp_service_group, [gs = global_schema_ptr(schema), gt = tracing::global_trace_state_ptr(std::move(tr_state)),
-                                     local, proposal = std::move(proposal), timeout, token] (storage_proxy& sp) {
-                return paxos::paxos_state::accept(sp, gt, gs, token, proposal, *timeout);
+                                     local, proposal = std::move(proposal), timeout, token, leased_ballot] (storage_proxy& sp) {
+                return paxos::paxos_state::accept(sp, gt, gs, token, proposal, *timeout, leased_ballot);
             });
         });
 
@@ -865,8 +867,15 @@ static result<db::per_partition_rate_limit::info> choose_rate_limit_info(
         }
     }
 
-    // The coordinator is not a replica. The decision whether to accept
-    // or reject is left for replicas.
+    // The coordinator is not a replica. Reject early if replicas have been
+    // rejecting operations on this partition, otherwise the decision whether
+    // to accept or reject is left for replicas.
+    auto& cf = db.find_column_family(s);
+    if (db.check_replica_rate_limit_feedback(cf, token, enforce_info, op_type) == db::rate_limiter::can_proceed::no) {
+        slogger.trace("Per-partition rate limiting: coordinator rejected on replica feedback");
+        tracing::trace(tr_state, "Per-partition rate limiting: coordinator rejected on replica feedback");
+        return coordinator_exception_container(exceptions::rate_limit_exception(s->ks_name(), s->cf_name(), op_type, true));
+    }
     slogger.trace("Per-partition rate limiting: replicas will decide");
     tracing::trace(tr_state, "Per-partition rate limiting: replicas will decide");
     return enforce_info;
@@ -1065,7 +1074,7 @@ class cas_mutation : public mutation_holder {
         // The handler will be set for "learn", but not for PAXOS repair
         // since repair may not include all replicas
         if (_handler) {
-            if (_handler->learned(ep)) {
+            if (_handler->learned(ep, _proposal->ballot)) {
                 // It's OK to start PRUNE while LEARN is still in progress: LEARN
                 // doesn't read any data from system.paxos, and PRUNE tombstone
                 // will cover LEARNed value even if it arrives out of order.
@@ -1102,9 +1111,12 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
     size_t _total_endpoints = 0;
     storage_proxy::write_stats& _stats;
     lw_shared_ptr<cdc::operation_result_tracker> _cdc_operation_result_tracker;
-    timer<storage_proxy::clock_type> _expire_timer;
+    utils::coarse_timer _expire_timer;
     service_permit _permit; // holds admission permit until operation completes
     db::per_partition_rate_limit::info _rate_limit_info;
+    // Set when replicas decide whether to rate limit the write, so that the
+    // coordinator can learn about their rejections.
+    std::optional<dht::token> _rate_limited_token;
 
 protected:
     virtual bool waited_for(gms::inet_address from) = 0;
@@ -1153,6 +1165,9 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
                     _ready.set_exception(mutation_write_failure_exception(*_message, _cl, _cl_acks, _failed, _total_block_for, _type));
                 }
             } else if (_error == error::RATE_LIMIT) {
+                if (_rate_limited_token) {
+                    _proxy->local_db().on_rejected_by_replicas(*get_schema(), *_rate_limited_token, db::operation_type::write);
+                }
                 _ready.set_value(exceptions::rate_limit_exception(get_schema()->ks_name(), get_schema()->cf_name(), db::operation_type::write, false));
             }
             if (_cdc_operation_result_tracker) {
@@ -1168,6 +1183,10 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
         _cdc_operation_result_tracker = std::move(tracker);
     }
 
+    void set_rate_limited_token(dht::token token) {
+        _rate_limited_token = std::move(token);
+    }
+
     // While delayed, a request is not throttled.
     void unthrottle() {
         _stats.background_writes++;
@@ -1533,6 +1552,18 @@ static future<> sleep_approx_50ms() {
     return seastar::sleep(std::chrono::milliseconds(dist(re)));
 }
 
+utils::UUID paxos_response_handler::new_ballot(client_state& cs, api::timestamp_type min_timestamp_micros_to_use) {
+    // We want a timestamp that is guaranteed to be unique for that node (so that the ballot is
+    // globally unique), and not smaller than min_timestamp_micros_to_use. We also don't want to
+    // use a timestamp that is older than the last one assigned by ClientState or operations may
+    // appear out-of-order (#7801).
+    api::timestamp_type ballot_micros = cs.get_timestamp_for_paxos(min_timestamp_micros_to_use);
+    // Note that ballotMicros is not guaranteed to be unique if two proposal are being handled
+    // concurrently by the same coordinator. But we still need ballots to be unique for each
+    // proposal so we have to use getRandomTimeUUIDFromMicros.
+    return utils::UUID_gen::get_random_time_UUID_from_micros(std::chrono::microseconds{ballot_micros});
+}
+
 /**
  * Begin a Paxos session by sending a prepare request and completing any in-progress requests seen in the replies.
  *
@@ -1555,17 +1586,10 @@ paxos_response_handler::begin_and_repair_paxos(client_state& cs, unsigned& conte
             );
         }
 
-        // We want a timestamp that is guaranteed to be unique for that node (so that the ballot is
-        // globally unique), but if we've got a prepare rejected already we also want to make sure
-        // we pick a timestamp that has a chance to be promised, i.e. one that is greater that the
-        // most recently known in progress (#5667). Lastly, we don't want to use a timestamp that is
-        // older than the last one assigned by ClientState or operations may appear out-of-order
-        // (#7801).
-        api::timestamp_type ballot_micros = cs.get_timestamp_for_paxos(min_timestamp_micros_to_use);
-        // Note that ballotMicros is not guaranteed to be unique if two proposal are being handled
-        // concurrently by the same coordinator. But we still need ballots to be unique for each
-        // proposal so we have to use getRandomTimeUUIDFromMicros.
-        utils::UUID ballot = utils::UUID_gen::get_random_time_UUID_from_micros(std::chrono::microseconds{ballot_micros});
+        // If we've got a prepare rejected already we want to make sure we pick a timestamp
+        // that has a chance to be promised, i.e. one that is greater that the most recently
+        // known in progress (#5667).
+        utils::UUID ballot = new_ballot(cs, min_timestamp_micros_to_use);
 
         paxos::paxos_state::logger.debug("CAS[{}] Preparing {}", _id, ballot);
         tracing::trace(tr_state, "Preparing {}", ballot);
@@ -1811,7 +1835,8 @@ future<paxos::prepare_summary> paxos_response_handler::prepare_ballot(utils::UUI
 }
 
 // This function implements accept stage of the Paxos protocol.
-future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted) {
+future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted,
+        std::optional<utils::UUID> leased_ballot) {
     struct {
         // the promise can be set before all replies are received at which point
         // the optional will be disengaged so further replies are ignored
@@ -1842,19 +1867,19 @@ future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::propos
     auto f = request_tracker.p->get_future();
 
     // We may continue collecting propose responses in the background after the reply is ready
-    (void)do_with(std::move(request_tracker), shared_from_this(), [this, timeout_if_partially_accepted, proposal = std::move(proposal)]
+    (void)do_with(std::move(request_tracker), shared_from_this(), [this, timeout_if_partially_accepted, proposal = std::move(proposal), leased_ballot]
                            (auto& request_tracker, shared_ptr<paxos_response_handler>& prh) -> future<> {
         paxos::paxos_state::logger.trace("CAS[{}] accept_proposal: sending commit {} to {}", _id, *proposal, _live_endpoints);
-        auto handle_one_msg = [this, &request_tracker, timeout_if_partially_accepted, proposal = std::move(proposal)] (gms::inet_address peer) mutable -> future<> {
+        auto handle_one_msg = [this, &request_tracker, timeout_if_partially_accepted, proposal = std::move(proposal), leased_ballot] (gms::inet_address peer) mutable -> future<> {
             bool is_timeout = false;
             std::optional<bool> accepted;
 
             try {
                 if (fbu::is_me(peer)) {
                     tracing::trace(tr_state, "accept_proposal: accept {} locally", *proposal);
-                    accepted = co_await paxos::paxos_state::accept(*_proxy, tr_state, _schema, proposal->update.decorated_key(*_schema).token(), *proposal, _timeout);
+                    accepted = co_await paxos::paxos_state::accept(*_proxy, tr_state, _schema, proposal->update.decorated_key(*_schema).token(), *proposal, _timeout, leased_ballot);
                 } else {
-                    accepted = co_await _proxy->remote().send_paxos_accept(netw::msg_addr(peer), _timeout, tr_state, *proposal);
+                    accepted = co_await _proxy->remote().send_paxos_accept(netw::msg_addr(peer), _timeout, tr_state, *proposal, leased_ballot);
                 }
             } catch(...) {
                 if (request_tracker.p) {
@@ -1959,6 +1984,8 @@ std::ostream& operator<<(std::ostream& os, const paxos_response_handler& h) {
 future<> paxos_response_handler::learn_decision(lw_shared_ptr<paxos::proposal> decision, bool allow_hints) {
     tracing::trace(tr_state, "learn_decision: committing {} with cl={}", *decision, _cl_for_learn);
     paxos::paxos_state::logger.trace("CAS[{}] learn_decision: committing {} with cl={}", _id, *decision, _cl_for_learn);
+    _lease_ballot = decision->ballot;
+    _lease_learned = 0;
     // FIXME: allow_hints is ignored. Consider if we should follow it and remove if not.
     // Right now we do not store hints for when committing decisions.
 
@@ -2034,16 +2061,36 @@ void paxos_response_handler::prune(utils::UUID ballot) {
     });
 }
 
-bool paxos_response_handler::learned(gms::inet_address ep) {
-    if (_learned < _required_participants) {
-        if (boost::range::find(_live_endpoints, ep) != _live_endpoints.end()) {
-            _learned++;
-            return _learned == _required_participants;
+bool paxos_response_handler::learned(gms::inet_address ep, const utils::UUID& ballot) {
+    if (boost::range::find(_live_endpoints, ep) == _live_endpoints.end()) {
+        return false;
+    }
+    if (ballot == _lease_ballot && ++_lease_learned == _live_endpoints.size()) {
+        // Every participant learned the decision, so until somebody prepares the key again
+        // the next proposal from this coordinator can go straight to the accept phase.
+        if (auto lease_ms = _proxy->get_db().local().get_config().cas_ballot_lease_in_ms(); lease_ms && _proxy->features().lwt_ballot_lease) {
+            paxos::paxos_state::grant_ballot_lease(*_schema, _key.token(), ballot,
+                    storage_proxy::clock_type::now() + std::chrono::milliseconds(lease_ms));
         }
     }
+    if (_learned < _required_participants) {
+        _learned++;
+        return _learned == _required_participants;
+    }
     return false;
 }
 
+std::optional<utils::UUID> paxos_response_handler::get_ballot_lease() const {
+    if (!_proxy->get_db().local().get_config().cas_ballot_lease_in_ms() || !_proxy->features().lwt_ballot_lease) {
+        return std::nullopt;
+    }
+    return paxos::paxos_state::get_ballot_lease(*_schema, _key.token());
+}
+
+void paxos_response_handler::revoke_ballot_lease() const {
+    paxos::paxos_state::revoke_ballot_lease(*_schema, _key.token());
+}
+
 static inet_address_vector_replica_set
 replica_ids_to_endpoints(const locator::token_metadata& tm, const std::vector<locator::host_id>& replica_ids) {
     inet_address_vector_replica_set endpoints;
@@ -2124,8 +2171,11 @@ void storage_proxy::remove_response_handler(storage_proxy::response_id_type id)
 }
 
 void storage_proxy::remove_response_handler_entry(response_handlers_map::iterator entry) {
-    entry->second->on_released();
-    _response_handlers.erase(std::move(entry));
+    auto h = std::move(entry->second);
+    h->on_released();
+    // The destructor of the handler may look up other handlers, so
+    // it must not run in the middle of the erase.
+    _response_handlers.erase(entry);
 }
 
 void storage_proxy::got_response(storage_proxy::response_id_type id, gms::inet_address from, std::optional<db::view::update_backlog> backlog) {
@@ -2384,6 +2434,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of speculative data read requests that were sent"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("speculative_reads_over_budget", speculative_reads_over_budget,
+                       sm::description("number of speculative read requests that were not sent because the speculative retry budget was spent"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_summary("cas_read_latency_summary", sm::description("CAS read latency summary"), [this] {return to_metrics_summary(cas_read.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
         sm::make_summary("cas_write_latency_summary", sm::description("CAS write latency summary"), [this] {return to_metrics_summary(cas_write.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
 
@@ -2432,6 +2486,18 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("CAS read rounds issued only if previous value is missing on some replica"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("cas_prepare_skipped", cas_prepare_skipped,
+                       sm::description("CAS proposals sent without a prepare round, using a ballot leased by an earlier round"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("cas_prepare_skip_failed", cas_prepare_skip_failed,
+                       sm::description("CAS proposals sent without a prepare round which were rejected because the ballot lease was lost"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("cas_background_learn", cas_background_learn,
+                       sm::description("CAS decisions learned in the background, because nobody waits for them to be applied"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_histogram("cas_read_contention", sm::description("how many contended reads were encountered"),
                        {storage_proxy_stats::current_scheduling_group_label()},
                        [this]{ return cas_read_contention.get_histogram(1, 8);}).set_skip_when_empty(),
@@ -2579,6 +2645,7 @@ storage_proxy::storage_proxy(distributed<replica::database>& db, gms::gossiper&
     , _write_smp_service_group(cfg.write_smp_service_group)
     , _hints_write_smp_service_group(cfg.hints_write_smp_service_group)
     , _write_ack_smp_service_group(cfg.write_ack_smp_service_group)
+    , _read_batcher(_read_smp_service_group)
     , _next_response_id(std::chrono::system_clock::now().time_since_epoch()/1ms)
     , _hints_resource_manager(cfg.available_memory / 10, _db.local().get_config().max_hinted_handoff_concurrency)
     , _hints_manager(_db.local().get_config().hints_directory(), cfg.hinted_handoff_enabled, _db.local().get_config().max_hint_window_in_ms(), _hints_resource_manager, _db)
@@ -2595,6 +2662,17 @@ storage_proxy::storage_proxy(distributed<replica::database>& db, gms::gossiper&
     _metrics.add_group(storage_proxy_stats::COORDINATOR_STATS_CATEGORY, {
         sm::make_queue_length("current_throttled_writes", [this] { return _throttled_writes.size(); },
                        sm::description("number of currently throttled write requests")),
+        sm::make_counter("cross_shard_read_calls", [this] { return _read_batcher.get_stats().calls; },
+                       sm::description("number of single partition reads of a local replica sent to the shard owning the partition")),
+        sm::make_counter("cross_shard_read_batches", [this] { return _read_batcher.get_stats().batches; },
+                       sm::description("number of messages carrying single partition reads to other shards. "
+                                       "The ratio of cross_shard_read_calls to this counter shows how many reads a message carries")),
+        sm::make_queue_length("deferred_read_repair_queue_length", [this] { return _deferred_repairs.size(); },
+                       sm::description("number of partitions with read repair writes waiting to be sent in the background")),
+        sm::make_counter("deferred_read_repairs", [this] { return _deferred_repairs.get_stats().queued; },
+                       sm::description("number of partitions queued for deferred read repair")),
+        sm::make_counter("deferred_read_repairs_dropped", [this] { return _deferred_repairs.get_stats().dropped; },
+                       sm::description("number of partition read repairs dropped because the deferred read repair queue was full")),
     });
 
     slogger.trace("hinted DCs: {}", cfg.hinted_handoff_enabled.to_configuration_string());
@@ -2771,8 +2849,12 @@ storage_proxy::create_write_response_handler_helper(schema_ptr s, const dht::tok
 
     db::assure_sufficient_live_nodes(cl, *erm, live_endpoints, pending_endpoints);
 
-    return create_write_response_handler(std::move(erm), cl, type, std::move(mh), std::move(live_endpoints), pending_endpoints,
+    auto r_id = create_write_response_handler(std::move(erm), cl, type, std::move(mh), std::move(live_endpoints), pending_endpoints,
             std::move(dead_endpoints), std::move(tr_state), get_stats(), std::move(permit), rate_limit_info);
+    if (r_id && std::holds_alternative<db::per_partition_rate_limit::account_and_enforce>(rate_limit_info)) {
+        get_write_response_handler(r_id.value())->set_rate_limited_token(token);
+    }
+    return r_id;
 }
 
 /**
@@ -3594,8 +3676,7 @@ void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type respo
 {
     // extra-datacenter replicas, grouped by dc
     std::unordered_map<sstring, inet_address_vector_replica_set> dc_groups;
-    std::vector<std::pair<const sstring, inet_address_vector_replica_set>> local;
-    local.reserve(3);
+    utils::small_vector<std::pair<const sstring, inet_address_vector_replica_set>, 3> local;
 
     auto handler_ptr = get_write_response_handler(response_id);
     auto& stats = handler_ptr->stats();
@@ -3715,6 +3796,43 @@ future<result<>> storage_proxy::schedule_repair(std::unordered_map<dht::token, s
     return mutate_internal(diffs | boost::adaptors::map_values, cl, false, std::move(trace_state), std::move(permit));
 }
 
+void storage_proxy::defer_repair(deferred_read_repair_queue::diffs_type diffs) {
+    if (_deferred_repair_as.abort_requested()) {
+        return;
+    }
+    _deferred_repairs.push(std::move(diffs), _db.local().get_config().deferred_read_repair_max_pending_partitions());
+    if (!_deferred_repairs.empty() && !_sending_deferred_repairs) {
+        _sending_deferred_repairs = true;
+        _deferred_repair_sender = send_deferred_repairs();
+    }
+}
+
+future<> storage_proxy::send_deferred_repairs() {
+    while (!_deferred_repairs.empty() && !_deferred_repair_as.abort_requested()) {
+        const auto rate = std::max(_db.local().get_config().deferred_read_repair_partitions_per_second(), 1u);
+        // Send a tenth of a second worth of partitions at a time.
+        auto batch = _deferred_repairs.pop(std::max(rate / 10, 1u));
+        const auto next = lowres_clock::now() + std::chrono::duration_cast<lowres_clock::duration>(
+                deferred_read_repair_queue::pacing_period(batch.size(), rate));
+        get_stats().read_repair_repaired_background += batch.size();
+        try {
+            // Nobody waits for the writes, so ONE is enough to know they reached a replica.
+            co_await mutate_internal(std::move(batch), db::consistency_level::ONE, false, nullptr, empty_service_permit())
+                    .then(utils::result_into_future<result<>>);
+        } catch (...) {
+            slogger.debug("Deferred read repair failed: {}", std::current_exception());
+        }
+        try {
+            co_await sleep_abortable<lowres_clock>(next - lowres_clock::now(), _deferred_repair_as);
+        } catch (const sleep_aborted&) {
+            break;
+        }
+    }
+    // Reset synchronously with the check above, so that a repair deferred
+    // from now on starts a new sender.
+    _sending_deferred_repairs = false;
+}
+
 class abstract_read_resolver {
 protected:
     enum class error_kind : uint8_t {
@@ -3726,7 +3844,7 @@ class abstract_read_resolver {
     size_t _targets_count;
     promise<result<>> _done_promise; // all target responded
     bool _request_failed = false; // will be true if request fails or timeouts
-    timer<storage_proxy::clock_type> _timeout;
+    utils::coarse_timer _timeout;
     schema_ptr _schema;
     size_t _failed = 0;
 
@@ -4487,6 +4605,24 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         _proxy->get_stats().foreground_reads -= int(_foreground);
     }
 
+    // Lets the rate limiter know if replicas rejected the read, so that
+    // further reads of the partition can be rejected by the coordinator.
+    void on_failure(const exceptions::coordinator_exception_container& ex) {
+        if (!std::holds_alternative<db::per_partition_rate_limit::account_and_enforce>(_rate_limit_info)) {
+            return;
+        }
+        const bool rejected_by_replicas = ex.accept([] <typename Ex> (const Ex& e) {
+            if constexpr (std::is_same_v<Ex, exceptions::rate_limit_exception>) {
+                return !e.rejected_by_coordinator;
+            } else {
+                return false;
+            }
+        });
+        if (rejected_by_replicas) {
+            _proxy->local_db().on_rejected_by_replicas(*_schema, _partition_range.start()->value().token(), db::operation_type::read);
+        }
+    }
+
     /// Targets that were successfully ised for data and/or digest requests.
     ///
     /// Only filled after the request is finished, call only after
@@ -4557,8 +4693,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_replica_latencies.request_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
+                replica_request_finished(ep, start);
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
@@ -4584,8 +4722,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_replica_latencies.request_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> f) {
+                replica_request_finished(ep, start);
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
@@ -4660,11 +4800,19 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                         && !data_resolver->any_partition_short_read()) {
                     auto result = ::make_foreign(::make_lw_shared<query::result>(
                             co_await to_data_query_result(std::move(*rr_opt), _schema, _cmd->slice, _cmd->get_row_limit(), cmd->partition_limit)));
+                    auto diffs = data_resolver->get_diffs_for_repair();
+                    if (!diffs.empty() && _proxy->_db.local().get_config().deferred_read_repair()) {
+                        // Return the result right away, the repair writes are sent in the background.
+                        _proxy->defer_repair(std::move(diffs));
+                        _result_promise.set_value(std::move(result));
+                        on_read_resolved();
+                        co_return;
+                    }
                     // wait for write to complete before returning result to prevent multiple concurrent read requests to
                     // trigger repair multiple times and to prevent quorum read to return an old value, even after a quorum
                     // another read had returned a newer value (but the newer value had not yet been sent to the other replicas)
                     // Waited on indirectly.
-                    (void)_proxy->schedule_repair(data_resolver->get_diffs_for_repair(), _cl, _trace_state, _permit).then(utils::result_wrap([this, result = std::move(result)] () mutable {
+                    (void)_proxy->schedule_repair(std::move(diffs), _cl, _trace_state, _permit).then(utils::result_wrap([this, result = std::move(result)] () mutable {
                         _result_promise.set_value(std::move(result));
                         return make_ready_future<::result<>>(bo::success());
                     })).then_wrapped([this, exec] (future<::result<>>&& f) {
@@ -4835,6 +4983,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         _max_request_latency = std::max(_max_request_latency, d);
     }
 
+    void replica_request_finished(gms::inet_address ep, latency_clock::time_point start) {
+        _proxy->_replica_latencies.request_finished(ep, std::chrono::duration_cast<std::chrono::microseconds>(latency_clock::now() - start));
+    }
+
     static constexpr latency_clock::duration NO_LATENCY{-1};
     latency_clock::duration _max_request_latency{NO_LATENCY};
 };
@@ -4871,6 +5023,10 @@ class speculating_read_executor : public abstract_read_executor {
     virtual void make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) override {
         _speculate_timer.set_callback([this, resolver, timeout] {
             if (!resolver->is_completed()) { // at the time the callback runs request may be completed already
+                if (!_proxy->_speculative_retry_budget.try_withdraw()) {
+                    _proxy->get_stats().speculative_reads_over_budget++;
+                    return;
+                }
                 resolver->add_wait_targets(1); // we send one more request so wait for it too
                 // FIXME: consider disabling for CL=*ONE
                 auto send_request = [&] (bool has_data) {
@@ -4954,12 +5110,49 @@ result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw
     // orders the list by proximity to the local endpoint.
     is_read_non_local |= !all_replicas.empty() && all_replicas.front() != utils::fb_utilities::get_broadcast_address();
 
+    // When a single replica is enough, the closest one gets all the reads of a
+    // partition, which overloads it if the partition is hot. Reads of
+    // partitions which get a large share of this shard's reads are spread
+    // over the live replicas in the local DC in turn instead.
+    bool hot_partition = false;
+    if (_db.local().get_config().spread_hot_partition_reads()
+            && (cl == db::consistency_level::ONE || cl == db::consistency_level::LOCAL_ONE)
+            && repair_decision == db::read_repair_decision::NONE && preferred_endpoints.empty() && all_replicas.size() > 1) {
+        auto hash = uint64_t(token.raw());
+        _partition_read_frequency.increment(hash);
+        if (_partition_read_frequency.estimate(hash) >= hot_partition_read_frequency) {
+            auto local_end = std::stable_partition(all_replicas.begin(), all_replicas.end(), erm->get_topology().get_local_dc_filter());
+            size_t local_count = std::distance(all_replicas.begin(), local_end);
+            if (local_count > 1) {
+                hot_partition = true;
+                std::rotate(all_replicas.begin(), all_replicas.begin() + _hot_partition_read_rotation++ % local_count, local_end);
+            }
+        }
+    }
+
+    // Order the local replicas by their recent latency and load, so that the
+    // targets are the fastest ones and the extra replica to speculate with is
+    // the fastest one left. Heat-weighted balancing would undo the order.
+    bool latency_balanced = false;
+    if (!hot_partition && _db.local().get_config().read_replica_latency_balancing()
+            && preferred_endpoints.empty() && all_replicas.size() > 1) {
+        auto local_end = std::stable_partition(all_replicas.begin(), all_replicas.end(), erm->get_topology().get_local_dc_filter());
+        _replica_latencies.sort_by_score(all_replicas.begin(), local_end);
+        latency_balanced = true;
+    }
+    // Leave the replicas the failure detector suspects for last, in any DC.
+    if (_replica_latencies.has_suspected() && preferred_endpoints.empty()) {
+        std::stable_partition(all_replicas.begin(), all_replicas.end(), [this] (gms::inet_address ep) {
+            return !_replica_latencies.is_suspected(ep);
+        });
+    }
+
     auto cf = _db.local().find_column_family(schema).shared_from_this();
     auto& gossiper = _remote->gossiper();
     inet_address_vector_replica_set target_replicas = db::filter_for_query(cl, *erm, all_replicas, preferred_endpoints, repair_decision,
             gossiper,
             retry_type == speculative_retry::type::NONE ? nullptr : &extra_replica,
-            _db.local().get_config().cache_hit_rate_read_balancing() ? &*cf : nullptr);
+            _db.local().get_config().cache_hit_rate_read_balancing() && !hot_partition && !latency_balanced ? &*cf : nullptr);
 
     slogger.trace("creating read executor for token {} with all: {} targets: {} rp decision: {}", token, all_replicas, target_replicas, repair_decision);
     tracing::trace(trace_state, "Creating read executor for token {} with all: {} targets: {} repair decision: {}", token, all_replicas, target_replicas, repair_decision);
@@ -4977,6 +5170,8 @@ result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw
         get_stats().read_repair_attempts++;
     }
 
+    _speculative_retry_budget.deposit(_db.local().get_config().speculative_retry_budget());
+
     size_t block_for = db::block_for(*erm, cl);
     auto p = shared_from_this();
 
@@ -5040,7 +5235,9 @@ storage_proxy::query_result_local(schema_ptr s, lw_shared_ptr<query::read_comman
     if (pr.is_singular()) {
         unsigned shard = dht::shard_of(*s, pr.start()->value().token());
         get_stats().replica_cross_shard_ops += shard != this_shard_id();
-        return _db.invoke_on(shard, _read_smp_service_group, [gs = global_schema_ptr(s), prv = dht::partition_range_vector({pr}) /* FIXME: pr is copied */, cmd, opts, timeout, gt = tracing::global_trace_state_ptr(std::move(trace_state)), rate_limit_info] (replica::database& db) mutable {
+        // Reads of many partitions, like those of IN queries, are sent to each shard in a single message.
+        return _read_batcher.submit_to(shard, [&sharded_db = _db, gs = global_schema_ptr(s), prv = dht::partition_range_vector({pr}) /* FIXME: pr is copied */, cmd, opts, timeout, gt = tracing::global_trace_state_ptr(std::move(trace_state)), rate_limit_info] () mutable {
+            auto& db = sharded_db.local();
             auto trace_state = gt.get();
             tracing::trace(trace_state, "Start querying singular range {}", prv.front());
             return db.query(gs, *cmd, opts, prv, trace_state, timeout, rate_limit_info).then([trace_state](std::tuple<lw_shared_ptr<query::result>, cache_temperature>&& f_ht) {
@@ -5160,6 +5357,8 @@ storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd,
             // Handle success here. Failure is handled just outside the try..catch.
             if (result) {
                 handle_completion(exec[0]);
+            } else {
+                exec[0].first->on_failure(result.error());
             }
         } else {
             auto mapper = [timeout, &handle_completion] (
@@ -5168,6 +5367,8 @@ storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd,
                 // Handle success here. Failure is handled (only once) just outside the try..catch.
                 if (result) {
                     handle_completion(executor_and_token_range);
+                } else {
+                    executor_and_token_range.first->on_failure(result.error());
                 }
                 co_return std::move(result);
             };
@@ -5215,6 +5416,39 @@ bool storage_proxy::is_worth_merging_for_range_query(
         : true;
 }
 
+// Picks the number of vnode ranges to query in the next round of a range
+// scan, from the results of the previous round.
+//
+// The rows (and partitions) returned per range in the previous round predict
+// how many more ranges are needed to fill the page. Querying many more than
+// that makes the replicas read data which won't fit in the page, so the
+// estimate, plus a margin for its error, bounds the next round. Without a
+// useful estimate (e.g. a filtering scan which matched nothing yet) the
+// concurrency doubles, like it always did. Growth is further limited when
+// the previous round was slow compared to the time left until the timeout,
+// as the replicas are likely loaded.
+static int next_range_scan_concurrency(int concurrency, size_t ranges_queried, uint64_t rows, uint64_t partitions,
+        uint64_t remaining_rows, uint32_t remaining_partitions,
+        storage_proxy::clock_type::duration round_latency, storage_proxy::clock_type::duration time_left) {
+    static constexpr int max_growth = 8;
+    static constexpr double estimate_margin = 1.5;
+
+    const bool replicas_slow = round_latency * 4 > time_left;
+    const int max_concurrency = concurrency * (replicas_slow ? 2 : max_growth);
+    if (!rows || !ranges_queried) {
+        return concurrency * 2;
+    }
+    auto needed = [&] (uint64_t returned, uint64_t remaining) {
+        return double(remaining) * ranges_queried / returned;
+    };
+    auto ranges_needed = needed(rows, remaining_rows);
+    if (partitions) {
+        ranges_needed = std::min(ranges_needed, needed(partitions, remaining_partitions));
+    }
+    auto next = std::ceil(ranges_needed * estimate_margin);
+    return std::clamp(int(std::min(next, double(max_concurrency))), 1, max_concurrency);
+}
+
 future<result<query_partition_key_range_concurrent_result>>
 storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::time_point timeout,
         std::vector<foreign_ptr<lw_shared_ptr<query::result>>>&& results,
@@ -5369,6 +5603,8 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
     query::result_merger merger(cmd->get_row_limit(), cmd->partition_limit);
     merger.reserve(exec.size());
 
+    const auto ranges_queried = ranges.size();
+    const auto round_start = clock_type::now();
     auto f = utils::result_map_reduce(exec.begin(), exec.end(), [timeout] (::shared_ptr<abstract_read_executor>& rex) {
         return rex->execute(timeout);
     }, std::move(merger));
@@ -5382,6 +5618,8 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
             cl,
             cmd,
             concurrency_factor,
+            ranges_queried,
+            round_start,
             timeout,
             remaining_row_count,
             remaining_partition_count,
@@ -5390,8 +5628,10 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
             ranges_per_exec = std::move(ranges_per_exec),
             permit = std::move(permit)] (foreign_ptr<lw_shared_ptr<query::result>>&& result) mutable {
         result->ensure_counts();
-        remaining_row_count -= result->row_count().value();
-        remaining_partition_count -= result->partition_count().value();
+        const auto rows = result->row_count().value();
+        const auto partitions = result->partition_count().value();
+        remaining_row_count -= rows;
+        remaining_partition_count -= partitions;
         results.emplace_back(std::move(result));
         if (ranges_to_vnodes.empty() || !remaining_row_count || !remaining_partition_count) {
             auto used_replicas = replicas_per_token_range();
@@ -5410,8 +5650,12 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
         } else {
             cmd->set_row_limit(remaining_row_count);
             cmd->partition_limit = remaining_partition_count;
+            const auto now = clock_type::now();
+            const auto next_concurrency_factor = next_range_scan_concurrency(concurrency_factor, ranges_queried, rows, partitions,
+                    remaining_row_count, remaining_partition_count, now - round_start, timeout - now);
+            slogger.trace("range scan round of {} ranges returned {} rows, querying {} ranges next", ranges_queried, rows, next_concurrency_factor);
             return p->query_partition_key_range_concurrent(timeout, std::move(results), cmd, cl, std::move(ranges_to_vnodes),
-                    concurrency_factor * 2, std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
+                    next_concurrency_factor, std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
         }
       }));
     },  utils::result_catch_dots([p] (auto&& handle) {
@@ -5692,6 +5936,10 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
         co_await coroutine::return_exception(std::logic_error("storage_proxy::cas called on a wrong shard"));
     }
 
+    // A request which doesn't look at existing values may skip the prepare phase,
+    // if this coordinator holds a ballot lease on the key.
+    const bool needs_read = bool(cmd);
+
     // In case a nullptr is passed to this function (i.e. the caller isn't interested in
     // existing value) we fabricate an "empty"  read_command that does nothing,
     // i.e. appropriate calls to storage_proxy::query immediately return an
@@ -5714,7 +5962,7 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
     db::consistency_level cl = cl_for_paxos == db::consistency_level::LOCAL_SERIAL ?
         db::consistency_level::LOCAL_QUORUM : db::consistency_level::QUORUM;
 
-    unsigned contentions;
+    unsigned contentions = 0;
 
     dht::token token = partition_ranges[0].start()->value().as_decorated_key().token();
     utils::latency_counter lc;
@@ -5734,12 +5982,31 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
         paxos::paxos_state::guard l = co_await paxos::paxos_state::get_cas_lock(token, write_timeout);
 
         while (true) {
-            // Finish the previous PAXOS round, if any, and, as a side effect, compute
-            // a ballot (round identifier) which is a) unique b) has good chances of being
-            // recent enough.
-            auto [ballot, qr] = co_await handler->begin_and_repair_paxos(query_options.cstate, contentions, write);
+            utils::UUID ballot;
+            foreign_ptr<lw_shared_ptr<query::result>> qr;
+            std::optional<utils::UUID> leased_ballot = needs_read ? std::nullopt : handler->get_ballot_lease();
+            if (leased_ballot) {
+                // Nobody prepared the key since this coordinator's last round was learned everywhere,
+                // so there is no unfinished round to repair and a newer ballot will be promised.
+                // Propose right away, the replicas will refuse if the lease turns out to be lost.
+                ballot = paxos_response_handler::new_ballot(query_options.cstate, utils::UUID_gen::micros_timestamp(*leased_ballot) + 1);
+                paxos::paxos_state::logger.debug("CAS[{}] Skipping prepare, proposing {} after leased ballot {}", handler->id(), ballot, *leased_ballot);
+                tracing::trace(handler->tr_state, "Skipping prepare, proposing {} after leased ballot {}", ballot, *leased_ballot);
+                ++get_stats().cas_prepare_skipped;
+                qr = make_foreign(make_lw_shared<query::result>());
+            } else {
+                handler->revoke_ballot_lease();
+                // Finish the previous PAXOS round, if any, and, as a side effect, compute
+                // a ballot (round identifier) which is a) unique b) has good chances of being
+                // recent enough.
+                auto bd = co_await handler->begin_and_repair_paxos(query_options.cstate, contentions, write);
+                ballot = bd.ballot;
+                qr = std::move(bd.data);
+            }
             // Read the current values and check they validate the conditions.
-            if (qr) {
+            if (leased_ballot) {
+                // The request doesn't look at existing values, qr is empty.
+            } else if (qr) {
                 paxos::paxos_state::logger.debug("CAS[{}]: Using prefetched values for CAS precondition",
                         handler->id());
                 tracing::trace(handler->tr_state, "Using prefetched values for CAS precondition");
@@ -5778,24 +6045,47 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
 
             auto proposal = make_lw_shared<paxos::proposal>(ballot, freeze(*mutation));
 
-            bool is_accepted = co_await handler->accept_proposal(proposal);
+            bool is_accepted = co_await handler->accept_proposal(proposal, true, leased_ballot);
             if (is_accepted) {
                 // The majority (aka a QUORUM) has promised the coordinator to
                 // accept the action associated with the computed ballot.
                 // Apply the mutation.
-                try {
-                  co_await handler->learn_decision(std::move(proposal));
-                } catch (unavailable_exception& e) {
-                    // if learning stage encountered unavailablity error lets re-map it to a write error
-                    // since unavailable error means that operation has never ever started which is not
-                    // the case here
-                    schema_ptr schema = handler->schema();
-                    throw mutation_write_timeout_exception(schema->ks_name(), schema->cf_name(),
-                                          e.consistency, e.alive, e.required, db::write_type::CAS);
+                if (handler->cl_for_learn() == db::consistency_level::ANY && !_background_learns.is_closed()) {
+                    // Nobody waits for the decision to be applied, and it can't be lost
+                    // since a quorum accepted it, so don't wait for it either. Keep the
+                    // key locked until it's learned, so a following CAS through this
+                    // coordinator doesn't find the round unfinished and have to repair it.
+                    // stop() waits for the learn through the gate.
+                    ++get_stats().cas_background_learn;
+                    (void)with_gate(_background_learns, [handler, proposal = std::move(proposal), l = std::move(l)] () mutable {
+                        return handler->learn_decision(std::move(proposal)).then_wrapped([handler, l = std::move(l)] (future<> f) {
+                            if (f.failed()) {
+                                paxos::paxos_state::logger.debug("CAS[{}] background learn failed: {}", handler->id(), f.get_exception());
+                            }
+                        });
+                    });
+                } else {
+                    try {
+                        co_await handler->learn_decision(std::move(proposal));
+                    } catch (unavailable_exception& e) {
+                        // if learning stage encountered unavailablity error lets re-map it to a write error
+                        // since unavailable error means that operation has never ever started which is not
+                        // the case here
+                        schema_ptr schema = handler->schema();
+                        throw mutation_write_timeout_exception(schema->ks_name(), schema->cf_name(),
+                                              e.consistency, e.alive, e.required, db::write_type::CAS);
+                    }
                 }
                 paxos::paxos_state::logger.debug("CAS[{}] successful", handler->id());
                 tracing::trace(handler->tr_state, "CAS successful");
                 break;
+            } else if (leased_ballot) {
+                // Another coordinator prepared the key since our last round. Not a contention
+                // yet, so retry with a regular round right away.
+                paxos::paxos_state::logger.debug("CAS[{}] PAXOS proposal not accepted (ballot lease {} lost)", handler->id(), *leased_ballot);
+                tracing::trace(handler->tr_state, "PAXOS proposal not accepted (ballot lease lost)");
+                ++get_stats().cas_prepare_skip_failed;
+                handler->revoke_ballot_lease();
             } else {
                 paxos::paxos_state::logger.debug("CAS[{}] PAXOS proposal not accepted (pre-empted by a higher ballot)",
                         handler->id());
@@ -6122,7 +6412,11 @@ future<> storage_proxy::drain_on_shutdown() {
 
 future<>
 storage_proxy::stop() {
-    return make_ready_future<>();
+    co_await _background_learns.close();
+    _deferred_repair_as.request_abort();
+    co_await std::exchange(_deferred_repair_sender, make_ready_future<>());
+    _deferred_repairs.clear();
+    co_await _read_batcher.stop();
 }
 
 locator::token_metadata_ptr storage_proxy::get_token_metadata_ptr() const noexcept {
@@ -13,9 +13,12 @@
 #include <variant>
 #include "replica/database_fwd.hh"
 #include "message/messaging_service_fwd.hh"
+#include <seastar/core/abort_source.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/execution_stage.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/scheduling_specific.hh>
+#include "service/deferred_read_repair_queue.hh"
 #include "db/read_repair_decision.hh"
 #include "db/write_type.hh"
 #include "db/hints/manager.hh"
@@ -29,7 +32,11 @@
 #include "locator/abstract_replication_strategy.hh"
 #include "db/hints/host_filter.hh"
 #include "utils/small_vector.hh"
+#include "absl-flat_hash_map.hh"
+#include "utils/cross_shard_batcher.hh"
+#include "utils/frequency_sketch.hh"
 #include "service/endpoint_lifecycle_subscriber.hh"
+#include "service/replica_selection.hh"
 #include <seastar/core/circular_buffer.hh>
 #include "exceptions/exceptions.hh"
 #include "exceptions/coordinator_result.hh"
@@ -151,7 +158,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         response_id_type release();
     };
     using unique_response_handler_vector = utils::small_vector<unique_response_handler, 1>;
-    using response_handlers_map = std::unordered_map<response_id_type, ::shared_ptr<abstract_write_response_handler>>;
+    // Open addressing, so that registering a write doesn't allocate a node.
+    using response_handlers_map = flat_hash_map<response_id_type, ::shared_ptr<abstract_write_response_handler>>;
 
 public:
     static const sstring COORDINATOR_STATS_CATEGORY;
@@ -227,6 +235,14 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     smp_service_group _write_smp_service_group;
     smp_service_group _hints_write_smp_service_group;
     smp_service_group _write_ack_smp_service_group;
+    // Must be initialized after _read_smp_service_group.
+    utils::cross_shard_batcher<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> _read_batcher;
+    deferred_read_repair_queue _deferred_repairs;
+    bool _sending_deferred_repairs = false;
+    future<> _deferred_repair_sender = make_ready_future<>();
+    abort_source _deferred_repair_as;
+    // Tracks CAS decisions learned in the background.
+    seastar::gate _background_learns;
     response_id_type _next_response_id;
     response_handlers_map _response_handlers;
     // This buffer hold ids of throttled writes in case resource consumption goes
@@ -252,6 +268,17 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     // for read repair chance calculation
     std::default_random_engine _urandom;
     std::uniform_real_distribution<> _read_repair_chance = std::uniform_real_distribution<>(0,1);
+    // How often partitions were read recently, by token, for spreading the
+    // reads of hot partitions across replicas. A partition is hot when its
+    // estimate saturates, which with the sketch's aging takes on the order of
+    // a tenth of a percent of the shard's reads.
+    static constexpr unsigned hot_partition_read_frequency = 15;
+    utils::frequency_sketch _partition_read_frequency{1024};
+    size_t _hot_partition_read_rotation = 0;
+    // For ordering the replicas of reads by their recent latency and load.
+    replica_latency_tracker _replica_latencies;
+    // Caps the extra load of speculative reads.
+    retry_budget _speculative_retry_budget;
     seastar::metrics::metric_groups _metrics;
     uint64_t _background_write_throttle_threahsold;
     inheriting_concrete_execution_stage<
@@ -382,6 +409,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<result<>> mutate_begin(unique_response_handler_vector ids, db::consistency_level cl, tracing::trace_state_ptr trace_state, std::optional<clock_type::time_point> timeout_opt = { });
     future<result<>> mutate_end(future<result<>> mutate_result, utils::latency_counter, write_stats& stats, tracing::trace_state_ptr trace_state);
     future<result<>> schedule_repair(std::unordered_map<dht::token, std::unordered_map<gms::inet_address, std::optional<mutation>>> diffs, db::consistency_level cl, tracing::trace_state_ptr trace_state, service_permit permit);
+    void defer_repair(deferred_read_repair_queue::diffs_type diffs);
+    future<> send_deferred_repairs();
     bool need_throttle_writes() const;
     void unthrottle();
     void handle_read_error(std::variant<exceptions::coordinator_exception_container, std::exception_ptr> failure, bool range);
@@ -629,6 +658,12 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
 
     future<> stop();
     future<> start_hints_manager(shared_ptr<gms::gossiper>);
+
+    // Reads go to suspected replicas only if the other replicas can't satisfy
+    // their consistency level.
+    void set_replica_suspected(gms::inet_address ep, bool suspected) {
+        _replica_latencies.set_suspected(ep, suspected);
+    }
     void allow_replaying_hints() noexcept;
     future<> drain_on_shutdown();
 
@@ -715,6 +750,10 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
     service_permit _permit;
     // how many replicas replied to learn
     uint64_t _learned = 0;
+    // The ballot of the last decision this handler sent to learn, and how many
+    // participants learned it. Once all of them did, the ballot is leased.
+    utils::UUID _lease_ballot;
+    size_t _lease_learned = 0;
 
     // Unique request id generator.
     static thread_local uint64_t next_id;
@@ -767,10 +806,14 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
         foreign_ptr<lw_shared_ptr<query::result>> data;
     };
 
+    static utils::UUID new_ballot(client_state& cs, api::timestamp_type min_timestamp_micros_to_use);
+
     // Steps of the Paxos protocol
     future<ballot_and_data> begin_and_repair_paxos(client_state& cs, unsigned& contentions, bool is_write);
     future<paxos::prepare_summary> prepare_ballot(utils::UUID ballot);
-    future<bool> accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted = true);
+    // If leased_ballot is engaged, the proposal skipped prepare, see paxos_state::accept().
+    future<bool> accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted = true,
+            std::optional<utils::UUID> leased_ballot = std::nullopt);
     future<> learn_decision(lw_shared_ptr<paxos::proposal> proposal, bool allow_hints = false);
     void prune(utils::UUID ballot);
     uint64_t id() const {
@@ -785,12 +828,18 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
     const partition_key& key() const {
         return _key.key();
     }
+    db::consistency_level cl_for_learn() const {
+        return _cl_for_learn;
+    }
     void set_cl_for_learn(db::consistency_level cl) {
         _cl_for_learn = cl;
     }
+    // The ballot this coordinator may propose after without a prepare, if any.
+    std::optional<utils::UUID> get_ballot_lease() const;
+    void revoke_ballot_lease() const;
     // this is called with an id of a replica that replied to learn request
     // adn returns true when quorum of such requests are accumulated
-    bool learned(gms::inet_address ep);
+    bool learned(gms::inet_address ep, const utils::UUID& ballot);
 };
 
 extern distributed<storage_proxy> _the_storage_proxy;
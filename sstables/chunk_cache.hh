@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "utils/bptree.hh"
+#include "utils/lru.hh"
+#include "utils/logalloc.hh"
+
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
+using namespace seastar;
+
+namespace sstables {
+
+/// \brief A cache of decompressed chunks of a compressed Data component.
+///
+/// Chunks are identified by their offset in the compressed file and hold the
+/// uncompressed contents of the whole chunk. The contents live in LSA and are
+/// evicted by the LRU shared with the row cache and the index page cache, or
+/// when the object is destroyed.
+///
+/// Unlike cached_file, hits copy the contents out instead of sharing them,
+/// so entries are always linked in the LRU and never pinned by readers.
+///
+/// The object is not movable, since entries keep a pointer to it.
+class chunk_cache {
+public:
+    using chunk_key = uint64_t;
+
+    struct metrics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t populations = 0;
+        uint64_t cached_bytes = 0;
+    };
+private:
+    class cached_chunk : public segmented_evictable {
+    public:
+        chunk_cache* parent;
+        chunk_key key;
+        logalloc::lsa_buffer _lsa_buf;
+    public:
+        cached_chunk(chunk_cache* parent, chunk_key key, const temporary_buffer<char>& buf)
+            : parent(parent)
+            , key(key)
+        {
+            _lsa_buf = parent->_region.alloc_buf(buf.size());
+            std::copy(buf.begin(), buf.end(), _lsa_buf.get());
+        }
+
+        cached_chunk(cached_chunk&&) noexcept {
+            // Required by allocation_strategy::construct() due to generic bplus::tree, but
+            // entries are always allocated in the standard allocator context so never moved.
+            abort();
+        }
+
+        void on_evicted() noexcept override;
+
+        size_t size_in_allocator() const noexcept {
+            return _lsa_buf.size();
+        }
+    };
+
+    struct key_less_comparator {
+        bool operator()(chunk_key lhs, chunk_key rhs) const noexcept {
+            return lhs < rhs;
+        }
+    };
+
+    using cache_type = bplus::tree<chunk_key, cached_chunk, key_less_comparator, 12, bplus::key_search::linear>;
+
+    metrics& _metrics;
+    lru& _lru;
+    logalloc::region& _region;
+    logalloc::allocating_section _as;
+    cache_type _cache;
+    size_t _cached_bytes = 0;
+private:
+    cached_chunk* find(chunk_key key) noexcept {
+        auto i = _cache.lower_bound(key);
+        return i != _cache.end() && i->key == key ? &*i : nullptr;
+    }
+
+    void on_evicted(cached_chunk& c) noexcept {
+        _metrics.cached_bytes -= c.size_in_allocator();
+        _cached_bytes -= c.size_in_allocator();
+        ++_metrics.evictions;
+    }
+public:
+    /// \param m Metrics object which should be updated from operations on this object.
+    ///          It can be shared by many chunk_cache instances.
+    chunk_cache(metrics& m, lru& l, logalloc::region& reg)
+        : _metrics(m)
+        , _lru(l)
+        , _region(reg)
+        , _cache(key_less_comparator())
+    { }
+
+    chunk_cache(chunk_cache&&) = delete;
+    chunk_cache(const chunk_cache&) = delete;
+
+    ~chunk_cache() {
+        with_allocator(standard_allocator(), [this] {
+            auto i = _cache.begin();
+            while (i != _cache.end()) {
+                on_evicted(*i);
+                i = i.erase(key_less_comparator());
+            }
+        });
+    }
+
+    /// \brief Returns a copy of the cached contents of a chunk,
+    /// or an empty buffer if the chunk is not cached.
+    temporary_buffer<char> get(chunk_key key) {
+        auto c = find(key);
+        if (!c) {
+            ++_metrics.misses;
+            return {};
+        }
+        // Allocating the buffer may reclaim memory, which can move the LSA
+        // contents or evict the entry altogether, so look it up again.
+        temporary_buffer<char> buf(c->_lsa_buf.size());
+        c = find(key);
+        if (!c || c->_lsa_buf.size() != buf.size()) {
+            ++_metrics.misses;
+            return {};
+        }
+        std::copy_n(c->_lsa_buf.get(), buf.size(), buf.get_write());
+        _lru.touch(*c);
+        ++_metrics.hits;
+        return buf;
+    }
+
+    /// \brief Inserts the decompressed contents of a chunk.
+    /// Does nothing if the chunk is already cached.
+    void put(chunk_key key, const temporary_buffer<char>& buf) {
+        // _cache.emplace() needs to run under allocating section even though it lives in the std space
+        // because bplus::tree operations are not reentrant, so we need to prevent memory reclamation.
+        auto [it, inserted] = _as(_region, [&] {
+            return _cache.emplace(key, this, key, buf);
+        });
+        if (inserted) {
+            _lru.add(*it);
+            ++_metrics.populations;
+            _metrics.cached_bytes += it->size_in_allocator();
+            _cached_bytes += it->size_in_allocator();
+        }
+    }
+
+    /// \brief Returns the number of bytes cached.
+    size_t cached_bytes() const noexcept {
+        return _cached_bytes;
+    }
+
+    /// \brief Evicts all chunks.
+    future<> evict_gently() {
+        auto i = _cache.begin();
+        while (i != _cache.end()) {
+            on_evicted(*i);
+            i = i.erase(key_less_comparator());
+            if (need_preempt() && i != _cache.end()) {
+                auto key = i->key;
+                co_await coroutine::maybe_yield();
+                i = _cache.lower_bound(key);
+            }
+        }
+    }
+};
+
+extern thread_local chunk_cache::metrics chunk_cache_metrics;
+
+inline
+void chunk_cache::cached_chunk::on_evicted() noexcept {
+    parent->on_evicted(*this);
+    with_allocator(standard_allocator(), [this] {
+        chunk_cache::cache_type::iterator it(this);
+        it.erase(key_less_comparator());
+    });
+}
+
+}
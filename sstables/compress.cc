@@ -14,12 +14,15 @@
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/semaphore.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
 #include "exceptions.hh"
 #include "unimplemented.hh"
 #include "segmented_compress_params.hh"
+#include "chunk_cache.hh"
 #include "utils/class_registrator.hh"
 
 namespace sstables {
@@ -251,23 +254,7 @@ local_compression::local_compression(compressor_ptr p)
 {}
 
 local_compression::local_compression(const compression& c)
-    : _compressor([&c] {
-        sstring n(c.name.value.begin(), c.name.value.end());
-        return compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
-            if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
-                return to_sstring(c.chunk_len / 1024);
-            }
-            if (key == compression_parameters::SSTABLE_COMPRESSION) {
-                return n;
-            }
-            for (auto& o : c.options.elements) {
-                if (key == sstring(o.key.value.begin(), o.key.value.end())) {
-                    return sstring(o.value.value.begin(), o.value.value.end());
-                }
-            }
-            return std::nullopt;
-        });
-    }())
+    : _compressor(c.get_compressor())
 {}
 
 size_t local_compression::uncompress(const char* input,
@@ -288,16 +275,40 @@ size_t local_compression::compress_max_size(size_t input_len) const {
     return _compressor ? _compressor->compress_max_size(input_len) : 0;
 }
 
+const compressor_ptr& compression::get_compressor() const {
+    if (!_compressor) {
+        sstring n(name.value.begin(), name.value.end());
+        _compressor = compressor::create(n, [this, &n](const sstring& key) -> compressor::opt_string {
+            if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
+                return to_sstring(chunk_len / 1024);
+            }
+            if (key == compression_parameters::SSTABLE_COMPRESSION) {
+                return n;
+            }
+            for (auto& o : options.elements) {
+                if (key == sstring(o.key.value.begin(), o.key.value.end())) {
+                    return sstring(o.value.value.begin(), o.value.value.end());
+                }
+            }
+            return std::nullopt;
+        });
+    }
+    return _compressor;
+}
+
 void compression::set_compressor(compressor_ptr c) {
+    _compressor = c;
     if (c) {
         unqualified_name uqn(compressor::namespace_prefix, c->name());
         const sstring& cn = uqn;
         name.value = bytes(cn.begin(), cn.end());
-        for (auto& p : c->options()) {
-            if (p.first != compression_parameters::SSTABLE_COMPRESSION) {
-                auto& k = p.first;
-                auto& v = p.second;
-                options.elements.push_back({bytes(k.begin(), k.end()), bytes(v.begin(), v.end())});
+        for (auto& p : c->stored_options()) {
+            auto& k = p.first;
+            auto& v = p.second;
+            auto key = bytes(k.begin(), k.end());
+            auto present = boost::find_if(options.elements, [&key] (const auto& o) { return o.key.value == key; }) != options.elements.end();
+            if (k != compression_parameters::SSTABLE_COMPRESSION && !present) {
+                options.elements.push_back({std::move(key), bytes(v.begin(), v.end())});
             }
         }
     }
@@ -338,16 +349,18 @@ class compressed_file_data_source_impl : public data_source_impl {
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::accessor _offsets;
     sstables::local_compression _compression;
+    sstables::chunk_cache* _chunk_cache;
     uint64_t _underlying_pos;
     uint64_t _pos;
     uint64_t _beg_pos;
     uint64_t _end_pos;
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
-                uint64_t pos, size_t len, file_input_stream_options options)
+                uint64_t pos, size_t len, file_input_stream_options options, sstables::chunk_cache* cache)
             : _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_accessor())
             , _compression(*cm)
+            , _chunk_cache(cache)
     {
         _beg_pos = pos;
         if (pos > _compression_metadata->uncompressed_file_length()) {
@@ -385,6 +398,16 @@ class compressed_file_data_source_impl : public data_source_impl {
         if (_pos != _beg_pos && addr.offset != 0) {
             throw std::runtime_error("compressed reader out of sync");
         }
+        if (_chunk_cache) {
+            if (auto out = _chunk_cache->get(addr.chunk_start)) {
+                out.trim_front(addr.offset);
+                _pos += out.size();
+                _underlying_pos += addr.chunk_len;
+                return _input_stream->skip(addr.chunk_len).then([out = std::move(out)] () mutable {
+                    return std::move(out);
+                });
+            }
+        }
         return _input_stream->read_exactly(addr.chunk_len).
             then([this, addr](temporary_buffer<char> buf) {
                 // The last 4 bytes of the chunk are the adler32/crc32 checksum
@@ -408,6 +431,9 @@ class compressed_file_data_source_impl : public data_source_impl {
                 auto len = _compression.uncompress(buf.get(), compressed_len, out.get_write(), out.size());
 
                 out.trim(len);
+                if (_chunk_cache) {
+                    _chunk_cache->put(addr.chunk_start, out);
+                }
                 out.trim_front(addr.offset);
                 _pos += out.size();
                 _underlying_pos += addr.chunk_len;
@@ -444,9 +470,9 @@ requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source : public data_source {
 public:
     compressed_file_data_source(file f, sstables::compression* cm,
-            uint64_t offset, size_t len, file_input_stream_options options)
+            uint64_t offset, size_t len, file_input_stream_options options, sstables::chunk_cache* cache)
         : data_source(std::make_unique<compressed_file_data_source_impl<ChecksumType>>(
-                std::move(f), cm, offset, len, std::move(options)))
+                std::move(f), cm, offset, len, std::move(options), cache))
         {}
 };
 
@@ -454,10 +480,10 @@ template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 inline input_stream<char> make_compressed_file_input_stream(
         file f, sstables::compression *cm, uint64_t offset, size_t len,
-        file_input_stream_options options)
+        file_input_stream_options options, sstables::chunk_cache* cache)
 {
     return input_stream<char>(compressed_file_data_source<ChecksumType>(
-            std::move(f), cm, offset, len, std::move(options)));
+            std::move(f), cm, offset, len, std::move(options), cache));
 }
 
 // For SSTables 2.x (formats 'ka' and 'la'), the full checksum is a combination of checksums of compressed chunks.
@@ -471,6 +497,10 @@ enum class compressed_checksum_mode {
 // compressed_file_data_sink_impl works as a filter for a file output stream,
 // where the buffer flushed will be compressed and its checksum computed, then
 // the result passed to a regular output stream.
+//
+// Compressed chunks are queued for writing, up to max_queued_bytes, so that
+// the producer can go on serializing and compressing the next chunks while
+// the output stream waits for its write-behind buffers to be written.
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink_impl : public data_sink_impl {
@@ -480,17 +510,34 @@ class compressed_file_data_sink_impl : public data_sink_impl {
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
-public:
-    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
-            : _out(std::move(out))
-            , _compression_metadata(cm)
-            , _offsets(_compression_metadata->offsets.get_writer())
-            , _compression(lc)
-            , _full_checksum(ChecksumType::init_checksum())
-    {}
+    // Chunks are held back until the compressor's dictionary is trained on them.
+    size_t _dictionary_sample_size;
+    size_t _sampled = 0;
+    std::vector<temporary_buffer<char>> _samples;
+    static constexpr size_t max_queued_bytes = 1 << 20;
+    semaphore _queued_bytes{max_queued_bytes};
+    // Writes of queued chunks, in order.
+    future<> _writes = make_ready_future<>();
+private:
+    future<> train_dictionary() {
+        _dictionary_sample_size = 0;
+        std::vector<std::string_view> samples;
+        samples.reserve(_samples.size());
+        for (auto& s : _samples) {
+            samples.emplace_back(s.get(), s.size());
+        }
+        // If there isn't enough data to train a dictionary, keep compressing without one.
+        if (auto c = _compression.compressor()->train_dictionary(samples)) {
+            _compression = sstables::local_compression(c);
+            _compression_metadata->set_compressor(c);
+        }
+        auto chunks = std::exchange(_samples, {});
+        for (auto& chunk : chunks) {
+            co_await write_chunk(std::move(chunk));
+        }
+    }
 
-    virtual future<> put(net::packet data) override { abort(); }
-    virtual future<> put(temporary_buffer<char> buf) override {
+    future<> write_chunk(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -527,11 +574,65 @@ class compressed_file_data_sink_impl : public data_sink_impl {
 
         compressed.trim(len + 4);
 
-        auto f = _out.write(compressed.get(), compressed.size());
-        return f.then([compressed = std::move(compressed)] {});
+        return queue_write(std::move(compressed));
+    }
+
+    future<> queue_write(temporary_buffer<char> buf) {
+        if (_writes.failed()) {
+            return std::exchange(_writes, make_ready_future<>());
+        }
+        auto units = std::min(buf.size(), max_queued_bytes);
+        return get_units(_queued_bytes, units).then([this, buf = std::move(buf)] (semaphore_units<> units) mutable {
+            _writes = _writes.then([this, buf = std::move(buf), units = std::move(units)] () mutable {
+                auto f = _out.write(buf.get(), buf.size());
+                return f.then([buf = std::move(buf), units = std::move(units)] {});
+            });
+        });
+    }
+public:
+    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+            : _out(std::move(out))
+            , _compression_metadata(cm)
+            , _offsets(_compression_metadata->offsets.get_writer())
+            , _compression(lc)
+            , _full_checksum(ChecksumType::init_checksum())
+            , _dictionary_sample_size(_compression.compressor() ? _compression.compressor()->dictionary_sample_size() : 0)
+    {}
+
+    virtual future<> put(net::packet data) override { abort(); }
+    virtual future<> put(temporary_buffer<char> buf) override {
+        if (_dictionary_sample_size) {
+            _sampled += buf.size();
+            _samples.push_back(std::move(buf));
+            if (_sampled < _dictionary_sample_size) {
+                return make_ready_future<>();
+            }
+            return train_dictionary();
+        }
+        return write_chunk(std::move(buf));
     }
     virtual future<> close() override {
-        return _out.close();
+        std::exception_ptr ex;
+        try {
+            if (_dictionary_sample_size) {
+                co_await train_dictionary();
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        // The queued writes must be done before the stream they write to is
+        // closed, even if an error is already pending.
+        try {
+            co_await std::exchange(_writes, make_ready_future<>());
+        } catch (...) {
+            if (!ex) {
+                ex = std::current_exception();
+            }
+        }
+        co_await _out.close();
+        if (ex) {
+            std::rethrow_exception(ex);
+        }
     }
 
     virtual size_t buffer_size() const noexcept override {
@@ -569,15 +670,15 @@ inline output_stream<char> make_compressed_file_output_stream(output_stream<char
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
         sstables::compression* cm, uint64_t offset, size_t len,
-        class file_input_stream_options options)
+        class file_input_stream_options options, chunk_cache* cache)
 {
-    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options));
+    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options), cache);
 }
 
 input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
         sstables::compression *cm, uint64_t offset, size_t len,
-        class file_input_stream_options options) {
-    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options));
+        class file_input_stream_options options, chunk_cache* cache) {
+    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options), cache);
 }
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(output_stream<char> out,
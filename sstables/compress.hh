@@ -301,9 +301,16 @@ struct compression {
     // Variables *not* found in the "Compression Info" file (added by update()):
     uint64_t _compressed_file_length = 0;
     uint32_t _full_checksum = 0;
+    // The compressor described by name and options. Created on first use
+    // and shared by all the reads of the sstable, so that a compressor with
+    // a dictionary prepares it only once.
+    mutable compressor_ptr _compressor;
 public:
     // Set the compressor algorithm, please check the definition of enum compressor.
+    // May be called again with a compressor derived from the first one, e.g. one
+    // which trained a dictionary, to add the options it needs; the others are kept.
     void set_compressor(compressor_ptr c);
+    const compressor_ptr& get_compressor() const;
     // After changing _compression, update() must be called to update
     // additional variables depending on it.    
     void update(uint64_t compressed_file_length);
@@ -364,18 +371,22 @@ struct compression {
 // for API query only. Free function just to distinguish it from an accessor in compression
 compressor_ptr get_sstable_compressor(const compression&);
 
+class chunk_cache;
+
 // Note: compression_metadata is passed by reference; The caller is
 // responsible for keeping the compression_metadata alive as long as there
 // are open streams on it. This should happen naturally on a higher level -
 // as long as we have *sstables* work in progress, we need to keep the whole
 // sstable alive, and the compression metadata is only a part of it.
+// The same applies to the optional chunk cache, which, when given, is
+// consulted before decompressing a chunk and populated after.
 input_stream<char> make_compressed_file_k_l_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options, chunk_cache* cache = nullptr);
 
 input_stream<char> make_compressed_file_m_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options, chunk_cache* cache = nullptr);
 
 output_stream<char> make_compressed_file_m_format_output_stream(output_stream<char> out,
                 sstables::compression* cm,
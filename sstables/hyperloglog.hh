@@ -48,6 +48,7 @@
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <algorithm>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/temporary_buffer.hh>
@@ -128,11 +129,59 @@ class HyperLogLog {
         alphaMM_ = alpha * m_ * m_;
     }
 
-    static HyperLogLog from_bytes(temporary_buffer<uint8_t> bytes) {
-        // FIXME: implement class that creates a HyperLogLog from an array of bytes.
-        // This will useful if we need to work with the cardinality data from the
-        // compaction metadata.
-        abort();
+    /**
+     * Creates a HyperLogLog from its serialized form, as returned by get_bytes().
+     *
+     * @param[in] bytes range of the serialized bytes
+     *
+     * @exception std::invalid_argument the bytes are malformed, or use a
+     *            format which isn't supported (e.g. the sparse one).
+     */
+    template <typename Range>
+    static HyperLogLog from_bytes(const Range& bytes) {
+        auto it = std::begin(bytes);
+        const auto end = std::end(bytes);
+        auto next_byte = [&] {
+            if (it == end) {
+                throw std::invalid_argument("truncated cardinality estimator");
+            }
+            return uint8_t(*it++);
+        };
+        int32_t version = 0;
+        for (int i = 0; i < 4; ++i) {
+            version = (version << 8) | next_byte();
+        }
+        if (version != -2) {
+            throw std::invalid_argument("unsupported cardinality estimator version " + std::to_string(version));
+        }
+        auto read_unsigned_var_int = [&] {
+            unsigned int value = 0;
+            for (unsigned shift = 0; shift < 32; shift += 7) {
+                auto b = next_byte();
+                value |= unsigned(b & 0x7F) << shift;
+                if (!(b & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::invalid_argument("malformed var int in cardinality estimator");
+        };
+        const auto p = read_unsigned_var_int();
+        read_unsigned_var_int(); // sp; precision of the sparse set
+        const auto type = read_unsigned_var_int();
+        if (type != 0) {
+            throw std::invalid_argument("unsupported sparse cardinality estimator");
+        }
+        if (p < 4 || p > 16) {
+            throw std::invalid_argument("bit width must be in the range [4,16]");
+        }
+        HyperLogLog hll(p);
+        if (read_unsigned_var_int() != hll.m_) {
+            throw std::invalid_argument("number of registers doesn't match the bit width");
+        }
+        for (auto& r : hll.M_) {
+            r = next_byte();
+        }
+        return hll;
     }
 
     /**
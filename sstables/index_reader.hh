@@ -323,6 +323,7 @@ std::unique_ptr<clustered_index_cursor> promoted_index::make_cursor(shared_sstab
         ck_values_fixed_lengths = std::make_optional(
             get_clustering_values_fixed_lengths(sst->get_serialization_header()));
     }
+    auto prefix_compressed = prefix_compressed_promoted_index(sst->has_prefix_compressed_promoted_index());
 
     if (sst->get_version() >= sstable_version_types::mc) {
         seastar::shared_ptr<cached_file> cached_file_ptr = caching
@@ -335,13 +336,13 @@ std::unique_ptr<clustered_index_cursor> promoted_index::make_cursor(shared_sstab
         return std::make_unique<mc::bsearch_clustered_cursor>(*sst->get_schema(),
             _promoted_index_start, _promoted_index_size,
             promoted_index_cache_metrics, permit,
-            *ck_values_fixed_lengths, cached_file_ptr, options.io_priority_class, _num_blocks, trace_state);
+            *ck_values_fixed_lengths, cached_file_ptr, options.io_priority_class, _num_blocks, prefix_compressed, trace_state);
     }
 
     auto file = make_tracked_index_file(*sst, permit, std::move(trace_state), caching);
     auto promoted_index_stream = make_file_input_stream(std::move(file), _promoted_index_start, _promoted_index_size,options);
     return std::make_unique<scanning_clustered_index_cursor>(*sst->get_schema(), permit,
-        std::move(promoted_index_stream), _promoted_index_size, _num_blocks, ck_values_fixed_lengths);
+        std::move(promoted_index_stream), _promoted_index_size, _num_blocks, ck_values_fixed_lengths, prefix_compressed);
 }
 
 // Less-comparator for lookups in the partition index.
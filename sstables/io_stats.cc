@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/file.hh>
+
+#include "sstables/io_stats.hh"
+#include "service/priority_manager.hh"
+
+namespace sstables {
+
+io_stats::component io_stats::to_component(component_type type) noexcept {
+    switch (type) {
+    case component_type::Data: return component::data;
+    case component_type::Index: return component::index;
+    case component_type::Filter: return component::filter;
+    default: return component::other;
+    }
+}
+
+io_stats::reason io_stats::to_reason(const io_priority_class& pc) noexcept {
+    if (pc == service::get_local_sstable_query_read_priority()) {
+        return reason::query;
+    }
+    if (pc == service::get_local_compaction_priority()) {
+        return reason::compaction;
+    }
+    return reason::other;
+}
+
+std::string_view to_string(io_stats::component c) noexcept {
+    switch (c) {
+    case io_stats::component::data: return "data";
+    case io_stats::component::index: return "index";
+    case io_stats::component::filter: return "filter";
+    case io_stats::component::other: return "other";
+    }
+    std::abort();
+}
+
+std::string_view to_string(io_stats::reason r) noexcept {
+    switch (r) {
+    case io_stats::reason::query: return "query";
+    case io_stats::reason::compaction: return "compaction";
+    case io_stats::reason::other: return "other";
+    }
+    std::abort();
+}
+
+class io_accounting_file_impl : public file_impl {
+    file _file;
+    lw_shared_ptr<io_stats> _stats;
+    io_stats::component _component;
+private:
+    io_stats::counters& counters(const io_priority_class& pc) noexcept {
+        return _stats->get(_component, io_stats::to_reason(pc));
+    }
+
+    template <typename Func>
+    auto account_read(const io_priority_class& pc, Func&& func) {
+        auto start = utils::time_estimated_histogram::clock::now();
+        return func().then([this, &c = counters(pc), start] (auto res) {
+            ++c.read_ops;
+            if constexpr (std::is_same_v<decltype(res), size_t>) {
+                c.read_bytes += res;
+            } else {
+                c.read_bytes += res.size();
+            }
+            c.read_latency.add(utils::time_estimated_histogram::clock::now() - start);
+            return res;
+        });
+    }
+
+    future<size_t> account_write(const io_priority_class& pc, future<size_t> f) {
+        return f.then([&c = counters(pc)] (size_t size) {
+            ++c.write_ops;
+            c.write_bytes += size;
+            return size;
+        });
+    }
+public:
+    io_accounting_file_impl(file f, lw_shared_ptr<io_stats> stats, component_type type)
+        : file_impl(*get_file_impl(f))
+        , _file(std::move(f))
+        , _stats(std::move(stats))
+        , _component(io_stats::to_component(type)) {
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override {
+        return account_write(pc, get_file_impl(_file)->write_dma(pos, buffer, len, pc));
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return account_write(pc, get_file_impl(_file)->write_dma(pos, std::move(iov), pc));
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
+        return account_read(pc, [&] {
+            return get_file_impl(_file)->read_dma(pos, buffer, len, pc);
+        });
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return account_read(pc, [&] {
+            return get_file_impl(_file)->read_dma(pos, std::move(iov), pc);
+        });
+    }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
+        return account_read(pc, [&] {
+            return get_file_impl(_file)->dma_read_bulk(offset, range_size, pc);
+        });
+    }
+
+    virtual future<> flush(void) override {
+        return get_file_impl(_file)->flush();
+    }
+
+    virtual future<struct stat> stat(void) override {
+        return get_file_impl(_file)->stat();
+    }
+
+    virtual future<> truncate(uint64_t length) override {
+        return get_file_impl(_file)->truncate(length);
+    }
+
+    virtual future<> discard(uint64_t offset, uint64_t length) override {
+        return get_file_impl(_file)->discard(offset, length);
+    }
+
+    virtual future<> allocate(uint64_t position, uint64_t length) override {
+        return get_file_impl(_file)->allocate(position, length);
+    }
+
+    virtual future<uint64_t> size(void) override {
+        return get_file_impl(_file)->size();
+    }
+
+    virtual future<> close() override {
+        return get_file_impl(_file)->close();
+    }
+
+    virtual std::unique_ptr<file_handle_impl> dup() override {
+        return get_file_impl(_file)->dup();
+    }
+
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override {
+        return get_file_impl(_file)->list_directory(std::move(next));
+    }
+};
+
+file make_io_accounting_file(file f, lw_shared_ptr<io_stats> stats, component_type type) {
+    return file(make_shared<io_accounting_file_impl>(std::move(f), std::move(stats), type));
+}
+
+} // namespace sstables
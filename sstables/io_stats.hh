@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <string_view>
+
+#include <seastar/core/file.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include "seastarx.hh"
+#include "sstables/component_type.hh"
+#include "utils/estimated_histogram.hh"
+
+namespace sstables {
+
+// Disk I/O done on the sstables of one table on this shard, by sstable
+// component and by the reason for the I/O, told apart by its priority class.
+class io_stats {
+public:
+    enum class component {
+        data,
+        index,
+        filter,
+        other,
+    };
+    static constexpr size_t component_count = 4;
+
+    enum class reason {
+        query,
+        compaction,
+        other,
+    };
+    static constexpr size_t reason_count = 3;
+
+    struct counters {
+        uint64_t read_ops = 0;
+        uint64_t read_bytes = 0;
+        uint64_t write_ops = 0;
+        uint64_t write_bytes = 0;
+        utils::time_estimated_histogram read_latency;
+
+        counters& merge(const counters& o) noexcept {
+            read_ops += o.read_ops;
+            read_bytes += o.read_bytes;
+            write_ops += o.write_ops;
+            write_bytes += o.write_bytes;
+            read_latency.merge(o.read_latency);
+            return *this;
+        }
+    };
+private:
+    std::array<std::array<counters, reason_count>, component_count> _counters;
+public:
+    counters& get(component c, reason r) noexcept {
+        return _counters[size_t(c)][size_t(r)];
+    }
+    const counters& get(component c, reason r) const noexcept {
+        return _counters[size_t(c)][size_t(r)];
+    }
+
+    io_stats& merge(const io_stats& o) noexcept {
+        for (size_t c = 0; c < component_count; ++c) {
+            for (size_t r = 0; r < reason_count; ++r) {
+                _counters[c][r].merge(o._counters[c][r]);
+            }
+        }
+        return *this;
+    }
+
+    static component to_component(component_type type) noexcept;
+    static reason to_reason(const io_priority_class& pc) noexcept;
+};
+
+std::string_view to_string(io_stats::component c) noexcept;
+std::string_view to_string(io_stats::reason r) noexcept;
+
+// Wraps f so that the I/O done through it is accounted in stats, as I/O on
+// a component of the given type.
+file make_io_accounting_file(file f, lw_shared_ptr<io_stats> stats, component_type type);
+
+} // namespace sstables
@@ -168,7 +168,13 @@ class cached_promoted_index {
     reader_permit _permit;
     cached_file::stream _stream;
     logalloc::allocating_section _as;
+    bool _offsets_read = false;
 private:
+    // The offset map is read with a single I/O the first time it's needed, if it's not
+    // larger than this. The binary search then needs one I/O per step instead of two
+    // for cold partitions, which matters most for large partitions.
+    static constexpr size_t max_offsets_read_ahead = 128 * 1024;
+
     // Feeds the stream into the consumer until the consumer is satisfied.
     // Does not give unconsumed data back to the stream.
     template <typename Consumer>
@@ -193,7 +199,24 @@ class cached_promoted_index {
         return _promoted_index_size - (_blocks_count - idx) * sizeof(pi_offset_type);
     }
 
+    // Populates the page cache with the whole offset map, see max_offsets_read_ahead.
+    future<> read_offsets(tracing::trace_state_ptr trace_state) {
+        _offsets_read = true;
+        size_t size = size_t(_blocks_count) * sizeof(pi_offset_type);
+        if (_blocks_count <= 1 || size > max_offsets_read_ahead) {
+            return make_ready_future<>();
+        }
+        auto pos = _promoted_index_start + get_offset_entry_pos(0);
+        _stream = _cached_file.read(pos, _pc, _permit, trace_state, pos % cached_file::page_size + size);
+        return _stream.next_page_view().discard_result();
+    }
+
     future<pi_offset_type> read_block_offset(pi_index_type idx, tracing::trace_state_ptr trace_state) {
+        if (!_offsets_read) {
+            return read_offsets(trace_state).then([this, idx, trace_state] {
+                return read_block_offset(idx, std::move(trace_state));
+            });
+        }
         _stream = _cached_file.read(_promoted_index_start + get_offset_entry_pos(idx), _pc, _permit, trace_state);
         return _stream.next_page_view().then([this, idx] (cached_file::page_view page) {
             temporary_buffer<char> buf = page.get_buf();
@@ -269,7 +292,8 @@ class cached_promoted_index {
             column_values_fixed_lengths cvfl,
             cached_file& f,
             io_priority_class pc,
-            pi_index_type blocks_count)
+            pi_index_type blocks_count,
+            prefix_compressed_promoted_index prefix_compressed)
         : _blocks(block_comparator{s})
         , _s(s)
         , _promoted_index_start(promoted_index_start)
@@ -280,7 +304,7 @@ class cached_promoted_index {
         , _cached_file(f)
         , _primitive_parser(permit)
         , _clustering_parser(s, permit, cvfl, true)
-        , _block_parser(s, permit, std::move(cvfl))
+        , _block_parser(s, permit, std::move(cvfl), prefix_compressed)
         , _permit(std::move(permit))
     { }
 
@@ -444,6 +468,7 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             seastar::shared_ptr<cached_file> f,
             io_priority_class pc,
             pi_index_type blocks_count,
+            prefix_compressed_promoted_index prefix_compressed,
             tracing::trace_state_ptr trace_state)
         : _s(s)
         , _blocks_count(blocks_count)
@@ -456,7 +481,8 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             std::move(cvfl),
             *_cached_file,
             pc,
-            blocks_count)
+            blocks_count,
+            prefix_compressed)
         , _trace_state(std::move(trace_state))
     { }
 
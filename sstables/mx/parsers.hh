@@ -12,9 +12,18 @@
 #include "sstables/types.hh"
 #include "sstables/column_translation.hh"
 #include "sstables/m_format_read_helpers.hh"
+#include "sstables/exceptions.hh"
 #include "position_in_partition.hh"
 
+#include <seastar/util/bool_class.hh>
+
 namespace sstables {
+
+// Whether end keys of promoted index blocks are stored without the leading
+// components they share with the start key of the block.
+// See sstable_feature::PrefixCompressedPIEntries.
+using prefix_compressed_promoted_index = bool_class<struct prefix_compressed_promoted_index_tag>;
+
 namespace mc {
 
 // Incremental parser for the MC-format clustering.
@@ -25,10 +34,16 @@ namespace mc {
 //   while (cp.consume(next_buf()) == read_status::waiting) {}
 //   position_in_partition pos = cp.get();
 //
+// With prefix_compressed_promoted_index::yes, end keys are expected to be
+// encoded as a suffix of the previously parsed key: the number of leading
+// components shared with it follows the bound kind and size, and only the
+// remaining components are serialized.
+//
 class clustering_parser {
     const schema& _s;
     column_values_fixed_lengths _clustering_values_fixed_lengths;
     bool _parsing_start_key;
+    prefix_compressed_promoted_index _prefix_compressed;
     boost::iterator_range<column_values_fixed_lengths::const_iterator> ck_range;
 
     std::vector<fragmented_temporary_buffer> clustering_key_values;
@@ -44,6 +59,8 @@ class clustering_parser {
         CLUSTERING_START,
         CK_KIND,
         CK_SIZE,
+        CK_SHARED,
+        CK_SHARED_END,
         CK_BLOCK,
         CK_BLOCK_HEADER,
         CK_BLOCK2,
@@ -61,6 +78,10 @@ class clustering_parser {
 
     bool no_more_ck_blocks() const { return ck_range.empty(); }
 
+    bool is_suffix() const {
+        return _prefix_compressed && !_parsing_start_key;
+    }
+
     void move_to_next_ck_block() {
         ck_range.advance_begin(1);
         ++ck_blocks_header_offset;
@@ -92,10 +113,12 @@ class clustering_parser {
 public:
     using read_status = data_consumer::read_status;
 
-    clustering_parser(const schema& s, reader_permit permit, column_values_fixed_lengths cvfl, bool parsing_start_key)
+    clustering_parser(const schema& s, reader_permit permit, column_values_fixed_lengths cvfl, bool parsing_start_key,
+            prefix_compressed_promoted_index prefix_compressed = prefix_compressed_promoted_index::no)
         : _s(s)
         , _clustering_values_fixed_lengths(std::move(cvfl))
         , _parsing_start_key(parsing_start_key)
+        , _prefix_compressed(prefix_compressed)
         , _primitive(std::move(permit))
     { }
 
@@ -115,8 +138,10 @@ class clustering_parser {
         case state::DONE:
             return read_status::ready;
         case state::CLUSTERING_START:
-            clustering_key_values.clear();
-            clustering_key_values.reserve(_clustering_values_fixed_lengths.size());
+            if (!is_suffix()) {
+                clustering_key_values.clear();
+                clustering_key_values.reserve(_clustering_values_fixed_lengths.size());
+            }
             ck_range = boost::make_iterator_range(_clustering_values_fixed_lengths);
             ck_blocks_header_offset = 0u;
             if (_primitive.read_8(data) != read_status::ready) {
@@ -126,8 +151,8 @@ class clustering_parser {
         case state::CK_KIND:
             kind = bound_kind_m{_primitive._u8};
             if (kind == bound_kind_m::clustering) {
-                _state = state::CK_BLOCK;
-                goto ck_block_label;
+                _state = state::CK_SHARED;
+                goto ck_shared_label;
             }
             if (_primitive.read_16(data) != read_status::ready) {
                 _state = state::CK_SIZE;
@@ -137,6 +162,23 @@ class clustering_parser {
             if (_primitive._u16 < _s.clustering_key_size()) {
                 ck_range.drop_back(_s.clustering_key_size() - _primitive._u16);
             }
+        case state::CK_SHARED:
+        ck_shared_label:
+            if (!is_suffix()) {
+                _state = state::CK_BLOCK;
+                goto ck_block_label;
+            }
+            if (_primitive.read_unsigned_vint(data) != read_status::ready) {
+                _state = state::CK_SHARED_END;
+                return read_status::waiting;
+            }
+        case state::CK_SHARED_END:
+            if (_primitive._u64 > clustering_key_values.size() || _primitive._u64 > ck_range.size()) {
+                throw malformed_sstable_exception(format("promoted index end key shares {} components with a start key of {}",
+                        _primitive._u64, clustering_key_values.size()));
+            }
+            clustering_key_values.resize(_primitive._u64);
+            ck_range.advance_begin(_primitive._u64);
         case state::CK_BLOCK:
         ck_block_label:
             if (no_more_ck_blocks()) {
@@ -225,8 +267,9 @@ class promoted_index_block_parser {
 public:
     using read_status = data_consumer::read_status;
 
-    promoted_index_block_parser(const schema& s, reader_permit permit, column_values_fixed_lengths cvfl)
-        : _clustering(s, permit, std::move(cvfl), true)
+    promoted_index_block_parser(const schema& s, reader_permit permit, column_values_fixed_lengths cvfl,
+            prefix_compressed_promoted_index prefix_compressed)
+        : _clustering(s, permit, std::move(cvfl), true, prefix_compressed)
         , _primitive(permit)
     { }
 
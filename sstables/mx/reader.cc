@@ -804,6 +804,77 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
     bool should_read_block_header() const {
         return _ck_blocks_header_offset == 0u;
     }
+    // Fast path for the common case of a simple cell whose header and value
+    // are entirely contained in the current buffer: decodes the whole cell in
+    // one go instead of stepping through the primitive_consumer states. Returns
+    // false, without consuming anything, if the cell crosses the buffer end.
+    bool try_read_simple_cell(temporary_buffer<char>& data) {
+        auto p = reinterpret_cast<const bytes::value_type*>(data.get());
+        const auto end = p + data.size();
+        auto read_vint = [&] (uint64_t& v) {
+            if (p == end) {
+                return false;
+            }
+            const auto len = unsigned_vint::serialized_size_from_first_byte(*p);
+            if (size_t(end - p) < len) {
+                return false;
+            }
+            v = unsigned_vint::deserialize(bytes_view(p, end - p));
+            p += len;
+            return true;
+        };
+        if (p == end) {
+            return false;
+        }
+        const column_flags_m flags(uint8_t(*p++));
+        uint64_t timestamp = 0, local_deletion_time = 0, ttl = 0;
+        if (!flags.use_row_timestamp() && !read_vint(timestamp)) {
+            return false;
+        }
+        const bool has_local_deletion_time = !flags.use_row_ttl() && (flags.is_deleted() || flags.is_expiring());
+        if (has_local_deletion_time && !read_vint(local_deletion_time)) {
+            return false;
+        }
+        const bool has_ttl = !flags.use_row_ttl() && flags.is_expiring();
+        if (has_ttl && !read_vint(ttl)) {
+            return false;
+        }
+        uint64_t value_length = 0;
+        if (flags.has_value()) {
+            if (auto len = get_column_value_length()) {
+                value_length = *len;
+            } else if (!read_vint(value_length)) {
+                return false;
+            }
+            if (uint64_t(end - p) < value_length) {
+                return false;
+            }
+        }
+
+        _column_flags = flags;
+        _column_timestamp = flags.use_row_timestamp() ? _liveness.timestamp() : parse_timestamp(_header, timestamp);
+        if (flags.use_row_ttl()) {
+            _column_local_deletion_time = _liveness.local_deletion_time();
+            _column_ttl = _liveness.ttl();
+        } else {
+            _column_local_deletion_time = has_local_deletion_time ? parse_expiry(_header, local_deletion_time) : gc_clock::time_point::max();
+            _column_ttl = has_ttl ? parse_ttl(_header, ttl) : gc_clock::duration::zero();
+        }
+        _cell_path = temporary_buffer<char>(0);
+        const auto header_size = p - reinterpret_cast<const bytes::value_type*>(data.get());
+        if (flags.has_value()) {
+            data.trim_front(header_size);
+            auto fragments = std::move(_column_value).release();
+            fragments.clear();
+            fragments.push_back(data.share(0, value_length));
+            _column_value = fragmented_temporary_buffer(std::move(fragments), value_length);
+            data.trim_front(value_length);
+        } else {
+            _column_value = fragmented_temporary_buffer();
+            data.trim_front(header_size);
+        }
+        return true;
+    }
 public:
     using consumer = mp_row_consumer_m;
     // assumes !primitive_consumer::active()
@@ -1002,9 +1073,21 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                     _row->_columns_selector.set();
                 }
                 while (_missing_columns_to_read > 0) {
-                    --_missing_columns_to_read;
-                    co_yield read_unsigned_vint(*_processing_data);
-                    _row->_columns_selector.flip(_u64);
+                    // Decode as many column indexes as the buffer holds in one batch, and fall
+                    // back to the state machine only for an index crossing the buffer end.
+                    std::array<uint64_t, 32> indexes;
+                    bytes_view in(reinterpret_cast<const bytes::value_type*>(_processing_data->get()), _processing_data->size());
+                    auto n = unsigned_vint::deserialize_many(in, std::span(indexes.data(), std::min<uint64_t>(indexes.size(), _missing_columns_to_read)));
+                    _processing_data->trim_front(_processing_data->size() - in.size());
+                    for (size_t i = 0; i < n; ++i) {
+                        _row->_columns_selector.flip(indexes[i]);
+                    }
+                    _missing_columns_to_read -= n;
+                    if (n == 0) {
+                        --_missing_columns_to_read;
+                        co_yield read_unsigned_vint(*_processing_data);
+                        _row->_columns_selector.flip(_u64);
+                    }
                 }
                 skip_absent_columns();
             } else {
@@ -1046,6 +1129,9 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                     goto column_label;
                 }
                 _subcolumns_to_read = 0;
+                if (try_read_simple_cell(*_processing_data)) {
+                    goto column_ready_label;
+                }
             }
             co_yield read_8(*_processing_data);
             _column_flags = column_flags_m(_u8);
@@ -1088,6 +1174,7 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                 }
                 co_yield status;
             }
+        column_ready_label:
             _consuming = false;
             if (is_column_counter() && !_column_flags.is_deleted()) {
                 if (_consumer.consume_counter_column(get_column_info(),
@@ -1249,6 +1336,11 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
     using DataConsumeRowsContext = data_consume_rows_context_m;
     using Consumer = mp_row_consumer_m;
     static_assert(RowConsumer<Consumer>);
+    // Clustering ranges starting at most this far ahead of the current
+    // position are read through instead of being skipped to. Ranges close
+    // to each other, like those of IN restrictions on clustering columns,
+    // then share reads instead of issuing a small read each.
+    static constexpr uint64_t max_coalesced_skip = 32 * 1024;
     value_or_reference<query::partition_slice> _slice_holder;
     const query::partition_slice& _slice;
     Consumer _consumer;
@@ -1468,6 +1560,10 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
                     if (index_position.start <= _context->position()) {
                         return make_ready_future<>();
                     }
+                    if (index_position.start - _context->position() <= max_coalesced_skip) {
+                        _sst->get_stats().on_coalesced_seek();
+                        return make_ready_future<>();
+                    }
                     return skip_to(idx.element_kind(), index_position.start).then([this, &idx] {
                         _sst->get_stats().on_partition_seek();
                         auto open_end_marker = idx.end_open_marker();
@@ -132,12 +132,16 @@ class clustering_blocks_input_range
     const clustering_key_prefix& _prefix;
     size_t _serialization_limit_size;
     mutable clustering_block _current_block;
-    mutable uint32_t _offset = 0;
+    // Index of the first serialized component. Blocks are counted from it.
+    const uint32_t _start;
+    mutable uint32_t _offset;
 
 public:
-    clustering_blocks_input_range(const schema& s, const clustering_key_prefix& prefix, ephemerally_full_prefix is_ephemerally_full)
+    clustering_blocks_input_range(const schema& s, const clustering_key_prefix& prefix, ephemerally_full_prefix is_ephemerally_full, uint32_t start = 0)
         : _schema(s)
-        , _prefix(prefix) {
+        , _prefix(prefix)
+        , _start(start)
+        , _offset(start) {
         _serialization_limit_size = is_ephemerally_full == ephemerally_full_prefix::yes
                                     ? _schema.clustering_key_size()
                                     : _prefix.size(_schema);
@@ -153,9 +157,9 @@ class clustering_blocks_input_range
         auto limit = std::min(_serialization_limit_size, _offset + clustering_block::max_block_size);
 
         _current_block = {};
-        assert (_offset % clustering_block::max_block_size == 0);
+        assert ((_offset - _start) % clustering_block::max_block_size == 0);
         while (_offset < limit) {
-            auto shift = _offset % clustering_block::max_block_size;
+            auto shift = (_offset - _start) % clustering_block::max_block_size;
             if (_offset < _prefix.size(_schema)) {
                 managed_bytes_view value = _prefix.get_component(_schema, _offset);
                 if (value.empty()) {
@@ -206,8 +210,8 @@ static void write(sstable_version_types v, W& out, const clustering_block& block
 template <typename W>
 requires Writer<W>
 void write_clustering_prefix(sstable_version_types v, W& out, const schema& s,
-    const clustering_key_prefix& prefix, ephemerally_full_prefix is_ephemerally_full) {
-    clustering_blocks_input_range range{s, prefix, is_ephemerally_full};
+    const clustering_key_prefix& prefix, ephemerally_full_prefix is_ephemerally_full, uint32_t start = 0) {
+    clustering_blocks_input_range range{s, prefix, is_ephemerally_full, start};
     for (const auto block: range) {
         write(v, out, block);
     }
@@ -590,6 +594,7 @@ class writer : public sstable_writer::writer_impl {
         // from write config
         size_t promoted_index_block_size;
         size_t promoted_index_auto_scale_threshold;
+        bool prefix_compressed;
     } _pi_write_m;
     run_id _run_identifier;
     bool _write_regular_as_static; // See #4139
@@ -787,7 +792,7 @@ class writer : public sstable_writer::writer_impl {
         // exactly what callers used to do anyway.
         estimated_partitions = std::max(uint64_t(1), estimated_partitions);
 
-        _sst.generate_toc(_schema.get_compressor_params().get_compressor(), _schema.bloom_filter_fp_chance());
+        _sst.generate_toc(_schema.get_compressor_params().get_compressor(), _cfg.bloom_filter_fp_chance.value_or(_schema.bloom_filter_fp_chance()));
         _sst.write_toc(_pc);
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -795,9 +800,11 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _cfg.bloom_filter_fp_chance.value_or(_schema.bloom_filter_fp_chance()),
+                cfg.blocked_bloom_filter ? utils::filter_format::blocked_format : utils::filter_format::m_format);
         _pi_write_m.promoted_index_block_size = cfg.promoted_index_block_size;
         _pi_write_m.promoted_index_auto_scale_threshold = cfg.promoted_index_auto_scale_threshold;
+        _pi_write_m.prefix_compressed = cfg.prefix_compressed_promoted_index;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
         prepare_summary(_sst._components->summary, estimated_partitions, _schema.min_index_interval());
     }
@@ -971,7 +978,7 @@ void writer::maybe_record_large_partitions(const sstables::sstable& sst, const s
     auto& row_count_entry = _rows_in_partition_entry;
     size_entry.max_value = std::max(size_entry.max_value, partition_size);
     row_count_entry.max_value = std::max(row_count_entry.max_value, rows);
-    auto ret = _sst.get_large_data_handler().maybe_record_large_partitions(sst, partition_key, partition_size, rows).get0();
+    auto ret = _sst.get_large_data_handler().maybe_record_large_partitions(sst, partition_key, partition_size, rows);
     size_entry.above_threshold += unsigned(bool(ret.size));
     row_count_entry.above_threshold += unsigned(bool(ret.rows));
 }
@@ -982,7 +989,7 @@ void writer::maybe_record_large_rows(const sstables::sstable& sst, const sstable
     if (entry.max_value < row_size) {
         entry.max_value = row_size;
     }
-    if (_sst.get_large_data_handler().maybe_record_large_rows(sst, partition_key, clustering_key, row_size).get0()) {
+    if (_sst.get_large_data_handler().maybe_record_large_rows(sst, partition_key, clustering_key, row_size)) {
         entry.above_threshold++;
     };
 }
@@ -997,7 +1004,7 @@ void writer::maybe_record_large_cells(const sstables::sstable& sst, const sstabl
     if (collection_elements_entry.max_value < collection_elements) {
         collection_elements_entry.max_value = collection_elements;
     }
-    if (_sst.get_large_data_handler().maybe_record_large_cells(_sst, *_partition_key, clustering_key, cdef, cell_size, collection_elements).get0()) {
+    if (_sst.get_large_data_handler().maybe_record_large_cells(_sst, *_partition_key, clustering_key, cdef, cell_size, collection_elements)) {
         if (cell_size > cell_size_entry.threshold) {
             cell_size_entry.above_threshold++;
         }
@@ -1338,6 +1345,42 @@ static void write_clustering_prefix(sstable_version_types v, W& writer, bound_ki
     write_clustering_prefix(v, writer, s, clustering, is_ephemerally_full);
 }
 
+// Returns the number of leading components of clustering equal to those of base.
+static uint32_t shared_components(const schema& s, const clustering_key_prefix& base, const clustering_key_prefix& clustering) {
+    auto base_components = base.components(s);
+    auto components = clustering.components(s);
+    uint32_t shared = 0;
+    auto i = base_components.begin();
+    auto j = components.begin();
+    while (i != base_components.end() && j != components.end() && shared < s.clustering_key_size() && *i == *j) {
+        ++i;
+        ++j;
+        ++shared;
+    }
+    return shared;
+}
+
+// Like write_clustering_prefix() above, but doesn't repeat the leading
+// components the clustering shares with base. Their count is written instead,
+// after the bound kind and size.
+// Used for the end keys of promoted index blocks of sstables with the
+// PrefixCompressedPIEntries feature, see mc::clustering_parser.
+template <typename W>
+requires Writer<W>
+static void write_clustering_prefix_suffix(sstable_version_types v, W& writer, bound_kind_m kind,
+    const schema& s, const clustering_key_prefix& clustering, const clustering_key_prefix& base) {
+    assert(kind != bound_kind_m::static_clustering);
+    write(v, writer, kind);
+    auto is_ephemerally_full = ephemerally_full_prefix{s.is_compact_table()};
+    if (kind != bound_kind_m::clustering) {
+        is_ephemerally_full = ephemerally_full_prefix::no;
+        write(v, writer, static_cast<uint16_t>(clustering.size(s)));
+    }
+    auto shared = shared_components(s, base, clustering);
+    write_vint(writer, shared);
+    write_clustering_prefix(v, writer, s, clustering, is_ephemerally_full, shared);
+}
+
 void writer::write_promoted_index() {
     if (_pi_write_m.promoted_index_size < 2) {
         write_vint(*_index_writer, uint64_t(0));
@@ -1359,7 +1402,11 @@ void writer::write_pi_block(const pi_block& block) {
     uint32_t offset = blocks.size();
     write(_sst.get_version(), _pi_write_m.offsets, offset);
     write_clustering_prefix(_sst.get_version(), blocks, block.first.kind, _schema, block.first.clustering);
-    write_clustering_prefix(_sst.get_version(), blocks, block.last.kind, _schema, block.last.clustering);
+    if (_pi_write_m.prefix_compressed) {
+        write_clustering_prefix_suffix(_sst.get_version(), blocks, block.last.kind, _schema, block.last.clustering, block.first.clustering);
+    } else {
+        write_clustering_prefix(_sst.get_version(), blocks, block.last.kind, _schema, block.last.clustering);
+    }
     write_vint(blocks, block.offset);
     write_signed_vint(blocks, block.width - width_base);
     write(_sst.get_version(), blocks, static_cast<std::byte>(block.open_marker ? 1 : 0));
@@ -1458,7 +1505,7 @@ void writer::consume_end_of_stream() {
 
     _sst._components->statistics.contents[metadata_type::Serialization] = std::make_unique<serialization_header>(std::move(_sst_schema.header));
     seal_statistics(_sst.get_version(), _sst._components->statistics, _collector,
-        _sst._schema->get_partitioner().name(), _schema.bloom_filter_fp_chance(),
+        _sst._schema->get_partitioner().name(), _cfg.bloom_filter_fp_chance.value_or(_schema.bloom_filter_fp_chance()),
         _sst._schema, _sst.get_first_decorated_key(), _sst.get_last_decorated_key(), _enc_stats);
     close_data_writer();
     _sst.write_summary(_pc);
@@ -1466,6 +1513,9 @@ void writer::consume_end_of_stream() {
     _sst.write_statistics(_pc);
     _sst.write_compression(_pc);
     auto features = sstable_enabled_features::all();
+    if (!_pi_write_m.prefix_compressed) {
+        features.disable(sstable_feature::PrefixCompressedPIEntries);
+    }
     run_identifier identifier{_run_identifier};
     std::optional<scylla_metadata::large_data_stats> ld_stats(scylla_metadata::large_data_stats{
         .map = {
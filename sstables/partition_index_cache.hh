@@ -32,12 +32,15 @@ class partition_index_cache {
     using key_type = uint64_t;
 private:
     // Allocated inside LSA
-    class entry : public evictable, public lsa::weakly_referencable<entry> {
+    class entry : public segmented_evictable, public lsa::weakly_referencable<entry> {
     public:
         partition_index_cache* _parent;
         key_type _key;
         std::variant<lw_shared_ptr<shared_promise<>>, partition_index_page> _page;
         size_t _size_in_allocator = 0;
+        // Set once the entry was released after its first use. Entries which are used again
+        // go to the protected segment of the LRU.
+        bool _reused = false;
     public:
         entry(partition_index_cache* parent, key_type key)
                 : _parent(parent)
@@ -119,7 +122,11 @@ class partition_index_cache {
         entry_ptr& operator=(std::nullptr_t) noexcept {
             if (_ref) {
                 if (_ref.unique()) {
-                    _ref->_parent->_lru.add(*_ref);
+                    if (std::exchange(_ref->_reused, true)) {
+                        _ref->_parent->_lru.touch(*_ref);
+                    } else {
+                        _ref->_parent->_lru.add(*_ref);
+                    }
                 }
                 _ref = nullptr;
             }
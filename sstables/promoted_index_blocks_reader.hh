@@ -74,8 +74,8 @@ class promoted_index_blocks_reader : public data_consumer::continuous_data_consu
     struct m_parser_context {
         mc::promoted_index_block_parser block_parser;
 
-        m_parser_context(const schema& s, reader_permit permit, column_values_fixed_lengths cvfl)
-            : block_parser(s, std::move(permit), std::move(cvfl))
+        m_parser_context(const schema& s, reader_permit permit, column_values_fixed_lengths cvfl, prefix_compressed_promoted_index prefix_compressed)
+            : block_parser(s, std::move(permit), std::move(cvfl), prefix_compressed)
         { }
     };
 
@@ -198,14 +198,15 @@ class promoted_index_blocks_reader : public data_consumer::continuous_data_consu
     // For the mc format clustering_values_fixed_lengths must be engaged. When not engaged ka/la is assumed.
     promoted_index_blocks_reader(reader_permit permit, input_stream<char>&& promoted_index_stream, uint32_t num_blocks,
                                  const schema& s, uint64_t start, uint64_t maxlen,
-                                 std::optional<column_values_fixed_lengths> clustering_values_fixed_lengths)
+                                 std::optional<column_values_fixed_lengths> clustering_values_fixed_lengths,
+                                 prefix_compressed_promoted_index prefix_compressed)
         : continuous_data_consumer(permit, std::move(promoted_index_stream), start, maxlen)
         , _total_num_blocks{num_blocks}
         , _num_blocks_left{num_blocks}
         , _s{s}
     {
         if (clustering_values_fixed_lengths) {
-            _ctx.emplace<m_parser_context>(m_parser_context{s, std::move(permit), std::move(*clustering_values_fixed_lengths)});
+            _ctx.emplace<m_parser_context>(m_parser_context{s, std::move(permit), std::move(*clustering_values_fixed_lengths), prefix_compressed});
         }
     }
 };
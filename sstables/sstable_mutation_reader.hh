@@ -7,6 +7,7 @@
  */
 #include "mutation.hh"
 #include "sstables.hh"
+#include "sstables_manager.hh"
 #include "types.hh"
 #include <seastar/core/future-util.hh>
 #include <seastar/core/coroutine.hh>
@@ -119,6 +120,15 @@ inline std::unique_ptr<DataConsumeRowsContext> data_consume_rows(const schema& s
     // This potentially enables read-ahead beyond end, until last_end, which
     // can be beneficial if the user wants to fast_forward_to() on the
     // returned context, and may make small skips.
+    //
+    // Reads which scan to the end of the file, like the reads of compaction,
+    // are sequential and get a deeper read-ahead.
+    if (toread.end == sst->data_size()) {
+        auto input = sst->data_stream(toread.start, last_end - toread.start, consumer.io_priority(),
+                consumer.permit(), consumer.trace_state(), sst->_scan_history,
+                sstable::raw_stream::no, sstable::cache_chunks::no, sst->manager().scan_read_ahead());
+        return std::make_unique<DataConsumeRowsContext>(s, std::move(sst), consumer, std::move(input), toread.start, toread.end - toread.start);
+    }
     auto input = sst->data_stream(toread.start, last_end - toread.start, consumer.io_priority(),
             consumer.permit(), consumer.trace_state(), sst->_partition_range_history);
     return std::make_unique<DataConsumeRowsContext>(s, std::move(sst), consumer, std::move(input), toread.start, toread.end - toread.start);
@@ -154,7 +164,8 @@ inline reversed_context<DataConsumeRowsContext> data_consume_reversed_partition(
 template <typename DataConsumeRowsContext>
 inline std::unique_ptr<DataConsumeRowsContext> data_consume_single_partition(const schema& s, shared_sstable sst, typename DataConsumeRowsContext::consumer& consumer, sstable::disk_read_range toread) {
     auto input = sst->data_stream(toread.start, toread.end - toread.start, consumer.io_priority(),
-            consumer.permit(), consumer.trace_state(), sst->_single_partition_history);
+            consumer.permit(), consumer.trace_state(), sst->_single_partition_history,
+            sstable::raw_stream::no, sstable::cache_chunks::yes);
     return std::make_unique<DataConsumeRowsContext>(s, std::move(sst), consumer, std::move(input), toread.start, toread.end - toread.start);
 }
 
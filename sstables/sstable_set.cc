@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/util/defer.hh>
 
 #include <boost/icl/interval_map.hpp>
@@ -24,6 +25,7 @@
 #include "readers/from_mutations_v2.hh"
 #include "readers/empty_v2.hh"
 #include "readers/combined.hh"
+#include "collection_mutation.hh"
 
 namespace sstables {
 
@@ -811,6 +813,168 @@ filter_sstable_for_reader_by_ck(std::vector<shared_sstable>&& sstables, replica:
     return std::move(sstables);
 }
 
+// Single-partition reads of specific rows can be served from the newest
+// sstables only, when they overwrite all the requested data at timestamps
+// above the maximum timestamp of the older sstables.
+//
+// Restricted to slices which name their rows, so that the data read from
+// each sstable is bounded and can be checked for coverage, and to
+// non-counter tables, where cells of different timestamps are merged
+// rather than overwritten.
+static bool can_read_in_timestamp_order(const schema& s, const query::partition_slice& slice, const partition_key& key,
+        streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
+    if (fwd || fwd_mr || s.is_counter() || slice.is_reversed()) {
+        return false;
+    }
+    if (!s.clustering_key_size()) {
+        return true;
+    }
+    auto& ranges = slice.row_ranges(s, key);
+    return !ranges.empty() && std::all_of(ranges.begin(), ranges.end(), [&s] (const query::clustering_range& r) {
+        return r.is_singular() && r.start()->value().is_full(s);
+    });
+}
+
+// Returns true if the cells of the given columns in the row shadow anything
+// written at or below max_ts.
+static bool cells_shadow(const schema& s, const row& cells, column_kind kind, const query::column_id_vector& columns,
+        api::timestamp_type max_ts) {
+    return std::all_of(columns.begin(), columns.end(), [&] (column_id id) {
+        auto* cell = cells.find_cell(id);
+        if (!cell) {
+            return false;
+        }
+        auto& col = s.column_at(kind, id);
+        if (col.is_atomic()) {
+            return cell->as_atomic_cell(col).timestamp() > max_ts;
+        }
+        return cell->as_collection_mutation().with_deserialized(*col.type, [max_ts] (collection_mutation_view_description mview) {
+            return mview.tomb.timestamp > max_ts;
+        });
+    });
+}
+
+// Returns true if reading sstables whose timestamps are all at or below
+// max_ts can't change the result of reading the slice from m.
+static bool shadows_older_data(const schema& s, const mutation& m, const query::partition_slice& slice, api::timestamp_type max_ts) {
+    auto& p = m.partition();
+    if (p.partition_tombstone().timestamp > max_ts) {
+        return true;
+    }
+    if (!slice.static_columns.empty() && !cells_shadow(s, p.static_row().get(), column_kind::static_column, slice.static_columns, max_ts)) {
+        return false;
+    }
+    auto row_shadows = [&] (const deletable_row& dr) {
+        if (dr.deleted_at().tomb().timestamp > max_ts) {
+            return true;
+        }
+        // An older row marker would keep the row alive even if all of the newer cells are dead.
+        if (!s.is_compact_table() && (dr.marker().is_missing() || dr.marker().timestamp() <= max_ts)) {
+            return false;
+        }
+        return cells_shadow(s, dr.cells(), column_kind::regular_column, slice.regular_columns, max_ts);
+    };
+    auto range_shadows = [&] (const query::clustering_range& r) {
+        auto rows = p.range(s, r);
+        return std::any_of(rows.begin(), rows.end(), [&] (const rows_entry& e) {
+            return !e.dummy() && row_shadows(e.row());
+        });
+    };
+    if (!s.clustering_key_size()) {
+        return range_shadows(query::clustering_range::make_open_ended_both_sides());
+    }
+    auto& ranges = slice.row_ranges(s, m.key());
+    return std::all_of(ranges.begin(), ranges.end(), range_shadows);
+}
+
+// Reads the partition from sstables in the order of decreasing maximum
+// timestamp, and stops as soon as what was read so far shadows the
+// remaining sstables. See can_read_in_timestamp_order().
+class timestamp_ordered_single_key_reader : public flat_mutation_reader_v2::impl {
+    std::vector<shared_sstable> _sstables;
+    const dht::partition_range& _pr;
+    const query::partition_slice& _slice;
+    const io_priority_class& _pc;
+    tracing::trace_state_ptr _trace_state;
+    utils::estimated_histogram& _sstable_histogram;
+    // Set if sstables which contain the partition were filtered out,
+    // so that the partition is emitted even if no rows are found.
+    bool _emit_empty_partition;
+    std::optional<flat_mutation_reader_v2> _reader;
+private:
+    future<mutation_opt> read_mutation() {
+        mutation_opt result;
+        if (_emit_empty_partition) {
+            result = mutation(_schema, *_pr.start()->value().key());
+        }
+        size_t read = 0;
+        for (auto i = _sstables.begin(); i != _sstables.end(); ++i) {
+            if (result && shadows_older_data(*_schema, *result, _slice, (*i)->get_stats_metadata().max_timestamp)) {
+                tracing::trace(_trace_state, "Skipping {} older sstables, shadowed by newer data", _sstables.end() - i);
+                break;
+            }
+            tracing::trace(_trace_state, "Reading key {} from sstable {}", _pr.start()->value(), seastar::value_of([&sst = *i] { return sst->get_filename(); }));
+            auto rd = (*i)->make_reader(_schema, _permit, _pr, _slice, _pc, _trace_state, streamed_mutation::forwarding::no);
+            auto mo = co_await read_mutation_from_flat_mutation_reader(rd).finally([&rd] { return rd.close(); });
+            ++read;
+            apply(result, std::move(mo));
+        }
+        _sstable_histogram.add(read);
+        co_return result;
+    }
+public:
+    timestamp_ordered_single_key_reader(schema_ptr s, reader_permit permit, std::vector<shared_sstable> sstables, bool emit_empty_partition,
+            utils::estimated_histogram& sstable_histogram, const dht::partition_range& pr, const query::partition_slice& slice,
+            const io_priority_class& pc, tracing::trace_state_ptr trace_state)
+        : impl(std::move(s), std::move(permit))
+        , _sstables(std::move(sstables))
+        , _pr(pr)
+        , _slice(slice)
+        , _pc(pc)
+        , _trace_state(std::move(trace_state))
+        , _sstable_histogram(sstable_histogram)
+        , _emit_empty_partition(emit_empty_partition)
+    {
+        std::stable_sort(_sstables.begin(), _sstables.end(), [] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_stats_metadata().max_timestamp > b->get_stats_metadata().max_timestamp;
+        });
+    }
+
+    virtual future<> fill_buffer() override {
+        if (!_reader) {
+            auto mo = co_await read_mutation();
+            if (!mo) {
+                _end_of_stream = true;
+                co_return;
+            }
+            _reader = make_flat_mutation_reader_from_mutations_v2(_schema, _permit, std::move(*mo), _slice);
+        }
+        co_await _reader->fill_buffer();
+        _reader->move_buffer_content_to(*this);
+        _end_of_stream = _reader->is_end_of_stream();
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty() && _reader) {
+            return _reader->next_partition();
+        }
+        return make_ready_future<>();
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range&) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> fast_forward_to(position_range) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> close() noexcept override {
+        return _reader ? _reader->close() : make_ready_future<>();
+    }
+};
+
 std::vector<sstable_run>
 sstable_set_impl::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     throw_with_backtrace<std::bad_function_call>();
@@ -835,8 +999,14 @@ sstable_set_impl::create_single_key_sstable_reader(
     if (!num_sstables) {
         return make_empty_flat_reader_v2(schema, permit);
     }
+    auto filtered_sstables = filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice);
+    if (filtered_sstables.size() > 1 && can_read_in_timestamp_order(*schema, slice, *pos.key(), fwd, fwd_mr)) {
+        bool emit_empty_partition = filtered_sstables.size() != num_sstables;
+        return make_flat_mutation_reader_v2<timestamp_ordered_single_key_reader>(schema, std::move(permit), std::move(filtered_sstables),
+                emit_empty_partition, sstable_histogram, pr, slice, pc, std::move(trace_state));
+    }
     auto readers = boost::copy_range<std::vector<flat_mutation_reader_v2>>(
-        filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice)
+        std::move(filtered_sstables)
         | boost::adaptors::transformed([&] (const shared_sstable& sstable) {
             tracing::trace(trace_state, "Reading key {} from sstable {}", pos, seastar::value_of([&sstable] { return sstable->get_filename(); }));
             return sstable->make_reader(schema, permit, pr, slice, pc, trace_state, fwd);
@@ -58,6 +58,7 @@
 #include "utils/bloom_filter.hh"
 #include "utils/memory_data_sink.hh"
 #include "utils/cached_file.hh"
+#include "sstables/chunk_cache.hh"
 #include "checked-file-impl.hh"
 #include "integrity_checked_file_impl.hh"
 #include "db/extensions.hh"
@@ -158,8 +159,8 @@ future<file> sstable::new_sstable_component_file(const io_error_handler& error_h
         }
     }
 
-    f = with_file_close_on_failure(std::move(f), [&error_handler] (file f) {
-        return make_checked_file(error_handler, std::move(f));
+    f = with_file_close_on_failure(std::move(f), [&error_handler, this, type] (file f) {
+        return make_io_accounting_file(make_checked_file(error_handler, std::move(f)), _io_stats, type);
     });
 
     if (!readonly) {
@@ -1394,44 +1395,42 @@ future<> sstable::open_data() noexcept {
     }).then([this] {
         _open_mode.emplace(open_flags::ro);
         _stats.on_open_for_reading();
+        _manager.on_filter_loaded(*this);
     });
 }
 
 future<> sstable::update_info_for_opened_data() {
-    return _data_file.stat().then([this] (struct stat st) {
+    // The calls below are independent metadata lookups, so they are issued
+    // together rather than one after another, which matters when a node opens
+    // many sstables at startup.
+    return when_all_succeed(_data_file.stat().then([this] (struct stat st) {
         if (this->has_component(component_type::CompressionInfo)) {
             _components->compression.update(st.st_size);
         }
         _data_file_size = st.st_size;
         _data_file_write_time = db_clock::from_time_t(st.st_mtime);
-    }).then([this] {
-        return _index_file.size().then([this] (auto size) {
-            _index_file_size = size;
-            assert(!_cached_index_file);
-            _cached_index_file = seastar::make_shared<cached_file>(_index_file,
-                                                                   index_page_cache_metrics,
-                                                                   _manager.get_cache_tracker().get_lru(),
-                                                                   _manager.get_cache_tracker().region(),
-                                                                   _index_file_size);
-            _index_file = make_cached_seastar_file(*_cached_index_file);
-        });
-    }).then([this] {
-        if (this->has_component(component_type::Filter)) {
-            return io_check([&] {
-                return file_size(this->filename(component_type::Filter));
-            }).then([this] (auto size) {
-                _filter_file_size = size;
-            });
-        }
-        return make_ready_future<>();
-    }).then([this] {
+    }), _index_file.size().then([this] (auto size) {
+        _index_file_size = size;
+        assert(!_cached_index_file);
+        _cached_index_file = seastar::make_shared<cached_file>(_index_file,
+                                                               index_page_cache_metrics,
+                                                               _manager.get_cache_tracker().get_lru(),
+                                                               _manager.get_cache_tracker().region(),
+                                                               _index_file_size);
+        _index_file = make_cached_seastar_file(*_cached_index_file);
+        if (_components->compression && _manager.config().sstable_chunk_cache() && _schema->caching_options().enabled()) {
+            _chunk_cache = seastar::make_shared<chunk_cache>(chunk_cache_metrics,
+                                                             _manager.get_cache_tracker().get_lru(),
+                                                             _manager.get_cache_tracker().region());
+        }
+    })).discard_result().then([this] {
         this->set_min_max_position_range();
         this->set_first_and_last_keys();
         _run_identifier = _components->scylla_metadata->get_optional_run_identifier().value_or(run_id::create_random_id());
 
         // Get disk usage for this sstable (includes all components).
         _bytes_on_disk = 0;
-        return do_for_each(_recognized_components, [this] (component_type c) {
+        return parallel_for_each(_recognized_components, [this] (component_type c) {
             return this->sstable_write_io_check([&, c] {
                 return file_stat(this->filename(c)).then_wrapped([this, c] (future<seastar::stat_data> f) {
                     if (f.failed()) [[unlikely]] {
@@ -1445,7 +1444,11 @@ future<> sstable::update_info_for_opened_data() {
                             return make_exception_future<uint64_t>(ex);
                         }
                     }
-                    return make_ready_future<uint64_t>(f.get0().allocated_size);
+                    auto st = f.get0();
+                    if (c == component_type::Filter) {
+                        _filter_file_size = st.size;
+                    }
+                    return make_ready_future<uint64_t>(st.allocated_size);
                 });
             }).then([this] (uint64_t bytes) {
                 _bytes_on_disk += bytes;
@@ -1469,6 +1472,8 @@ future<> sstable::create_data() noexcept {
 future<> sstable::drop_caches() {
     return _cached_index_file->evict_gently().then([this] {
         return _index_cache->evict_gently();
+    }).then([this] {
+        return _chunk_cache ? _chunk_cache->evict_gently() : make_ready_future<>();
     });
 }
 
@@ -1486,16 +1491,36 @@ future<> sstable::read_filter(const io_priority_class& pc) {
         utils::filter_format format = (_version >= sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
+        if (_components->scylla_metadata && _components->scylla_metadata->get_filter_layout() == filter_layout::blocked) {
+            format = utils::filter_format::blocked_format;
+        }
         _components->filter = utils::filter::create_filter(filter.hashes, std::move(bs), format);
     });
 }
 
+void sstable::evict_filter() noexcept {
+    _components->filter = std::make_unique<utils::filter::always_present_filter>();
+    _filter_evicted = true;
+    _filter_read_since_eviction = false;
+    _stats.on_filter_eviction(_filter_memory);
+}
+
+void sstable::touch_filter() const noexcept {
+    _manager.on_filter_read(const_cast<sstable&>(*this));
+}
+
+future<> sstable::reload_filter() {
+    co_await read_filter(default_priority_class());
+    _filter_evicted = false;
+    _stats.on_filter_reload(_filter_memory);
+}
+
 void sstable::write_filter(const io_priority_class& pc) {
     if (!has_component(component_type::Filter)) {
         return;
     }
 
-    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
+    auto f = static_cast<utils::filter::bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
     auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
@@ -1530,8 +1555,8 @@ future<> sstable::load(sstables::foreign_sstable_open_info info) noexcept {
     static_assert(std::is_nothrow_move_constructible_v<sstables::foreign_sstable_open_info>);
     return read_toc().then([this, info = std::move(info)] () mutable {
         _components = std::move(info.components);
-        _data_file = make_checked_file(_read_error_handler, info.data.to_file());
-        _index_file = make_checked_file(_read_error_handler, info.index.to_file());
+        _data_file = make_io_accounting_file(make_checked_file(_read_error_handler, info.data.to_file()), _io_stats, component_type::Data);
+        _index_file = make_io_accounting_file(make_checked_file(_read_error_handler, info.index.to_file()), _io_stats, component_type::Index);
         _shards = std::move(info.owners);
         validate_min_max_metadata();
         validate_max_local_deletion_time();
@@ -1541,6 +1566,8 @@ future<> sstable::load(sstables::foreign_sstable_open_info info) noexcept {
 }
 
 future<foreign_sstable_open_info> sstable::get_open_info() & {
+    _components_shared = true;
+    _filter_lru_link.unlink();
     return _components.copy().then([this] (auto c) mutable {
         return foreign_sstable_open_info{std::move(c), this->get_shards_for_this_sstable(), _data_file.dup(), _index_file.dup(),
             _generation, _version, _format, data_size()};
@@ -1725,6 +1752,11 @@ sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, ssta
         _components->scylla_metadata->data.set<scylla_metadata_type::SSTableOrigin>(std::move(o));
     }
 
+    if (auto f = dynamic_cast<const utils::filter::bloom_filter*>(_components->filter.get());
+            f && f->format() == utils::filter_format::blocked_format) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::FilterLayout>(filter_layout::blocked);
+    }
+
     scylla_metadata::scylla_version version;
     version.value = bytes(to_bytes_view(sstring_view(scylla_version())));
     _components->scylla_metadata->data.set<scylla_metadata_type::ScyllaVersion>(std::move(version));
@@ -2216,6 +2248,23 @@ future<> sstable::create_links_and_mark_for_removal(const sstring& dir, generati
     return create_links_common(dir, generation, true /* mark_for_removal */);
 }
 
+future<> sstable::snapshot(const sstring& dir) const {
+    sstlog.trace("snapshot: {} -> {}", get_filename(), dir);
+    // A snapshot is valid only once its manifest is written, so the
+    // components need no TemporaryTOC; TOC still goes last so that a
+    // partially linked sstable isn't picked up from the directory.
+    auto comps = all_components();
+    co_await coroutine::parallel_for_each(comps, [this, &dir] (const auto& p) {
+        if (p.first == component_type::TOC) {
+            return make_ready_future<>();
+        }
+        auto src = sstable::filename(_dir, _schema->ks_name(), _schema->cf_name(), _version, _generation, _format, p.second);
+        auto dst = sstable::filename(dir, _schema->ks_name(), _schema->cf_name(), _version, _generation, _format, p.second);
+        return sstable_write_io_check(idempotent_link_file, std::move(src), std::move(dst));
+    });
+    co_await sstable_write_io_check(idempotent_link_file, filename(component_type::TOC), filename(dir, component_type::TOC));
+}
+
 future<> sstable::set_generation(generation_type new_generation) {
     sstlog.debug("Setting generation for {} to generation={}", get_filename(), new_generation);
     return create_links(_dir, new_generation).then([this] {
@@ -2280,6 +2329,7 @@ sstable::make_reader(
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
         read_monitor& mon) {
+    ++permit.get_read_stats().sstables_read;
     const auto reversed = slice.is_reversed();
     if (_version >= version_types::mc && (!reversed || range.is_singular())) {
         return mx::make_reader(shared_from_this(), std::move(schema), std::move(permit), range, slice, pc, std::move(trace_state), fwd, fwd_mr, mon);
@@ -2418,11 +2468,12 @@ component_type sstable::component_from_sstring(version_types v, sstring &s) {
 }
 
 input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-        reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw) {
+        reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history,
+        raw_stream raw, cache_chunks cache, unsigned read_ahead) {
     file_input_stream_options options;
     options.buffer_size = sstable_buffer_size;
     options.io_priority_class = pc;
-    options.read_ahead = 4;
+    options.read_ahead = read_ahead;
     options.dynamic_adjustments = std::move(history);
 
     file f = make_tracked_file(_data_file, std::move(permit));
@@ -2432,12 +2483,13 @@ input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_prior
 
     input_stream<char> stream;
     if (_components->compression && raw == raw_stream::no) {
+        auto* cc = cache ? _chunk_cache.get() : nullptr;
         if (_version >= sstable_version_types::mc) {
              return make_compressed_file_m_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), cc);
         } else {
             return make_compressed_file_k_l_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), cc);
         }
     }
 
@@ -3185,6 +3237,7 @@ future<> replay_pending_delete_log(sstring pending_delete_log) {
 thread_local sstables_stats::stats sstables_stats::_shard_stats;
 thread_local partition_index_cache::stats partition_index_cache::_shard_stats;
 thread_local cached_file::metrics index_page_cache_metrics;
+thread_local chunk_cache::metrics chunk_cache_metrics;
 thread_local mc::cached_promoted_index::metrics promoted_index_cache_metrics;
 static thread_local seastar::metrics::metric_groups metrics;
 
@@ -3218,6 +3271,17 @@ future<> init_metrics() {
         sm::make_gauge("index_page_cache_bytes_in_std", [] { return index_page_cache_metrics.bytes_in_std; },
             sm::description("Total number of bytes in temporary buffers which live in the std allocator")),
 
+        sm::make_counter("chunk_cache_hits", [] { return chunk_cache_metrics.hits; },
+            sm::description("Data chunk reads which were served from the decompressed chunk cache")),
+        sm::make_counter("chunk_cache_misses", [] { return chunk_cache_metrics.misses; },
+            sm::description("Data chunk reads which had to read and decompress the chunk")),
+        sm::make_counter("chunk_cache_evictions", [] { return chunk_cache_metrics.evictions; },
+            sm::description("Total number of decompressed chunks which have been evicted")),
+        sm::make_counter("chunk_cache_populations", [] { return chunk_cache_metrics.populations; },
+            sm::description("Total number of decompressed chunks which were inserted into the cache")),
+        sm::make_gauge("chunk_cache_bytes", [] { return chunk_cache_metrics.cached_bytes; },
+            sm::description("Total number of bytes cached in the decompressed chunk cache")),
+
         sm::make_counter("pi_cache_hits_l0", [] { return promoted_index_cache_metrics.hits_l0; },
             sm::description("Number of requests for promoted index block in state l0 which didn't have to go to the page cache")),
         sm::make_counter("pi_cache_hits_l1", [] { return promoted_index_cache_metrics.hits_l1; },
@@ -3268,6 +3332,8 @@ future<> init_metrics() {
             sm::description("Number of partitions read")),
         sm::make_counter("partition_seeks", [] { return sstables_stats::get_shard_stats().partition_seeks; },
             sm::description("Number of partitions seeked")),
+        sm::make_counter("coalesced_seeks", [] { return sstables_stats::get_shard_stats().coalesced_seeks; },
+            sm::description("Number of seeks within a partition done by reading through the data in between")),
         sm::make_counter("row_reads", [] { return sstables_stats::get_shard_stats().row_reads; },
             sm::description("Number of rows read")),
 
@@ -3295,6 +3361,12 @@ future<> init_metrics() {
 
         sm::make_gauge("bloom_filter_memory_size", [] { return utils::filter::bloom_filter::get_shard_stats().memory_size; },
             sm::description("Bloom filter memory usage in bytes.")),
+        sm::make_counter("bloom_filter_evictions", [] { return sstables_stats::get_shard_stats().filter_evictions; },
+            sm::description("Number of bloom filters dropped from memory to keep within sstable_filter_memory_limit_fraction")),
+        sm::make_counter("bloom_filter_reloads", [] { return sstables_stats::get_shard_stats().filter_reloads; },
+            sm::description("Number of dropped bloom filters read back from disk")),
+        sm::make_gauge("evicted_bloom_filter_memory_size", [] { return sstables_stats::get_shard_stats().evicted_filter_memory; },
+            sm::description("Memory the dropped bloom filters would take if loaded, in bytes.")),
     });
   });
 }
@@ -3335,6 +3407,7 @@ sstable::sstable(schema_ptr schema,
     , _write_error_handler(error_handler_gen(sstable_write_error))
     , _large_data_handler(large_data_handler)
     , _manager(manager)
+    , _io_stats(manager.get_io_stats(_schema->id()))
 {
     manager.add(this);
 }
@@ -3360,6 +3433,8 @@ future<> sstable::destroy() {
             } else {
                 return make_ready_future<>();
             }
+        }).then([this] {
+            return _chunk_cache ? _chunk_cache->evict_gently() : make_ready_future<>();
         });
     });
 }
@@ -16,6 +16,7 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/enum.hh>
+#include <seastar/core/lowres_clock.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <unordered_set>
 #include <unordered_map>
@@ -31,6 +32,7 @@
 #include "component_type.hh"
 #include "column_translation.hh"
 #include "stats.hh"
+#include "io_stats.hh"
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
 #include "sstables/generation_type.hh"
@@ -64,6 +66,7 @@ namespace fs = std::filesystem;
 
 extern logging::logger sstlog;
 class key;
+class chunk_cache;
 class sstable_writer;
 class sstable_writer_v2;
 class sstables_manager;
@@ -107,6 +110,10 @@ struct sstable_writer_config {
     run_id run_identifier = run_id::create_random_id();
     size_t summary_byte_cost;
     sstring origin;
+    bool blocked_bloom_filter = false;
+    bool prefix_compressed_promoted_index = false;
+    // Overrides the schema's bloom_filter_fp_chance.
+    std::optional<double> bloom_filter_fp_chance;
 
 private:
     explicit sstable_writer_config() {}
@@ -135,6 +142,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     using version_types = sstable_version_types;
     using format_types = sstable_format_types;
     using manager_link_type = bi::list_member_hook<bi::link_mode<bi::auto_unlink>>;
+    using filter_lru_link_type = bi::list_member_hook<bi::link_mode<bi::auto_unlink>>;
 public:
     sstable(schema_ptr schema,
             sstring dir,
@@ -409,6 +417,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return create_links(dir, _generation);
     }
 
+    // Hard-links all components into a snapshot directory, TOC last. Unlike
+    // create_links(), the directory isn't synced; the caller syncs it once
+    // all sstables of the snapshot are linked.
+    future<> snapshot(const sstring& dir) const;
+
     // Delete the sstable by unlinking all sstable files
     // Ignores all errors.
     future<> unlink() noexcept;
@@ -496,6 +509,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     std::set<generation_type> _compaction_ancestors;
     file _index_file;
     seastar::shared_ptr<cached_file> _cached_index_file;
+    // Decompressed Data chunks; only present for compressed sstables of tables
+    // with caching enabled, when sstable_chunk_cache is set.
+    seastar::shared_ptr<chunk_cache> _chunk_cache;
     file _data_file;
     uint64_t _data_file_size;
     uint64_t _index_file_size;
@@ -513,6 +529,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     lw_shared_ptr<file_input_stream_history> _single_partition_history = make_lw_shared<file_input_stream_history>();
     lw_shared_ptr<file_input_stream_history> _partition_range_history = make_lw_shared<file_input_stream_history>();
+    // Kept apart from _partition_range_history, so that the skips of range
+    // reads ending before the end of the file don't shrink the buffers of scans.
+    lw_shared_ptr<file_input_stream_history> _scan_history = make_lw_shared<file_input_stream_history>();
     lw_shared_ptr<file_input_stream_history> _index_history = make_lw_shared<file_input_stream_history>();
 
     schema_ptr _schema;
@@ -524,6 +543,19 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     format_types _format;
 
     filter_tracker _filter_tracker;
+    // Bookkeeping of the sstables_manager's filter memory budget.
+    // _filter_memory is the memory of the loaded filter, kept while it is
+    // evicted, so the manager knows how much a reload takes.
+    uint64_t _filter_memory = 0;
+    bool _filter_accounted = false;
+    bool _filter_evicted = false;
+    mutable bool _filter_read_since_eviction = false;
+    // Set once the components are shared with other shards, which may read
+    // the filter concurrently; such filters are never evicted.
+    bool _components_shared = false;
+    // Links the sstable in the manager's LRU of loaded or of evicted filters.
+    // Unlinked while the filter isn't accounted, is reloading, or is shared.
+    mutable filter_lru_link_type _filter_lru_link;
     std::unique_ptr<partition_index_cache> _index_cache;
 
     enum class mark_for_deletion {
@@ -542,6 +574,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     sstables_manager& _manager;
 
     sstables_stats _stats;
+    lw_shared_ptr<io_stats> _io_stats;
     manager_link_type _manager_link;
 
     // The _large_data_stats map stores e.g. largest partitions, rows, cells sizes,
@@ -591,6 +624,16 @@ class sstable : public enable_lw_shared_from_this<sstable> {
             std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin);
 
     future<> read_filter(const io_priority_class& pc);
+    // Replaces the filter with one which lets every key through, to free
+    // its memory.
+    void evict_filter() noexcept;
+    future<> reload_filter();
+    void on_filter_read() const noexcept {
+        if (_filter_lru_link.is_linked()) {
+            touch_filter();
+        }
+    }
+    void touch_filter() const noexcept;
 
     void write_filter(const io_priority_class& pc);
 
@@ -652,9 +695,15 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     //
     // When created with `raw_stream::yes`, the sstable data file will be
     // streamed as-is, without decompressing (if compressed).
+    //
+    // When created with `cache_chunks::yes`, decompressed chunks are looked
+    // up in and added to the sstable's chunk cache, if it has one. Meant for
+    // point reads, which tend to hit the same chunks repeatedly.
     using raw_stream = bool_class<class raw_stream_tag>;
+    using cache_chunks = bool_class<class cache_chunks_tag>;
     input_stream<char> data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-            reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw = raw_stream::no);
+            reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history,
+            raw_stream raw = raw_stream::no, cache_chunks cache = cache_chunks::no, unsigned read_ahead = 4);
 
     // Read exactly the specific byte range from the data file (after
     // uncompression, if the file is compressed). This can be used to read
@@ -718,6 +767,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return has_scylla_component() && _components->scylla_metadata->has_feature(sstable_feature::ShadowableTombstones);
     }
 
+    bool has_prefix_compressed_promoted_index() const {
+        return has_scylla_component() && _components->scylla_metadata->has_feature(sstable_feature::PrefixCompressedPIEntries);
+    }
+
     sstable_enabled_features features() const {
         if (!has_scylla_component()) {
             return {};
@@ -738,6 +791,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     }
 
     bool filter_has_key(const key& key) const {
+        on_filter_read();
         return _components->filter->is_present(bytes_view(key));
     }
 
@@ -750,6 +804,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     future<bool> has_partition_key(const utils::hashed_key& hk, const dht::decorated_key& dk);
 
     bool filter_has_key(utils::hashed_key key) const {
+        on_filter_read();
         return _components->filter->is_present(key);
     }
 
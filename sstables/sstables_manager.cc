@@ -25,7 +25,10 @@ sstables_manager::sstables_manager(
         max_count_sstable_metadata_concurrent_reads,
         max_memory_sstable_metadata_concurrent_reads(available_memory),
         "sstable_metadata_concurrency_sem",
-        std::numeric_limits<size_t>::max()) {
+        std::numeric_limits<size_t>::max())
+    , _filter_memory_limit(dbcfg.sstable_filter_memory_limit_fraction() > 0
+            ? available_memory * dbcfg.sstable_filter_memory_limit_fraction()
+            : std::numeric_limits<size_t>::max()) {
 }
 
 sstables_manager::~sstables_manager() {
@@ -34,6 +37,18 @@ sstables_manager::~sstables_manager() {
     assert(_undergoing_close.empty());
 }
 
+lw_shared_ptr<io_stats> sstables_manager::get_io_stats(table_id id) {
+    auto& stats = _io_stats[id];
+    if (!stats) {
+        stats = make_lw_shared<io_stats>();
+    }
+    return stats;
+}
+
+void sstables_manager::remove_io_stats(table_id id) noexcept {
+    _io_stats.erase(id);
+}
+
 const locator::host_id& sstables_manager::get_local_host_id() const {
     return _db_config.host_id;
 }
@@ -61,20 +76,118 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    cfg.blocked_bloom_filter = _db_config.sstable_blocked_bloom_filter();
+    cfg.prefix_compressed_promoted_index = _db_config.sstable_prefix_compressed_promoted_index();
 
     cfg.origin = std::move(origin);
 
     return cfg;
 }
 
+unsigned sstables_manager::scan_read_ahead() const {
+    return std::max(_db_config.sstable_scan_read_ahead(), 1u);
+}
+
 void sstables_manager::add(sstable* sst) {
     _active.push_back(*sst);
 }
 
+void sstables_manager::on_filter_loaded(sstable& sst) {
+    if (sst._filter_accounted || sst._components.get_owner_shard() != this_shard_id()) {
+        return;
+    }
+    sst._filter_memory = sst.filter_memory_size();
+    sst._filter_accounted = true;
+    _filter_memory += sst._filter_memory;
+    if (sst._filter_memory && !sst._components_shared) {
+        _loaded_filters.push_back(sst);
+    }
+    maybe_evict_filters();
+}
+
+void sstables_manager::on_filter_read(sstable& sst) noexcept {
+    sst._filter_lru_link.unlink();
+    if (sst._filter_evicted) {
+        sst._filter_read_since_eviction = true;
+        _evicted_filters.push_back(sst);
+    } else {
+        _loaded_filters.push_back(sst);
+    }
+}
+
+void sstables_manager::set_filter_memory_limit(size_t limit) {
+    _filter_memory_limit = limit;
+    maybe_evict_filters();
+    maybe_reload_filters();
+}
+
+void sstables_manager::release_filter_memory(sstable& sst) noexcept {
+    if (!sst._filter_accounted) {
+        return;
+    }
+    sst._filter_accounted = false;
+    sst._filter_lru_link.unlink();
+    if (sst._filter_evicted) {
+        sst._stats.on_evicted_filter_dropped(sst._filter_memory);
+    } else {
+        // Reloading filters are accounted up front.
+        _filter_memory -= sst._filter_memory;
+    }
+}
+
+void sstables_manager::maybe_evict_filters() {
+    while (_filter_memory > _filter_memory_limit && !_loaded_filters.empty()) {
+        auto& sst = _loaded_filters.front();
+        _loaded_filters.pop_front();
+        smlogger.debug("Evicting the filter of {} ({} bytes), filter memory {} over the limit of {}",
+                sst.get_filename(), sst._filter_memory, _filter_memory, _filter_memory_limit);
+        _filter_memory -= sst._filter_memory;
+        sst.evict_filter();
+        // Not read since the eviction, so it goes before those which were.
+        _evicted_filters.push_front(sst);
+    }
+}
+
+void sstables_manager::maybe_reload_filters() {
+    if (_filter_reloads.is_closed()) {
+        return;
+    }
+    // Reload the most recently read filters first, up to the first one which
+    // wasn't read since its eviction.
+    auto it = _evicted_filters.end();
+    while (it != _evicted_filters.begin() && std::prev(it)->_filter_read_since_eviction) {
+        auto& sst = *std::prev(it);
+        if (_filter_memory + sst._filter_memory > _filter_memory_limit) {
+            --it;
+            continue;
+        }
+        it = _evicted_filters.erase(std::prev(it));
+        _filter_memory += sst._filter_memory;
+        (void)with_gate(_filter_reloads, [this, ptr = sst.shared_from_this()] {
+            return ptr->reload_filter().then_wrapped([this, ptr] (future<> f) {
+                if (f.failed()) {
+                    smlogger.warn("Failed to reload the filter of {}: {}", ptr->get_filename(), f.get_exception());
+                    _filter_memory -= ptr->_filter_memory;
+                    // Retry only once the sstable is read again.
+                    ptr->_filter_read_since_eviction = false;
+                    _evicted_filters.push_front(*ptr);
+                    return;
+                }
+                smlogger.debug("Reloaded the filter of {}", ptr->get_filename());
+                if (!ptr->_components_shared) {
+                    _loaded_filters.push_back(*ptr);
+                }
+            });
+        });
+    }
+}
+
 void sstables_manager::deactivate(sstable* sst) {
     // At this point, sst has a reference count of zero, since we got here from
     // lw_shared_ptr_deleter<sstables::sstable>::dispose().
     _active.erase(_active.iterator_to(*sst));
+    release_filter_memory(*sst);
+    maybe_reload_filters();
     _undergoing_close.push_back(*sst);
     // guard against sstable::close_files() calling shared_from_this() and immediately destroying
     // the result, which will dispose of the sstable recursively
@@ -97,6 +210,7 @@ void sstables_manager::maybe_done() {
 }
 
 future<> sstables_manager::close() {
+    co_await _filter_reloads.close();
     _closing = true;
     maybe_done();
     co_await _done.get_future();
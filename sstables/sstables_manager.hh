@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <seastar/core/gate.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sharded.hh>
 
@@ -20,11 +21,13 @@
 #include "sstables/sstables.hh"
 #include "sstables/version.hh"
 #include "sstables/component_type.hh"
+#include "sstables/io_stats.hh"
 #include "db/cache_tracker.hh"
 #include "locator/host_id.hh"
 #include "reader_concurrency_semaphore.hh"
 
 #include <boost/intrusive/list.hpp>
+#include <unordered_map>
 
 namespace db {
 
@@ -46,6 +49,9 @@ class sstables_manager {
     using list_type = boost::intrusive::list<sstable,
             boost::intrusive::member_hook<sstable, sstable::manager_link_type, &sstable::_manager_link>,
             boost::intrusive::constant_time_size<false>>;
+    using filter_lru_type = boost::intrusive::list<sstable,
+            boost::intrusive::member_hook<sstable, sstable::filter_lru_link_type, &sstable::_filter_lru_link>,
+            boost::intrusive::constant_time_size<false>>;
 private:
     db::large_data_handler& _large_data_handler;
     const db::config& _db_config;
@@ -69,6 +75,23 @@ class sstables_manager {
     cache_tracker& _cache_tracker;
 
     reader_concurrency_semaphore _sstable_metadata_concurrency_sem;
+
+    // Disk I/O on the sstables of each table, see get_io_stats().
+    std::unordered_map<table_id, lw_shared_ptr<io_stats>> _io_stats;
+
+    // Memory budget of the bloom filters of the sstables open for reading
+    // on this shard. Above it, the filters of the least recently read
+    // sstables are evicted. When memory is freed, evicted filters which were
+    // read since are reloaded in the background.
+    size_t _filter_memory_limit;
+    size_t _filter_memory = 0;
+    // Sstables with a loaded filter which can be evicted, the least recently
+    // read first.
+    filter_lru_type _loaded_filters;
+    // Sstables with an evicted filter. Those read since the eviction are at
+    // the back, the most recently read last.
+    filter_lru_type _evicted_filters;
+    gate _filter_reloads;
 public:
     explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker&, size_t available_memory);
     virtual ~sstables_manager();
@@ -84,6 +107,8 @@ class sstables_manager {
             size_t buffer_size = default_sstable_buffer_size);
 
     virtual sstable_writer_config configure_writer(sstring origin) const;
+    // Read-ahead of readers which scan the data file to its end.
+    unsigned scan_read_ahead() const;
     const db::config& config() const { return _db_config; }
     cache_tracker& get_cache_tracker() { return _cache_tracker; }
 
@@ -94,6 +119,14 @@ class sstables_manager {
 
     reader_concurrency_semaphore& sstable_metadata_concurrency_sem() noexcept { return _sstable_metadata_concurrency_sem; }
 
+    // Returns the accounting of the disk I/O on the sstables of the table,
+    // created on first use. Sstables of the table made afterwards account
+    // their I/O in it.
+    lw_shared_ptr<io_stats> get_io_stats(table_id id);
+    // Called when the table is removed. Its sstables still alive keep
+    // accounting in the old object.
+    void remove_io_stats(table_id id) noexcept;
+
     // Wait until all sstables managed by this sstables_manager instance
     // (previously created by make_sstable()) have been disposed of:
     //   - if they were marked for deletion, the files are deleted
@@ -103,6 +136,12 @@ class sstables_manager {
     // Note that close() will not complete until all references to all
     // sstables have been destroyed.
     future<> close();
+
+    // Sets the memory budget of the bloom filters, evicting filters over it.
+    void set_filter_memory_limit(size_t limit);
+    size_t filter_memory() const noexcept {
+        return _filter_memory;
+    }
 private:
     void add(sstable* sst);
     // Transition the sstable to the "inactive" state. It has no
@@ -112,6 +151,14 @@ class sstables_manager {
     void remove(sstable* sst);
     void maybe_done();
 
+    // Called once the sstable's filter is loaded, on opening it for reading.
+    void on_filter_loaded(sstable& sst);
+    // Called when the filter of an sstable in one of the filter LRUs is read.
+    void on_filter_read(sstable& sst) noexcept;
+    void release_filter_memory(sstable& sst) noexcept;
+    void maybe_evict_filters();
+    void maybe_reload_filters();
+
     static constexpr size_t max_count_sstable_metadata_concurrent_reads{10};
     // Allow at most 10% of memory to be filled with such reads.
     size_t max_memory_sstable_metadata_concurrent_reads(size_t available_memory) { return available_memory * 0.1; }
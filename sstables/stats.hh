@@ -27,6 +27,7 @@ class sstables_stats {
         uint64_t range_partition_reads = 0;
         uint64_t partition_reads = 0;
         uint64_t partition_seeks = 0;
+        uint64_t coalesced_seeks = 0;
         uint64_t row_reads = 0;
         uint64_t capped_local_deletion_time = 0;
         uint64_t capped_tombstone_deletion_time = 0;
@@ -36,6 +37,9 @@ class sstables_stats {
         uint64_t closed_for_writing = 0;
         uint64_t deleted = 0;
         uint64_t promoted_index_auto_scale_events = 0;
+        uint64_t filter_evictions = 0;
+        uint64_t filter_reloads = 0;
+        uint64_t evicted_filter_memory = 0;
     } _shard_stats;
 
     stats& _stats = _shard_stats;
@@ -97,6 +101,10 @@ class sstables_stats {
         ++_stats.partition_seeks;
     }
 
+    inline void on_coalesced_seek() noexcept {
+        ++_stats.coalesced_seeks;
+    }
+
     inline void on_row_read() noexcept {
         ++_stats.row_reads;
     }
@@ -130,6 +138,19 @@ class sstables_stats {
     inline void on_promoted_index_auto_scale() noexcept {
         ++_stats.promoted_index_auto_scale_events;
     }
+
+    inline void on_filter_eviction(uint64_t memory) noexcept {
+        ++_stats.filter_evictions;
+        _stats.evicted_filter_memory += memory;
+    }
+    inline void on_filter_reload(uint64_t memory) noexcept {
+        ++_stats.filter_reloads;
+        _stats.evicted_filter_memory -= memory;
+    }
+    // The filter of an evicted sstable is gone with the sstable.
+    inline void on_evicted_filter_dropped(uint64_t memory) noexcept {
+        _stats.evicted_filter_memory -= memory;
+    }
 };
 
 }
@@ -486,7 +486,8 @@ enum sstable_feature : uint8_t {
     CorrectStaticCompact = 3, // See #4139
     CorrectEmptyCounters = 4, // See #4363
     CorrectUDTsInCollections = 5, // See #6130
-    End = 6,
+    PrefixCompressedPIEntries = 6, // End keys of promoted index blocks share a prefix with start keys
+    End = 7,
 };
 
 // Scylla-specific features enabled for a particular sstable.
@@ -529,6 +530,14 @@ enum class scylla_metadata_type : uint32_t {
     SSTableOrigin = 6,
     ScyllaBuildId = 7,
     ScyllaVersion = 8,
+    FilterLayout = 9,
+};
+
+// Layout of the bitmap stored in the Filter component.
+// Sstables without a FilterLayout entry use the classic layout.
+enum class filter_layout : uint8_t {
+    classic = 0,   // Cassandra-compatible, k independent probes
+    blocked = 1,   // utils::filter::blocked_bloom_filter
 };
 
 // UUID is used for uniqueness across nodes, such that an imported sstable
@@ -578,7 +587,8 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::LargeDataStats, large_data_stats>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaBuildId, scylla_build_id>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::FilterLayout, filter_layout>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -602,6 +612,10 @@ struct scylla_metadata {
         }
         return *ext;
     }
+    sstables::filter_layout get_filter_layout() const {
+        auto* l = data.get<scylla_metadata_type::FilterLayout, sstables::filter_layout>();
+        return l ? *l : sstables::filter_layout::classic;
+    }
     std::optional<run_id> get_optional_run_identifier() const {
         auto* m = data.get<scylla_metadata_type::RunIdentifier, run_identifier>();
         return m ? std::make_optional(m->id) : std::nullopt;
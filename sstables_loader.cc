@@ -8,6 +8,8 @@
 
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/core/queue.hh>
+#include <seastar/core/when_all.hh>
 #include <seastar/rpc/rpc.hh>
 #include "sstables_loader.hh"
 #include "replica/distributed_loader.hh"
@@ -16,9 +18,13 @@
 #include "gms/inet_address.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
 #include "streaming/stream_reason.hh"
+#include "streaming/consumer.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
+#include "readers/generating_v2.hh"
+#include "mutation_writer/multishard_writer.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "message/messaging_service.hh"
+#include "utils/fb_utilities.hh"
 
 #include <cfloat>
 
@@ -112,6 +118,68 @@ class send_meta_data {
     }
 };
 
+// Applies the fragments streamed to this node directly, the same way the
+// receiving side of the stream does, instead of sending them to itself
+// through the messaging service.
+class local_send_meta_data {
+    schema_ptr _schema;
+    reader_permit _permit;
+    seastar::queue<mutation_fragment_opt> _queue;
+    size_t _num_partitions_sent = 0;
+    size_t _num_bytes_sent = 0;
+    future<> _consume_done;
+public:
+    local_send_meta_data(schema_ptr s, reader_permit permit)
+        : _schema(std::move(s))
+        , _permit(std::move(permit))
+        , _queue(16)
+        , _consume_done(make_ready_future<>()) {
+    }
+    void consume(sharded<replica::database>& db, sharded<db::system_distributed_keyspace>& sys_dist_ks,
+            sharded<db::view::view_update_generator>& vug, uint64_t estimated_partitions, streaming::stream_reason reason) {
+        auto op = db.local().find_column_family(_schema->id()).stream_in_progress();
+        auto reader = make_generating_reader_v1(_schema, _permit, [this] {
+            return _queue.pop_eventually();
+        });
+        _consume_done = mutation_writer::distribute_reader_and_consume_on_shards(_schema, std::move(reader),
+                streaming::make_streaming_consumer("load_and_stream", db, sys_dist_ks, vug, estimated_partitions, reason, sstables::offstrategy::no),
+                std::move(op)).then_wrapped([this] (future<uint64_t> f) {
+            if (f.failed()) {
+                // Unblock the sender.
+                auto ex = f.get_exception();
+                _queue.abort(ex);
+                return make_exception_future<>(std::move(ex));
+            }
+            return make_ready_future<>();
+        });
+    }
+    future<> send(const mutation_fragment& mf, bool is_partition_start) {
+        if (is_partition_start) {
+            ++_num_partitions_sent;
+        }
+        _num_bytes_sent += mf.memory_usage();
+        return _queue.push_eventually(mutation_fragment(*_schema, _permit, mf));
+    }
+    future<> finish(bool failed) {
+        if (failed) {
+            _queue.abort(std::make_exception_ptr(std::runtime_error("load_and_stream: sender failed")));
+        } else {
+            try {
+                co_await _queue.push_eventually(mutation_fragment_opt());
+            } catch (...) {
+                // The consumer failed, its error is reported below.
+            }
+        }
+        co_await std::move(_consume_done);
+    }
+    size_t num_partitions_sent() {
+        return _num_partitions_sent;
+    }
+    size_t num_bytes_sent() {
+        return _num_bytes_sent;
+    }
+};
+
 } // anonymous namespace
 
 future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
@@ -148,10 +216,13 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
         auto start_time = std::chrono::steady_clock::now();
         inet_address_vector_replica_set current_targets;
         std::unordered_map<gms::inet_address, send_meta_data> metas;
+        std::optional<local_send_meta_data> local_meta;
+        bool current_target_is_local = false;
         size_t num_partitions_processed = 0;
         size_t num_bytes_read = 0;
         nr_sst_current += sst_processed.size();
         auto permit = co_await _db.local().obtain_reader_permit(table, "sstables_loader::load_and_stream()", db::no_timeout);
+        auto local_permit = permit;
         auto reader = mutation_fragment_v1_stream(table.make_streaming_reader(s, std::move(permit), full_partition_range, sst_set));
         std::exception_ptr eptr;
         bool failed = false;
@@ -170,6 +241,16 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
                     }
                     llog.trace("load_and_stream: ops_uuid={}, current_dk={}, current_targets={}", ops_uuid,
                             current_dk.token(), current_targets);
+                    auto local = std::find(current_targets.begin(), current_targets.end(), utils::fb_utilities::get_broadcast_address());
+                    current_target_is_local = local != current_targets.end();
+                    if (current_target_is_local) {
+                        current_targets.erase(local);
+                        if (!local_meta) {
+                            llog.debug("load_and_stream: ops_uuid={}, apply locally", ops_uuid);
+                            local_meta.emplace(s, local_permit);
+                            local_meta->consume(_db, _sys_dist_ks, _view_update_generator, estimated_partitions, reason);
+                        }
+                    }
                     for (auto& node : current_targets) {
                         if (!metas.contains(node)) {
                             auto [sink, source] = co_await ms.make_sink_and_source_for_stream_mutation_fragments(reader.schema()->version(),
@@ -180,6 +261,13 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
                         }
                     }
                 }
+                if (current_target_is_local) {
+                    co_await local_meta->send(*mf, is_partition_start);
+                }
+                if (current_targets.empty()) {
+                    num_bytes_read += mf->memory_usage();
+                    continue;
+                }
                 frozen_mutation_fragment fmf = freeze(*s, *mf);
                 num_bytes_read += fmf.representation().size();
                 co_await coroutine::parallel_for_each(current_targets, [&metas, &fmf, is_partition_start] (const gms::inet_address& node) {
@@ -194,10 +282,12 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
         }
         co_await reader.close();
         try {
-            co_await coroutine::parallel_for_each(metas.begin(), metas.end(), [failed] (std::pair<const gms::inet_address, send_meta_data>& pair) {
-                auto& meta = pair.second;
-                return meta.finish(failed);
-            });
+            co_await when_all_succeed(
+                    local_meta ? local_meta->finish(failed) : make_ready_future<>(),
+                    parallel_for_each(metas, [failed] (std::pair<const gms::inet_address, send_meta_data>& pair) {
+                        auto& meta = pair.second;
+                        return meta.finish(failed);
+                    })).discard_result();
         } catch (...) {
             failed = true;
             eptr = std::current_exception();
@@ -223,6 +313,10 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
             llog.info("load_and_stream: ops_uuid={}, ks={}, table={}, target_node={}, num_partitions_sent={}, num_bytes_sent={}",
                     ops_uuid, ks_name, cf_name, node, meta.num_partitions_sent(), meta.num_bytes_sent());
         }
+        if (local_meta) {
+            llog.info("load_and_stream: ops_uuid={}, ks={}, table={}, target_node={} (local), num_partitions_sent={}, num_bytes_sent={}",
+                    ops_uuid, ks_name, cf_name, utils::fb_utilities::get_broadcast_address(), local_meta->num_partitions_sent(), local_meta->num_bytes_sent());
+        }
         auto partition_rate = std::fabs(duration) > FLT_EPSILON ? num_partitions_processed / duration : 0;
         auto bytes_rate = std::fabs(duration) > FLT_EPSILON ? num_bytes_read / duration / 1024 / 1024 : 0;
         auto status = failed ? "failed" : "succeeded";
@@ -267,6 +267,19 @@ def test_batch_get_item_hash(test_table_s):
     got_items = reply['Responses'][test_table_s.name]
     assert multiset(got_items) == multiset(items)
 
+# Same, with many keys of a hash-only table. Scylla reads the keys owned by
+# the same replicas together, so check that no item is lost or duplicated
+# when many keys go to the same replica set, some of them missing.
+def test_batch_get_item_hash_many(test_table_s):
+    items = [{'p': random_string(), 'val': random_string()} for i in range(100)]
+    with test_table_s.batch_writer() as batch:
+        for item in items:
+            batch.put_item(item)
+    keys = [{'p': x['p']} for x in items] + [{'p': random_string()} for i in range(10)]
+    reply = test_table_s.meta.client.batch_get_item(RequestItems = {test_table_s.name: {'Keys': keys, 'ConsistentRead': True}})
+    got_items = reply['Responses'][test_table_s.name]
+    assert multiset(got_items) == multiset(items)
+
 # Test what do we get if we try to read two *missing* values in addition to
 # an existing one. It turns out the missing items are simply not returned,
 # with no sign they are missing.
@@ -227,6 +227,28 @@ def test_total_operations(dynamodb, metrics):
     with check_increases_metric(metrics, ['scylla_alternator_total_operations']):
         dynamodb.meta.client.describe_endpoints()
 
+# Test that when writes which don't need to read the item use LWT, repeated
+# writes to the same item skip the Paxos prepare phase, as the coordinator
+# holds a ballot lease on the key after the first write. Writes use LWT only
+# in the "always_use_lwt" write isolation mode, which test/alternator/run
+# uses, so the test is skipped if they didn't.
+def test_lwt_prepare_skipped(test_table_s, metrics):
+    the_metrics = get_metrics(metrics)
+    saved_lwt = get_metric(metrics, 'scylla_alternator_write_using_lwt', None, the_metrics)
+    saved_skipped = get_metric(metrics, 'scylla_storage_proxy_coordinator_cas_prepare_skipped', None, the_metrics)
+    saved_skip_failed = get_metric(metrics, 'scylla_storage_proxy_coordinator_cas_prepare_skip_failed', None, the_metrics)
+    p = random_string()
+    for i in range(3):
+        test_table_s.put_item(Item={'p': p, 'a': i})
+    the_metrics = get_metrics(metrics)
+    if get_metric(metrics, 'scylla_alternator_write_using_lwt', None, the_metrics) == saved_lwt:
+        pytest.skip('writes do not use LWT')
+    assert saved_skipped < get_metric(metrics, 'scylla_storage_proxy_coordinator_cas_prepare_skipped', None, the_metrics)
+    # Nobody else writes the item, so the lease is never lost: the pruning of
+    # the decisions learned by all replicas mustn't make them reject the proposals.
+    assert saved_skip_failed == get_metric(metrics, 'scylla_storage_proxy_coordinator_cas_prepare_skip_failed', None, the_metrics)
+    assert test_table_s.get_item(Key={'p': p}, ConsistentRead=True)['Item'] == {'p': p, 'a': 2}
+
 # A fixture to read alternator-ttl-period-in-seconds from Scylla's
 # configuration. If we're testing something which isn't Scylla, or
 # this configuration does not exist, skip this test. If the configuration
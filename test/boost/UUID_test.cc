@@ -129,6 +129,23 @@ BOOST_AUTO_TEST_CASE(test_timeuuid_msb_is_monotonic) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_batched_time_uuids_are_unique_and_monotonic) {
+    using utils::UUID, utils::UUID_gen;
+    auto before = UUID_gen::get_time_UUID();
+    std::vector<UUID> uuids(1000);
+    UUID_gen::get_time_UUIDs(uuids);
+    auto after = UUID_gen::get_time_UUID();
+
+    auto prev = before;
+    for (auto& uuid : uuids) {
+        BOOST_REQUIRE(uuid.is_timestamp());
+        BOOST_REQUIRE_EQUAL(uuid.get_least_significant_bits(), before.get_least_significant_bits());
+        BOOST_REQUIRE_LT(prev.timestamp(), uuid.timestamp());
+        prev = uuid;
+    }
+    BOOST_REQUIRE_LT(prev.timestamp(), after.timestamp());
+}
+
 BOOST_AUTO_TEST_CASE(test_timeuuid_tri_compare_legacy) {
     using utils::UUID, utils::UUID_gen;
     auto uuid = UUID_gen::get_time_UUID();
@@ -24,6 +24,8 @@
 #include "types/set.hh"
 
 #include "db/config.hh"
+#include "cql3/functions/functions.hh"
+#include "cql3/functions/aggregate_function.hh"
 
 namespace {
 
@@ -272,3 +274,37 @@ SEASTAR_TEST_CASE(test_minmax_on_set) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_aggregate_input_batch) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        auto sf = cql_serialization_format::latest();
+        auto check = [&] (const sstring& name, data_type type, std::vector<data_value> values) {
+            auto func = cql3::functions::functions::find(db::functions::function_name::native_function(name), {type});
+            auto aggr = dynamic_pointer_cast<db::functions::aggregate_function>(func);
+            BOOST_REQUIRE(aggr);
+            for (auto&& f : {aggr, aggr->reducible_aggregate_function()}) {
+                auto by_row = f->new_aggregate();
+                auto by_batch = f->new_aggregate();
+                db::functions::argument_batch batch;
+                for (auto& v : values) {
+                    auto b = v.is_null() ? bytes_opt() : bytes_opt(v.serialize_nonnull());
+                    by_row->add_input(sf, {b});
+                    if (b) {
+                        batch.push_back(std::array<bytes_view, 1>{bytes_view(*b)});
+                    } else {
+                        batch.push_null();
+                    }
+                }
+                by_batch->add_input_batch(sf, batch);
+                BOOST_REQUIRE(by_batch->compute(sf) == by_row->compute(sf));
+            }
+        };
+        for (auto name : {"sum", "avg", "min", "max", "count"}) {
+            check(name, int32_type, {data_value(int32_t(3)), data_value::make_null(int32_type), data_value(int32_t(-7)), data_value(int32_t(12))});
+            check(name, long_type, {data_value(std::numeric_limits<int64_t>::max()), data_value(int64_t(1)), data_value(int64_t(-5))});
+            check(name, double_type, {data_value(1.5), data_value(-0.25), data_value::make_null(double_type)});
+            check(name, decimal_type, {decimal_type->deserialize(decimal_type->from_string("1.50")), decimal_type->deserialize(decimal_type->from_string("-2"))});
+            check(name, int32_type, {});
+        }
+    });
+}
@@ -157,6 +157,41 @@ SEASTAR_TEST_CASE(test_password_authenticator_operations) {
     }, cfg);
 }
 
+SEASTAR_TEST_CASE(test_password_authenticator_remembers_verified_passwords) {
+    auto cfg = make_shared<db::config>();
+    cfg->authenticator(sstring(auth::password_authenticator_name));
+
+    return do_with_cql_env_thread([] (cql_test_env& env) {
+        auto& a = dynamic_cast<const auth::password_authenticator&>(env.local_auth_service().underlying_authenticator());
+        auth::role_config config {
+            .can_login = true,
+        };
+        auth::create_role(env.local_auth_service(), "user1", config, auth::authentication_options{.password = "pass1"}).get();
+        auto stats = a.get_stats();
+
+        authenticate(env, "user1", "pass1").get();
+        BOOST_REQUIRE_EQUAL(a.get_stats().password_hashes, stats.password_hashes + 1);
+        authenticate(env, "user1", "pass1").get();
+        BOOST_REQUIRE_EQUAL(a.get_stats().password_hashes, stats.password_hashes + 1);
+        BOOST_REQUIRE_EQUAL(a.get_stats().verified_password_hits, stats.verified_password_hits + 1);
+
+        // A wrong password is never accepted from the verified ones.
+        require_throws<exceptions::authentication_exception>(authenticate(env, "user1", "pass2")).get();
+        BOOST_REQUIRE_EQUAL(a.get_stats().password_hashes, stats.password_hashes + 2);
+
+        authenticate(env, "user1", "pass1").get();
+        BOOST_REQUIRE_EQUAL(a.get_stats().password_hashes, stats.password_hashes + 3);
+
+        // Changing the password invalidates the verified one.
+        auth::alter_role(env.local_auth_service(), "user1", auth::role_config_update{}, auth::authentication_options{.password = "pass2"}).get();
+        require_throws<exceptions::authentication_exception>(authenticate(env, "user1", "pass1")).get();
+        BOOST_REQUIRE_EQUAL(a.get_stats().password_hashes, stats.password_hashes + 4);
+        authenticate(env, "user1", "pass2").get();
+        BOOST_REQUIRE_EQUAL(a.get_stats().password_hashes, stats.password_hashes + 5);
+        BOOST_REQUIRE_EQUAL(a.get_stats().verified_password_hits, stats.verified_password_hits + 1);
+    }, cfg);
+}
+
 namespace {
 
 /// Asserts that table is protected from alterations that can brick a node.
@@ -10,6 +10,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include "utils/big_decimal.hh"
+#include "utils/big_number_accumulator.hh"
 #include "marshal_exception.hh"
 
 namespace {
@@ -203,3 +204,66 @@ BOOST_AUTO_TEST_CASE(test_big_decimal_sub) {
     test_sub("9999999999999999999999999999999999999", "-1.000e0", "10000000000000000000000000000000000000.000");
     test_sub("+10.", "1.e+1", "0");
 }
+
+BOOST_AUTO_TEST_CASE(test_decimal_accumulator) {
+    auto check = [] (std::vector<const char*> values) {
+        utils::decimal_accumulator acc;
+        big_decimal expected;
+        for (auto v : values) {
+            acc += big_decimal(v);
+            expected += big_decimal(v);
+            auto ret = acc.get();
+            BOOST_REQUIRE_EQUAL(ret.unscaled_value(), expected.unscaled_value());
+            BOOST_REQUIRE_EQUAL(ret.scale(), expected.scale());
+        }
+    };
+    check({"1", "4", "-3"});
+    check({"1.00", "4.000", "-3.0", "1e3", "-1e-5"});
+    // Sums which don't fit 128 bits move to big_decimal and stay correct.
+    check({"99999999999999999999999999999999999999", "99999999999999999999999999999999999999", "-1", "0.5"});
+    check({"-99999999999999999999999999999999999999", "-99999999999999999999999999999999999999"});
+    check({"1", "1e-40", "2"});
+    check({"123456789012345678901234567890123456789012345", "1"});
+}
+
+BOOST_AUTO_TEST_CASE(test_decimal_accumulator_serialized) {
+    auto serialize = [] (int32_t scale, std::vector<int8_t> unscaled) {
+        bytes b(bytes::initialized_later(), sizeof(int32_t) + unscaled.size());
+        write_be(reinterpret_cast<char*>(b.begin()), scale);
+        std::copy(unscaled.begin(), unscaled.end(), b.begin() + sizeof(int32_t));
+        return b;
+    };
+    utils::decimal_accumulator acc;
+    BOOST_REQUIRE(acc.add_serialized(serialize(2, {0x01, 0x00})));   // 2.56
+    BOOST_REQUIRE(acc.add_serialized(serialize(1, {-1})));           // -0.1
+    BOOST_REQUIRE(!acc.add_serialized(bytes()));
+    BOOST_REQUIRE(!acc.add_serialized(serialize(0, std::vector<int8_t>(17, 1))));
+    BOOST_REQUIRE_EQUAL(acc.get(), big_decimal("2.46"));
+    BOOST_REQUIRE_EQUAL(acc.get().scale(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_varint_accumulator) {
+    utils::varint_accumulator acc;
+    utils::multiprecision_int expected;
+    auto add = [&] (const char* v) {
+        acc += utils::multiprecision_int(v);
+        expected += utils::multiprecision_int(v);
+        BOOST_REQUIRE_EQUAL(acc.get(), expected);
+    };
+    add("1");
+    add("-170141183460469231731687303715884105727");
+    add("-170141183460469231731687303715884105727");
+    add("170141183460469231731687303715884105727");
+    add("123456789012345678901234567890123456789012345");
+    add("-5");
+
+    bytes minus_256{int8_t(-1), int8_t(0)};
+    BOOST_REQUIRE(acc.add_serialized(minus_256));
+    expected -= 256;
+    BOOST_REQUIRE_EQUAL(acc.get(), expected);
+
+    utils::varint_accumulator other(utils::multiprecision_int("1000"));
+    acc += other;
+    expected += 1000;
+    BOOST_REQUIRE_EQUAL(acc.get(), expected);
+}
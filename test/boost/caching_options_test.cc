@@ -34,4 +34,20 @@ BOOST_AUTO_TEST_CASE(test_caching_options) {
         sstring in_str = "{\"keys\": \"NONE, }";
         BOOST_REQUIRE_THROW(caching_options::from_sstring(in_str), std::exception);
     }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "FREQUENT"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(co.admit_frequent_only());
+        BOOST_REQUIRE(in_map == co.to_map());
+    }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "ALL"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(!co.admit_frequent_only());
+        BOOST_REQUIRE(co == caching_options::from_map({ {"keys", "ALL"}, {"rows_per_partition", "ALL"}}));
+    }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "SOME"}};
+        BOOST_REQUIRE_THROW(caching_options::from_map(in_map), std::exception);
+    }
 }
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "cdc/generation.hh"
+#include "locator/token_index.hh"
 #include "test/lib/random_utils.hh"
 
 namespace cdc {
@@ -72,12 +73,22 @@ static void assert_stream_ids_in_right_token_ranges(const cdc::topology_descript
 }
 
 cdc::stream_id get_stream(const std::vector<cdc::token_range_description>& entries, dht::token tok);
+cdc::stream_id get_stream(const std::vector<cdc::token_range_description>& entries, const locator::token_index& index, dht::token tok);
 
 static void assert_random_tokens_mapped_to_streams_with_tokens_in_the_same_token_range(const cdc::topology_description& desc) {
+    std::vector<dht::token> ends;
+    for (auto& e : desc.entries()) {
+        ends.push_back(e.token_range_end);
+    }
+    locator::token_index index(ends);
+    for (auto& t : ends) {
+        BOOST_REQUIRE(get_stream(desc.entries(), index, t) == get_stream(desc.entries(), t));
+    }
     for (size_t count = 0; count < 100; ++count) {
         int64_t token_value = tests::random::get_int(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
         dht::token t = dht::token::from_int64(token_value);
         auto stream = get_stream(desc.entries(), t);
+        BOOST_REQUIRE(get_stream(desc.entries(), index, t) == stream);
         auto& e = desc.entries().at(stream.index());
         BOOST_REQUIRE(std::find(e.streams.begin(), e.streams.end(), stream) != e.streams.end());
         if (stream.index() != 0) {
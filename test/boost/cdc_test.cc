@@ -14,6 +14,7 @@
 #include "cdc/log.hh"
 #include "cdc/cdc_extension.hh"
 #include "db/config.hh"
+#include "replica/database.hh"
 #include "schema_builder.hh"
 #include "test/lib/cql_assertions.hh"
 #include "test/lib/cql_test_env.hh"
@@ -683,6 +684,45 @@ SEASTAR_THREAD_TEST_CASE(test_pre_post_image_logging_static_row) {
     }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_preimage_from_cache) {
+    do_with_cql_env_thread([](cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE ks.tbl (pk int, ck int, val int, PRIMARY KEY(pk, ck)) "
+                "WITH cdc = {'enabled':'true', 'preimage':'true', 'postimage':'true', 'preimage_source':'cache'}");
+        cquery_nofail(e, "INSERT INTO ks.tbl (pk, ck, val) VALUES (1, 1, 1)");
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 2 WHERE pk = 1 AND ck = 1");
+
+        auto rows = select_log(e, "tbl");
+        auto val_index = column_index(*rows, cdc::log_data_column_name("val"));
+        auto pre_image = to_bytes_filtered(*rows, cdc::operation::pre_image);
+        BOOST_REQUIRE_EQUAL(pre_image.size(), 1);
+        BOOST_REQUIRE_EQUAL(pre_image[0][val_index], int32_type->decompose(1));
+        BOOST_REQUIRE(to_bytes_filtered(*rows, cdc::operation::pre_image_unknown).empty());
+        BOOST_REQUIRE_EQUAL(to_bytes_filtered(*rows, cdc::operation::post_image).size(), 2);
+
+        // Drop the row from memory, so that its preimage can't be read without reading sstables.
+        auto& t = e.local_db().find_column_family("ks", "tbl");
+        t.flush().get();
+        t.get_row_cache().invalidate(row_cache::external_updater([] {})).get();
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 3 WHERE pk = 1 AND ck = 1");
+
+        rows = select_log(e, "tbl");
+        BOOST_REQUIRE_EQUAL(to_bytes_filtered(*rows, cdc::operation::pre_image).size(), 1);
+        BOOST_REQUIRE_EQUAL(to_bytes_filtered(*rows, cdc::operation::pre_image_unknown).size(), 1);
+        BOOST_REQUIRE_EQUAL(to_bytes_filtered(*rows, cdc::operation::post_image).size(), 2);
+
+        // Reading the row brings it back to cache.
+        cquery_nofail(e, "SELECT * FROM ks.tbl WHERE pk = 1 AND ck = 1");
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 4 WHERE pk = 1 AND ck = 1");
+
+        rows = select_log(e, "tbl");
+        pre_image = to_bytes_filtered(*rows, cdc::operation::pre_image);
+        sort_by_time(*rows, pre_image);
+        BOOST_REQUIRE_EQUAL(pre_image.size(), 2);
+        BOOST_REQUIRE_EQUAL(pre_image.back()[val_index], int32_type->decompose(3));
+        BOOST_REQUIRE_EQUAL(to_bytes_filtered(*rows, cdc::operation::post_image).size(), 3);
+    }).get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_range_deletion) {
     do_with_cql_env_thread([](cql_test_env& e) {
         cquery_nofail(e, "CREATE TABLE ks.tbl (pk int, ck int, val int, PRIMARY KEY(pk, ck)) WITH cdc = {'enabled':'true'}");
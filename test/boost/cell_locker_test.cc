@@ -130,6 +130,38 @@ SEASTAR_TEST_CASE(test_disjoint_mutations) {
     });
 }
 
+SEASTAR_TEST_CASE(test_reused_partition_entries) {
+    return seastar::async([&] {
+        auto destroy = [] (auto) { };
+
+        auto s = make_schema();
+        cell_locker_stats cl_stats;
+        cell_locker cl(s, cl_stats);
+
+        auto m1 = make_mutation(s, "0", { "s1" }, {
+                make_row("one", { "r1", "r2" }),
+        });
+        auto m2 = make_mutation(s, "1", { "s1" }, {
+                make_row("one", { "r1", "r2" }),
+        });
+
+        // Entries of unlocked partitions are reused for other partitions,
+        // which must not see cells of the previous one.
+        for (int i = 0; i < 3; i++) {
+            auto l1 = cl.lock_cells(m1.decorated_key(), partition_cells_range(m1.partition()), no_timeout).get0();
+            destroy(std::move(l1));
+            auto l2 = cl.lock_cells(m2.decorated_key(), partition_cells_range(m2.partition()), no_timeout).get0();
+            auto f1 = cl.lock_cells(m1.decorated_key(), partition_cells_range(m1.partition()), no_timeout);
+            BOOST_REQUIRE(f1.available());
+            auto f2 = cl.lock_cells(m2.decorated_key(), partition_cells_range(m2.partition()), no_timeout);
+            BOOST_REQUIRE(!f2.available());
+            destroy(f1.get0());
+            destroy(std::move(l2));
+            destroy(f2.get0());
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_single_cell_overlap) {
     return seastar::async([&] {
         auto destroy = [] (auto) { };
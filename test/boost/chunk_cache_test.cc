@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/random_utils.hh"
+
+#include "sstables/chunk_cache.hh"
+
+using namespace seastar;
+
+static lru cc_lru;
+
+static temporary_buffer<char> make_chunk(const sstring& contents) {
+    return temporary_buffer<char>(contents.data(), contents.size());
+}
+
+static sstring to_sstring(const temporary_buffer<char>& buf) {
+    return sstring(buf.get(), buf.size());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hits_and_misses) {
+    sstables::chunk_cache::metrics metrics;
+    logalloc::region region;
+    sstables::chunk_cache cc(metrics, cc_lru, region);
+
+    auto c0 = tests::random::get_sstring(4096);
+    auto c1 = tests::random::get_sstring(1000);
+
+    BOOST_REQUIRE(!cc.get(0));
+    BOOST_REQUIRE_EQUAL(1, metrics.misses);
+
+    cc.put(0, make_chunk(c0));
+    cc.put(4100, make_chunk(c1));
+    BOOST_REQUIRE_EQUAL(2, metrics.populations);
+    BOOST_REQUIRE_EQUAL(c0.size() + c1.size(), metrics.cached_bytes);
+    BOOST_REQUIRE_EQUAL(c0.size() + c1.size(), cc.cached_bytes());
+
+    BOOST_REQUIRE_EQUAL(c0, to_sstring(cc.get(0)));
+    BOOST_REQUIRE_EQUAL(c1, to_sstring(cc.get(4100)));
+    BOOST_REQUIRE(!cc.get(4096));
+    BOOST_REQUIRE_EQUAL(2, metrics.hits);
+    BOOST_REQUIRE_EQUAL(2, metrics.misses);
+
+    // Re-inserting a cached chunk is a no-op.
+    cc.put(0, make_chunk(c1));
+    BOOST_REQUIRE_EQUAL(2, metrics.populations);
+    BOOST_REQUIRE_EQUAL(c0, to_sstring(cc.get(0)));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_eviction_via_lru) {
+    sstables::chunk_cache::metrics metrics;
+    logalloc::region region;
+
+    {
+        sstables::chunk_cache cc(metrics, cc_lru, region);
+        for (uint64_t i = 0; i < 3; ++i) {
+            cc.put(i * 100, make_chunk(tests::random::get_sstring(100)));
+        }
+
+        // The chunk which is hit is evicted last.
+        BOOST_REQUIRE(cc.get(0));
+        with_allocator(region.allocator(), [] {
+            cc_lru.evict();
+        });
+        BOOST_REQUIRE_EQUAL(1, metrics.evictions);
+        BOOST_REQUIRE(!cc.get(100));
+        BOOST_REQUIRE(cc.get(0));
+        BOOST_REQUIRE(cc.get(200));
+
+        with_allocator(region.allocator(), [] {
+            cc_lru.evict_all();
+        });
+        BOOST_REQUIRE_EQUAL(3, metrics.evictions);
+        BOOST_REQUIRE_EQUAL(0, metrics.cached_bytes);
+        BOOST_REQUIRE_EQUAL(0, cc.cached_bytes());
+        BOOST_REQUIRE_EQUAL(region.occupancy().used_space(), 0);
+
+        cc.put(0, make_chunk(tests::random::get_sstring(100)));
+    }
+
+    // Destruction drops the remaining chunks.
+    BOOST_REQUIRE_EQUAL(4, metrics.evictions);
+    BOOST_REQUIRE_EQUAL(0, metrics.cached_bytes);
+    BOOST_REQUIRE_EQUAL(region.occupancy().used_space(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hit_chunk_survives_scan) {
+    sstables::chunk_cache::metrics metrics;
+    logalloc::region region;
+    sstables::chunk_cache cc(metrics, cc_lru, region);
+
+    cc.put(0, make_chunk(tests::random::get_sstring(100)));
+    BOOST_REQUIRE(cc.get(0));
+
+    // Chunks which are only inserted are evicted before the one which was hit,
+    // even though they were inserted later.
+    for (uint64_t i = 1; i < 4; ++i) {
+        cc.put(i * 100, make_chunk(tests::random::get_sstring(100)));
+    }
+    with_allocator(region.allocator(), [] {
+        for (int i = 0; i < 3; ++i) {
+            cc_lru.evict();
+        }
+    });
+    BOOST_REQUIRE_EQUAL(3, metrics.evictions);
+    BOOST_REQUIRE(!cc.get(100));
+    BOOST_REQUIRE(!cc.get(200));
+    BOOST_REQUIRE(!cc.get(300));
+    BOOST_REQUIRE(cc.get(0));
+
+    with_allocator(region.allocator(), [] {
+        cc_lru.evict_all();
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_protected_segment_is_bounded) {
+    lru l;
+    l.set_max_protected_size(2);
+    sstables::chunk_cache::metrics metrics;
+    logalloc::region region;
+    sstables::chunk_cache cc(metrics, l, region);
+
+    for (uint64_t i = 0; i < 3; ++i) {
+        cc.put(i * 100, make_chunk(tests::random::get_sstring(100)));
+        BOOST_REQUIRE(cc.get(i * 100));
+    }
+    // Hits on chunks which are already protected are not promotions.
+    BOOST_REQUIRE(cc.get(100));
+    BOOST_REQUIRE(cc.get(200));
+    BOOST_REQUIRE_EQUAL(3, l.get_stats().promotions);
+    BOOST_REQUIRE_EQUAL(1, l.get_stats().demotions);
+    BOOST_REQUIRE_EQUAL(2, l.protected_size());
+
+    // The demoted chunk is evicted first.
+    with_allocator(region.allocator(), [&] {
+        l.evict();
+    });
+    BOOST_REQUIRE_EQUAL(1, l.get_stats().probation_evictions);
+    BOOST_REQUIRE(!cc.get(0));
+    BOOST_REQUIRE(cc.get(100));
+    BOOST_REQUIRE(cc.get(200));
+
+    with_allocator(region.allocator(), [&] {
+        l.evict_all();
+    });
+    BOOST_REQUIRE_EQUAL(2, l.get_stats().protected_evictions);
+    BOOST_REQUIRE_EQUAL(0, l.protected_size());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_evict_gently) {
+    sstables::chunk_cache::metrics metrics;
+    logalloc::region region;
+    sstables::chunk_cache cc(metrics, cc_lru, region);
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        cc.put(i, make_chunk(tests::random::get_sstring(64)));
+    }
+    cc.evict_gently().get();
+    BOOST_REQUIRE_EQUAL(1000, metrics.evictions);
+    BOOST_REQUIRE_EQUAL(0, cc.cached_bytes());
+    BOOST_REQUIRE(!cc.get(0));
+}
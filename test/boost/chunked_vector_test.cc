@@ -242,3 +242,23 @@ BOOST_AUTO_TEST_CASE(test_amoritzed_reserve) {
     amortized_reserve(v, 1);
     BOOST_REQUIRE_EQUAL(v.capacity(), 8);
 }
+
+BOOST_AUTO_TEST_CASE(test_chunks_are_recycled_through_the_fragment_pool) {
+    using vector_type = utils::chunked_vector<uint64_t>;
+    const auto n = vector_type::max_chunk_capacity() * 2;
+    {
+        vector_type v;
+        v.reserve(n);
+    }
+    const auto hits = utils::fragment_pool::get_stats().hits;
+    BOOST_REQUIRE_GT(utils::fragment_pool::get_stats().cached_bytes, 0);
+    {
+        vector_type v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(i);
+        }
+        BOOST_REQUIRE_EQUAL(v[n - 1], n - 1);
+    }
+    BOOST_REQUIRE_EQUAL(utils::fragment_pool::get_stats().hits, hits + 2);
+}
@@ -9,6 +9,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 
 #include <stdlib.h>
 #include <iostream>
@@ -102,6 +103,29 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// check that concurrent writes in group mode are all flushed, sharing flushes
+SEASTAR_TEST_CASE(test_commitlog_written_to_disk_group){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::GROUP;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        constexpr size_t writes = 100;
+        sstring tmp = "hej bubba cow";
+        auto uuid = make_table_id();
+        for (int round = 0; round < 3; ++round) {
+            co_await parallel_for_each(boost::irange<size_t>(0, writes), [&] (size_t) {
+                return log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [tmp](db::commitlog::output& dst) {
+                    dst.write(tmp.data(), tmp.size());
+                }).then([] (replay_position rp) {
+                    BOOST_CHECK_NE(rp, db::replay_position());
+                });
+            });
+        }
+        auto n = log.get_flush_count();
+        BOOST_REQUIRE(n > 0);
+        BOOST_REQUIRE(n < 3 * writes);
+    });
+}
+
 // check that an entry marked as sync is immediately flushed to a storage
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_sync){
     commitlog::config cfg;
@@ -174,6 +198,36 @@ SEASTAR_TEST_CASE(test_commitlog_new_segment){
     });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_extra_locations){
+    auto extra = make_lw_shared<tmpdir>();
+    commitlog::config cfg;
+    cfg.commitlog_segment_size_in_mb = 1;
+    cfg.extra_commit_log_locations.push_back(extra->path().string());
+    return cl_test(cfg, [extra](commitlog& log) {
+        return seastar::async([&log, extra] {
+            rp_set set;
+            auto uuid = make_table_id();
+            while (set.size() < 4) {
+                sstring tmp = "hej bubba cow";
+                set.put(log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [tmp](db::commitlog::output& dst) {
+                    dst.write(tmp.data(), tmp.size());
+                }).get0());
+            }
+            auto names = log.get_active_segment_names();
+            auto in_extra = std::count_if(names.begin(), names.end(), [&] (const sstring& name) {
+                return std::filesystem::path(name).parent_path() == extra->path();
+            });
+            BOOST_REQUIRE_GT(in_extra, 0);
+            BOOST_REQUIRE_LT(size_t(in_extra), names.size());
+
+            auto existing = log.list_existing_segments().get0();
+            for (auto& name : names) {
+                BOOST_REQUIRE(std::find(existing.begin(), existing.end(), name) != existing.end());
+            }
+        });
+    }).finally([extra] {});
+}
+
 typedef std::vector<sstring> segment_names;
 
 static segment_names segment_diff(commitlog& log, segment_names prev = {}) {
@@ -416,6 +470,88 @@ SEASTAR_TEST_CASE(test_commitlog_reader){
         });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_compressed_reader) {
+    commitlog::config cfg;
+    cfg.use_compression = true;
+    return cl_test(cfg, [](commitlog& log) {
+        return seastar::async([&] {
+            constexpr size_t n = 1000;
+            const sstring value(1000, 'x');
+            auto uuid = make_table_id();
+            rp_set set;
+            std::vector<replay_position> rps;
+            for (size_t i = 0; i < n; ++i) {
+                auto h = log.add_mutation(uuid, value.size(), db::commitlog::force_sync::no, [&](db::commitlog::output& dst) {
+                    dst.write(value.data(), value.size());
+                }).get0();
+                rps.emplace_back(h.rp());
+                set.put(std::move(h));
+            }
+            log.sync_all_segments().get();
+            BOOST_REQUIRE_LT(log.get_total_size(), n * value.size() / 2);
+
+            std::vector<replay_position> result;
+            for (auto& seg : log.get_active_segment_names()) {
+                commitlog::descriptor desc(seg, db::commitlog::descriptor::FILENAME_PREFIX);
+                BOOST_REQUIRE_EQUAL(desc.ver, db::commitlog::descriptor::segment_version_3);
+                db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&](db::commitlog::buffer_and_replay_position buf_rp) {
+                    auto&& [buf, rp] = buf_rp;
+                    auto linearization_buffer = bytes_ostream();
+                    auto in = buf.get_istream();
+                    BOOST_REQUIRE_EQUAL(to_sstring_view(in.read_bytes_view(buf.size_bytes(), linearization_buffer)), value);
+                    result.emplace_back(rp);
+                    return make_ready_future<>();
+                }).get();
+            }
+            std::sort(result.begin(), result.end());
+            BOOST_REQUIRE(result == rps);
+        });
+    });
+}
+
+// Segments left on disk on shutdown are truncated to what was written,
+// which for compressed segments is less than their logical size.
+SEASTAR_TEST_CASE(test_commitlog_compressed_shutdown_truncate) {
+    return seastar::async([] {
+        tmpdir tmp;
+        commitlog::config cfg;
+        cfg.commit_log_location = tmp.path().string();
+        cfg.use_compression = true;
+        cfg.warn_about_segments_left_on_disk_after_shutdown = false;
+        auto log = commitlog::create_commitlog(cfg).get0();
+
+        constexpr size_t n = 1000;
+        const sstring value(1000, 'x');
+        auto uuid = make_table_id();
+        std::vector<replay_position> rps;
+        for (size_t i = 0; i < n; ++i) {
+            auto h = log.add_mutation(uuid, value.size(), db::commitlog::force_sync::no, [&](db::commitlog::output& dst) {
+                dst.write(value.data(), value.size());
+            }).get0();
+            rps.emplace_back(h.release());
+        }
+        auto segs = log.get_active_segment_names();
+        log.shutdown().get();
+
+        uint64_t total = 0;
+        std::vector<replay_position> result;
+        for (auto& seg : segs) {
+            auto size = file_size(seg).get0();
+            BOOST_REQUIRE_LT(size, n * value.size() / 2);
+            total += size;
+            db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&](db::commitlog::buffer_and_replay_position buf_rp) {
+                result.emplace_back(buf_rp.position);
+                return make_ready_future<>();
+            }).get();
+        }
+        BOOST_REQUIRE_EQUAL(log.disk_footprint(), total);
+        std::sort(result.begin(), result.end());
+        BOOST_REQUIRE(result == rps);
+
+        log.clear().get();
+    });
+}
+
 static future<> corrupt_segment(sstring seg, uint64_t off, uint32_t value) {
     return open_file_dma(seg, open_flags::rw).then([off, value](file f) {
         size_t size = align_up<size_t>(off, 4096);
@@ -80,6 +80,34 @@ SEASTAR_TEST_CASE(test_like_operator_on_clustering_key) {
     });
 }
 
+SEASTAR_TEST_CASE(test_like_operator_prefix_on_clustering_key) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        // A literal prefix bounds the clustering range read; the rest of the pattern is still checked.
+        cquery_nofail(e, "create table t (p int, c1 text, c2 text, primary key(p, c1, c2))");
+        cquery_nofail(e, "create table r (p int, c1 text, c2 text, primary key(p, c1, c2)) with clustering order by (c1 desc, c2 desc)");
+        for (auto table : {"t", "r"}) {
+            for (auto c1 : {"ab", "abc", "abd", "ab%", "ac", "aШ", "b"}) {
+                cquery_nofail(e, format("insert into {} (p, c1, c2) values (1, '{}', 'x')", table, c1));
+                cquery_nofail(e, format("insert into {} (p, c1, c2) values (1, 'abc', '{}')", table, c1));
+            }
+            auto like = [&] (const char* pattern) {
+                return format("select c1 from {} where p = 1 and c1 like '{}' and c2 = 'x' allow filtering", table, pattern);
+            };
+            require_rows(e, like("ab%"), {{T("ab")}, {T("ab%")}, {T("abc")}, {T("abd")}});
+            require_rows(e, like("abc"), {{T("abc")}});
+            require_rows(e, like("ab_"), {{T("ab%")}, {T("abc")}, {T("abd")}});
+            require_rows(e, like("ab\\%"), {{T("ab%")}});
+            require_rows(e, like("a%c"), {{T("abc")}, {T("ac")}});
+            require_rows(e, like("aШ%"), {{T("aШ")}});
+            require_rows(e, like("c%"), {});
+            require_rows(e, format("select c2 from {} where p = 1 and c1 = 'abc' and c2 like 'ab%' allow filtering", table),
+                    {{T("ab")}, {T("ab%")}, {T("abc")}, {T("abd")}});
+            require_rows(e, format("select c2 from {} where p = 1 and c1 = 'abc' and c2 like 'ab%' and c2 > 'abc' allow filtering", table),
+                    {{T("abd")}});
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_like_operator_conjunction) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         cquery_nofail(e, "create table t (s1 text primary key, s2 text)");
@@ -4913,6 +4913,46 @@ SEASTAR_THREAD_TEST_CASE(test_query_limit) {
     }, std::move(cfg)).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_paged_in_query_partition_window) {
+    cql_test_config cfg;
+    cfg.db_config->max_partitions_per_in_query_page(2);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE test (pk int, ck int, PRIMARY KEY (pk, ck));").get();
+        for (int pk = 0; pk < 6; ++pk) {
+            for (int ck = 0; ck < 2; ++ck) {
+                e.execute_cql(format("INSERT INTO test (pk, ck) VALUES ({}, {});", pk, ck)).get();
+            }
+        }
+
+        const auto select_query = "SELECT * FROM test WHERE pk IN (0, 1, 2, 3, 4, 5);";
+        bool has_more_pages = true;
+        lw_shared_ptr<service::pager::paging_state> paging_state = nullptr;
+        size_t pages = 0;
+        size_t rows = 0;
+        while (has_more_pages) {
+            auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                    cql3::query_options::specific_options{100, paging_state, {}, api::new_timestamp()});
+            auto result = e.execute_cql(select_query, std::move(qo)).get0();
+            auto rows_fetched = count_rows_fetched(result);
+            // Each page reads a window of two partitions, with two rows each.
+            BOOST_REQUIRE(rows_fetched == 4 || (rows_fetched == 0 && !::has_more_pages(result)));
+            rows += rows_fetched;
+            ++pages;
+            has_more_pages = ::has_more_pages(result);
+            paging_state = extract_paging_state(result);
+            BOOST_REQUIRE(!has_more_pages || paging_state);
+        }
+        BOOST_REQUIRE_EQUAL(rows, 12);
+        BOOST_REQUIRE_LE(pages, 4);
+
+        // Aggregates page internally through all the windows.
+        assert_that(e.execute_cql("SELECT count(*) FROM test WHERE pk IN (0, 1, 2, 3, 4, 5);").get0())
+            .is_rows()
+            .with_rows({{long_type->decompose(int64_t(12))}});
+    }, std::move(cfg)).get();
+}
+
 // reproduces https://github.com/scylladb/scylla/issues/3552
 // when clustering-key filtering is enabled in filter_sstable_for_reader
 static future<> test_clustering_filtering_with_compaction_strategy(const std::string_view& cs) {
@@ -4994,6 +5034,42 @@ SEASTAR_TEST_CASE(test_clustering_filtering_3) {
             test_clustering_filtering_3_with_compaction_strategy);
 }
 
+// Single-row reads stop at the newest sstables when they shadow the older ones.
+// Check that data which isn't fully shadowed is still read from the older sstables.
+SEASTAR_TEST_CASE(test_single_row_reads_of_overwritten_rows) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE cf(pk int, ck int, v1 int, v2 int, s int static, PRIMARY KEY(pk, ck))");
+        e.db().invoke_on_all([] (replica::database& db) {
+            auto& table = db.find_column_family("ks", "cf");
+            return table.disable_auto_compaction();
+        }).get();
+        auto flush = [&] {
+            e.db().invoke_on_all([] (replica::database& db) { return db.flush_all_memtables(); }).get();
+        };
+        cquery_nofail(e, "INSERT INTO cf(pk, ck, v1, v2, s) VALUES (0, 0, 1, 1, 1) USING TIMESTAMP 1");
+        cquery_nofail(e, "INSERT INTO cf(pk, ck, v1, v2) VALUES (0, 1, 1, 1) USING TIMESTAMP 1");
+        cquery_nofail(e, "INSERT INTO cf(pk, ck, v1, v2) VALUES (0, 2, 1, 1) USING TIMESTAMP 1");
+        flush();
+        // Full overwrite of ck=0, partial overwrite of ck=1, deletion of ck=2.
+        cquery_nofail(e, "INSERT INTO cf(pk, ck, v1, v2) VALUES (0, 0, 2, 2) USING TIMESTAMP 2");
+        cquery_nofail(e, "UPDATE cf USING TIMESTAMP 2 SET v1 = 2 WHERE pk = 0 AND ck = 1");
+        cquery_nofail(e, "DELETE FROM cf USING TIMESTAMP 2 WHERE pk = 0 AND ck = 2");
+        flush();
+        cquery_nofail(e, "UPDATE cf USING TIMESTAMP 3 SET v2 = null WHERE pk = 0 AND ck = 0");
+        flush();
+        e.db().invoke_on_all([] (replica::database& db) { db.row_cache_tracker().clear(); }).get();
+
+        require_rows(e, "SELECT v1, v2 FROM cf WHERE pk = 0 AND ck = 0", {{int32_type->decompose(2), {}}});
+        require_rows(e, "SELECT v1, v2 FROM cf WHERE pk = 0 AND ck = 1", {{int32_type->decompose(2), int32_type->decompose(1)}});
+        require_rows(e, "SELECT v1, v2 FROM cf WHERE pk = 0 AND ck = 2", {});
+        require_rows(e, "SELECT v1, s FROM cf WHERE pk = 0 AND ck = 0", {{int32_type->decompose(2), int32_type->decompose(1)}});
+        require_rows(e, "SELECT ck, v1 FROM cf WHERE pk = 0 AND ck IN (0, 1, 2)", {
+            {int32_type->decompose(0), int32_type->decompose(2)},
+            {int32_type->decompose(1), int32_type->decompose(2)},
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_counter_column_added_into_non_counter_table) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         cquery_nofail(e, "CREATE TABLE t (pk int, ck int, PRIMARY KEY(pk, ck))");
@@ -5218,6 +5294,45 @@ SEASTAR_TEST_CASE(timeuuid_fcts_prepared_re_evaluation) {
     });
 }
 
+// A statement prepared on one shard is prepared on another on its first
+// execution there, with the keyspace of the session which prepared it.
+SEASTAR_TEST_CASE(test_execute_batch_prepared_on_other_shard) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        if (smp::count < 2) {
+            return;
+        }
+        e.execute_cql("CREATE TABLE t (p int PRIMARY KEY, v int)").get();
+        const sstring query = "BEGIN BATCH INSERT INTO t (p, v) VALUES (?, ?); UPDATE t SET v = ? WHERE p = ?; APPLY BATCH";
+        auto& client_state = e.local_client_state();
+        client_state.set_keyspace(e.local_db(), "ks");
+        e.local_qp().prepare(query, client_state, false).get();
+        auto id = cql3::query_processor::compute_id(query, "ks");
+
+        auto other_shard = (this_shard_id() + 1) % smp::count;
+        smp::submit_to(other_shard, [&e, id] {
+            return seastar::async([&e, id] {
+                BOOST_REQUIRE(!e.local_qp().get_prepared(id));
+                BOOST_REQUIRE(e.local_qp().prepare_from_other_shards(id).get0());
+                BOOST_REQUIRE(e.local_qp().get_prepared(id));
+                std::vector<cql3::raw_value> raw_values;
+                for (int32_t v : {1, 10, 20, 2}) {
+                    raw_values.emplace_back(cql3::raw_value::make_value(int32_type->decompose(v)));
+                }
+                e.execute_prepared(id, std::move(raw_values)).get();
+            });
+        }).get();
+
+        assert_that(e.execute_cql("SELECT p, v FROM t").get0()).is_rows().with_rows_ignore_order({
+            {int32_type->decompose(1), int32_type->decompose(10)},
+            {int32_type->decompose(2), int32_type->decompose(20)},
+        });
+
+        // A statement no shard has prepared can't be prepared from other shards.
+        auto unknown = cql3::query_processor::compute_id("SELECT * FROM t", "ks");
+        BOOST_REQUIRE(!e.local_qp().prepare_from_other_shards(unknown).get0());
+    });
+}
+
 SEASTAR_TEST_CASE(test_parallelized_select_count) {
     return do_with_cql_env_thread([](cql_test_env& e) {
         auto& qp = e.local_qp();
@@ -5331,7 +5446,83 @@ SEASTAR_TEST_CASE(test_parallelized_select_sum_group_by) {
             {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t((value_count - 1) * value_count / 2))}
         });
 
-        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_count_group_by_clustering_prefix) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+
+        e.execute_cql("CREATE TABLE tbl (k int, c1 int, c2 int, v int, PRIMARY KEY (k, c1, c2));").get();
+        for (int k = 0; k < 2; k++) {
+            for (int c1 = 0; c1 < 2; c1++) {
+                for (int c2 = 0; c2 <= c1; c2++) {
+                    e.execute_cql(format("INSERT INTO tbl (k, c1, c2, v) VALUES ({:d}, {:d}, {:d}, {:d});", k, c1, c2, c2)).get();
+                }
+            }
+        }
+
+        // Groups are returned in ring order, like when they aren't forwarded.
+        auto msg = e.execute_cql("SELECT COUNT(*), c1, k, MAX(v) FROM tbl GROUP BY k, c1;").get();
+        assert_that(msg).is_rows().with_rows({
+            {long_type->decompose(int64_t(1)), int32_type->decompose(0), int32_type->decompose(1), int32_type->decompose(0)},
+            {long_type->decompose(int64_t(2)), int32_type->decompose(1), int32_type->decompose(1), int32_type->decompose(1)},
+            {long_type->decompose(int64_t(1)), int32_type->decompose(0), int32_type->decompose(0), int32_type->decompose(0)},
+            {long_type->decompose(int64_t(2)), int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(1)},
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+
+        // Groups not spanning the whole partition key, or limited ones, are
+        // aggregated by the coordinator.
+        e.execute_cql("SELECT c1, COUNT(*) FROM tbl WHERE k = 0 GROUP BY c1;").get();
+        e.execute_cql("SELECT k, COUNT(*) FROM tbl GROUP BY k LIMIT 1;").get();
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_group_by_page_overflow) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+
+        // Grouping columns with quoted, case-sensitive names.
+        e.execute_cql("CREATE TABLE tbl (\"Key\" int, \"Ck\" int, v int, PRIMARY KEY (\"Key\", \"Ck\"));").get();
+        const int partitions = 10;
+        for (int k = 0; k < partitions; k++) {
+            for (int ck = 0; ck < 2; ck++) {
+                e.execute_cql(format("INSERT INTO tbl (\"Key\", \"Ck\", v) VALUES ({:d}, {:d}, 1);", k, ck)).get();
+            }
+        }
+        const auto query = "SELECT \"Key\", SUM(v) FROM tbl GROUP BY \"Key\";";
+
+        // All groups fit in a page, they are aggregated by replicas.
+        auto msg = e.execute_cql(query).get();
+        BOOST_REQUIRE_EQUAL(count_rows_fetched(msg), partitions);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+
+        // More groups than fit in a page are aggregated, and paged, by the
+        // coordinator.
+        std::set<int32_t> keys;
+        lw_shared_ptr<service::pager::paging_state> paging_state = nullptr;
+        bool more_pages = true;
+        while (more_pages) {
+            auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                    cql3::query_options::specific_options{3, paging_state, {}, api::new_timestamp()});
+            auto result = e.execute_cql(query, std::move(qo)).get0();
+            auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(result);
+            BOOST_REQUIRE(rows);
+            BOOST_REQUIRE_LE(rows->rs().result_set().size(), 3);
+            for (auto& row : rows->rs().result_set().rows()) {
+                keys.insert(value_cast<int32_t>(int32_type->deserialize(*row[0])));
+                BOOST_REQUIRE_EQUAL(value_cast<int32_t>(int32_type->deserialize(*row[1])), 2);
+            }
+            more_pages = has_more_pages(result);
+            paging_state = extract_paging_state(result);
+        }
+        BOOST_REQUIRE_EQUAL(keys.size(), partitions);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
     });
 }
 
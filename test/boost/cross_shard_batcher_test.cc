@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/defer.hh>
+
+#include "utils/cross_shard_batcher.hh"
+
+using namespace seastar;
+
+SEASTAR_THREAD_TEST_CASE(test_calls_to_the_same_shard_are_batched) {
+    utils::cross_shard_batcher<unsigned> batcher;
+    auto stop = defer([&] { batcher.stop().get(); });
+
+    auto target = (this_shard_id() + 1) % smp::count;
+    std::vector<future<unsigned>> futs;
+    for (unsigned i = 0; i < 10; ++i) {
+        futs.push_back(batcher.submit_to(target, [i] {
+            return make_ready_future<unsigned>(this_shard_id() * 100 + i);
+        }));
+    }
+    for (unsigned i = 0; i < futs.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(futs[i].get0(), target * 100 + i);
+    }
+
+    if (target != this_shard_id()) {
+        BOOST_REQUIRE_EQUAL(batcher.get_stats().calls, 10);
+        BOOST_REQUIRE_EQUAL(batcher.get_stats().batches, 1);
+    } else {
+        BOOST_REQUIRE_EQUAL(batcher.get_stats().batches, 0);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_failures_are_propagated_per_call) {
+    utils::cross_shard_batcher<int> batcher;
+    auto stop = defer([&] { batcher.stop().get(); });
+
+    auto target = (this_shard_id() + 1) % smp::count;
+    auto ok = batcher.submit_to(target, [] { return make_ready_future<int>(1); });
+    auto failed = batcher.submit_to(target, [] { return make_exception_future<int>(std::runtime_error("failed")); });
+    auto thrown = batcher.submit_to(target, [] () -> future<int> { throw std::runtime_error("thrown"); });
+
+    BOOST_REQUIRE_EQUAL(ok.get0(), 1);
+    BOOST_REQUIRE_THROW(failed.get(), std::runtime_error);
+    BOOST_REQUIRE_THROW(thrown.get(), std::runtime_error);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_calls_fail_after_stop) {
+    utils::cross_shard_batcher<int> batcher;
+    auto target = (this_shard_id() + 1) % smp::count;
+    auto in_flight = batcher.submit_to(target, [] { return make_ready_future<int>(1); });
+    batcher.stop().get();
+    BOOST_REQUIRE_EQUAL(in_flight.get0(), 1);
+    if (target != this_shard_id()) {
+        BOOST_REQUIRE_THROW(batcher.submit_to(target, [] { return make_ready_future<int>(2); }).get(), gate_closed_exception);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_calls_are_batched_per_scheduling_group) {
+    utils::cross_shard_batcher<bool> batcher;
+    auto stop = defer([&] { batcher.stop().get(); });
+
+    auto sg1 = create_scheduling_group("batcher_test_1", 100).get0();
+    auto sg2 = create_scheduling_group("batcher_test_2", 100).get0();
+    auto destroy = defer([&] {
+        destroy_scheduling_group(sg1).get();
+        destroy_scheduling_group(sg2).get();
+    });
+
+    auto target = (this_shard_id() + 1) % smp::count;
+    auto submit = [&] (scheduling_group sg) {
+        return with_scheduling_group(sg, [&batcher, target, sg] {
+            return batcher.submit_to(target, [sg] {
+                return make_ready_future<bool>(current_scheduling_group() == sg);
+            });
+        });
+    };
+    std::vector<future<bool>> futs;
+    for (unsigned i = 0; i < 4; ++i) {
+        futs.push_back(submit(i % 2 ? sg1 : sg2));
+    }
+    for (auto& f : futs) {
+        BOOST_REQUIRE(f.get0());
+    }
+
+    if (target != this_shard_id()) {
+        BOOST_REQUIRE_EQUAL(batcher.get_stats().calls, 4);
+        BOOST_REQUIRE_EQUAL(batcher.get_stats().batches, 2);
+    }
+}
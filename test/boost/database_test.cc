@@ -15,6 +15,7 @@
 #include <seastar/testing/thread_test_case.hh>
 
 #include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/result_set_assertions.hh"
 #include "test/lib/log.hh"
 #include "test/lib/random_utils.hh"
@@ -829,6 +830,41 @@ SEASTAR_TEST_CASE(toppartitions_cross_shard_schema_ptr) {
     });
 }
 
+SEASTAR_TEST_CASE(hot_partitions_sampled_writes) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.tab (pk text PRIMARY KEY, v int)").get();
+        auto s = e.local_db().find_schema("ks", "tab");
+        auto keys = make_local_keys(2, s);
+        // Count every write.
+        db::hot_partitions_data_listener hp(e.local_db(), utils::updateable_value<uint32_t>(1));
+
+        auto q = e.prepare("INSERT INTO ks.tab(pk, v) VALUES(?, ?)").get0();
+        auto insert = [&] (const sstring& pk, int n) {
+            for (int i = 0; i != n; ++i) {
+                e.execute_prepared(q, {cql3::raw_value::make_value(utf8_type->decompose(pk)), cql3::raw_value::make_value(int32_type->decompose(i))}).get();
+            }
+        };
+        insert(keys[0], 3);
+        insert(keys[1], 5);
+
+        BOOST_REQUIRE(hp.last_window().write.empty());
+        hp.close_window();
+        auto is_key = [&] (const db::toppartitions_item_key& item, const sstring& pk) {
+            return item.key.key().equal(*s, partition_key::from_single_value(*s, utf8_type->decompose(pk)));
+        };
+        auto& top = hp.last_window().write;
+        BOOST_REQUIRE_EQUAL(top.size(), 2);
+        BOOST_REQUIRE(is_key(top[0].item, keys[1]));
+        BOOST_REQUIRE_EQUAL(top[0].count, 5);
+        BOOST_REQUIRE(is_key(top[1].item, keys[0]));
+        BOOST_REQUIRE_EQUAL(top[1].count, 3);
+
+        // The next window starts empty.
+        hp.close_window();
+        BOOST_REQUIRE(hp.last_window().write.empty());
+    });
+}
+
 SEASTAR_THREAD_TEST_CASE(read_max_size) {
     do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("CREATE TABLE test (pk text, ck int, v text, PRIMARY KEY (pk, ck));").get();
@@ -1296,3 +1332,44 @@ SEASTAR_TEST_CASE(drop_table_with_explicit_snapshot) {
         co_return;
     });
 }
+
+// Read repair writes back the mutations which replicas return for a query,
+// so these must carry the cells of the columns the query doesn't select
+// with their values, also for reads bypassing the cache.
+SEASTAR_THREAD_TEST_CASE(test_mutation_query_bypassing_cache_keeps_unselected_values) {
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE test (pk text, ck int, v1 int, v2 int, PRIMARY KEY (pk, ck));").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "test");
+        auto pk = make_local_key(s);
+        e.execute_cql(format("INSERT INTO test (pk, ck, v1, v2) VALUES ('{}', 0, 1, 2);", pk)).get();
+        db.flush_all_memtables().get();
+
+        auto qo = std::make_unique<cql3::query_options>(db::consistency_level::QUORUM, std::vector<cql3::raw_value>{},
+                cql3::query_options::specific_options::DEFAULT);
+        auto msg = e.execute_cql(format("SELECT v1 FROM test WHERE pk = '{}' BYPASS CACHE;", pk), std::move(qo)).get0();
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(1)}});
+
+        auto slice = partition_slice_builder(*s)
+                .with_no_regular_columns()
+                .with_regular_column("v1")
+                .with_option<query::partition_slice::option::bypass_cache>()
+                .build();
+        auto cmd = query::read_command(s->id(), s->version(), slice, query::max_result_size(std::numeric_limits<size_t>::max()),
+                query::tombstone_limit::max);
+        auto dk = dht::decorate_key(*s, partition_key::from_single_value(*s, utf8_type->decompose(data_value(pk))));
+        auto res = std::get<0>(db.query_mutations(s, cmd, dht::partition_range::make_singular(dk), {}, db::no_timeout).get0());
+        BOOST_REQUIRE_EQUAL(res.partitions().size(), 1);
+        auto m = res.partitions()[0].mut().unfreeze(s);
+        size_t cells = 0;
+        for (auto& row : m.partition().clustered_rows()) {
+            row.row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+                auto& def = s->regular_column_at(id);
+                auto value = def.type->deserialize(c.as_atomic_cell(def).value().linearize());
+                BOOST_REQUIRE_EQUAL(value, data_value(int32_t(def.name_as_text() == "v1" ? 1 : 2)));
+                ++cells;
+            });
+        }
+        BOOST_REQUIRE_GE(cells, 1);
+    }).get();
+}
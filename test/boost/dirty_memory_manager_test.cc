@@ -645,3 +645,36 @@ SEASTAR_THREAD_TEST_CASE(test_size_tracked_region_move_assign) {
     r1 = std::move(r0);
     r1.allocator().free(std::exchange(p, nullptr));
 }
+
+SEASTAR_THREAD_TEST_CASE(test_get_largest_regions) {
+    region_group rg;
+    std::vector<std::unique_ptr<size_tracked_region>> regions;
+    std::vector<std::vector<managed_ref<int>>> objs;
+    constexpr size_t base_count = 16 * 1024;
+
+    for (size_t i : {2, 8, 1, 4}) {
+        auto& r = regions.emplace_back(std::make_unique<size_tracked_region>());
+        r->listen(&rg);
+        auto& o = objs.emplace_back();
+        with_allocator(r->allocator(), [&] {
+            for (size_t j = 0; j < i * base_count; j++) {
+                o.emplace_back(make_managed<int>());
+            }
+        });
+    }
+
+    auto largest = rg.get_largest_regions(3);
+    BOOST_REQUIRE_EQUAL(largest.size(), 3);
+    BOOST_REQUIRE_EQUAL(largest[0], regions[1].get());
+    BOOST_REQUIRE_EQUAL(largest[1], regions[3].get());
+    BOOST_REQUIRE_EQUAL(largest[2], regions[0].get());
+    BOOST_REQUIRE_EQUAL(largest[0], rg.get_largest_region());
+
+    BOOST_REQUIRE_EQUAL(rg.get_largest_regions(10).size(), regions.size());
+
+    for (size_t i = 0; i < regions.size(); ++i) {
+        with_allocator(regions[i]->allocator(), [&] {
+            objs[i].clear();
+        });
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/defer.hh>
+
+#include "test/lib/random_utils.hh"
+#include "test/lib/tmpdir.hh"
+
+#include "utils/disk_block_cache.hh"
+
+using namespace seastar;
+
+static constexpr size_t block_size = 4096;
+
+static sstring write_file(const std::filesystem::path& path, size_t size) {
+    auto contents = tests::random::get_sstring(size);
+    file f = open_file_dma(path.c_str(), open_flags::create | open_flags::rw).get0();
+    output_stream<char> out = make_file_output_stream(f).get0();
+    out.write(contents.begin(), contents.size()).get();
+    out.flush().get();
+    out.close().get();
+    return contents;
+}
+
+static sstring read(file& f, uint64_t pos, size_t len) {
+    auto buf = f.dma_read_bulk<char>(pos, len).get0();
+    return sstring(buf.get(), buf.size());
+}
+
+struct cache_fixture {
+    tmpdir dir;
+    file cache_file;
+    std::unique_ptr<utils::disk_block_cache> cache;
+
+    explicit cache_fixture(size_t capacity_blocks, unsigned read_ahead_blocks = 0) {
+        cache_file = open_file_dma((dir.path() / "cache").c_str(), open_flags::create | open_flags::rw).get0();
+        cache = std::make_unique<utils::disk_block_cache>(cache_file, utils::disk_block_cache::config{
+            .block_size = block_size,
+            .capacity = capacity_blocks * block_size,
+            .read_ahead_blocks = read_ahead_blocks,
+        });
+    }
+    ~cache_fixture() {
+        cache->close().get();
+        cache_file.close().get();
+    }
+
+    std::pair<file, sstring> make_file(const char* name, size_t size) {
+        auto path = dir.path() / name;
+        auto contents = write_file(path, size);
+        auto backing = open_file_dma(path.c_str(), open_flags::ro).get0();
+        return {utils::make_disk_cached_file(*cache, std::move(backing)).get0(), std::move(contents)};
+    }
+};
+
+SEASTAR_THREAD_TEST_CASE(test_reads_are_served_from_the_cache) {
+    cache_fixture fx(16);
+    auto [f, contents] = fx.make_file("data", block_size * 3 + 100);
+    auto close_f = defer([&f] { f.close().get(); });
+    auto& stats = fx.cache->get_stats();
+
+    BOOST_REQUIRE_EQUAL(read(f, 10, 100), contents.substr(10, 100));
+    BOOST_REQUIRE_EQUAL(stats.misses, 1);
+    BOOST_REQUIRE_EQUAL(stats.hits, 0);
+
+    BOOST_REQUIRE_EQUAL(read(f, 200, 300), contents.substr(200, 300));
+    BOOST_REQUIRE_EQUAL(stats.misses, 1);
+    BOOST_REQUIRE_EQUAL(stats.hits, 1);
+
+    // Spanning blocks, and reading past the end of the file.
+    BOOST_REQUIRE_EQUAL(read(f, block_size - 10, block_size * 4), contents.substr(block_size - 10));
+    BOOST_REQUIRE_EQUAL(stats.misses, 4);
+    BOOST_REQUIRE_EQUAL(read(f, 0, contents.size()), contents);
+    BOOST_REQUIRE_EQUAL(stats.misses, 4);
+    BOOST_REQUIRE_EQUAL(fx.cache->cached_blocks(), 4);
+    BOOST_REQUIRE_EQUAL(f.size().get0(), contents.size());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_least_recently_used_blocks_are_evicted) {
+    cache_fixture fx(2);
+    auto [f1, contents1] = fx.make_file("data1", block_size * 2);
+    auto [f2, contents2] = fx.make_file("data2", block_size);
+    auto close_f = defer([&f1, &f2] { f1.close().get(); f2.close().get(); });
+    auto& stats = fx.cache->get_stats();
+
+    BOOST_REQUIRE_EQUAL(read(f1, 0, 10), contents1.substr(0, 10));
+    BOOST_REQUIRE_EQUAL(read(f1, block_size, 10), contents1.substr(block_size, 10));
+    BOOST_REQUIRE_EQUAL(read(f1, 0, 10), contents1.substr(0, 10));
+    BOOST_REQUIRE_EQUAL(stats.evictions, 0);
+
+    // Evicts the second block of f1, the least recently used one.
+    BOOST_REQUIRE_EQUAL(read(f2, 0, 10), contents2.substr(0, 10));
+    BOOST_REQUIRE_EQUAL(stats.evictions, 1);
+    BOOST_REQUIRE_EQUAL(fx.cache->cached_blocks(), 2);
+
+    const auto misses = stats.misses;
+    BOOST_REQUIRE_EQUAL(read(f1, 0, 10), contents1.substr(0, 10));
+    BOOST_REQUIRE_EQUAL(stats.misses, misses);
+    BOOST_REQUIRE_EQUAL(read(f1, block_size, 10), contents1.substr(block_size, 10));
+    BOOST_REQUIRE_EQUAL(stats.misses, misses + 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_sequential_reads_trigger_read_ahead) {
+    cache_fixture fx(16, 2);
+    auto [f, contents] = fx.make_file("data", block_size * 8);
+    auto close_f = defer([&f] { f.close().get(); });
+    auto& stats = fx.cache->get_stats();
+
+    BOOST_REQUIRE_EQUAL(read(f, 0, block_size), contents.substr(0, block_size));
+    BOOST_REQUIRE_EQUAL(stats.read_aheads, 0);
+    BOOST_REQUIRE_EQUAL(read(f, block_size, block_size), contents.substr(block_size, block_size));
+    BOOST_REQUIRE_EQUAL(stats.read_aheads, 2);
+
+    // Wait for the read-aheads, then the next blocks are hits.
+    while (fx.cache->cached_blocks() < 4) {
+        thread::yield();
+    }
+    const auto misses = stats.misses;
+    BOOST_REQUIRE_EQUAL(read(f, block_size * 2, block_size * 2), contents.substr(block_size * 2, block_size * 2));
+    BOOST_REQUIRE_EQUAL(stats.misses, misses);
+}
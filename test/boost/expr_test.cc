@@ -10,6 +10,7 @@
 #include <boost/test/unit_test.hpp>
 #include <utility>
 #include "cql3/expr/expression.hh"
+#include "cql3/expr/column_filter.hh"
 #include "utils/overloaded_functor.hh"
 #include <cassert>
 #include "cql3/query_options.hh"
@@ -376,3 +377,44 @@ BOOST_AUTO_TEST_CASE(boolean_factors_test) {
         )
     );
 }
+
+BOOST_AUTO_TEST_CASE(single_column_filter_test) {
+    column_definition col_def(utf8_type->decompose("v"), int32_type, column_kind::regular_column);
+    auto satisfies = [] (const single_column_filter& f, std::optional<int> v) {
+        if (!v) {
+            return f.is_satisfied_by(std::nullopt);
+        }
+        auto b = int32_type->decompose(*v);
+        return f.is_satisfied_by(managed_bytes_view(bytes_view(b)));
+    };
+
+    // 5 < v <= 10
+    auto range = single_column_filter::prepare(make_conjunction(
+            binary_operator(column_value(&col_def), oper_t::GT, make_int(5)),
+            binary_operator(column_value(&col_def), oper_t::LTE, make_int(10))), query_options::DEFAULT);
+    BOOST_REQUIRE(range);
+    BOOST_REQUIRE(!satisfies(*range, 5));
+    BOOST_REQUIRE(satisfies(*range, 6));
+    BOOST_REQUIRE(satisfies(*range, 10));
+    BOOST_REQUIRE(!satisfies(*range, 11));
+    BOOST_REQUIRE(!satisfies(*range, -7));
+    BOOST_REQUIRE(!satisfies(*range, std::nullopt));
+
+    // v != 3 is satisfied by null, since it's !(v = 3)
+    auto neq = single_column_filter::prepare(
+            binary_operator(column_value(&col_def), oper_t::NEQ, make_int(3)), query_options::DEFAULT);
+    BOOST_REQUIRE(neq);
+    BOOST_REQUIRE(!satisfies(*neq, 3));
+    BOOST_REQUIRE(satisfies(*neq, 4));
+    BOOST_REQUIRE(satisfies(*neq, std::nullopt));
+
+    // Comparisons with null are false
+    auto eq_null = single_column_filter::prepare(
+            binary_operator(column_value(&col_def), oper_t::EQ, constant::make_null(int32_type)), query_options::DEFAULT);
+    BOOST_REQUIRE(eq_null);
+    BOOST_REQUIRE(!satisfies(*eq_null, 3));
+
+    // Unsupported operators are left to is_satisfied_by()
+    BOOST_REQUIRE(!single_column_filter::prepare(
+            binary_operator(column_value(&col_def), oper_t::IN, make_int(3)), query_options::DEFAULT));
+}
@@ -11,6 +11,7 @@
 #include <seastar/core/smp.hh>
 
 #include "db/hints/sync_point.hh"
+#include "db/hints/segment_replay_tracker.hh"
 
 SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
     const unsigned encoded_shard_count = 2;
@@ -65,3 +66,73 @@ SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
 
     return make_ready_future<>();
 }
+
+static db::replay_position make_rp(segment_id_type id, position_type pos) {
+    return db::replay_position(0, id, pos);
+}
+
+SEASTAR_TEST_CASE(test_segment_replay_tracker_out_of_order_completion) {
+    db::hints::segment_replay_tracker tracker;
+    const std::vector<segment_id_type> ids{make_rp(1, 0).id, make_rp(2, 0).id, make_rp(3, 0).id};
+    tracker.start_round(ids);
+    BOOST_REQUIRE(!tracker.replayed_bound());
+
+    // A newer segment is replayed in full before the oldest one starts.
+    tracker.on_progress(ids[1], make_rp(2, 0));
+    tracker.on_progress(ids[1], make_rp(2, 100));
+    tracker.on_done(ids[1]);
+    BOOST_REQUIRE(!tracker.replayed_bound());
+
+    tracker.on_progress(ids[0], make_rp(1, 0));
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(1, 0));
+    tracker.on_progress(ids[0], make_rp(1, 50));
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(1, 50));
+
+    // Once the oldest segment is done, the bound moves past the newer
+    // segment which was done before, up to the one which isn't started.
+    tracker.on_progress(ids[0], make_rp(1, 200));
+    tracker.on_done(ids[0]);
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(2, 100));
+    BOOST_REQUIRE(!tracker.replayed_bound());
+
+    tracker.on_progress(ids[2], make_rp(3, 10));
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(3, 10));
+
+    // Segments which are not part of the round, like foreign ones, are ignored.
+    tracker.on_progress(make_rp(4, 0).id, make_rp(4, 10));
+    tracker.on_done(make_rp(4, 0).id);
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(3, 10));
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_segment_replay_tracker_failed_segment) {
+    db::hints::segment_replay_tracker tracker;
+    const std::vector<segment_id_type> ids{make_rp(1, 0).id, make_rp(2, 0).id};
+    tracker.start_round(ids);
+
+    // Sending from the oldest segment fails after some hints, while the
+    // newer segment is replayed in full.
+    tracker.on_progress(ids[0], make_rp(1, 0));
+    tracker.on_progress(ids[0], make_rp(1, 30));
+    tracker.on_progress(ids[1], make_rp(2, 0));
+    tracker.on_progress(ids[1], make_rp(2, 80));
+    tracker.on_done(ids[1]);
+
+    // The bound is held by the failed segment.
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(1, 30));
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(1, 30));
+
+    // The failed segment is retried in the next round, from where it was
+    // left, and the bound moves past it once it's done.
+    tracker.start_round(std::vector<segment_id_type>{ids[0]});
+    BOOST_REQUIRE(!tracker.replayed_bound());
+    tracker.on_progress(ids[0], make_rp(1, 0));
+    tracker.on_progress(ids[0], make_rp(1, 60));
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(1, 60));
+    tracker.on_done(ids[0]);
+    BOOST_REQUIRE(tracker.replayed_bound() == make_rp(1, 60));
+    BOOST_REQUIRE(!tracker.replayed_bound());
+
+    return make_ready_future<>();
+}
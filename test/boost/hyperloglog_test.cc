@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#define BOOST_TEST_MODULE hyperloglog
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+
+#include "sstables/hyperloglog.hh"
+
+static void offer(hll::HyperLogLog& hll, uint64_t first, uint64_t count) {
+    for (uint64_t i = first; i < first + count; ++i) {
+        // A cheap mixer, the estimator expects uniformly distributed hashes.
+        uint64_t h = i * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 31;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 29;
+        hll.offer_hashed(h);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization_round_trip) {
+    hll::HyperLogLog a(13);
+    offer(a, 0, 10000);
+    auto bytes = a.get_bytes();
+
+    auto b = hll::HyperLogLog::from_bytes(bytes);
+    BOOST_REQUIRE_EQUAL(b.registerSize(), a.registerSize());
+    BOOST_REQUIRE_EQUAL(b.estimate(), a.estimate());
+
+    auto truncated = std::vector<uint8_t>(bytes.begin(), bytes.end() - 1);
+    BOOST_REQUIRE_THROW(hll::HyperLogLog::from_bytes(truncated), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_merged_estimate_of_overlapping_sets) {
+    hll::HyperLogLog a(13);
+    hll::HyperLogLog b(13);
+    // 100k distinct keys in total, 50k of them in both.
+    offer(a, 0, 75000);
+    offer(b, 25000, 75000);
+
+    auto merged = hll::HyperLogLog::from_bytes(a.get_bytes());
+    merged.merge(hll::HyperLogLog::from_bytes(b.get_bytes()));
+    BOOST_REQUIRE_CLOSE(merged.estimate(), 100000.0, 5.0);
+
+    hll::HyperLogLog coarse(4);
+    BOOST_REQUIRE_THROW(merged.merge(coarse), std::invalid_argument);
+}
@@ -443,3 +443,28 @@ BOOST_AUTO_TEST_CASE(test_reset) {
     BOOST_TEST(matches(m, u8"alpha"));
     BOOST_TEST(!matches(m, u8"omega"));
 }
+
+BOOST_AUTO_TEST_CASE(test_percent_overlapping_pieces) {
+    auto m = matcher(u8"ab%ba%ab");
+    BOOST_TEST(matches(m, u8"abbaab"));
+    BOOST_TEST(matches(m, u8"abШbaШab"));
+    BOOST_TEST(!matches(m, u8"abab"));
+    BOOST_TEST(!matches(m, u8"abbab"));
+    BOOST_TEST(!matches(m, u8"ababab"));
+}
+
+BOOST_AUTO_TEST_CASE(test_literal_prefix) {
+    auto prefix = [] (const char8_t* pattern) {
+        return like_matcher::literal_prefix(bytes(reinterpret_cast<const char*>(pattern)));
+    };
+    BOOST_TEST(prefix(u8"") == bytes(""));
+    BOOST_TEST(prefix(u8"abc") == bytes("abc"));
+    BOOST_TEST(prefix(u8"abc%") == bytes("abc"));
+    BOOST_TEST(prefix(u8"ab_c%") == bytes("ab"));
+    BOOST_TEST(prefix(u8"%abc") == bytes(""));
+    BOOST_TEST(prefix(u8"_abc") == bytes(""));
+    BOOST_TEST(prefix(u8R"(a\%b%)") == bytes("a%b"));
+    BOOST_TEST(prefix(u8R"(a\_b\\c%)") == bytes(R"(a_b\c)"));
+    BOOST_TEST(prefix(u8R"(ab\)") == bytes(R"(ab\)"));
+    BOOST_TEST(prefix(u8"Шa%") == bytes(reinterpret_cast<const char*>(u8"Шa")));
+}
@@ -43,7 +43,7 @@ struct fragmenting_allocation_strategy : standard_allocation_strategy {
 
 constexpr size_t alloc_size = 63;
 const std::vector<size_t> sizes = {
-    0, 1, 15, 16,
+    0, 1, 15, 16, 31, 32,
     alloc_size - 1, alloc_size, alloc_size + 1,
     alloc_size * 4 - 1, alloc_size * 4, alloc_size * 4 + 1,
 };
@@ -181,6 +181,22 @@ BOOST_AUTO_TEST_CASE(test_external_memory_usage) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_small_values_are_inline) {
+    fragmenting_allocation_strategy fragmenting_allocator(alloc_size);
+    with_allocator(fragmenting_allocator, [&] {
+        for (size_t size = 0; size <= 31; ++size) {
+            auto b = tests::random::get_bytes(size);
+            auto m = managed_bytes(b);
+            auto m2 = m;
+            BOOST_CHECK_EQUAL(fragmenting_allocator.allocated_bytes, 0);
+            BOOST_CHECK_EQUAL(m.external_memory_usage(), 0);
+            BOOST_CHECK_EQUAL(to_bytes(m2), b);
+        }
+        auto m = managed_bytes(tests::random::get_bytes(32));
+        BOOST_CHECK_GT(fragmenting_allocator.allocated_bytes, 0);
+    });
+}
+
 BOOST_AUTO_TEST_CASE(test_with_linearized) {
     fragmenting_allocation_strategy fragmenting_allocator(alloc_size);
     for (size_t size : sizes) {
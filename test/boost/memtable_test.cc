@@ -380,6 +380,64 @@ SEASTAR_TEST_CASE(test_partition_version_consistency_after_lsa_compaction_happen
     });
 }
 
+SEASTAR_TEST_CASE(test_single_partition_reads_with_partition_index) {
+    return seastar::async([] {
+        schema_ptr s = schema_builder("ks", "cf")
+                .with_column("pk", bytes_type, column_kind::partition_key)
+                .with_column("col", bytes_type, column_kind::regular_column)
+                .build();
+
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+
+        auto make_m = [&] {
+            auto m = make_unique_mutation(s);
+            set_column(m, "col");
+            return m;
+        };
+
+        std::vector<mutation> muts;
+        for (int i = 0; i < 1000; ++i) {
+            muts.push_back(make_m());
+            mt->apply(muts.back());
+        }
+
+        auto check_reads = [&] {
+            for (auto& m : muts) {
+                auto pr = dht::partition_range::make_singular(m.decorated_key());
+                assert_that(mt->make_flat_reader(s, semaphore.make_permit(), pr))
+                    .produces(m)
+                    .produces_end_of_stream();
+            }
+            auto missing = make_unique_mutation(s);
+            auto pr = dht::partition_range::make_singular(missing.decorated_key());
+            assert_that(mt->make_flat_reader(s, semaphore.make_permit(), pr))
+                .produces_end_of_stream();
+        };
+
+        // Enough lookups to build the index.
+        check_reads();
+        check_reads();
+
+        // Overwrites and inserts go through the index too.
+        for (int i = 0; i < 1000; i += 2) {
+            auto m = muts[i];
+            set_column(m, "col");
+            mt->apply(m);
+            muts[i] = m;
+            muts.push_back(make_m());
+            mt->apply(muts.back());
+        }
+        check_reads();
+
+        // Invalidates the index.
+        logalloc::shard_tracker().full_compaction();
+        check_reads();
+        check_reads();
+    });
+}
+
 // Reproducer for #1746
 SEASTAR_TEST_CASE(test_segment_migration_during_flush) {
     return seastar::async([] {
@@ -574,6 +632,58 @@ SEASTAR_THREAD_TEST_CASE(test_tombstone_compaction_during_flush) {
     mt->cleaner().drain().get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_dead_partitions_are_purged_on_flush) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v", int32_type)
+            .set_gc_grace_seconds(0)
+            .set_purge_dead_partitions_on_flush(true)
+            .build();
+    auto mt = make_lw_shared<replica::memtable>(s);
+
+    auto make_pkey = [&] (int32_t v) {
+        return dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(v)));
+    };
+    const column_definition& v_def = *s->get_column_definition("v");
+    auto make_row = [&] (const dht::decorated_key& dk, api::timestamp_type ts) {
+        mutation m(s, dk);
+        m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(0)), v_def,
+                atomic_cell::make_live(*v_def.type, ts, int32_type->decompose(1)));
+        return m;
+    };
+    auto make_delete = [&] (const dht::decorated_key& dk, api::timestamp_type ts) {
+        mutation m(s, dk);
+        m.partition().apply(tombstone(ts, gc_clock::now()));
+        return m;
+    };
+
+    // Stays, since it is live.
+    auto live = make_row(make_pkey(0), 1);
+    // Written and deleted in the memtable, so it is purged.
+    auto deleted = make_pkey(1);
+    // Dead, but may shadow data elsewhere, so it stays.
+    auto shadowing = make_delete(make_pkey(2), 2);
+
+    mt->apply(live);
+    mt->apply(make_row(deleted, 1));
+    mt->apply(make_delete(deleted, 2));
+    mt->apply(shadowing);
+
+    std::vector<mutation> expected{live, shadowing};
+    std::sort(expected.begin(), expected.end(), mutation_decorated_key_less_comparator());
+
+    auto can_purge = [&] (const dht::decorated_key& dk) {
+        return !dk.equal(*s, shadowing.decorated_key());
+    };
+    auto rd = assert_that(mt->make_flush_reader(s, semaphore.make_permit(), default_priority_class(), can_purge));
+    for (auto& m : expected) {
+        rd.produces(m);
+    }
+    rd.produces_end_of_stream();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_tombstone_merging_with_multiple_versions) {
     tests::reader_concurrency_semaphore_wrapper semaphore;
     simple_schema ss;
@@ -642,6 +752,38 @@ SEASTAR_THREAD_TEST_CASE(test_tombstone_merging_with_multiple_versions) {
         .produces(m1 + m2 + m3);
 }
 
+// Frozen mutations are applied directly into the memtable partition unless
+// it has a snapshot. Check that both ways give the same result.
+SEASTAR_THREAD_TEST_CASE(test_frozen_mutation_apply) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    for (auto counters : { random_mutation_generator::generate_counters::no, random_mutation_generator::generate_counters::yes }) {
+        random_mutation_generator gen(counters);
+        auto s = gen.schema();
+        auto m1 = gen();
+        auto m2 = mutation(s, m1.decorated_key(), gen().partition());
+        auto m3 = mutation(s, m1.decorated_key(), gen().partition());
+        auto pr = dht::partition_range::make_singular(m1.decorated_key());
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(freeze(m1), s);
+        mt->apply(freeze(m2), s);
+
+        // Keeps a snapshot of the partition, so that m3 goes to a new version.
+        auto rd = mt->make_flat_reader(s, semaphore.make_permit(), pr, s->full_slice(), default_priority_class(),
+                                       nullptr, streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+        auto close_rd = deferred_close(rd);
+        rd.fill_buffer().get();
+
+        mt->apply(freeze(m3), s);
+        // Applying the same mutation twice must not change the result.
+        mt->apply(freeze(m1), s);
+
+        assert_that(mt->make_flat_reader(s, semaphore.make_permit(), pr))
+            .produces(m1 + m2 + m3)
+            .produces_end_of_stream();
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_range_tombstones_are_compacted_with_data) {
     tests::reader_concurrency_semaphore_wrapper semaphore;
     simple_schema ss;
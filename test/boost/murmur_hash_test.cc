@@ -109,3 +109,20 @@ BOOST_AUTO_TEST_CASE(test_hash_output) {
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_batched_hash_output) {
+    std::vector<bytes_view> prefixes;
+    for (size_t i = 0; i < full_sequence.size(); ++i) {
+        prefixes.emplace_back(full_sequence.begin(), i);
+    }
+    // Longest first too, so keys hashed together differ in length both ways.
+    for (size_t i = full_sequence.size(); i > 0; --i) {
+        prefixes.emplace_back(full_sequence.begin(), i - 1);
+    }
+
+    std::vector<std::array<uint64_t, 2>> hashes(prefixes.size());
+    utils::murmur_hash::hash3_x64_128(prefixes, seed, hashes);
+    for (size_t i = 0; i < prefixes.size(); ++i) {
+        BOOST_REQUIRE(hashes[i] == prefix_hashes[prefixes[i].size()]);
+    }
+}
@@ -560,6 +560,61 @@ SEASTAR_THREAD_TEST_CASE(test_result_size_calculation) {
     BOOST_REQUIRE_EQUAL(digest_only_builder.memory_accounter().used_memory(), result_and_digest_builder.memory_accounter().used_memory());
 }
 
+SEASTAR_THREAD_TEST_CASE(test_data_query_with_row_filter) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = make_schema();
+
+    mutation m1(s, partition_key::from_single_value(*s, "key1"));
+    m1.set_static_cell("s1", data_value(bytes("s1:v")), 1);
+    m1.set_clustered_cell(clustering_key::from_single_value(*s, bytes("A")), "v1", data_value(bytes("a")), 1);
+    m1.set_clustered_cell(clustering_key::from_single_value(*s, bytes("B")), "v1", data_value(bytes("b")), 1);
+
+    mutation m2(s, partition_key::from_single_value(*s, "key2"));
+    m2.set_clustered_cell(clustering_key::from_single_value(*s, bytes("A")), "v1", data_value(bytes("b")), 1);
+    m2.set_clustered_cell(clustering_key::from_single_value(*s, bytes("B")), "v2", data_value(bytes("b")), 1);
+
+    mutation m3(s, partition_key::from_single_value(*s, "key3"));
+    m3.set_static_cell("s1", data_value(bytes("s1:v")), 1);
+    m3.set_clustered_cell(clustering_key::from_single_value(*s, bytes("A")), "v1", data_value(bytes("c")), 1);
+
+    auto src = make_source({m1, m2, m3});
+    auto slice = make_full_slice(*s);
+    query::result_memory_limiter l(std::numeric_limits<ssize_t>::max());
+
+    auto query_with_filter = [&] (query::row_filter filter) {
+        query::result::builder builder(slice, query::result_options::only_result(),
+                l.new_data_read(query::max_result_size(query::result_memory_limiter::maximum_result_size), query::short_read::yes).get0(),
+                query::max_tombstones, &filter);
+        data_query(s, semaphore.make_permit(), src, query::full_partition_range, slice, builder);
+        return query::result_set::from_raw_result(s, slice, builder.build());
+    };
+
+    auto v1 = s->get_column_definition("v1")->id;
+
+    // Partitions whose rows were all filtered out are dropped, even if they have static content.
+    assert_that(query_with_filter({{{v1, query::row_filter::comparison_op::eq, bytes("b")}}}))
+        .has_size(2)
+        .has(a_row()
+            .with_column("pk", data_value(bytes("key1")))
+            .with_column("ck", data_value(bytes("B")))
+            .with_column("v1", data_value(bytes("b"))))
+        .has(a_row()
+            .with_column("pk", data_value(bytes("key2")))
+            .with_column("ck", data_value(bytes("A")))
+            .with_column("v1", data_value(bytes("b"))));
+
+    // Rows in which the column is null satisfy only inequality.
+    assert_that(query_with_filter({{{v1, query::row_filter::comparison_op::gt, bytes("a")},
+                                    {v1, query::row_filter::comparison_op::neq, bytes("c")}}}))
+        .has_size(2)
+        .has(a_row()
+            .with_column("pk", data_value(bytes("key1")))
+            .with_column("ck", data_value(bytes("B"))))
+        .has(a_row()
+            .with_column("pk", data_value(bytes("key2")))
+            .with_column("ck", data_value(bytes("A"))));
+}
+
 SEASTAR_THREAD_TEST_CASE(test_frozen_mutation_consumer) {
     random_mutation_generator gen(random_mutation_generator::generate_counters::no);
     schema_ptr s = gen.schema();
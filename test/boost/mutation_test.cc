@@ -1799,6 +1799,34 @@ SEASTAR_TEST_CASE(test_collection_cell_diff) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_collection_merge_of_appended_cells) {
+    auto set_type = set_type_impl::get_instance(int32_type, true);
+    auto make = [] (tombstone t, std::vector<std::pair<int32_t, api::timestamp_type>> elements) {
+        collection_mutation_description m;
+        m.tomb = t;
+        for (auto [e, ts] : elements) {
+            m.cells.emplace_back(int32_type->decompose(e), atomic_cell::make_live(*bytes_type, ts, bytes_view()));
+        }
+        return m.serialize(*set_type);
+    };
+    auto check = [&] (const collection_mutation& a, const collection_mutation& b, const collection_mutation& expected) {
+        auto merged = merge(*set_type, a, b);
+        BOOST_REQUIRE(merged._data == expected._data);
+    };
+    const auto now = gc_clock::now();
+
+    // Appended cells
+    check(make({}, {{1, 1}, {2, 1}, {3, 1}}), make({}, {{4, 2}, {5, 2}}), make({}, {{1, 1}, {2, 1}, {3, 1}, {4, 2}, {5, 2}}));
+    check(make({}, {}), make({}, {{4, 2}}), make({}, {{4, 2}}));
+    check(make(tombstone(1, now), {{1, 2}}), make({}, {{4, 2}}), make(tombstone(1, now), {{1, 2}, {4, 2}}));
+
+    // Not appended cells
+    check(make({}, {{1, 1}, {3, 1}}), make({}, {{2, 2}, {4, 2}}), make({}, {{1, 1}, {2, 2}, {3, 1}, {4, 2}}));
+    check(make({}, {{1, 1}, {3, 1}}), make({}, {{3, 2}, {4, 2}}), make({}, {{1, 1}, {3, 2}, {4, 2}}));
+    check(make(tombstone(2, now), {{1, 3}}), make({}, {{4, 2}, {5, 3}}), make(tombstone(2, now), {{1, 3}, {5, 3}}));
+    check(make({}, {{1, 1}, {2, 3}}), make(tombstone(2, now), {{4, 3}}), make(tombstone(2, now), {{2, 3}, {4, 3}}));
+}
+
 SEASTAR_TEST_CASE(test_apply_is_commutative) {
     return seastar::async([] {
         for_each_mutation_pair([] (auto&& m1, auto&& m2, are_equal eq) {
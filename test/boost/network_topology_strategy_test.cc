@@ -11,6 +11,7 @@
 #include "utils/fb_utilities.hh"
 #include "utils/sequenced_set.hh"
 #include "locator/network_topology_strategy.hh"
+#include "locator/token_index.hh"
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
 #include <seastar/core/sstring.hh>
@@ -633,3 +634,40 @@ SEASTAR_TEST_CASE(test_invalid_dcs) {
     });
 }
 
+
+SEASTAR_THREAD_TEST_CASE(test_token_index) {
+    for (size_t n : {1, 2, 3, 7, 8, 100, 1000}) {
+        std::set<int64_t> values;
+        while (values.size() < n) {
+            values.insert(tests::random::get_int<int64_t>(std::numeric_limits<int64_t>::min() + 1, std::numeric_limits<int64_t>::max()));
+        }
+        std::vector<dht::token> sorted;
+        for (auto v : values) {
+            sorted.push_back(dht::token::from_int64(v));
+        }
+        locator::token_index index(sorted);
+        BOOST_REQUIRE(!index.empty());
+
+        auto check = [&] (const dht::token& t) {
+            auto expected = std::lower_bound(sorted.begin(), sorted.end(), t) - sorted.begin();
+            BOOST_REQUIRE_EQUAL(index.lower_bound(t), size_t(expected));
+        };
+        check(dht::minimum_token());
+        check(dht::maximum_token());
+        for (auto v : values) {
+            check(dht::token::from_int64(v));
+            if (v > std::numeric_limits<int64_t>::min() + 1) {
+                check(dht::token::from_int64(v - 1));
+            }
+            if (v < std::numeric_limits<int64_t>::max()) {
+                check(dht::token::from_int64(v + 1));
+            }
+        }
+        for (int i = 0; i < 1000; ++i) {
+            check(dht::token::get_random_token());
+        }
+    }
+
+    BOOST_REQUIRE(locator::token_index({}).empty());
+    BOOST_REQUIRE(locator::token_index({dht::minimum_token()}).empty());
+}
@@ -55,6 +55,32 @@ SEASTAR_THREAD_TEST_CASE(test_decorated_key_is_compatible_with_origin) {
     BOOST_REQUIRE(dk._key.equal(*s, key));
 }
 
+SEASTAR_THREAD_TEST_CASE(test_get_tokens_matches_get_token) {
+    dht::murmur3_partitioner partitioner;
+    for (auto s : {
+            schema_builder("ks", "cf").with_column("p", utf8_type, column_kind::partition_key).build(),
+            schema_builder("ks", "cf")
+                .with_column("c1", int32_type, column_kind::partition_key)
+                .with_column("c2", utf8_type, column_kind::partition_key)
+                .build()}) {
+        std::vector<partition_key> keys;
+        for (int i = 0; i < 23; ++i) {
+            auto text = sstring(i * 3, 'a' + i);
+            if (s->partition_key_size() == 1) {
+                keys.push_back(partition_key::from_single_value(*s, utf8_type->decompose(text)));
+            } else {
+                keys.push_back(partition_key::from_exploded(*s, {int32_type->decompose(i), utf8_type->decompose(text)}));
+            }
+        }
+        std::vector<partition_key_view> views(keys.begin(), keys.end());
+        std::vector<dht::token> tokens(keys.size());
+        partitioner.get_tokens(*s, views, tokens);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            BOOST_REQUIRE_EQUAL(tokens[i], partitioner.get_token(*s, keys[i]));
+        }
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_token_wraparound_1) {
     auto t1 = token_from_long(0x7000'0000'0000'0000);
     auto t2 = token_from_long(0xa000'0000'0000'0000);
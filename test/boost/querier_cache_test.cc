@@ -187,6 +187,10 @@ class test_querier_cache {
         return _sem;
     }
 
+    const query::querier_cache::stats& get_cache_stats() const {
+        return _cache.get_stats();
+    }
+
     dht::partition_range make_partition_range(bound begin, bound end) const {
         return dht::partition_range::make({_mutations.at(begin.value()).decorated_key(), begin.is_inclusive()},
                 {_mutations.at(end.value()).decorated_key(), end.is_inclusive()});
@@ -314,6 +318,21 @@ class test_querier_cache {
         return *this;
     }
 
+    // Looks up the querier and saves it again, like the next page of the
+    // query does.
+    test_querier_cache& assert_cache_lookup_and_save_data_querier(unsigned lookup_key,
+            const schema& lookup_schema,
+            const dht::partition_range& lookup_range,
+            const query::partition_slice& lookup_slice) {
+
+        const auto cache_key = make_cache_key(lookup_key);
+        auto querier_opt = _cache.lookup_data_querier(cache_key, lookup_schema, lookup_range, lookup_slice, nullptr, db::no_timeout);
+        BOOST_REQUIRE_EQUAL(_cache.get_stats().lookups, ++_expected_stats.lookups);
+        BOOST_REQUIRE(querier_opt);
+        _cache.insert_data_querier(cache_key, std::move(*querier_opt), nullptr);
+        return *this;
+    }
+
     test_querier_cache& assert_cache_lookup_mutation_querier(unsigned lookup_key,
             const schema& lookup_schema,
             const dht::partition_range& lookup_range,
@@ -561,6 +580,46 @@ SEASTAR_THREAD_TEST_CASE(test_time_based_cache_eviction) {
     BOOST_REQUIRE_EQUAL(t.get_semaphore().get_stats().inactive_reads, 0);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_time_based_eviction_extends_ttl_of_returning_query) {
+    test_querier_cache t(1s);
+
+    const auto entry1 = t.produce_first_page_and_save_data_querier(1);
+
+    seastar::sleep(1200ms).get();
+
+    t.assert_cache_lookup_data_querier(entry1.key, *t.get_schema(), entry1.expected_range, entry1.expected_slice)
+        .misses()
+        .no_drops()
+        .time_based_evictions();
+    BOOST_REQUIRE_EQUAL(t.get_cache_stats().misses_after_time_based_eviction, 1);
+    BOOST_REQUIRE_EQUAL(t.get_cache_stats().extended_ttl_inserts, 0);
+
+    // The query came back after its querier expired, so the next querier
+    // of the query is given twice the TTL.
+    const auto entry2 = t.produce_first_page_and_save_data_querier(1);
+    BOOST_REQUIRE_EQUAL(t.get_cache_stats().extended_ttl_inserts, 1);
+
+    seastar::sleep(1200ms).get();
+
+    t.assert_cache_lookup_and_save_data_querier(entry2.key, *t.get_schema(), entry2.expected_range, entry2.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+
+    // The querier keeps the extended TTL for the following pages.
+    seastar::sleep(1200ms).get();
+
+    t.assert_cache_lookup_data_querier(entry2.key, *t.get_schema(), entry2.expected_range, entry2.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+    BOOST_REQUIRE_EQUAL(t.get_cache_stats().extended_ttl_inserts, 1);
+
+    // Other queries get the normal TTL.
+    t.produce_first_page_and_save_data_querier(2);
+    BOOST_REQUIRE_EQUAL(t.get_cache_stats().extended_ttl_inserts, 1);
+}
+
 sstring make_string_blob(size_t size) {
     const char* const letters = "abcdefghijklmnoqprsuvwxyz";
     auto& re = seastar::testing::local_random_engine;
@@ -24,6 +24,8 @@
 #include "cql3/query_processor.hh"
 #include "cql3/untyped_result_set.hh"
 #include "cql3/cql_config.hh"
+#include "cql3/service_time_clock.hh"
+#include "cql3/statements/prepared_statement.hh"
 
 SEASTAR_TEST_CASE(test_execute_internal_insert) {
     return do_with_cql_env([] (auto& e) {
@@ -352,3 +354,57 @@ SEASTAR_TEST_CASE(test_select_full_scan_metrics) {
         BOOST_CHECK_EQUAL(stat_ps8, qp.get_cql_stats().select_partition_range_scan);
     });
 }
+
+SEASTAR_TEST_CASE(test_service_time_clock) {
+    using namespace std::chrono_literals;
+    cql3::service_time_clock clock;
+    auto t0 = cql3::service_time_clock::clock_type::now();
+
+    // An execution alone is served for its whole duration.
+    auto s = clock.start(t0);
+    BOOST_REQUIRE_EQUAL(clock.stop(s, t0 + 10ms).count(), 10000);
+
+    // Two executions at the same time share the shard.
+    auto s1 = clock.start(t0 + 10ms);
+    auto s2 = clock.start(t0 + 10ms);
+    BOOST_REQUIRE_EQUAL(clock.stop(s1, t0 + 30ms).count(), 10000);
+    // Alone again for the last 5ms.
+    BOOST_REQUIRE_EQUAL(clock.stop(s2, t0 + 35ms).count(), 15000);
+    BOOST_REQUIRE_EQUAL(clock.in_flight(), 0);
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_heavy_statement_classification_hysteresis) {
+    using namespace std::chrono_literals;
+    const std::chrono::microseconds threshold = 10ms;
+    cql3::statements::prepared_statement ps(::shared_ptr<cql3::cql_statement>{});
+
+    ps.record_service_time(1ms, threshold);
+    BOOST_REQUIRE(!ps.heavy);
+    for (int i = 0; i < 20; ++i) {
+        ps.record_service_time(20ms, threshold);
+    }
+    BOOST_REQUIRE(ps.heavy);
+
+    // Falling just below the threshold doesn't make the statement light again.
+    for (int i = 0; i < 50; ++i) {
+        ps.record_service_time(7ms, threshold);
+    }
+    BOOST_REQUIRE(ps.average_service_time < threshold);
+    BOOST_REQUIRE(ps.heavy);
+
+    // Falling below half of it does.
+    for (int i = 0; i < 50; ++i) {
+        ps.record_service_time(1ms, threshold);
+    }
+    BOOST_REQUIRE(!ps.heavy);
+
+    // Rising just above half of the threshold doesn't make it heavy.
+    for (int i = 0; i < 50; ++i) {
+        ps.record_service_time(7ms, threshold);
+    }
+    BOOST_REQUIRE(!ps.heavy);
+
+    return make_ready_future<>();
+}
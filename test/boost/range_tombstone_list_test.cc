@@ -530,6 +530,28 @@ BOOST_AUTO_TEST_CASE(test_random_list_is_not_overlapped) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_apply_monotonically_moved_list) {
+    for (uint32_t i = 0; i < 2000; ++i) {
+        range_tombstone_list l1(*s);
+        for (auto&& rt : make_random()) {
+            l1.apply(*s, rt);
+        }
+        range_tombstone_list l2(*s);
+        for (auto&& rt : make_random()) {
+            l2.apply(*s, rt);
+        }
+
+        range_tombstone_list expected(l1);
+        expected.apply(*s, l2);
+
+        range_tombstone_list l2_copy(l2);
+        l1.apply_monotonically(*s, std::move(l2_copy));
+        BOOST_REQUIRE(assert_valid(l1));
+        BOOST_REQUIRE(l2_copy.empty());
+        BOOST_REQUIRE(l1.equal(*s, expected));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_non_sorted_addition_with_one_range_with_empty_end) {
     range_tombstone_list l(*s);
 
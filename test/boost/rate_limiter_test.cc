@@ -128,3 +128,53 @@ SEASTAR_TEST_CASE(test_rate_limiter_account_operation) {
     }
     BOOST_REQUIRE(encountered_rejection);
 }
+
+SEASTAR_TEST_CASE(test_rate_limiter_replica_feedback) {
+    const uint64_t token = 0;
+    test_rate_limiter::label lbl;
+
+    test_rate_limiter limiter;
+
+    auto info_for = [] (double r) {
+        return db::per_partition_rate_limit::account_and_enforce{
+            .random_variable = uint32_t(r * double(UINT32_MAX)),
+        };
+    };
+    auto check = [&] (double r) {
+        return limiter.check_replica_feedback(lbl, token, info_for(r));
+    };
+
+    // Nothing is known about the partition yet
+    BOOST_REQUIRE(check(0.99) == test_rate_limiter::can_proceed::yes);
+
+    // The first rejections only start counting, the time window
+    // in which they happened was not observed from its beginning
+    limiter.on_rejected_by_replicas(lbl, token);
+    co_await step_seconds(1);
+    BOOST_REQUIRE(check(0.99) == test_rate_limiter::can_proceed::yes);
+
+    // Replicas reject half of the operations
+    for (int i = 0; i < 99; i++) {
+        BOOST_REQUIRE(check(0.1) == test_rate_limiter::can_proceed::yes);
+        if (i % 2 == 0) {
+            limiter.on_rejected_by_replicas(lbl, token);
+        }
+    }
+    co_await step_seconds(1);
+
+    // Now the coordinator rejects half of the operations by itself,
+    // starting from the ones with the highest random variable
+    BOOST_REQUIRE(check(0.9) == test_rate_limiter::can_proceed::no);
+    BOOST_REQUIRE(check(0.6) == test_rate_limiter::can_proceed::no);
+    BOOST_REQUIRE(check(0.4) == test_rate_limiter::can_proceed::yes);
+
+    // Without further rejections from replicas, early rejections fade out
+    co_await step_seconds(1);
+    BOOST_REQUIRE(check(0.6) == test_rate_limiter::can_proceed::yes);
+    BOOST_REQUIRE(check(0.9) == test_rate_limiter::can_proceed::no);
+    co_await step_seconds(2);
+    BOOST_REQUIRE(check(0.9) == test_rate_limiter::can_proceed::yes);
+
+    // Workaround for seastar#1072, see test_rate_limiter_time_window_wraparound_handling
+    co_await seastar::sleep(std::chrono::seconds(1));
+}
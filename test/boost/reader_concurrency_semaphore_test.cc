@@ -13,6 +13,8 @@
 #include "test/lib/random_schema.hh"
 
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/with_scheduling_group.hh>
+#include <seastar/util/defer.hh>
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
 #include <boost/test/unit_test.hpp>
@@ -560,6 +562,39 @@ SEASTAR_THREAD_TEST_CASE(reader_concurrency_semaphore_dump_reader_diganostics) {
     testlog.info("With max-lines=4: {}", semaphore.dump_diagnostics(4));
     testlog.info("With no max-lines: {}", semaphore.dump_diagnostics(0));
 }
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_sheds_reads_past_deadline) {
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, replica::new_reader_base_cost);
+    auto stop_sem = deferred_stop(semaphore);
+
+    // Admit queued reads at a rate of one per 50ms.
+    reader_permit_opt permit = semaphore.obtain_permit(nullptr, "permit", replica::new_reader_base_cost, db::no_timeout).get();
+    for (int i = 0; i < 3; ++i) {
+        auto next_fut = semaphore.obtain_permit(nullptr, "next", replica::new_reader_base_cost, db::no_timeout);
+        BOOST_REQUIRE_EQUAL(semaphore.waiters(), 1);
+        seastar::sleep(std::chrono::milliseconds(50)).get();
+        permit = {};
+        permit = next_fut.get();
+    }
+
+    auto queued_fut = semaphore.obtain_permit(nullptr, "queued", replica::new_reader_base_cost, db::no_timeout);
+
+    // With one read queued ahead, a read with 5ms left can't make it.
+    auto late_fut = semaphore.obtain_permit(nullptr, "late", replica::new_reader_base_cost, db::timeout_clock::now() + std::chrono::milliseconds(5));
+    BOOST_REQUIRE(late_fut.failed());
+    BOOST_REQUIRE_THROW(late_fut.get(), std::runtime_error);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().total_reads_shed_due_to_deadline, 1);
+
+    // One with plenty of time left can.
+    auto patient_fut = semaphore.obtain_permit(nullptr, "patient", replica::new_reader_base_cost, db::timeout_clock::now() + std::chrono::hours(1));
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 2);
+
+    permit = {};
+    permit = queued_fut.get();
+    permit = {};
+    permit = patient_fut.get();
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().total_reads_shed_due_to_deadline, 1);
+}
+
 SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_stop_waits_on_permits) {
     BOOST_TEST_MESSAGE("unused");
     {
@@ -957,3 +992,51 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_evict_inactive_reads_
         handles.clear();
     }
 }
+
+// Reads enqueued from different scheduling groups are admitted in a fair
+// order, instead of the reads of one group queueing behind all the reads of
+// a group which enqueued earlier.
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_fair_admission) {
+    simple_schema s;
+    const auto schema_ptr = s.schema().get();
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, 1024 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+
+    scheduling_group sg_a = create_scheduling_group("fair_admission_a", 100).get();
+    scheduling_group sg_b = create_scheduling_group("fair_admission_b", 100).get();
+    auto cleanup_scheduling_groups = defer([&] {
+        destroy_scheduling_group(sg_a).get();
+        destroy_scheduling_group(sg_b).get();
+    });
+
+    BOOST_REQUIRE_THROW(semaphore.set_admission_weight(sg_a, 0), std::invalid_argument);
+
+    std::vector<char> order;
+    std::vector<future<>> futures;
+    auto enqueue = [&] (scheduling_group sg, char name) {
+        with_scheduling_group(sg, [&, name] {
+            futures.push_back(semaphore.obtain_permit(schema_ptr, get_name(), 1024, db::no_timeout).then([&order, name] (reader_permit) {
+                order.push_back(name);
+            }));
+            return make_ready_future<>();
+        }).get();
+    };
+
+    reader_permit_opt permit = semaphore.obtain_permit(schema_ptr, get_name(), 1024, db::no_timeout).get();
+
+    for (int i = 0; i < 4; ++i) {
+        enqueue(sg_a, 'a');
+    }
+    enqueue(sg_b, 'b');
+    enqueue(sg_b, 'b');
+
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 6);
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(sg_a), 4);
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(sg_b), 2);
+
+    permit = {};
+    when_all_succeed(futures.begin(), futures.end()).get();
+
+    BOOST_REQUIRE_EQUAL(std::string(order.begin(), order.end()), "ababaa");
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 0);
+}
@@ -9,9 +9,12 @@
 #include "readers/from_fragments_v2.hh"
 #include "readers/upgrading_consumer.hh"
 #include "repair/hash.hh"
+#include "repair/hash_sketch.hh"
+#include "repair/row_buf_size.hh"
 #include "repair/row.hh"
 #include "repair/writer.hh"
 #include "repair/row_level.hh"
+#include "replica/range_hash_summaries.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/random_utils.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
@@ -132,3 +135,149 @@ SEASTAR_TEST_CASE(flush_repair_rows_on_wire_to_sstable) {
     });
 }
 
+
+SEASTAR_TEST_CASE(test_range_hash_summaries) {
+    auto t = [] (int64_t v) { return dht::token(dht::token::kind::key, v); };
+    auto r1 = dht::token_range::make({t(0), false}, {t(100), true});
+    auto r2 = dht::token_range::make({t(100), false}, {t(200), true});
+
+    replica::range_hash_summaries summaries;
+    BOOST_REQUIRE(!summaries.get(r1));
+
+    summaries.start(r1, 1);
+    summaries.start(r2, 1);
+    // Not recorded until the range was read.
+    BOOST_REQUIRE(!summaries.get(r1));
+    summaries.finish(r1, 1, 42);
+    summaries.finish(r2, 1, 43);
+    BOOST_REQUIRE_EQUAL(summaries.get(r1)->hash, 42);
+    BOOST_REQUIRE_EQUAL(summaries.get(r1)->seed, 1);
+    BOOST_REQUIRE_EQUAL(summaries.get(r2)->hash, 43);
+
+    // Only exact ranges have summaries.
+    BOOST_REQUIRE(!summaries.get(dht::token_range::make({t(0), false}, {t(50), true})));
+
+    // Starting with the same seed keeps the summary, with another seed drops it.
+    summaries.start(r1, 1);
+    BOOST_REQUIRE_EQUAL(summaries.get(r1)->hash, 42);
+    summaries.start(r2, 2);
+    BOOST_REQUIRE(!summaries.get(r2));
+    summaries.finish(r2, 1, 43);
+    BOOST_REQUIRE(!summaries.get(r2));
+    summaries.finish(r2, 2, 44);
+    BOOST_REQUIRE_EQUAL(summaries.get(r2)->hash, 44);
+
+    // Writes drop the summaries of the ranges they fall into.
+    summaries.invalidate(t(0));
+    BOOST_REQUIRE(summaries.get(r1));
+    summaries.invalidate(t(100));
+    BOOST_REQUIRE(!summaries.get(r1));
+    BOOST_REQUIRE(summaries.get(r2));
+
+    // A write while the range is read prevents recording its hash.
+    summaries.start(r1, 1);
+    summaries.invalidate(t(50));
+    summaries.finish(r1, 1, 42);
+    BOOST_REQUIRE(!summaries.get(r1));
+
+    summaries.invalidate(dht::token_range::make({t(150), true}, {t(300), true}));
+    BOOST_REQUIRE(summaries.empty());
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_repair_hash_sketch) {
+    repair_hash_set common;
+    for (int i = 0; i < 1000; ++i) {
+        common.insert(repair_hash(tests::random::get_int<uint64_t>()));
+    }
+    auto make_sets = [&] (size_t nr_only_in_a, size_t nr_only_in_b) {
+        auto a = common;
+        auto b = common;
+        repair_hash_set only_in_a, only_in_b;
+        for (size_t i = 0; i < nr_only_in_a; ++i) {
+            auto h = repair_hash(tests::random::get_int<uint64_t>());
+            a.insert(h);
+            only_in_a.insert(h);
+        }
+        for (size_t i = 0; i < nr_only_in_b; ++i) {
+            auto h = repair_hash(tests::random::get_int<uint64_t>());
+            b.insert(h);
+            only_in_b.insert(h);
+        }
+        return std::make_tuple(std::move(a), std::move(b), std::move(only_in_a), std::move(only_in_b));
+    };
+
+    // A difference well within the sketch size decodes.
+    {
+        auto [a, b, only_in_a, only_in_b] = make_sets(10, 5);
+        repair_hash_sketch sketch(120, a);
+        sketch.subtract(repair_hash_sketch(120, b));
+        auto diff = sketch.decode();
+        BOOST_REQUIRE(diff);
+        BOOST_REQUIRE(diff->only_in_this == only_in_a);
+        BOOST_REQUIRE(diff->only_in_other == only_in_b);
+    }
+
+    // Identical sets decode to no difference.
+    {
+        repair_hash_sketch sketch(120, common);
+        sketch.subtract(repair_hash_sketch(120, common));
+        auto diff = sketch.decode();
+        BOOST_REQUIRE(diff);
+        BOOST_REQUIRE(diff->only_in_this.empty());
+        BOOST_REQUIRE(diff->only_in_other.empty());
+    }
+
+    // A difference bigger than the sketch fails to decode.
+    {
+        auto [a, b, only_in_a, only_in_b] = make_sets(300, 300);
+        repair_hash_sketch sketch(120, a);
+        sketch.subtract(repair_hash_sketch(120, b));
+        BOOST_REQUIRE(!sketch.decode());
+    }
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_repair_row_buf_size) {
+    constexpr size_t default_size = 1 << 20;
+
+    // Synced rounds grow the size beyond the default, up to the maximum.
+    {
+        repair_row_buf_size size(default_size, 4 * default_size);
+        BOOST_REQUIRE_EQUAL(size.get(), default_size);
+        size.on_synced_round();
+        BOOST_REQUIRE_EQUAL(size.get(), 2 * default_size);
+        for (int i = 0; i < 10; ++i) {
+            size.on_synced_round();
+        }
+        BOOST_REQUIRE_EQUAL(size.get(), 4 * default_size);
+    }
+
+    // Rounds with differences shrink the size down to the minimum, and
+    // synced rounds grow it back.
+    {
+        repair_row_buf_size size(default_size, 4 * default_size);
+        size.on_round_with_diffs();
+        BOOST_REQUIRE_EQUAL(size.get(), default_size / 2);
+        for (int i = 0; i < 10; ++i) {
+            size.on_round_with_diffs();
+        }
+        BOOST_REQUIRE_EQUAL(size.get(), default_size / repair_row_buf_size::min_ratio);
+        for (int i = 0; i < 10; ++i) {
+            size.on_synced_round();
+        }
+        BOOST_REQUIRE_EQUAL(size.get(), 4 * default_size);
+    }
+
+    // Without memory for growth, the size doesn't go beyond the default.
+    {
+        repair_row_buf_size size(default_size, default_size / 2);
+        BOOST_REQUIRE_EQUAL(size.max(), default_size);
+        size.on_synced_round();
+        BOOST_REQUIRE_EQUAL(size.get(), default_size);
+    }
+
+    return make_ready_future<>();
+}
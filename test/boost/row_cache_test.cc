@@ -596,6 +596,52 @@ SEASTAR_TEST_CASE(test_query_of_incomplete_range_goes_to_underlying) {
     });
 }
 
+SEASTAR_TEST_CASE(test_scan_over_runs_of_incomplete_entries) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        std::vector<mutation> mutations = make_ring(s, 8);
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        for (auto&& m : mutations) {
+            mt->apply(m);
+        }
+
+        int underlying_reads = 0;
+        auto underlying = mutation_source([&] (schema_ptr s, reader_permit permit, const dht::partition_range& range,
+                const query::partition_slice& slice, const io_priority_class& pc, tracing::trace_state_ptr trace, streamed_mutation::forwarding fwd) {
+            ++underlying_reads;
+            return mt->make_flat_reader(s, std::move(permit), range, slice, pc, std::move(trace), std::move(fwd));
+        });
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(underlying), tracker);
+
+        // Every other partition is cached, but none of them is continuous.
+        for (size_t i = 1; i < mutations.size(); i += 2) {
+            assert_that(cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(mutations[i].decorated_key())))
+                .produces(mutations[i])
+                .produces_end_of_stream();
+        }
+
+        auto check_scan = [&] {
+            auto rd = assert_that(cache.make_reader(s, semaphore.make_permit(), query::full_partition_range));
+            for (auto&& m : mutations) {
+                rd.produces(m);
+            }
+            rd.produces_end_of_stream();
+        };
+
+        check_scan();
+
+        // The scan left the whole range continuous.
+        underlying_reads = 0;
+        check_scan();
+        BOOST_REQUIRE_EQUAL(underlying_reads, 0);
+    });
+}
+
 SEASTAR_TEST_CASE(test_single_key_queries_after_population_in_reverse_order) {
     return seastar::async([] {
         auto s = make_schema();
@@ -957,6 +1003,53 @@ SEASTAR_TEST_CASE(test_eviction_after_schema_change) {
     });
 }
 
+// With frequent-only admission, a missing partition is populated only if it
+// was read more often than the last partition evicted from the cache.
+SEASTAR_TEST_CASE(test_frequent_only_admission_compares_with_victim) {
+    return seastar::async([] {
+        auto s = schema_builder(make_schema())
+                .set_caching_options(caching_options::from_map({{"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "FREQUENT"}}))
+                .build();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto mt = make_lw_shared<replica::memtable>(s);
+        auto hot = make_new_mutation(s);
+        auto cold = make_new_mutation(s);
+        mt->apply(hot);
+        mt->apply(cold);
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto read = [&] (const mutation& m) {
+            assert_that(cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(m.decorated_key())))
+                .produces(m)
+                .produces_end_of_stream();
+        };
+
+        // Nothing was evicted yet, so the first miss populates.
+        read(hot);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admission_rejections, 0);
+        // Hits count towards the frequency too.
+        read(hot);
+        read(hot);
+
+        cache.evict();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions, 0);
+
+        // The evicted partition was read 3 times, so one which was read fewer
+        // times is not worth evicting another one like it.
+        for (int i = 0; i < 3; ++i) {
+            read(cold);
+            BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions, 0);
+            BOOST_REQUIRE_EQUAL(tracker.get_stats().admission_rejections, i + 1);
+        }
+        read(cold);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admission_rejections, 3);
+    });
+}
+
 void test_sliced_read_row_presence(flat_mutation_reader_v2 reader, schema_ptr s, std::deque<int> expected)
 {
     auto close_reader = deferred_close(reader);
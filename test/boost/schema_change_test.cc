@@ -967,3 +967,31 @@ SEASTAR_TEST_CASE(test_schema_get_reversed) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(test_schema_versions_share_column_definitions) {
+    auto s1 = schema_builder("tests", get_name())
+            .with_column("pk", bytes_type, column_kind::partition_key)
+            .with_column("ck", bytes_type, column_kind::clustering_key)
+            .with_column("v1", bytes_type)
+            .build();
+    auto s2 = schema_builder(s1)
+            .set_comment("new comment")
+            .build();
+    BOOST_REQUIRE(s1->version() != s2->version());
+
+    for (auto&& def : s2->all_columns()) {
+        BOOST_REQUIRE_EQUAL(def.column_specification.get(), s1->get_column_definition(def.name())->column_specification.get());
+    }
+
+    // The v3 layout of a CQL3 table is the schema's own.
+    BOOST_REQUIRE_EQUAL(&s1->v3().all_columns(), &s1->all_columns());
+
+    auto s3 = schema_builder(s1)
+            .with_column("v2", int32_type)
+            .build();
+    auto&& v2 = *s3->get_column_definition(to_bytes("v2"));
+    BOOST_REQUIRE_EQUAL(v2.column_specification->name->name(), to_bytes("v2"));
+    BOOST_REQUIRE(v2.column_specification->type == int32_type);
+
+    return make_ready_future<>();
+}
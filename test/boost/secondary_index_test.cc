@@ -828,6 +828,36 @@ SEASTAR_TEST_CASE(test_local_and_global_secondary_index) {
     });
 }
 
+// Rows of one partition found through the index are read from the base
+// table together, rather than with a separate read for each row.
+SEASTAR_TEST_CASE(test_local_index_base_rows_read_per_partition) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table t (p int, c int, v int, primary key(p, c))").get();
+        e.execute_cql("create index on t ((p),v)").get();
+
+        std::vector<std::vector<bytes_opt>> expected_rows;
+        for (int c = 0; c < 10; ++c) {
+            e.execute_cql(format("insert into t (p,c,v) values (1,{},7)", c)).get();
+            expected_rows.push_back({int32_type->decompose(1), int32_type->decompose(c), int32_type->decompose(7)});
+        }
+        e.execute_cql("insert into t (p,c,v) values (1,10,8)").get();
+
+        auto get_base_read_count = [&] {
+            return e.db().map_reduce0([] (replica::database& local_db) {
+                return local_db.find_column_family("ks", "t").get_stats().reads.hist.count;
+            }, 0, std::plus<int64_t>()).get0();
+        };
+
+        eventually([&] {
+            auto reads_before = get_base_read_count();
+            auto res = e.execute_cql("select * from t where p = 1 and v = 7").get0();
+            assert_that(res).is_rows().with_rows(expected_rows);
+            // Keys are fetched in batches of 1, 2, 4 and the remaining 3.
+            BOOST_REQUIRE_EQUAL(get_base_read_count() - reads_before, 4);
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_local_index_paging) {
     return do_with_cql_env_thread([] (auto& e) {
         e.execute_cql("CREATE TABLE tab (p int, c1 int, c2 int, v int, PRIMARY KEY (p, c1, c2))").get();
@@ -3792,6 +3792,16 @@ SEASTAR_TEST_CASE(test_write_many_partitions_zstd) {
             })});
 }
 
+SEASTAR_TEST_CASE(test_write_many_partitions_zstd_with_dictionary) {
+    return test_write_many_partitions(
+            "many_partitions_zstd_with_dictionary",
+            tombstone{},
+            compression_parameters{compressor::create({
+                {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+                {"dictionary_size_kb", "4"}
+            })});
+}
+
 SEASTAR_TEST_CASE(test_write_multiple_rows) {
   return test_env::do_with_async([] (test_env& env) {
     sstring table_name = "multiple_rows";
@@ -5147,24 +5157,21 @@ struct large_row_handler : public db::large_data_handler {
         start();
     }
 
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+    virtual future<> record_large_rows(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, uint64_t row_size) const override {
-        const schema_ptr s = sst.get_schema();
-        callback(*s, partition_key, clustering_key, row_size, nullptr, 0, 0);
+        callback(s, partition_key, clustering_key, row_size, nullptr, 0, 0);
         return make_ready_future<>();
     }
 
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+    virtual future<> record_large_cells(const schema& s, std::string_view sstable_name, const sstables::key& partition_key,
         const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const override {
-        const schema_ptr s = sst.get_schema();
-        callback(*s, partition_key, clustering_key, 0, &cdef, cell_size, collection_elements);
+        callback(s, partition_key, clustering_key, 0, &cdef, cell_size, collection_elements);
         return make_ready_future<>();
     }
 
-    virtual future<> record_large_partitions(const sstables::sstable& sst,
+    virtual future<> record_large_partitions(const schema& s, std::string_view sstable_name,
         const sstables::key& partition_key, uint64_t partition_size, uint64_t rows_count) const override {
-        const schema_ptr s = sst.get_schema();
-        callback(*s, partition_key, nullptr, rows_count, nullptr, 0, 0);
+        callback(s, partition_key, nullptr, rows_count, nullptr, 0, 0);
         return make_ready_future<>();
     }
 
@@ -5206,6 +5213,8 @@ static void test_sstable_write_large_row_f(schema_ptr s, reader_permit permit, r
     // depends on the encoding statistics (because of variable-length encoding). The original values
     // were chosen with the default-constructed encoding_stats, so let's keep it that way.
     sst->write_components(mt.make_flat_reader(s, std::move(permit)), 1, s, manager.configure_writer("test"), encoding_stats{}).get();
+    // Records are written in the background, stopping the handler waits for them.
+    handler.stop().get();
     BOOST_REQUIRE_EQUAL(i, expected.size());
 }
 
@@ -5263,6 +5272,7 @@ static void test_sstable_write_large_cell_f(schema_ptr s, reader_permit permit,
     // depends on the encoding statistics (because of variable-length encoding). The original values
     // were chosen with the default-constructed encoding_stats, so let's keep it that way.
     sst->write_components(mt.make_flat_reader(s, std::move(permit)), 1, s, manager.configure_writer("test"), encoding_stats{}).get();
+    handler.stop().get();
     BOOST_REQUIRE_EQUAL(i, expected.size());
 }
 
@@ -5319,6 +5329,7 @@ static void test_sstable_log_too_many_rows_f(int rows, uint64_t threshold, bool
     auto sst = manager.make_sstable(sc, dir.path().string(), generation_from_value(1), version, sstables::sstable::format_types::big);
     sst->write_components(mt->make_flat_reader(sc, semaphore.make_permit()), 1, sc, manager.configure_writer("test"), encoding_stats{}).get();
 
+    handler.stop().get();
     BOOST_REQUIRE_EQUAL(logged, expected);
 }
 
@@ -5372,6 +5383,7 @@ static void test_sstable_too_many_collection_elements_f(int elements, uint64_t t
     auto sst = manager.make_sstable(sc, dir.path().string(), generation_from_value(1), version, sstables::sstable::format_types::big);
     sst->write_components(mt->make_flat_reader(sc, semaphore.make_permit()), 1, sc, manager.configure_writer("test"), encoding_stats{}).get();
 
+    handler.stop().get();
     BOOST_REQUIRE_EQUAL(logged, expected);
 }
 
@@ -61,6 +61,7 @@
 #include <unistd.h>
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/algorithm/cxx11/none_of.hpp>
 #include <boost/algorithm/cxx11/is_sorted.hpp>
 #include <boost/icl/interval_map.hpp>
 #include "test/lib/test_services.hh"
@@ -71,6 +72,7 @@
 #include "readers/from_mutations_v2.hh"
 #include "readers/from_fragments_v2.hh"
 #include "readers/combined.hh"
+#include "mutation_source_metadata.hh"
 
 namespace fs = std::filesystem;
 
@@ -129,12 +131,19 @@ compact_sstables(sstables::compaction_descriptor descriptor, table_for_tests t,
 
 class strategy_control_for_test : public strategy_control {
     bool _has_ongoing_compaction;
+    std::vector<compaction::running_compaction> _running_compactions;
 public:
-    explicit strategy_control_for_test(bool has_ongoing_compaction) noexcept : _has_ongoing_compaction(has_ongoing_compaction) {}
+    explicit strategy_control_for_test(bool has_ongoing_compaction, std::vector<compaction::running_compaction> running_compactions = {}) noexcept
+        : _has_ongoing_compaction(has_ongoing_compaction)
+        , _running_compactions(std::move(running_compactions)) {}
 
     bool has_ongoing_compaction(table_state& table_s) const noexcept override {
         return _has_ongoing_compaction;
     }
+
+    std::vector<compaction::running_compaction> running_compactions(table_state& table_s) const override {
+        return _running_compactions;
+    }
 };
 
 static std::unique_ptr<strategy_control> make_strategy_control_for_test(bool has_ongoing_compaction) {
@@ -834,6 +843,48 @@ SEASTAR_TEST_CASE(leveled_07) {
   });
 }
 
+SEASTAR_TEST_CASE(leveled_skips_ranges_of_running_compactions) {
+  return test_env::do_with_async([] (test_env& env) {
+    table_for_tests cf(env.manager());
+
+    auto key_and_token_pair = token_generation_for_current_shard(4);
+    auto sstable_max_size = 1024*1024;
+
+    // Level 1 is over its limit and holds sstables over disjoint key ranges.
+    for (auto i = 0; i < 4; i++) {
+        add_sstable_for_leveled_test(env, cf, i, sstable_max_size * 4, /*level*/1, key_and_token_pair[i].first, key_and_token_pair[i].first);
+    }
+
+    auto candidates = get_candidates_for_leveled_strategy(*cf);
+    sstables::size_tiered_compaction_strategy_options stcs_options;
+    std::vector<std::optional<dht::decorated_key>> last_compacted_keys(leveled_manifest::MAX_LEVELS);
+    std::vector<int> compaction_counter(leveled_manifest::MAX_LEVELS);
+
+    leveled_manifest manifest = leveled_manifest::create(cf.as_table_state(), candidates, 1, stcs_options);
+    auto first = manifest.get_compaction_candidates(last_compacted_keys, compaction_counter);
+    BOOST_REQUIRE(first.level == 2);
+    BOOST_REQUIRE(first.sstables.size() == 1);
+
+    // With the first candidate being compacted, the next pick must not touch its key range.
+    auto remaining = candidates;
+    std::erase(remaining, first.sstables.front());
+    manifest = leveled_manifest::create(cf.as_table_state(), remaining, 1, stcs_options);
+    manifest.set_running_compactions({ compaction::running_compaction{first.sstables, first.level} });
+    auto second = manifest.get_compaction_candidates(last_compacted_keys, compaction_counter);
+    BOOST_REQUIRE(second.level == 2);
+    BOOST_REQUIRE(second.sstables.size() == 1);
+    BOOST_REQUIRE(second.sstables.front() != first.sstables.front());
+    BOOST_REQUIRE(!manifest.interferes_with_running_compactions(second.sstables, second.level));
+
+    // A running compaction the strategy knows nothing about holds everything back.
+    manifest.set_running_compactions({ compaction::running_compaction{} });
+    auto none = manifest.get_compaction_candidates(last_compacted_keys, compaction_counter);
+    BOOST_REQUIRE(none.sstables.empty());
+
+    cf.stop_and_keep_alive().get();
+  });
+}
+
 SEASTAR_TEST_CASE(leveled_invariant_fix) {
   return test_env::do_with_async([] (test_env& env) {
     table_for_tests cf(env.manager());
@@ -1722,6 +1773,62 @@ SEASTAR_TEST_CASE(time_window_strategy_size_tiered_behavior_correctness) {
     });
 }
 
+SEASTAR_TEST_CASE(time_window_strategy_cold_window_options) {
+    using namespace std::chrono;
+
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "time_window_strategy_cold_window")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        auto make_sstable = [&] (int first, api::timestamp_type t) {
+            std::vector<mutation> muts;
+            for (int i = first; i < first + 100; ++i) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), t);
+                muts.push_back(std::move(m));
+            }
+            return make_sstable_containing(sst_gen, std::move(muts));
+        };
+
+        std::map<sstring, sstring> options = {
+            {time_window_compaction_strategy_options::COMPACTION_WINDOW_UNIT_KEY, "HOURS"},
+            {time_window_compaction_strategy_options::COLD_WINDOW_BLOOM_FILTER_FP_CHANCE_KEY, "0.5"},
+        };
+        time_window_compaction_strategy twcs(options);
+
+        table_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+        auto control = make_strategy_control_for_test(false);
+
+        api::timestamp_type current_window_ts = api::timestamp_clock::now().time_since_epoch().count();
+        api::timestamp_type past_window_ts = current_window_ts - duration_cast<microseconds>(hours(2)).count();
+
+        std::vector<shared_sstable> past = { make_sstable(0, past_window_ts), make_sstable(100, past_window_ts) };
+
+        // The newest window is compacted with the schema's settings.
+        auto desc = twcs.get_sstables_for_compaction(cf.as_table_state(), *control, past);
+        BOOST_REQUIRE(!desc.bloom_filter_fp_chance);
+
+        // Once a newer window shows up, the past window is cold.
+        auto candidates = past;
+        candidates.push_back(make_sstable(200, current_window_ts));
+        desc = twcs.get_sstables_for_compaction(cf.as_table_state(), *control, candidates);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), 2);
+        BOOST_REQUIRE(desc.bloom_filter_fp_chance == 0.5);
+
+        auto input_filter_size = past[0]->filter_memory_size();
+        auto ret = compact_sstables(std::move(desc), cf, sst_gen).get0();
+        BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+        BOOST_REQUIRE_LT(ret.new_sstables[0]->filter_memory_size(), input_filter_size);
+    });
+}
+
 static void check_min_max_column_names(const sstable_ptr& sst, std::vector<bytes> min_components, std::vector<bytes> max_components) {
     const auto& st = sst->get_stats_metadata();
     BOOST_TEST_MESSAGE(fmt::format("min {}/{} max {}/{}", st.min_column_names.elements.size(), min_components.size(), st.max_column_names.elements.size(), max_components.size()));
@@ -1804,6 +1911,54 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(incremental_compaction_strategy_tiers_runs_test) {
+  return test_env::do_with([] (test_env& env) {
+    table_for_tests cf(env.manager());
+    std::map<sstring, sstring> opts = {
+        { "sstable_size_in_mb", "100" },
+    };
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, opts);
+    static constexpr uint64_t fragment_size = 100 * 1024 * 1024;
+
+    std::vector<sstables::shared_sstable> candidates;
+    int64_t gen = 0;
+    auto make_run = [&] (unsigned fragments) {
+        auto id = sstables::run_id::create_random_id();
+        for (unsigned i = 0; i < fragments; i++) {
+            auto sst = env.make_sstable(cf.schema(), "", gen++, la, big);
+            sstables::test(sst).set_data_file_size(fragment_size);
+            sstables::test(sst).set_run_identifier(id);
+            candidates.push_back(std::move(sst));
+        }
+    };
+    // A big run made of many fragments doesn't belong to the same tier as its fragments.
+    make_run(10);
+    unsigned small_runs = cf->schema()->min_compaction_threshold();
+    for (unsigned i = 0; i < small_runs; i++) {
+        make_run(1);
+    }
+    auto big_run = candidates.front()->run_identifier();
+
+    auto strategy_c = make_strategy_control_for_test(false);
+    auto desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), small_runs);
+    BOOST_REQUIRE(boost::algorithm::none_of(desc.sstables, [&] (const sstables::shared_sstable& sst) {
+        return sst->run_identifier() == big_run;
+    }));
+    BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, fragment_size);
+
+    // Cleanup works on whole runs.
+    auto jobs = cs.get_cleanup_compaction_jobs(cf.as_table_state(), candidates);
+    BOOST_REQUIRE_EQUAL(jobs.size(), small_runs + 1);
+    for (auto& job : jobs) {
+        BOOST_REQUIRE(boost::algorithm::all_of(job.sstables, [&] (const sstables::shared_sstable& sst) {
+            return sst->run_identifier() == job.run_identifier;
+        }));
+    }
+    return cf.stop_and_keep_alive();
+  });
+}
+
 SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     return test_env::do_with_async([] (test_env& env) {
         auto tmp = tmpdir();
@@ -1909,6 +2064,53 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     });
 }
 
+SEASTAR_TEST_CASE(size_tiered_and_leveled_drop_fully_expired_sstables) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto builder = schema_builder("tests", "expiring")
+            .with_column("pk", utf8_type, column_kind::partition_key)
+            .with_column("r1", int32_type);
+        builder.set_gc_grace_seconds(0);
+        auto s = builder.build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+        auto make_expiring_sstable = [&] (sstring key, gc_clock::time_point expiry) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), *s->get_column_definition("r1"),
+                    atomic_cell::make_live(*int32_type, api::new_timestamp(), int32_type->decompose(1), expiry, std::chrono::hours(1)));
+            return make_sstable_containing(sst_gen, {std::move(m)});
+        };
+
+        table_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+        auto strategy_c = make_strategy_control_for_test(false);
+
+        auto expired = make_expiring_sstable("expired", gc_clock::now() - std::chrono::hours(1));
+        for (auto type : {sstables::compaction_strategy_type::size_tiered, sstables::compaction_strategy_type::leveled}) {
+            auto cs = sstables::make_compaction_strategy(type, {});
+            auto descriptor = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, { expired });
+            BOOST_REQUIRE(descriptor.has_only_fully_expired);
+            BOOST_REQUIRE(descriptor.sstables == std::vector<shared_sstable>{ expired });
+        }
+
+        // sstables which will expire within expiring_sstable_skip_window aren't compacted.
+        std::vector<shared_sstable> expiring;
+        for (auto i = 0; i < s->min_compaction_threshold(); i++) {
+            expiring.push_back(make_expiring_sstable(format("expiring{}", i), gc_clock::now() + std::chrono::hours(1)));
+        }
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto descriptor = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, expiring);
+        BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), expiring.size());
+        BOOST_REQUIRE(!descriptor.has_only_fully_expired);
+
+        cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {{"expiring_sstable_skip_window", "7200"}});
+        descriptor = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, expiring);
+        BOOST_REQUIRE(descriptor.sstables.empty());
+    });
+}
+
 SEASTAR_TEST_CASE(compaction_correctness_with_partitioned_sstable_set) {
     return test_env::do_with_async([] (test_env& env) {
         cell_locker_stats cl_stats;
@@ -3754,6 +3956,27 @@ SEASTAR_TEST_CASE(test_twcs_partition_estimate) {
     });
 }
 
+SEASTAR_TEST_CASE(twcs_partition_estimate_test) {
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, {});
+    const api::timestamp_type day = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::days(1)).count();
+    const api::timestamp_type start = 100 * day;
+
+    auto estimate = [&] (api::timestamp_type min, api::timestamp_type max) {
+        mutation_source_metadata ms_meta;
+        ms_meta.min_timestamp = min;
+        ms_meta.max_timestamp = max;
+        return cs.adjust_partition_estimate(ms_meta, 100000);
+    };
+
+    BOOST_REQUIRE_EQUAL(estimate(start, start + day - 1), 100000);
+    BOOST_REQUIRE_EQUAL(estimate(start, start + day), 50000);
+    BOOST_REQUIRE_EQUAL(estimate(start + day / 2, start + 2 * day + day / 2), 100000 / 3);
+    // Data is segregated into at most max_data_segregation_window_count sstables.
+    BOOST_REQUIRE_EQUAL(estimate(start, start + 1000 * day),
+            100000 / sstables::time_window_compaction_strategy::max_data_segregation_window_count);
+    return make_ready_future<>();
+}
+
 SEASTAR_TEST_CASE(stcs_reshape_test) {
     return test_env::do_with_async([] (test_env& env) {
         simple_schema ss;
@@ -5017,3 +5240,100 @@ SEASTAR_TEST_CASE(compaction_manager_stop_and_drain_race_test) {
     testlog.info("stopping compaction manager");
     co_await cm.stop();
 }
+
+SEASTAR_TEST_CASE(test_gc_before_for_range_spanning_repaired_ranges) {
+    auto s = schema_builder("ks", "cf")
+            .with_column("p", int32_type, column_kind::partition_key)
+            .with_tombstone_gc_options(tombstone_gc_options({{"mode", "repair"}}))
+            .build();
+    per_table_history_maps maps;
+    tombstone_gc_state gc_state(&maps);
+    auto range = [] (int64_t start, int64_t end) {
+        return dht::token_range(dht::token_range::bound(dht::token::from_int64(start), false),
+                dht::token_range::bound(dht::token::from_int64(end), true));
+    };
+    const auto now = gc_clock::now();
+    const auto delay = s->tombstone_gc_options().propagation_delay_in_seconds();
+    const auto t1 = now - std::chrono::hours(2);
+    const auto t2 = now - std::chrono::hours(1);
+
+    gc_state.update_repair_time(s->id(), range(0, 100), t1);
+    gc_state.update_repair_time(s->id(), range(100, 200), t2);
+
+    // Ranges repaired at different times still cover the whole range.
+    auto res = gc_state.get_gc_before_for_range(s, range(50, 150), now);
+    BOOST_REQUIRE(res.knows_entire_range);
+    BOOST_REQUIRE(res.min_gc_before == t1 - delay);
+    BOOST_REQUIRE(res.max_gc_before == t2 - delay);
+
+    res = gc_state.get_gc_before_for_range(s, range(120, 180), now);
+    BOOST_REQUIRE(res.knows_entire_range);
+    BOOST_REQUIRE(res.min_gc_before == t2 - delay);
+
+    // Part of the range wasn't repaired.
+    res = gc_state.get_gc_before_for_range(s, range(150, 250), now);
+    BOOST_REQUIRE(!res.knows_entire_range);
+
+    // A gap between repaired ranges.
+    gc_state.update_repair_time(s->id(), range(300, 400), t2);
+    res = gc_state.get_gc_before_for_range(s, range(50, 350), now);
+    BOOST_REQUIRE(!res.knows_entire_range);
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_compaction_passes_through_single_sstable_without_tombstones) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "compaction_pass_through")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+        table_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+
+        auto make_mutation = [&] (sstring key) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::new_timestamp());
+            return m;
+        };
+        auto data_links = [] (const shared_sstable& sst) {
+            return file_stat(sst->filename(component_type::Data)).get0().number_of_links;
+        };
+        auto promote = [&] (shared_sstable sst, bool chosen_by_strategy = true) {
+            auto desc = sstables::compaction_descriptor({sst}, default_priority_class(), /*level*/1);
+            desc.can_pass_through = chosen_by_strategy;
+            auto ret = compact_sstables(std::move(desc), cf, sst_gen).get0();
+            BOOST_REQUIRE(ret.new_sstables.size() == 1);
+            BOOST_REQUIRE_EQUAL(ret.new_sstables[0]->get_sstable_level(), 1);
+            return ret.new_sstables[0];
+        };
+
+        // The Data component is shared with the input instead of being rewritten.
+        auto mut1 = make_mutation("key1");
+        auto sst = make_sstable_containing(sst_gen, {mut1});
+        auto promoted = promote(sst);
+        BOOST_REQUIRE(promoted->generation() != sst->generation());
+        BOOST_REQUIRE_EQUAL(data_links(promoted), 2);
+        BOOST_REQUIRE_EQUAL(sst->get_sstable_level(), 0);
+        assert_that(sstable_reader(promoted, s, env.make_reader_permit()))
+                .produces(mut1)
+                .produces_end_of_stream();
+
+        // Compactions not chosen by the strategy, like major compactions,
+        // rewrite their input.
+        sst = make_sstable_containing(sst_gen, {mut1});
+        promoted = promote(sst, false);
+        BOOST_REQUIRE_EQUAL(data_links(promoted), 1);
+
+        // A tombstone may have to be purged, so the sstable is compacted as usual.
+        auto mut2 = make_mutation("key2");
+        mut2.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+        sst = make_sstable_containing(sst_gen, {mut2});
+        promoted = promote(sst);
+        BOOST_REQUIRE_EQUAL(data_links(promoted), 1);
+    });
+}
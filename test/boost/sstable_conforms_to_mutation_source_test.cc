@@ -84,10 +84,12 @@ void test_cache_population_with_range_tombstone_adjacent_to_population_range(pop
             .produces_end_of_stream();
 }
 
-static future<> test_sstable_conforms_to_mutation_source(sstable_version_types version, int index_block_size) {
-    return sstables::test_env::do_with_async([version, index_block_size] (sstables::test_env& env) {
+static future<> test_sstable_conforms_to_mutation_source(sstable_version_types version, int index_block_size,
+        bool prefix_compressed_promoted_index = false) {
+    return sstables::test_env::do_with_async([version, index_block_size, prefix_compressed_promoted_index] (sstables::test_env& env) {
         sstable_writer_config cfg = env.manager().configure_writer();
         cfg.promoted_index_block_size = index_block_size;
+        cfg.prefix_compressed_promoted_index = prefix_compressed_promoted_index;
 
         std::vector<tmpdir> dirs;
         auto populate = [&env, &dirs, &cfg, version] (schema_ptr s, const std::vector<mutation>& partitions,
@@ -136,6 +138,14 @@ SEASTAR_TEST_CASE(test_sstable_conforms_to_mutation_source_md_large) {
 // This assert makes sure we don't miss writable vertions
 static_assert(writable_sstable_versions.size() == 3);
 
+SEASTAR_TEST_CASE(test_sstable_conforms_to_mutation_source_prefix_compressed_pi_tiny) {
+    return test_sstable_conforms_to_mutation_source(writable_sstable_versions.back(), block_sizes[0], true);
+}
+
+SEASTAR_TEST_CASE(test_sstable_conforms_to_mutation_source_prefix_compressed_pi_medium) {
+    return test_sstable_conforms_to_mutation_source(writable_sstable_versions.back(), block_sizes[1], true);
+}
+
 // `keys` may contain repetitions.
 // The generated position ranges are non-empty. The start of each range in the vector is greater than the end of the previous range.
 //
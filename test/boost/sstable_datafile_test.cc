@@ -3396,3 +3396,42 @@ SEASTAR_TEST_CASE(find_first_position_in_partition_from_sstable_test) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_sstable_io_stats) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp] () {
+            return env.make_sstable(s, tmp.path().string(), 1, sstables::get_highest_sstable_version(), big);
+        };
+
+        std::vector<mutation> muts;
+        for (auto& pk : ss.make_pkeys(10)) {
+            mutation m(s, pk);
+            ss.add_row(m, ss.make_ckey(0), "value");
+            muts.push_back(std::move(m));
+        }
+        auto sst = make_sstable_containing(sst_gen, muts);
+
+        using io_stats = sstables::io_stats;
+        auto stats = env.manager().get_io_stats(s->id());
+        auto total = [&] (io_stats::component c) {
+            io_stats::counters ret;
+            for (size_t r = 0; r < io_stats::reason_count; ++r) {
+                ret.merge(stats->get(c, io_stats::reason(r)));
+            }
+            return ret;
+        };
+        BOOST_REQUIRE_GE(total(io_stats::component::data).write_bytes, sst->data_size());
+        BOOST_REQUIRE_GT(total(io_stats::component::index).write_ops, 0);
+
+        auto data_read_bytes = total(io_stats::component::data).read_bytes;
+        assert_that(sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit(), query::full_partition_range))
+            .produces(muts)
+            .produces_end_of_stream();
+        auto data = total(io_stats::component::data);
+        BOOST_REQUIRE_GT(data.read_ops, 0);
+        BOOST_REQUIRE_GE(data.read_bytes - data_read_bytes, sst->data_size());
+    });
+}
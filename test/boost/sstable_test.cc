@@ -12,6 +12,8 @@
 #include <seastar/core/aligned_buffer.hh>
 #include <seastar/core/do_with.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/util/later.hh>
 #include <seastar/util/closeable.hh>
 
 #include "sstables/sstables.hh"
@@ -19,6 +21,7 @@
 #include "sstables/key.hh"
 #include "test/lib/sstable_utils.hh"
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "schema.hh"
 #include "compress.hh"
 #include "replica/database.hh"
@@ -29,6 +32,8 @@
 #include "test/lib/test_services.hh"
 #include "cell_locking.hh"
 #include "sstables/sstable_mutation_reader.hh"
+#include "utils/bloom_filter.hh"
+#include "test/lib/simple_schema.hh"
 
 #include <boost/range/combine.hpp>
 
@@ -270,6 +275,98 @@ SEASTAR_TEST_CASE(check_filter_func) {
     return check_component_integrity(component_type::Filter);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_blocked_bloom_filter) {
+    constexpr int64_t nr_keys = 10000;
+    auto key = [] (int64_t i) {
+        return bytes(to_bytes_view(sstring_view(format("key{}", i))));
+    };
+
+    auto f = utils::i_filter::get_filter(nr_keys, 0.01, utils::filter_format::blocked_format);
+    for (int64_t i = 0; i < nr_keys; ++i) {
+        f->add(key(i));
+    }
+    for (int64_t i = 0; i < nr_keys; ++i) {
+        BOOST_REQUIRE(f->is_present(key(i)));
+    }
+    int64_t false_positives = 0;
+    for (int64_t i = nr_keys; i < 2 * nr_keys; ++i) {
+        false_positives += f->is_present(key(i));
+    }
+    BOOST_REQUIRE_LT(false_positives, nr_keys / 50);
+
+    // Reconstructing the filter from its stored bits must preserve membership.
+    auto& bf = static_cast<utils::filter::bloom_filter&>(*f);
+    BOOST_REQUIRE(bf.format() == utils::filter_format::blocked_format);
+    BOOST_REQUIRE_EQUAL(bf.bits().size() % utils::filter::blocked_bloom_filter::bits_per_block, 0);
+    auto storage = bf.bits().get_storage();
+    large_bitset bs(bf.bits().size(), std::move(storage));
+    auto loaded = utils::filter::create_filter(bf.num_hashes(), std::move(bs), utils::filter_format::blocked_format);
+    for (int64_t i = 0; i < 2 * nr_keys; ++i) {
+        BOOST_REQUIRE_EQUAL(loaded->is_present(key(i)), f->is_present(key(i)));
+    }
+}
+
+SEASTAR_TEST_CASE(test_filter_memory_limit) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto tmp = tmpdir();
+        auto& mgr = env.manager();
+        auto& stats = sstables_stats::get_shard_stats();
+        unsigned long gen = 1;
+        auto make_sst = [&] (uint32_t first_key) {
+            std::vector<mutation> muts;
+            for (uint32_t i = first_key; i < first_key + 100; ++i) {
+                mutation m(s, ss.make_pkey(i));
+                ss.add_row(m, ss.make_ckey(0), "v");
+                muts.push_back(std::move(m));
+            }
+            return make_sstable_containing([&] { return env.make_sstable(s, tmp.path().string(), gen++); }, std::move(muts));
+        };
+        auto read_filter = [&] (const shared_sstable& sst, uint32_t key) {
+            return sst->filter_has_key(*s, ss.make_pkey(key).key());
+        };
+
+        auto sst1 = make_sst(0);
+        auto sst2 = make_sst(100);
+        auto sst3 = make_sst(200);
+        auto filter_memory = sst1->filter_memory_size();
+        BOOST_REQUIRE_GT(filter_memory, 0);
+        BOOST_REQUIRE_EQUAL(mgr.filter_memory(), sst1->filter_memory_size() + sst2->filter_memory_size() + sst3->filter_memory_size());
+
+        // The least recently read filter is evicted first.
+        read_filter(sst1, 0);
+        auto evictions = stats.filter_evictions;
+        mgr.set_filter_memory_limit(mgr.filter_memory() - 1);
+        BOOST_REQUIRE_EQUAL(stats.filter_evictions, evictions + 1);
+        BOOST_REQUIRE_EQUAL(sst2->filter_memory_size(), 0);
+        BOOST_REQUIRE_GT(sst1->filter_memory_size(), 0);
+        BOOST_REQUIRE_GT(sst3->filter_memory_size(), 0);
+        // Keys absent from the sstable get through the evicted filter.
+        BOOST_REQUIRE(read_filter(sst2, 1000));
+
+        // Then the next least recently read.
+        mgr.set_filter_memory_limit(mgr.filter_memory() - 1);
+        BOOST_REQUIRE_EQUAL(stats.filter_evictions, evictions + 2);
+        BOOST_REQUIRE_EQUAL(sst3->filter_memory_size(), 0);
+        BOOST_REQUIRE_GT(sst1->filter_memory_size(), 0);
+
+        // Releasing an sstable frees memory for the evicted filter which was
+        // read since its eviction, but not for the one which wasn't.
+        auto reloads = stats.filter_reloads;
+        sst1 = {};
+        while (stats.filter_reloads == reloads) {
+            seastar::sleep(1ms).get();
+        }
+        BOOST_REQUIRE_EQUAL(stats.filter_reloads, reloads + 1);
+        BOOST_REQUIRE_GT(sst2->filter_memory_size(), 0);
+        BOOST_REQUIRE_EQUAL(sst3->filter_memory_size(), 0);
+        for (uint32_t i = 100; i < 200; ++i) {
+            BOOST_REQUIRE(read_filter(sst2, i));
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(check_statistics_func) {
     auto s = make_schema_for_compressed_sstable();
     return write_and_validate_sst(std::move(s), "test/resource/sstables/compressed", [] (shared_sstable sst1, shared_sstable sst2) {
@@ -833,6 +930,111 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_compressed_stream_with_dictionary_shares_compressor) {
+    tmpdir tmp;
+    auto file_path = (tmp.path() / "test").string();
+    file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+    compression_parameters cp(compressor::create({
+        { compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor" },
+        { compression_parameters::CHUNK_LENGTH_KB, "4" },
+        { "dictionary_size_kb", "4" },
+    }));
+
+    sstables::compression c;
+    auto out = make_compressed_file_m_format_output_stream(make_file_output_stream(f, file_output_stream_options()).get0(), &c, cp);
+    sstring data;
+    for (int i = 0; data.size() < 256 * 1024; ++i) {
+        data += format("row {:d} of a compressed stream with a dictionary\n", i);
+    }
+    out.write(data.data(), data.size()).get();
+    out.close().get();
+    c.update(seastar::file_size(file_path).get0());
+
+    // Like the CompressionInfo of a loaded sstable: options, but no compressor.
+    sstables::compression loaded;
+    loaded.name = c.name;
+    loaded.options = c.options;
+    loaded.set_uncompressed_chunk_length(c.uncompressed_chunk_length());
+    loaded.offsets = std::move(c.offsets);
+    loaded.set_uncompressed_file_length(c.uncompressed_file_length());
+    loaded.update(c.compressed_file_length());
+
+    for (int read = 0; read < 2; ++read) {
+        auto in = make_compressed_file_m_format_input_stream(open_file_dma(file_path, open_flags::ro).get0(), &loaded, 0, data.size(), file_input_stream_options());
+        auto close_in = deferred_close(in);
+        auto buf = in.read_exactly(data.size()).get0();
+        BOOST_REQUIRE(std::string_view(buf.get(), buf.size()) == std::string_view(data));
+    }
+    // Both reads used the same compressor, which prepared the dictionary once.
+    auto compressor = loaded.get_compressor();
+    BOOST_REQUIRE(compressor);
+    BOOST_REQUIRE(compressor.get() == loaded.get_compressor().get());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_compressed_stream_write_errors) {
+    // Fails the writes after the first few, and records whether any write
+    // was still in flight when the sink got closed.
+    class failing_sink : public data_sink_impl {
+        unsigned _writes_left;
+        unsigned _in_flight = 0;
+        bool& _closed_with_writes_in_flight;
+    public:
+        failing_sink(unsigned writes_left, bool& closed_with_writes_in_flight)
+            : _writes_left(writes_left), _closed_with_writes_in_flight(closed_with_writes_in_flight) {}
+        virtual future<> put(net::packet) override { abort(); }
+        virtual future<> put(temporary_buffer<char>) override {
+            ++_in_flight;
+            co_await seastar::yield();
+            --_in_flight;
+            if (!_writes_left) {
+                throw std::runtime_error("injected write error");
+            }
+            --_writes_left;
+        }
+        virtual future<> flush() override { return make_ready_future<>(); }
+        virtual future<> close() override {
+            _closed_with_writes_in_flight |= _in_flight > 0;
+            return make_ready_future<>();
+        }
+    };
+
+    compression_parameters cp({
+        { compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor" },
+        { compression_parameters::CHUNK_LENGTH_KB, "4" },
+    });
+
+    for (unsigned writes_left : {0, 3}) {
+        bool closed_with_writes_in_flight = false;
+        sstables::compression c;
+        auto out = make_compressed_file_m_format_output_stream(
+                output_stream<char>(data_sink(std::make_unique<failing_sink>(writes_left, closed_with_writes_in_flight)), 4096), &c, cp);
+        temporary_buffer<char> buf(c.uncompressed_chunk_length());
+        std::fill_n(buf.get_write(), buf.size(), 'a');
+        // The error surfaces either from a later write, or from close().
+        auto write_all = [&] () -> future<> {
+            for (int i = 0; i < 16; ++i) {
+                co_await out.write(buf.get(), buf.size());
+            }
+            co_await out.flush();
+        };
+        auto f = write_all();
+        bool failed = false;
+        try {
+            f.get();
+        } catch (const std::runtime_error&) {
+            failed = true;
+        }
+        try {
+            out.close().get();
+        } catch (const std::runtime_error&) {
+            failed = true;
+        }
+        BOOST_REQUIRE(failed);
+        BOOST_REQUIRE(!closed_with_writes_in_flight);
+    }
+}
+
 // Test that sstables::key_view::tri_compare(const schema& s, partition_key_view other)
 // should correctly compare empty keys. The fact we did this incorrectly was
 // noticed while fixing #9375, and a separate issue on it is #10178.
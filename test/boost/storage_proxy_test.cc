@@ -9,12 +9,16 @@
 
 #include <seastar/core/thread.hh>
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "query-result-writer.hh"
 
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/result_set_assertions.hh"
 #include "service/storage_proxy.hh"
+#include "service/deferred_read_repair_queue.hh"
+#include "service/replica_selection.hh"
+#include "test/lib/simple_schema.hh"
 #include "query_ranges_to_vnodes.hh"
 #include "partition_slice_builder.hh"
 #include "schema_builder.hh"
@@ -103,3 +107,153 @@ SEASTAR_TEST_CASE(test_get_restricted_ranges) {
         });
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_deferred_read_repair_queue) {
+    simple_schema ss;
+    auto s = ss.schema();
+    const auto ep1 = gms::inet_address("10.0.0.1");
+    const auto ep2 = gms::inet_address("10.0.0.2");
+    auto make_diffs = [&] (const dht::decorated_key& dk, gms::inet_address ep, uint32_t ck) {
+        mutation m(s, dk);
+        ss.add_row(m, ss.make_ckey(ck), "v");
+        service::deferred_read_repair_queue::diffs_type diffs;
+        diffs[dk.token()][ep] = std::move(m);
+        return diffs;
+    };
+    auto pkeys = ss.make_pkeys(3);
+
+    service::deferred_read_repair_queue q;
+
+    // Repairs of a queued partition are merged into it.
+    q.push(make_diffs(pkeys[0], ep1, 1), 2);
+    q.push(make_diffs(pkeys[0], ep1, 2), 2);
+    q.push(make_diffs(pkeys[0], ep2, 3), 2);
+    BOOST_REQUIRE_EQUAL(q.size(), 1);
+    BOOST_REQUIRE_EQUAL(q.get_stats().queued, 1);
+
+    // Repairs of new partitions beyond the bound are dropped, but those of
+    // queued partitions are still merged.
+    q.push(make_diffs(pkeys[1], ep1, 1), 2);
+    q.push(make_diffs(pkeys[2], ep1, 1), 2);
+    q.push(make_diffs(pkeys[1], ep1, 2), 2);
+    BOOST_REQUIRE_EQUAL(q.size(), 2);
+    BOOST_REQUIRE_EQUAL(q.get_stats().queued, 2);
+    BOOST_REQUIRE_EQUAL(q.get_stats().dropped, 1);
+
+    std::map<dht::token, service::deferred_read_repair_queue::partition_diffs> popped;
+    for (auto&& diff : q.pop(1)) {
+        popped.emplace(diff.begin()->second->token(), std::move(diff));
+    }
+    BOOST_REQUIRE_EQUAL(popped.size(), 1);
+    BOOST_REQUIRE_EQUAL(q.size(), 1);
+    for (auto&& diff : q.pop(10)) {
+        popped.emplace(diff.begin()->second->token(), std::move(diff));
+    }
+    BOOST_REQUIRE(q.empty());
+    BOOST_REQUIRE_EQUAL(popped.size(), 2);
+
+    auto& p0 = popped.at(pkeys[0].token());
+    BOOST_REQUIRE_EQUAL(p0.size(), 2);
+    BOOST_REQUIRE_EQUAL(p0.at(ep1)->partition().clustered_rows().calculate_size(), 2);
+    BOOST_REQUIRE_EQUAL(p0.at(ep2)->partition().clustered_rows().calculate_size(), 1);
+    auto& p1 = popped.at(pkeys[1].token());
+    BOOST_REQUIRE_EQUAL(p1.size(), 1);
+    BOOST_REQUIRE_EQUAL(p1.at(ep1)->partition().clustered_rows().calculate_size(), 2);
+    BOOST_REQUIRE(!popped.contains(pkeys[2].token()));
+
+    // A tenth of a second worth of partitions must not be paced to nothing.
+    using namespace std::chrono_literals;
+    BOOST_REQUIRE(service::deferred_read_repair_queue::pacing_period(100, 1000) == 100ms);
+    BOOST_REQUIRE(service::deferred_read_repair_queue::pacing_period(1, 1000) == 1ms);
+    BOOST_REQUIRE(service::deferred_read_repair_queue::pacing_period(1, 3) == 333333us);
+    BOOST_REQUIRE(service::deferred_read_repair_queue::pacing_period(0, 1000) == 0us);
+}
+
+SEASTAR_TEST_CASE(test_replica_latency_tracker) {
+    using namespace std::chrono_literals;
+    using clock = service::replica_latency_tracker::clock;
+    service::replica_latency_tracker tracker;
+    auto a = gms::inet_address("127.0.0.1");
+    auto b = gms::inet_address("127.0.0.2");
+    auto c = gms::inet_address("127.0.0.3");
+    auto now = clock::now();
+    auto sorted = [&] (std::vector<gms::inet_address> replicas, clock::time_point at) {
+        tracker.sort_by_score(replicas.begin(), replicas.end(), at);
+        return replicas;
+    };
+    using replicas = std::vector<gms::inet_address>;
+
+    // Without samples, the order is kept.
+    BOOST_REQUIRE(sorted({b, a, c}, now) == replicas({b, a, c}));
+
+    tracker.request_started(a);
+    tracker.request_finished(a, 1ms, now);
+    tracker.request_started(b);
+    tracker.request_finished(b, 10ms, now);
+
+    // A replica without samples is assumed to be as fast as the average of
+    // the others, neither first nor last.
+    BOOST_REQUIRE(sorted({b, c, a}, now) == replicas({a, c, b}));
+
+    // Once a request is in flight to it, it is not picked first anymore.
+    tracker.request_started(c);
+    BOOST_REQUIRE(sorted({c, b, a}, now) == replicas({a, b, c}));
+    tracker.request_finished(c, 2ms, now);
+    BOOST_REQUIRE(sorted({c, b, a}, now) == replicas({a, c, b}));
+
+    // Requests in flight push a replica back.
+    for (int i = 0; i < 2; ++i) {
+        tracker.request_started(a);
+    }
+    BOOST_REQUIRE(sorted({a, b, c}, now) == replicas({c, b, a}));
+    for (int i = 0; i < 2; ++i) {
+        tracker.request_finished(a, 1ms, now);
+    }
+
+    // Old samples are not trusted. All replicas are unsampled again, and
+    // only the requests in flight tell them apart.
+    auto later = now + service::replica_latency_tracker::max_sample_age + 1s;
+    BOOST_REQUIRE(!tracker.latency(b, later));
+    BOOST_REQUIRE(sorted({b, a, c}, later) == replicas({b, a, c}));
+    tracker.request_started(b);
+    BOOST_REQUIRE(sorted({b, a, c}, later) == replicas({a, c, b}));
+    // The first sample after that replaces the old average.
+    tracker.request_finished(b, 3ms, later);
+    BOOST_REQUIRE_EQUAL(*tracker.latency(b, later), 3000);
+
+    // Suspected replicas come last.
+    tracker.set_suspected(a, true);
+    BOOST_REQUIRE(sorted({a, b, c}, now) == replicas({c, b, a}));
+    tracker.set_suspected(a, false);
+    BOOST_REQUIRE(sorted({a, b, c}, now) == replicas({a, c, b}));
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_retry_budget) {
+    service::retry_budget budget;
+
+    // Starts full, to let a burst through.
+    for (int i = 0; i < int(service::retry_budget::max_tokens); ++i) {
+        BOOST_REQUIRE(budget.try_withdraw());
+    }
+    BOOST_REQUIRE(!budget.try_withdraw());
+
+    // Every read deposits a fraction of a token.
+    for (int i = 0; i < 3; ++i) {
+        budget.deposit(0.25);
+        BOOST_REQUIRE(!budget.try_withdraw());
+    }
+    budget.deposit(0.25);
+    BOOST_REQUIRE(budget.try_withdraw());
+    BOOST_REQUIRE(!budget.try_withdraw());
+
+    // Savings are capped.
+    budget.deposit(100);
+    for (int i = 0; i < int(service::retry_budget::max_tokens); ++i) {
+        BOOST_REQUIRE(budget.try_withdraw());
+    }
+    BOOST_REQUIRE(!budget.try_withdraw());
+
+    return make_ready_future<>();
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "utils/timer_wheel.hh"
+
+using namespace seastar;
+using namespace std::chrono_literals;
+using clock_type = utils::coarse_timer::clock;
+
+SEASTAR_THREAD_TEST_CASE(test_timers_fire_after_their_timeout) {
+    std::vector<int> fired;
+    utils::coarse_timer t1([&] { fired.push_back(1); });
+    utils::coarse_timer t2([&] { fired.push_back(2); });
+
+    auto start = clock_type::now();
+    t2.arm(start + 80ms);
+    t1.arm(start + 20ms);
+    BOOST_REQUIRE(t1.armed());
+    BOOST_REQUIRE_EQUAL(utils::timer_wheel::local().armed_timers(), 2);
+
+    sleep(200ms).get();
+    BOOST_REQUIRE(fired == std::vector<int>({1, 2}));
+    BOOST_REQUIRE(!t1.armed());
+    BOOST_REQUIRE_EQUAL(utils::timer_wheel::local().armed_timers(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_canceled_and_destroyed_timers_do_not_fire) {
+    unsigned fired = 0;
+    utils::coarse_timer t1([&] { ++fired; });
+    t1.arm(clock_type::now() + 10ms);
+    {
+        utils::coarse_timer t2([&] { ++fired; });
+        t2.arm(clock_type::now() + 10ms);
+    }
+    BOOST_REQUIRE(t1.cancel());
+    BOOST_REQUIRE(!t1.cancel());
+    BOOST_REQUIRE_EQUAL(utils::timer_wheel::local().armed_timers(), 0);
+
+    sleep(50ms).get();
+    BOOST_REQUIRE_EQUAL(fired, 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_timers_beyond_the_first_level) {
+    bool far_fired = false;
+    bool near_fired = false;
+    utils::coarse_timer far([&] { far_fired = true; });
+    utils::coarse_timer near([&] { near_fired = true; });
+    utils::coarse_timer never([] { BOOST_FAIL("fired"); });
+
+    auto start = clock_type::now();
+    far.arm(start + utils::timer_wheel::tick * (utils::timer_wheel::level0_slots + 10));
+    near.arm(start + 10ms);
+    never.arm(clock_type::time_point::max());
+
+    sleep(100ms).get();
+    BOOST_REQUIRE(near_fired);
+    BOOST_REQUIRE(!far_fired);
+    BOOST_REQUIRE(far.armed());
+
+    sleep(far.get_timeout() - clock_type::now() + 100ms).get();
+    BOOST_REQUIRE(far_fired);
+    BOOST_REQUIRE(never.armed());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_callbacks_can_rearm) {
+    unsigned fired = 0;
+    utils::coarse_timer t;
+    t.set_callback([&] {
+        if (++fired < 3) {
+            t.arm(clock_type::now() + 10ms);
+        }
+    });
+    t.arm(clock_type::now());
+
+    sleep(200ms).get();
+    BOOST_REQUIRE_EQUAL(fired, 3);
+    BOOST_REQUIRE(!t.armed());
+}
@@ -517,6 +517,24 @@ BOOST_AUTO_TEST_CASE(test_compound_type_compare) {
         type.serialize_value({bytes("c"), bytes("b"), bytes("c")})) < 0);
 }
 
+BOOST_AUTO_TEST_CASE(test_tri_compare_matches_type_compare) {
+    auto check = [] (data_type t, std::vector<data_value> values) {
+        for (auto& a : values) {
+            for (auto& b : values) {
+                auto ba = managed_bytes(a.serialize_nonnull());
+                auto bb = managed_bytes(b.serialize_nonnull());
+                BOOST_REQUIRE(tri_compare(t, ba, bb) == t->compare(ba, bb));
+            }
+        }
+    };
+    check(utf8_type, {sstring(""), sstring("a"), sstring("aa"), sstring("b"), sstring("\xc3\xa9")});
+    check(ascii_type, {ascii_native_type{""}, ascii_native_type{"a"}, ascii_native_type{"b"}});
+    check(bytes_type, {data_value(from_hex("")), data_value(from_hex("00")), data_value(from_hex("ff")), data_value(from_hex("0100"))});
+    check(inet_addr_type, {seastar::net::inet_address("127.0.0.1"), seastar::net::inet_address("10.0.0.1"), seastar::net::inet_address("::1")});
+    check(int32_type, {int32_t(-1), int32_t(0), int32_t(1)});
+    check(reversed_type_impl::get_instance(utf8_type), {sstring("a"), sstring("b")});
+}
+
 template <typename T>
 std::optional<T>
 extract(data_value a) {
@@ -862,6 +880,49 @@ BOOST_AUTO_TEST_CASE(test_map_to_json) {
     BOOST_REQUIRE_EQUAL(to_json_string(*m, map_v.serialize()), "{\"42\": \"abc\", \"42\": \"abc\"}");
 }
 
+BOOST_AUTO_TEST_CASE(test_partially_deserialize_map_views) {
+    auto m = map_type_impl::get_instance(utf8_type, int32_type, false);
+    map_type_impl::native_type native;
+    for (int32_t i = 0; i < 1000; ++i) {
+        native.emplace_back(data_value(format("key{}", i)), data_value(i));
+    }
+    auto serialized = make_map_value(m, native).serialize_nonnull();
+    auto mb = managed_bytes(serialized);
+
+    auto views = partially_deserialize_map_views(managed_bytes_view(mb), cql_serialization_format::internal());
+    BOOST_REQUIRE_EQUAL(views.size(), native.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+        BOOST_REQUIRE(utf8_type->deserialize(views[i].first) == native[i].first);
+        BOOST_REQUIRE(int32_type->deserialize(views[i].second) == native[i].second);
+    }
+    auto copies = partially_deserialize_map(managed_bytes_view(mb), cql_serialization_format::internal());
+    BOOST_REQUIRE_EQUAL(copies.size(), views.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+        BOOST_REQUIRE(copies[i].first == managed_bytes(views[i].first));
+        BOOST_REQUIRE(copies[i].second == managed_bytes(views[i].second));
+    }
+
+    // A collection which claims more elements than it has room for is rejected before anything is allocated.
+    auto truncated = bytes(serialized.begin(), serialized.begin() + 64);
+    BOOST_REQUIRE_THROW(partially_deserialize_map_views(managed_bytes_view(bytes_view(truncated)), cql_serialization_format::internal()), marshal_exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_partially_deserialize_listlike_views) {
+    auto l = list_type_impl::get_instance(int32_type, false);
+    list_type_impl::native_type native;
+    for (int32_t i = 0; i < 1000; ++i) {
+        native.emplace_back(i);
+    }
+    auto serialized = make_list_value(l, native).serialize_nonnull();
+    auto mb = managed_bytes(serialized);
+
+    auto views = partially_deserialize_listlike_views(managed_bytes_view(mb), cql_serialization_format::internal());
+    BOOST_REQUIRE_EQUAL(views.size(), native.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+        BOOST_REQUIRE(int32_type->deserialize(views[i]) == native[i]);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_set_to_string) {
     auto m = set_type_impl::get_instance(int32_type, true);
     using native_type = std::vector<data_value>;
@@ -11,6 +11,7 @@
 #include "replica/database.hh"
 #include "db/view/view_builder.hh"
 #include "db/view/view_updating_consumer.hh"
+#include "db/view/view_update_generator.hh"
 #include "db/system_keyspace.hh"
 #include "db/system_keyspace_view_types.hh"
 #include "db/config.hh"
@@ -871,3 +872,37 @@ SEASTAR_TEST_CASE(test_load_view_build_progress_with_values_missing) {
         BOOST_REQUIRE(db::system_keyspace::load_view_build_progress().get0().empty());
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_split_staging_ranges) {
+    using vug = db::view::view_update_generator;
+    auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .build();
+    dht::ring_position_comparator cmp(*s);
+    auto is_full = [&] (const std::vector<dht::partition_range>& ranges) {
+        return ranges.size() == 1 && !ranges[0].start() && !ranges[0].end();
+    };
+
+    // Nothing to split.
+    BOOST_REQUIRE(is_full(vug::split_staging_ranges(dht::token::from_int64(-1000), dht::token::from_int64(1000), 1)));
+    BOOST_REQUIRE(is_full(vug::split_staging_ranges(dht::token::from_int64(7), dht::token::from_int64(7), 4)));
+    BOOST_REQUIRE(is_full(vug::split_staging_ranges(dht::token::from_int64(7), dht::token::from_int64(9), 4)));
+    BOOST_REQUIRE(is_full(vug::split_staging_ranges(std::vector<sstables::shared_sstable>{}, 4)));
+
+    auto ranges = vug::split_staging_ranges(dht::token::from_int64(-1000), dht::token::from_int64(1000), 4);
+    BOOST_REQUIRE_EQUAL(ranges.size(), 4);
+    // The ranges cover the whole ring, the tokens outside of the span too.
+    BOOST_REQUIRE(!ranges.front().start());
+    BOOST_REQUIRE(!ranges.back().end());
+    // They're split evenly over the span.
+    for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(dht::token::to_int64(ranges[i].end()->value().token()), -1000 + 500 * int64_t(i + 1));
+    }
+    // Every token is in exactly one range.
+    for (int64_t t : {std::numeric_limits<int64_t>::min() + 1, int64_t(-1001), int64_t(-1000), int64_t(-500), int64_t(-499),
+            int64_t(0), int64_t(1), int64_t(500), int64_t(1000), std::numeric_limits<int64_t>::max()}) {
+        auto pos = dht::ring_position::starting_at(dht::token::from_int64(t));
+        auto n = std::ranges::count_if(ranges, [&] (const dht::partition_range& r) { return r.contains(pos, cmp); });
+        BOOST_REQUIRE_EQUAL(n, 1);
+    }
+}
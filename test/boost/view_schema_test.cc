@@ -24,6 +24,8 @@
 #include "types/set.hh"
 #include "types/list.hh"
 #include "types/map.hh"
+#include "db/view/view.hh"
+#include "schema_builder.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -3161,3 +3163,88 @@ SEASTAR_TEST_CASE(test_mv_allow_some_column_drops) {
         BOOST_REQUIRE_THROW(e.execute_cql("alter table cf2 drop d").get(), exceptions::invalid_request_exception);
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_coalescer) {
+    auto s = schema_builder("ks", "mv")
+            .with_column("p", int32_type, column_kind::partition_key)
+            .with_column("c", int32_type, column_kind::clustering_key)
+            .with_column("v", int32_type)
+            .build();
+    auto make_update = [&] (int32_t p, int32_t c) {
+        mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(p)));
+        m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(c)), "v", data_value(c), 1);
+        return m;
+    };
+
+    struct sent_update {
+        std::optional<gms::inet_address> target;
+        frozen_mutation_and_schema mut;
+        size_t units;
+    };
+    std::vector<sent_update> sent;
+    db::view::stats stats("test", seastar::metrics::label_instance("ks", "ks"), seastar::metrics::label_instance("cf", "mv"));
+    db::timeout_semaphore sem(100);
+    db::view::view_update_coalescer coalescer(stats, [&] (dht::token, std::optional<gms::inet_address> target,
+            frozen_mutation_and_schema mut, db::timeout_semaphore_units units, tracing::trace_state_ptr) {
+        sent.push_back(sent_update{target, std::move(mut), units.count()});
+        return make_ready_future<>();
+    });
+    auto add = [&] (const mutation& m, gms::inet_address target) {
+        coalescer.add(m.token(), target, frozen_mutation_and_schema{freeze(m), s}, get_units(sem, 1).get0(), tracing::trace_state_ptr());
+    };
+    auto find_sent = [&] (gms::inet_address target, const mutation& m) -> sent_update& {
+        auto it = std::find_if(sent.begin(), sent.end(), [&] (const sent_update& u) {
+            return u.target == target && u.mut.fm.key().equal(*s, m.key());
+        });
+        BOOST_REQUIRE(it != sent.end());
+        return *it;
+    };
+
+    const gms::inet_address ep1("127.0.0.2");
+    const gms::inet_address ep2("127.0.0.3");
+    auto m1 = make_update(1, 1);
+    auto m2 = make_update(1, 2);
+    auto m3 = make_update(2, 1);
+
+    add(m1, ep1);
+    add(m2, ep1);
+    add(m3, ep1);
+    add(m1, ep2);
+    BOOST_REQUIRE(sent.empty());
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 96);
+
+    coalescer.flush();
+    BOOST_REQUIRE_EQUAL(sent.size(), 3);
+    BOOST_REQUIRE_EQUAL(stats.view_updates_coalesced, 1);
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 100);
+
+    // Updates to the same partition and replica are merged, and their units
+    // are held until the merged update is sent.
+    auto& merged = find_sent(ep1, m1);
+    auto expected = m1;
+    expected.apply(m2);
+    BOOST_REQUIRE_EQUAL(merged.mut.fm.unfreeze(s), expected);
+    BOOST_REQUIRE_EQUAL(merged.units, 2);
+
+    // Updates which are not merged are sent as they were given.
+    for (auto [target, m] : {std::pair(ep1, m3), std::pair(ep2, m1)}) {
+        auto& u = find_sent(target, m);
+        BOOST_REQUIRE(u.mut.fm.representation() == freeze(m).representation());
+        BOOST_REQUIRE_EQUAL(u.units, 1);
+    }
+
+    // Pending updates are sent when the window expires.
+    sent.clear();
+    add(m1, ep1);
+    sleep(db::view::view_update_coalescer::window * 10).get();
+    BOOST_REQUIRE_EQUAL(sent.size(), 1);
+
+    // Updates are sent by stop(), and right away once stopped.
+    sent.clear();
+    add(m1, ep1);
+    coalescer.stop().get();
+    BOOST_REQUIRE_EQUAL(sent.size(), 1);
+    add(m2, ep1);
+    BOOST_REQUIRE_EQUAL(sent.size(), 2);
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 100);
+}
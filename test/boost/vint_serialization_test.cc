@@ -17,6 +17,8 @@
 #include <array>
 #include <cstdint>
 #include <random>
+#include <span>
+#include <vector>
 
 using namespace seastar;
 
@@ -137,3 +139,38 @@ BOOST_AUTO_TEST_CASE(sanity_signed_examples) {
 BOOST_AUTO_TEST_CASE(sanity_signed_sweep) {
     check_roundtrip_sweep<signed_vint>(100'000, random_engine());
 }
+
+BOOST_AUTO_TEST_CASE(deserialize_many_sweep) {
+    auto& rng = random_engine();
+    std::vector<uint64_t> values;
+    std::vector<int8_t> encoded;
+    for (int i = 0; i < 10'000; ++i) {
+        // Mix long runs of single-byte values, which take the batched path, with larger ones.
+        auto v = std::uniform_int_distribution<uint64_t>()(rng);
+        values.push_back(i % 37 < 30 ? v % 128 : v >> (v % 64));
+        bytes buf(bytes::initialized_later(), max_vint_length);
+        auto len = unsigned_vint::serialize(values.back(), buf.begin());
+        encoded.insert(encoded.end(), buf.begin(), buf.begin() + len);
+    }
+
+    std::vector<uint64_t> decoded(values.size());
+    bytes_view in(encoded.data(), encoded.size());
+    size_t n = 0;
+    // Decode in uneven chunks, and through a truncated view, to exercise the stopping conditions.
+    while (n < values.size()) {
+        auto chunk = std::min(values.size() - n, size_t(1 + n % 23));
+        auto truncated = in.substr(0, std::min(in.size(), size_t(5 + n % 50)));
+        auto before = truncated.size();
+        auto got = unsigned_vint::deserialize_many(truncated, std::span(decoded.data() + n, chunk));
+        BOOST_REQUIRE_LE(got, chunk);
+        in.remove_prefix(before - truncated.size());
+        n += got;
+        if (!got) {
+            // The next vint straddles the truncation point; it must decode from the full view.
+            BOOST_REQUIRE_EQUAL(unsigned_vint::deserialize_many(in, std::span(decoded.data() + n, 1)), 1);
+            ++n;
+        }
+    }
+    BOOST_REQUIRE(in.empty());
+    BOOST_REQUIRE(decoded == values);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <random>
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "message/zstd_rpc_compressor.hh"
+
+using namespace seastar;
+using netw::zstd_rpc_compressor;
+
+static std::string linearize(const std::variant<std::vector<temporary_buffer<char>>, temporary_buffer<char>>& bufs) {
+    std::string ret;
+    std::visit([&ret] (auto& b) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(b)>, temporary_buffer<char>>) {
+            ret.append(b.get(), b.size());
+        } else {
+            for (auto& f : b) {
+                ret.append(f.get(), f.size());
+            }
+        }
+    }, bufs);
+    return ret;
+}
+
+static rpc::snd_buf make_snd_buf(const std::string& data) {
+    std::vector<temporary_buffer<char>> frags;
+    for (size_t pos = 0; pos < data.size(); pos += rpc::snd_buf::chunk_size) {
+        auto len = std::min(data.size() - pos, rpc::snd_buf::chunk_size);
+        frags.emplace_back(data.data() + pos, len);
+    }
+    rpc::snd_buf ret;
+    ret.size = data.size();
+    ret.bufs = std::move(frags);
+    return ret;
+}
+
+// Strips the head space, and splits what is left in fragments of the given size,
+// as the receiving side may get them.
+static rpc::rcv_buf to_rcv_buf(const rpc::snd_buf& buf, size_t head_space, size_t fragment_size) {
+    auto data = linearize(buf.bufs).substr(head_space);
+    std::vector<temporary_buffer<char>> frags;
+    for (size_t pos = 0; pos < data.size(); pos += fragment_size) {
+        frags.emplace_back(data.data() + pos, std::min(data.size() - pos, fragment_size));
+    }
+    rpc::rcv_buf ret(data.size());
+    ret.bufs = std::move(frags);
+    return ret;
+}
+
+static std::string round_trip(zstd_rpc_compressor& c, const std::string& data, size_t fragment_size, size_t* wire_size = nullptr) {
+    constexpr size_t head_space = 4;
+    auto compressed = c.compress(head_space, make_snd_buf(data));
+    BOOST_REQUIRE_EQUAL(compressed.size, linearize(compressed.bufs).size());
+    if (wire_size) {
+        *wire_size = compressed.size - head_space;
+    }
+    auto uncompressed = c.decompress(to_rcv_buf(compressed, head_space, fragment_size));
+    auto ret = linearize(uncompressed.bufs);
+    BOOST_REQUIRE_EQUAL(uncompressed.size, ret.size());
+    return ret;
+}
+
+static std::string random_data(size_t size) {
+    std::mt19937 gen(size);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::string ret(size, 0);
+    for (auto& c : ret) {
+        c = char(dist(gen));
+    }
+    return ret;
+}
+
+static std::string compressible_data(size_t size) {
+    std::string ret;
+    for (unsigned i = 0; ret.size() < size; ++i) {
+        ret += format("partition key {} clustering key {} value {};", i % 97, i, i % 13);
+    }
+    ret.resize(size);
+    return ret;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_round_trip) {
+    zstd_rpc_compressor c;
+    for (auto size : {0, 1, 100, 4096, 256 * 1024}) {
+        for (auto fragment_size : {3, 1000, 1 << 20}) {
+            auto data = compressible_data(size);
+            size_t wire_size;
+            BOOST_REQUIRE(round_trip(c, data, fragment_size, &wire_size) == data);
+            if (size >= 4096) {
+                BOOST_REQUIRE_LT(wire_size, data.size() / 2);
+            }
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_incompressible_messages_are_sent_uncompressed) {
+    zstd_rpc_compressor c;
+    auto data = random_data(64 * 1024);
+    size_t wire_size;
+    for (int i = 0; i < 10; ++i) {
+        BOOST_REQUIRE(round_trip(c, data, 1000, &wire_size) == data);
+        BOOST_REQUIRE_EQUAL(wire_size, data.size() + zstd_rpc_compressor::header_size);
+    }
+
+    // Compression resumes once messages compress again.
+    auto compressible = compressible_data(64 * 1024);
+    bool compressed = false;
+    for (unsigned i = 0; i <= zstd_rpc_compressor::max_skipped_messages && !compressed; ++i) {
+        BOOST_REQUIRE(round_trip(c, compressible, 1000, &wire_size) == compressible);
+        compressed = wire_size < compressible.size() / 2;
+    }
+    BOOST_REQUIRE(compressed);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_corrupted_message) {
+    zstd_rpc_compressor c;
+    auto data = compressible_data(64 * 1024);
+    auto compressed = c.compress(0, make_snd_buf(data));
+    auto wire = linearize(compressed.bufs);
+    auto truncated = rpc::rcv_buf(temporary_buffer<char>(wire.data(), wire.size() / 2));
+    BOOST_REQUIRE_THROW(c.decompress(std::move(truncated)), std::runtime_error);
+    auto header_only = rpc::rcv_buf(temporary_buffer<char>(wire.data(), 2));
+    BOOST_REQUIRE_THROW(c.decompress(std::move(header_only)), std::runtime_error);
+
+    // The compressor is still usable.
+    BOOST_REQUIRE(round_trip(c, data, 1000) == data);
+}
@@ -82,6 +82,7 @@ future<scheduling_groups> get_scheduling_groups() {
         _scheduling_groups->memory_compaction_scheduling_group = co_await create_scheduling_group("mem_compaction", 1000);
         _scheduling_groups->streaming_scheduling_group = co_await create_scheduling_group("streaming", 200);
         _scheduling_groups->statement_scheduling_group = co_await create_scheduling_group("statement", 1000);
+        _scheduling_groups->heavy_statement_scheduling_group = co_await create_scheduling_group("heavy_statement", 200);
         _scheduling_groups->memtable_scheduling_group = co_await create_scheduling_group("memtable", 1000);
         _scheduling_groups->memtable_to_cache_scheduling_group = co_await create_scheduling_group("memtable_to_cache", 200);
         _scheduling_groups->gossip_scheduling_group = co_await create_scheduling_group("gossip", 1000);
@@ -658,6 +659,7 @@ class single_node_cql_env : public cql_test_env {
             dbcfg.memory_compaction_scheduling_group = scheduling_groups.memory_compaction_scheduling_group;
             dbcfg.streaming_scheduling_group = scheduling_groups.streaming_scheduling_group;
             dbcfg.statement_scheduling_group = scheduling_groups.statement_scheduling_group;
+            dbcfg.heavy_statement_scheduling_group = scheduling_groups.heavy_statement_scheduling_group;
             dbcfg.memtable_scheduling_group = scheduling_groups.memtable_scheduling_group;
             dbcfg.memtable_to_cache_scheduling_group = scheduling_groups.memtable_to_cache_scheduling_group;
             dbcfg.gossip_scheduling_group = scheduling_groups.gossip_scheduling_group;
@@ -672,6 +674,8 @@ class single_node_cql_env : public cql_test_env {
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .shares_smoothing = std::chrono::milliseconds(cfg->compaction_shares_smoothing_in_ms()),
+                    .max_concurrent_offstrategy_compactions = std::max(cfg->max_concurrent_offstrategy_compactions(), 1u),
                 };
             });
             cm.start(std::move(get_cm_cfg), std::ref(abort_sources)).get();
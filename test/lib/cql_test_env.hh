@@ -69,6 +69,7 @@ struct scheduling_groups {
     scheduling_group memory_compaction_scheduling_group;
     scheduling_group streaming_scheduling_group;
     scheduling_group statement_scheduling_group;
+    scheduling_group heavy_statement_scheduling_group;
     scheduling_group memtable_scheduling_group;
     scheduling_group memtable_to_cache_scheduling_group;
     scheduling_group gossip_scheduling_group;
@@ -312,3 +312,30 @@ SEASTAR_TEST_CASE(test_block_partition_row) {
         flock1.get0();
     });
 }
+// Locking several rows at once blocks locks on any of those rows and on the
+// entire partition, but not on other rows of the partition.
+SEASTAR_TEST_CASE(test_block_several_rows) {
+    return seastar::async([&] {
+        auto s = make_schema();
+        row_locker rl(s);
+        auto pk = make_pk(s, "pk1");
+        auto ck1 = make_ck(s, "ck1");
+        auto ck2 = make_ck(s, "ck2");
+        auto ck3 = make_ck(s, "ck3");
+        auto lock = rl.lock_cks(pk, {ck2, ck1, ck2}, true, db::timeout_clock::time_point::max(), row_locker_stats).get0();
+        auto flock1 = rl.lock_ck(pk, ck1, false, db::timeout_clock::time_point::max(), row_locker_stats);
+        auto flock2 = rl.lock_ck(pk, ck2, true, db::timeout_clock::time_point::max(), row_locker_stats);
+        auto flock3 = rl.lock_pk(pk, true, db::timeout_clock::time_point::max(), row_locker_stats);
+        BOOST_REQUIRE(!flock1.available());
+        BOOST_REQUIRE(!flock2.available());
+        BOOST_REQUIRE(!flock3.available());
+        auto lock3 = rl.lock_ck(pk, ck3, true, db::timeout_clock::time_point::max(), row_locker_stats).get0();
+        auto ignore = [] (auto) { };
+        ignore(std::move(lock));
+        ignore(std::move(lock3));
+        ignore(flock1.get0());
+        ignore(flock2.get0());
+        ignore(flock3.get0());
+        BOOST_REQUIRE(rl.empty() == true);
+    });
+}
@@ -49,8 +49,9 @@ std::ostream& operator<<(std::ostream& out, const scheduling_latency_measurer& s
 
 std::ostream&
 operator<<(std::ostream& os, const perf_result& result) {
-    fmt::print(os, "{:.2f} tps ({:5.1f} allocs/op, {:5.1f} tasks/op, {:7.0f} insns/op, {:8} errors)",
-            result.throughput, result.mallocs_per_op, result.tasks_per_op, result.instructions_per_op, result.errors);
+    fmt::print(os, "{:.2f} tps ({:5.1f} allocs/op, {:5.1f} tasks/op, {:7.0f} insns/op, {:8} errors, p50 {} us, p99 {} us, max {} us)",
+            result.throughput, result.mallocs_per_op, result.tasks_per_op, result.instructions_per_op, result.errors,
+            result.latency_p50, result.latency_p99, result.latency_max);
     return os;
 }
 
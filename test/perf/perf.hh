@@ -12,6 +12,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/core/sleep.hh>
 #include <seastar/coroutine/as_future.hh>
 #include "seastarx.hh"
 #include "utils/extremum_tracking.hh"
@@ -53,6 +54,8 @@ struct executor_shard_stats {
     uint64_t tasks_executed = 0;
     uint64_t instructions_retired = 0;
     uint64_t errors = 0;
+    // Latencies of the invocations, in microseconds.
+    utils::estimated_histogram latencies;
 };
 
 inline
@@ -63,6 +66,7 @@ operator+(executor_shard_stats a, executor_shard_stats b) {
     a.tasks_executed += b.tasks_executed;
     a.instructions_retired += b.instructions_retired;
     a.errors += b.errors;
+    a.latencies.merge(b.latencies);
     return a;
 }
 
@@ -74,6 +78,7 @@ operator-(executor_shard_stats a, executor_shard_stats b) {
     a.tasks_executed -= b.tasks_executed;
     a.instructions_retired -= b.instructions_retired;
     a.errors -= b.errors;
+    // Latencies are only collected between the snapshots, so a's are kept as is.
     return a;
 }
 
@@ -82,22 +87,44 @@ uint64_t perf_mallocs();
 
 // Drives concurrent and continuous execution of given asynchronous action
 // until a deadline. Counts invocations and collects statistics.
+//
+// With a non-zero rate, invocations are started at that many per second
+// (open loop) instead of back to back, as long as there are free workers.
+// Latencies are then measured from the time an invocation should have
+// started, so that a stalled server shows up in them rather than only in
+// a lower throughput.
 template <typename Func>
 class executor {
+    using clk = std::chrono::steady_clock;
+
     const Func _func;
     const lowres_clock::time_point _end_at;
     const uint64_t _end_at_count;
     const unsigned _n_workers;
     const bool _stop_on_error;
+    const unsigned _rate;
     uint64_t _count;
     uint64_t _errors;
+    clk::time_point _start;
+    utils::estimated_histogram _latencies;
     linux_perf_event _instructions_retired_counter = linux_perf_event::user_instructions_retired();
 private:
     executor_shard_stats executor_shard_stats_snapshot();
     future<> run_worker() {
         while (_end_at_count ? _count < _end_at_count : lowres_clock::now() < _end_at) {
-            ++_count;
+            auto start = clk::now();
+            if (_rate) {
+                auto scheduled = _start + std::chrono::duration_cast<clk::duration>(std::chrono::duration<double>(double(_count) / _rate));
+                ++_count;
+                if (scheduled > start) {
+                    co_await seastar::sleep(scheduled - start);
+                }
+                start = scheduled;
+            } else {
+                ++_count;
+            }
             future<> f = co_await coroutine::as_future(_func());
+            _latencies.add(std::chrono::duration_cast<std::chrono::microseconds>(clk::now() - start).count());
             if (f.failed()) {
                 ++_errors;
                 if (_stop_on_error) [[unlikely]] {
@@ -108,18 +135,20 @@ class executor {
         }
     }
 public:
-    executor(unsigned n_workers, Func func, lowres_clock::time_point end_at, uint64_t end_at_count = 0, bool stop_on_error = true)
+    executor(unsigned n_workers, Func func, lowres_clock::time_point end_at, uint64_t end_at_count = 0, bool stop_on_error = true, unsigned rate = 0)
             : _func(std::move(func))
             , _end_at(end_at)
             , _end_at_count(end_at_count)
             , _n_workers(n_workers)
             , _stop_on_error(stop_on_error)
+            , _rate(rate)
             , _count(0)
             , _errors(0)
     { }
 
     // Returns the number of invocations of @func
     future<executor_shard_stats> run() {
+        _start = clk::now();
         auto stats_start = executor_shard_stats_snapshot();
         _instructions_retired_counter.enable();
         auto idx = boost::irange(0, (int)_n_workers);
@@ -146,6 +175,7 @@ executor<Func>::executor_shard_stats_snapshot() {
         .tasks_executed = perf_tasks_processed(),
         .instructions_retired = _instructions_retired_counter.read(),
         .errors = _errors,
+        .latencies = _latencies,
     };
 }
 
@@ -155,6 +185,10 @@ struct perf_result {
     double tasks_per_op;
     double instructions_per_op;
     uint64_t errors;
+    // Latency percentiles, in microseconds.
+    int64_t latency_p50;
+    int64_t latency_p99;
+    int64_t latency_max;
 };
 
 std::ostream& operator<<(std::ostream& os, const perf_result& result);
@@ -180,12 +214,15 @@ std::ostream& operator<<(std::ostream& os, const perf_result_with_aio_writes& re
  *
  * Runs many iterations. Prints partial total throughput after each iteraton.
  *
+ * With a non-zero rate_per_core, the action is started at that rate on each
+ * core instead of back to back, see executor.
+ *
  * Returns a vector of throughputs achieved in each iteration.
  */
 template <typename Res, typename Func, typename UpdateFunc = void(*)(const Res&, const executor_shard_stats&)>
 requires (std::is_base_of_v<perf_result, Res> && std::is_invocable_v<UpdateFunc, Res&, const executor_shard_stats&>)
 static
-std::vector<Res> time_parallel_ex(Func func, unsigned concurrency_per_core, int iterations = 5, unsigned operations_per_shard = 0, bool stop_on_error = true, UpdateFunc uf = [](const auto&, const auto&) {}) {
+std::vector<Res> time_parallel_ex(Func func, unsigned concurrency_per_core, int iterations = 5, unsigned operations_per_shard = 0, bool stop_on_error = true, UpdateFunc uf = [](const auto&, const auto&) {}, unsigned rate_per_core = 0) {
     using clk = std::chrono::steady_clock;
     if (operations_per_shard) {
         iterations = 1;
@@ -196,7 +233,7 @@ std::vector<Res> time_parallel_ex(Func func, unsigned concurrency_per_core, int
         auto end_at = lowres_clock::now() + std::chrono::seconds(1);
         distributed<executor<Func>> exec;
         Res result;
-        exec.start(concurrency_per_core, func, std::move(end_at), operations_per_shard, stop_on_error).get();
+        exec.start(concurrency_per_core, func, std::move(end_at), operations_per_shard, stop_on_error, rate_per_core).get();
         auto stop_exec = defer([&exec] {
             exec.stop().get();
         });
@@ -210,6 +247,9 @@ std::vector<Res> time_parallel_ex(Func func, unsigned concurrency_per_core, int
         result.tasks_per_op = double(stats.tasks_executed) / stats.invocations;
         result.instructions_per_op = double(stats.instructions_retired) / stats.invocations;
         result.errors = stats.errors;
+        result.latency_p50 = stats.latencies.percentile(0.5);
+        result.latency_p99 = stats.latencies.percentile(0.99);
+        result.latency_max = stats.latencies.max();
 
         uf(result, stats);
 
@@ -221,8 +261,9 @@ std::vector<Res> time_parallel_ex(Func func, unsigned concurrency_per_core, int
 
 template <typename Func>
 static
-std::vector<perf_result> time_parallel(Func func, unsigned concurrency_per_core, int iterations = 5, unsigned operations_per_shard = 0, bool stop_on_error = true) {
-    return time_parallel_ex<perf_result>(std::move(func), concurrency_per_core, iterations, operations_per_shard, stop_on_error);
+std::vector<perf_result> time_parallel(Func func, unsigned concurrency_per_core, int iterations = 5, unsigned operations_per_shard = 0, bool stop_on_error = true, unsigned rate_per_core = 0) {
+    return time_parallel_ex<perf_result>(std::move(func), concurrency_per_core, iterations, operations_per_shard, stop_on_error,
+            [] (const auto&, const auto&) {}, rate_per_core);
 }
 
 template<typename Func>
@@ -12,6 +12,7 @@
 #include <random>
 
 #include "utils/big_decimal.hh"
+#include "utils/big_number_accumulator.hh"
 #include "test/lib/make_random_string.hh"
 
 struct big_decimal_test {
@@ -23,6 +24,15 @@ struct big_decimal_test {
     const sstring neg_data_neg_exponent = "-" + make_random_numeric_string(18) + "E-" + make_random_numeric_string(7);
     const sstring neg_data_fraction_exponent = "-" + make_random_numeric_string(14) + "E" + make_random_numeric_string(6);
     const sstring neg_data_fraction_neg_exponent = "-" + make_random_numeric_string(14) + "E-" + make_random_numeric_string(6);
+
+    // Amounts of money, as summed by financial reports.
+    const std::vector<big_decimal> amounts = [] {
+        std::vector<big_decimal> ret;
+        for (int i = 0; i < 100; ++i) {
+            ret.emplace_back(make_random_numeric_string(8) + "." + make_random_numeric_string(2));
+        }
+        return ret;
+    }();
 };
 
 PERF_TEST_F(big_decimal_test, from_string) {
@@ -36,3 +46,19 @@ PERF_TEST_F(big_decimal_test, from_string) {
     perf_tests::do_not_optimize(big_decimal{neg_data_fraction_neg_exponent});
 }
 
+
+PERF_TEST_F(big_decimal_test, sum) {
+    big_decimal sum;
+    for (auto& v : amounts) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+}
+
+PERF_TEST_F(big_decimal_test, sum_accumulator) {
+    utils::decimal_accumulator sum;
+    for (auto& v : amounts) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum.get());
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <unordered_map>
+
+#include <boost/range/adaptor/transformed.hpp>
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/util/defer.hh>
+
+#include "message/messaging_service.hh"
+#include "locator/token_metadata.hh"
+#include "frozen_mutation.hh"
+#include "mutation_query.hh"
+#include "query-result.hh"
+#include "cache_temperature.hh"
+#include "full_position.hh"
+#include "replica/exceptions.hh"
+#include "db/view/view_update_backlog.hh"
+#include "service/paxos/prepare_response.hh"
+#include "service/paxos/proposal.hh"
+#include "repair/hash.hh"
+#include "idl/storage_proxy.dist.hh"
+#include "utils/fb_utilities.hh"
+#include "test/lib/random_utils.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/perf/perf.hh"
+
+/// Measures the cost of inter-node verbs over the real RPC stack.
+///
+/// The node talks to itself over loopback: every shard sends requests to the
+/// messaging_service of --target-shards shards, each over its own connection,
+/// and the handlers answer with prepared payloads without touching any
+/// replica, so that only serialization and RPC are measured. Since both sides
+/// run in this process, insns/op on a single shard covers both the client and
+/// the server.
+///
+/// Messaging service compresses and sets TCP_NODELAY on all connections to
+/// nodes which are not in its topology, so --compress toggles between no
+/// compression and compressing everything, and TCP_NODELAY is always set.
+///
+/// Example run:
+///
+///    $ build/release/test/perf/perf_messaging_g -c2 --verb read_data --rows 100 --compress true
+///
+
+using namespace std::chrono_literals;
+
+struct test_config {
+    sstring verb;
+    unsigned concurrency;
+    unsigned duration_in_seconds;
+    unsigned operations_per_shard = 0;
+    unsigned rate = 0;
+    unsigned rows;
+    unsigned cell_size;
+    unsigned target_shards;
+};
+
+class verb_bench {
+    netw::messaging_service& _ms;
+    test_config _cfg;
+    gms::inet_address _address;
+    simple_schema _ss;
+    schema_ptr _s;
+    frozen_mutation _fm;
+    query::read_command _cmd;
+    dht::partition_range _pr;
+    lw_shared_ptr<query::result> _result;
+    lw_shared_ptr<reconcilable_result> _mutation_result;
+    repair_hash_set _hashes;
+    uint64_t _next_response_id = 0;
+    std::unordered_map<uint64_t, promise<>> _pending_writes;
+    unsigned _next_target = 0;
+private:
+    static mutation make_payload(simple_schema& ss, const test_config& cfg) {
+        mutation m(ss.schema(), ss.make_pkey(0));
+        for (unsigned i = 0; i < cfg.rows; ++i) {
+            ss.add_row(m, ss.make_ckey(i), tests::random::get_sstring(cfg.cell_size));
+        }
+        return m;
+    }
+
+    netw::msg_addr next_target() {
+        auto shard = (this_shard_id() + _next_target++ % _cfg.target_shards) % smp::count;
+        return netw::msg_addr{_address, shard};
+    }
+
+    future<> send_mutation(netw::msg_addr addr, netw::messaging_service::clock_type::time_point timeout) {
+        auto id = _next_response_id++;
+        auto done = _pending_writes[id].get_future();
+        try {
+            co_await ser::storage_proxy_rpc_verbs::send_mutation(&_ms, addr, timeout, _fm, inet_address_vector_replica_set(),
+                    _address, this_shard_id(), id, std::nullopt, db::per_partition_rate_limit::info());
+        } catch (...) {
+            _pending_writes.erase(id);
+            throw;
+        }
+        co_await std::move(done);
+    }
+public:
+    verb_bench(netw::messaging_service& ms, test_config cfg, gms::inet_address address)
+        : _ms(ms)
+        , _cfg(std::move(cfg))
+        , _address(address)
+        , _s(_ss.schema())
+        , _fm(freeze(make_payload(_ss, _cfg)))
+        , _cmd(_s->id(), _s->version(), _s->full_slice(), query::max_result_size(std::numeric_limits<uint64_t>::max()), query::tombstone_limit::max)
+        , _pr(dht::partition_range::make_singular(_ss.make_pkey(0)))
+        , _result(make_lw_shared<query::result>(query_mutation(_fm.unfreeze(_s), _s->full_slice())))
+    {
+        utils::chunked_vector<reconcilable_result::partition> partitions;
+        partitions.emplace_back(uint64_t(_cfg.rows), _fm);
+        _mutation_result = make_lw_shared<reconcilable_result>(uint64_t(_cfg.rows), std::move(partitions), query::short_read::no);
+        for (unsigned i = 0; i < _cfg.rows; ++i) {
+            _hashes.insert(repair_hash(tests::random::get_int<uint64_t>()));
+        }
+    }
+
+    // Sizes of the payload of a request and of its response, before compression.
+    std::pair<size_t, size_t> payload_sizes() const {
+        auto row_hashes_size = _hashes.size() * sizeof(uint64_t);
+        if (_cfg.verb == "mutation") {
+            return {_fm.representation().size(), 0};
+        } else if (_cfg.verb == "read_data") {
+            return {0, _result->buf().size()};
+        } else if (_cfg.verb == "read_mutation_data") {
+            return {0, _fm.representation().size()};
+        } else if (_cfg.verb == "repair_get_full_row_hashes") {
+            return {0, row_hashes_size};
+        }
+        return {0, 0};
+    }
+
+    void start() {
+        // The handlers reply the way storage_proxy and repair do, but with prepared payloads.
+        ser::storage_proxy_rpc_verbs::register_mutation(&_ms, [this] (const rpc::client_info&, rpc::opt_time_point,
+                frozen_mutation, inet_address_vector_replica_set, gms::inet_address reply_to, unsigned shard, uint64_t response_id,
+                rpc::optional<std::optional<tracing::trace_info>>, rpc::optional<db::per_partition_rate_limit::info>) {
+            return ser::storage_proxy_rpc_verbs::send_mutation_done(&_ms, netw::msg_addr{reply_to, shard}, shard, response_id,
+                    db::view::update_backlog::no_backlog()).then_wrapped([] (future<> f) {
+                f.ignore_ready_future();
+                return netw::messaging_service::no_wait();
+            });
+        });
+        ser::storage_proxy_rpc_verbs::register_mutation_done(&_ms, [this] (const rpc::client_info&, unsigned, uint64_t response_id,
+                rpc::optional<db::view::update_backlog>) {
+            if (auto it = _pending_writes.find(response_id); it != _pending_writes.end()) {
+                it->second.set_value();
+                _pending_writes.erase(it);
+            }
+            return make_ready_future<rpc::no_wait_type>(netw::messaging_service::no_wait());
+        });
+        ser::storage_proxy_rpc_verbs::register_read_data(&_ms, [this] (const rpc::client_info&, rpc::opt_time_point,
+                query::read_command, ::compat::wrapping_partition_range, rpc::optional<query::digest_algorithm>,
+                rpc::optional<db::per_partition_rate_limit::info>) {
+            return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature, replica::exception_variant>>(
+                    make_foreign(_result), cache_temperature::invalid(), replica::exception_variant());
+        });
+        ser::storage_proxy_rpc_verbs::register_read_mutation_data(&_ms, [this] (const rpc::client_info&, rpc::opt_time_point,
+                query::read_command, ::compat::wrapping_partition_range) {
+            return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature, replica::exception_variant>>(
+                    make_foreign(_mutation_result), cache_temperature::invalid(), replica::exception_variant());
+        });
+        ser::storage_proxy_rpc_verbs::register_read_digest(&_ms, [] (const rpc::client_info&, rpc::opt_time_point,
+                query::read_command, ::compat::wrapping_partition_range, rpc::optional<query::digest_algorithm>,
+                rpc::optional<db::per_partition_rate_limit::info>) {
+            using result_type = rpc::tuple<query::result_digest, long, cache_temperature, replica::exception_variant, std::optional<full_position>>;
+            return make_ready_future<result_type>(query::result_digest(), api::missing_timestamp, cache_temperature::invalid(),
+                    replica::exception_variant(), std::nullopt);
+        });
+        _ms.register_repair_get_full_row_hashes([this] (const rpc::client_info&, uint32_t) {
+            return make_ready_future<repair_hash_set>(_hashes);
+        });
+    }
+
+    future<> stop() {
+        co_await ser::storage_proxy_rpc_verbs::unregister(&_ms);
+        co_await _ms.unregister_repair_get_full_row_hashes();
+    }
+
+    future<> send() {
+        auto addr = next_target();
+        auto timeout = netw::messaging_service::clock_type::now() + 10s;
+        if (_cfg.verb == "mutation") {
+            co_await send_mutation(addr, timeout);
+        } else if (_cfg.verb == "read_data") {
+            co_await ser::storage_proxy_rpc_verbs::send_read_data(&_ms, addr, timeout, _cmd, _pr,
+                    query::digest_algorithm::none, db::per_partition_rate_limit::info());
+        } else if (_cfg.verb == "read_mutation_data") {
+            co_await ser::storage_proxy_rpc_verbs::send_read_mutation_data(&_ms, addr, timeout, _cmd, _pr);
+        } else if (_cfg.verb == "read_digest") {
+            co_await ser::storage_proxy_rpc_verbs::send_read_digest(&_ms, addr, timeout, _cmd, _pr,
+                    query::digest_algorithm::xxHash, db::per_partition_rate_limit::info());
+        } else if (_cfg.verb == "repair_get_full_row_hashes") {
+            co_await _ms.send_repair_get_full_row_hashes(addr, 0);
+        } else {
+            throw std::invalid_argument(format("Unknown verb: {}", _cfg.verb));
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("verb", bpo::value<sstring>()->default_value("mutation"), "verb to send: mutation, read_data, read_mutation_data, read_digest or repair_get_full_row_hashes")
+        ("duration", bpo::value<unsigned>()->default_value(5), "test duration in seconds")
+        ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
+        ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
+        ("rate", bpo::value<unsigned>()->default_value(0), "send this many requests per second on each core instead of back to back, 0 to disable")
+        ("rows", bpo::value<unsigned>()->default_value(10), "rows in the mutation or query result payload, or hashes in the repair payload")
+        ("cell-size", bpo::value<unsigned>()->default_value(100), "size of the value of each row")
+        ("compress", bpo::value<bool>()->default_value(false), "compress the connections")
+        ("target-shards", bpo::value<unsigned>()->default_value(1), "number of shards each shard sends to, each over a separate connection")
+        ("listen-address", bpo::value<sstring>()->default_value("127.0.0.1"), "address to listen on and send to")
+        ("port", bpo::value<uint16_t>()->default_value(7000), "port to listen on")
+        ;
+
+    return app.run(argc, argv, [&app_in = app] () -> future<> {
+        auto& app = app_in;
+        auto& c = app.configuration();
+
+        auto cfg = test_config();
+        cfg.verb = c["verb"].as<sstring>();
+        cfg.duration_in_seconds = c["duration"].as<unsigned>();
+        cfg.concurrency = c["concurrency"].as<unsigned>();
+        if (c.contains("operations-per-shard")) {
+            cfg.operations_per_shard = c["operations-per-shard"].as<unsigned>();
+        }
+        cfg.rate = c["rate"].as<unsigned>();
+        cfg.rows = c["rows"].as<unsigned>();
+        cfg.cell_size = c["cell-size"].as<unsigned>();
+        cfg.target_shards = std::clamp(c["target-shards"].as<unsigned>(), 1u, smp::count);
+
+        auto address = gms::inet_address(c["listen-address"].as<sstring>());
+        co_await smp::invoke_on_all([address] {
+            utils::fb_utilities::set_broadcast_address(address);
+        });
+
+        netw::messaging_service::config mscfg;
+        mscfg.ip = address;
+        mscfg.port = c["port"].as<uint16_t>();
+        mscfg.compress = c["compress"].as<bool>() ? netw::messaging_service::compress_what::all : netw::messaging_service::compress_what::none;
+        mscfg.rpc_memory_limit = std::max<size_t>(0.08 * memory::stats().total_memory(), mscfg.rpc_memory_limit);
+        netw::messaging_service::scheduling_config scfg{{{{}, "$default"}}, {}, {}};
+
+        seastar::semaphore token_metadata_sem(1);
+        sharded<locator::shared_token_metadata> token_metadata;
+        co_await token_metadata.start([&token_metadata_sem] () noexcept { return get_units(token_metadata_sem, 1); });
+
+        sharded<netw::messaging_service> messaging;
+        co_await messaging.start(mscfg, scfg, nullptr);
+
+        sharded<verb_bench> bench;
+        std::exception_ptr ex;
+        try {
+            co_await bench.start(std::ref(messaging), cfg, address);
+            co_await bench.invoke_on_all(&verb_bench::start);
+            co_await messaging.invoke_on_all([&token_metadata] (netw::messaging_service& ms) {
+                return ms.start_listen(token_metadata.local());
+            });
+
+            auto [request_size, response_size] = bench.local().payload_sizes();
+            std::cout << format("verb: {}, request payload: {} [B], response payload: {} [B], compression: {}, connections per shard: {}\n",
+                    cfg.verb, request_size, response_size, mscfg.compress == netw::messaging_service::compress_what::all, cfg.target_shards);
+
+            // test "framework" expects seastar thread
+            auto results = co_await seastar::async([&] {
+                return time_parallel([&] {
+                    return bench.local().send();
+                }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, true, cfg.rate);
+            });
+
+            auto compare_throughput = [] (perf_result a, perf_result b) { return a.throughput < b.throughput; };
+            std::sort(results.begin(), results.end(), compare_throughput);
+            auto median_result = results[results.size() / 2];
+            auto median = median_result.throughput;
+            auto min = results[0].throughput;
+            auto max = results[results.size() - 1].throughput;
+            auto absolute_deviations = boost::copy_range<std::vector<double>>(
+                    results
+                    | boost::adaptors::transformed(std::mem_fn(&perf_result::throughput))
+                    | boost::adaptors::transformed([&] (double r) { return abs(r - median); }));
+            std::sort(absolute_deviations.begin(), absolute_deviations.end());
+            auto mad = absolute_deviations[results.size() / 2];
+            std::cout << format("\nmedian {}\nmedian absolute deviation: {:.2f}\nmaximum: {:.2f}\nminimum: {:.2f}\n", median_result, mad, max, min);
+            if (auto bytes = request_size + response_size) {
+                std::cout << format("throughput: {:.2f} [MB/s], {:.2f} insns/byte\n",
+                        median * bytes / (1024 * 1024), median_result.instructions_per_op / bytes);
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+
+        co_await messaging.invoke_on_all(&netw::messaging_service::shutdown);
+        co_await bench.stop();
+        co_await messaging.stop();
+        co_await token_metadata.stop();
+
+        if (ex) {
+            std::rethrow_exception(ex);
+        }
+    });
+}
@@ -31,12 +31,14 @@ class combined {
     std::vector<mutation> _one_row;
     std::vector<mutation> _single;
     std::vector<std::vector<mutation>> _disjoint_interleaved;
+    std::vector<std::vector<mutation>> _many_disjoint_interleaved;
     std::vector<std::vector<mutation>> _disjoint_ranges;
     std::vector<std::vector<mutation>> _overlapping_partitions_disjoint_rows;
 private:
     static std::vector<mutation> create_one_row(simple_schema&, reader_permit);
     static std::vector<mutation> create_single_stream(simple_schema&, reader_permit);
     static std::vector<std::vector<mutation>> create_disjoint_interleaved_streams(simple_schema&, reader_permit);
+    static std::vector<std::vector<mutation>> create_many_disjoint_interleaved_streams(simple_schema&, reader_permit);
     static std::vector<std::vector<mutation>> create_disjoint_ranges_streams(simple_schema&, reader_permit);
     static std::vector<std::vector<mutation>> create_overlapping_partitions_disjoint_rows_streams(simple_schema&, reader_permit);
 protected:
@@ -47,6 +49,9 @@ class combined {
     const std::vector<std::vector<mutation>>& disjoint_interleaved_streams() const {
         return _disjoint_interleaved;
     }
+    const std::vector<std::vector<mutation>>& many_disjoint_interleaved_streams() const {
+        return _many_disjoint_interleaved;
+    }
     const std::vector<std::vector<mutation>>& disjoint_ranges_streams() const {
         return _disjoint_ranges;
     }
@@ -61,6 +66,7 @@ class combined {
         , _one_row(create_one_row(_schema, _permit))
         , _single(create_single_stream(_schema, _permit))
         , _disjoint_interleaved(create_disjoint_interleaved_streams(_schema, _permit))
+        , _many_disjoint_interleaved(create_many_disjoint_interleaved_streams(_schema, _permit))
         , _disjoint_ranges(create_disjoint_ranges_streams(_schema, _permit))
         , _overlapping_partitions_disjoint_rows(create_overlapping_partitions_disjoint_rows_streams(_schema, _permit))
     { }
@@ -106,6 +112,29 @@ std::vector<std::vector<mutation>> combined::create_disjoint_interleaved_streams
     return mss;
 }
 
+// Like many small sstables merged by a compaction: 32 streams, each with
+// every 32nd of 1024 single-row partitions.
+std::vector<std::vector<mutation>> combined::create_many_disjoint_interleaved_streams(simple_schema& s, reader_permit permit)
+{
+    auto base = boost::copy_range<std::vector<mutation>>(
+        s.make_pkeys(1024)
+        | boost::adaptors::transformed([&] (auto& dkey) {
+            auto m = mutation(s.schema(), dkey);
+            m.apply(s.make_row(permit, s.make_ckey(0), "value"));
+            return m;
+        })
+    );
+    std::vector<std::vector<mutation>> mss;
+    for (auto i = 0; i < 32; i++) {
+        mss.emplace_back(boost::copy_range<std::vector<mutation>>(
+            base
+            | boost::adaptors::sliced(i, base.size())
+            | boost::adaptors::strided(32)
+        ));
+    }
+    return mss;
+}
+
 std::vector<std::vector<mutation>> combined::create_disjoint_ranges_streams(simple_schema& s, reader_permit permit)
 {
     auto base = create_single_stream(s, permit);
@@ -198,6 +227,18 @@ PERF_TEST_F(combined, disjoint_interleaved)
     ));
 }
 
+PERF_TEST_F(combined, many_disjoint_interleaved)
+{
+    return consume_all(make_combined_reader(schema().schema(), permit(),
+        boost::copy_range<std::vector<flat_mutation_reader_v2>>(
+            many_disjoint_interleaved_streams()
+            | boost::adaptors::transformed([this] (auto&& ms) {
+                return make_flat_mutation_reader_from_mutations_v2(schema().schema(), permit(), std::move(ms));
+            })
+        )
+    ));
+}
+
 PERF_TEST_F(combined, disjoint_ranges)
 {
     return consume_all(make_combined_reader(schema().schema(), permit(),
@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <deque>
+#include <random>
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/util/defer.hh>
+
+#include "utils/logalloc.hh"
+#include "row_cache.hh"
+#include "replica/memtable.hh"
+#include "test/lib/memtable_snapshot_source.hh"
+#include "test/lib/reader_concurrency_semaphore.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/perf/perf.hh"
+
+/// Parameterized microbenchmark of the row cache.
+///
+/// Runs the following phases against a single cache, and reports the time
+/// per operation and per row, and the bytes allocated in LSA per row, of each:
+///
+///   populate   - a full scan which populates the empty cache
+///   evict      - eviction of rows down to --cache-ratio of the populated size
+///   read       - reads of random partitions, which populate evicted rows
+///   scan       - full scans interleaved with the reads, see --scan-every
+///   update     - cache updates from memtables, while readers hold snapshots
+///                taken before the last --versions updates, so that updates
+///                create new partition versions
+///   mvcc-read  - reads of random partitions while the snapshots are held
+///   merge      - merging of the partition versions after the snapshots are released
+///
+/// Eviction to the configured size follows every operation which may
+/// populate the cache, so eviction pressure is included in the "evict" line.
+///
+/// Example run:
+///
+///    $ build/release/test/perf/perf_row_cache_g -c1 -m1G --partitions 10000 --rows-per-partition 10 --cache-ratio 0.5 --versions 2
+///
+
+static bool cancelled = false;
+static const auto MB = 1024 * 1024;
+
+struct test_config {
+    unsigned partitions;
+    unsigned rows_per_partition;
+    unsigned cell_size;
+    double cache_ratio;
+    unsigned reads;
+    unsigned scan_every;
+    unsigned updates;
+    unsigned update_rows;
+    unsigned versions;
+};
+
+class op_stats {
+    sstring _name;
+    uint64_t _ops = 0;
+    uint64_t _rows = 0;
+    double _seconds = 0;
+    uint64_t _allocated = 0;
+public:
+    explicit op_stats(sstring name) : _name(std::move(name)) {}
+
+    // Runs func as one operation. func returns the number of rows it touched.
+    template <typename Func>
+    void measure(Func&& func) {
+        auto allocated = logalloc::shard_tracker().statistics().memory_allocated;
+        uint64_t rows = 0;
+        auto d = duration_in_seconds([&] {
+            rows = func();
+        });
+        _seconds += d.count();
+        _allocated += logalloc::shard_tracker().statistics().memory_allocated - allocated;
+        _rows += rows;
+        ++_ops;
+    }
+
+    void print() const {
+        if (!_ops) {
+            return;
+        }
+        std::cout << format("{:<10} ops: {:8d}, {:12.1f} [ns/op], rows: {:10d}, {:8.1f} [ns/row], {:8.1f} [B/row] allocated\n",
+                _name, _ops, _seconds * 1e9 / _ops, _rows,
+                _rows ? _seconds * 1e9 / _rows : 0.0,
+                _rows ? double(_allocated) / _rows : 0.0);
+    }
+};
+
+void run_test(const test_config& cfg) {
+    simple_schema ss;
+    auto s = ss.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    cache_tracker tracker;
+    memtable_snapshot_source mss(s);
+    std::default_random_engine gen(std::random_device{}());
+
+    auto val = sstring(sstring::initialized_later(), cfg.cell_size);
+    auto pkeys = ss.make_pkeys(cfg.partitions);
+    // Readers keep a reference to their range.
+    std::vector<dht::partition_range> ranges;
+    ranges.reserve(pkeys.size());
+    for (auto& pk : pkeys) {
+        ranges.push_back(dht::partition_range::make_singular(pk));
+    }
+
+    std::cout << "Filling underlying source" << std::endl;
+    for (auto& pk : pkeys) {
+        mutation m(s, pk);
+        for (unsigned i = 0; i < cfg.rows_per_partition; ++i) {
+            ss.add_row(m, ss.make_ckey(i), val);
+        }
+        mss.apply(m);
+        seastar::thread::maybe_yield();
+        if (cancelled) {
+            return;
+        }
+    }
+
+    row_cache cache(s, snapshot_source([&] { return mss(); }), tracker, is_continuous::no);
+
+    op_stats populate("populate");
+    op_stats evict("evict");
+    op_stats read("read");
+    op_stats scan("scan");
+    op_stats update("update");
+    op_stats mvcc_read("mvcc-read");
+    op_stats merge("merge");
+
+    auto consume = [&] (flat_mutation_reader_v2& rd) {
+        uint64_t rows = 0;
+        rd.consume_pausable([&] (mutation_fragment_v2 mf) {
+            rows += mf.is_clustering_row();
+            return stop_iteration(cancelled);
+        }).get();
+        return rows;
+    };
+
+    auto read_all = [&] (const dht::partition_range& pr) {
+        auto rd = cache.make_reader(s, semaphore.make_permit(), pr);
+        auto close_rd = deferred_close(rd);
+        return consume(rd);
+    };
+
+    size_t cache_cap = std::numeric_limits<size_t>::max();
+    auto evict_to_cap = [&] {
+        if (tracker.region().occupancy().used_space() <= cache_cap) {
+            return;
+        }
+        evict.measure([&] {
+            auto evicted = tracker.get_stats().row_evictions;
+            while (tracker.region().occupancy().used_space() > cache_cap) {
+                if (tracker.region().evict_some() == memory::reclaiming_result::reclaimed_nothing) {
+                    break;
+                }
+            }
+            return tracker.get_stats().row_evictions - evicted;
+        });
+    };
+
+    auto random_index = [&] {
+        return std::uniform_int_distribution<size_t>(0, pkeys.size() - 1)(gen);
+    };
+
+    auto print_cache = [&] {
+        auto rows = tracker.get_stats().rows;
+        std::cout << format("cache: {:d}/{:d} [MB], partitions: {:d}, rows: {:d}, {:.1f} [B/row] resident\n",
+                tracker.region().occupancy().used_space() / MB,
+                tracker.region().occupancy().total_space() / MB,
+                tracker.get_stats().partitions, rows,
+                rows ? double(tracker.region().occupancy().used_space()) / rows : 0.0);
+    };
+
+    auto do_reads = [&] (op_stats& stats) {
+        for (unsigned i = 0; i < cfg.reads && !cancelled; ++i) {
+            stats.measure([&] {
+                return read_all(ranges[random_index()]);
+            });
+            evict_to_cap();
+            if (cfg.scan_every && (i + 1) % cfg.scan_every == 0) {
+                scan.measure([&] {
+                    return read_all(query::full_partition_range);
+                });
+                evict_to_cap();
+            }
+            seastar::thread::maybe_yield();
+        }
+    };
+
+    std::cout << "Populating" << std::endl;
+    populate.measure([&] {
+        return read_all(query::full_partition_range);
+    });
+    print_cache();
+
+    if (cfg.cache_ratio < 1) {
+        cache_cap = tracker.region().occupancy().used_space() * cfg.cache_ratio;
+        evict_to_cap();
+        print_cache();
+    }
+
+    std::cout << "Reading" << std::endl;
+    do_reads(read);
+    print_cache();
+
+    std::cout << "Updating" << std::endl;
+    std::deque<std::vector<flat_mutation_reader_v2>> snapshots;
+    auto release_snapshots = [&] (std::vector<flat_mutation_reader_v2>& rds) {
+        for (auto& rd : rds) {
+            rd.close().get();
+        }
+        rds.clear();
+    };
+    auto release_all_snapshots = defer([&] {
+        for (auto& rds : snapshots) {
+            release_snapshots(rds);
+        }
+    });
+    uint64_t rows_in_versions = 0;
+    for (unsigned i = 0; i < cfg.updates && !cancelled; ++i) {
+        if (cfg.versions) {
+            std::vector<flat_mutation_reader_v2> rds;
+            rds.reserve(ranges.size());
+            for (auto& pr : ranges) {
+                auto rd = cache.make_reader(s, semaphore.make_permit(), pr);
+                auto close_rd = deferred_close(rd);
+                // The reader holds a snapshot of the partition once it entered it.
+                rd.set_max_buffer_size(1);
+                rd.fill_buffer().get();
+                close_rd.cancel();
+                rds.push_back(std::move(rd));
+            }
+            snapshots.push_back(std::move(rds));
+            if (snapshots.size() > cfg.versions) {
+                release_snapshots(snapshots.front());
+                snapshots.pop_front();
+            }
+        }
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        std::vector<mutation> muts;
+        muts.reserve(cfg.update_rows);
+        auto ck_dist = std::uniform_int_distribution<unsigned>(0, cfg.rows_per_partition - 1);
+        for (unsigned j = 0; j < cfg.update_rows; ++j) {
+            mutation m(s, pkeys[random_index()]);
+            ss.add_row(m, ss.make_ckey(ck_dist(gen)), val);
+            mt->apply(m);
+            muts.push_back(std::move(m));
+        }
+        update.measure([&] {
+            cache.update(row_cache::external_updater([&] {
+                for (auto& m : muts) {
+                    mss.apply(m);
+                }
+            }), *mt).get();
+            return cfg.update_rows;
+        });
+        if (cfg.versions) {
+            rows_in_versions += cfg.update_rows;
+        }
+        evict_to_cap();
+    }
+    print_cache();
+
+    if (!snapshots.empty()) {
+        std::cout << "Reading with " << snapshots.size() << " snapshots held" << std::endl;
+        do_reads(mvcc_read);
+
+        std::cout << "Merging versions" << std::endl;
+        merge.measure([&] {
+            for (auto& rds : snapshots) {
+                release_snapshots(rds);
+            }
+            snapshots.clear();
+            tracker.cleaner().drain().get();
+            return rows_in_versions;
+        });
+        print_cache();
+    }
+
+    std::cout << std::endl;
+    populate.print();
+    evict.print();
+    read.print();
+    scan.print();
+    update.print();
+    mvcc_read.print();
+    merge.print();
+
+    // Clean gently to avoid reactor stalls in destructors
+    cache.invalidate(row_cache::external_updater([]{})).get();
+    tracker.cleaner().drain().get();
+}
+
+int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("partitions", bpo::value<unsigned>()->default_value(10000), "Number of partitions")
+        ("rows-per-partition", bpo::value<unsigned>()->default_value(10), "Number of rows in each partition")
+        ("cell-size", bpo::value<unsigned>()->default_value(128), "Size of the value of each row")
+        ("cache-ratio", bpo::value<double>()->default_value(1.0), "Size of the cache relative to the size of the populated data")
+        ("reads", bpo::value<unsigned>()->default_value(10000), "Number of reads of random partitions in each read phase")
+        ("scan-every", bpo::value<unsigned>()->default_value(0), "Run a full scan after every that many reads, 0 to disable")
+        ("updates", bpo::value<unsigned>()->default_value(10), "Number of cache updates")
+        ("update-rows", bpo::value<unsigned>()->default_value(10000), "Number of rows written by each update")
+        ("versions", bpo::value<unsigned>()->default_value(1), "Number of updates during which a snapshot of each partition is held")
+        ;
+
+    return app.run(argc, argv, [&app] {
+        return seastar::async([&] {
+            engine().at_exit([] {
+                cancelled = true;
+                return make_ready_future();
+            });
+            auto& c = app.configuration();
+            test_config cfg{
+                .partitions = std::max(c["partitions"].as<unsigned>(), 1u),
+                .rows_per_partition = std::max(c["rows-per-partition"].as<unsigned>(), 1u),
+                .cell_size = c["cell-size"].as<unsigned>(),
+                .cache_ratio = c["cache-ratio"].as<double>(),
+                .reads = c["reads"].as<unsigned>(),
+                .scan_every = c["scan-every"].as<unsigned>(),
+                .updates = c["updates"].as<unsigned>(),
+                .update_rows = c["update-rows"].as<unsigned>(),
+                .versions = c["versions"].as<unsigned>(),
+            };
+            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
+            run_test(cfg);
+        });
+    });
+}
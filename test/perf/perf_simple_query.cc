@@ -38,24 +38,31 @@ static bytes make_key(uint64_t sequence) {
     return b;
 };
 
-static void execute_update_for_key(cql_test_env& env, const bytes& key) {
+// The restriction on the clustering key, if the table has one. It doesn't
+// depend on bound values, so it exercises the parts of the query plan which
+// can be prepared once per statement.
+static sstring clustering_restriction(bool clustering) {
+    return clustering ? " AND \"CK\" = 0" : "";
+}
+
+static void execute_update_for_key(cql_test_env& env, const bytes& key, bool clustering) {
     env.execute_cql(fmt::format("UPDATE cf SET "
         "\"C0\" = 0x8f75da6b3dcec90c8a404fb9a5f6b0621e62d39c69ba5758e5f41b78311fbb26cc7a,"
         "\"C1\" = 0xa8761a2127160003033a8f4f3d1069b7833ebe24ef56b3beee728c2b686ca516fa51,"
         "\"C2\" = 0x583449ce81bfebc2e1a695eb59aad5fcc74d6d7311fc6197b10693e1a161ca2e1c64,"
         "\"C3\" = 0x62bcb1dbc0ff953abc703bcb63ea954f437064c0c45366799658bd6b91d0f92908d7,"
         "\"C4\" = 0x222fcbe31ffa1e689540e1499b87fa3f9c781065fccd10e4772b4c7039c2efd0fb27 "
-        "WHERE \"KEY\"= 0x{};", to_hex(key))).get();
+        "WHERE \"KEY\"= 0x{}{};", to_hex(key), clustering_restriction(clustering))).get();
 };
 
-static void execute_counter_update_for_key(cql_test_env& env, const bytes& key) {
+static void execute_counter_update_for_key(cql_test_env& env, const bytes& key, bool clustering) {
     env.execute_cql(fmt::format("UPDATE cf SET "
         "\"C0\" = \"C0\" + 1,"
         "\"C1\" = \"C1\" + 2,"
         "\"C2\" = \"C2\" + 3,"
         "\"C3\" = \"C3\" + 4,"
         "\"C4\" = \"C4\" + 5 "
-        "WHERE \"KEY\"= 0x{};", to_hex(key))).get();
+        "WHERE \"KEY\"= 0x{}{};", to_hex(key), clustering_restriction(clustering))).get();
 };
 
 struct test_config {
@@ -71,9 +78,11 @@ struct test_config {
     bool counters;
     bool flush_memtables;
     unsigned operations_per_shard = 0;
+    unsigned rate = 0;
     bool stop_on_error;
     sstring timeout;
     bool bypass_cache;
+    bool clustering;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -96,10 +105,12 @@ std::ostream& operator<<(std::ostream& os, const test_config::frontend_type& f)
 std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
     return os << "{partitions=" << cfg.partitions
            << ", concurrency=" << cfg.concurrency
+           << ", rate=" << cfg.rate
            << ", mode=" << cfg.mode
            << ", frontend=" << cfg.frontend
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", clustering=" << (cfg.clustering ? "yes" : "no")
            << "}";
 }
 
@@ -107,9 +118,9 @@ static void create_partitions(cql_test_env& env, test_config& cfg) {
     std::cout << "Creating " << cfg.partitions << " partitions..." << std::endl;
     for (unsigned sequence = 0; sequence < cfg.partitions; ++sequence) {
         if (cfg.counters) {
-            execute_counter_update_for_key(env, make_key(sequence));
+            execute_counter_update_for_key(env, make_key(sequence), cfg.clustering);
         } else {
-            execute_update_for_key(env, make_key(sequence));
+            execute_update_for_key(env, make_key(sequence), cfg.clustering);
         }
     }
 
@@ -129,7 +140,7 @@ static bytes make_random_key(test_config& cfg) {
 
 static std::vector<perf_result> test_read(cql_test_env& env, test_config& cfg) {
     create_partitions(env, cfg);
-    sstring query = "select \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" from cf where \"KEY\" = ?";
+    sstring query = "select \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" from cf where \"KEY\" = ?" + clustering_restriction(cfg.clustering);
     if (cfg.bypass_cache) {
         query += " bypass cache";
     }
@@ -140,7 +151,7 @@ static std::vector<perf_result> test_read(cql_test_env& env, test_config& cfg) {
     return time_parallel([&env, &cfg, id] {
             bytes key = make_random_key(cfg);
             return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
-        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cfg.rate);
 }
 
 static std::vector<perf_result> test_write(cql_test_env& env, test_config& cfg) {
@@ -154,12 +165,12 @@ static std::vector<perf_result> test_write(cql_test_env& env, test_config& cfg)
             "\"C2\" = 0x583449ce81bfebc2e1a695eb59aad5fcc74d6d7311fc6197b10693e1a161ca2e1c64,"
             "\"C3\" = 0x62bcb1dbc0ff953abc703bcb63ea954f437064c0c45366799658bd6b91d0f92908d7,"
             "\"C4\" = 0x222fcbe31ffa1e689540e1499b87fa3f9c781065fccd10e4772b4c7039c2efd0fb27 "
-            "WHERE \"KEY\" = ?", usings);
+            "WHERE \"KEY\" = ?{}", usings, clustering_restriction(cfg.clustering));
     auto id = env.prepare(query).get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_random_key(cfg);
             return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
-        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cfg.rate);
 }
 
 static std::vector<perf_result> test_delete(cql_test_env& env, test_config& cfg) {
@@ -168,12 +179,12 @@ static std::vector<perf_result> test_delete(cql_test_env& env, test_config& cfg)
     if (!cfg.timeout.empty()) {
         usings += "USING TIMEOUT " + cfg.timeout;
     }
-    sstring query = format("DELETE \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" FROM cf {}WHERE \"KEY\" = ?", usings);
+    sstring query = format("DELETE \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" FROM cf {}WHERE \"KEY\" = ?{}", usings, clustering_restriction(cfg.clustering));
     auto id = env.prepare(query).get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_random_key(cfg);
             return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
-        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cfg.rate);
 }
 
 static std::vector<perf_result> test_counter_update(cql_test_env& env, test_config& cfg) {
@@ -187,17 +198,21 @@ static std::vector<perf_result> test_counter_update(cql_test_env& env, test_conf
             "\"C2\" = \"C2\" + 3,"
             "\"C3\" = \"C3\" + 4,"
             "\"C4\" = \"C4\" + 5 "
-            "WHERE \"KEY\" = ?", usings);
+            "WHERE \"KEY\" = ?{}", usings, clustering_restriction(cfg.clustering));
     auto id = env.prepare(query).get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_random_key(cfg);
             return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
-        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cfg.rate);
 }
 
-static schema_ptr make_counter_schema(std::string_view ks_name) {
-    return schema_builder(ks_name, "cf")
-            .with_column("KEY", bytes_type, column_kind::partition_key)
+static schema_ptr make_counter_schema(std::string_view ks_name, bool clustering) {
+    schema_builder builder(ks_name, "cf");
+    builder.with_column("KEY", bytes_type, column_kind::partition_key);
+    if (clustering) {
+        builder.with_column("CK", int32_type, column_kind::clustering_key);
+    }
+    return builder
             .with_column("C0", counter_type)
             .with_column("C1", counter_type)
             .with_column("C2", counter_type)
@@ -305,7 +320,7 @@ static std::vector<perf_result> test_alternator_read(service::client_state& stat
         content.emplace_back(key.data(), key.size(), deleter{});
         content.emplace_back(postfix.data(), postfix.size(), deleter{});
         return executor.get_item(state, tracing::trace_state_ptr(), empty_service_permit(), rjson::parse(std::move(content))).discard_result();
-    }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+    }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cfg.rate);
 }
 
 static std::vector<perf_result> test_alternator_write(service::client_state& state, alternator::executor& executor, test_config& cfg) {
@@ -348,7 +363,7 @@ static std::vector<perf_result> test_alternator_write(service::client_state& sta
         content.emplace_back(key.data(), key.size(), deleter{});
         content.emplace_back(postfix.data(), postfix.size(), deleter{});
         return executor.update_item(state, tracing::trace_state_ptr(), empty_service_permit(), rjson::parse(std::move(content))).discard_result();
-    }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+    }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cfg.rate);
 }
 
 static std::vector<perf_result> test_alternator_delete(service::client_state& state, noncopyable_function<void()> flush_memtables,
@@ -367,7 +382,7 @@ static std::vector<perf_result> test_alternator_delete(service::client_state& st
             }
         )";
         return executor.delete_item(state, tracing::trace_state_ptr(), empty_service_permit(), rjson::parse(json)).discard_result();
-    }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+    }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cfg.rate);
 }
 
 static std::vector<perf_result> do_alternator_test(std::string isolation_level,
@@ -414,10 +429,14 @@ static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg)
     std::cout << "Running test with config: " << cfg << std::endl;
     env.create_table([&cfg] (auto ks_name) {
         if (cfg.counters) {
-            return *make_counter_schema(ks_name);
+            return *make_counter_schema(ks_name, cfg.clustering);
+        }
+        schema_builder builder(ks_name, "cf");
+        builder.with_column("KEY", bytes_type, column_kind::partition_key);
+        if (cfg.clustering) {
+            builder.with_column("CK", int32_type, column_kind::clustering_key);
         }
-        return *schema_builder(ks_name, "cf")
-                .with_column("KEY", bytes_type, column_kind::partition_key)
+        return *builder
                 .with_column("C0", bytes_type)
                 .with_column("C1", bytes_type)
                 .with_column("C2", bytes_type)
@@ -449,6 +468,7 @@ void write_json_result(std::string result_file, const test_config& cfg, perf_res
     params["partitions"] = cfg.partitions;
     params["cpus"] = smp::count;
     params["duration"] = cfg.duration_in_seconds;
+    params["rate"] = cfg.rate;
     params["concurrency,partitions,cpus,duration"] = fmt::format("{},{},{},{}", cfg.concurrency, cfg.partitions, smp::count, cfg.duration_in_seconds);
     results["parameters"] = std::move(params);
 
@@ -460,6 +480,9 @@ void write_json_result(std::string result_file, const test_config& cfg, perf_res
     stats["mad tps"] = mad;
     stats["max tps"] = max;
     stats["min tps"] = min;
+    stats["p50 latency us"] = Json::Int64(median.latency_p50);
+    stats["p99 latency us"] = Json::Int64(median.latency_p99);
+    stats["max latency us"] = Json::Int64(median.latency_max);
     results["stats"] = std::move(stats);
 
     std::string test_type;
@@ -511,6 +534,7 @@ int main(int argc, char** argv) {
         ("query-single-key", "test reading with a single key instead of random keys")
         ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
         ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
+        ("rate", bpo::value<unsigned>()->default_value(0), "start this many operations per second per shard, measuring latency from the scheduled start (0 runs them back to back)")
         ("counters", "test counters")
         ("flush", "flush memtables before test")
         ("json-result", bpo::value<std::string>(), "name of the json result file")
@@ -519,6 +543,7 @@ int main(int argc, char** argv) {
         ("stop-on-error", bpo::value<bool>()->default_value(true), "stop after encountering the first error")
         ("timeout", bpo::value<std::string>()->default_value(""), "use timeout")
         ("bypass-cache", "use bypass cache when querying")
+        ("clustering", "add a clustering key to the table, restricted to a constant in all queries")
         ;
 
     set_abort_on_internal_error(true);
@@ -562,9 +587,11 @@ int main(int argc, char** argv) {
             if (app.configuration().contains("operations-per-shard")) {
                 cfg.operations_per_shard = app.configuration()["operations-per-shard"].as<unsigned>();
             }
+            cfg.rate = app.configuration()["rate"].as<unsigned>();
             cfg.stop_on_error = app.configuration()["stop-on-error"].as<bool>();
             cfg.timeout = app.configuration()["timeout"].as<std::string>();
             cfg.bypass_cache = app.configuration().contains("bypass-cache");
+            cfg.clustering = app.configuration().contains("clustering");
             auto results = cfg.frontend == test_config::frontend_type::cql
                     ? do_cql_test(env, cfg)
                     : do_alternator_test(app.configuration()["alternator"].as<std::string>(),
@@ -44,6 +44,13 @@ future<> test_compaction(distributed<perf_sstable_test_env>& dt) {
     });
 }
 
+future<> test_compaction_strategy(distributed<perf_sstable_test_env>& dt) {
+    // Only shard 0 runs, so that its progress reports can be read.
+    return dt.invoke_on(0, [] (perf_sstable_test_env& t) {
+        return t.compaction_strategy_simulation(iterations, std::max(iterations / 10, 1u));
+    });
+}
+
 future<> test_index_read(distributed<perf_sstable_test_env>& dt) {
     return time_runs(iterations, parallelism, dt, &perf_sstable_test_env::read_all_indexes);
 }
@@ -58,6 +65,7 @@ enum class test_modes {
     write,
     index_write,
     compaction,
+    compaction_strategy,
 };
 
 static std::unordered_map<sstring, test_modes> test_mode = {
@@ -66,6 +74,7 @@ static std::unordered_map<sstring, test_modes> test_mode = {
     {"write", test_modes::write },
     {"index_write", test_modes::index_write },
     {"compaction", test_modes::compaction },
+    {"compaction_strategy", test_modes::compaction_strategy },
 };
 
 int main(int argc, char** argv) {
@@ -73,14 +82,14 @@ int main(int argc, char** argv) {
     app_template app;
     app.add_options()
         ("parallelism", bpo::value<unsigned>()->default_value(1), "number parallel requests")
-        ("iterations", bpo::value<unsigned>()->default_value(30), "number of iterations")
+        ("iterations", bpo::value<unsigned>()->default_value(30), "number of iterations (memtable flushes in compaction_strategy mode)")
         ("partitions", bpo::value<unsigned>()->default_value(5000000), "number of partitions")
         ("buffer_size", bpo::value<unsigned>()->default_value(64), "sstable buffer size, in KB")
         ("key_size", bpo::value<unsigned>()->default_value(128), "size of partition key")
         ("num_columns", bpo::value<unsigned>()->default_value(5), "number of columns per row")
         ("column_size", bpo::value<unsigned>()->default_value(64), "size in bytes for each column")
         ("sstables", bpo::value<unsigned>()->default_value(1), "number of sstables (valid only for compaction mode)")
-        ("mode", bpo::value<sstring>()->default_value("index_write"), "one of: sequential_read, index_read, write, compaction, index_write (default)")
+        ("mode", bpo::value<sstring>()->default_value("index_write"), "one of: sequential_read, index_read, write, compaction, compaction_strategy, index_write (default)")
         ("testdir", bpo::value<sstring>()->default_value("/var/lib/scylla/perf-tests"), "directory in which to store the sstables")
         ("compaction-strategy", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy"), "compaction strategy to use, one of "
              "(SizeTieredCompactionStrategy, LeveledCompactionStrategy, DateTieredCompactionStrategy, TimeWindowCompactionStrategy)")
@@ -122,7 +131,8 @@ int main(int argc, char** argv) {
                         throw;
                     }
                 });
-            } else if ((mode == test_modes::index_write) || (mode == test_modes::write) || (mode == test_modes::compaction)) {
+            } else if ((mode == test_modes::index_write) || (mode == test_modes::write) || (mode == test_modes::compaction)
+                    || (mode == test_modes::compaction_strategy)) {
                 return test_setup::create_empty_test_dir(dir);
             } else {
                 throw std::invalid_argument("Invalid mode");
@@ -136,6 +146,8 @@ int main(int argc, char** argv) {
                 return test_write(*test).then([test] {});
             } else if (mode == test_modes::compaction) {
                 return test_compaction(*test).then([test] {});
+            } else if (mode == test_modes::compaction_strategy) {
+                return test_compaction_strategy(*test).then([test] {});
             } else {
                 throw std::invalid_argument("Invalid mode");
             }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <seastar/util/closeable.hh>
+#include <seastar/util/defer.hh>
 
 #include "sstables/sstables.hh"
 #include "compaction/compaction_manager.hh"
@@ -199,6 +200,85 @@ class perf_sstable_test_env {
         });
     }
 
+    // Flushes `flushes` memtables into a table using the configured compaction
+    // strategy, running the compactions the strategy asks for after each flush,
+    // and prints the amplification it ends up with every `report_interval` flushes.
+    //
+    // Every flush overwrites the same partitions, so the data of one flush is
+    // all the live data there is.
+    future<> compaction_strategy_simulation(unsigned flushes, unsigned report_interval) {
+        return test_setup::create_empty_test_dir(dir()).then([this, flushes, report_interval] {
+            return sstables::test_env::do_with_async([this, flushes, report_interval] (sstables::test_env& env) {
+                auto sst_gen = [this, gen = make_lw_shared<unsigned>(0)] () mutable {
+                    return _env.make_sstable(s, dir(), (*gen)++, sstables::get_highest_sstable_version(), sstable::format_types::big, _cfg.buffer_size);
+                };
+                table_for_tests cf(env.manager(), s);
+                auto stop_cf = defer([&cf] { cf.stop().get(); });
+                auto& cm = cf.get_compaction_manager();
+                // The compactions are run below, one at a time.
+                cf->disable_auto_compaction().get();
+
+                auto keys = make_local_keys(int(_cfg.partitions / _cfg.sstables), s, _cfg.key_size);
+                std::vector<dht::decorated_key> sampled_keys;
+                for (size_t i = 0; i < keys.size(); i += std::max(keys.size() / 100, size_t(1))) {
+                    sampled_keys.push_back(dht::decorate_key(*s, partition_key::from_deeply_exploded(*s, { keys[i] })));
+                }
+
+                uint64_t flushed_bytes = 0;
+                uint64_t compaction_written_bytes = 0;
+                uint64_t live_data_bytes = 0;
+                for (unsigned flush = 1; flush <= flushes; ++flush) {
+                    _mt = make_lw_shared<replica::memtable>(s);
+                    fill_memtable().get();
+                    auto sst = sst_gen();
+                    write_memtable_to_sstable_for_test(*_mt, sst).get();
+                    sst->open_data().get();
+                    flushed_bytes += sst->bytes_on_disk();
+                    live_data_bytes = sst->bytes_on_disk();
+                    cf->add_sstable_and_update_cache(sst).get();
+
+                    // Bounded, in case a strategy keeps proposing jobs which don't change anything.
+                    for (unsigned jobs = 0; jobs < 100; ++jobs) {
+                        auto candidates = cf->get_sstables();
+                        auto descriptor = cf->get_compaction_strategy().get_sstables_for_compaction(cf.as_table_state(), cm.get_strategy_control(),
+                                std::vector<shared_sstable>(candidates->begin(), candidates->end()));
+                        if (descriptor.sstables.empty()) {
+                            break;
+                        }
+                        descriptor.creator = [&sst_gen] (unsigned dummy) {
+                            return sst_gen();
+                        };
+                        descriptor.replacer = [&cf] (sstables::compaction_completion_desc desc) {
+                            cf.as_table_state().on_compaction_completion(std::move(desc), sstables::offstrategy::no).get();
+                        };
+                        auto cdata = compaction_manager::create_compaction_data();
+                        auto ret = sstables::compact_sstables(std::move(descriptor), cdata, cf.as_table_state()).get0();
+                        compaction_written_bytes += ret.stats.end_size;
+                    }
+
+                    if (flush % report_interval && flush != flushes) {
+                        continue;
+                    }
+                    auto all = cf->get_sstables();
+                    auto total_bytes = std::accumulate(all->begin(), all->end(), uint64_t(0), [] (uint64_t n, const shared_sstable& sst) {
+                        return n + sst->bytes_on_disk();
+                    });
+                    uint64_t sstables_read = 0;
+                    for (auto& dk : sampled_keys) {
+                        sstables_read += cf->get_sstable_set().select(dht::partition_range::make_singular(dk)).size();
+                    }
+                    std::cout << format("{:6d} flushes: write amplification {:.2f}, space amplification {:.2f}, sstables per read {:.2f}, {} sstables, backlog {:.2f}",
+                            flush,
+                            double(flushed_bytes + compaction_written_bytes) / flushed_bytes,
+                            double(total_bytes) / live_data_bytes,
+                            double(sstables_read) / sampled_keys.size(),
+                            all->size(),
+                            cm.backlog()) << std::endl;
+                }
+            });
+        });
+    }
+
     future<double> read_all_indexes(int idx) {
         return do_with(test(_sst[0]), [this] (auto& sst) {
             const auto start = perf_sstable_test_env::now();
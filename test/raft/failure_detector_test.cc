@@ -270,3 +270,50 @@ SEASTAR_TEST_CASE(failure_detector_test) {
 
     co_await fd.stop();
 }
+
+SEASTAR_TEST_CASE(failure_detector_adaptive_threshold_test) {
+    test_pinger pinger;
+    test_clock clock;
+    sharded<direct_failure_detector::failure_detector> fd;
+    co_await fd.start(std::ref(pinger), std::ref(clock), 10);
+
+    test_listener fixed, adaptive;
+    auto sub1 = co_await fd.local().register_listener(fixed, 95);
+    auto sub2 = co_await fd.local().register_listener(adaptive, direct_failure_detector::adaptive_threshold{
+        .min = 15,
+        .max = 95,
+        .false_positive_rate = 1e-4,
+    });
+
+    direct_failure_detector::pinger::endpoint_id ep{1};
+    pinger._responding.insert(ep);
+    fd.local().add_endpoint(ep);
+
+    auto tick = [&clock] (size_t n) -> future<> {
+        for (size_t i = 0; i < n; ++i) {
+            co_await clock.tick();
+        }
+    };
+
+    co_await tick(100);
+    co_await fixed.wait_for(ep, true);
+    co_await adaptive.wait_for(ep, true);
+
+    // Pings are answered within the same tick, so the adaptive threshold drops to its minimum.
+    pinger._responding.erase(ep);
+    co_await tick(30);
+    co_await adaptive.wait_for(ep, false);
+    BOOST_REQUIRE(fixed.is_alive(ep));
+
+    pinger._responding.insert(ep);
+    co_await tick(10);
+    co_await adaptive.wait_for(ep, true);
+    BOOST_REQUIRE(fixed.is_alive(ep));
+
+    std::optional<direct_failure_detector::subscription> sub_opt{std::move(sub1)};
+    sub_opt.reset();
+    sub_opt.emplace(std::move(sub2));
+    sub_opt.reset();
+
+    co_await fd.stop();
+}
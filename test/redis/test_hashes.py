@@ -151,3 +151,18 @@ def test_hexists(redis_host, redis_port):
     assert r.hexists(key, field) == 0
     assert r.hset(key, field, random_string(10)) == 1
     assert r.hexists(key, field) == 1
+
+def test_hmget(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    field1 = random_string(10)
+    val1 = random_string(10)
+    field2 = random_string(10)
+    val2 = random_string(10)
+    missing = random_string(10)
+
+    assert r.hset(key, field1, val1) == 1
+    assert r.hset(key, field2, val2) == 1
+    assert r.hmget(key, [field2, missing, field1]) == [val2, None, val1]
+    r.delete(key)
+    assert r.hmget(key, [field1, field2]) == [None, None]
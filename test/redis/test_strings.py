@@ -231,3 +231,18 @@ def test_strlen_wrongtype(redis_host, redis_port):
         r.strlen(key1)
     except redis.exceptions.ResponseError as ex:
         assert str(ex) == 'WRONGTYPE Operation against a key holding the wrong kind of value'
+
+def test_mset_mget(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    keys = [random_string(10) for _ in range(5)]
+    vals = [random_string(10) for _ in range(5)]
+    missing = random_string(10)
+    r.delete(missing)
+
+    assert r.mset(dict(zip(keys, vals))) == True
+    assert r.mget(keys) == vals
+    # Missing keys are returned as nil, in their position; duplicates are repeated
+    assert r.mget([keys[0], missing, keys[0]]) == [vals[0], None, vals[0]]
+    for key in keys:
+        assert r.get(key) == vals[keys.index(key)]
+        r.delete(key)
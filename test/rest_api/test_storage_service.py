@@ -410,6 +410,30 @@ def test_describe_ring(cql, this_dc, rest_api):
         resp = rest_api.send("GET", f"storage_service/describe_ring/{keyspace}")
         resp.raise_for_status()
 
+def test_shard_ranges(cql, this_dc, rest_api):
+    with new_test_keyspace(cql, f"WITH REPLICATION = {{ 'class' : 'NetworkTopologyStrategy', '{this_dc}' : 1 }}") as keyspace:
+        with new_test_table(cql, keyspace, 'p int, primary key (p)') as t:
+            resp = rest_api.send("GET", f"storage_service/shard_ranges/{keyspace}", { "cf": t.split('.')[1] })
+            resp.raise_for_status()
+            ranges = resp.json()
+            assert ranges
+
+            def contains(r, token):
+                if r['start_token'] and (token < int(r['start_token']) or token == int(r['start_token']) and not r['start_inclusive']):
+                    return False
+                if r['end_token'] and (token > int(r['end_token']) or token == int(r['end_token']) and not r['end_inclusive']):
+                    return False
+                return True
+
+            # The node is the only replica, so every token is in exactly one range.
+            for p in range(100):
+                cql.execute(f"INSERT INTO {t} (p) VALUES ({p})")
+                token = cql.execute(f"SELECT token(p) FROM {t} WHERE p = {p}").one()[0]
+                assert len([r for r in ranges if contains(r, token)]) == 1
+
+            resp = rest_api.send("GET", f"storage_service/shard_ranges/{keyspace}")
+            assert resp.status_code == requests.codes.bad_request
+
 def test_storage_service_keyspace_cleanup(cql, this_dc, rest_api):
     with new_test_keyspace(cql, f"WITH REPLICATION = {{ 'class' : 'NetworkTopologyStrategy', '{this_dc}' : 1 }}") as keyspace:
         schema = 'p int, v text, primary key (p)'
@@ -1946,13 +1946,36 @@ class thrift_handler : public CassandraCobSvIf {
         auto cell = atomic_cell::make_live_counter_update(api::new_timestamp(), col.value);
         m_to_apply.set_clustered_cell(std::move(ckey), def, std::move(cell));
     }
-    static void add_to_mutation(const schema& s, const CounterColumn& col, mutation& m_to_apply) {
+    // Column definitions of a static column family by their Thrift name, so
+    // that converting the columns of a batch doesn't allocate a bytes key
+    // for each of them. Built once per column family of a batch.
+    class column_lookup {
+        std::unordered_map<std::string_view, const column_definition*> _by_name;
+    public:
+        explicit column_lookup(const schema& s) {
+            if (s.thrift().is_dynamic()) {
+                return;
+            }
+            _by_name.reserve(s.all_columns_count());
+            for (auto&& def : s.all_columns()) {
+                _by_name.emplace(std::string_view(reinterpret_cast<const char*>(def.name().data()), def.name().size()), &def);
+            }
+        }
+        const column_definition* find(const std::string& name) const {
+            auto it = _by_name.find(std::string_view(name));
+            return it == _by_name.end() ? nullptr : it->second;
+        }
+    };
+    static const column_definition* find_column(const schema& s, const std::string& name, const column_lookup* columns) {
+        return columns ? columns->find(name) : s.get_column_definition(to_bytes(name));
+    }
+    static void add_to_mutation(const schema& s, const CounterColumn& col, mutation& m_to_apply, const column_lookup* columns = nullptr) {
         thrift_validation::validate_column_name(col.name);
         if (s.thrift().is_dynamic()) {
             auto&& value_col = s.regular_begin();
             add_live_cell(s, col, *value_col, make_clustering_prefix(s, to_bytes_view(col.name)), m_to_apply);
         } else {
-            auto def = s.get_column_definition(to_bytes(col.name));
+            auto def = find_column(s, col.name, columns);
             if (def) {
                 if (def->kind != column_kind::regular_column) {
                     throw make_exception<InvalidRequestException>("Column {} is not settable", col.name);
@@ -1963,13 +1986,13 @@ class thrift_handler : public CassandraCobSvIf {
             }
         }
     }
-    static void add_to_mutation(const schema& s, const Column& col, mutation& m_to_apply) {
+    static void add_to_mutation(const schema& s, const Column& col, mutation& m_to_apply, const column_lookup* columns = nullptr) {
         thrift_validation::validate_column_name(col.name);
         if (s.thrift().is_dynamic()) {
             auto&& value_col = s.regular_begin();
             add_live_cell(s, col, *value_col, make_clustering_prefix(s, to_bytes_view(col.name)), m_to_apply);
         } else {
-            auto def = s.get_column_definition(to_bytes(col.name));
+            auto def = find_column(s, col.name, columns);
             if (def) {
                 if (def->kind != column_kind::regular_column) {
                     throw make_exception<InvalidRequestException>("Column {} is not settable", col.name);
@@ -1980,7 +2003,7 @@ class thrift_handler : public CassandraCobSvIf {
             }
         }
     }
-    static void add_to_mutation(const schema& s, const Mutation& m, mutation& m_to_apply) {
+    static void add_to_mutation(const schema& s, const Mutation& m, mutation& m_to_apply, const column_lookup* columns = nullptr) {
         if (m.__isset.column_or_supercolumn) {
             if (m.__isset.deletion) {
                 throw make_exception<InvalidRequestException>("Mutation must have one and only one of column_or_supercolumn or deletion");
@@ -1990,11 +2013,11 @@ class thrift_handler : public CassandraCobSvIf {
                 throw make_exception<InvalidRequestException>("ColumnOrSuperColumn must have one (and only one) of column, super_column, counter and counter_super_column");
             }
             if (cosc.__isset.column) {
-                add_to_mutation(s, cosc.column, m_to_apply);
+                add_to_mutation(s, cosc.column, m_to_apply, columns);
             } else if (cosc.__isset.super_column) {
                 fail(unimplemented::cause::SUPER);
             } else if (cosc.__isset.counter_column) {
-                add_to_mutation(s, cosc.counter_column, m_to_apply);
+                add_to_mutation(s, cosc.counter_column, m_to_apply, columns);
             } else if (cosc.__isset.counter_super_column) {
                 fail(unimplemented::cause::SUPER);
             }
@@ -2033,10 +2056,12 @@ class thrift_handler : public CassandraCobSvIf {
                 throw make_exception<InvalidRequestException>("Cannot modify Materialized Views directly");
             }
             schemas.emplace_back(schema);
+            const column_lookup columns(*schema);
+            muts.reserve(muts.size() + cf_key.second.size());
             for (auto&& key_mutations : cf_key.second) {
                 mutation m_to_apply(schema, key_from_thrift(*schema, to_bytes_view(key_mutations.first)));
                 for (auto&& m : key_mutations.second) {
-                    add_to_mutation(*schema, m, m_to_apply);
+                    add_to_mutation(*schema, m, m_to_apply, &columns);
                 }
                 muts.emplace_back(std::move(m_to_apply));
             }
@@ -9,6 +9,7 @@
 #include <chrono>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_map.hpp>
+#include <boost/icl/interval_set.hpp>
 #include "schema.hh"
 #include "dht/i_partitioner.hh"
 #include "gc_clock.hh"
@@ -60,7 +61,9 @@ void tombstone_gc_state::drop_repair_history_map_for_table(const table_id& id) {
 //
 // The knows_entire_range is set to true:
 // 1) if the tombstone_gc_mode is not repair, since we have the same value for all the keys in the ranges.
-// 2) if the tombstone_gc_mode is repair, and the range is a sub range of a range in the repair history map.
+// 2) if the tombstone_gc_mode is repair, and the range is covered by ranges in the repair history map,
+//    with no gaps. The ranges may have been repaired at different times, min_gc_before is then the
+//    gc_before of the least recently repaired one.
 tombstone_gc_state::get_gc_before_for_range_result tombstone_gc_state::get_gc_before_for_range(schema_ptr s, const dht::token_range& range, const gc_clock::time_point& query_time) const {
     bool knows_entire_range = true;
     const auto& options = s->tombstone_gc_options();
@@ -91,20 +94,20 @@ tombstone_gc_state::get_gc_before_for_range_result tombstone_gc_state::get_gc_be
             auto interval = locator::token_metadata::range_to_interval(range);
             auto min = gc_clock::time_point::max();
             auto max = gc_clock::time_point::min();
-            bool contains_all = false;
+            // The parts of the range with a repair time. Touching intervals
+            // are joined, so a range without gaps ends up as one interval.
+            boost::icl::interval_set<dht::token> covered;
             for (auto& x : boost::make_iterator_range(m->map.equal_range(interval))) {
-                auto r = locator::token_metadata::interval_to_range(x.first);
                 min = std::min(x.second, min);
                 max = std::max(x.second, max);
-                if (++hits == 1 && r.contains(range, dht::tri_compare)) {
-                    contains_all = true;
-                }
+                covered += x.first & interval;
+                ++hits;
             }
             if (hits == 0) {
                 min_repair_timestamp = gc_clock::time_point::min();
                 max_repair_timestamp = gc_clock::time_point::min();
             } else {
-                knows_entire_range = hits == 1 && contains_all;
+                knows_entire_range = boost::icl::contains(covered, interval);
                 min_repair_timestamp = min;
                 max_repair_timestamp = max;
             }
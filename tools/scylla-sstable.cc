@@ -13,6 +13,7 @@
 #include <fmt/chrono.h>
 #include <seastar/core/app-template.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/util/closeable.hh>
 
 #include "compaction/compaction.hh"
@@ -22,6 +23,9 @@
 #include "reader_concurrency_semaphore.hh"
 #include "readers/combined.hh"
 #include "readers/generating_v2.hh"
+#include "readers/multi_range.hh"
+#include "mutation_writer/partition_based_splitting_writer.hh"
+#include "mutation_writer/shard_based_splitting_writer.hh"
 #include "schema_builder.hh"
 #include "sstables/index_reader.hh"
 #include "sstables/sstables_manager.hh"
@@ -847,27 +851,48 @@ stop_iteration consume_reader(flat_mutation_reader_v2 rd, sstable_consumer& cons
     return consumer.on_end_of_sstable().get();
 }
 
+// Returns singular ranges of the filtered-for partitions, in ring order.
+// Reading only these lets the sstable reader look the partitions up in the
+// index, instead of reading through (and decompressing) the whole data file.
+dht::partition_range_vector get_partition_ranges(schema_ptr schema, const partition_set& partitions) {
+    std::vector<dht::decorated_key> keys(partitions.begin(), partitions.end());
+    std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(std::move(schema)));
+    dht::partition_range_vector ranges;
+    ranges.reserve(keys.size());
+    for (auto& key : keys) {
+        ranges.emplace_back(dht::partition_range::make_singular(std::move(key)));
+    }
+    return ranges;
+}
+
+// If ranges is not null, only the partitions in it are read, otherwise all
+// partitions are. Ranges are only supported with the regular (not crawling)
+// reader, as they need the index.
 void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstables::shared_sstable> sstables, bool merge, bool use_crawling_reader,
-        std::function<stop_iteration(flat_mutation_reader_v2&, sstables::sstable*)> reader_consumer) {
-    sst_log.trace("consume_sstables(): {} sstables, merge={}, use_crawling_reader={}", sstables.size(), merge, use_crawling_reader);
+        const dht::partition_range_vector* ranges, std::function<stop_iteration(flat_mutation_reader_v2&, sstables::sstable*)> reader_consumer) {
+    sst_log.trace("consume_sstables(): {} sstables, merge={}, use_crawling_reader={}, ranges={}", sstables.size(), merge, use_crawling_reader,
+            ranges ? fmt::format("{}", ranges->size()) : "all");
+    auto make_reader = [&] (const sstables::shared_sstable& sst) {
+        if (ranges) {
+            return make_flat_multi_range_reader(schema, permit, sst->as_mutation_source(), *ranges, schema->full_slice());
+        }
+        if (use_crawling_reader) {
+            return sst->make_crawling_reader(schema, permit);
+        }
+        return sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice());
+    };
     if (merge) {
         std::vector<flat_mutation_reader_v2> readers;
         readers.reserve(sstables.size());
         for (const auto& sst : sstables) {
-            if (use_crawling_reader) {
-                readers.emplace_back(sst->make_crawling_reader(schema, permit));
-            } else {
-                readers.emplace_back(sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice()));
-            }
+            readers.emplace_back(make_reader(sst));
         }
         auto rd = make_combined_reader(schema, permit, std::move(readers));
 
         reader_consumer(rd, nullptr);
     } else {
         for (const auto& sst : sstables) {
-            auto rd = use_crawling_reader
-                ? sst->make_crawling_reader(schema, permit)
-                : sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice());
+            auto rd = make_reader(sst);
 
             if (reader_consumer(rd, sst.get()) == stop_iteration::yes) {
                 break;
@@ -876,6 +901,11 @@ void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstab
     }
 }
 
+// How many sstables operations which process sstables independently of each
+// other work on at the same time. Keeps the disk busy without opening too
+// many readers at once.
+constexpr size_t max_concurrent_sstables = 16;
+
 using operation_func = void(*)(schema_ptr, reader_permit, const std::vector<sstables::shared_sstable>&, sstables::sstables_manager&, const bpo::variables_map&);
 
 class operation {
@@ -911,7 +941,16 @@ void validate_operation(schema_ptr schema, reader_permit permit, const std::vect
     }
     const auto merge = vm.count("merge");
     sstables::compaction_data info;
-    consume_sstables(schema, permit, sstables, merge, true, [&info] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
+    if (!merge) {
+        // The sstables are validated independently, so overlap their I/O.
+        max_concurrent_for_each(sstables, max_concurrent_sstables, [&] (const sstables::shared_sstable& sst) -> future<> {
+            sst_log.info("validating {}", sst->get_filename());
+            const auto errors = co_await sstables::scrub_validate_mode_validate_reader(sst->make_crawling_reader(schema, permit), info);
+            sst_log.info("validated {}: {}", sst->get_filename(), errors == 0 ? "valid" : "invalid");
+        }).get();
+        return;
+    }
+    consume_sstables(schema, permit, sstables, merge, true, nullptr, [&info] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
         if (sst) {
             sst_log.info("validating {}", sst->get_filename());
         }
@@ -1335,6 +1374,7 @@ const char* to_string(sstables::scylla_metadata_type t) {
         case sstables::scylla_metadata_type::SSTableOrigin: return "sstable_origin";
         case sstables::scylla_metadata_type::ScyllaVersion: return "scylla_version";
         case sstables::scylla_metadata_type::ScyllaBuildId: return "scylla_build_id";
+        case sstables::scylla_metadata_type::FilterLayout: return "filter_layout";
     }
     std::abort();
 }
@@ -1389,6 +1429,7 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
                 {sstables::sstable_feature::CorrectStaticCompact, "CorrectStaticCompact"},
                 {sstables::sstable_feature::CorrectEmptyCounters, "CorrectEmptyCounters"},
                 {sstables::sstable_feature::CorrectUDTsInCollections, "CorrectUDTsInCollections"},
+                {sstables::sstable_feature::PrefixCompressedPIEntries, "PrefixCompressedPIEntries"},
         };
         _writer.StartObject();
         _writer.Key("mask");
@@ -1433,6 +1474,13 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
     void operator()(const sstables::disk_string<Size>& val) const {
         _writer.String(disk_string_to_string(val));
     }
+    void operator()(const sstables::filter_layout& val) const {
+        switch (val) {
+            case sstables::filter_layout::classic: _writer.String("classic"); return;
+            case sstables::filter_layout::blocked: _writer.String("blocked"); return;
+        }
+        _writer.String(format("unknown({})", static_cast<unsigned>(val)));
+    }
 
     template <sstables::scylla_metadata_type E, typename T>
     void operator()(const sstables::disk_tagged_union_member<sstables::scylla_metadata_type, E, T>& m) const {
@@ -1471,10 +1519,10 @@ void validate_checksums_operation(schema_ptr schema, reader_permit permit, const
         throw std::runtime_error("error: no sstables specified on the command line");
     }
 
-    for (auto& sst : sstables) {
-        const auto valid = sstables::validate_checksums(sst, permit, default_priority_class()).get();
+    max_concurrent_for_each(sstables, max_concurrent_sstables, [&] (const sstables::shared_sstable& sst) -> future<> {
+        const auto valid = co_await sstables::validate_checksums(sst, permit, default_priority_class());
         sst_log.info("validated the checksums of {}: {}", sst->get_filename(), valid ? "valid" : "invalid");
-    }
+    }).get();
 }
 
 void decompress_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
@@ -2403,16 +2451,20 @@ void write_operation(schema_ptr schema, reader_permit permit, const std::vector<
     if (!vm.count("generation")) {
         throw std::invalid_argument("error: missing required option '--generation'");
     }
-    auto generation = sstables::generation_type(vm["generation"].as<int64_t>());
+    auto next_generation = vm["generation"].as<int64_t>();
     auto format = sstables::sstable_format_types::big;
     auto version = sstables::get_highest_sstable_version();
+    const auto unsorted = vm.count("unsorted");
+    const auto split_by_shard = vm.count("split-by-shard");
+    const auto max_memory = vm["max-memory"].as<size_t>();
 
-    {
+    auto check_not_exists = [&] (sstables::generation_type generation) -> future<> {
         auto sst_name = sstables::sstable::filename(output_dir, schema->ks_name(), schema->cf_name(), version, generation, format, component_type::Data);
-        if (file_exists(sst_name).get()) {
+        if (co_await file_exists(sst_name)) {
             throw std::runtime_error(fmt::format("error: cannot create output sstable {}, file already exists", sst_name));
         }
-    }
+    };
+    check_not_exists(sstables::generation_type(next_generation)).get();
 
     auto ifile = open_file_dma(input_file, open_flags::ro).get();
     auto istream = make_file_input_stream(std::move(ifile));
@@ -2420,9 +2472,32 @@ void write_operation(schema_ptr schema, reader_permit permit, const std::vector<
     auto reader = make_generating_reader_v2(schema, permit, std::move(parser));
     auto writer_cfg = manager.configure_writer("scylla-sstable");
     writer_cfg.validation_level = validation_level;
-    auto sst = manager.make_sstable(schema, output_dir, generation, version, format);
 
-    sst->write_components(std::move(reader), 1, schema, writer_cfg, encoding_stats{}).get();
+    // Each output stream gets its own sstable, with consecutive generations.
+    reader_consumer_v2 write_sstable = [&] (flat_mutation_reader_v2 rd) -> future<> {
+        auto generation = sstables::generation_type(next_generation++);
+        try {
+            co_await check_not_exists(generation);
+        } catch (...) {
+            co_await rd.close();
+            throw;
+        }
+        auto sst = manager.make_sstable(schema, output_dir, generation, version, format);
+        sst_log.info("writing {}", sst->get_filename());
+        co_await sst->write_components(std::move(rd), 1, schema, writer_cfg, encoding_stats{});
+    };
+    reader_consumer_v2 consumer = std::move(write_sstable);
+    if (split_by_shard) {
+        consumer = [&, write = std::move(consumer)] (flat_mutation_reader_v2 rd) mutable {
+            return mutation_writer::segregate_by_shard(std::move(rd), std::ref(write));
+        };
+    }
+    if (unsorted) {
+        auto cfg = mutation_writer::segregate_config{default_priority_class(), max_memory};
+        mutation_writer::segregate_by_partition(std::move(reader), cfg, std::move(consumer)).get();
+    } else {
+        consumer(std::move(reader)).get();
+    }
 }
 
 template <typename SstableConsumer>
@@ -2435,9 +2510,14 @@ void sstable_consumer_operation(schema_ptr schema, reader_permit permit, const s
     const auto no_skips = vm.count("no-skips");
     const auto partitions = get_partitions(schema, vm);
     const auto use_crawling_reader = no_skips || partitions.empty();
+    std::optional<dht::partition_range_vector> ranges;
+    if (!use_crawling_reader) {
+        ranges = get_partition_ranges(schema, partitions);
+    }
     auto consumer = std::make_unique<SstableConsumer>(schema, permit, vm);
     consumer->on_start_of_stream().get();
-    consume_sstables(schema, permit, sstables, merge, use_crawling_reader, [&, &consumer = *consumer] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
+    consume_sstables(schema, permit, sstables, merge, use_crawling_reader, ranges ? &*ranges : nullptr,
+            [&, &consumer = *consumer] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
         return consume_reader(std::move(rd), consumer, sst, partitions, no_skips);
     });
     consumer->on_end_of_stream().get();
@@ -2503,6 +2583,9 @@ const std::vector<option> all_options {
     typed_option<std::string>("output-dir", ".", "directory to place the output files to"),
     typed_option<int64_t>("generation", "generation of generated sstable"),
     typed_option<std::string>("validation-level", "clustering_key", "degree of validation on the output, one of (partition_region, token, partition_key, clustering_key)"),
+    typed_option<>("unsorted", "the input may contain partitions in any order, sort it in memory bounded by --max-memory, writing more sstables if needed"),
+    typed_option<size_t>("max-memory", 256 << 20, "maximum amount of memory to use for sorting unsorted input (in bytes)"),
+    typed_option<>("split-by-shard", "write a separate sstable for each shard, the shard count is that of the tool (see --smp)"),
 };
 
 const std::vector<operation> operations{
@@ -3037,8 +3120,19 @@ Note that levels are cumulative, each contains all the checks of the
 previous levels too. By default the strictest level is used. This can
 be relaxed if e.g. one wants to produce intentionally corrupt sstables
 for tests.
+
+For bulk generation of sstables, the input doesn't have to be sorted. With
+--unsorted, partitions may come in any order, and may even appear multiple
+times. The input is sorted in memory, bounded by --max-memory, and each
+time the memory limit is reached a new output sstable is started.
+With --split-by-shard, each output sstable is further split by the shard
+owning its partitions, so the resulting sstables can be loaded without
+resharding. The shard count used is that of the tool itself, set it with
+--smp to match the target nodes.
+Additional output sstables use consecutive generations, starting from
+--generation.
 )",
-            {"input-file", "output-dir", "generation", "validation-level"},
+            {"input-file", "output-dir", "generation", "validation-level", "unsorted", "max-memory", "split-by-shard"},
             write_operation},
 };
 
@@ -429,6 +429,14 @@ class trace_state final {
      */
     void trace_internal(sstring msg);
 
+    /**
+     * Checks whether there is budget for storing one more trace record.
+     * Accounts for a dropped record if there isn't.
+     *
+     * @return TRUE if a record may be stored
+     */
+    bool check_records_budget();
+
     /**
      * Add a single trace entry - a special case for a simple string.
      *
@@ -444,6 +452,9 @@ class trace_state final {
     }
     void trace(const char* msg) noexcept {
         try {
+            if (!is_in_state(state::inactive) && !check_records_budget()) {
+                return;
+            }
             trace_internal(sstring(msg));
         } catch (...) {
             // Bump up an error counter and ignore
@@ -517,11 +528,7 @@ class trace_state_ptr final {
     }
 };
 
-inline void trace_state::trace_internal(sstring message) {
-    if (is_in_state(state::inactive)) {
-        throw std::logic_error("trying to use a trace() before begin() for \"" + message + "\" tracepoint");
-    }
-
+inline bool trace_state::check_records_budget() {
     // We don't want the total amount of pending, active and flushing records to
     // bypass two times the maximum number of pending records.
     //
@@ -535,6 +542,17 @@ inline void trace_state::trace_internal(sstring message) {
             tracing_logger.warn("Maximum records limit is hit {} times", _local_tracing_ptr->stats.dropped_records);
         }
 
+        return false;
+    }
+    return true;
+}
+
+inline void trace_state::trace_internal(sstring message) {
+    if (is_in_state(state::inactive)) {
+        throw std::logic_error("trying to use a trace() before begin() for \"" + message + "\" tracepoint");
+    }
+
+    if (!check_records_budget()) {
         return;
     }
 
@@ -565,6 +583,10 @@ inline void trace_state::trace_internal(sstring message) {
 template <typename... A>
 void trace_state::trace(const char* fmt, A&&... a) noexcept {
     try {
+        // Don't format a message which is going to be dropped anyway.
+        if (!is_in_state(state::inactive) && !check_records_budget()) {
+            return;
+        }
         trace_internal(seastar::format(fmt, std::forward<A>(a)...));
     } catch (...) {
         // Bump up an error counter and ignore
@@ -17,9 +17,12 @@ namespace cql_transport {
 
 static const std::map<cql_protocol_extension, seastar::sstring> EXTENSION_NAMES = {
     {cql_protocol_extension::LWT_ADD_METADATA_MARK, "SCYLLA_LWT_ADD_METADATA_MARK"},
-    {cql_protocol_extension::RATE_LIMIT_ERROR, "SCYLLA_RATE_LIMIT_ERROR"}
+    {cql_protocol_extension::RATE_LIMIT_ERROR, "SCYLLA_RATE_LIMIT_ERROR"},
+    {cql_protocol_extension::SHARD_ROUTING_HINT, "SCYLLA_SHARD_ROUTING_HINT"}
 };
 
+const seastar::sstring shard_routing_hint_payload_key = "scylla-owner-shard";
+
 cql_protocol_extension_enum_set supported_cql_protocol_extensions() {
     return cql_protocol_extension_enum_set::full();
 } 
@@ -34,6 +37,8 @@ std::vector<seastar::sstring> additional_options_for_proto_ext(cql_protocol_exte
             return {format("LWT_OPTIMIZATION_META_BIT_MASK={:d}", cql3::prepared_metadata::LWT_FLAG_MASK)};
         case cql_protocol_extension::RATE_LIMIT_ERROR:
             return {format("ERROR_CODE={}", exceptions::exception_code::RATE_LIMIT_ERROR)};
+        case cql_protocol_extension::SHARD_ROUTING_HINT:
+            return {format("PAYLOAD_KEY={}", shard_routing_hint_payload_key)};
         default:
             return {};
     }
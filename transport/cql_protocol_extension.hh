@@ -29,12 +29,20 @@ namespace cql_transport {
  */
 enum class cql_protocol_extension {
     LWT_ADD_METADATA_MARK,
-    RATE_LIMIT_ERROR
+    RATE_LIMIT_ERROR,
+    SHARD_ROUTING_HINT
 };
 
 using cql_protocol_extension_enum = super_enum<cql_protocol_extension,
     cql_protocol_extension::LWT_ADD_METADATA_MARK,
-    cql_protocol_extension::RATE_LIMIT_ERROR>;
+    cql_protocol_extension::RATE_LIMIT_ERROR,
+    cql_protocol_extension::SHARD_ROUTING_HINT>;
+
+/**
+ * The key of the custom payload entry holding the shard which owns the partition
+ * of a misrouted request, sent with the SHARD_ROUTING_HINT extension.
+ */
+extern const seastar::sstring shard_routing_hint_payload_key;
 
 using cql_protocol_extension_enum_set = enum_set<cql_protocol_extension_enum>;
 
@@ -204,10 +204,10 @@ class request_reader {
         options_flag::NAMES_FOR_VALUES
     >;
 public:
-    std::unique_ptr<cql3::query_options> read_options(uint8_t version, cql_serialization_format cql_ser_format, const cql3::cql_config& cql_config) {
+    cql3::query_options read_options(uint8_t version, cql_serialization_format cql_ser_format, const cql3::cql_config& cql_config) {
         auto consistency = read_consistency();
         if (version == 1) {
-            return std::make_unique<cql3::query_options>(cql_config, consistency, std::nullopt, std::vector<cql3::raw_value_view>{},
+            return cql3::query_options(cql_config, consistency, std::nullopt, std::vector<cql3::raw_value_view>{},
                 false, cql3::query_options::specific_options::DEFAULT, cql_ser_format);
         }
 
@@ -229,7 +229,6 @@ class request_reader {
         flags.remove<options_flag::VALUES>();
         flags.remove<options_flag::SKIP_METADATA>();
 
-        std::unique_ptr<cql3::query_options> options;
         if (flags) {
             lw_shared_ptr<service::pager::paging_state> paging_state;
             int32_t page_size = flags.contains<options_flag::PAGE_SIZE>() ? read_int() : -1;
@@ -255,15 +254,12 @@ class request_reader {
             if (!names.empty()) {
                 onames = std::move(names);
             }
-            options = std::make_unique<cql3::query_options>(cql_config, consistency, std::move(onames), std::move(values), skip_metadata,
+            return cql3::query_options(cql_config, consistency, std::move(onames), std::move(values), skip_metadata,
                 cql3::query_options::specific_options{page_size, std::move(paging_state), serial_consistency, ts},
                 cql_ser_format);
-        } else {
-            options = std::make_unique<cql3::query_options>(cql_config, consistency, std::nullopt, std::move(values), skip_metadata,
-                cql3::query_options::specific_options::DEFAULT, cql_ser_format);
         }
-
-        return options;
+        return cql3::query_options(cql_config, consistency, std::nullopt, std::move(values), skip_metadata,
+            cql3::query_options::specific_options::DEFAULT, cql_ser_format);
     }
 };
 
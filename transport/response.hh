@@ -10,6 +10,7 @@
 
 #include "server.hh"
 #include "utils/reusable_buffer.hh"
+#include <seastar/core/deleter.hh>
 
 namespace cql_transport {
 
@@ -38,7 +39,24 @@ class response {
     cql_binary_opcode _opcode;
     uint8_t           _flags = 0; // a bitwise OR mask of zero or more cql_frame_flags values
     bytes_ostream _body;
+    // Parts of the body referenced instead of copied into _body. Each one
+    // goes right after the first `position` bytes of _body, in order.
+    struct external_fragment {
+        size_t position;
+        bytes_view data;
+    };
+    std::vector<external_fragment> _external_fragments;
+    size_t _external_size = 0;
+    // Keeps the memory of _external_fragments alive.
+    deleter _external_owner;
+    // For responses to single partition requests, whether the request was sent
+    // to the shard owning the partition.
+    std::optional<bool> _misrouted;
 public:
+    // write_value_ref() copies fragments smaller than this, for which
+    // the copy is cheaper than an extra iovec in the scatter-gather write.
+    static constexpr size_t min_referenced_fragment_size = 512;
+
     template<typename T>
     class placeholder;
 
@@ -75,9 +93,17 @@ class response {
     void write_string_multimap(std::multimap<sstring, sstring> string_map);
     void write_value(bytes_opt value);
     void write_value(std::optional<query::result_bytes_view> value);
+    // Like write_value(), but large fragments of the value are referenced instead of
+    // copied. Their memory must be kept alive with retain() by the caller.
+    void write_value_ref(std::optional<query::result_bytes_view> value);
     void write(const cql3::metadata& m, bool skip = false);
     void write(const cql3::prepared_metadata& m, uint8_t version);
 
+    // Keeps d alive, and the memory it owns, until the response is destroyed.
+    void retain(deleter d) {
+        _external_owner.append(std::move(d));
+    }
+
     // Make a non-owning scattered_message of the response. Remains valid as long
     // as the response object is alive.
     scattered_message<char> make_message(uint8_t version, cql_compression compression);
@@ -85,10 +111,23 @@ class response {
     cql_binary_opcode opcode() const {
         return _opcode;
     }
+
+    void set_misrouted(bool misrouted) noexcept {
+        _misrouted = misrouted;
+    }
+
+    const std::optional<bool>& misrouted() const noexcept {
+        return _misrouted;
+    }
     size_t size() const {
-        return _body.size();
+        return _body.size() + _external_size;
     }
 private:
+    // Calls func with the fragments of the body, including the external ones, in order.
+    template <typename Func>
+    void for_each_body_fragment(Func&& func) const;
+    // Copies the external fragments into _body.
+    void inline_external_fragments();
     void compress(cql_compression compression);
     void compress_lz4();
     void compress_snappy();
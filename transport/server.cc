@@ -186,6 +186,13 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
         sm::make_counter("register_requests", _stats.register_requests,
                         sm::description("Counts the total number of received CQL REGISTER messages.")),
 
+        sm::make_counter("routable_requests", _stats.routable_requests,
+                        sm::description("Counts the CQL EXECUTE messages of statements restricted to a single partition, which shard-aware drivers can route to the shard owning it.")),
+
+        sm::make_counter("misrouted_requests", _stats.misrouted_requests,
+                        sm::description("Counts the CQL EXECUTE messages of statements restricted to a single partition which were sent to a shard not owning it. "
+                                        "A non-zero rate indicates clients with stale or missing shard routing, whose requests hop between shards.")),
+
         sm::make_counter("cql-connections", _stats.connects,
                         sm::description("Counts a number of client connections.")),
 
@@ -206,9 +213,15 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
                         sm::description(
                             seastar::format("Holds an incrementing counter with the requests that ever blocked due to reaching the memory quota limit ({}B). "
                                             "The first derivative of this value shows how often we block due to memory exhaustion in the \"CQL transport\" component.", _max_request_size))),
+        sm::make_counter("requests_blocked_connection_memory", _stats.requests_blocked_connection_memory,
+                        sm::description("Counts requests which waited for their connection's share of the request memory (configured via cql_connection_memory_share).")),
+        sm::make_counter("connection_memory_wait_us", _stats.connection_memory_wait_us,
+                        sm::description("Total time requests waited for their connection's share of the request memory, in microseconds.")),
         sm::make_counter("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component.")),
+        sm::make_counter("coalesced_responses", _stats.coalesced_responses,
+                        sm::description("Counts responses which were flushed to the client together with the responses queued after them.")),
         sm::make_gauge("requests_memory_available", [this] { return _memory_available.current(); },
                         sm::description(
                             seastar::format("Holds the amount of available memory for admitting new requests (max is {}B)."
@@ -520,6 +533,8 @@ cql_server::connection::connection(cql_server& server, socket_address server_add
     , _server(server)
     , _server_addr(server_addr)
     , _client_state(service::client_state::external_tag{}, server._auth_service, &server._sl_controller, server.timeout_config(), addr)
+    , _memory_share_size(std::min(server._config.max_connection_memory, server._max_request_size))
+    , _memory_share(_memory_share_size)
 {
     _shedding_timer.set_callback([this] {
         clogger.debug("Shedding all incoming requests due to overload");
@@ -551,6 +566,8 @@ client_data cql_server::connection::make_client_data() const {
     if (const auto user_ptr = _client_state.user(); user_ptr) {
         cd.username = user_ptr->name;
     }
+    cd.routable_requests = _routable_requests;
+    cd.misrouted_requests = _misrouted_requests;
     if (_ready) {
         cd.connection_stage = client_connection_stage::ready;
     } else if (_authenticating) {
@@ -606,7 +623,6 @@ future<> cql_server::connection::process_request() {
             tracing_requested = tracing_request_type::no_write_on_close;
         }
 
-        auto op = f.opcode;
         auto stream = f.stream;
         auto mem_estimate = f.length * 2 + 8000; // Allow for extra copies and bookkeeping
         if (mem_estimate > _server._max_request_size) {
@@ -628,6 +644,19 @@ future<> cql_server::connection::process_request() {
             });
         }
 
+        // A request bigger than the share takes all of it, so it runs alone.
+        const auto share_estimate = std::min<size_t>(mem_estimate, _memory_share_size);
+        const bool share_blocked = _memory_share.waiters() || _memory_share.available_units() < ssize_t(share_estimate);
+        if (share_blocked) {
+            ++_server._stats.requests_blocked_connection_memory;
+        }
+        return get_units(_memory_share, share_estimate).then([this, f, mem_estimate, allow_shedding, tracing_requested, share_blocked,
+                wait_start = share_blocked ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()] (semaphore_units<> share_permit) mutable {
+        if (share_blocked) {
+            _server._stats.connection_memory_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wait_start).count();
+        }
+        auto op = f.opcode;
+        auto stream = f.stream;
         const auto shedding_timeout = std::chrono::milliseconds(50);
         auto fut = allow_shedding
                 ? get_units(_server._memory_available, mem_estimate, shedding_timeout).then_wrapped([this, length = f.length] (auto f) {
@@ -651,14 +680,15 @@ future<> cql_server::connection::process_request() {
             ++_server._stats.requests_blocked_memory;
         }
 
-        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested] (auto mem_permit_fut) {
+        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested, share_permit = std::move(share_permit)] (auto mem_permit_fut) mutable {
           if (mem_permit_fut.failed()) {
               // Ignore semaphore errors - they are expected if load shedding took place
               mem_permit_fut.ignore_ready_future();
               return make_ready_future<>();
           }
           semaphore_units<> mem_permit = mem_permit_fut.get0();
-          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
+          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit)),
+                  share_permit = std::move(share_permit)] (fragmented_temporary_buffer buf) mutable {
 
             ++_server._stats.requests_served;
             ++_server._stats.requests_serving;
@@ -671,10 +701,10 @@ future<> cql_server::connection::process_request() {
             });
             auto istream = buf.get_istream();
             (void)_process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit)
-                    .then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+                    .then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), share_permit = std::move(share_permit)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
                 try {
                     write_response(response_f.get0(), std::move(mem_permit), _compression);
-                    _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
+                    _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave), share_permit = std::move(share_permit)] {});
                 } catch (...) {
                     clogger.error("request processing failed: {}", std::current_exception());
                 }
@@ -683,6 +713,7 @@ future<> cql_server::connection::process_request() {
             return make_ready_future<>();
           });
         });
+        });
     });
 }
 
@@ -835,8 +866,8 @@ cql_server::connection::init_cql_serialization_format() {
 }
 
 std::unique_ptr<cql_server::response>
-make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata = false);
+make_result(int16_t stream, ::shared_ptr<messages::result_message> msg, const tracing::trace_state_ptr& tr_state,
+        cql_protocol_version_type version, bool skip_metadata = false, std::optional<unsigned> owner_shard_hint = std::nullopt);
 
 template<typename Process>
 future<cql_server::result_with_foreign_response_ptr>
@@ -896,7 +927,7 @@ process_query_internal(service::client_state& client_state, distributed<cql3::qu
     auto query = in.read_long_string_view();
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
-    q_state->options = in.read_options(version, serialization_format, qp.local().get_cql_config());
+    q_state->options.emplace(in.read_options(version, serialization_format, qp.local().get_cql_config()));
     auto& options = *q_state->options;
     if (!cached_pk_fn_calls.empty()) {
         options.set_cached_pk_function_calls(std::move(cached_pk_fn_calls));
@@ -920,7 +951,7 @@ process_query_internal(service::client_state& client_state, distributed<cql3::qu
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
         }
     });
 }
@@ -940,31 +971,49 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
     tracing::add_query(trace_state, query);
     tracing::begin(trace_state, "Preparing CQL3 query", client_state.get_client_address());
 
-    auto cpu_id = this_shard_id();
-    auto cpus = boost::irange(0u, smp::count);
-    return parallel_for_each(cpus.begin(), cpus.end(), [this, query, cpu_id, &client_state] (unsigned int c) mutable {
-        if (c != cpu_id) {
-            return smp::submit_to(c, [this, query, &client_state] () mutable {
-                return _server._query_processor.local().prepare(std::move(query), client_state, false).discard_result();
-            });
-        } else {
-            return make_ready_future<>();
-        }
-    }).then([this, query, stream, &client_state, trace_state] () mutable {
-        tracing::trace(trace_state, "Done preparing on remote shards");
-        return _server._query_processor.local().prepare(std::move(query), client_state, false).then([this, stream, &client_state, trace_state] (auto msg) {
-            tracing::trace(trace_state, "Done preparing on a local shard - preparing a result. ID is [{}]", seastar::value_of([&msg] {
-                return messages::result_message::prepared::cql::get_id(msg);
-            }));
-            return make_result(stream, *msg, trace_state, _version);
-        });
+    // Other shards prepare the statement when they first execute it, see
+    // query_processor::prepare_from_other_shards().
+    return _server._query_processor.local().prepare(std::move(query), client_state, false).then([this, stream, &client_state, trace_state] (auto msg) {
+        tracing::trace(trace_state, "Done preparing on a local shard - preparing a result. ID is [{}]", seastar::value_of([&msg] {
+            return messages::result_message::prepared::cql::get_id(msg);
+        }));
+        return make_result(stream, msg, trace_state, _version);
     });
 }
 
+// Returns the shard owning the partition a prepared statement is restricted to,
+// if the bound values name a single partition.
+static std::optional<unsigned> owner_shard(cql3::query_processor& qp, const cql3::statements::prepared_statement& prepared,
+        const cql3::query_options& options) {
+    const auto& indices = prepared.partition_key_bind_indices;
+    if (indices.empty()) {
+        return std::nullopt;
+    }
+    const auto& spec = *prepared.bound_names[indices.front()];
+    auto table = qp.db().try_find_table(spec.ks_name, spec.cf_name);
+    if (!table) {
+        return std::nullopt;
+    }
+    const auto& s = *table->schema();
+    std::vector<bytes> components;
+    components.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        auto value = options.get_value_at(indices[i]);
+        // A marker of another type, like the list of IN ?, names several partitions.
+        if (!value || prepared.bound_names[indices[i]]->type != s.partition_key_columns()[i].type) {
+            return std::nullopt;
+        }
+        components.push_back(value.with_linearized([] (bytes_view v) { return bytes(v); }));
+    }
+    auto key = partition_key::from_exploded(s, components);
+    return s.get_sharder().shard_of(dht::get_token(s, key));
+}
+
 static future<process_fn_return_type>
 process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
         service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+    const auto request = in;
     cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
     auto& id = cql3::prepared_cache_key_type::cql_id(cache_key);
     bool needs_authorization = false;
@@ -978,7 +1027,14 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
     }
 
     if (!prepared) {
-        throw exceptions::prepared_query_not_found_exception(id);
+        return qp.local().prepare_from_other_shards(cache_key).then([&client_state, &qp, request, stream, version, serialization_format, permit = std::move(permit),
+                trace_state = std::move(trace_state), init_trace, cached_pk_fn_calls = std::move(cached_pk_fn_calls), id = id] (bool found) mutable {
+            if (!found) {
+                throw exceptions::prepared_query_not_found_exception(id);
+            }
+            return process_execute_internal(client_state, qp, request, stream, version, serialization_format,
+                    std::move(permit), std::move(trace_state), init_trace, std::move(cached_pk_fn_calls));
+        });
     }
 
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
@@ -987,10 +1043,10 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
         std::vector<cql3::raw_value_view> values;
         in.read_value_view_list(version, values);
         auto consistency = in.read_consistency();
-        q_state->options = std::make_unique<cql3::query_options>(qp.local().get_cql_config(), consistency, std::nullopt, values, false,
-                                                                 cql3::query_options::specific_options::DEFAULT, serialization_format);
+        q_state->options.emplace(qp.local().get_cql_config(), consistency, std::nullopt, std::move(values), false,
+                                 cql3::query_options::specific_options::DEFAULT, serialization_format);
     } else {
-        q_state->options = in.read_options(version, serialization_format, qp.local().get_cql_config());
+        q_state->options.emplace(in.read_options(version, serialization_format, qp.local().get_cql_config()));
     }
     auto& options = *q_state->options;
     if (!cached_pk_fn_calls.empty()) {
@@ -1025,16 +1081,31 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
         tracing::add_prepared_query_options(trace_state, options);
     }
 
+    // A request bounced here was first sent to another shard.
+    auto owner = init_trace ? owner_shard(qp.local(), *prepared, options) : std::make_optional(this_shard_id());
+    std::optional<bool> misrouted;
+    std::optional<unsigned> owner_shard_hint;
+    if (owner) {
+        misrouted = !init_trace || *owner != this_shard_id();
+        if (*misrouted && client_state.is_protocol_extension_set(cql_protocol_extension::SHARD_ROUTING_HINT)) {
+            owner_shard_hint = *owner;
+        }
+    }
+
     tracing::trace(trace_state, "Processing a statement");
     return qp.local().execute_prepared_without_checking_exception_message(std::move(prepared), std::move(cache_key), query_state, options, needs_authorization)
-            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
+            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version, owner_shard_hint, misrouted] (auto msg) {
         if (msg->move_to_shard()) {
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else if (msg->is_exception()) {
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            auto response = make_result(stream, msg, q_state->query_state.get_trace_state(), version, skip_metadata, owner_shard_hint);
+            if (misrouted) {
+                response->set_misrouted(*misrouted);
+            }
+            return process_fn_return_type(make_foreign(std::move(response)));
         }
     });
 }
@@ -1042,7 +1113,17 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 future<cql_server::result_with_foreign_response_ptr> cql_server::connection::process_execute(uint16_t stream, request_reader in,
         service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state) {
     ++_server._stats.execute_requests;
-    return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_execute_internal);
+    return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_execute_internal).then([this] (result_with_foreign_response_ptr res) {
+        if (res && res.value()->misrouted()) {
+            ++_server._stats.routable_requests;
+            ++_routable_requests;
+            if (*res.value()->misrouted()) {
+                ++_server._stats.misrouted_requests;
+                ++_misrouted_requests;
+            }
+        }
+        return res;
+    });
 }
 
 static future<process_fn_return_type>
@@ -1053,6 +1134,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
         throw exceptions::protocol_exception("BATCH messages are not support in version 1 of the protocol");
     }
 
+    const auto request = in;
     const auto type = in.read_byte();
     const unsigned n = in.read_short();
 
@@ -1094,7 +1176,15 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
             if (!ps) {
                 ps = qp.local().get_prepared(cache_key);
                 if (!ps) {
-                    throw exceptions::prepared_query_not_found_exception(id);
+                    // Prepare it from another shard and start over, see process_execute_internal().
+                    return qp.local().prepare_from_other_shards(cache_key).then([&client_state, &qp, request, stream, version, serialization_format, permit = std::move(permit),
+                            trace_state = std::move(trace_state), init_trace, cached_pk_fn_calls = std::move(cached_pk_fn_calls), id = id] (bool found) mutable {
+                        if (!found) {
+                            throw exceptions::prepared_query_not_found_exception(id);
+                        }
+                        return process_batch_internal(client_state, qp, request, stream, version, serialization_format,
+                                std::move(permit), std::move(trace_state), init_trace, std::move(cached_pk_fn_calls));
+                    });
                 }
                 // authorize a particular prepared statement only once
                 needs_authorization = pending_authorization_entries.emplace(std::move(cache_key), ps->checked_weak_from_this()).second;
@@ -1136,8 +1226,8 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
     // #563. CQL v2 encodes query_options in v1 format for batch requests.
-    q_state->options = std::make_unique<cql3::query_options>(cql3::query_options::make_batch_options(std::move(*in.read_options(version < 3 ? 1 : version, serialization_format,
-                                                                     qp.local().get_cql_config())), std::move(values)));
+    q_state->options.emplace(cql3::query_options::make_batch_options(in.read_options(version < 3 ? 1 : version, serialization_format,
+                                                                     qp.local().get_cql_config()), std::move(values)));
     auto& options = *q_state->options;
     if (!cached_pk_fn_calls.empty()) {
         options.set_cached_pk_function_calls(std::move(cached_pk_fn_calls));
@@ -1159,7 +1249,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, trace_state, version)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, trace_state, version)));
         }
     });
 }
@@ -1422,9 +1512,15 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
             void start_row() {
                 _row_count++;
             }
+            // Key components are exploded into temporaries, so values
+            // in general have to be copied.
             void accept_value(std::optional<query::result_bytes_view> cell) {
                 _response.write_value(cell);
             }
+            // make_result() keeps the message, which owns the result's cells, alive.
+            void accept_result_value(std::optional<query::result_bytes_view> cell) {
+                _response.write_value_ref(cell);
+            }
             void end_row() { }
 
             int64_t row_count() const { return _row_count; }
@@ -1437,15 +1533,24 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 };
 
 std::unique_ptr<cql_server::response>
-make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata) {
+make_result(int16_t stream, ::shared_ptr<messages::result_message> msg, const tracing::trace_state_ptr& tr_state,
+        cql_protocol_version_type version, bool skip_metadata, std::optional<unsigned> owner_shard_hint) {
     auto response = std::make_unique<cql_server::response>(stream, cql_binary_opcode::RESULT, tr_state);
-    if (__builtin_expect(!msg.warnings().empty() && version > 3, false)) {
+    if (__builtin_expect(!msg->warnings().empty() && version > 3, false)) {
         response->set_frame_flag(cql_frame_flags::warning);
-        response->write_string_list(msg.warnings());
+        response->write_string_list(msg->warnings());
+    }
+    // The custom payload goes after the warnings, and is supported since v4.
+    if (__builtin_expect(owner_shard_hint && version > 3, false)) {
+        response->set_frame_flag(cql_frame_flags::custom_payload);
+        response->write_short(1);
+        response->write_string(shard_routing_hint_payload_key);
+        response->write_bytes(int32_type->decompose(int32_t(*owner_shard_hint)));
     }
     cql_server::fmt_visitor fmt{version, *response, skip_metadata};
-    msg.accept(fmt);
+    msg->accept(fmt);
+    // Rows reference the cells of the result instead of copying them.
+    response->retain(make_object_deleter(std::move(msg)));
     return response;
 }
 
@@ -1480,30 +1585,78 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
 
 void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
 {
+    ++_queued_responses;
     _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
+        --_queued_responses;
         auto message = response->make_message(_version, compression);
         message.on_delete([response = std::move(response)] { });
         return _write_buf.write(std::move(message)).then([this] {
+            // Responses queued behind this one go out in the same flush,
+            // the last of them flushes.
+            if (_queued_responses) {
+                ++_server._stats.coalesced_responses;
+                return make_ready_future<>();
+            }
             return _write_buf.flush();
         });
     });
 }
 
+template <typename Func>
+void cql_server::response::for_each_body_fragment(Func&& func) const {
+    auto ext = _external_fragments.begin();
+    size_t pos = 0;
+    for (bytes_view fragment : _body.fragments()) {
+        while (ext != _external_fragments.end() && ext->position <= pos + fragment.size()) {
+            auto n = ext->position - pos;
+            if (n) {
+                func(fragment.substr(0, n));
+                fragment.remove_prefix(n);
+                pos += n;
+            }
+            func(ext->data);
+            ++ext;
+        }
+        if (!fragment.empty()) {
+            func(fragment);
+            pos += fragment.size();
+        }
+    }
+    for (; ext != _external_fragments.end(); ++ext) {
+        func(ext->data);
+    }
+}
+
+void cql_server::response::inline_external_fragments() {
+    if (_external_fragments.empty()) {
+        return;
+    }
+    bytes_ostream body;
+    for_each_body_fragment([&] (bytes_view fragment) {
+        body.write(fragment);
+    });
+    _body = std::move(body);
+    _external_fragments.clear();
+    _external_size = 0;
+}
+
 scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
     if (compression != cql_compression::none) {
         compress(compression);
     }
     scattered_message<char> msg;
-    auto frame = make_frame(version, _body.size());
+    auto frame = make_frame(version, size());
     msg.append(std::move(frame));
-    for (auto&& fragment : _body.fragments()) {
+    for_each_body_fragment([&] (bytes_view fragment) {
         msg.append_static(reinterpret_cast<const char*>(fragment.data()), fragment.size());
-    }
+    });
     return msg;
 }
 
 void cql_server::response::compress(cql_compression compression)
 {
+    // The compressors work on a linearized body anyway.
+    inline_external_fragments();
     switch (compression) {
     case cql_compression::lz4:
         compress_lz4();
@@ -1752,6 +1905,25 @@ void cql_server::response::write_value(std::optional<query::result_bytes_view> v
     });
 }
 
+void cql_server::response::write_value_ref(std::optional<query::result_bytes_view> value)
+{
+    if (!value) {
+        write_int(-1);
+        return;
+    }
+
+    write_int(value->size_bytes());
+    using boost::range::for_each;
+    for_each(*value, [&] (bytes_view fragment) {
+        if (fragment.size() < min_referenced_fragment_size) {
+            _body.write(fragment);
+        } else {
+            _external_fragments.push_back(external_fragment{_body.size(), fragment});
+            _external_size += fragment.size();
+        }
+    });
+}
+
 class type_codec {
 private:
     enum class type_id : int16_t {
@@ -74,6 +74,7 @@ enum class cql_compression {
 enum cql_frame_flags {
     compression = 0x01,
     tracing     = 0x02,
+    custom_payload = 0x04,
     warning     = 0x08,
 };
 
@@ -103,9 +104,12 @@ struct [[gnu::packed]] cql_binary_frame_v3 {
     }
 };
 
+// The coordinator-side state of a single QUERY, EXECUTE or BATCH request,
+// alive until the request completes. The options are kept inline, so the
+// state of a request takes one allocation rather than one per member.
 struct cql_query_state {
     service::query_state query_state;
-    std::unique_ptr<cql3::query_options> options;
+    std::optional<cql3::query_options> options;
 
     cql_query_state(service::client_state& client_state, tracing::trace_state_ptr trace_state_ptr, service_permit permit)
         : query_state(client_state, std::move(trace_state_ptr), std::move(permit))
@@ -115,6 +119,8 @@ struct cql_query_state {
 struct cql_server_config {
     ::timeout_config timeout_config;
     size_t max_request_size;
+    // Memory the in-flight requests of a single connection may take.
+    size_t max_connection_memory = std::numeric_limits<size_t>::max();
     sstring partitioner_name;
     unsigned sharding_ignore_msb;
     std::optional<uint16_t> shard_aware_transport_port;
@@ -132,7 +138,13 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint64_t requests_served;
         uint32_t requests_serving;
         uint64_t requests_blocked_memory;
+        // Requests which waited for their connection's memory share, and
+        // the total time they waited.
+        uint64_t requests_blocked_connection_memory;
+        uint64_t connection_memory_wait_us;
         uint64_t requests_shed;
+        // Responses written without a flush of their own.
+        uint64_t coalesced_responses;
 
         // cql message stats
         uint64_t startups;
@@ -143,6 +155,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint64_t execute_requests;
         uint64_t batch_requests;
         uint64_t register_requests;
+        // EXECUTE requests of single partition statements, and those of them
+        // which were sent to a shard not owning the partition.
+        uint64_t routable_requests;
+        uint64_t misrouted_requests;
 
         std::unordered_map<exceptions::exception_code, uint64_t> errors;
     };
@@ -180,7 +196,7 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
 private:
     class fmt_visitor;
     friend class connection;
-    friend std::unique_ptr<cql_server::response> make_result(int16_t stream, messages::result_message& msg,
+    friend std::unique_ptr<cql_server::response> make_result(int16_t stream, ::shared_ptr<messages::result_message> msg,
             const tracing::trace_state_ptr& tr_state, cql_protocol_version_type version, bool skip_metadata);
 
     class connection : public generic_server::connection {
@@ -196,6 +212,14 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         unsigned _request_cpu = 0;
         bool _ready = false;
         bool _authenticating = false;
+        uint64_t _routable_requests = 0;
+        uint64_t _misrouted_requests = 0;
+        // Responses waiting on _ready_to_respond to be written.
+        unsigned _queued_responses = 0;
+        // This connection's share of the server's request memory. Frames
+        // aren't read while it is exhausted, pushing back on this client only.
+        size_t _memory_share_size;
+        semaphore _memory_share;
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -1364,28 +1364,68 @@ set_type_impl::serialize_partially_deserialized_form_fragmented(
     return pack_fragmented(v.begin(), v.end(), v.size(), sf);
 }
 
+// Reads the number of elements of a serialized collection, each made of values_per_element values,
+// and checks it against the number of bytes left, which must hold at least the headers of the values.
 template <FragmentedView View>
-utils::chunked_vector<managed_bytes> partially_deserialize_listlike(View in, cql_serialization_format sf) {
+static size_t read_collection_element_count(View& in, cql_serialization_format sf, size_t values_per_element) {
     auto nr = read_collection_size(in, sf);
-    utils::chunked_vector<managed_bytes> elements;
+    if (nr < 0) {
+        throw marshal_exception(format("negative collection size: {}", nr));
+    }
+    if (size_t(nr) * values_per_element > in.size_bytes() / collection_value_len(sf)) {
+        throw marshal_exception(format("collection of {} elements doesn't fit in {} bytes", nr, in.size_bytes()));
+    }
+    return nr;
+}
+
+template <FragmentedView View>
+utils::chunked_vector<View> partially_deserialize_listlike_views(View in, cql_serialization_format sf) {
+    auto nr = read_collection_element_count(in, sf, 1);
+    utils::chunked_vector<View> elements;
     elements.reserve(nr);
-    for (int i = 0; i != nr; ++i) {
+    for (size_t i = 0; i != nr; ++i) {
         elements.emplace_back(read_collection_value(in, sf));
     }
     return elements;
 }
+template utils::chunked_vector<managed_bytes_view> partially_deserialize_listlike_views(managed_bytes_view in, cql_serialization_format sf);
+template utils::chunked_vector<fragmented_temporary_buffer::view> partially_deserialize_listlike_views(fragmented_temporary_buffer::view in, cql_serialization_format sf);
+
+template <FragmentedView View>
+utils::chunked_vector<std::pair<View, View>> partially_deserialize_map_views(View in, cql_serialization_format sf) {
+    auto nr = read_collection_element_count(in, sf, 2);
+    utils::chunked_vector<std::pair<View, View>> elements;
+    elements.reserve(nr);
+    for (size_t i = 0; i != nr; ++i) {
+        auto key = read_collection_value(in, sf);
+        auto value = read_collection_value(in, sf);
+        elements.emplace_back(key, value);
+    }
+    return elements;
+}
+template utils::chunked_vector<std::pair<managed_bytes_view, managed_bytes_view>> partially_deserialize_map_views(managed_bytes_view in, cql_serialization_format sf);
+template utils::chunked_vector<std::pair<fragmented_temporary_buffer::view, fragmented_temporary_buffer::view>> partially_deserialize_map_views(fragmented_temporary_buffer::view in, cql_serialization_format sf);
+
+template <FragmentedView View>
+utils::chunked_vector<managed_bytes> partially_deserialize_listlike(View in, cql_serialization_format sf) {
+    auto views = partially_deserialize_listlike_views(in, sf);
+    utils::chunked_vector<managed_bytes> elements;
+    elements.reserve(views.size());
+    for (auto& v : views) {
+        elements.emplace_back(v);
+    }
+    return elements;
+}
 template utils::chunked_vector<managed_bytes> partially_deserialize_listlike(managed_bytes_view in, cql_serialization_format sf);
 template utils::chunked_vector<managed_bytes> partially_deserialize_listlike(fragmented_temporary_buffer::view in, cql_serialization_format sf);
 
 template <FragmentedView View>
 std::vector<std::pair<managed_bytes, managed_bytes>> partially_deserialize_map(View in, cql_serialization_format sf) {
-    auto nr = read_collection_size(in, sf);
+    auto views = partially_deserialize_map_views(in, sf);
     std::vector<std::pair<managed_bytes, managed_bytes>> elements;
-    elements.reserve(nr);
-    for (int i = 0; i != nr; ++i) {
-        auto key = managed_bytes(read_collection_value(in, sf));
-        auto value = managed_bytes(read_collection_value(in, sf));
-        elements.emplace_back(std::move(key), std::move(value));
+    elements.reserve(views.size());
+    for (auto& [key, value] : views) {
+        elements.emplace_back(managed_bytes(key), managed_bytes(value));
     }
     return elements;
 }
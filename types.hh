@@ -735,7 +735,20 @@ bool less_compare(data_type t, bytes_view e1, bytes_view e2) {
 
 static inline
 std::strong_ordering tri_compare(data_type t, managed_bytes_view e1, managed_bytes_view e2) {
-    return t->compare(e1, e2);
+    switch (t->get_kind()) {
+    // Ordered like their serialized form, compare them without the out-of-line
+    // dispatch of abstract_type::compare(). Keys compared component by component
+    // in hot paths mostly consist of these.
+    case abstract_type::kind::ascii:
+    case abstract_type::kind::utf8:
+    case abstract_type::kind::bytes:
+    case abstract_type::kind::inet:
+    case abstract_type::kind::date:
+    case abstract_type::kind::duration:
+        return compare_unsigned(e1, e2);
+    default:
+        return t->compare(e1, e2);
+    }
 }
 
 inline
@@ -1202,6 +1215,18 @@ utils::chunked_vector<managed_bytes> partially_deserialize_listlike(View in, cql
 template <FragmentedView View>
 std::vector<std::pair<managed_bytes, managed_bytes>> partially_deserialize_map(View in, cql_serialization_format sf);
 
+// Like partially_deserialize_listlike() and partially_deserialize_map(), but returns views
+// of the elements into the serialized collection instead of copies, so the elements
+// don't have to be allocated one by one. The collection must be kept alive while the
+// views are used.
+// The size of the collection is checked against the size of the serialized form before
+// any memory is reserved for the elements, and each element header is checked while
+// splitting. The elements themselves are not validated.
+template <FragmentedView View>
+utils::chunked_vector<View> partially_deserialize_listlike_views(View in, cql_serialization_format sf);
+template <FragmentedView View>
+utils::chunked_vector<std::pair<View, View>> partially_deserialize_map_views(View in, cql_serialization_format sf);
+
 using user_type = shared_ptr<const user_type_impl>;
 using tuple_type = shared_ptr<const tuple_type_impl>;
 
@@ -16,6 +16,7 @@
 #include <chrono>
 #include <random>
 #include <limits>
+#include <span>
 
 #include "UUID.hh"
 #include "db_clock.hh"
@@ -93,15 +94,20 @@ class UUID_gen
     // need monotonicity between time UUIDs created at different
     // shards and UUID code uses thread local state on each shard.
     int64_t create_time_safe() {
+        return create_time(reserve_time(1));
+    }
+
+    // Returns the first of n consecutive decimicrosecond times, all later
+    // than the ones returned before, reading the system clock once.
+    decimicroseconds reserve_time(size_t n) {
         using std::chrono::system_clock;
         auto millis = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
         decimicroseconds when = from_unix_timestamp(millis);
-        if (when > _last_used_time) {
-            _last_used_time = when;
-        } else {
-            when = ++_last_used_time;
+        if (when <= _last_used_time) {
+            when = _last_used_time + decimicroseconds{1};
         }
-        return create_time(when);
+        _last_used_time = when + decimicroseconds(n - 1);
+        return when;
     }
 
 public:
@@ -120,6 +126,22 @@ class UUID_gen
         return uuid;
     }
 
+    /**
+     * Fills @param uuids with type 1 UUIDs, as if by calling get_time_UUID()
+     * for each of them, but reading the clock only once.
+     */
+    static void get_time_UUIDs(std::span<UUID> uuids)
+    {
+        if (uuids.empty()) {
+            return;
+        }
+        auto when = _instance.reserve_time(uuids.size());
+        for (auto& uuid : uuids) {
+            uuid = UUID(create_time(when), clock_seq_and_node);
+            when += decimicroseconds{1};
+        }
+    }
+
     /**
      * Creates a type 1 UUID (time-based UUID) with the wall clock time point @param tp.
      *
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "utils/alien_worker.hh"
+
+namespace utils {
+
+alien_worker::alien_worker(unsigned threads) {
+    _threads.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        _threads.emplace_back([this] { run(); });
+    }
+}
+
+alien_worker::~alien_worker() {
+    {
+        std::unique_lock lock(_mutex);
+        _running = false;
+    }
+    _cv.notify_all();
+    for (auto& t : _threads) {
+        t.join();
+    }
+}
+
+void alien_worker::enqueue(task* t) noexcept {
+    {
+        std::unique_lock lock(_mutex);
+        if (_tail) {
+            _tail->next = t;
+        } else {
+            _head = t;
+        }
+        _tail = t;
+    }
+    _cv.notify_one();
+}
+
+void alien_worker::run() noexcept {
+    // Threads inherit the affinity of the thread which creates them, which is
+    // a reactor pinned to a single CPU. Let the kernel schedule the workers on
+    // any CPU the process may run on (it intersects the set with the cpuset).
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (unsigned cpu = 0; cpu < std::thread::hardware_concurrency() && cpu < CPU_SETSIZE; ++cpu) {
+        CPU_SET(cpu, &cpus);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [this] { return _head || !_running; });
+        if (!_head) {
+            return;
+        }
+        task* t = std::exchange(_head, _head->next);
+        if (!_head) {
+            _tail = nullptr;
+        }
+        lock.unlock();
+        t->run();
+        alien::run_on(t->alien, t->shard, [t] () noexcept {
+            t->complete();
+            delete t;
+        });
+        lock.lock();
+    }
+}
+
+} // namespace utils
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <seastar/core/alien.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "seastarx.hh"
+
+namespace utils {
+
+// Runs CPU-heavy functions (e.g. password hashing) on a pool of OS threads
+// outside of the reactor, so they don't stall the shards which submit them.
+//
+// The threads are not pinned to the CPUs of any shard, and the pool is meant
+// to be shared by all shards of the process. Functions must not touch any
+// seastar state. Everything else about a submission (the function object, its
+// result and the promise waiting for it) is allocated, completed and destroyed
+// on the submitting shard, which must keep running until the returned future
+// resolves.
+class alien_worker {
+    class task {
+    public:
+        task* next = nullptr;
+        unsigned shard = this_shard_id();
+        alien::instance& alien = engine().alien();
+
+        virtual ~task() = default;
+        // Runs on a worker thread.
+        virtual void run() noexcept = 0;
+        // Runs on the submitting shard.
+        virtual void complete() noexcept = 0;
+    };
+
+    template <typename T>
+    class typed_task final : public task {
+        noncopyable_function<T()> _func;
+        std::optional<T> _result;
+        std::exception_ptr _ex;
+        promise<T> _pr;
+    public:
+        explicit typed_task(noncopyable_function<T()> f) : _func(std::move(f)) { }
+        future<T> get_future() {
+            return _pr.get_future();
+        }
+        virtual void run() noexcept override {
+            try {
+                _result.emplace(_func());
+            } catch (...) {
+                _ex = std::current_exception();
+            }
+        }
+        virtual void complete() noexcept override {
+            if (_ex) {
+                _pr.set_exception(std::move(_ex));
+            } else {
+                _pr.set_value(std::move(*_result));
+            }
+        }
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    // Intrusive, so that the queue doesn't allocate on either side.
+    task* _head = nullptr;
+    task* _tail = nullptr;
+    bool _running = true;
+    std::vector<std::thread> _threads;
+private:
+    void run() noexcept;
+    void enqueue(task* t) noexcept;
+public:
+    explicit alien_worker(unsigned threads);
+    // Waits for the submitted functions to run.
+    ~alien_worker();
+
+    template <typename T>
+    future<T> submit(noncopyable_function<T()> f) {
+        auto t = std::make_unique<typed_task<T>>(std::move(f));
+        auto fut = t->get_future();
+        enqueue(t.release());
+        return fut;
+    }
+};
+
+} // namespace utils
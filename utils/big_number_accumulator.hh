@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <limits>
+#include <optional>
+
+#include <seastar/core/byteorder.hh>
+
+#include "bytes.hh"
+#include "utils/big_decimal.hh"
+#include "utils/multiprecision_int.hh"
+
+namespace utils {
+
+// Accumulators for summing varints and decimals, as done by the sum() and
+// avg() aggregates. Sums are kept in a 128-bit integer as long as they fit,
+// so that they don't allocate, and only move to multiprecision arithmetic
+// on overflow. Values can be added in their serialized form, which skips
+// decoding them into a multiprecision_int when they fit 128 bits.
+
+namespace detail {
+
+inline std::optional<__int128> serialized_varint_to_int128(bytes_view v) noexcept {
+    if (v.empty() || v.size() > sizeof(__int128)) {
+        return std::nullopt;
+    }
+    // Big-endian two's complement; the first byte carries the sign.
+    auto r = static_cast<unsigned __int128>(static_cast<__int128>(static_cast<int8_t>(v[0])));
+    for (size_t i = 1; i < v.size(); ++i) {
+        r = (r << 8) | static_cast<uint8_t>(v[i]);
+    }
+    return static_cast<__int128>(r);
+}
+
+inline boost::multiprecision::cpp_int int128_to_cpp_int(__int128 v) {
+    bool negative = v < 0;
+    auto m = negative ? -static_cast<unsigned __int128>(v) : static_cast<unsigned __int128>(v);
+    boost::multiprecision::cpp_int r = static_cast<uint64_t>(m >> 64);
+    r <<= 64;
+    r += static_cast<uint64_t>(m);
+    return negative ? boost::multiprecision::cpp_int(-r) : r;
+}
+
+inline std::optional<__int128> cpp_int_to_int128(const boost::multiprecision::cpp_int& v) {
+    if (v.is_zero()) {
+        return 0;
+    }
+    boost::multiprecision::cpp_int m = abs(v);
+    if (boost::multiprecision::msb(m) >= 127) {
+        return std::nullopt;
+    }
+    boost::multiprecision::cpp_int hi = m >> 64;
+    boost::multiprecision::cpp_int lo = m & std::numeric_limits<uint64_t>::max();
+    auto r = (static_cast<unsigned __int128>(static_cast<uint64_t>(hi)) << 64) | static_cast<uint64_t>(lo);
+    return v.sign() < 0 ? -static_cast<__int128>(r) : static_cast<__int128>(r);
+}
+
+// Multiplies v by 10^exp, or returns std::nullopt on overflow.
+inline std::optional<__int128> rescale_int128(__int128 v, int64_t exp) noexcept {
+    if (v == 0) {
+        return v;
+    }
+    for (; exp > 0; --exp) {
+        if (__builtin_mul_overflow(v, 10, &v)) {
+            return std::nullopt;
+        }
+    }
+    return v;
+}
+
+} // namespace detail
+
+class varint_accumulator {
+    __int128 _fast = 0;
+    // The part of the sum which didn't fit in _fast.
+    std::optional<multiprecision_int> _slow;
+private:
+    void add_slow(const multiprecision_int& v) {
+        if (_slow) {
+            *_slow += v;
+        } else {
+            _slow = v;
+        }
+    }
+public:
+    varint_accumulator() = default;
+    explicit varint_accumulator(const multiprecision_int& v) {
+        *this += v;
+    }
+
+    varint_accumulator& operator+=(__int128 v) {
+        __int128 r;
+        if (__builtin_add_overflow(_fast, v, &r)) {
+            add_slow(multiprecision_int(detail::int128_to_cpp_int(_fast)));
+            r = v;
+        }
+        _fast = r;
+        return *this;
+    }
+    varint_accumulator& operator+=(const multiprecision_int& v) {
+        if (auto f = detail::cpp_int_to_int128(v)) {
+            return *this += *f;
+        }
+        add_slow(v);
+        return *this;
+    }
+    varint_accumulator& operator+=(const varint_accumulator& o) {
+        *this += o._fast;
+        if (o._slow) {
+            add_slow(*o._slow);
+        }
+        return *this;
+    }
+
+    // Adds a serialized varint. Returns false, without adding it, if the
+    // value doesn't fit 128 bits or is empty; such values have to be
+    // deserialized and added as multiprecision_int.
+    bool add_serialized(bytes_view v) {
+        if (auto f = detail::serialized_varint_to_int128(v)) {
+            *this += *f;
+            return true;
+        }
+        return false;
+    }
+
+    multiprecision_int get() const {
+        multiprecision_int r(detail::int128_to_cpp_int(_fast));
+        if (_slow) {
+            r += *_slow;
+        }
+        return r;
+    }
+};
+
+class decimal_accumulator {
+    int32_t _scale = 0;
+    __int128 _unscaled = 0;
+    // Holds the whole sum once it didn't fit in _unscaled.
+    std::optional<big_decimal> _slow;
+private:
+    // Same as big_decimal::operator+=(), in 128 bits. Returns false, without
+    // adding, on overflow.
+    bool add_fast(int32_t scale, __int128 unscaled) noexcept {
+        auto max_scale = std::max(_scale, scale);
+        auto x = detail::rescale_int128(_unscaled, int64_t(max_scale) - _scale);
+        auto y = detail::rescale_int128(unscaled, int64_t(max_scale) - scale);
+        __int128 r;
+        if (!x || !y || __builtin_add_overflow(*x, *y, &r)) {
+            return false;
+        }
+        _scale = max_scale;
+        _unscaled = r;
+        return true;
+    }
+    void add_slow(const big_decimal& v) {
+        if (!_slow) {
+            _slow = get();
+        }
+        *_slow += v;
+    }
+public:
+    decimal_accumulator() = default;
+    explicit decimal_accumulator(const big_decimal& v) {
+        *this += v;
+    }
+
+    decimal_accumulator& operator+=(const big_decimal& v) {
+        if (!_slow) {
+            if (auto u = detail::cpp_int_to_int128(v.unscaled_value()); u && add_fast(v.scale(), *u)) {
+                return *this;
+            }
+        }
+        add_slow(v);
+        return *this;
+    }
+    decimal_accumulator& operator+=(const decimal_accumulator& o) {
+        if (_slow || o._slow || !add_fast(o._scale, o._unscaled)) {
+            add_slow(o.get());
+        }
+        return *this;
+    }
+
+    // Adds a serialized decimal. Returns false, without adding it, if it
+    // can't be added in 128 bits; such values have to be deserialized and
+    // added as big_decimal.
+    bool add_serialized(bytes_view v) {
+        if (_slow || v.size() <= sizeof(int32_t)) {
+            return false;
+        }
+        auto scale = read_be<int32_t>(reinterpret_cast<const char*>(v.data()));
+        auto unscaled = detail::serialized_varint_to_int128(v.substr(sizeof(int32_t)));
+        return unscaled && add_fast(scale, *unscaled);
+    }
+
+    big_decimal get() const {
+        return _slow ? *_slow : big_decimal(_scale, detail::int128_to_cpp_int(_unscaled));
+    }
+};
+
+} // namespace utils
@@ -55,20 +55,27 @@ class cached_file {
         uint64_t bytes_in_std = 0; // memory used by active temporary_buffer:s
     };
 private:
-    class cached_page : public evictable {
+    class cached_page : public segmented_evictable {
     public:
         cached_file* parent;
         page_idx_type idx;
         logalloc::lsa_buffer _lsa_buf;
         temporary_buffer<char> _buf; // Empty when not shared. May mirror _lsa_buf when shared.
         size_t _use_count = 0;
+        // Set once the page was released after its first use. Pages which are used again
+        // go to the protected segment of the LRU.
+        bool _reused = false;
     public:
         struct cached_page_del {
             void operator()(cached_page* cp) {
                 if (--cp->_use_count == 0) {
                     cp->parent->_metrics.bytes_in_std -= cp->_buf.size();
                     cp->_buf = {};
-                    cp->parent->_lru.add(*cp);
+                    if (std::exchange(cp->_reused, true)) {
+                        cp->parent->_lru.touch(*cp);
+                    } else {
+                        cp->parent->_lru.add(*cp);
+                    }
                 }
             }
         };
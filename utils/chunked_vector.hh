@@ -41,6 +41,7 @@
 // possibly smaller than a full 128 KB.
 
 #include "utils/small_vector.hh"
+#include "utils/fragment_pool.hh"
 
 #include <boost/range/algorithm/equal.hpp>
 #include <boost/algorithm/clamp.hpp>
@@ -55,7 +56,7 @@
 namespace utils {
 
 struct chunked_vector_free_deleter {
-    void operator()(void* x) const { ::free(x); }
+    void operator()(void* x) const { fragment_pool::free(x); }
 };
 
 template <typename T, size_t max_contiguous_allocation = 128*1024>
@@ -373,7 +374,7 @@ chunked_vector<T, max_contiguous_allocation>::~chunked_vector() {
 template <typename T, size_t max_contiguous_allocation>
 typename chunked_vector<T, max_contiguous_allocation>::chunk_ptr
 chunked_vector<T, max_contiguous_allocation>::new_chunk(size_t n) {
-    auto p = malloc(n * sizeof(T));
+    auto p = fragment_pool::allocate(n * sizeof(T));
     if (!p) {
         throw std::bad_alloc();
     }
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <variant>
+#include <vector>
+
+#include <seastar/core/do_with.hh>
+#include <seastar/core/future-util.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/util/later.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+namespace utils {
+
+// Batches calls submitted to other shards.
+//
+// Calls for the same shard which are submitted before the batch is sent go
+// in one smp message, and their results come back in one reply. The batch
+// is sent from a task scheduled when the first call is queued, so a burst of
+// calls made by one task, like the per-partition reads of an IN query, costs
+// a single message per shard. Calls for the current shard run directly.
+//
+// Calls submitted from different scheduling groups go in different batches,
+// and each batch runs in the scheduling group its calls were submitted from.
+//
+// The results travel back to the submitting shard, so they must be safe to
+// move across shards, like foreign_ptr.
+template <typename Result>
+class cross_shard_batcher {
+public:
+    using func_type = seastar::noncopyable_function<seastar::future<Result>()>;
+
+    struct stats {
+        // Calls submitted to other shards.
+        uint64_t calls = 0;
+        uint64_t batches = 0;
+    };
+private:
+    using outcome = std::variant<Result, std::exception_ptr>;
+
+    struct batch {
+        seastar::scheduling_group sg;
+        std::vector<func_type> funcs;
+        std::vector<seastar::promise<Result>> promises;
+    };
+
+    seastar::smp_service_group _ssg;
+    // Batches waiting to be sent, per destination shard. There are only a
+    // few scheduling groups, so they are looked up linearly.
+    std::vector<std::vector<batch>> _batches;
+    seastar::gate _gate;
+    stats _stats;
+private:
+    static seastar::future<std::vector<outcome>> run(std::vector<func_type>& funcs) {
+        std::vector<seastar::future<Result>> futs;
+        futs.reserve(funcs.size());
+        for (auto& f : funcs) {
+            futs.push_back(seastar::futurize_invoke(f));
+        }
+        return seastar::when_all(futs.begin(), futs.end()).then([] (std::vector<seastar::future<Result>> futs) {
+            std::vector<outcome> ret;
+            ret.reserve(futs.size());
+            for (auto& f : futs) {
+                if (f.failed()) {
+                    ret.emplace_back(std::in_place_index<1>, f.get_exception());
+                } else {
+                    ret.emplace_back(std::in_place_index<0>, f.get0());
+                }
+            }
+            return ret;
+        });
+    }
+
+    seastar::future<> send(unsigned shard, seastar::scheduling_group sg) {
+        auto& batches = _batches[shard];
+        auto it = std::find_if(batches.begin(), batches.end(), [sg] (const batch& b) { return b.sg == sg; });
+        auto funcs = std::move(it->funcs);
+        auto promises = std::move(it->promises);
+        batches.erase(it);
+        ++_stats.batches;
+        return seastar::smp::submit_to(shard, _ssg, [sg, funcs = std::move(funcs)] () mutable {
+            return seastar::with_scheduling_group(sg, [funcs = std::move(funcs)] () mutable {
+                return seastar::do_with(std::move(funcs), [] (std::vector<func_type>& funcs) {
+                    return run(funcs);
+                });
+            });
+        }).then_wrapped([promises = std::move(promises)] (seastar::future<std::vector<outcome>> f) mutable {
+            if (f.failed()) {
+                auto ex = f.get_exception();
+                for (auto& p : promises) {
+                    p.set_exception(ex);
+                }
+                return;
+            }
+            auto outcomes = f.get0();
+            for (size_t i = 0; i < promises.size(); ++i) {
+                if (auto* r = std::get_if<0>(&outcomes[i])) {
+                    promises[i].set_value(std::move(*r));
+                } else {
+                    promises[i].set_exception(std::get<1>(std::move(outcomes[i])));
+                }
+            }
+        });
+    }
+public:
+    explicit cross_shard_batcher(seastar::smp_service_group ssg = seastar::default_smp_service_group())
+        : _ssg(ssg)
+        , _batches(seastar::smp::count)
+    { }
+
+    seastar::future<Result> submit_to(unsigned shard, func_type func) {
+        if (shard == seastar::this_shard_id()) {
+            return seastar::do_with(std::move(func), [] (func_type& func) {
+                return seastar::futurize_invoke(func);
+            });
+        }
+        if (_gate.is_closed()) {
+            return seastar::make_exception_future<Result>(seastar::gate_closed_exception());
+        }
+        ++_stats.calls;
+        auto sg = seastar::current_scheduling_group();
+        auto& batches = _batches[shard];
+        auto it = std::find_if(batches.begin(), batches.end(), [sg] (const batch& b) { return b.sg == sg; });
+        if (it == batches.end()) {
+            it = batches.insert(batches.end(), batch{sg});
+            // The gate is held until the batch is sent and its results are set.
+            (void)seastar::with_gate(_gate, [this, shard, sg] {
+                return seastar::yield().then([this, shard, sg] {
+                    return send(shard, sg);
+                });
+            });
+        }
+        it->funcs.push_back(std::move(func));
+        it->promises.emplace_back();
+        return it->promises.back().get_future();
+    }
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+
+    // Waits for the calls in flight. Calls submitted later fail.
+    seastar::future<> stop() {
+        return _gate.close();
+    }
+};
+
+} // namespace utils
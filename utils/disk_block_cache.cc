@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+
+#include "utils/disk_block_cache.hh"
+#include "log.hh"
+
+namespace utils {
+
+static logging::logger dbclogger("disk_block_cache");
+
+disk_block_cache::disk_block_cache(file cache_file, config cfg)
+    : _cfg(cfg)
+    , _cache_file(std::move(cache_file))
+    , _slots(_cfg.capacity / _cfg.block_size)
+{
+    _free_slots.reserve(_slots.size());
+    for (size_t i = _slots.size(); i > 0; --i) {
+        _free_slots.push_back(i - 1);
+    }
+}
+
+future<> disk_block_cache::close() noexcept {
+    return _gate.close();
+}
+
+disk_block_cache::slot* disk_block_cache::find_slot(block_key key) {
+    auto it = _index.find(key);
+    return it == _index.end() ? nullptr : &_slots[it->second];
+}
+
+std::optional<size_t> disk_block_cache::allocate_slot() {
+    if (!_free_slots.empty()) {
+        auto idx = _free_slots.back();
+        _free_slots.pop_back();
+        return idx;
+    }
+    if (_lru.empty()) {
+        // All slots are being read or written.
+        return std::nullopt;
+    }
+    auto& s = _lru.front();
+    _lru.pop_front();
+    _index.erase(s.key);
+    s.used = false;
+    ++_stats.evictions;
+    return &s - _slots.data();
+}
+
+void disk_block_cache::release_slot(slot& s) noexcept {
+    if (--s.readers == 0) {
+        if (s.used) {
+            _lru.push_back(s);
+        } else {
+            _free_slots.push_back(&s - _slots.data());
+        }
+    }
+}
+
+future<temporary_buffer<char>> disk_block_cache::read_slot(slot& s) {
+    if (s.readers++ == 0) {
+        _lru.erase(_lru.iterator_to(s));
+    }
+    const auto pos = uint64_t(&s - _slots.data()) * _cfg.block_size;
+    std::exception_ptr ex;
+    temporary_buffer<char> buf;
+    try {
+        buf = co_await _cache_file.dma_read_exactly<char>(pos, s.size);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    release_slot(s);
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+    co_return buf;
+}
+
+future<temporary_buffer<char>> disk_block_cache::fetch(file backing, uint64_t file_size, block_key key) {
+    _fetches.try_emplace(key);
+    std::exception_ptr ex;
+    temporary_buffer<char> data;
+    try {
+        const auto pos = key.block * _cfg.block_size;
+        data = co_await backing.dma_read_exactly<char>(pos, std::min<uint64_t>(_cfg.block_size, file_size - pos));
+        _stats.backing_bytes_read += data.size();
+        if (auto idx = allocate_slot()) {
+            auto& s = _slots[*idx];
+            s.key = key;
+            s.size = data.size();
+            s.readers = 1; // Not evictable until written.
+            auto wbuf = temporary_buffer<char>::aligned(_cache_file.memory_dma_alignment(), _cfg.block_size);
+            std::copy(data.begin(), data.end(), wbuf.get_write());
+            try {
+                co_await _cache_file.dma_write(*idx * _cfg.block_size, wbuf.get(), wbuf.size());
+                s.used = true;
+                _index.emplace(key, *idx);
+            } catch (...) {
+                // Serve the read anyway, the block just doesn't get cached.
+                dbclogger.warn("Failed to write block to the cache file: {}", std::current_exception());
+            }
+            release_slot(s);
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    // Waiters look the block up again. If it couldn't be cached, or the
+    // fetch failed, they fetch it themselves.
+    auto nh = _fetches.extract(key);
+    nh.mapped().set_value();
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+    co_return data;
+}
+
+future<temporary_buffer<char>> disk_block_cache::read_block(file& backing, file_id id, uint64_t file_size, uint64_t block) {
+    const auto key = block_key{id, block};
+    while (true) {
+        if (auto* s = find_slot(key)) {
+            ++_stats.hits;
+            co_return co_await read_slot(*s);
+        }
+        auto it = _fetches.find(key);
+        if (it == _fetches.end()) {
+            break;
+        }
+        co_await it->second.get_shared_future();
+    }
+    ++_stats.misses;
+    co_return co_await fetch(backing, file_size, key);
+}
+
+void disk_block_cache::read_ahead(file& backing, file_id id, uint64_t file_size, uint64_t block) {
+    const auto key = block_key{id, block};
+    if (block * _cfg.block_size >= file_size || _index.contains(key) || _fetches.contains(key) || _gate.is_closed()) {
+        return;
+    }
+    ++_stats.read_aheads;
+    (void)with_gate(_gate, [this, backing, file_size, key] {
+        return fetch(backing, file_size, key).discard_result();
+    }).handle_exception([] (std::exception_ptr ep) {
+        dbclogger.debug("Read-ahead failed: {}", ep);
+    });
+}
+
+class disk_cached_file_impl : public file_impl {
+    disk_block_cache& _cache;
+    file _backing;
+    disk_block_cache::file_id _id;
+    uint64_t _size;
+    // The last block of the previous read, for detecting sequential reads.
+    std::optional<uint64_t> _last_block;
+private:
+    [[noreturn]] void unsupported() {
+        throw_with_backtrace<std::logic_error>("unsupported operation");
+    }
+public:
+    disk_cached_file_impl(disk_block_cache& cache, file backing, uint64_t size)
+        : file_impl(*get_file_impl(backing))
+        , _cache(cache)
+        , _backing(std::move(backing))
+        , _id(cache.new_file_id())
+        , _size(size)
+    { }
+
+    // unsupported
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override { unsupported(); }
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override { unsupported(); }
+    virtual future<> flush(void) override { unsupported(); }
+    virtual future<> truncate(uint64_t length) override { unsupported(); }
+    virtual future<> discard(uint64_t offset, uint64_t length) override { unsupported(); }
+    virtual future<> allocate(uint64_t position, uint64_t length) override { unsupported(); }
+    virtual subscription<directory_entry> list_directory(std::function<future<>(directory_entry)>) override { unsupported(); }
+    virtual std::unique_ptr<seastar::file_handle_impl> dup() override { unsupported(); }
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override { unsupported(); }
+
+    // delegating
+    virtual future<struct stat> stat(void) override { return _backing.stat(); }
+    virtual future<uint64_t> size(void) override { return make_ready_future<uint64_t>(_size); }
+    virtual future<> close() override { return _backing.close(); }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t size, const io_priority_class& pc) override {
+        if (offset >= _size) {
+            co_return temporary_buffer<uint8_t>();
+        }
+        size = std::min<uint64_t>(size, _size - offset);
+        const auto block_size = _cache.get_config().block_size;
+        const auto first = offset / block_size;
+        const auto last = (offset + size - 1) / block_size;
+
+        if (_last_block && (first == *_last_block || first == *_last_block + 1)) {
+            for (unsigned i = 1; i <= _cache.get_config().read_ahead_blocks; ++i) {
+                _cache.read_ahead(_backing, _id, _size, last + i);
+            }
+        }
+        _last_block = last;
+
+        auto result = temporary_buffer<uint8_t>::aligned(_memory_dma_alignment, size);
+        size_t copied = 0;
+        for (auto block = first; block <= last; ++block) {
+            auto buf = co_await _cache.read_block(_backing, _id, _size, block);
+            const auto block_start = block * block_size;
+            const auto begin = std::max(offset, block_start) - block_start;
+            const auto end = std::min<uint64_t>(offset + size - block_start, buf.size());
+            std::copy(buf.begin() + begin, buf.begin() + end, result.get_write() + copied);
+            copied += end - begin;
+        }
+        result.trim(copied);
+        co_return result;
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
+        auto buf = co_await dma_read_bulk(pos, len, pc);
+        std::copy(buf.begin(), buf.end(), reinterpret_cast<uint8_t*>(buffer));
+        co_return buf.size();
+    }
+};
+
+future<file> make_disk_cached_file(disk_block_cache& cache, file backing) {
+    auto size = co_await backing.size();
+    co_return file(make_shared<disk_cached_file_impl>(cache, std::move(backing), size));
+}
+
+} // namespace utils
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <boost/intrusive/list.hpp>
+
+#include <seastar/core/file.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "seastarx.hh"
+
+namespace utils {
+
+// A read-through cache of immutable files on slow storage (e.g. sstable
+// components kept in object storage), backed by a file on fast local disk.
+//
+// Backing files are cached in blocks of block_size. The local cache file is
+// divided into capacity / block_size slots, each holding one block. When all
+// slots are taken, the least recently used slot which isn't being read is
+// reused. Blocks being fetched are shared by concurrent readers, so a block
+// is fetched from the backing file at most once at a time.
+//
+// Reads of consecutive blocks of a file trigger fetching the next
+// read_ahead_blocks blocks in the background, so sequential scans of cold
+// files don't wait for the backing storage on every block.
+//
+// Like cached_file, this is meant for immutable files only: writes to the
+// backing file are not seen through the cache. The cache is shard-local.
+class disk_block_cache {
+public:
+    struct config {
+        size_t block_size = 1 << 20;
+        uint64_t capacity = 1ull << 30;
+        unsigned read_ahead_blocks = 4;
+    };
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t read_aheads = 0;
+        uint64_t backing_bytes_read = 0;
+    };
+
+    using file_id = uint64_t;
+private:
+    struct block_key {
+        file_id file;
+        uint64_t block;
+        bool operator==(const block_key&) const = default;
+    };
+    struct block_key_hash {
+        size_t operator()(const block_key& k) const noexcept {
+            return std::hash<uint64_t>()(k.file * 1000003 ^ k.block);
+        }
+    };
+    using lru_hook = boost::intrusive::list_member_hook<>;
+    struct slot {
+        block_key key;
+        size_t size = 0; // Shorter than block_size for the last block of a file
+        unsigned readers = 0;
+        bool used = false;
+        lru_hook hook;
+    };
+    using lru_type = boost::intrusive::list<slot, boost::intrusive::member_hook<slot, lru_hook, &slot::hook>>;
+
+    config _cfg;
+    file _cache_file;
+    std::vector<slot> _slots;
+    std::vector<size_t> _free_slots;
+    // Slots which aren't being read, least recently used first.
+    lru_type _lru;
+    std::unordered_map<block_key, size_t, block_key_hash> _index;
+    std::unordered_map<block_key, shared_future<>, block_key_hash> _fetches;
+    file_id _next_file_id = 0;
+    gate _gate;
+    stats _stats;
+private:
+    slot* find_slot(block_key key);
+    std::optional<size_t> allocate_slot();
+    void release_slot(slot& s) noexcept;
+    future<temporary_buffer<char>> read_slot(slot& s);
+    future<temporary_buffer<char>> fetch(file backing, uint64_t file_size, block_key key);
+public:
+    disk_block_cache(file cache_file, config cfg);
+    disk_block_cache(disk_block_cache&&) = delete;
+
+    // Waits for background read-aheads. The cache must not be used after.
+    future<> close() noexcept;
+
+    const config& get_config() const noexcept { return _cfg; }
+    const stats& get_stats() const noexcept { return _stats; }
+    size_t cached_blocks() const noexcept { return _index.size(); }
+
+    file_id new_file_id() noexcept { return _next_file_id++; }
+
+    // Returns the content of the given block of the backing file, which is
+    // file_size long, from the cache, or from the backing file on a miss.
+    future<temporary_buffer<char>> read_block(file& backing, file_id id, uint64_t file_size, uint64_t block);
+
+    // Starts fetching the given block in the background, unless it is cached
+    // or already being fetched.
+    void read_ahead(file& backing, file_id id, uint64_t file_size, uint64_t block);
+};
+
+// Returns a read-only seastar::file reading `backing` through `cache`.
+// The cache must outlive the returned file.
+future<file> make_disk_cached_file(disk_block_cache& cache, file backing);
+
+} // namespace utils
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <malloc.h>
+
+namespace utils {
+
+// A per-shard cache of freed buffer fragments of 4 KB to 128 KB, which
+// chunked_vector, bytes_ostream and fragmented_temporary_buffer allocate
+// their fragments from. Freed fragments are kept in power-of-two size
+// classes and handed out again without going through the allocator, up to
+// max_cached_bytes per shard; beyond that they are freed.
+//
+// Fragments are plain malloc() memory, so they may also be released with
+// free() (e.g. after bytes_ostream chunks were handed over to
+// managed_bytes); they just don't get recycled then.
+class fragment_pool {
+public:
+    static constexpr size_t min_size = 4 * 1024;
+    static constexpr size_t max_size = 128 * 1024;
+    static constexpr size_t max_cached_bytes = 1024 * 1024;
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t cached_bytes = 0;
+    };
+private:
+    static constexpr unsigned min_size_shift = std::countr_zero(min_size);
+    static constexpr unsigned nr_classes = std::countr_zero(max_size) - min_size_shift + 1;
+
+    struct free_fragment {
+        free_fragment* next;
+    };
+
+    std::array<free_fragment*, nr_classes> _free = {};
+    stats _stats;
+private:
+    static fragment_pool& local() noexcept {
+        static thread_local fragment_pool pool;
+        return pool;
+    }
+
+    fragment_pool() = default;
+    ~fragment_pool() {
+        for (auto f : _free) {
+            while (f) {
+                ::free(std::exchange(f, f->next));
+            }
+        }
+    }
+
+    void* do_allocate(size_t size) noexcept {
+        if (size < min_size || size > max_size) {
+            return ::malloc(size);
+        }
+        // Fragments cached in the class of bit_ceil(size) have at least that much room.
+        const auto cls = std::bit_width(size - 1) - min_size_shift;
+        if (auto f = _free[cls]) {
+            _free[cls] = f->next;
+            _stats.cached_bytes -= size_t(1) << (cls + min_size_shift);
+            ++_stats.hits;
+            return f;
+        }
+        ++_stats.misses;
+        return ::malloc(size);
+    }
+
+    void do_free(void* p) noexcept {
+        if (!p) {
+            return;
+        }
+        const auto usable = ::malloc_usable_size(p);
+        if (usable < min_size || usable >= 2 * max_size || _stats.cached_bytes >= max_cached_bytes) {
+            ::free(p);
+            return;
+        }
+        const auto cls = std::min<size_t>(std::bit_width(usable) - 1 - min_size_shift, nr_classes - 1);
+        _free[cls] = new (p) free_fragment{_free[cls]};
+        _stats.cached_bytes += size_t(1) << (cls + min_size_shift);
+    }
+public:
+    // Returns at least size bytes of malloc() memory, or nullptr on failure.
+    static void* allocate(size_t size) noexcept {
+        return local().do_allocate(size);
+    }
+
+    // Releases memory returned by allocate() or malloc().
+    static void free(void* p) noexcept {
+        local().do_free(p);
+    }
+
+    static const stats& get_stats() noexcept {
+        return local()._stats;
+    }
+};
+
+} // namespace utils
@@ -18,6 +18,7 @@
 #include "bytes.hh"
 #include "bytes_ostream.hh"
 #include "fragment_range.hh"
+#include "utils/fragment_pool.hh"
 
 /// Fragmented buffer consisting of multiple temporary_buffer<char>
 class fragmented_temporary_buffer {
@@ -92,14 +93,29 @@ class fragmented_temporary_buffer {
         std::vector<seastar::temporary_buffer<char>> fragments;
         fragments.reserve(full_fragment_count + !!last_fragment_size);
         for (size_t i = 0; i < full_fragment_count; ++i) {
-            fragments.emplace_back(seastar::temporary_buffer<char>(max_fragment_size));
+            fragments.emplace_back(allocate_fragment(max_fragment_size));
         }
         if (last_fragment_size) {
-            fragments.emplace_back(seastar::temporary_buffer<char>(last_fragment_size));
+            fragments.emplace_back(allocate_fragment(last_fragment_size));
         }
         return fragmented_temporary_buffer(std::move(fragments), data_size);
     }
 
+    // Allocates a fragment from utils::fragment_pool, to which it returns
+    // when the last reference to it is released.
+    static seastar::temporary_buffer<char> allocate_fragment(size_t size) {
+        auto p = static_cast<char*>(utils::fragment_pool::allocate(size));
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        try {
+            return seastar::temporary_buffer<char>(p, size, seastar::make_deleter([p] { utils::fragment_pool::free(p); }));
+        } catch (...) {
+            utils::fragment_pool::free(p);
+            throw;
+        }
+    }
+
     vector_type release() && noexcept {
         return std::move(_fragments);
     }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <seastar/core/bitops.hh>
+
+namespace utils {
+
+// Approximate counts of how often keys were seen recently.
+//
+// A count-min sketch with periodic aging, as used by the TinyLFU admission
+// policy. Each key, given as a 64-bit hash, maps to one counter in each row,
+// and its estimate is the smallest of them. Counters saturate at 15. Once the
+// number of increments reaches the sample size, all counters are halved, so
+// that the sketch reflects recent history only.
+class frequency_sketch {
+    static constexpr unsigned rows = 4;
+    static constexpr uint8_t max_count = 15;
+    static constexpr std::array<uint64_t, rows> seeds = {
+        0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full, 0xcbf29ce484222325ull,
+    };
+
+    std::vector<uint8_t> _counters;
+    size_t _width_mask;
+    size_t _sample_size;
+    size_t _increments = 0;
+private:
+    size_t index(unsigned row, uint64_t hash) const noexcept {
+        uint64_t h = (hash ^ seeds[row]) * 0x9e3779b97f4a7c15ull;
+        return row * (_width_mask + 1) + ((h >> 32) & _width_mask);
+    }
+
+    void age() noexcept {
+        for (auto& c : _counters) {
+            c >>= 1;
+        }
+        _increments /= 2;
+    }
+public:
+    // The width of the rows is rounded up to a power of two. The sample size
+    // is a multiple of the width, so that counters saturate only for keys
+    // which are really frequent.
+    explicit frequency_sketch(size_t width)
+        : _counters(rows * (size_t(1) << seastar::log2ceil(std::max(width, size_t(2)))))
+        , _width_mask(_counters.size() / rows - 1)
+        , _sample_size(10 * (_width_mask + 1))
+    { }
+
+    unsigned estimate(uint64_t hash) const noexcept {
+        uint8_t ret = max_count;
+        for (unsigned row = 0; row < rows; ++row) {
+            ret = std::min(ret, _counters[index(row, hash)]);
+        }
+        return ret;
+    }
+
+    void increment(uint64_t hash) noexcept {
+        bool incremented = false;
+        for (unsigned row = 0; row < rows; ++row) {
+            auto& c = _counters[index(row, hash)];
+            if (c < max_count) {
+                ++c;
+                incremented = true;
+            }
+        }
+        if (incremented && ++_increments >= _sample_size) {
+            age();
+        }
+    }
+
+    size_t sample_size() const noexcept {
+        return _sample_size;
+    }
+};
+
+} // namespace utils
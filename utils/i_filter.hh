@@ -20,6 +20,9 @@ using filter_ptr = std::unique_ptr<i_filter>;
 enum class filter_format {
     k_l_format,
     m_format,
+    // Scylla-specific cache-line-blocked layout, see filter::blocked_bloom_filter.
+    // Only readable by Scylla, and only when recorded in the Scylla component.
+    blocked_format,
 };
 
 class hashed_key {
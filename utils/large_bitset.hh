@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <limits>
 #include <seastar/core/preempt.hh>
 #include "utils/chunked_vector.hh"
@@ -58,6 +59,20 @@ class large_bitset {
     }
     void clear();
 
+    // Direct access to a run of words, for users which lay out their own
+    // structure over the bitset. The run [idx, idx + n) must not cross a
+    // storage chunk, which holds for any naturally aligned power-of-two n.
+    int_type* words(size_t idx, [[maybe_unused]] size_t n) {
+        assert(idx / words_per_chunk() == (idx + n - 1) / words_per_chunk());
+        return &_storage[idx];
+    }
+    const int_type* words(size_t idx, size_t n) const {
+        return const_cast<large_bitset*>(this)->words(idx, n);
+    }
+    static size_t words_per_chunk() {
+        return utils::chunked_vector<int_type>::max_chunk_capacity();
+    }
+
     const utils::chunked_vector<int_type>& get_storage() const {
         return _storage;
     }
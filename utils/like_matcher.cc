@@ -9,10 +9,14 @@
 
 
 #include "like_matcher.hh"
+#include "utils/utf8.hh"
 
 #include <boost/regex/icu.hpp>
 #include <boost/locale/encoding.hpp>
+#include <cstring>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -75,10 +79,69 @@ wstring regex_from_pattern(bytes_view pattern) {
     return re;
 }
 
+using piece = std::basic_string<bytes::value_type>;
+
+/// Splits a pattern without '_' wildcards into the literal (unescaped) pieces between its '%' wildcards.
+/// Returns std::nullopt if the pattern has a '_' wildcard or isn't valid UTF-8.
+///
+/// A pattern of N pieces matches texts which start with the first piece, end with the last one, and
+/// contain the others in order in between.  Since UTF-8 is self-synchronizing, the pieces can be
+/// searched for byte-wise.
+std::optional<std::vector<piece>> literal_pieces(bytes_view pattern) {
+    if (!utils::utf8::validate(pattern)) {
+        return std::nullopt;
+    }
+    std::vector<piece> pieces(1);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        auto c = pattern[i];
+        if (c == '\\') {
+            // A trailing backslash matches itself, like an escaped one.
+            pieces.back().push_back(i + 1 < pattern.size() ? pattern[++i] : c);
+        } else if (c == '%') {
+            pieces.emplace_back();
+        } else if (c == '_') {
+            return std::nullopt;
+        } else {
+            pieces.back().push_back(c);
+        }
+    }
+    return pieces;
+}
+
+/// Matches text against the pieces of a pattern returned by literal_pieces().
+bool match_pieces(const std::vector<piece>& pieces, bytes_view text) {
+    const piece& first = pieces.front();
+    if (pieces.size() == 1) {
+        return text == first;
+    }
+    const piece& last = pieces.back();
+    if (text.size() < first.size() + last.size()
+            || text.substr(0, first.size()) != first
+            || text.substr(text.size() - last.size()) != last) {
+        return false;
+    }
+    text = text.substr(first.size(), text.size() - first.size() - last.size());
+    for (size_t i = 1; i < pieces.size() - 1; ++i) {
+        const piece& p = pieces[i];
+        if (p.empty()) {
+            continue;
+        }
+        // glibc's memmem() uses a vectorized two-way search.
+        auto found = static_cast<const bytes::value_type*>(::memmem(text.data(), text.size(), p.data(), p.size()));
+        if (!found) {
+            return false;
+        }
+        text.remove_prefix(found - text.data() + p.size());
+    }
+    return true;
+}
+
 } // anonymous namespace
 
 class like_matcher::impl {
     bytes _pattern;
+    // Patterns without '_' are matched by searching for their literal pieces. Others use the regex.
+    std::optional<std::vector<piece>> _pieces;
     boost::u32regex _re; // Performs pattern matching.
   public:
     explicit impl(bytes_view pattern);
@@ -86,6 +149,11 @@ class like_matcher::impl {
     void reset(bytes_view pattern);
   private:
     void init_re() {
+        _pieces = literal_pieces(_pattern);
+        if (_pieces) {
+            _re = boost::u32regex();
+            return;
+        }
         _re = boost::make_u32regex(regex_from_pattern(_pattern), boost::u32regex::basic | boost::u32regex::optimize);
     }
 };
@@ -95,6 +163,9 @@ like_matcher::impl::impl(bytes_view pattern) : _pattern(pattern) {
 }
 
 bool like_matcher::impl::operator()(bytes_view text) const {
+    if (_pieces) {
+        return match_pieces(*_pieces, text);
+    }
     return boost::u32regex_match(text.begin(), text.end(), _re);
 }
 
@@ -120,3 +191,18 @@ bool like_matcher::operator()(bytes_view text) const {
 void like_matcher::reset(bytes_view pattern) {
     return _impl->reset(pattern);
 }
+
+bytes like_matcher::literal_prefix(bytes_view pattern) {
+    piece prefix;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        auto c = pattern[i];
+        if (c == '%' || c == '_') {
+            break;
+        }
+        if (c == '\\' && i + 1 < pattern.size()) {
+            c = pattern[++i];
+        }
+        prefix.push_back(c);
+    }
+    return bytes(prefix.data(), prefix.size());
+}
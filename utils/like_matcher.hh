@@ -41,4 +41,8 @@ class like_matcher {
 
     /// Resets pattern if different from the current one.
     void reset(bytes_view pattern);
+
+    /// Returns the text every match of \c pattern starts with: the pattern up to its first wildcard,
+    /// with escapes removed.
+    static bytes literal_prefix(bytes_view pattern);
 };
@@ -25,6 +25,7 @@
 #include <seastar/core/with_scheduling_group.hh>
 #include <seastar/util/alloc_failure_injector.hh>
 #include <seastar/util/backtrace.hh>
+#include <seastar/util/defer.hh>
 #include <seastar/util/later.hh>
 
 #include "utils/logalloc.hh"
@@ -368,13 +369,14 @@ class background_reclaimer {
     timer<lowres_clock> _adjust_shares_timer;
     // If engaged, main loop is not running, set_value() to wake it.
     promise<>* _main_loop_wait = nullptr;
+    const size_t _free_memory_threshold;
+    const unsigned _max_shares;
     future<> _done;
     bool _stopping = false;
-    static constexpr size_t free_memory_threshold = 60'000'000;
 private:
     bool have_work() const {
 #ifndef SEASTAR_DEFAULT_ALLOCATOR
-        return memory::free_memory() < free_memory_threshold;
+        return memory::free_memory() < _free_memory_threshold;
 #else
         return false;
 #endif
@@ -400,14 +402,14 @@ class background_reclaimer {
             if (_stopping) {
                 break;
             }
-            _reclaim(free_memory_threshold - memory::free_memory());
+            _reclaim(_free_memory_threshold - memory::free_memory());
             co_await coroutine::maybe_yield();
         }
         llogger.debug("background_reclaimer::main_loop: exit");
     }
     void adjust_shares() {
         if (have_work()) {
-            auto shares = 1 + (1000 * (free_memory_threshold - memory::free_memory())) / free_memory_threshold;
+            auto shares = 1 + (_max_shares * (_free_memory_threshold - memory::free_memory())) / _free_memory_threshold;
             _sg.set_shares(shares);
             llogger.trace("background_reclaimer::adjust_shares: {}", shares);
             if (_main_loop_wait) {
@@ -416,10 +418,12 @@ class background_reclaimer {
         }
     }
 public:
-    explicit background_reclaimer(scheduling_group sg, noncopyable_function<void (size_t target)> reclaim)
+    background_reclaimer(scheduling_group sg, size_t free_memory_threshold, unsigned max_shares, noncopyable_function<void (size_t target)> reclaim)
             : _sg(sg)
             , _reclaim(std::move(reclaim))
             , _adjust_shares_timer(default_scheduling_group(), [this] { adjust_shares(); })
+            , _free_memory_threshold(free_memory_threshold)
+            , _max_shares(max_shares)
             , _done(with_scheduling_group(_sg, [this] { return main_loop(); })) {
         if (sg != default_scheduling_group()) {
             _adjust_shares_timer.arm_periodic(50ms);
@@ -445,6 +449,10 @@ class tracker::impl {
     bool _abort_on_bad_alloc = false;
     bool _sanitizer_report_backtrace = false;
     reclaim_timer* _active_timer = nullptr;
+    bool _reclaiming_in_background = false;
+    // Time spent in reclaim, split by whether an allocation waited for it.
+    utils::coarse_steady_clock::duration _sync_reclaim_time{};
+    utils::coarse_steady_clock::duration _background_reclaim_time{};
 private:
     // Prevents tracker's reclaimer from running while live. Reclaimer may be
     // invoked synchronously with allocator. This guard ensures that this
@@ -503,12 +511,20 @@ class tracker::impl {
     // Abort on allocation failure from LSA
     void enable_abort_on_bad_alloc() noexcept { _abort_on_bad_alloc = true; }
     bool should_abort_on_bad_alloc() const noexcept { return _abort_on_bad_alloc; }
-    void setup_background_reclaim(scheduling_group sg) {
+    void setup_background_reclaim(scheduling_group sg, size_t free_memory_threshold, unsigned max_shares) {
         assert(!_background_reclaimer);
-        _background_reclaimer.emplace(sg, [this] (size_t target) {
+        if (!free_memory_threshold) {
+            return;
+        }
+        _background_reclaimer.emplace(sg, free_memory_threshold, max_shares, [this] (size_t target) {
+            _reclaiming_in_background = true;
+            auto reset = defer([this] () noexcept { _reclaiming_in_background = false; });
             reclaim(target, is_preemptible::yes);
         });
     }
+    void account_reclaim_time(utils::coarse_steady_clock::duration d) noexcept {
+        (_reclaiming_in_background ? _background_reclaim_time : _sync_reclaim_time) += d;
+    }
     // const bool&, so interested parties can save a reference and see updates.
     const bool& sanitizer_report_backtrace() const { return _sanitizer_report_backtrace; }
     void set_sanitizer_report_backtrace(bool rb) { _sanitizer_report_backtrace = rb; }
@@ -712,6 +728,17 @@ class segment_store_backend {
     virtual void* alloc_segment_memory() noexcept = 0;
     virtual void free_segment_memory(void* seg) noexcept = 0;
     virtual size_t free_memory() const noexcept = 0;
+    // Asks the kernel to back the segment store with transparent huge pages.
+    // Returns the number of bytes covered.
+    size_t advise_huge_pages() noexcept {
+        constexpr uintptr_t huge_page_size = 2 * 1024 * 1024;
+        auto start = align_up(_layout.start, huge_page_size);
+        auto end = align_down(_layout.end, huge_page_size);
+        if (start >= end || madvise(reinterpret_cast<void*>(start), end - start, MADV_HUGEPAGE)) {
+            return 0;
+        }
+        return end - start;
+    }
     bool can_allocate_more_segments(size_t non_lsa_reserve) const noexcept {
         if (_freed_segment_increases_general_memory_availability) {
             return free_memory() >= non_lsa_reserve + segment::size;
@@ -851,6 +878,9 @@ class contiguous_memory_segment_store {
     bool can_allocate_more_segments() const noexcept {
         return _backend->can_allocate_more_segments(non_lsa_reserve);
     }
+    size_t advise_huge_pages() noexcept {
+        return _backend->advise_huge_pages();
+    }
 };
 #ifndef SEASTAR_DEFAULT_ALLOCATOR
 using segment_store = contiguous_memory_segment_store;
@@ -953,6 +983,13 @@ class segment_store {
         auto i = find_empty();
         return i != _segments.end();
     }
+    size_t advise_huge_pages() noexcept {
+        if (_delegate_store) {
+            return _delegate_store->advise_huge_pages();
+        }
+        // Segments are scattered over the standard allocator's memory.
+        return 0;
+    }
 };
 #endif
 
@@ -1029,6 +1066,7 @@ class segment_pool {
     tracker::impl& tracker() { return _tracker; }
     void prime(size_t available_memory, size_t min_free_memory);
     void use_standard_allocator_segment_pool_backend(size_t available_memory);
+    size_t advise_huge_pages() noexcept { return _store.advise_huge_pages(); }
     segment* new_segment(region::impl* r);
     const segment_descriptor& descriptor(const segment* seg) const noexcept {
         uintptr_t index = idx_from_segment(seg);
@@ -1480,6 +1518,7 @@ reclaim_timer::~reclaim_timer() {
     }
 
     _duration = clock::now() - _start;
+    _tracker.account_reclaim_time(_duration);
     _stall_detected = _duration >= _duration_threshold;
     if (_debug_enabled || _stall_detected) {
         sample_stats(_end_stats);
@@ -2314,7 +2353,7 @@ void tracker::configure(const config& cfg) {
     if (cfg.abort_on_lsa_bad_alloc) {
         _impl->enable_abort_on_bad_alloc();
     }
-    _impl->setup_background_reclaim(cfg.background_reclaim_sched_group);
+    _impl->setup_background_reclaim(cfg.background_reclaim_sched_group, cfg.background_reclaim_free_memory_threshold, cfg.background_reclaim_max_shares);
     _impl->set_sanitizer_report_backtrace(cfg.sanitizer_report_backtrace);
 }
 
@@ -2804,6 +2843,12 @@ tracker::impl::impl() : _segment_pool(std::make_unique<logalloc::segment_pool>(*
 
         sm::make_counter("memory_freed", [this] { return _segment_pool->statistics().memory_freed; },
                         sm::description("Counts number of bytes which were requested to be freed in LSA.")),
+
+        sm::make_counter("sync_reclaim_time_us", [this] { return _sync_reclaim_time / 1us; },
+                        sm::description("Counts the time in microseconds spent reclaiming memory on behalf of allocations waiting for it.")),
+
+        sm::make_counter("background_reclaim_time_us", [this] { return _background_reclaim_time / 1us; },
+                        sm::description("Counts the time in microseconds spent reclaiming memory in the background, to keep a free memory reserve.")),
     });
 }
 
@@ -2921,6 +2966,17 @@ future<> prime_segment_pool(size_t available_memory, size_t min_free_memory) {
     });
 }
 
+future<> use_huge_pages_for_segment_pool() {
+    return smp::invoke_on_all([] {
+        auto bytes = shard_tracker().get_impl().segment_pool().advise_huge_pages();
+        if (bytes) {
+            llogger.debug("segment pool: advised huge pages for {} MiB", bytes >> 20);
+        } else {
+            llogger.warn("segment pool: could not advise huge pages");
+        }
+    });
+}
+
 future<> use_standard_allocator_segment_pool_backend(size_t available_memory) {
     return smp::invoke_on_all([=] {
         shard_tracker().get_impl().segment_pool().use_standard_allocator_segment_pool_backend(available_memory);
@@ -63,6 +63,10 @@ class tracker {
         bool sanitizer_report_backtrace = false; // Better reports but slower
         size_t lsa_reclamation_step;
         scheduling_group background_reclaim_sched_group;
+        // Background reclaim runs while free memory is below this.
+        size_t background_reclaim_free_memory_threshold = 60'000'000;
+        // Shares of background_reclaim_sched_group when there's no free memory left.
+        unsigned background_reclaim_max_shares = 1000;
     };
 
     struct stats {
@@ -525,6 +529,15 @@ class allocating_section {
 
 future<> prime_segment_pool(size_t available_memory, size_t min_free_memory);
 
+// Ask the kernel to back the segment pool with transparent huge pages, to reduce
+// TLB misses when accessing LSA memory.
+//
+// The segment pool shares its memory with the seastar allocator, so this applies
+// to all of the shard's memory. Call before prime_segment_pool(), so that memory
+// which the priming touches for the first time is faulted in as huge pages.
+// Memory reserved up-front with seastar's --hugepages doesn't need this.
+future<> use_huge_pages_for_segment_pool();
+
 // Use the segment pool appropriate for the standard allocator.
 //
 // In debug mode, this will use the release standard allocator store.
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <boost/intrusive/list.hpp>
+#include <limits>
+#include <utility>
 #include <seastar/core/memory.hh>
 
 class evictable {
@@ -39,44 +41,157 @@ class evictable {
     }
 };
 
+class lru;
+
+// An evictable which can be moved to the protected segment of the LRU,
+// see lru::touch().
+//
+// Knows whether it is linked in the protected segment, so that the LRU
+// can keep track of the segment's size even when the entry is unlinked
+// behind its back.
+class segmented_evictable : public evictable {
+    friend class lru;
+    // The LRU in whose protected segment the entry is linked, if any.
+    lru* _protected_in = nullptr;
+protected:
+    ~segmented_evictable();
+public:
+    segmented_evictable() = default;
+    segmented_evictable(segmented_evictable&& o) noexcept
+        : evictable(std::move(o))
+        , _protected_in(std::exchange(o._protected_in, nullptr))
+    { }
+    // Like the LRU link, doesn't change the linkage of either entry.
+    segmented_evictable& operator=(segmented_evictable&&) noexcept {
+        return *this;
+    }
+
+    void unlink_from_lru() noexcept;
+};
+
+// Segmented LRU.
+//
+// New entries are added to the probation segment. Segmented entries which are
+// touched afterwards move to the protected segment. Eviction takes from the
+// probation segment first, so that entries which are used only once, like
+// those read by a scan, don't push out entries which are used repeatedly.
+//
+// The probation segment is a plain LRU. Entries which rely on the eviction
+// order among themselves, like cache rows which have to be evicted from older
+// versions first, must only be added to it and never touched.
+//
+// The protected segment holds at most max_protected_size entries. Touching
+// an entry beyond that demotes the least recently used protected entry back
+// to probation, where it gets evicted unless it is touched again.
 class lru {
+public:
+    struct stats {
+        uint64_t promotions = 0; // Entries moved to the protected segment
+        uint64_t demotions = 0; // Entries moved from the protected segment back to probation
+        uint64_t probation_evictions = 0;
+        uint64_t protected_evictions = 0;
+    };
 private:
     friend class evictable;
+    friend class segmented_evictable;
     using lru_type = boost::intrusive::list<evictable,
         boost::intrusive::member_hook<evictable, evictable::lru_link_type, &evictable::_lru_link>,
         boost::intrusive::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
-    lru_type _list;
+    lru_type _probation;
+    lru_type _protected; // Holds only segmented_evictable entries.
+    size_t _protected_size = 0;
+    size_t _max_protected_size = std::numeric_limits<size_t>::max();
+    stats _stats;
+private:
+    // Forgets that the entry, linked in the protected segment, is there.
+    // Doesn't unlink it.
+    void on_unlinked_from_protected(segmented_evictable& e) noexcept {
+        e._protected_in = nullptr;
+        --_protected_size;
+    }
+
+    segmented_evictable& pop_protected() noexcept {
+        auto& e = static_cast<segmented_evictable&>(_protected.front());
+        _protected.pop_front();
+        on_unlinked_from_protected(e);
+        return e;
+    }
+
+    void demote() noexcept {
+        _probation.push_back(pop_protected());
+        ++_stats.demotions;
+    }
 public:
     using reclaiming_result = seastar::memory::reclaiming_result;
 
     ~lru() {
-        _list.clear_and_dispose([] (evictable* e) {
+        _probation.clear_and_dispose([] (evictable* e) {
             e->on_evicted();
         });
+        while (!_protected.empty()) {
+            pop_protected().on_evicted();
+        }
     }
 
     void remove(evictable& e) noexcept {
-        _list.erase(_list.iterator_to(e));
+        e.unlink_from_lru();
+    }
+
+    void remove(segmented_evictable& e) noexcept {
+        e.unlink_from_lru();
     }
 
+    // Adds an entry to the probation segment.
     void add(evictable& e) noexcept {
-        _list.push_back(e);
+        _probation.push_back(e);
     }
 
-    void touch(evictable& e) noexcept {
-        remove(e);
-        add(e);
+    // Marks the entry as recently used, moving it to the protected segment.
+    // The entry doesn't have to be linked.
+    void touch(segmented_evictable& e) noexcept {
+        if (e._protected_in) {
+            e.evictable::unlink_from_lru();
+            _protected.push_back(e);
+            return;
+        }
+        e.evictable::unlink_from_lru();
+        _protected.push_back(e);
+        e._protected_in = this;
+        ++_protected_size;
+        ++_stats.promotions;
+        if (_protected_size > _max_protected_size) {
+            demote();
+        }
+    }
+
+    // Sets the maximum number of entries in the protected segment,
+    // demoting the excess ones.
+    void set_max_protected_size(size_t n) noexcept {
+        _max_protected_size = n;
+        while (_protected_size > _max_protected_size) {
+            demote();
+        }
+    }
+
+    size_t protected_size() const noexcept {
+        return _protected_size;
     }
 
     // Evicts a single element from the LRU
     reclaiming_result evict() noexcept {
-        if (_list.empty()) {
-            return reclaiming_result::reclaimed_nothing;
+        if (!_probation.empty()) {
+            evictable& e = _probation.front();
+            _probation.pop_front();
+            e.on_evicted();
+            ++_stats.probation_evictions;
+            return reclaiming_result::reclaimed_something;
         }
-        evictable& e = _list.front();
-        _list.pop_front();
-        e.on_evicted();
-        return reclaiming_result::reclaimed_something;
+        if (!_protected.empty()) {
+            pop_protected().on_evicted();
+            ++_stats.protected_evictions;
+            return reclaiming_result::reclaimed_something;
+        }
+        return reclaiming_result::reclaimed_nothing;
     }
 
     // Evicts all elements.
@@ -84,8 +199,27 @@ class lru {
     void evict_all() {
         while (evict() == reclaiming_result::reclaimed_something) {}
     }
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
 };
 
+inline
+segmented_evictable::~segmented_evictable() {
+    if (_protected_in) {
+        _protected_in->on_unlinked_from_protected(*this);
+    }
+}
+
+inline
+void segmented_evictable::unlink_from_lru() noexcept {
+    if (_protected_in) {
+        _protected_in->on_unlinked_from_protected(*this);
+    }
+    evictable::unlink_from_lru();
+}
+
 inline
 evictable::evictable(evictable&& o) noexcept {
     if (o._lru_link.is_linked()) {
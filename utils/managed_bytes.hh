@@ -75,7 +75,9 @@ struct blob_storage {
 // A managed version of "bytes" (can be used with LSA).
 class managed_bytes {
     friend class bytes_ostream;
-    static constexpr size_t max_inline_size = 15;
+    // Large enough for the keys of most tables (e.g. a timeuuid or a few
+    // integers), so that copying them doesn't allocate.
+    static constexpr size_t max_inline_size = 31;
     struct small_blob {
         bytes_view::value_type data[max_inline_size];
         int8_t size; // -1 -> use blob_storage
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <seastar/core/metrics.hh>
+
+namespace utils {
+
+// The metric group of the per-subsystem memory usage gauges.
+inline constexpr std::string_view memory_usage_metrics_group = "memory";
+
+// Defines the gauge of the memory used by the given subsystem, in bytes.
+//
+// The subsystems account the memory they use themselves, so this covers the
+// memory they track, like reader buffers in their permits, and not allocator
+// overhead. The gauges of all subsystems belong to one metric family,
+// memory_subsystem_used_bytes, so they can be compared with each other and
+// with the totals of the allocator.
+template <typename Func>
+seastar::metrics::impl::metric_definition_impl make_subsystem_memory_gauge(std::string_view subsystem, Func&& func) {
+    namespace sm = seastar::metrics;
+    static const sm::label subsystem_label("subsystem");
+    return sm::make_gauge("subsystem_used_bytes", std::forward<Func>(func),
+            sm::description("Memory used by the subsystem in the subsystem label, as accounted by the subsystem"),
+            {subsystem_label(seastar::sstring(subsystem))});
+}
+
+} // namespace utils
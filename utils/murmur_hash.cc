@@ -11,6 +11,10 @@
 
 #include "murmur_hash.hh"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
 namespace utils {
 
 namespace murmur_hash {
@@ -142,32 +146,42 @@ static inline uint64_t getblock(bytes_view key, uint32_t index)
             | (uint64_t(p[7]) << 56);
 }
 
-void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t,2> &result)
+static constexpr uint64_t hash3_c1 = 0x87c37b91114253d5L;
+static constexpr uint64_t hash3_c2 = 0x4cf5ad432745937fL;
+
+static inline void hash3_block(bytes_view key, uint32_t i, uint64_t& h1, uint64_t& h2)
 {
-    uint32_t length = key.size();
-    const uint32_t nblocks = length >> 4; // Process as 128-bit blocks.
+    uint64_t c1 = hash3_c1;
+    uint64_t c2 = hash3_c2;
 
-    uint64_t h1 = seed;
-    uint64_t h2 = seed;
+    uint64_t k1 = getblock(key, i*2+0);
+    uint64_t k2 = getblock(key, i*2+1);
 
-    uint64_t c1 = 0x87c37b91114253d5L;
-    uint64_t c2 = 0x4cf5ad432745937fL;
+    k1 *= c1; k1 = rotl64(k1,31); k1 *= c2; h1 ^= k1;
 
-    //----------
-    // body
+    h1 = rotl64(h1,27); h1 += h2; h1 = h1*5+0x52dce729;
 
-    for(uint32_t i = 0; i < nblocks; i++)
-    {
-        uint64_t k1 = getblock(key, i*2+0);
-        uint64_t k2 = getblock(key, i*2+1);
+    k2 *= c2; k2  = rotl64(k2,33); k2 *= c1; h2 ^= k2;
 
-        k1 *= c1; k1 = rotl64(k1,31); k1 *= c2; h1 ^= k1;
+    h2 = rotl64(h2,31); h2 += h1; h2 = h2*5+0x38495ab5;
+}
 
-        h1 = rotl64(h1,27); h1 += h2; h1 = h1*5+0x52dce729;
+// Hashes key from its first_block-th 128-bit block on, given the state
+// after the preceding blocks.
+static void hash3_x64_128_from(bytes_view key, uint32_t first_block, uint64_t h1, uint64_t h2, std::array<uint64_t,2> &result)
+{
+    uint32_t length = key.size();
+    const uint32_t nblocks = length >> 4; // Process as 128-bit blocks.
 
-        k2 *= c2; k2  = rotl64(k2,33); k2 *= c1; h2 ^= k2;
+    uint64_t c1 = hash3_c1;
+    uint64_t c2 = hash3_c2;
 
-        h2 = rotl64(h2,31); h2 += h1; h2 = h2*5+0x38495ab5;
+    //----------
+    // body
+
+    for(uint32_t i = first_block; i < nblocks; i++)
+    {
+        hash3_block(key, i, h1, h2);
     }
 
     //----------
@@ -218,5 +232,39 @@ void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t,2> &result
     result[1] = h2;
 }
 
+void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t,2> &result)
+{
+    hash3_x64_128_from(key, 0, seed, seed, result);
+}
+
+void hash3_x64_128(std::span<const bytes_view> keys, uint64_t seed, std::span<std::array<uint64_t, 2>> results)
+{
+    assert(keys.size() == results.size());
+    constexpr size_t lanes = 4;
+
+    size_t n = 0;
+    for (; n + lanes <= keys.size(); n += lanes) {
+        uint64_t h1[lanes];
+        uint64_t h2[lanes];
+        uint32_t common_blocks = std::numeric_limits<uint32_t>::max();
+        for (size_t l = 0; l < lanes; ++l) {
+            h1[l] = seed;
+            h2[l] = seed;
+            common_blocks = std::min(common_blocks, uint32_t(keys[n + l].size() >> 4));
+        }
+        for (uint32_t i = 0; i < common_blocks; ++i) {
+            for (size_t l = 0; l < lanes; ++l) {
+                hash3_block(keys[n + l], i, h1[l], h2[l]);
+            }
+        }
+        for (size_t l = 0; l < lanes; ++l) {
+            hash3_x64_128_from(keys[n + l], common_blocks, h1[l], h2[l], results[n + l]);
+        }
+    }
+    for (; n < keys.size(); ++n) {
+        hash3_x64_128(keys[n], seed, results[n]);
+    }
+}
+
 } // namespace murmur_hash
 } // namespace utils
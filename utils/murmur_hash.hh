@@ -12,6 +12,7 @@
 
 #include <cstdint>
 #include <array>
+#include <span>
 
 #include "bytes.hh"
 
@@ -139,6 +140,13 @@ void hash3_x64_128(InputIterator in, uint32_t length, uint64_t seed, std::array<
 
 void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t, 2>& result);
 
+// Hashes each of keys into the corresponding element of results, which must
+// be as large. Same as calling hash3_x64_128() on each key, but interleaves
+// the block loops of groups of keys, so the CPU overlaps their independent
+// multiply chains (or the compiler vectorizes them, where 64-bit vector
+// multiplies exist).
+void hash3_x64_128(std::span<const bytes_view> keys, uint64_t seed, std::span<std::array<uint64_t, 2>> results);
+
 } // namespace murmur_hash
 
 } // namespace utils
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <execinfo.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <boost/range/irange.hpp>
+
+#include <seastar/core/map_reduce.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/util/backtrace.hh>
+#include <seastar/util/defer.hh>
+
+#include "utils/sampling_profiler.hh"
+#include "log.hh"
+
+static logging::logger plog("sampling_profiler");
+
+namespace utils::sampling_profiler {
+
+namespace {
+
+constexpr int profiler_signal = SIGPROF;
+// The signal handler and the signal trampoline.
+constexpr int skipped_frames = 2;
+constexpr int max_frames = 32 + skipped_frames;
+
+struct sample {
+    seastar::scheduling_group sg;
+    int nr_frames;
+    std::array<void*, max_frames> frames;
+};
+
+struct shard_state {
+    bool active = false;
+    std::vector<sample> samples;
+    size_t nr_samples = 0;
+    uint64_t dropped = 0;
+};
+
+thread_local shard_state state;
+
+// Runs on the interrupted shard's thread, so it must be async-signal-safe:
+// it only writes to the samples allocated before the timer was armed.
+void on_signal(int, siginfo_t*, void*) {
+    auto saved_errno = errno;
+    auto& st = state;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    if (st.active) {
+        if (st.nr_samples < st.samples.size()) {
+            auto& s = st.samples[st.nr_samples];
+            s.sg = seastar::current_scheduling_group();
+            s.nr_frames = ::backtrace(s.frames.data(), max_frames);
+            ++st.nr_samples;
+        } else {
+            ++st.dropped;
+        }
+    }
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    errno = saved_errno;
+}
+
+void install_signal_handler() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        struct sigaction sa = {};
+        sa.sa_sigaction = on_signal;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (sigaction(profiler_signal, &sa, nullptr) == -1) {
+            throw std::system_error(errno, std::system_category(), "sigaction");
+        }
+        // backtrace() loads libgcc on first use, which isn't signal-safe.
+        void* frame;
+        ::backtrace(&frame, 1);
+    });
+}
+
+void set_signal_blocked(bool blocked) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, profiler_signal);
+    pthread_sigmask(blocked ? SIG_BLOCK : SIG_UNBLOCK, &mask, nullptr);
+}
+
+seastar::sstring fold(const sample& s) {
+    std::ostringstream out;
+    out << s.sg.name();
+    for (int i = s.nr_frames - 1; i >= skipped_frames; --i) {
+        // Return addresses point after the call instruction.
+        out << ';' << seastar::decorate(reinterpret_cast<uintptr_t>(s.frames[i]) - 1);
+    }
+    return seastar::sstring(out.str());
+}
+
+} // anonymous namespace
+
+seastar::future<folded_stacks> profile_shard(std::chrono::milliseconds duration, std::chrono::microseconds period) {
+    if (state.active) {
+        throw std::runtime_error("The sampling profiler is already running");
+    }
+    if (period.count() <= 0) {
+        throw std::invalid_argument("The sampling period must be positive");
+    }
+    install_signal_handler();
+
+    auto expected = std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / period.count() + 1;
+    state.samples.resize(std::min<size_t>(expected, max_samples));
+    state.nr_samples = 0;
+    state.dropped = 0;
+
+    struct sigevent sev = {};
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = profiler_signal;
+    sev._sigev_un._tid = syscall(SYS_gettid);
+    timer_t timer;
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &timer) == -1) {
+        throw std::system_error(errno, std::system_category(), "timer_create");
+    }
+    auto delete_timer = defer([timer] () noexcept {
+        timer_delete(timer);
+    });
+
+    state.active = true;
+    set_signal_blocked(false);
+    auto stop = defer([] () noexcept {
+        set_signal_blocked(true);
+        state.active = false;
+    });
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(period).count();
+    struct itimerspec its = {};
+    its.it_interval.tv_sec = ns / 1000000000;
+    its.it_interval.tv_nsec = ns % 1000000000;
+    its.it_value = its.it_interval;
+    if (timer_settime(timer, 0, &its, nullptr) == -1) {
+        throw std::system_error(errno, std::system_category(), "timer_settime");
+    }
+
+    co_await seastar::sleep(duration);
+
+    its = {};
+    timer_settime(timer, 0, &its, nullptr);
+    stop.cancel();
+    set_signal_blocked(true);
+    state.active = false;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    folded_stacks ret;
+    for (size_t i = 0; i < state.nr_samples; ++i) {
+        ++ret[fold(state.samples[i])];
+    }
+    if (state.dropped) {
+        plog.info("Dropped {} samples over the limit of {}", state.dropped, state.samples.size());
+    }
+    state.samples = {};
+    co_return ret;
+}
+
+seastar::future<folded_stacks> profile(std::chrono::milliseconds duration, std::chrono::microseconds period) {
+    return seastar::map_reduce(boost::irange<unsigned>(0, seastar::smp::count), [duration, period] (unsigned shard) {
+        return seastar::smp::submit_to(shard, [duration, period] {
+            return profile_shard(duration, period);
+        });
+    }, folded_stacks(), [] (folded_stacks a, folded_stacks b) {
+        for (auto& [stack, count] : b) {
+            a[stack] += count;
+        }
+        return a;
+    });
+}
+
+} // namespace utils::sampling_profiler
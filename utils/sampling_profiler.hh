@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <unordered_map>
+
+#include <seastar/core/future.hh>
+#include <seastar/core/sstring.hh>
+
+// A timer-based sampling CPU profiler.
+//
+// While profiling, each shard's thread is interrupted every period of CPU
+// time it consumes, and the backtrace of the interrupted code is recorded
+// together with the scheduling group of the running task. The samples are
+// returned as folded stacks, the input format of flamegraph.pl: the
+// scheduling group name, then the frames from the outermost to the
+// innermost, separated by ';'. The frames are addresses in the form used by
+// reactor stall reports, to be resolved with seastar-addr2line.
+namespace utils::sampling_profiler {
+
+// Maps folded stacks to the number of samples in which they were seen.
+using folded_stacks = std::unordered_map<seastar::sstring, uint64_t>;
+
+// Each shard keeps at most that many samples per profile.
+constexpr size_t max_samples = 16384;
+
+// Profiles all shards for the given duration, samples them every period of
+// CPU time, and returns the merged samples of all shards. Fails if the
+// profiler is already running.
+seastar::future<folded_stacks> profile(std::chrono::milliseconds duration, std::chrono::microseconds period);
+
+// Profiles this shard only.
+seastar::future<folded_stacks> profile_shard(std::chrono::milliseconds duration, std::chrono::microseconds period);
+
+} // namespace utils::sampling_profiler
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/metrics.hh>
+#include <seastar/core/reactor.hh>
+
+#include "utils/stall_attribution.hh"
+#include "utils/histogram_metrics_helper.hh"
+
+namespace utils::stall_attribution {
+
+namespace internal {
+
+thread_local operation current_operation = operation::none;
+
+} // namespace internal
+
+std::string_view to_string(operation op) noexcept {
+    switch (op) {
+    case operation::none: return "none";
+    case operation::cache_update: return "cache_update";
+    case operation::schema_merge: return "schema_merge";
+    case operation::range_tombstone_apply: return "range_tombstone_apply";
+    }
+    std::abort();
+}
+
+tracker::tracker()
+    : _prev_report(seastar::engine().get_stall_detector_report_function())
+    , _timer([this] { account_stall(); })
+{
+    seastar::engine().set_stall_detector_report_function([this] {
+        if (_prev_report) {
+            _prev_report();
+        }
+        on_stall_report();
+    });
+    // Timers can't be armed from the signal handler, so the stalls are
+    // polled for. Stalls closer to each other than the period are merged.
+    _timer.arm_periodic(poll_period);
+}
+
+tracker::~tracker() {
+    seastar::engine().set_stall_detector_report_function(std::move(_prev_report));
+}
+
+seastar::future<> tracker::stop() {
+    _timer.cancel();
+    return seastar::make_ready_future<>();
+}
+
+void tracker::on_stall_report() noexcept {
+    // Must be async-signal-safe: no allocation, no locks.
+    auto now = std::chrono::steady_clock::now();
+    if (!_stall.active) {
+        _stall.active = true;
+        _stall.sg = seastar::current_scheduling_group();
+        _stall.op = internal::current_operation;
+        _stall.first_report = now;
+    }
+    _stall.last_report = now;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+void tracker::account_stall() {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    if (!_stall.active) {
+        return;
+    }
+    auto s = _stall;
+    _stall.active = false;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    auto tag = s.op != operation::none ? seastar::sstring(to_string(s.op)) : s.sg.name();
+    auto& stats = get_tag_stats(tag);
+    ++stats.stalls;
+    stats.duration.add(seastar::engine().get_blocked_reactor_notify_ms() + (s.last_report - s.first_report));
+}
+
+tracker::tag_stats& tracker::get_tag_stats(const seastar::sstring& tag) {
+    auto [it, inserted] = _tags.try_emplace(tag);
+    auto& stats = it->second;
+    if (inserted) {
+        namespace sm = seastar::metrics;
+        static const sm::label tag_label("tag");
+        stats.metrics.add_group("stalls", {
+            sm::make_counter("stalls", [&stats] { return stats.stalls; },
+                    sm::description("Number of reactor stalls attributed to the operation or scheduling group in the tag label"),
+                    {tag_label(tag)}),
+            sm::make_histogram("stall_duration",
+                    sm::description("Estimated duration of the reactor stalls attributed to the operation or scheduling group in the tag label, in microseconds"),
+                    {tag_label(tag)},
+                    [&stats] { return to_metrics_histogram(stats.duration); }),
+        });
+    }
+    return stats;
+}
+
+} // namespace utils::stall_attribution
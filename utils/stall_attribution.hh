@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <string_view>
+
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/timer.hh>
+
+#include "utils/estimated_histogram.hh"
+
+// Attribution of reactor stalls to the ScyllaDB subsystem which caused them.
+//
+// A stall is attributed to the operation which was running when the stall
+// detector fired, when the stalled code runs inside a scope of that operation,
+// and to the scheduling group of the stalled task otherwise. Operations which
+// run in a scheduling group of their own, like compaction and memtable flushes,
+// are covered by the latter. The durations of the stalls are exported as a
+// histogram per attribution tag.
+//
+// Scopes are thread-local state, not task-local, so they must only enclose
+// code which doesn't defer: a scope left open across a deferring point would
+// have the stalls of unrelated tasks attributed to its operation.
+namespace utils::stall_attribution {
+
+enum class operation : uint8_t {
+    none,
+    cache_update,
+    schema_merge,
+    range_tombstone_apply,
+};
+
+std::string_view to_string(operation op) noexcept;
+
+namespace internal {
+
+extern thread_local operation current_operation;
+
+} // namespace internal
+
+// Attributes the stalls of the enclosed non-deferring code to op.
+class scope {
+    operation _prev;
+public:
+    explicit scope(operation op) noexcept
+        : _prev(std::exchange(internal::current_operation, op)) {
+        // Orders the store with respect to the stall detector's signal handler.
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+    ~scope() {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        internal::current_operation = _prev;
+    }
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+};
+
+// Hooks into the reactor's stall detector on this shard, and accounts the
+// stalls it reports. Meant to be used as a sharded service.
+//
+// The stall detector calls its report function from a signal handler,
+// possibly several times during a single stall, so the hook only records the
+// time of the reports. The stall is accounted once the reactor runs tasks
+// again, which is checked every poll_period. Its duration is estimated as the
+// detection threshold plus the time between its first and last reports.
+class tracker {
+    struct stall {
+        bool active = false;
+        seastar::scheduling_group sg;
+        operation op = operation::none;
+        std::chrono::steady_clock::time_point first_report;
+        std::chrono::steady_clock::time_point last_report;
+    };
+
+    struct tag_stats {
+        uint64_t stalls = 0;
+        time_estimated_histogram duration;
+        seastar::metrics::metric_groups metrics;
+    };
+
+    static constexpr auto poll_period = std::chrono::milliseconds(100);
+
+    stall _stall;
+    std::function<void()> _prev_report;
+    std::map<seastar::sstring, tag_stats> _tags;
+    seastar::timer<seastar::lowres_clock> _timer;
+private:
+    // Called from the stall detector's signal handler.
+    void on_stall_report() noexcept;
+    void account_stall();
+    tag_stats& get_tag_stats(const seastar::sstring& tag);
+public:
+    tracker();
+    ~tracker();
+
+    seastar::future<> stop();
+};
+
+} // namespace utils::stall_attribution
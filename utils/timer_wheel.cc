@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <limits>
+
+#include "utils/timer_wheel.hh"
+
+namespace utils {
+
+timer_wheel::timer_wheel() {
+    _driver.set_callback([this] { on_driver(); });
+}
+
+timer_wheel& timer_wheel::local() noexcept {
+    static thread_local timer_wheel wheel;
+    return wheel;
+}
+
+// Rounds up, so timers never fire early.
+uint64_t timer_wheel::tick_of(clock::time_point t) const noexcept {
+    if (t <= _base) {
+        return 0;
+    }
+    auto d = t - _base;
+    // Timeouts like db::no_timeout would overflow the tick count.
+    constexpr int64_t max_ticks = int64_t(1) << 48;
+    auto ticks = d / tick;
+    if (ticks >= max_ticks) {
+        return max_ticks;
+    }
+    return ticks + (d % tick != clock::duration(0));
+}
+
+void timer_wheel::insert(coarse_timer& t) noexcept {
+    auto target = std::max(tick_of(t._timeout), _current);
+    if (target - _current < level0_slots) {
+        _level0[target % level0_slots].push_back(t);
+    } else if (target / level0_slots - _current / level0_slots < level1_slots) {
+        _level1[(target / level0_slots) % level1_slots].push_back(t);
+    } else {
+        _overflow.push_back(t);
+    }
+}
+
+void timer_wheel::arm(coarse_timer& t, clock::time_point timeout) {
+    t._timeout = timeout;
+    if (!_armed) {
+        // Nothing is armed, so restart the wheel from now, to not spin over
+        // the ticks which passed while it was idle.
+        _base = clock::now();
+        _current = 0;
+    }
+    insert(t);
+    if (!_armed++) {
+        _driver.rearm(_base);
+    }
+}
+
+void timer_wheel::on_cancel() noexcept {
+    if (!--_armed) {
+        _driver.cancel();
+    }
+}
+
+// Fires the timers of the current tick and moves to the next one.
+void timer_wheel::advance() noexcept {
+    if (_current % level0_slots == 0) {
+        auto block = _current / level0_slots;
+        auto redistribute = [this] (coarse_timer::list_type& timers) {
+            coarse_timer::list_type pending;
+            pending.splice(pending.end(), timers);
+            while (!pending.empty()) {
+                auto& t = pending.front();
+                pending.pop_front();
+                insert(t);
+            }
+        };
+        if (block % level1_slots == 0) {
+            redistribute(_overflow);
+        }
+        redistribute(_level1[block % level1_slots]);
+    }
+    coarse_timer::list_type expired;
+    expired.splice(expired.end(), _level0[_current % level0_slots]);
+    // Timers armed by the callbacks must not land in the slot being expired.
+    ++_current;
+    while (!expired.empty()) {
+        auto& t = expired.front();
+        expired.pop_front();
+        --_armed;
+        t._callback();
+    }
+}
+
+void timer_wheel::on_driver() noexcept {
+    // The callbacks may restart an emptied wheel, so don't cache the tick.
+    while (_armed && _current <= uint64_t((clock::now() - _base) / tick)) {
+        advance();
+    }
+    if (_armed) {
+        _driver.rearm(_base + tick * int64_t(_current));
+    }
+}
+
+} // namespace utils
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include <boost/intrusive/list.hpp>
+
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+namespace utils {
+
+class timer_wheel;
+
+// A timer with the resolution of timer_wheel::tick, for request timeouts.
+//
+// Unlike seastar::timer, arming and canceling it doesn't touch the reactor's
+// timer set: the timer is linked into a slot of its shard's wheel, in O(1),
+// and the wheel fires all the timers of a slot together, from a single
+// reactor timer. Timers fire no earlier than their timeout, and at most one
+// tick later.
+//
+// A coarse_timer must be armed, canceled and destroyed on the shard which
+// created it.
+class coarse_timer {
+public:
+    using clock = seastar::lowres_clock;
+    using callback_t = seastar::noncopyable_function<void()>;
+private:
+    using hook_type = boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+    hook_type _hook;
+    callback_t _callback;
+    clock::time_point _timeout;
+    friend class timer_wheel;
+public:
+    using list_type = boost::intrusive::list<coarse_timer,
+            boost::intrusive::member_hook<coarse_timer, hook_type, &coarse_timer::_hook>,
+            boost::intrusive::constant_time_size<false>>;
+
+    coarse_timer() noexcept = default;
+    explicit coarse_timer(callback_t callback) : _callback(std::move(callback)) {}
+    coarse_timer(const coarse_timer&) = delete;
+    coarse_timer& operator=(const coarse_timer&) = delete;
+    ~coarse_timer() {
+        cancel();
+    }
+
+    void set_callback(callback_t callback) {
+        _callback = std::move(callback);
+    }
+
+    // Arms the timer to fire at the given time, rearming it if needed.
+    void arm(clock::time_point timeout);
+
+    // Returns true if the timer was armed.
+    bool cancel() noexcept;
+
+    bool armed() const noexcept {
+        return _hook.is_linked();
+    }
+
+    clock::time_point get_timeout() const noexcept {
+        return _timeout;
+    }
+};
+
+// A per-shard hierarchical timer wheel driving the coarse_timers of the shard.
+//
+// The first level has a slot per tick, the second level a slot per turn of
+// the first one; timers of the second level move down when their slot comes
+// up. Timers further away than the second level reaches wait in an overflow
+// list, which is redistributed on each turn of the second level.
+class timer_wheel {
+public:
+    using clock = coarse_timer::clock;
+    static constexpr auto tick = std::chrono::milliseconds(10);
+    static constexpr size_t level0_slots = 256;
+    static constexpr size_t level1_slots = 256;
+private:
+    std::array<coarse_timer::list_type, level0_slots> _level0;
+    std::array<coarse_timer::list_type, level1_slots> _level1;
+    coarse_timer::list_type _overflow;
+    // The tick whose slot fires next. Ticks are counted from _base.
+    uint64_t _current = 0;
+    clock::time_point _base;
+    size_t _armed = 0;
+    seastar::timer<clock> _driver;
+private:
+    uint64_t tick_of(clock::time_point t) const noexcept;
+    void insert(coarse_timer& t) noexcept;
+    void advance() noexcept;
+    void on_driver() noexcept;
+public:
+    timer_wheel();
+
+    void arm(coarse_timer& t, clock::time_point timeout);
+    void on_cancel() noexcept;
+
+    size_t armed_timers() const noexcept {
+        return _armed;
+    }
+
+    // The wheel of this shard.
+    static timer_wheel& local() noexcept;
+};
+
+inline void coarse_timer::arm(clock::time_point timeout) {
+    cancel();
+    timer_wheel::local().arm(*this, timeout);
+}
+
+inline bool coarse_timer::cancel() noexcept {
+    if (!armed()) {
+        return false;
+    }
+    _hook.unlink();
+    timer_wheel::local().on_cancel();
+    return true;
+}
+
+} // namespace utils
@@ -225,6 +225,13 @@ alignas(16) static const uint8_t s_range_adjust_tbl[] = {
                  0,     0,
 };
 
+// Bytes at the end of a block which start a character needing more bytes
+// than remain in the block are greater than these: xx..xx EF DF BF
+alignas(16) static const uint8_t s_incomplete_tbl[] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
 // 2x ~ 4x faster than naive method
 partial_validation_results
 internal::validate_partial(const uint8_t *data, size_t len) {
@@ -244,11 +251,24 @@ internal::validate_partial(const uint8_t *data, size_t len) {
         const uint8x16_t const_2 = vdupq_n_u8(2);
         const uint8x16_t const_e0 = vdupq_n_u8(0xE0);
 
+        const uint8x16_t incomplete_tbl = vld1q_u8(s_incomplete_tbl);
+
         uint8x16_t error = vdupq_n_u8(0);
 
         while (len >= 16) {
             const uint8x16_t input = vld1q_u8(data);
 
+            // ASCII only block: it's valid unless the previous block ended
+            // in the middle of a character.
+            if (vmaxvq_u8(input) < 0x80) {
+                error = vorrq_u8(error, vqsubq_u8(prev_input, incomplete_tbl));
+                prev_input = input;
+                prev_first_len = vdupq_n_u8(0);
+                data += 16;
+                len -= 16;
+                continue;
+            }
+
             // high_nibbles = input >> 4
             const uint8x16_t high_nibbles = vshrq_n_u8(input, 4);
 
@@ -412,6 +432,13 @@ alignas(16) static const int8_t s_ef_fe_tbl[] = {
     0, 3, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 };
 
+// Bytes at the end of a block which start a character needing more bytes
+// than remain in the block are greater than these: xx..xx EF DF BF
+alignas(16) static const uint8_t s_incomplete_tbl[] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
 // 5x faster than naive method
 partial_validation_results
 internal::validate_partial(const uint8_t *data, size_t len) {
@@ -427,11 +454,24 @@ internal::validate_partial(const uint8_t *data, size_t len) {
         const __m128i df_ee_tbl = _mm_load_si128((const __m128i *)s_df_ee_tbl);
         const __m128i ef_fe_tbl = _mm_load_si128((const __m128i *)s_ef_fe_tbl);
 
+        const __m128i incomplete_tbl = _mm_load_si128((const __m128i *)s_incomplete_tbl);
+
         __m128i error = _mm_set1_epi8(0);
 
         while (len >= 16) {
             const __m128i input = _mm_lddqu_si128((const __m128i *)data);
 
+            // ASCII only block: it's valid unless the previous block ended
+            // in the middle of a character.
+            if (_mm_movemask_epi8(input) == 0) {
+                error = _mm_or_si128(error, _mm_subs_epu8(prev_input, incomplete_tbl));
+                prev_input = input;
+                prev_first_len = _mm_set1_epi8(0);
+                data += 16;
+                len -= 16;
+                continue;
+            }
+
             // high_nibbles = input >> 4
             const __m128i high_nibbles =
                 _mm_and_si128(_mm_srli_epi16(input, 4), _mm_set1_epi8(0x0F));
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -141,6 +142,40 @@ uint64_t unsigned_vint::deserialize(bytes_view v) {
     return result;
 }
 
+size_t unsigned_vint::deserialize_many(bytes_view& in, std::span<uint64_t> out) noexcept {
+    auto p = in.data();
+    const auto end = p + in.size();
+    size_t n = 0;
+    while (n < out.size()) {
+        // Small values dominate, so first try to take eight single-byte vints at once:
+        // they are recognized by all the high bits of a 64-bit word being clear, and
+        // the widening copy below is vectorized by the compiler.
+        if (out.size() - n >= 8 && end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if ((word & 0x8080808080808080ull) == 0) {
+                for (size_t i = 0; i < 8; ++i) {
+                    out[n + i] = uint8_t(p[i]);
+                }
+                p += 8;
+                n += 8;
+                continue;
+            }
+        }
+        if (p == end) {
+            break;
+        }
+        const auto len = serialized_size_from_first_byte(*p);
+        if (size_t(end - p) < len) {
+            break;
+        }
+        out[n++] = deserialize(bytes_view(p, end - p));
+        p += len;
+    }
+    in.remove_prefix(p - in.data());
+    return n;
+}
+
 vint_size_type unsigned_vint::serialized_size_from_first_byte(bytes::value_type first_byte) {
     int8_t first_byte_casted = first_byte;
     return 1 + (first_byte_casted >= 0 ? 0 : count_extra_bytes(first_byte_casted));
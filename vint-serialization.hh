@@ -35,6 +35,7 @@
 #include "bytes.hh"
 
 #include <cstdint>
+#include <span>
 
 using vint_size_type = bytes::size_type;
 
@@ -49,6 +50,11 @@ struct unsigned_vint final {
 
     static value_type deserialize(bytes_view v);
 
+    // Decodes consecutive vints from the front of `in` into `out`, stopping when `out`
+    // is full or when the next vint is not entirely contained in `in`.
+    // Advances `in` past the decoded vints and returns their count.
+    static size_t deserialize_many(bytes_view& in, std::span<value_type> out) noexcept;
+
     static vint_size_type serialized_size_from_first_byte(bytes::value_type first_byte);
 };
 
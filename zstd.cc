@@ -13,14 +13,49 @@
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
 
+#include <memory>
+
 #include "compress.hh"
 #include "utils/class_registrator.hh"
 
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_KB = "dictionary_size_kb";
+// Set by train_dictionary() and stored along with the compressed data, not set by users.
+static const sstring DICTIONARY = "dictionary";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 
+// Stored options are serialized with a 16-bit length.
+static constexpr int max_dictionary_size_kb = 63;
+// How many times the dictionary size is sampled to build it.
+static constexpr size_t dictionary_sample_ratio = 8;
+
+struct zstd_ddict_deleter {
+    void operator()(ZSTD_DDict* ddict) const noexcept {
+        ZSTD_freeDDict(ddict);
+    }
+};
+
+struct zstd_cdict_deleter {
+    void operator()(ZSTD_CDict* cdict) const noexcept {
+        ZSTD_freeCDict(cdict);
+    }
+};
+
 class zstd_processor : public compressor {
     int _compression_level = 3;
+    int _chunk_len;
+    size_t _dictionary_size = 0;
+
+    // The dictionary is its raw content: zstd can use any data as a dictionary,
+    // and picking samples is much cheaper than training one from them.
+    sstring _dictionary;
+    ZSTD_compressionParameters _cparams;
+    // The dictionary prepared for use, created on first use. An sstable
+    // creates its compressor once, so these are prepared once per sstable.
+    // Both reference _dictionary.
+    mutable std::unique_ptr<ZSTD_DDict, zstd_ddict_deleter> _ddict;
+    // Most compressors with a dictionary are only used to uncompress.
+    mutable std::unique_ptr<ZSTD_CDict, zstd_cdict_deleter> _cdict;
 
     // Manages memory for the compression context.
     std::unique_ptr<char[], free_deleter> _cctx_raw;
@@ -42,6 +77,10 @@ class zstd_processor : public compressor {
 
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
+    std::map<sstring, sstring> stored_options() const override;
+
+    size_t dictionary_sample_size() const override;
+    compressor::ptr_type train_dictionary(const std::vector<std::string_view>& samples) const override;
 };
 
 zstd_processor::zstd_processor(const opt_getter& opts)
@@ -63,18 +102,38 @@ zstd_processor::zstd_processor(const opt_getter& opts)
         }
     }
 
+    auto dictionary_size_kb = opts(DICTIONARY_SIZE_KB);
+    if (dictionary_size_kb) {
+        int size_kb;
+        try {
+            size_kb = std::stoi(*dictionary_size_kb);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *dictionary_size_kb, DICTIONARY_SIZE_KB));
+        }
+        if (size_kb < 0 || size_kb > max_dictionary_size_kb) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 0 and {}, got {}", DICTIONARY_SIZE_KB, max_dictionary_size_kb, size_kb));
+        }
+        _dictionary_size = size_t(size_kb) * 1024;
+    }
+
+    if (auto dictionary = opts(DICTIONARY)) {
+        _dictionary = std::move(*dictionary);
+    }
+
     auto chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB);
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
     // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
-    auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
+    _cparams = ZSTD_getCParams(_compression_level, _chunk_len, _dictionary.size());
+    auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(_cparams);
     // According to the ZSTD documentation, pointer to the context buffer must be 8-bytes aligned.
     _cctx_raw = allocate_aligned_buffer<char>(cctx_size, 8);
     _cctx = ZSTD_initStaticCCtx(_cctx_raw.get(), cctx_size);
@@ -91,7 +150,15 @@ zstd_processor::zstd_processor(const opt_getter& opts)
 }
 
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
+    if (!_dictionary.empty() && !_ddict) {
+        _ddict.reset(ZSTD_createDDict_advanced(_dictionary.data(), _dictionary.size(), ZSTD_dlm_byRef, ZSTD_dct_rawContent, ZSTD_defaultCMem));
+        if (!_ddict) {
+            throw std::runtime_error("Unable to create ZSTD decompression dictionary");
+        }
+    }
+    auto ret = _ddict
+        ? ZSTD_decompress_usingDDict(_dctx, output, output_len, input, input_len, _ddict.get())
+        : ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD decompression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -100,7 +167,15 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
+    if (!_dictionary.empty() && !_cdict) {
+        _cdict.reset(ZSTD_createCDict_advanced(_dictionary.data(), _dictionary.size(), ZSTD_dlm_byRef, ZSTD_dct_rawContent, _cparams, ZSTD_defaultCMem));
+        if (!_cdict) {
+            throw std::runtime_error("Unable to create ZSTD compression dictionary");
+        }
+    }
+    auto ret = _cdict
+        ? ZSTD_compress_usingCDict(_cctx, output, output_len, input, input_len, _cdict.get())
+        : ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -112,11 +187,51 @@ size_t zstd_processor::compress_max_size(size_t input_len) const {
 }
 
 std::set<sstring> zstd_processor::option_names() const {
-    return {COMPRESSION_LEVEL};
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_KB};
 }
 
 std::map<sstring, sstring> zstd_processor::options() const {
-    return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    std::map<sstring, sstring> ret{{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    if (_dictionary_size) {
+        ret.emplace(DICTIONARY_SIZE_KB, std::to_string(_dictionary_size / 1024));
+    }
+    return ret;
+}
+
+std::map<sstring, sstring> zstd_processor::stored_options() const {
+    auto ret = options();
+    if (!_dictionary.empty()) {
+        ret.emplace(DICTIONARY, _dictionary);
+    }
+    return ret;
+}
+
+size_t zstd_processor::dictionary_sample_size() const {
+    return _dictionary.empty() ? _dictionary_size * dictionary_sample_ratio : 0;
+}
+
+compressor::ptr_type zstd_processor::train_dictionary(const std::vector<std::string_view>& samples) const {
+    size_t total = 0;
+    for (auto& sample : samples) {
+        total += sample.size();
+    }
+    if (!_dictionary_size || total < _dictionary_size) {
+        return nullptr;
+    }
+    // Take an equal share of every sample, so that the dictionary covers
+    // all of the sampled data rather than just its beginning.
+    sstring dictionary;
+    for (auto& sample : samples) {
+        auto share = sample.size() * _dictionary_size / total;
+        dictionary.append(sample.data(), share);
+    }
+    auto opts = options();
+    opts.emplace(compression_parameters::CHUNK_LENGTH_KB, std::to_string(_chunk_len / 1024));
+    opts.emplace(DICTIONARY, std::move(dictionary));
+    return seastar::make_shared<zstd_processor>([&opts] (const sstring& key) -> opt_string {
+        auto i = opts.find(key);
+        return i != opts.end() ? opt_string(i->second) : std::nullopt;
+    });
 }
 
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>